@@ -2,19 +2,12 @@
 #include <cstdint>
 #include <cstring>
 
-uint32_t tag_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM] = {};
-uint32_t data_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM][DCACHE_WORD_NUM] = {};
-bool valid_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM] = {};
-bool dirty_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM] = {};
-bool pending_fill_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM] = {};
-bool plru_tree_state[DCACHE_SETS_NUM][DCACHE_PLRU_TREE_BITS] = {};
-
 namespace {
 inline bool invalid_set_or_way(uint32_t set_idx, uint32_t way) {
     return set_idx >= DCACHE_SETS_NUM || way >= DCACHE_WAYS_NUM;
 }
 
-inline void plru_touch_way(uint32_t set_idx, uint32_t way) {
+inline void plru_touch_way(DcacheArrays &a, uint32_t set_idx, uint32_t way) {
     if (set_idx >= DCACHE_SETS_NUM || way >= DCACHE_WAYS_NUM) {
         return;
     }
@@ -25,7 +18,7 @@ inline void plru_touch_way(uint32_t set_idx, uint32_t way) {
     while (span > 1) {
         const uint32_t half = span / 2;
         const bool went_right = way >= left_way + half;
-        plru_tree_state[set_idx][node] = went_right ? 0 : 1;
+        a.plru_tree_state[set_idx][node] = went_right ? 0 : 1;
         node = node * 2 + (went_right ? 2 : 1);
         if (went_right) {
             left_way += half;
@@ -35,14 +28,13 @@ inline void plru_touch_way(uint32_t set_idx, uint32_t way) {
 }
 } // namespace
 
-void init_dcache()
+void init_dcache(DcacheArrays &a)
 {
-    std::memset(tag_array, 0, sizeof(tag_array));
-    std::memset(data_array, 0, sizeof(data_array));
-    std::memset(valid_array, 0, sizeof(valid_array));
-    std::memset(dirty_array, 0, sizeof(dirty_array));
-    std::memset(pending_fill_array, 0, sizeof(pending_fill_array));
-    std::memset(plru_tree_state, 0, sizeof(plru_tree_state));
+    std::memset(a.tag_array, 0, sizeof(a.tag_array));
+    std::memset(a.data_array, 0, sizeof(a.data_array));
+    std::memset(a.valid_array, 0, sizeof(a.valid_array));
+    std::memset(a.dirty_array, 0, sizeof(a.dirty_array));
+    std::memset(a.plru_tree_state, 0, sizeof(a.plru_tree_state));
 }
 
 AddrFields decode(uint32_t addr)
@@ -95,73 +87,73 @@ void apply_strobe(uint32_t &dst, uint32_t src, uint8_t strb)
     }
 }
 
-void write_dcache_line(uint32_t set_idx, uint32_t way, uint32_t tag, const uint32_t data[DCACHE_WORD_NUM])
+void write_dcache_line(DcacheArrays &a, uint32_t set_idx, uint32_t way, uint32_t tag, const uint32_t data[DCACHE_WORD_NUM])
 {
     uint32_t target_way = way;
     for (uint32_t w = 0; w < DCACHE_WAYS_NUM; w++)
     {
-        if (valid_array[set_idx][w] && tag_array[set_idx][w] == tag)
+        if (a.valid_array[set_idx][w] && a.tag_array[set_idx][w] == tag)
         {
             target_way = w;
             break;
         }
     }
 
-    valid_array[set_idx][target_way] = true;
-    dirty_array[set_idx][target_way] = false;
-    tag_array[set_idx][target_way] = tag;
-    plru_tree_touch(set_idx, target_way);
+    a.valid_array[set_idx][target_way] = true;
+    a.dirty_array[set_idx][target_way] = false;
+    a.tag_array[set_idx][target_way] = tag;
+    plru_tree_touch(a, set_idx, target_way);
     for (int w = 0; w < DCACHE_WORD_NUM; w++)
     {
-        data_array[set_idx][target_way][w] = data[w];
+        a.data_array[set_idx][target_way][w] = data[w];
     }
 }
 
 bool cache_line_match(uint32_t addr1, uint32_t addr2){
     return (addr1 >> DCACHE_OFFSET_BITS) == (addr2 >> DCACHE_OFFSET_BITS);
 }
-void Dcache_Read(const DcacheLineReadReq read_req[LSU_LDU_COUNT+LSU_STA_COUNT],DcacheLineReadResp resp[LSU_LDU_COUNT+LSU_STA_COUNT], const FillOut &fillout,FillIn &fillin)
+void Dcache_Read(const DcacheArrays &a, const DcacheLineReadReq read_req[LSU_LDU_COUNT+LSU_STA_COUNT],DcacheLineReadResp resp[LSU_LDU_COUNT+LSU_STA_COUNT], const FillOut &fillout,FillIn &fillin)
 {
     for (int i = 0; i < LSU_LDU_COUNT + LSU_STA_COUNT; i++) {
         const auto &req = read_req[i];
-        memcpy(resp[i].valid, valid_array[req.set_idx], sizeof(valid_array[req.set_idx]));
-        memcpy(resp[i].tag, tag_array[req.set_idx], sizeof(tag_array[req.set_idx]));
-        memcpy(resp[i].dirty, dirty_array[req.set_idx], sizeof(dirty_array[req.set_idx]));
-        memcpy(resp[i].data, data_array[req.set_idx], sizeof(data_array[req.set_idx]));
+        memcpy(resp[i].valid, a.valid_array[req.set_idx], sizeof(a.valid_array[req.set_idx]));
+        memcpy(resp[i].tag, a.tag_array[req.set_idx], sizeof(a.tag_array[req.set_idx]));
+        memcpy(resp[i].dirty, a.dirty_array[req.set_idx], sizeof(a.dirty_array[req.set_idx]));
+        memcpy(resp[i].data, a.data_array[req.set_idx], sizeof(a.data_array[req.set_idx]));
     }
 
     if(fillout.valid){
-        memcpy(fillin.valid_snap,valid_array[fillout.set_idx], sizeof(valid_array[fillout.set_idx]));
-        memcpy(fillin.tag_snap,tag_array[fillout.set_idx], sizeof(tag_array[fillout.set_idx]));
-        memcpy(fillin.dirty_snap,dirty_array[fillout.set_idx], sizeof(dirty_array[fillout.set_idx]));
-        memcpy(fillin.data_snap,data_array[fillout.set_idx], sizeof(data_array[fillout.set_idx]));
-        memcpy(fillin.plru_tree_state,plru_tree_state[fillout.set_idx], sizeof(plru_tree_state[fillout.set_idx]));
+        memcpy(fillin.valid_snap,a.valid_array[fillout.set_idx], sizeof(a.valid_array[fillout.set_idx]));
+        memcpy(fillin.tag_snap,a.tag_array[fillout.set_idx], sizeof(a.tag_array[fillout.set_idx]));
+        memcpy(fillin.dirty_snap,a.dirty_array[fillout.set_idx], sizeof(a.dirty_array[fillout.set_idx]));
+        memcpy(fillin.data_snap,a.data_array[fillout.set_idx], sizeof(a.data_array[fillout.set_idx]));
+        memcpy(fillin.plru_tree_state,a.plru_tree_state[fillout.set_idx], sizeof(a.plru_tree_state[fillout.set_idx]));
     }
     else{
         memset(&fillin, 0, sizeof(fillin));
     }
 }
-void Dcache_Write(const PendingWrite pws[LSU_LDU_COUNT+LSU_STA_COUNT], const LruUpdate lru_updates[LSU_LDU_COUNT+LSU_STA_COUNT], const FILLWrite &fillwrite){
+void Dcache_Write(DcacheArrays &a, const PendingWrite pws[LSU_LDU_COUNT+LSU_STA_COUNT], const LruUpdate lru_updates[LSU_LDU_COUNT+LSU_STA_COUNT], const FILLWrite &fillwrite){
     for(int i=0;i<LSU_LDU_COUNT+LSU_STA_COUNT;i++){
         const PendingWrite &pw = pws[i];
         const LruUpdate &lru_update = lru_updates[i];
         if(pw.valid){
-            apply_strobe(data_array[pw.set_idx][pw.way_idx][pw.word_off], pw.data, pw.strb);
-            dirty_array[pw.set_idx][pw.way_idx] = true;
+            apply_strobe(a.data_array[pw.set_idx][pw.way_idx][pw.word_off], pw.data, pw.strb);
+            a.dirty_array[pw.set_idx][pw.way_idx] = true;
         }
 
         if(lru_update.valid){
-            plru_touch_way(lru_update.set_idx, lru_update.way);
+            plru_touch_way(a, lru_update.set_idx, lru_update.way);
         }
     }
     if(fillwrite.valid){
-        write_dcache_line(fillwrite.set_idx, fillwrite.way_idx, fillwrite.tag, fillwrite.data);
+        write_dcache_line(a, fillwrite.set_idx, fillwrite.way_idx, fillwrite.tag, fillwrite.data);
     }
 
 }
 
-void plru_tree_touch(uint32_t set_idx, uint32_t way) {
-    plru_touch_way(set_idx, way);
+void plru_tree_touch(DcacheArrays &a, uint32_t set_idx, uint32_t way) {
+    plru_touch_way(a, set_idx, way);
 }
 
 bool CheckAddr(uint32_t addr1, uint8_t strb1, uint32_t addr2, uint8_t strb2) {
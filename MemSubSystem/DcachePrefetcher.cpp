@@ -0,0 +1,301 @@
+#include "DcachePrefetcher.h"
+#include "MemRouteBlock.h"
+#include "types.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kLineMask = ~static_cast<uint32_t>(DCACHE_LINE_SIZE - 1);
+constexpr uint32_t kPageMask = ~static_cast<uint32_t>(4096 - 1);
+// A miss within this many lines of a stream's last line continues it.
+constexpr int32_t kStreamWindow = 4;
+
+} // namespace
+
+#if !BSD_CONFIG && defined(CONFIG_PERF_COUNTER)
+#define L1D_PF_PERF_INC(field)                                                 \
+    do {                                                                       \
+        if (ctx != nullptr) {                                                  \
+            ctx->perf.field++;                                                 \
+        }                                                                      \
+    } while (0)
+#else
+#define L1D_PF_PERF_INC(field)                                                 \
+    do {                                                                       \
+    } while (0)
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+// init
+// ─────────────────────────────────────────────────────────────────────────────
+void DcachePrefetcher::init()
+{
+    std::memset(&cur, 0, sizeof(cur));
+    std::memset(&nxt, 0, sizeof(nxt));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// comb_issue — inject the queue head as a tag probe into an idle load port.
+// Runs after MemRouteBlock has merged LSU / icache / PTW requests, so the probe
+// never displaces a demand request.
+// ─────────────────────────────────────────────────────────────────────────────
+void DcachePrefetcher::comb_issue()
+{
+    if (cur.queue_count == 0) {
+        return;
+    }
+    for (int i = 0; i < LSU_LDU_COUNT; i++) {
+        LoadReq &port = out.pf2dcache->req_ports.load_ports[i];
+        if (port.valid) {
+            continue;
+        }
+        port = {};
+        port.valid = true;
+        port.addr = cur.queue[cur.queue_head];
+        port.is_prefetch = true;
+
+        nxt.queue_head = (cur.queue_head + 1) % L1D_PF_QUEUE_SIZE;
+        nxt.queue_count = cur.queue_count - 1;
+        L1D_PF_PERF_INC(l1d_pf_probe);
+        return;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// comb_train — consume stage2 results of this cycle.
+// ─────────────────────────────────────────────────────────────────────────────
+void DcachePrefetcher::comb_train()
+{
+    // ── Fill: a tracked line arrived in the cache ────────────────────────────
+    if (in.mshr2dcache->fill_req.valid) {
+        const int t = find_track(in.mshr2dcache->fill_req.addr & kLineMask);
+        if (t >= 0) {
+            nxt.track[t].filled = true;
+        }
+    }
+
+    // ── Probe result ──────────────────────────────────────────────────────────
+    const PfProbeResp &probe = in.dcache2pf->probe_resp;
+    if (probe.valid) {
+        if (probe.present) {
+            L1D_PF_PERF_INC(l1d_pf_drop_present);
+        } else if (probe.issued) {
+            PfTrackEntry &e = nxt.track[cur.track_ptr];
+            e.valid = true;
+            e.filled = false;
+            e.line_addr = probe.addr & kLineMask;
+            nxt.track_ptr = (cur.track_ptr + 1) % L1D_PF_TRACK_SIZE;
+            L1D_PF_PERF_INC(l1d_pf_issue);
+        } else {
+            L1D_PF_PERF_INC(l1d_pf_drop_mshr);
+        }
+    }
+
+    // ── Demand loads ──────────────────────────────────────────────────────────
+    for (int i = 0; i < LSU_LDU_COUNT; i++) {
+        const PfTrainEvent &ev = in.dcache2pf->train[i];
+        if (!ev.valid || dcache_req_id_is_route(ev.req_id)) {
+            continue;
+        }
+        L1D_PF_PERF_INC(l1d_pf_train);
+
+        // First demand access to a prefetched line: useful if the fill already
+        // landed, late if it is still in flight. A miss without an MSHR means
+        // the line was evicted unused.
+        bool pf_first_hit = false;
+        const int t = find_track(ev.addr & kLineMask);
+        if (t >= 0) {
+            if (!ev.miss) {
+                L1D_PF_PERF_INC(l1d_pf_useful);
+                pf_first_hit = true;
+            } else if (ev.mshr_hit) {
+                L1D_PF_PERF_INC(l1d_pf_late);
+                pf_first_hit = true;
+            }
+            nxt.track[t].valid = false;
+        }
+
+        train_stride(ev);
+        if (ev.miss || pf_first_hit) {
+            train_stream(ev);
+        }
+    }
+}
+
+// PC-indexed stride: two matching deltas in a row (conf >= 2) trigger
+// L1D_PF_DEGREE prefetches ahead. Strides shorter than a line trigger only on
+// line crossings and walk consecutive lines in the stride direction.
+void DcachePrefetcher::train_stride(const PfTrainEvent &ev)
+{
+    const uint32_t idx = ev.pc_hash & (L1D_PF_STRIDE_ENTRIES - 1);
+    const uint32_t tag = ev.pc_hash >> L1D_PF_STRIDE_IDX_BITS;
+    PfStrideEntry &e = nxt.stride[idx];
+
+    if (!e.valid || e.tag != tag) {
+        e = {};
+        e.valid = true;
+        e.tag = tag;
+        e.last_addr = ev.addr;
+        return;
+    }
+
+    const uint32_t last_addr = e.last_addr;
+    const int32_t delta = static_cast<int32_t>(ev.addr - last_addr);
+    if (delta == 0) {
+        return;
+    }
+    if (delta == static_cast<int32_t>(e.stride)) {
+        if (e.conf < 3) {
+            e.conf = e.conf + 1;
+        }
+    } else if (e.conf > 0) {
+        e.conf = e.conf - 1;
+    } else {
+        e.stride = static_cast<uint32_t>(delta);
+    }
+    e.last_addr = ev.addr;
+
+    if (e.conf < 2) {
+        return;
+    }
+    const int32_t stride = static_cast<int32_t>(e.stride);
+    if (stride > -DCACHE_LINE_SIZE && stride < DCACHE_LINE_SIZE) {
+        if ((ev.addr & kLineMask) == (last_addr & kLineMask)) {
+            return;
+        }
+        const int32_t step = stride > 0 ? DCACHE_LINE_SIZE : -DCACHE_LINE_SIZE;
+        for (int k = 1; k <= L1D_PF_DEGREE; k++) {
+            if (push_candidate(ev.addr, ev.addr + step * k)) {
+                L1D_PF_PERF_INC(l1d_pf_cand_stride);
+            }
+        }
+    } else {
+        for (int k = 1; k <= L1D_PF_DEGREE; k++) {
+            if (push_candidate(ev.addr, ev.addr + stride * k)) {
+                L1D_PF_PERF_INC(l1d_pf_cand_stride);
+            }
+        }
+    }
+}
+
+// Stream: a miss close to an existing stream's last line advances it; two
+// steps in the same direction trigger L1D_PF_DEGREE next lines. Otherwise the
+// LRU entry starts a new stream.
+void DcachePrefetcher::train_stream(const PfTrainEvent &ev)
+{
+    const uint32_t line = ev.addr >> DCACHE_OFFSET_BITS;
+    nxt.stream_stamp = cur.stream_stamp + 1;
+
+    int hit = -1;
+    int victim = 0;
+    for (int i = 0; i < L1D_PF_STREAM_ENTRIES; i++) {
+        const PfStreamEntry &s = nxt.stream[i];
+        if (s.valid) {
+            const int32_t d = static_cast<int32_t>(line - s.last_line);
+            if (d >= -kStreamWindow && d <= kStreamWindow) {
+                hit = i;
+                break;
+            }
+        }
+        const PfStreamEntry &v = nxt.stream[victim];
+        if (v.valid && (!s.valid || s.lru_stamp < v.lru_stamp)) {
+            victim = i;
+        }
+    }
+
+    if (hit < 0) {
+        PfStreamEntry &s = nxt.stream[victim];
+        s = {};
+        s.valid = true;
+        s.last_line = line;
+        s.lru_stamp = nxt.stream_stamp;
+        return;
+    }
+
+    PfStreamEntry &s = nxt.stream[hit];
+    s.lru_stamp = nxt.stream_stamp;
+    const int32_t d = static_cast<int32_t>(line - s.last_line);
+    if (d == 0) {
+        return;
+    }
+    const bool down = d < 0;
+    if (s.dir_valid && s.dir_down == down) {
+        if (s.conf < 3) {
+            s.conf = s.conf + 1;
+        }
+    } else {
+        s.dir_valid = true;
+        s.dir_down = down;
+        s.conf = 1;
+    }
+    s.last_line = line;
+
+    if (s.conf < 2) {
+        return;
+    }
+    const int32_t step = down ? -DCACHE_LINE_SIZE : DCACHE_LINE_SIZE;
+    for (int k = 1; k <= L1D_PF_DEGREE; k++) {
+        if (push_candidate(ev.addr, ev.addr + step * k)) {
+            L1D_PF_PERF_INC(l1d_pf_cand_stream);
+        }
+    }
+}
+
+// Returns false if the candidate leaves the trigger's page; other drops
+// (duplicate, queue full) are counted here.
+bool DcachePrefetcher::push_candidate(uint32_t trigger_addr, uint32_t cand_addr)
+{
+    if ((cand_addr & kPageMask) != (trigger_addr & kPageMask)) {
+        return false;
+    }
+    const uint32_t line_addr = cand_addr & kLineMask;
+
+    for (int i = 0; i < nxt.queue_count; i++) {
+        if (nxt.queue[(nxt.queue_head + i) % L1D_PF_QUEUE_SIZE] == line_addr) {
+            L1D_PF_PERF_INC(l1d_pf_drop_dup);
+            return true;
+        }
+    }
+    if (find_track(line_addr) >= 0) {
+        L1D_PF_PERF_INC(l1d_pf_drop_dup);
+        return true;
+    }
+    if (nxt.queue_count == L1D_PF_QUEUE_SIZE) {
+        L1D_PF_PERF_INC(l1d_pf_drop_queue_full);
+        return true;
+    }
+    nxt.queue[(nxt.queue_head + nxt.queue_count) % L1D_PF_QUEUE_SIZE] = line_addr;
+    nxt.queue_count = nxt.queue_count + 1;
+    return true;
+}
+
+int DcachePrefetcher::find_track(uint32_t line_addr) const
+{
+    for (int i = 0; i < L1D_PF_TRACK_SIZE; i++) {
+        if (nxt.track[i].valid && nxt.track[i].line_addr == line_addr) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void DcachePrefetcher::seq()
+{
+    cur = nxt;
+}
+
+void DcachePrefetcher::dump_debug_state(FILE *out) const {
+    fprintf(out, "DcachePrefetcher State:\n");
+    fprintf(out, "  Queue Head: %u, Count: %u\n", cur.queue_head, cur.queue_count);
+    for (int i = 0; i < cur.queue_count; i++) {
+        fprintf(out, "  Queue %d: Line: 0x%08x\n", i,
+                cur.queue[(cur.queue_head + i) % L1D_PF_QUEUE_SIZE]);
+    }
+    for (int i = 0; i < L1D_PF_TRACK_SIZE; i++) {
+        const PfTrackEntry &e = cur.track[i];
+        if (e.valid) {
+            fprintf(out, "  Track %d: Line: 0x%08x, Filled: %d\n", i, e.line_addr, e.filled);
+        }
+    }
+}
@@ -39,17 +39,27 @@ void MSHR::comb_outputs_axi()
 {  
     out.axi_out->clear();
 
+    // Demand misses first; prefetch entries only issue when no demand entry waits.
+    int issue_idx = -1;
     for(uint32_t i=0; i<DCACHE_MSHR_ENTRIES; i++){
         const MSHREntry &ce = cur.mshr_entries[i];
         if (ce.valid && !ce.issued)
         {
-            out.axi_out->req_valid = true;
-            out.axi_out->req_addr = ce.addr;
-            out.axi_out->req_total_size = DCACHE_LINE_SIZE - 1;
-            out.axi_out->req_id = i;
-            break;
+            if (!ce.is_prefetch) {
+                issue_idx = i;
+                break;
+            }
+            if (issue_idx < 0) {
+                issue_idx = i;
+            }
         }
     }
+    if (issue_idx >= 0) {
+        out.axi_out->req_valid = true;
+        out.axi_out->req_addr = cur.mshr_entries[issue_idx].addr;
+        out.axi_out->req_total_size = DCACHE_LINE_SIZE - 1;
+        out.axi_out->req_id = issue_idx;
+    }
     out.axi_out->resp_ready = !cur.axi_resp_hold_valid;
 }
 
@@ -63,6 +73,10 @@ void MSHR::comb_inputs_dcache()
                 uint32_t find_addr = get_addr(in.dcache2mshr->find_req[i].set_idx, in.dcache2mshr->find_req[i].tag, 0);
                 if(e.valid && e.addr == find_addr){
                     nxt.find_hit[i] = true;
+                    // A demand access waiting on a prefetched line promotes it.
+                    if (e.is_prefetch && !in.dcache2mshr->find_req[i].is_prefetch) {
+                        nxt.mshr_entries[j].is_prefetch = false;
+                    }
                     break;
                 }
             }
@@ -92,7 +106,13 @@ void MSHR::comb_inputs_dcache()
                     nxt.mshr_entries[j].valid = true;
                     nxt.mshr_entries[j].issued = false;
                     nxt.mshr_entries[j].addr = get_addr(f.set_idx, f.tag, 0);
+                    nxt.mshr_entries[j].is_prefetch = in.dcache2mshr->mshr_req[i].is_prefetch;
                     nxt.mshr_count = nxt.mshr_count + 1;
+#if !BSD_CONFIG && defined(CONFIG_PERF_COUNTER)
+                    if (ctx != nullptr && !in.dcache2mshr->mshr_req[i].is_prefetch) {
+                        ctx->perf.l1d_miss_mshr_alloc++;
+                    }
+#endif
                     break;
                 }
             }
@@ -158,6 +178,6 @@ void MSHR::dump_debug_state(FILE *out) const {
     fprintf(out, "  AXI Resp Hold Valid: %d, ID: %u\n", cur.axi_resp_hold_valid, cur.axi_resp_hold_id);
     for (uint32_t i = 0; i < DCACHE_MSHR_ENTRIES; i++) {
         const MSHREntry &e = cur.mshr_entries[i];
-        fprintf(out, "  Entry %u: Valid: %d, Issued: %d, Addr: 0x%08x\n", i, e.valid, e.issued, e.addr);
+        fprintf(out, "  Entry %u: Valid: %d, Issued: %d, Prefetch: %d, Addr: 0x%08x\n", i, e.valid, e.issued, e.is_prefetch, e.addr);
     }
 }
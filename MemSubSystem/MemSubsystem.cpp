@@ -2,6 +2,7 @@
 #include "config.h"
 #include "icache/GenericTable.h"
 #include <assert.h>
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
 #include <cstring>
@@ -72,30 +73,27 @@ struct AxiLlcTableRuntime {
     return read_req;
   }
 
-  static DynamicTableWriteReq make_write_req(
+  // 写视图直接引用 req 的 payload/byte_enable，按 way 偏移写入行内一段，
+  // 不再每拍构造整行大小的 DynamicTableWriteReq。
+  static DynamicTableWriteView make_write_view(
       const axi_interconnect::AXI_LLC_TableReq_t &req, uint32_t row_bytes,
       uint32_t unit_bytes) {
-    DynamicTableWriteReq write_req;
-    write_req.enable = req.enable && req.write;
-    write_req.address = req.index;
-    write_req.payload.reset(row_bytes);
-    write_req.chunk_enable.assign(row_bytes, 0);
-    if (!write_req.enable) {
-      return write_req;
+    DynamicTableWriteView write_view;
+    write_view.enable = req.enable && req.write;
+    write_view.address = req.index;
+    if (!write_view.enable) {
+      return write_view;
     }
     const size_t base =
         unit_bytes == 0 ? 0 : static_cast<size_t>(req.way) * unit_bytes;
     const size_t copy_bytes =
-        std::min(req.payload.size(), row_bytes > base ? row_bytes - base : 0u);
-    if (copy_bytes == 0) {
-      return write_req;
-    }
-    std::memcpy(write_req.payload.data() + base, req.payload.data(), copy_bytes);
-    const size_t en_bytes = std::min(req.byte_enable.size(), copy_bytes);
-    for (size_t i = 0; i < en_bytes; ++i) {
-      write_req.chunk_enable[base + i] = req.byte_enable[i];
-    }
-    return write_req;
+        std::min({req.payload.size(), req.byte_enable.size(),
+                  row_bytes > base ? row_bytes - base : size_t{0}});
+    write_view.chunk_offset = static_cast<uint32_t>(base);
+    write_view.chunk_count = static_cast<uint32_t>(copy_bytes);
+    write_view.payload = req.payload.data();
+    write_view.chunk_enable = req.byte_enable.data();
+    return write_view;
   }
 
   void configure(const axi_interconnect::AXI_LLCConfig &cfg) {
@@ -124,7 +122,13 @@ struct AxiLlcTableRuntime {
   }
 
   void comb_outputs() {
-    lookup_in = {};
+    // 只清有效位与内容，保留 bytes 的容量，避免逐拍重新分配
+    lookup_in.data_valid = false;
+    lookup_in.meta_valid = false;
+    lookup_in.repl_valid = false;
+    lookup_in.data.bytes.clear();
+    lookup_in.meta.bytes.clear();
+    lookup_in.repl.bytes.clear();
     if (!enabled) {
       return;
     }
@@ -132,18 +136,21 @@ struct AxiLlcTableRuntime {
       return;
     }
 
-    DynamicTablePayload data_payload;
-    DynamicTablePayload meta_payload;
-    DynamicTablePayload repl_payload;
-    lookup_in.data_valid =
-        data.debug_read_row(lookup_pending_index, data_payload);
-    lookup_in.meta_valid =
-        meta.debug_read_row(lookup_pending_index, meta_payload);
-    lookup_in.repl_valid =
-        repl.debug_read_row(lookup_pending_index, repl_payload);
-    lookup_in.data.bytes = data_payload.bytes;
-    lookup_in.meta.bytes = meta_payload.bytes;
-    lookup_in.repl.bytes = repl_payload.bytes;
+    copy_row(data, lookup_in.data_valid, lookup_in.data.bytes);
+    copy_row(meta, lookup_in.meta_valid, lookup_in.meta.bytes);
+    copy_row(repl, lookup_in.repl_valid, lookup_in.repl.bytes);
+  }
+
+  // 行视图直接拷入 lookup_in 中已有的缓冲，复用其容量
+  void copy_row(const DynamicGenericTable<SramTablePolicy> &table, bool &valid,
+                std::vector<uint8_t> &dst) const {
+    const DynamicTableRowView row = table.peek_row_view(lookup_pending_index);
+    valid = row.data != nullptr;
+    if (valid) {
+      dst.assign(row.data, row.data + row.size);
+    } else {
+      dst.assign(table.payload_bytes(), 0);
+    }
   }
 
   void seq(const axi_interconnect::AXI_LLC_TableOut_t &table_out) {
@@ -162,14 +169,14 @@ struct AxiLlcTableRuntime {
       return;
     }
     const auto data_write =
-        make_write_req(table_out.data, config.ways * config.line_bytes,
-                       config.line_bytes);
-    const auto meta_write = make_write_req(
+        make_write_view(table_out.data, config.ways * config.line_bytes,
+                        config.line_bytes);
+    const auto meta_write = make_write_view(
         table_out.meta,
         config.ways * axi_interconnect::AXI_LLC_META_ENTRY_BYTES,
         axi_interconnect::AXI_LLC_META_ENTRY_BYTES);
     const auto repl_write =
-        make_write_req(table_out.repl, axi_interconnect::AXI_LLC_REPL_BYTES, 0);
+        make_write_view(table_out.repl, axi_interconnect::AXI_LLC_REPL_BYTES, 0);
 
     data.seq({}, data_write);
     meta.seq({}, meta_write);
@@ -612,16 +619,25 @@ void MemSubsystem::init() {
   mem_route_block.out.ptw_grant = &ptw_grant;   // MemRouteBlock output → PTW grant signals
   mem_route_block.out.wakeup = &wakeup;         // MemRouteBlock output → LSU wakeup signals
 
+  dcache_.out.dcache2pf = &dcache_pf_io_;   // DCache load outcomes → L1D prefetcher
+  l1d_pf_.in.dcache2pf = &dcache_pf_io_;
+  l1d_pf_.in.mshr2dcache = &mshr_dcache_io_; // MSHR fill → prefetch tracking
+  l1d_pf_.out.pf2dcache = &dcache_req_mux_;  // prefetch probe → idle DCache load port
+
   wb_.bind_context(ctx);
+  mshr_.bind_context(ctx);
+  l1d_pf_.bind_context(ctx);
 
   // ── Initialise sub-modules ─────────────────────────────────────────────────
   mshr_.init();
   wb_.init();
   dcache_.init();
+  l1d_pf_.init();
   peripheral_model_.bind(csr, memory);
   peripheral_axi_.peripheral_req = peripheral_req;
   peripheral_axi_.peripheral_resp = peripheral_resp;
   peripheral_axi_.peripheral_model = &peripheral_model_;
+  peripheral_axi_.ctx = ctx;
   peripheral_axi_.init();
 
   ptw_block.init();
@@ -641,6 +657,7 @@ void MemSubsystem::init() {
   dcache_mshr_io_ = {};
   wb_dcache_io_ = {};
   dcache_wb_io_ = {};
+  dcache_pf_io_ = {};
 
   memset(dcache_line_read_req_, 0, sizeof(dcache_line_read_req_));
   memset(dcache_line_read_resp_, 0, sizeof(dcache_line_read_resp_));
@@ -675,9 +692,9 @@ void MemSubsystem::init() {
   axi_kit_runtime->mmio.add_device(UART_ADDR_BASE, UART_MMIO_SIZE,
                                    &axi_kit_runtime->uart0);
   axi_kit_runtime->ddr.init();
-  static bool printed_axi_cfg = false;
-  if (!printed_axi_cfg) {
-    printed_axi_cfg = true;
+  // 多个实例可能在不同线程上同时 init，配置只打印一次
+  static std::atomic<bool> printed_axi_cfg{false};
+  if (!printed_axi_cfg.exchange(true)) {
     printf(
         "[CONFIG][AXI] ddr_read_latency=%ucy ddr_write_resp_latency=%ucy "
         "ddr_beat=%uB wq=%u wag=%ucy wfifo=%u wdrain=%ucy whi=%u wlo=%u "
@@ -756,6 +773,7 @@ void MemSubsystem::dump_debug_state(FILE *out) const {
   mshr_.dump_debug_state(out);
   wb_.dump_debug_state(out);
   dcache_.dump_debug_state(out);
+  l1d_pf_.dump_debug_state(out);
 }
 
 void MemSubsystem::comb() {
@@ -834,16 +852,24 @@ void MemSubsystem::comb() {
   mshr_.comb_outputs_dcache();
   mshr_.comb_outputs_axi();
   mem_route_block.comb_request();
+#ifdef CONFIG_L1D_PREFETCH
+  l1d_pf_.comb_issue();
+#endif
 
-  Dcache_Read(dcache_line_read_req_,
+  Dcache_Read(dcache_.arrays,
+              dcache_line_read_req_,
               dcache_line_read_resp_,
               fill_out_,
               fill_in_);
 
   dcache_.stage2_comb();
-  Dcache_Write(pending_writes_,
+  Dcache_Write(dcache_.arrays,
+               pending_writes_,
                lru_updates_,
                fill_writes_);
+#ifdef CONFIG_L1D_PREFETCH
+  l1d_pf_.comb_train();
+#endif
 
   mem_route_block.comb_response();
   dcache_.stage1_comb();
@@ -982,6 +1008,9 @@ void MemSubsystem::seq() {
   dcache_.seq();
   mshr_.seq();
   wb_.seq();
+#ifdef CONFIG_L1D_PREFETCH
+  l1d_pf_.seq();
+#endif
   peripheral_axi_.seq();
   mem_route_block.seq();
 #if AXI_KIT_RUNTIME_ENABLED
@@ -1,26 +1,26 @@
 #include "PeripheralAxi.h"
 #include "PeripheralModel.h"
+#include "SimCpu.h"
 #include "config.h"
-#include "oracle.h"
 
 namespace {
 bool is_local_special_read_addr(uint32_t addr) {
   return addr == OPENSBI_TIMER_LOW_ADDR || addr == OPENSBI_TIMER_HIGH_ADDR;
 }
 
-uint32_t local_special_read_data(uint32_t addr) {
+uint32_t local_special_read_data(SimContext *ctx, uint32_t addr) {
   if (addr == OPENSBI_TIMER_LOW_ADDR) {
 #ifdef CONFIG_BPU
-    return static_cast<uint32_t>(sim_time);
+    return static_cast<uint32_t>(ctx->sim_time);
 #else
-    return static_cast<uint32_t>(get_oracle_timer());
+    return static_cast<uint32_t>(ctx->cpu->oracle.pop_timer());
 #endif
   }
   if (addr == OPENSBI_TIMER_HIGH_ADDR) {
 #ifdef CONFIG_BPU
-    return static_cast<uint32_t>(sim_time >> 32);
+    return static_cast<uint32_t>(ctx->sim_time >> 32);
 #else
-    return static_cast<uint32_t>(get_oracle_timer());
+    return static_cast<uint32_t>(ctx->cpu->oracle.pop_timer());
 #endif
   }
   return 0;
@@ -148,7 +148,7 @@ void PeripheralAxi::comb_inputs() {
         nxt.addr = peripheral_req->mmio_addr;
         nxt.wdata = 0;
         nxt.func3 = peripheral_req->mmio_fun3;
-        nxt.rdata = local_special_read_data(peripheral_req->mmio_addr);
+        nxt.rdata = local_special_read_data(ctx, peripheral_req->mmio_addr);
         nxt.req_id = 0;
         return;
       }
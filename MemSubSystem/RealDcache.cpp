@@ -4,7 +4,7 @@
 #include <MemUtils.h>
 
 void RealDcache::init() {
-    init_dcache();
+    init_dcache(arrays);
     s1s2_cur = {};
     s1s2_nxt = {};
 }
@@ -63,6 +63,8 @@ void RealDcache::stage1_comb() {
             slot.addr     = req.addr;
             slot.req_id   = req.req_id;
             slot.replayed  = replay;
+            slot.pc_hash  = req.pc_hash;
+            slot.is_prefetch = req.is_prefetch;
             AddrFields f  = decode(req.addr);
             out.dcachereadreq[i]->set_idx = f.set_idx;
 
@@ -72,6 +74,7 @@ void RealDcache::stage1_comb() {
             out.dcache2mshr->find_req[i].valid = true;
             out.dcache2mshr->find_req[i].set_idx = f.set_idx;
             out.dcache2mshr->find_req[i].tag = f.tag;
+            out.dcache2mshr->find_req[i].is_prefetch = req.is_prefetch;
         }        
     }
 
@@ -125,6 +128,7 @@ void RealDcache::stage2_comb() {
     memset(out.dcache2mshr->mshr_req, 0, sizeof(out.dcache2mshr->mshr_req));
     memset(&out.dcache2wb->dirty_info, 0, sizeof(out.dcache2wb->dirty_info));
     memset(&out.dcache2mshr->fill_resp, 0, sizeof(out.dcache2mshr->fill_resp));
+    out.dcache2pf->clear();
     
     *out.fill_write = {};
     for(int i=0;i<LSU_LDU_COUNT + LSU_STA_COUNT;i++){
@@ -188,7 +192,24 @@ void RealDcache::stage2_comb() {
             }
         }
 
-        
+        const bool present = hit_way >= 0 || in.wb2dcache->bypass_resp[i].valid;
+        if (slot.is_prefetch) {
+            // L1D prefetch probe: never answers the LSU. Presence is resolved
+            // here, MSHR allocation is decided after the demand ports below.
+            PfProbeResp &probe = out.dcache2pf->probe_resp;
+            probe.valid   = true;
+            probe.addr    = slot.addr;
+            probe.present = present || in.mshr2dcache->find_resp[i].valid;
+            continue;
+        }
+        PfTrainEvent &train = out.dcache2pf->train[i];
+        train.valid    = true;
+        train.addr     = slot.addr;
+        train.req_id   = slot.req_id;
+        train.pc_hash  = slot.pc_hash;
+        train.miss     = !present;
+        train.mshr_hit = !present && in.mshr2dcache->find_resp[i].valid;
+
          if(in.wb2dcache->bypass_resp[i].valid){
             resp.valid = true;
             resp.data = in.wb2dcache->bypass_resp[i].data;
@@ -334,6 +355,27 @@ void RealDcache::stage2_comb() {
         }
     }
 
+    // ── L1D prefetch allocation ──────────────────────────────────────────────
+    // Lower priority than demand: the probe only takes an MSHR after this
+    // cycle's demand misses and while L1D_PF_MSHR_RESERVE entries stay free.
+    PfProbeResp &probe = out.dcache2pf->probe_resp;
+    if (probe.valid && !probe.present) {
+        int demand_allocs = 0;
+        for (int k = 0; k < DCACHE_PF_MSHR_REQ_SLOT; k++) {
+            const MSHRReq &req = out.dcache2mshr->mshr_req[k];
+            if (!req.valid) continue;
+            demand_allocs++;
+            if (cache_line_match(req.addr, probe.addr)) probe.present = true;
+        }
+        if (!probe.present && mshr_free_entries - demand_allocs > L1D_PF_MSHR_RESERVE) {
+            MSHRReq &pf_req    = out.dcache2mshr->mshr_req[DCACHE_PF_MSHR_REQ_SLOT];
+            pf_req.valid       = true;
+            pf_req.addr        = probe.addr;
+            pf_req.is_prefetch = true;
+            probe.issued       = true;
+        }
+    }
+
     out.dcache2lsu->mshr_fill = out.fill_write->valid; // Inform LSU about MSHR fill in the same cycle, so that it can prioritize the waiting load/store to consume the fill data and free up the MSHR entry as soon as possible, improving performance when there are back-to-back misses.
 }
 
@@ -4,21 +4,25 @@
 #include "IO.h"
 #include "config.h"
 
-extern uint32_t tag_array  [DCACHE_SETS_NUM][DCACHE_WAYS_NUM];
-extern uint32_t data_array [DCACHE_SETS_NUM][DCACHE_WAYS_NUM][DCACHE_WORD_NUM];
-extern wire<1>  valid_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM];
-extern wire<1>  dirty_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM];
-
 static_assert((DCACHE_WAYS_NUM & (DCACHE_WAYS_NUM - 1)) == 0,
               "tree-PLRU requires power-of-two DCACHE_WAYS_NUM");
 constexpr int DCACHE_PLRU_TREE_BITS =
     (DCACHE_WAYS_NUM > 1) ? (DCACHE_WAYS_NUM - 1) : 1;
-extern wire<1>  plru_tree_state[DCACHE_SETS_NUM][DCACHE_PLRU_TREE_BITS];
+
+// DCache 存储阵列：每个 RealDcache 一份，经下方 Dcache_* 函数读写
+struct DcacheArrays {
+    uint32_t tag_array  [DCACHE_SETS_NUM][DCACHE_WAYS_NUM];
+    uint32_t data_array [DCACHE_SETS_NUM][DCACHE_WAYS_NUM][DCACHE_WORD_NUM];
+    wire<1>  valid_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM];
+    wire<1>  dirty_array[DCACHE_SETS_NUM][DCACHE_WAYS_NUM];
+    wire<1>  plru_tree_state[DCACHE_SETS_NUM][DCACHE_PLRU_TREE_BITS];
+};
 
 struct MSHRFINDReq{
     wire<1> valid;
     wire<DCACHE_SET_BITS> set_idx;
     wire<DCACHE_TAG_BITS> tag;
+    wire<1> is_prefetch; // prefetch probes must not promote a prefetch entry to demand
 };
 struct MSHRFINDResp{
     wire<1> valid;
@@ -28,8 +32,14 @@ struct MSHRFINDResp{
 struct MSHRReq{
     wire<1> valid;
     wire<32> addr;
+    wire<1> is_prefetch;
 };
 
+// mshr_req slot layout: [0] load miss, [1] store miss, [2] L1D prefetch.
+constexpr int DCACHE_PF_MSHR_REQ_SLOT = 2;
+static_assert(DCACHE_MISS_NUM > DCACHE_PF_MSHR_REQ_SLOT,
+              "DCACHE_MISS_NUM must leave a slot for L1D prefetch allocation");
+
 struct MSHR_FILLReq{
     wire<1> valid;
     wire<DCACHE_WAY_BITS> way_idx;
@@ -153,6 +163,33 @@ struct FillOut {
     wire<DCACHE_SET_BITS> set_idx;
 };
 
+// ─────────────────────────────────────────────────────────────────────────────
+// RealDcache stage2 → DcachePrefetcher
+// ─────────────────────────────────────────────────────────────────────────────
+// Outcome of one demand load resolved in stage2 (replayed slots are not reported).
+struct PfTrainEvent {
+    wire<1> valid;
+    wire<32> addr;
+    wire<32> req_id;  // MemRouteBlock ids (icache / PTW) are not trained on
+    wire<L1D_PF_PC_HASH_WIDTH> pc_hash;
+    wire<1> miss;     // not in cache or WB
+    wire<1> mshr_hit; // miss on a line already in flight
+};
+// Outcome of the prefetch tag probe resolved in stage2.
+struct PfProbeResp {
+    wire<1> valid;
+    wire<32> addr;
+    wire<1> present;  // line already in cache / WB / MSHR
+    wire<1> issued;   // MSHR allocated through mshr_req[DCACHE_PF_MSHR_REQ_SLOT]
+};
+struct DcachePfIO {
+    PfTrainEvent train[LSU_LDU_COUNT];
+    PfProbeResp probe_resp;
+    void clear() {
+        memset(this, 0, sizeof(DcachePfIO));
+    }
+};
+
 struct DcacheINIO {
     LsuDcacheIO  *lsu2dcache  = nullptr;  // LSU → DCache requests
     MSHRDcacheIO *mshr2dcache = nullptr;  // MSHR fill/free → DCache
@@ -165,6 +202,7 @@ struct DcacheOUTIO {
     DcacheLsuIO  *dcache2lsu  = nullptr;  // DCache → LSU responses
     DcacheMSHRIO *dcache2mshr = nullptr;  // DCache miss alloc → MSHR
     DcacheWBIO   *dcache2wb   = nullptr;  // DCache bypass/merge req → WB
+    DcachePfIO   *dcache2pf   = nullptr;  // DCache load outcomes / probe result → L1D prefetcher
     PendingWrite *pendingwrite[LSU_LDU_COUNT + LSU_STA_COUNT]; // For tracking pending misses for the store queue and load queue
     LruUpdate *lru_updates[LSU_LDU_COUNT + LSU_STA_COUNT]; // For tracking PLRU updates for the store queue and load queue
     FILLWrite *fill_write; // For tracking MSHR fill responses for the store queue and load queue
@@ -181,19 +219,19 @@ struct AddrFields {
     wire<DCACHE_OFFSET_BITS> word_off; // which 32-bit word within the cacheline [4:2]
 };
 
-void init_dcache();
+void init_dcache(DcacheArrays &a);
 AddrFields decode(uint32_t addr);
 uint32_t get_addr(uint32_t set_idx, uint32_t tag, uint32_t word_off);
 uint32_t choose_plru_tree_victim(const bool plru_tree[DCACHE_PLRU_TREE_BITS], const bool valid[DCACHE_WAYS_NUM]);
-void plru_tree_touch(uint32_t set_idx, uint32_t way);
+void plru_tree_touch(DcacheArrays &a, uint32_t set_idx, uint32_t way);
 
 
-void write_dcache_line(uint32_t set_idx, uint32_t way,uint32_t tag, uint32_t data[DCACHE_WORD_NUM]);
+void write_dcache_line(DcacheArrays &a, uint32_t set_idx, uint32_t way, uint32_t tag, const uint32_t data[DCACHE_WORD_NUM]);
 void apply_strobe(uint32_t &dst, uint32_t src, uint8_t strb);
 
 bool cache_line_match(uint32_t addr1, uint32_t addr2);
 
-void Dcache_Read(const DcacheLineReadReq read_req[LSU_LDU_COUNT+LSU_STA_COUNT],DcacheLineReadResp resp[LSU_LDU_COUNT+LSU_STA_COUNT], const FillOut &fillout,FillIn &fillin);
-void Dcache_Write(const PendingWrite pws[LSU_LDU_COUNT+LSU_STA_COUNT], const LruUpdate lru_updates[LSU_LDU_COUNT+LSU_STA_COUNT], const FILLWrite &fillwrite);
+void Dcache_Read(const DcacheArrays &a, const DcacheLineReadReq read_req[LSU_LDU_COUNT+LSU_STA_COUNT],DcacheLineReadResp resp[LSU_LDU_COUNT+LSU_STA_COUNT], const FillOut &fillout,FillIn &fillin);
+void Dcache_Write(DcacheArrays &a, const PendingWrite pws[LSU_LDU_COUNT+LSU_STA_COUNT], const LruUpdate lru_updates[LSU_LDU_COUNT+LSU_STA_COUNT], const FILLWrite &fillwrite);
 
 bool CheckAddr(uint32_t addr1, uint8_t strb1, uint32_t addr2, uint8_t strb2);
\ No newline at end of file
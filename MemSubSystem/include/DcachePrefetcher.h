@@ -0,0 +1,96 @@
+#pragma once
+
+#include "DcacheConfig.h"
+#include "IO.h"
+#include "config.h"
+#include <cstdint>
+#include <cstdio>
+
+class SimContext;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// DcachePrefetcher — L1D hardware prefetch engine
+//
+// Training: RealDcache stage2 reports every demand load it resolves (hit, miss
+// on an in-flight MSHR, new miss) together with the load's PC hash.
+//   - stride: PC-indexed table, triggers once the same delta is seen twice;
+//   - stream: sequential-line detector trained on demand misses and on the
+//     first demand hit of a prefetched line, so a covered stream keeps running.
+// Candidates stay in the trigger's 4KB page and wait in a small queue. One
+// candidate per cycle is injected into an idle load port as a tag probe;
+// RealDcache drops it if the line is present and otherwise allocates an MSHR
+// only while L1D_PF_MSHR_RESERVE entries stay free for demand misses.
+// Issued lines are tracked until their first demand access to measure
+// accuracy, coverage and lateness.
+// ─────────────────────────────────────────────────────────────────────────────
+
+constexpr int L1D_PF_STRIDE_IDX_BITS = clog2(L1D_PF_STRIDE_ENTRIES);
+
+struct PfStrideEntry {
+    reg<1> valid;
+    reg<L1D_PF_PC_HASH_WIDTH - L1D_PF_STRIDE_IDX_BITS> tag; // pc_hash bits above the index
+    reg<32> last_addr;
+    reg<32> stride;            // signed byte delta
+    reg<2> conf;
+};
+
+struct PfStreamEntry {
+    reg<1> valid;
+    reg<32> last_line;         // line number (addr >> DCACHE_OFFSET_BITS)
+    reg<1> dir_valid;
+    reg<1> dir_down;
+    reg<2> conf;
+    reg<32> lru_stamp;
+};
+
+struct PfTrackEntry {
+    reg<1> valid;
+    reg<1> filled;             // MSHR fill seen; a later demand hit is timely
+    reg<32> line_addr;
+};
+
+struct DcachePrefetcherState {
+    PfStrideEntry stride[L1D_PF_STRIDE_ENTRIES];
+    PfStreamEntry stream[L1D_PF_STREAM_ENTRIES];
+    reg<32> stream_stamp;
+
+    reg<32> queue[L1D_PF_QUEUE_SIZE]; // candidate line addresses
+    reg<8> queue_head;
+    reg<8> queue_count;
+
+    PfTrackEntry track[L1D_PF_TRACK_SIZE];
+    reg<8> track_ptr;          // FIFO replacement
+};
+
+struct DcachePrefetcherIn {
+    DcachePfIO   *dcache2pf   = nullptr; // stage2 load outcomes / probe result
+    MSHRDcacheIO *mshr2dcache = nullptr; // fill_req marks tracked lines filled
+};
+
+struct DcachePrefetcherOut {
+    LsuDcacheIO  *pf2dcache   = nullptr; // DCache request mux: probe goes to an idle load port
+};
+
+class DcachePrefetcher {
+public:
+    void init();
+    void comb_issue();  // after MemRouteBlock::comb_request, before stage1
+    void comb_train();  // after stage2
+    void seq();
+
+    DcachePrefetcherIn in;
+    DcachePrefetcherOut out;
+
+    DcachePrefetcherState cur, nxt;
+
+    void dump_debug_state(FILE *out) const;
+#if !BSD_CONFIG
+    void bind_context(SimContext *c) { ctx = c; }
+    SimContext *ctx = nullptr;
+#endif
+private:
+    void train_stride(const PfTrainEvent &ev);
+    void train_stream(const PfTrainEvent &ev);
+    bool push_candidate(uint32_t trigger_addr, uint32_t cand_addr);
+    int find_track(uint32_t line_addr) const;
+};
@@ -13,6 +13,7 @@ struct MSHREntry {
     reg<1> valid;
     reg<1> issued;
     reg<32> addr;
+    reg<1> is_prefetch; // allocated by the L1D prefetcher; AR issue yields to demand entries
 };
 
 
@@ -79,4 +80,8 @@ public:
     MSHR_STATE cur,nxt;
 
     void dump_debug_state(FILE *out) const;
+#if !BSD_CONFIG
+    void bind_context(SimContext *c) { ctx = c; }
+    SimContext *ctx = nullptr;
+#endif
 };
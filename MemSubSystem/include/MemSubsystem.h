@@ -1,5 +1,6 @@
 #pragma once
 
+#include "DcachePrefetcher.h"
 #include "IO.h"
 #include "MSHR.h"
 #include "MemPtwBlock.h"
@@ -95,6 +96,7 @@ private:
   RealDcache  dcache_;
   MSHR          mshr_;
   WriteBuffer   wb_;
+  DcachePrefetcher l1d_pf_;
   PeripheralAxi peripheral_axi_;
   PeripheralModel peripheral_model_;
   MemPtwBlock   ptw_block;
@@ -108,6 +110,8 @@ private:
   WBDcacheIO wb_dcache_io_{};
   DcacheWBIO dcache_wb_io_{};
 
+  DcachePfIO dcache_pf_io_{};
+
   DcacheLineReadResp dcache_line_read_resp_[LSU_LDU_COUNT + LSU_STA_COUNT]{};
   DcacheLineReadReq dcache_line_read_req_[LSU_LDU_COUNT + LSU_STA_COUNT]{};
   PendingWrite pending_writes_[LSU_LDU_COUNT + LSU_STA_COUNT]{};
@@ -6,6 +6,7 @@
 #include <cstring>
 
 class PeripheralModel;
+class SimContext;
 
 struct PeripheralAxiReadIn {
   bool req_ready = false;
@@ -67,6 +68,7 @@ public:
   PeripheralReqIO *peripheral_req = nullptr;
   PeripheralRespIO *peripheral_resp = nullptr;
   PeripheralModel *peripheral_model = nullptr;
+  SimContext *ctx = nullptr;
 
   void init();
   void comb_outputs();
@@ -21,6 +21,8 @@ struct S1S2Reg {
         reg<32>    addr     = 0;
         reg<32>     req_id   = 0;
         reg<1>    replayed  = false; // whether this load has been replayed due to MSHR full or conflict, used to avoid accepting new requests for the same load and causing starvation when there are multiple back-to-back misses
+        reg<L1D_PF_PC_HASH_WIDTH> pc_hash = 0; // load PC hash, reported to the L1D prefetcher
+        reg<1>    is_prefetch = false; // L1D prefetch tag probe: no LSU response
     } loads[LSU_LDU_COUNT];
 
     // Store slots
@@ -41,6 +43,7 @@ public:
 
     DcacheINIO in;
     DcacheOUTIO out;
+    DcacheArrays arrays; // tag/data/valid/dirty/PLRU 存储阵列
 
     void stage1_comb();
     void stage2_comb();
@@ -1,22 +1,20 @@
 #include "BackTop.h"
+#include "Checkpoint.h"
 #include "Csr.h"
 #include "IO.h"
 #include "PhysMemory.h"
 #include "RealLsu.h"
+#include "SimCpu.h"
 #include "config.h"
 #include "diff.h"
 #include "oracle.h"
 #include "ref.h"
 #include "util.h"
 
-#include <array>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <vector>
-#include <zlib.h>
-
-void init_diff_ckpt(CPU_state ckpt_state);
 
 namespace {
 MMUResultType to_lsu_mmu_result(TlbMmu::Result result) {
@@ -375,8 +373,11 @@ void BackTop::comb() {
       out.redirect_pc = csr->out.csr2front->epc;
     } else if (rob->out.rob_bcast->exception) {
       out.redirect_pc = csr->out.csr2front->trap_pc;
+    } else if (rob->out.rob_bcast->fuse_replay) {
+      out.redirect_pc = rob->out.rob_bcast->pc;
     } else {
-      out.redirect_pc = rob->out.rob_bcast->pc + 4;
+      out.redirect_pc =
+          rob->out.rob_bcast->pc + rob->out.rob_bcast->inst_bytes;
     }
     BE_LOG("flush redirect_pc=0x%08x", (uint32_t)out.redirect_pc);
   }
@@ -436,63 +437,6 @@ void BackTop::seq() {
   lsu->seq();
 }
 
-// --- 辅助函数：简化 zlib 读写 POD 类型 ---
-template <typename T> void gz_write_pod(gzFile file, const T &data) {
-  if (gzwrite(file, &data, sizeof(T)) != sizeof(T)) {
-    Assert(0 && "Error writing data to gzip file.");
-  }
-}
-
-template <typename T> void gz_read_pod(gzFile file, T &data) {
-  if (gzread(file, &data, sizeof(T)) != sizeof(T)) {
-    Assert(0 && "Error reading data from gzip file.");
-  }
-}
-
-namespace {
-constexpr uint64_t kCkptSimpointRamBytes = RAM_SIZE;
-constexpr uint64_t kGzChunkSize = 1ULL * 1024 * 1024 * 1024;
-constexpr uint32_t kCkptMagic = 0x006d6552u; // "Rem\0" little-endian
-constexpr uint32_t kCkptVersion = 2u;
-
-typedef struct CkptHeader {
-  uint32_t magic;
-  uint32_t version;
-  uint32_t ram_size;
-  uint32_t io_range_count;
-} CkptHeader;
-
-typedef struct CkptIoRange {
-  uint32_t base;
-  uint32_t size;
-} CkptIoRange;
-
-constexpr std::array<CkptIoRange, 4> kExpectedIoLayout = {
-    CkptIoRange{BOOT_IO_BASE, BOOT_IO_SIZE},
-    CkptIoRange{UART_ADDR_BASE, UART_MMIO_SIZE},
-    CkptIoRange{PLIC_ADDR_BASE, PLIC_MMIO_SIZE},
-    CkptIoRange{OPENSBI_TIMER_BASE, OPENSBI_TIMER_MMIO_SIZE},
-};
-
-void gz_read_exact(gzFile file, uint8_t *dst, uint64_t total_bytes) {
-  uint64_t remain = total_bytes;
-  while (remain > 0) {
-    const unsigned int chunk = static_cast<unsigned int>(
-        remain > kGzChunkSize ? kGzChunkSize : remain);
-    const int read_bytes = gzread(file, dst, chunk);
-    if (read_bytes < 0) {
-      Assert(0 && "Error: gzread failed during checkpoint restore.");
-    }
-    if (read_bytes == 0) {
-      Assert(0 && "Error: Unexpected EOF during checkpoint restore.");
-    }
-    dst += read_bytes;
-    remain -= static_cast<uint64_t>(read_bytes);
-  }
-}
-
-} // namespace
-
 void BackTop::load_image(const std::string &filename) {
   std::ifstream inst_data(filename, std::ios::binary);
   if (!inst_data.is_open()) {
@@ -519,24 +463,25 @@ void BackTop::load_image(const std::string &filename) {
   pmem_write(0x10000004, 0x00006000); // 和进入 OpenSBI 相关
 
 #ifdef CONFIG_DIFFTEST
-  init_difftest(size);
+  ctx->cpu->difftest.init(size);
 #endif
 
 #ifndef CONFIG_BPU
-  init_oracle(size);
+  ctx->cpu->oracle.init(size);
 #endif
 }
 
 void BackTop::restore_from_ref() {
   CPU_state state;
   uint8_t privilege;
-  get_state(state, privilege);
+  Difftest &difftest = ctx->cpu->difftest;
+  CPU_state &dut_cpu = difftest.dut_cpu;
+  difftest.get_state(state, privilege);
   number_PC = state.pc;
 
   csr->privilege = csr->privilege_1 = privilege;
   for (int i = 0; i < ARF_NUM; i++) {
-    prf->reg_file[i] = state.gpr[i];
-    prf->reg_file_1[i] = state.gpr[i];
+    prf->reg_file.force(i, state.gpr[i]);
   }
 
   for (int i = 0; i < CSR_NUM; i++) {
@@ -544,7 +489,7 @@ void BackTop::restore_from_ref() {
     csr->CSR_RegFile_1[i] = state.csr[i];
   }
 
-  // 同步 dut_cpu，全局参考路径（oracle/refetch 校验）依赖该镜像状态。
+  // 同步 dut_cpu，oracle/refetch 校验依赖该镜像状态。
   std::memcpy(dut_cpu.gpr, state.gpr, sizeof(dut_cpu.gpr));
   std::memcpy(dut_cpu.csr, state.csr, sizeof(dut_cpu.csr));
   dut_cpu.pc = state.pc;
@@ -566,56 +511,15 @@ void BackTop::restore_from_ref() {
 #ifndef CONFIG_BPU
   // FAST 模式从 ref 切换到 O3+oracle 时，oracle 也必须恢复到同一状态，
   // 否则首拍 refetch 会因为 PC 不一致触发断言。
-  init_oracle_ckpt(state, privilege);
+  ctx->cpu->oracle.init_ckpt(state, privilege);
 #endif
 }
 
 void BackTop::restore_checkpoint(const std::string &filename) {
-
-  std::string final_name = filename;
-  gzFile file = gzopen(final_name.c_str(), "rb");
-  if (!file && final_name.find(".gz") == std::string::npos) {
-    final_name += ".gz";
-    file = gzopen(final_name.c_str(), "rb");
-  }
-
-  if (!file) {
-    Assert(0 && "Error: Could not open checkpoint file");
-  }
-
-  // 与 SimpleSim/save_checkpoint 写入格式保持一致，确保反序列化对齐。
-  // 注意：reserve_* 当前在本模拟器中暂未使用，但必须读取以避免流错位。
-  typedef struct Ckpt_CPU_state {
-    uint32_t gpr[32];
-    uint32_t csr[21];
-    uint32_t pc;
-
-    uint32_t store_addr;
-    uint32_t store_data;
-    uint32_t store_strb;
-    bool store;
-    bool reserve_valid;
-    uint32_t reserve_addr;
-  } Ckpt_CPU_state;
-
-  Ckpt_CPU_state ckpt_state;
-  CkptHeader ckpt_header = {};
-  uint64_t interval_inst_count;
-
-  // 1. 恢复 header + 状态
-  gz_read_pod(file, ckpt_header);
-  Assert(ckpt_header.magic == kCkptMagic &&
-         "Error: Invalid checkpoint magic.");
-  Assert(ckpt_header.version == kCkptVersion &&
-         "Error: Unsupported checkpoint version.");
-  Assert(ckpt_header.ram_size == static_cast<uint32_t>(kCkptSimpointRamBytes) &&
-         "Error: Checkpoint RAM size mismatch.");
-  Assert(ckpt_header.io_range_count == kExpectedIoLayout.size() &&
-         "Error: Checkpoint IO layout count mismatch.");
-
-  gz_read_pod(file, ckpt_state);
-  gz_read_pod(file, interval_inst_count);
-  ckpt_interval_inst_count = interval_inst_count;
+  CkptSnapshot snap;
+  const std::string final_name = ckpt_restore(filename, snap);
+  const CkptCpuState &ckpt_state = snap.cpu;
+  ckpt_interval_inst_count = snap.interval_inst_count;
 
   CPU_state state;
   memcpy(state.gpr, ckpt_state.gpr, sizeof(state.gpr));
@@ -636,13 +540,11 @@ void BackTop::restore_checkpoint(const std::string &filename) {
   state.inst_idx = 0;
 
   number_PC = state.pc;
-  // 约束：当前 checkpoint 生成流程要求快照时处于 U 态，因此恢复时固定回到 U
-  // 态。 若未来支持在 S/M 态打点，需要把特权级一并写入并按快照值恢复。
-  csr->privilege = csr->privilege_1 = RISCV_MODE_U;
+  // v2 快照固定处于 U 态；v3 在文件中记录打点时的特权级。
+  csr->privilege = csr->privilege_1 = snap.privilege;
 
   for (int i = 0; i < ARF_NUM; i++) {
-    prf->reg_file[i] = state.gpr[i];
-    prf->reg_file_1[i] = state.gpr[i];
+    prf->reg_file.force(i, state.gpr[i]);
   }
 
   for (int i = 0; i < CSR_NUM; i++) {
@@ -650,7 +552,9 @@ void BackTop::restore_checkpoint(const std::string &filename) {
     csr->CSR_RegFile_1[i] = state.csr[i];
   }
 
-  // Populate global dut_cpu for Oracle state comparison
+  // Populate dut_cpu for Oracle state comparison
+  Difftest &difftest = ctx->cpu->difftest;
+  CPU_state &dut_cpu = difftest.dut_cpu;
   memcpy(dut_cpu.gpr, state.gpr, sizeof(dut_cpu.gpr));
   memcpy(dut_cpu.csr, state.csr, sizeof(dut_cpu.csr));
   dut_cpu.pc = state.pc;
@@ -665,46 +569,11 @@ void BackTop::restore_checkpoint(const std::string &filename) {
   lsu->nxt.lrsc_unit.reserve_valid = state.reserve_valid;
   lsu->nxt.lrsc_unit.reserve_addr = state.reserve_addr;
 
-  // 2. 恢复内存
-  if (pmem_ram_ptr() == nullptr) {
-    Assert(0 && "Error: Memory not allocated during checkpoint restore.");
-  }
-  pmem_clear_all();
-
-  std::cout << "Restoring Memory... format=simpoint-v2(header+ranges)"
-            << std::endl;
-
-  uint8_t *ram_dst = reinterpret_cast<uint8_t *>(pmem_ram_ptr());
-  gz_read_exact(file, ram_dst, kCkptSimpointRamBytes);
-
-  // 3. 恢复并校验 IO 布局（range descriptor + raw bytes）
-  for (uint32_t i = 0; i < ckpt_header.io_range_count; ++i) {
-    CkptIoRange range = {};
-    gz_read_pod(file, range);
-    const auto &expected = kExpectedIoLayout[i];
-    Assert(range.base == expected.base && range.size == expected.size &&
-           "Error: Checkpoint IO layout mismatch.");
-
-    std::vector<uint8_t> io_bytes(range.size, 0);
-    gz_read_exact(file, io_bytes.data(), io_bytes.size());
-    for (uint32_t off = 0; off + 4 <= range.size; off += 4) {
-      const uint32_t word =
-          static_cast<uint32_t>(io_bytes[off + 0]) |
-          (static_cast<uint32_t>(io_bytes[off + 1]) << 8) |
-          (static_cast<uint32_t>(io_bytes[off + 2]) << 16) |
-          (static_cast<uint32_t>(io_bytes[off + 3]) << 24);
-      if (word != 0) {
-        pmem_write(range.base + off, word);
-      }
-    }
-  }
-
-  gzclose(file);
   std::cout << "Checkpoint restored from " << final_name << std::endl;
 
-  init_diff_ckpt(state);
+  difftest.init_ckpt(state, snap.privilege);
 #ifndef CONFIG_BPU
-  init_oracle_ckpt(state, RISCV_MODE_U);
+  ctx->cpu->oracle.init_ckpt(state, snap.privilege);
 #endif
 
   // Ensure the pipeline starts with a refetch from the restored PC
@@ -0,0 +1,372 @@
+#include "Checkpoint.h"
+#include "PhysMemory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+constexpr uint64_t kGzChunkSize = 1ULL * 1024 * 1024 * 1024;
+constexpr unsigned kCkptMaxThreads = 16;
+
+[[noreturn]] void ckpt_fatal(const std::string &file, const char *msg) {
+  std::fprintf(stderr, "[Checkpoint] %s: %s\n", file.c_str(), msg);
+  std::exit(1);
+}
+
+// --- 辅助函数：简化 zlib 读 POD 类型 ---
+template <typename T>
+void gz_read_pod(gzFile file, T &data, const std::string &name) {
+  if (gzread(file, &data, sizeof(T)) != sizeof(T)) {
+    ckpt_fatal(name, "error reading data from gzip file");
+  }
+}
+
+void gz_read_exact(gzFile file, uint8_t *dst, uint64_t total_bytes,
+                   const std::string &name) {
+  uint64_t remain = total_bytes;
+  while (remain > 0) {
+    const unsigned int chunk = static_cast<unsigned int>(
+        remain > kGzChunkSize ? kGzChunkSize : remain);
+    const int read_bytes = gzread(file, dst, chunk);
+    if (read_bytes < 0) {
+      ckpt_fatal(name, "gzread failed during checkpoint restore");
+    }
+    if (read_bytes == 0) {
+      ckpt_fatal(name, "unexpected EOF during checkpoint restore");
+    }
+    dst += read_bytes;
+    remain -= static_cast<uint64_t>(read_bytes);
+  }
+}
+
+bool pread_exact(int fd, void *dst, size_t len, uint64_t offset) {
+  uint8_t *p = static_cast<uint8_t *>(dst);
+  while (len > 0) {
+    const ssize_t n = pread(fd, p, len, static_cast<off_t>(offset));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+  return true;
+}
+
+bool write_exact(int fd, const void *src, size_t len) {
+  const uint8_t *p = static_cast<const uint8_t *>(src);
+  while (len > 0) {
+    const ssize_t n = write(fd, p, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+unsigned ckpt_thread_count(size_t jobs) {
+  return std::max(1u, std::min({std::thread::hardware_concurrency(),
+                                kCkptMaxThreads,
+                                static_cast<unsigned>(jobs)}));
+}
+
+// 在 threads 个线程上对 [0, jobs) 调用 fn(i)，按原子游标领取任务。
+template <typename Fn> void parallel_for(size_t jobs, unsigned threads, Fn fn) {
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next.fetch_add(1); i < jobs; i = next.fetch_add(1)) {
+      fn(i);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (std::thread &t : pool) {
+    t.join();
+  }
+}
+
+void check_header(const CkptHeader &header, const std::string &name) {
+  if (header.magic != kCkptMagic) {
+    ckpt_fatal(name, "invalid checkpoint magic");
+  }
+  if (header.ram_size != static_cast<uint32_t>(kCkptSimpointRamBytes)) {
+    ckpt_fatal(name, "checkpoint RAM size mismatch");
+  }
+  if (header.io_range_count != kExpectedIoLayout.size()) {
+    ckpt_fatal(name, "checkpoint IO layout count mismatch");
+  }
+}
+
+void check_io_range(const CkptIoRange &range, uint32_t i,
+                    const std::string &name) {
+  const auto &expected = kExpectedIoLayout[i];
+  if (range.base != expected.base || range.size != expected.size) {
+    ckpt_fatal(name, "checkpoint IO layout mismatch");
+  }
+}
+
+void restore_v2(const std::string &name, CkptSnapshot &snap) {
+  gzFile file = gzopen(name.c_str(), "rb");
+  if (!file) {
+    ckpt_fatal(name, "could not open checkpoint file");
+  }
+
+  // 1. 恢复 header + 状态
+  CkptHeader header = {};
+  gz_read_pod(file, header, name);
+  check_header(header, name);
+  if (header.version != kCkptVersionV2) {
+    ckpt_fatal(name, "unsupported checkpoint version");
+  }
+  gz_read_pod(file, snap.cpu, name);
+  gz_read_pod(file, snap.interval_inst_count, name);
+  snap.version = kCkptVersionV2;
+  // v2 生成流程要求快照时处于 U 态，文件中不记录特权级。
+  snap.privilege = 0;
+
+  // 2. 恢复内存
+  std::printf("Restoring Memory... format=simpoint-v2(header+ranges)\n");
+  gz_read_exact(file, reinterpret_cast<uint8_t *>(pmem_ram_ptr()),
+                kCkptSimpointRamBytes, name);
+
+  // 3. 恢复并校验 IO 布局（range descriptor + raw bytes）
+  for (uint32_t i = 0; i < header.io_range_count; ++i) {
+    CkptIoRange range = {};
+    gz_read_pod(file, range, name);
+    check_io_range(range, i, name);
+
+    std::vector<uint8_t> io_bytes(range.size, 0);
+    gz_read_exact(file, io_bytes.data(), io_bytes.size(), name);
+    for (uint32_t off = 0; off + 4 <= range.size; off += 4) {
+      const uint32_t word =
+          static_cast<uint32_t>(io_bytes[off + 0]) |
+          (static_cast<uint32_t>(io_bytes[off + 1]) << 8) |
+          (static_cast<uint32_t>(io_bytes[off + 2]) << 16) |
+          (static_cast<uint32_t>(io_bytes[off + 3]) << 24);
+      if (word != 0) {
+        pmem_write(range.base + off, word);
+      }
+    }
+  }
+
+  gzclose(file);
+}
+
+void restore_v3(const std::string &name, int fd, CkptSnapshot &snap) {
+  uint64_t pos = 0;
+  auto read_pod = [&](void *dst, size_t len) {
+    if (!pread_exact(fd, dst, len, pos)) {
+      ckpt_fatal(name, "truncated checkpoint header");
+    }
+    pos += len;
+  };
+
+  CkptHeader header = {};
+  CkptV3Meta meta = {};
+  read_pod(&header, sizeof(header));
+  check_header(header, name);
+  if (header.version != kCkptVersionV3) {
+    ckpt_fatal(name, "unsupported checkpoint version");
+  }
+  read_pod(&meta, sizeof(meta));
+  read_pod(&snap.cpu, sizeof(snap.cpu));
+  if (meta.chunk_bytes == 0 || header.ram_size % meta.chunk_bytes != 0 ||
+      meta.chunk_count > header.ram_size / meta.chunk_bytes) {
+    ckpt_fatal(name, "invalid chunk geometry");
+  }
+  snap.version = kCkptVersionV3;
+  snap.privilege = static_cast<uint8_t>(meta.privilege);
+  snap.interval_inst_count = meta.interval_inst_count;
+
+  for (uint32_t i = 0; i < header.io_range_count; ++i) {
+    CkptIoRange range = {};
+    read_pod(&range, sizeof(range));
+    check_io_range(range, i, name);
+  }
+  std::vector<CkptIoWord> io_words(meta.io_word_count);
+  read_pod(io_words.data(), io_words.size() * sizeof(CkptIoWord));
+  std::vector<CkptChunkEntry> chunks(meta.chunk_count);
+  read_pod(chunks.data(), chunks.size() * sizeof(CkptChunkEntry));
+
+  const uint32_t chunk_num = header.ram_size / meta.chunk_bytes;
+  for (const CkptChunkEntry &c : chunks) {
+    if (c.index >= chunk_num) {
+      ckpt_fatal(name, "chunk index out of range");
+    }
+  }
+
+  const unsigned threads = ckpt_thread_count(chunks.size());
+  std::printf("Restoring Memory... format=simpoint-v3(chunks=%u/%u, "
+              "chunk=%uKB, threads=%u)\n",
+              meta.chunk_count, chunk_num, meta.chunk_bytes >> 10, threads);
+
+  // 各线程直接解压到 pmem 对应偏移；未存储的块即全零，pmem_clear_all()
+  // 已保证其内容。
+  uint8_t *ram = reinterpret_cast<uint8_t *>(pmem_ram_ptr());
+  std::atomic<bool> failed{false};
+  parallel_for(chunks.size(), threads, [&](size_t i) {
+    thread_local std::vector<uint8_t> comp;
+    const CkptChunkEntry &c = chunks[i];
+    comp.resize(c.comp_bytes);
+    uLongf out_len = meta.chunk_bytes;
+    if (!pread_exact(fd, comp.data(), comp.size(), c.offset) ||
+        uncompress(ram + static_cast<uint64_t>(c.index) * meta.chunk_bytes,
+                   &out_len, comp.data(), comp.size()) != Z_OK ||
+        out_len != meta.chunk_bytes) {
+      failed = true;
+    }
+  });
+  if (failed) {
+    ckpt_fatal(name, "corrupted RAM chunk");
+  }
+
+  for (const CkptIoWord &w : io_words) {
+    pmem_write(w.addr, w.data);
+  }
+}
+} // namespace
+
+std::string ckpt_restore(const std::string &filename, CkptSnapshot &snap) {
+  std::string name = filename;
+  int fd = open(name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0 && name.find(".gz") == std::string::npos) {
+    name += ".gz";
+    fd = open(name.c_str(), O_RDONLY | O_CLOEXEC);
+  }
+  if (fd < 0) {
+    ckpt_fatal(filename, "could not open checkpoint file");
+  }
+  if (pmem_ram_ptr() == nullptr) {
+    ckpt_fatal(name, "memory not allocated during checkpoint restore");
+  }
+  pmem_clear_all();
+
+  uint8_t magic[2] = {};
+  if (!pread_exact(fd, magic, sizeof(magic), 0)) {
+    ckpt_fatal(name, "empty checkpoint file");
+  }
+  if (magic[0] == 0x1f && magic[1] == 0x8b) {
+    close(fd);
+    restore_v2(name, snap);
+  } else {
+    restore_v3(name, fd, snap);
+    close(fd);
+  }
+  return name;
+}
+
+void ckpt_save(const std::string &path, const CkptSnapshot &snap,
+               const uint32_t *ram,
+               const std::vector<uint64_t> &dirty_page_bits,
+               const std::unordered_map<uint32_t, uint32_t> &io_words) {
+  constexpr uint32_t kChunk = kCkptV3ChunkBytes;
+  constexpr uint32_t kPagesPerChunk = kChunk / 4096;
+  static_assert(kPagesPerChunk % 64 == 0, "chunk must cover whole bitmap words");
+  const uint32_t chunk_num = static_cast<uint32_t>(kCkptSimpointRamBytes / kChunk);
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(ram);
+
+  // 1. 并行压缩候选块；全零块（含空洞）省略。工作线程未绑定仿真实例，
+  //    镜像查询经调用线程的 PhysMemory 进行。
+  const PhysMemory &pmem = pmem_current();
+  std::vector<std::vector<uint8_t>> comp(chunk_num);
+  parallel_for(chunk_num, ckpt_thread_count(chunk_num), [&](size_t i) {
+    const uint64_t off = static_cast<uint64_t>(i) * kChunk;
+    bool dirty = false;
+    for (uint32_t w = 0; w < kPagesPerChunk / 64; ++w) {
+      const size_t idx = i * (kPagesPerChunk / 64) + w;
+      dirty |= idx < dirty_page_bits.size() && dirty_page_bits[idx] != 0;
+    }
+    if (!dirty && !pmem.image_has_data(off, kChunk)) {
+      return;
+    }
+    const uint8_t *src = bytes + off;
+    if (src[0] == 0 && std::memcmp(src, src + 1, kChunk - 1) == 0) {
+      return;
+    }
+    uLongf len = compressBound(kChunk);
+    comp[i].resize(len);
+    if (compress2(comp[i].data(), &len, src, kChunk, Z_DEFAULT_COMPRESSION) !=
+        Z_OK) {
+      ckpt_fatal(path, "zlib compression failed");
+    }
+    comp[i].resize(len);
+  });
+
+  // 2. 组装头部与索引
+  CkptHeader header = {kCkptMagic, kCkptVersionV3,
+                       static_cast<uint32_t>(kCkptSimpointRamBytes),
+                       static_cast<uint32_t>(kExpectedIoLayout.size())};
+  std::vector<CkptIoWord> words;
+  for (const auto &kv : io_words) {
+    if (kv.second != 0) {
+      words.push_back(CkptIoWord{kv.first, kv.second});
+    }
+  }
+  std::sort(words.begin(), words.end(),
+            [](const CkptIoWord &a, const CkptIoWord &b) { return a.addr < b.addr; });
+  std::vector<CkptChunkEntry> entries;
+  for (uint32_t i = 0; i < chunk_num; ++i) {
+    if (!comp[i].empty()) {
+      entries.push_back(
+          CkptChunkEntry{i, static_cast<uint32_t>(comp[i].size()), 0});
+    }
+  }
+  CkptV3Meta meta = {kChunk, static_cast<uint32_t>(entries.size()),
+                     static_cast<uint32_t>(words.size()), snap.privilege,
+                     snap.interval_inst_count};
+  uint64_t offset = sizeof(header) + sizeof(meta) + sizeof(snap.cpu) +
+                    sizeof(CkptIoRange) * kExpectedIoLayout.size() +
+                    sizeof(CkptIoWord) * words.size() +
+                    sizeof(CkptChunkEntry) * entries.size();
+  for (CkptChunkEntry &e : entries) {
+    e.offset = offset;
+    offset += e.comp_bytes;
+  }
+
+  // 3. 写临时文件后改名，避免留下半截 checkpoint
+  const std::string tmp = path + ".tmp";
+  const int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    ckpt_fatal(path, "could not create checkpoint file");
+  }
+  bool ok = write_exact(fd, &header, sizeof(header)) &&
+            write_exact(fd, &meta, sizeof(meta)) &&
+            write_exact(fd, &snap.cpu, sizeof(snap.cpu)) &&
+            write_exact(fd, kExpectedIoLayout.data(),
+                        sizeof(CkptIoRange) * kExpectedIoLayout.size()) &&
+            write_exact(fd, words.data(), sizeof(CkptIoWord) * words.size()) &&
+            write_exact(fd, entries.data(),
+                        sizeof(CkptChunkEntry) * entries.size());
+  for (const CkptChunkEntry &e : entries) {
+    ok = ok && write_exact(fd, comp[e.index].data(), e.comp_bytes);
+  }
+  ok = (close(fd) == 0) && ok;
+  if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    ckpt_fatal(path, "failed to write checkpoint file");
+  }
+  std::printf("[Checkpoint] Wrote %s (v3, chunks=%zu/%u, io_words=%zu, "
+              "priv=%u, interval=%llu)\n",
+              path.c_str(), entries.size(), chunk_num, words.size(),
+              static_cast<unsigned>(snap.privilege),
+              static_cast<unsigned long long>(snap.interval_inst_count));
+}
@@ -6,10 +6,11 @@
 
 namespace deadlock_debug {
 namespace {
-DumpCallback g_lsu_dump_cb = nullptr;
-DumpCallback g_mem_dump_cb = nullptr;
-DumpCallback g_front_dump_cb = nullptr;
-DumpCallback g_soc_dump_cb = nullptr;
+// 回调读取各自线程绑定的实例，因此按线程登记
+thread_local DumpCallback g_lsu_dump_cb = nullptr;
+thread_local DumpCallback g_mem_dump_cb = nullptr;
+thread_local DumpCallback g_front_dump_cb = nullptr;
+thread_local DumpCallback g_soc_dump_cb = nullptr;
 } // namespace
 
 void register_lsu_dump_cb(DumpCallback cb) { g_lsu_dump_cb = cb; }
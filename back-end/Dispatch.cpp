@@ -150,7 +150,8 @@ void Dispatch::comb_alloc() {
  * 功能: 根据 busy_table 与唤醒总线更新 inst_alloc 源操作数 busy 状态。
  * 输入依赖: busy_table, in.prf_awake, in.iss_awake, inst_alloc, out.dis2rob->valid。
  * 输出更新: inst_alloc[].src1_busy/src2_busy。
- * 约束: 同拍更早槽位若写同一 preg，则后续槽位对应源 busy 必须保持 true（防止过早就绪）。
+ * 约束: 同拍更早槽位若写同一 preg，则后续槽位对应源 busy 必须保持 true（防止过早就绪）；
+ *       Ren 消除的搬移不写 preg，不参与该判断。
  */
 void Dispatch::comb_wake() {
   for (int i = 0; i < DECODE_WIDTH; i++) {
@@ -164,7 +165,8 @@ void Dispatch::comb_wake() {
     apply_wakeup_to_uop(uop);
 
     for (int j = 0; j < i; j++) {
-      if (!out.dis2rob->valid[j] || !inst_alloc[j].dest_en) {
+      if (!out.dis2rob->valid[j] || !inst_alloc[j].dest_en ||
+          inst_alloc[j].move_elim) {
         continue;
       }
       if (inst_alloc[j].dest_areg == 0) {
@@ -440,7 +442,8 @@ void Dispatch::comb_fire() {
   }
 
   for (int i = 0; i < DECODE_WIDTH; i++) {
-    if (out.dis2rob->dis_fire[i] && inst_r[i].dest_en) {
+    if (out.dis2rob->dis_fire[i] && inst_r[i].dest_en &&
+        !inst_r[i].move_elim) {
       busy_table_1[inst_r[i].dest_preg] = true;
     }
   }
@@ -490,6 +493,7 @@ void Dispatch::comb_fire() {
       out.dis2lsu->rob_flag[k] = out.dis2rob->uop[inst_idx].rob_flag;
       out.dis2lsu->stq_flag[k] = out.dis2rob->uop[inst_idx].stq_flag;
       out.dis2lsu->func3[k] = out.dis2rob->uop[inst_idx].func3;
+      out.dis2lsu->ssit_idx[k] = inst_alloc[inst_idx].ssit_idx;
     }
   }
 
@@ -503,6 +507,8 @@ void Dispatch::comb_fire() {
           out.dis2rob->uop[inst_idx].br_mask & ~clear_mask;
       out.dis2lsu->ldq_rob_idx[k] = out.dis2rob->uop[inst_idx].rob_idx;
       out.dis2lsu->ldq_rob_flag[k] = out.dis2rob->uop[inst_idx].rob_flag;
+      out.dis2lsu->ldq_ssit_idx[k] = inst_alloc[inst_idx].ssit_idx;
+      out.dis2lsu->ldq_pf_pc_hash[k] = inst_alloc[inst_idx].pf_pc_hash;
     }
   }
 
@@ -771,6 +777,7 @@ DisIssIO::DisIssUop Dispatch::make_dis_iss_uop(const DispatchInst &inst) const {
   uop.ftq_idx = inst.ftq_idx;
   uop.ftq_offset = inst.ftq_offset;
   uop.is_atomic = inst.is_atomic;
+  uop.is_rvc = inst.is_rvc;
   uop.dest_en = inst.dest_en;
   uop.src1_en = inst.src1_en;
   uop.src2_en = inst.src2_en;
@@ -797,6 +804,11 @@ int Dispatch::decompose_inst(const DispatchInst &inst, UopPacket *out_uops) {
   int count = 0;
   InstType type = decode_inst_type(inst.type);
 
+  // Ren 已消除的搬移/清零不产生 uop：expect_mask 为 0，进入 ROB 即完成。
+  if (inst.move_elim) {
+    return 0;
+  }
+
   switch (type) {
   case ADD:
     out_uops[0].iq_id = IQ_INT;
@@ -852,11 +864,11 @@ int Dispatch::decompose_inst(const DispatchInst &inst, UopPacket *out_uops) {
     break;
 
   case JALR:
-    // JALR -> ADD (PC+4) + JUMP
+    // JALR -> ADD (PC+4) + JUMP，压缩指令链接地址为 PC+2
     out_uops[0].iq_id = IQ_INT;
     out_uops[0].uop = make_dis_iss_uop(inst);
     out_uops[0].uop.op = UOP_ADD;
-    out_uops[0].uop.imm = 4;
+    out_uops[0].uop.imm = inst.is_rvc ? 2 : 4;
     out_uops[0].uop.src1_en = false; // PC+4 不需要 src1
     out_uops[0].uop.src2_en = false; // PC+4 不需要 src2
 
@@ -869,11 +881,11 @@ int Dispatch::decompose_inst(const DispatchInst &inst, UopPacket *out_uops) {
     break;
 
   case JAL:
-    // JAL -> ADD (PC+4) + JUMP
+    // JAL -> ADD (PC+4) + JUMP，压缩指令链接地址为 PC+2
     out_uops[0].iq_id = IQ_INT;
     out_uops[0].uop = make_dis_iss_uop(inst);
     out_uops[0].uop.op = UOP_ADD;
-    out_uops[0].uop.imm = 4;
+    out_uops[0].uop.imm = inst.is_rvc ? 2 : 4;
     out_uops[0].uop.src1_en = false; // PC+4 不需要 src1
     out_uops[0].uop.src2_en = false; // PC+4 不需要 src2
 
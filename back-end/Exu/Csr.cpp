@@ -49,8 +49,12 @@ inline IrqState eval_interrupts(uint32_t mstatus, uint32_t mie_reg,
 } // namespace
 
 void Csr::init() {
-  CSR_RegFile[csr_misa] = 0x40141103;   // U/S/M  RV32I/A/M/B
-  CSR_RegFile_1[csr_misa] = 0x40141103; // U/S/M  RV32I/A/M/B
+  uint32_t misa = 0x40141103; // U/S/M  RV32I/A/M/B
+#ifdef CONFIG_RVC
+  misa |= 1u << 2; // C
+#endif
+  CSR_RegFile[csr_misa] = misa;
+  CSR_RegFile_1[csr_misa] = misa;
 }
 
 void Csr::comb_begin() {
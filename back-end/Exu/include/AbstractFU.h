@@ -80,7 +80,7 @@ private:
   std::deque<PipeEntry> pipeline_1;
 
   bool has_finished(const std::deque<PipeEntry> &pipe) const {
-    if (!pipe.empty() && pipe.front().done_cycle <= sim_time) {
+    if (!pipe.empty() && pipe.front().done_cycle <= sim_now()) {
       return true;
     }
     return false;
@@ -145,7 +145,7 @@ public:
       impl_compute(inst);
       PipeEntry entry{};
       entry.uop = inst;
-      entry.done_cycle = sim_time + latency - 1;
+      entry.done_cycle = sim_now() + latency - 1;
       pipeline_1.push_back(entry);
     }
 
@@ -189,7 +189,7 @@ public:
     done_cycle_1 = done_cycle;
     busy_1 = busy;
     out.ready = !busy;
-    out.complete = (busy && done_cycle <= sim_time);
+    out.complete = (busy && done_cycle <= sim_now());
     if (out.complete) {
       out.inst = current_inst;
     }
@@ -219,18 +219,18 @@ public:
       impl_compute(inst);
       int dyn_latency = calculate_latency(inst);
       current_inst_1 = inst;
-      done_cycle_1 = sim_time + dyn_latency;
+      done_cycle_1 = sim_now() + dyn_latency;
       busy_1 = true;
     }
 
-    out.complete = (busy_1 && done_cycle_1 <= sim_time);
+    out.complete = (busy_1 && done_cycle_1 <= sim_now());
     if (out.complete) {
       out.inst = current_inst_1;
     }
   }
 
   void comb_consume() override {
-    if (in.consume && busy_1 && done_cycle_1 <= sim_time) {
+    if (in.consume && busy_1 && done_cycle_1 <= sim_now()) {
       busy_1 = false;
       done_cycle_1 = 0;
     }
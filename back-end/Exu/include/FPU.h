@@ -1,6 +1,7 @@
 #pragma once
 #include "AbstractFU.h"  
 #include "IO.h"
+#include "SoftfloatGuard.h"
 #include "config.h"
 #include <cassert>
 #include <climits>
@@ -138,6 +139,7 @@ protected:
     float32_t a, b;
     a.v = inst.src1_rdata;
     b.v = inst.src2_rdata;
+    SoftfloatGuard softfloat_guard;
     // rm=7(DYN) is currently treated as RNE.
     softfloat_roundingMode = (inst.func3 == 7) ? 0 : inst.func3;
 
@@ -351,6 +351,7 @@ protected:
     uint32_t operand2 = inst.src2_rdata;
     uint32_t inst_pc = inst.pc;
     uint32_t pc_br = inst_pc + inst.imm;
+    uint32_t pc_seq = inst_pc + (inst.is_rvc ? 2 : 4);
     bool br_taken = true;
 
     if (inst.op == UOP_BR) {
@@ -401,7 +402,7 @@ protected:
     if (pred_taken) {
       pred_target = inst.ftq_next_pc;
     } else {
-      pred_target = inst_pc + 4;
+      pred_target = pc_seq;
     }
 
     // Verify
@@ -414,7 +415,7 @@ protected:
 #endif
 
     inst.br_taken = br_taken;
-    inst.diag_val = br_taken ? pc_br : (inst_pc + 4);
+    inst.diag_val = br_taken ? pc_br : pc_seq;
   }
 };
 
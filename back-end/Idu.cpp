@@ -1,17 +1,13 @@
 #include "Idu.h"
 #include "Csr.h"
 #include "RISCV.h"
+#include "RVC.h"
 #include "config.h"
 #include "ref.h"
 #include "util.h"
 #include <cstdint>
 #include <cstdlib>
 
-// 中间信号
-#ifdef CONFIG_BPU
-static wire<BR_TAG_WIDTH> alloc_tag[DECODE_WIDTH]; // 分配的新 Tag
-#endif
-
 void Idu::init() {
   for (int i = 0; i < MAX_BR_NUM; i++) {
     tag_vec[i] = true;
@@ -27,13 +23,20 @@ void Idu::init() {
   pending_free_mask_1 = 0;
   br_latch = {};
   br_latch_1 = {};
+  fuse_inhibit_valid = false;
+  fuse_inhibit_valid_1 = false;
+  fuse_inhibit_pc = 0;
+  fuse_inhibit_pc_1 = 0;
+  for (int i = 0; i < IDU_PEEK_WIDTH; i++) {
+    entry_slot[i] = -1;
+  }
 }
 
 /*
  * comb_begin
  * 功能: 组合阶段开始时，将时序态镜像到 *_1 工作副本，作为本拍组合逻辑的可写基线。
- * 输入依赖: tag_vec, br_mask_cp, now_br_mask, pending_free_mask, br_latch。
- * 输出更新: tag_vec_1, br_mask_cp_1, now_br_mask_1, pending_free_mask_1, br_latch_1。
+ * 输入依赖: tag_vec, br_mask_cp, now_br_mask, pending_free_mask, br_latch, fuse_inhibit_*。
+ * 输出更新: tag_vec_1, br_mask_cp_1, now_br_mask_1, pending_free_mask_1, br_latch_1, fuse_inhibit_*_1。
  * 约束: 仅做状态复制，不分配/释放分支 Tag，不驱动对外接口信号。
  */
 void Idu::comb_begin() {
@@ -44,48 +47,177 @@ void Idu::comb_begin() {
   now_br_mask_1 = now_br_mask;
   pending_free_mask_1 = pending_free_mask;
   br_latch_1 = br_latch;
+  fuse_inhibit_valid_1 = fuse_inhibit_valid;
+  fuse_inhibit_pc_1 = fuse_inhibit_pc;
 }
 
 /*
- * comb_decode
- * 功能: 译码 in.issue 指令并生成 dec2ren uop，同时为分支指令预分配 br_id/br_mask（遇 Tag 不足时截断）。
- * 输入依赖: in.issue->entries, br_latch.clear_mask, now_br_mask, tag_vec, max_br_per_cycle。
- * 输出更新: out.dec2ren->valid/uop, alloc_tag（供 comb_fire 在 fire 时提交分配）。
- * 约束: 每拍最多分配 max_br_per_cycle 个分支 Tag, Tag 不足时后续槽位 valid 置 0。
+ * try_fuse
+ * 功能: 判断相邻两条指令（a 在前）能否宏融合，可以则把 a 改写为融合 uop。
+ * 输入依赖: a/b 的译码结果及指令字 inst_a/inst_b。
+ * 输出更新: a（融合后的静态字段、fuse_kind、dbg.fused_instruction、ftq_is_last）。
+ * 约束: 两条须同属一个取指块、无取指异常且都不是压缩指令（融合 uop 按
+ *       8 字节推进）；中间结果必须被第二条覆盖（rd 相同且第二条以 rd 为源），
+ *       融合 uop 只写一个目的寄存器。
  */
-void Idu::comb_decode() {
-#ifndef CONFIG_BPU
+bool Idu::try_fuse(DecRenIO::DecRenInst &a, const DecRenIO::DecRenInst &b,
+                   uint32_t inst_a, uint32_t inst_b) {
+  if (a.ftq_idx != b.ftq_idx || a.page_fault_inst || b.page_fault_inst ||
+      a.illegal_inst || b.illegal_inst || a.is_rvc || b.is_rvc) {
+    return false;
+  }
+  const uint32_t rd = BITS(inst_a, 11, 7);
+  if (rd == 0 || BITS(inst_b, 11, 7) != rd || BITS(inst_b, 19, 15) != rd) {
+    return false;
+  }
+  const uint32_t opcode_a = BITS(inst_a, 6, 0);
+  const uint32_t opcode_b = BITS(inst_b, 6, 0);
+  const uint32_t funct3_a = BITS(inst_a, 14, 12);
+  const uint32_t funct3_b = BITS(inst_b, 14, 12);
+  const bool b_is_addi = opcode_b == number_7_opcode_addi && funct3_b == 0;
+
+  int kind = FUSE_NONE;
+  if (opcode_a == number_0_opcode_lui && b_is_addi) {
+    // lui rd, hi; addi rd, rd, lo -> add rd, x0, hi + lo
+    a.imm = immU(inst_a) + immI(inst_b);
+    kind = FUSE_LUI_ADDI;
+  } else if (opcode_a == number_1_opcode_auipc && b_is_addi) {
+    // auipc rd, hi; addi rd, rd, lo -> add rd, pc, hi + lo
+    a.imm = immU(inst_a) + immI(inst_b);
+    kind = FUSE_AUIPC_ADDI;
+  } else if (opcode_a == number_7_opcode_addi && funct3_a == 0b001 &&
+             BITS(inst_a, 31, 25) == 0 && opcode_b == number_7_opcode_addi &&
+             funct3_b == 0b101 && BITS(inst_b, 31, 25) == 0 &&
+             BITS(inst_a, 24, 20) == BITS(inst_b, 24, 20) &&
+             BITS(inst_a, 24, 20) != 0) {
+    // slli rd, rs, k; srli rd, rd, k -> andi rd, rs, 0xffffffff >> k
+    a.func3 = 0b111;
+    a.func7 = 0;
+    a.imm = 0xffffffffu >> BITS(inst_a, 24, 20);
+    kind = FUSE_ZEXT;
+  } else if (opcode_a == number_0_opcode_lui &&
+             opcode_b == number_5_opcode_lb) {
+    // lui rd, hi; lw rd, lo(rd) -> lw rd, (hi + lo)(x0)
+    // 访存语义取自 b，PC/FTQ 位置取自 a（异常与重取都以 a 为准）。
+    DecRenIO::DecRenInst fused = b;
+    fused.src1_areg = 0;
+    fused.imm = immU(inst_a) + immI(inst_b);
+    fused.ftq_offset = a.ftq_offset;
+    fused.dbg.pc = a.dbg.pc;
+    fused.dbg.instruction = a.dbg.instruction;
+    fused.dbg.inst_idx = a.dbg.inst_idx;
+    a = fused;
+    kind = FUSE_LUI_LOAD;
+  } else {
+    return false;
+  }
+  a.fuse_kind = kind;
+  a.ftq_is_last = b.ftq_is_last;
+  a.dbg.fused_instruction = inst_b;
+  return true;
+}
+
+/*
+ * decode_slot
+ * 功能: 译码单个 IBuf 项（取指缺页直接生成异常 uop）并填入 PC/FTQ/SSIT 字段。
+ */
+void Idu::decode_slot(DecRenIO::DecRenInst &decoded,
+                      const InstructionBufferEntry &entry) {
+  decoded = {};
+  if (entry.page_fault_inst) {
+    decoded.diag_val = entry.inst;
+    decoded.page_fault_inst = true;
+    decoded.type = encode_inst_type(NOP);
+    decoded.src1_en = false;
+    decoded.src2_en = false;
+    decoded.dest_en = false;
+    decoded.dbg.instruction = entry.inst;
+  } else {
+    decode(decoded, entry.inst);
+  }
+  decoded.dbg.pc = entry.pc;
+  decoded.ssit_idx = ssit_index_of_pc(entry.pc);
+  decoded.pf_pc_hash = l1d_pf_pc_hash(entry.pc);
+  decoded.ftq_idx = entry.ftq_idx;
+  decoded.ftq_offset = entry.ftq_offset;
+  decoded.ftq_is_last = entry.ftq_is_last;
+}
+
+/*
+ * decode_group
+ * 功能: 从 in.issue->entries 顺序译码，填满至多 DECODE_WIDTH 个 dec2ren 槽位；
+ *       启用 CONFIG_MACRO_FUSION 时相邻可融合的两项压缩进同一槽位。
+ * 输入依赖: in.issue->entries, fuse_inhibit_valid/fuse_inhibit_pc。
+ * 输出更新: out.dec2ren->valid/uop（br_id/br_mask 由调用方填写）, entry_slot[]。
+ * 约束: 槽位按程序序紧凑分配，entry_slot 单调不减，保证出队是 IBuf 前缀。
+ */
+void Idu::decode_group() {
   for (int i = 0; i < DECODE_WIDTH; i++) {
     out.dec2ren->valid[i] = false;
     out.dec2ren->uop[i] = {};
   }
+  for (int e = 0; e < IDU_PEEK_WIDTH; e++) {
+    entry_slot[e] = -1;
+  }
 
-  for (int i = 0; i < DECODE_WIDTH; i++) {
-    const InstructionBufferEntry &entry = in.issue->entries[i];
-    if (!entry.valid)
-      continue;
-
-    out.dec2ren->valid[i] = true;
-    auto &decoded = out.dec2ren->uop[i];
-    decoded = {};
-    if (entry.page_fault_inst) {
-      decoded.diag_val = entry.inst;
-      decoded.page_fault_inst = true;
-      decoded.type = encode_inst_type(NOP);
-      decoded.src1_en = false;
-      decoded.src2_en = false;
-      decoded.dest_en = false;
-      decoded.dbg.instruction = entry.inst;
+  int slot = 0;
+  int e = 0;
+#ifdef CONFIG_MACRO_FUSION
+  // 融合失败时已译码的下一项留到下一槽位使用，避免重复译码
+  DecRenIO::DecRenInst carry;
+  bool carry_valid = false;
+#endif
+  while (slot < DECODE_WIDTH && e < IDU_PEEK_WIDTH &&
+         in.issue->entries[e].valid) {
+    const InstructionBufferEntry &entry = in.issue->entries[e];
+    auto &decoded = out.dec2ren->uop[slot];
+#ifdef CONFIG_MACRO_FUSION
+    if (carry_valid) {
+      decoded = carry;
+      carry_valid = false;
     } else {
-      decode(decoded, entry.inst);
+      decode_slot(decoded, entry);
+    }
+#else
+    decode_slot(decoded, entry);
+#endif
+    out.dec2ren->valid[slot] = true;
+    entry_slot[e] = slot;
+    e++;
+
+#ifdef CONFIG_MACRO_FUSION
+    const uint32_t opcode = BITS(entry.inst, 6, 0);
+    const bool fuse_head = opcode == number_0_opcode_lui ||
+                           opcode == number_1_opcode_auipc ||
+                           opcode == number_7_opcode_addi;
+    const bool inhibited = fuse_inhibit_valid && entry.pc == fuse_inhibit_pc;
+    if (fuse_head && !inhibited && e < IDU_PEEK_WIDTH &&
+        in.issue->entries[e].valid) {
+      const InstructionBufferEntry &next = in.issue->entries[e];
+      decode_slot(carry, next);
+      if (try_fuse(decoded, carry, entry.inst, next.inst)) {
+        entry_slot[e] = slot;
+        e++;
+      } else {
+        carry_valid = true;
+      }
     }
-    decoded.dbg.pc = entry.pc;
-    decoded.ftq_idx = entry.ftq_idx;
-    decoded.ftq_offset = entry.ftq_offset;
-    decoded.ftq_is_last = entry.ftq_is_last;
-    decoded.br_id = 0;
-    decoded.br_mask = 0;
+#endif
+    slot++;
   }
+}
+
+/*
+ * comb_decode
+ * 功能: 译码 in.issue 指令并生成 dec2ren uop，同时为分支指令预分配 br_id/br_mask（遇 Tag 不足时截断）。
+ * 输入依赖: in.issue->entries, br_latch.clear_mask, now_br_mask, tag_vec, max_br_per_cycle。
+ * 输出更新: out.dec2ren->valid/uop, entry_slot[], alloc_tag（供 comb_fire 在 fire 时提交分配）。
+ * 约束: 每拍最多分配 max_br_per_cycle 个分支 Tag, Tag 不足时后续槽位 valid 置 0。
+ */
+void Idu::comb_decode() {
+#ifndef CONFIG_BPU
+  // oracle 前端无分支恢复，br_id/br_mask 保持 0
+  decode_group();
   return;
 #else
   wire<1> alloc_valid[DECODE_WIDTH];
@@ -102,35 +234,7 @@ void Idu::comb_decode() {
     alloc_valid[i] = false;
   }
 
-  for (int i = 0; i < DECODE_WIDTH; i++) {
-    out.dec2ren->valid[i] = false;
-    out.dec2ren->uop[i] = {};
-  }
-
-  for (int i = 0; i < DECODE_WIDTH; i++) {
-    const InstructionBufferEntry &entry = in.issue->entries[i];
-    if (!entry.valid)
-      continue;
-
-    out.dec2ren->valid[i] = true;
-    auto &decoded = out.dec2ren->uop[i];
-    decoded = {};
-    if (entry.page_fault_inst) {
-      decoded.diag_val = entry.inst;
-      decoded.page_fault_inst = true;
-      decoded.type = encode_inst_type(NOP);
-      decoded.src1_en = false;
-      decoded.src2_en = false;
-      decoded.dest_en = false;
-      decoded.dbg.instruction = entry.inst;
-    } else {
-      decode(decoded, entry.inst);
-    }
-    decoded.dbg.pc = entry.pc;
-    decoded.ftq_idx = entry.ftq_idx;
-    decoded.ftq_offset = entry.ftq_offset;
-    decoded.ftq_is_last = entry.ftq_is_last;
-  }
+  decode_group();
 
   int br_num = 0;
   // ID 阶段旁路清理：本拍已解析分支的 bit 不应继续传播到新译码指令。
@@ -211,7 +315,7 @@ void Idu::comb_branch() {
  * 约束: flush 最高优先级并直接返回；mispred 路径不进行新分支分配；仅对 fire 且为分支的槽位提交 Tag 占用。
  */
 void Idu::comb_fire() {
-  for (int i = 0; i < DECODE_WIDTH; i++) {
+  for (int i = 0; i < IDU_PEEK_WIDTH; i++) {
     out.idu_consume->fire[i] = false;
   }
 
@@ -223,6 +327,11 @@ void Idu::comb_fire() {
 
   // 0. flush 最高优先级：清空本地分支状态。
   if (in.rob_bcast->flush) {
+    // 融合 uop 异常重取：首条 PC 处本次不再融合，让异常落在单条指令上。
+    if (in.rob_bcast->fuse_replay) {
+      fuse_inhibit_valid_1 = true;
+      fuse_inhibit_pc_1 = in.rob_bcast->pc;
+    }
     for (int i = 1; i < MAX_BR_NUM; i++) {
       tag_vec_1[i] = true;
     }
@@ -266,15 +375,21 @@ void Idu::comb_fire() {
     return;
   }
 
-  // 5. 正常发射路径：所有成功握手的槽位都要通知 PreIduQueue 出队；
-  // 分支 tag 的推进仅在启用 BPU 时生效。
+  // 5. 正常发射路径：所有成功握手的 IBuf 项都要通知 PreIduQueue 出队
+  // （融合对的两项随同一槽位出队）；分支 tag 的推进仅在启用 BPU 时生效。
+  for (int e = 0; e < IDU_PEEK_WIDTH; e++) {
+    const int slot = entry_slot[e];
+    wire<1> fire = slot >= 0 && out.dec2ren->valid[slot] && in.ren2dec->ready;
+    out.idu_consume->fire[e] = fire;
+    const InstructionBufferEntry &entry = in.issue->entries[e];
+    if (fire && fuse_inhibit_valid && entry.pc == fuse_inhibit_pc) {
+      fuse_inhibit_valid_1 = false;
+    }
+  }
 #ifdef CONFIG_BPU
   int br_num = 0;
-#endif
   for (int i = 0; i < DECODE_WIDTH; i++) {
     wire<1> fire = out.dec2ren->valid[i] && in.ren2dec->ready;
-    out.idu_consume->fire[i] = fire;
-#ifdef CONFIG_BPU
     if (fire && is_branch(out.dec2ren->uop[i].type)) {
       wire<BR_TAG_WIDTH> new_tag = alloc_tag[br_num];
       tag_vec_1[new_tag] = false;
@@ -282,8 +397,8 @@ void Idu::comb_fire() {
       br_mask_cp_1[new_tag] = now_br_mask_1;
       br_num++;
     }
-#endif
   }
+#endif
 }
 
 void Idu::seq() {
@@ -294,9 +409,39 @@ void Idu::seq() {
     br_mask_cp[i] = br_mask_cp_1[i];
   }
   br_latch = br_latch_1;
+  fuse_inhibit_valid = fuse_inhibit_valid_1;
+  fuse_inhibit_pc = fuse_inhibit_pc_1;
 }
 
 void Idu::decode(DecRenIO::DecRenInst &uop, uint32_t inst) {
+  if (const DecRenIO::DecRenInst *memo = decode_memo.find(inst)) {
+    uop = *memo;
+  } else {
+    decode_uncached(uop, inst);
+    decode_memo.insert(inst, uop);
+  }
+  uop.dbg.inst_idx = global_inst_idx++;
+}
+
+void Idu::decode_uncached(DecRenIO::DecRenInst &uop, uint32_t inst) {
+#ifdef CONFIG_RVC
+  // 压缩指令展开为等价的 32 位指令后按常规路径译码（dbg.instruction 为展开
+  // 结果，与 ref 一致）；保留编码展开为 0 落入非法指令，tval 取原始 16 位。
+  if (rvc_is_compressed(inst)) {
+    const uint32_t raw = inst & 0xffffu;
+    decode_rv32(uop, rvc_expand(raw));
+    uop.is_rvc = true;
+    if (uop.illegal_inst) {
+      uop.diag_val = raw;
+    }
+    return;
+  }
+#endif
+  decode_rv32(uop, inst);
+  uop.is_rvc = false;
+}
+
+void Idu::decode_rv32(DecRenIO::DecRenInst &uop, uint32_t inst) {
   // 操作数来源以及type
   // uint32_t imm;
   uop.dbg.instruction = inst;
@@ -328,8 +473,6 @@ void Idu::decode(DecRenIO::DecRenInst &uop, uint32_t inst) {
   uop.tma.mem_commit_is_load = false;
   uop.tma.mem_commit_is_store = false;
   uop.dbg.mem_align_mask = 0;
-  static uint64_t global_inst_idx = 0;
-  uop.dbg.inst_idx = global_inst_idx++;
 
   switch (opcode) {
   case number_0_opcode_lui: { // lui
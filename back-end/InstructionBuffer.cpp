@@ -1,7 +1,17 @@
 #include "InstructionBuffer.h"
 #include "util.h"
 
-void InstructionBuffer::init() { clear(); }
+void InstructionBuffer::init() {
+  entries.reset(InstructionBufferEntry());
+  head_r = tail_r = count_r = 0;
+  head_1 = tail_1 = count_1 = 0;
+}
+
+void InstructionBuffer::comb_begin() {
+  head_1 = head_r;
+  tail_1 = tail_r;
+  count_1 = count_r;
+}
 
 const InstructionBufferEntry &InstructionBuffer::peek(int offset) const {
   Assert(offset >= 0 && offset < count_r &&
@@ -10,30 +20,32 @@ const InstructionBufferEntry &InstructionBuffer::peek(int offset) const {
   return entries[idx];
 }
 
+// 出队只推进指针：count 之外的槽位不会被 peek 读到，无需逐项清零。
 void InstructionBuffer::pop_front(int n) {
   if (n <= 0) {
     return;
   }
-  int actual = (n > count_r) ? count_r : n;
-  for (int i = 0; i < actual; i++) {
-    entries[head_r] = {};
-    head_r = (head_r + 1) % IDU_INST_BUFFER_SIZE;
-  }
-  count_r -= actual;
+  int actual = (n > count_1) ? count_1 : n;
+  head_1 = (head_1 + actual) % IDU_INST_BUFFER_SIZE;
+  count_1 = count_1 - actual;
 }
 
 void InstructionBuffer::push_back(const InstructionBufferEntry &entry) {
-  Assert(count_r < IDU_INST_BUFFER_SIZE && "InstructionBuffer overflow");
-  entries[tail_r] = entry;
-  tail_r = (tail_r + 1) % IDU_INST_BUFFER_SIZE;
-  count_r++;
+  Assert(count_1 < IDU_INST_BUFFER_SIZE && "InstructionBuffer overflow");
+  entries.set(tail_1, entry);
+  tail_1 = (tail_1 + 1) % IDU_INST_BUFFER_SIZE;
+  count_1 = count_1 + 1;
 }
 
 void InstructionBuffer::clear() {
-  head_r = 0;
-  tail_r = 0;
-  count_r = 0;
-  for (int i = 0; i < IDU_INST_BUFFER_SIZE; i++) {
-    entries[i] = {};
-  }
+  head_1 = 0;
+  tail_1 = 0;
+  count_1 = 0;
+}
+
+void InstructionBuffer::seq() {
+  entries.seq();
+  head_r = head_1;
+  tail_r = tail_1;
+  count_r = count_1;
 }
@@ -32,11 +32,30 @@ STLFResult check_stlf(uint32_t load_addr, uint32_t load_func3, uint32_t store_ad
 
 RealLsu::RealLsu(SimContext *ctx) : cur{}, nxt{}, in{}, out{}, ctx(ctx) {}
 
+namespace {
+template <typename T, int N> void reset_zeroed(DualRankArray<T, N> &ring) {
+  T zero;
+  std::memset(static_cast<void *>(&zero), 0, sizeof(zero));
+  ring.reset(zero);
+}
+} // namespace
+
 void RealLsu::init() {
   std::memset(&cur, 0, sizeof(cur));
   std::memset(&nxt, 0, sizeof(nxt));
+  reset_zeroed(ldq);
+  reset_zeroed(stq);
+  reset_zeroed(wait_mmu_stq);
+  reset_zeroed(wait_mmu_ldq);
+  reset_zeroed(mmu_done_stq);
+  reset_zeroed(finish);
+  reset_zeroed(wait_dcache_ldq);
+  reset_zeroed(ssit);
+  reset_zeroed(lfst);
 }
 
+// 标量状态（指针/计数/单元）较小，整体镜像；各队列条目由 DualRankArray
+// 维持两 rank 一致，不参与拷贝。
 void RealLsu::comb_cal() {
   nxt = cur;
 }
@@ -65,8 +84,8 @@ void RealLsu::comb_lsu2rob() {
   uint64_t miss_mask = 0;
 #if !BSD_CONFIG
   for (int i = 0; i < cur.ldq_count; i++) {
-    if (cur.ldq[(cur.ldq_head + i) % LDQ_SIZE].cache_miss == true) {
-      miss_mask |= (1ULL << cur.ldq[(cur.ldq_head + i) % LDQ_SIZE].rob_idx); // 将重放中的load对应的rob位设置为1
+    if (ldq[(cur.ldq_head + i) % LDQ_SIZE].cache_miss == true) {
+      miss_mask |= (1ULL << ldq[(cur.ldq_head + i) % LDQ_SIZE].rob_idx); // 将重放中的load对应的rob位设置为1
     }
   }
 #endif
@@ -90,22 +109,22 @@ void RealLsu::comb_mmio_in() {
   if (in.peripheral_resp->is_mmio) {
      if (cur.uncached_unit.is_load) {
       if (cur.uncached_unit.valid) {
-        auto &entry = nxt.ldq[cur.uncached_unit.idx];
+        auto &entry = ldq.write(cur.uncached_unit.idx);
         if (entry.load_state == LoadState::WaitMmioResp) {
           entry.result = in.peripheral_resp->mmio_rdata;
           entry.load_state = LoadState::ReadyToWb;
 
           const uint32_t finish_idx =
               (nxt.finish_head + nxt.finish_count) % kFinishSize;
-          nxt.finish[finish_idx].valid = true;
-          nxt.finish[finish_idx].idx = cur.uncached_unit.idx;
-          nxt.finish[finish_idx].is_load = true;
+          finish.write(finish_idx).valid = true;
+          finish.write(finish_idx).idx = cur.uncached_unit.idx;
+          finish.write(finish_idx).is_load = true;
           nxt.finish_count++;
         }
       }
     }
     else {
-      auto &entry = nxt.stq[cur.uncached_unit.idx];
+      auto &entry = stq.write(cur.uncached_unit.idx);
       if (entry.store_state == StoreState::WaitMmioResp) {
         entry.store_state = StoreState::Done; // MMIO store在收到响应后就可以认为完成了
       }
@@ -124,16 +143,16 @@ void RealLsu::comb_tlb_out() {
 
   // 将等待MMU响应的LDQ条目发送给MMU
   for (int i = 0; i < issue_ldq; i++) {
-    const auto &entry = cur.wait_mmu_ldq[(cur.wait_mmu_ldq_head + i) % LDQ_SIZE];
-    const LdqEntry &ldq_entry = cur.ldq[entry.ldq_idx];
+    const auto &entry = wait_mmu_ldq[(cur.wait_mmu_ldq_head + i) % LDQ_SIZE];
+    const LdqEntry &ldq_entry = ldq[entry.ldq_idx];
     out.lsu2mmu->ldq_req[i].valid = ldq_entry.load_state == LoadState::WaitTlb && entry.valid;
     out.lsu2mmu->ldq_req[i].vaddr = ldq_entry.v_addr;
   }
 
   // 将等待MMU响应的STQ条目发送给MMU
   for (int i = 0; i < issue_stq; i++) {
-    const auto &entry = cur.wait_mmu_stq[(cur.wait_mmu_stq_head + i) % STQ_SIZE];
-    const StqEntry &stq_entry = cur.stq[entry.stq_idx];
+    const auto &entry = wait_mmu_stq[(cur.wait_mmu_stq_head + i) % STQ_SIZE];
+    const StqEntry &stq_entry = stq[entry.stq_idx];
     out.lsu2mmu->stq_req[i].valid = stq_entry.store_state == StoreState::WaitTlb && entry.valid;
     out.lsu2mmu->stq_req[i].vaddr = stq_entry.vaddr;
   }
@@ -147,8 +166,8 @@ void RealLsu::comb_tlb_in() {
     if (in.mmu2lsu->ldq_resp[i].valid) {
       const auto &resp = in.mmu2lsu->ldq_resp[i];
       const auto &entry =
-          cur.wait_mmu_ldq[(cur.wait_mmu_ldq_head + i) % LDQ_SIZE];
-      LdqEntry &ldq_entry = nxt.ldq[entry.ldq_idx];
+          wait_mmu_ldq[(cur.wait_mmu_ldq_head + i) % LDQ_SIZE];
+      LdqEntry &ldq_entry = ldq.write(entry.ldq_idx);
 
       if (entry.valid) {
         if (ldq_entry.load_state == LoadState::WaitTlb) {
@@ -172,16 +191,16 @@ void RealLsu::comb_tlb_in() {
 
             const uint32_t finish_idx =
                 (nxt.finish_head + nxt.finish_count) % kFinishSize;
-            nxt.finish[finish_idx].valid = true;
-            nxt.finish[finish_idx].idx = entry.ldq_idx;
-            nxt.finish[finish_idx].is_load = true;
+            finish.write(finish_idx).valid = true;
+            finish.write(finish_idx).idx = entry.ldq_idx;
+            finish.write(finish_idx).is_load = true;
             nxt.finish_count++;
           }
         }
       } else {
         wait_mmu_ldq_entries[i].valid = false;
       }
-      nxt.wait_mmu_ldq[(nxt.wait_mmu_ldq_head + i) % LDQ_SIZE].valid = false; // 无论命中与否都需要将条目写回等待队列
+      wait_mmu_ldq.write((nxt.wait_mmu_ldq_head + i) % LDQ_SIZE).valid = false; // 无论命中与否都需要将条目写回等待队列
     }
   }
 
@@ -189,7 +208,7 @@ void RealLsu::comb_tlb_in() {
   uint32_t tmp_count = nxt.wait_mmu_ldq_count;
   uint32_t issue = tmp_count > LSU_LDU_COUNT ? LSU_LDU_COUNT : tmp_count;
   for (int i = 0; i < issue; i++) {
-    if (!nxt.wait_mmu_ldq[(nxt.wait_mmu_ldq_head + i) % LDQ_SIZE].valid) {
+    if (!wait_mmu_ldq.next((nxt.wait_mmu_ldq_head + i) % LDQ_SIZE).valid) {
       tmp_head = (tmp_head + 1) % LDQ_SIZE;
       if (tmp_count > 0) {
         tmp_count--;
@@ -205,8 +224,8 @@ void RealLsu::comb_tlb_in() {
     if (in.mmu2lsu->stq_resp[i].valid) {
       const auto &resp = in.mmu2lsu->stq_resp[i];
       const auto &entry =
-          cur.wait_mmu_stq[(cur.wait_mmu_stq_head + i) % STQ_SIZE];
-      StqEntry &stq_entry = nxt.stq[entry.stq_idx];
+          wait_mmu_stq[(cur.wait_mmu_stq_head + i) % STQ_SIZE];
+      StqEntry &stq_entry = stq.write(entry.stq_idx);
 
       if (stq_entry.store_state == StoreState::WaitTlb) {
         if (resp.result == MMUResultType::HIT) {
@@ -214,21 +233,24 @@ void RealLsu::comb_tlb_in() {
           stq_entry.paddr = resp.paddr;
           stq_entry.is_mmio = lsu_is_mmio_addr(resp.paddr);
           wait_mmu_stq_entries[i].valid = false;
+#ifdef LSU_STORE_SET
+          ss_check_violation(entry.stq_idx, stq_entry);
+#endif
 
           if (stq_entry.data_valid) {
             stq_entry.store_state = StoreState::Done;
             if (!stq_entry.is_lrsc) {
               const uint32_t done_idx =
                   (nxt.mmu_done_stq_head + nxt.mmu_done_stq_count) % STQ_SIZE;
-              nxt.mmu_done_stq[done_idx].valid = true;
-              nxt.mmu_done_stq[done_idx].stq_idx = entry.stq_idx;
+              mmu_done_stq.write(done_idx).valid = true;
+              mmu_done_stq.write(done_idx).stq_idx = entry.stq_idx;
               nxt.mmu_done_stq_count++;
             } else {
               const uint32_t finish_idx =
                   (nxt.finish_head + nxt.finish_count) % kFinishSize;
-              nxt.finish[finish_idx].valid = true;
-              nxt.finish[finish_idx].idx = entry.stq_idx;
-              nxt.finish[finish_idx].is_load = false;
+              finish.write(finish_idx).valid = true;
+              finish.write(finish_idx).idx = entry.stq_idx;
+              finish.write(finish_idx).is_load = false;
               nxt.finish_count++;
             }
           } else {
@@ -244,13 +266,13 @@ void RealLsu::comb_tlb_in() {
           if (stq_entry.is_lrsc) {
             const uint32_t finish_idx =
                 (nxt.finish_head + nxt.finish_count) % kFinishSize;
-            nxt.finish[finish_idx].valid = true;
-            nxt.finish[finish_idx].idx = entry.stq_idx;
-            nxt.finish[finish_idx].is_load = false;
+            finish.write(finish_idx).valid = true;
+            finish.write(finish_idx).idx = entry.stq_idx;
+            finish.write(finish_idx).is_load = false;
             nxt.finish_count++;
           } else {
-            nxt.mmu_done_stq[(nxt.mmu_done_stq_head + nxt.mmu_done_stq_count) % STQ_SIZE].valid = true;
-            nxt.mmu_done_stq[(nxt.mmu_done_stq_head + nxt.mmu_done_stq_count) % STQ_SIZE].stq_idx = entry.stq_idx; // 将STQ条目加入MMU完成队列
+            mmu_done_stq.write((nxt.mmu_done_stq_head + nxt.mmu_done_stq_count) % STQ_SIZE).valid = true;
+            mmu_done_stq.write((nxt.mmu_done_stq_head + nxt.mmu_done_stq_count) % STQ_SIZE).stq_idx = entry.stq_idx; // 将STQ条目加入MMU完成队列
             nxt.mmu_done_stq_count++;
           }
 
@@ -259,7 +281,7 @@ void RealLsu::comb_tlb_in() {
       } else {
         wait_mmu_stq_entries[i].valid = false;
       }
-      nxt.wait_mmu_stq[(nxt.wait_mmu_stq_head + i) % STQ_SIZE].valid = false; // 无论命中与否都需要将条目写回等待队列
+      wait_mmu_stq.write((nxt.wait_mmu_stq_head + i) % STQ_SIZE).valid = false; // 无论命中与否都需要将条目写回等待队列
     }
   }
 
@@ -267,7 +289,7 @@ void RealLsu::comb_tlb_in() {
   tmp_count = nxt.wait_mmu_stq_count;
   issue = tmp_count > LSU_STA_COUNT ? LSU_STA_COUNT : tmp_count;
   for (int i = 0; i < issue; i++) {
-    if (!nxt.wait_mmu_stq[(nxt.wait_mmu_stq_head + i) % STQ_SIZE].valid) {
+    if (!wait_mmu_stq.next((nxt.wait_mmu_stq_head + i) % STQ_SIZE).valid) {
       tmp_head = (tmp_head + 1) % STQ_SIZE;
       if (tmp_count > 0) {
         tmp_count--;
@@ -281,14 +303,14 @@ void RealLsu::comb_tlb_in() {
 
   for (int i = 0; i < LSU_LDU_COUNT; i++) {
     if (wait_mmu_ldq_entries[i].valid) {
-      nxt.wait_mmu_ldq[(nxt.wait_mmu_ldq_head + nxt.wait_mmu_ldq_count) % LDQ_SIZE] = wait_mmu_ldq_entries[i];
+      wait_mmu_ldq.set((nxt.wait_mmu_ldq_head + nxt.wait_mmu_ldq_count) % LDQ_SIZE, wait_mmu_ldq_entries[i]);
       nxt.wait_mmu_ldq_count++;
     }
   }
 
   for (int i = 0; i < LSU_STA_COUNT; i++) {
     if (wait_mmu_stq_entries[i].valid) {
-      nxt.wait_mmu_stq[(nxt.wait_mmu_stq_head + nxt.wait_mmu_stq_count) % STQ_SIZE] = wait_mmu_stq_entries[i];
+      wait_mmu_stq.set((nxt.wait_mmu_stq_head + nxt.wait_mmu_stq_count) % STQ_SIZE, wait_mmu_stq_entries[i]);
       nxt.wait_mmu_stq_count++;
     }
   }
@@ -319,20 +341,22 @@ void RealLsu::comb_exe2lsu() {
   }
 }
 void RealLsu::comb_dis2lsu() {
-  for (int i = 0; i < MAX_LDQ_DISPATCH_WIDTH; i++) {
-    if (!in.dis2lsu->ldq_alloc_req[i]) {
+  // 先分配 store：同拍更年轻的 load 查 LFST 时能看到本拍更新
+  for (int i = 0; i < MAX_STQ_DISPATCH_WIDTH; i++) {
+    if (!in.dis2lsu->alloc_req[i]) {
       continue;
     }
-    bool ok = alloc_ldq_entry(in.dis2lsu->ldq_br_mask[i], in.dis2lsu->ldq_rob_idx[i], in.dis2lsu->ldq_rob_flag[i], in.dis2lsu->ldq_idx[i]);
-    Assert(ok && "LDQ allocate collision");
+    bool ok = alloc_stq_entry(in.dis2lsu->br_mask[i], in.dis2lsu->rob_idx[i], in.dis2lsu->rob_flag[i], in.dis2lsu->func3[i], in.dis2lsu->stq_flag[i], in.dis2lsu->ssit_idx[i]);
+    Assert(ok && "STQ allocate overflow");
   }
 
-  for (int i = 0; i < MAX_STQ_DISPATCH_WIDTH; i++) {
-    if (!in.dis2lsu->alloc_req[i]) {
+  for (int i = 0; i < MAX_LDQ_DISPATCH_WIDTH; i++) {
+    if (!in.dis2lsu->ldq_alloc_req[i]) {
       continue;
     }
-    bool ok = alloc_stq_entry(in.dis2lsu->br_mask[i], in.dis2lsu->rob_idx[i], in.dis2lsu->rob_flag[i], in.dis2lsu->func3[i], in.dis2lsu->stq_flag[i]);
-    Assert(ok && "STQ allocate overflow");
+    bool ok = alloc_ldq_entry(in.dis2lsu->ldq_br_mask[i], in.dis2lsu->ldq_rob_idx[i], in.dis2lsu->ldq_rob_flag[i], in.dis2lsu->ldq_idx[i], in.dis2lsu->ldq_ssit_idx[i],
+                              in.dis2lsu->ldq_pf_pc_hash[i]);
+    Assert(ok && "LDQ allocate collision");
   }
 }
 
@@ -342,11 +366,10 @@ void RealLsu::comb_stlf() {
 
   for (int i = 0; i < issue; i++) {
     const uint32_t ldq_idx = (nxt.ldq_head + i) % LDQ_SIZE;
-    LdqEntry &entry = nxt.ldq[ldq_idx];
-
-    if (entry.load_state != LoadState::CheckStlf) {
+    if (ldq.next(ldq_idx).load_state != LoadState::CheckStlf) {
       continue;
     }
+    LdqEntry &entry = ldq.write(ldq_idx);
 
     uint32_t older_store_count = 0;
     const bool boundary_ok = stq_distance_from_head_to_boundary(
@@ -383,8 +406,8 @@ void RealLsu::comb_stlf() {
       entry.load_state = LoadState::ReadyToIssue;
       const uint32_t wait_idx =
           (nxt.wait_dcache_ldq_head + nxt.wait_dcache_ldq_count) % LDQ_SIZE;
-      nxt.wait_dcache_ldq[wait_idx].valid = true;
-      nxt.wait_dcache_ldq[wait_idx].ldq_idx = ldq_idx;
+      wait_dcache_ldq.write(wait_idx).valid = true;
+      wait_dcache_ldq.write(wait_idx).ldq_idx = ldq_idx;
       nxt.wait_dcache_ldq_count++;
     }
   }
@@ -396,11 +419,10 @@ void RealLsu::comb_stlf() {
   uint32_t todcache_wait_count = 0;
   for (int i = 0; i < issue; i++) {
     const uint32_t ldq_idx = (nxt.ldq_head + i) % LDQ_SIZE;
-    LdqEntry &entry = nxt.ldq[ldq_idx];
-
-    if (entry.load_state != LoadState::CheckStlf) {
+    if (ldq.next(ldq_idx).load_state != LoadState::CheckStlf) {
       continue;
     }
+    LdqEntry &entry = ldq.write(ldq_idx);
 
     uint32_t older_store_count = 0;
     const bool boundary_ok = stq_distance_from_head_to_boundary(
@@ -430,10 +452,38 @@ void RealLsu::comb_stlf() {
       continue;
     }
     uint32_t check_stlf_num = 0;
+#ifdef LSU_STORE_SET
+    // 沿 LFST 链（依赖 store -> 同 set 上一条 store）确定需要等待的 store，
+    // 其余地址未知的 older store 预测无依赖，直接越过。
+    bool ss_chain_valid = entry.ss_dep_valid;
+    StoreTag ss_chain = entry.ss_dep;
+    bool bypassed = false;
+#endif
     for (int j = older_store_count - 1; j >= 0; j--) {
       const uint32_t stq_idx = (cur.stq_head + j) % STQ_SIZE;
-      const StqEntry &stq_entry = cur.stq[stq_idx];
+      const StqEntry &stq_entry = stq[stq_idx];
+#ifdef LSU_STORE_SET
+      const bool ss_predicted = ss_chain_valid && ss_chain.idx == stq_idx &&
+                                ss_chain.flag == stq_entry.stq_flag;
+      if (ss_predicted) {
+        ss_chain_valid = stq_entry.ss_pred_valid;
+        ss_chain.idx = stq_entry.ss_pred_idx;
+        ss_chain.flag = stq_entry.ss_pred_flag;
+      }
+#endif
       if (!stq_entry.paddr_valid) {
+#ifdef LSU_STORE_SET
+        // 本拍正在解析地址的 store 不越过：违例检查只看已发射的 load
+        if (!ss_predicted && !entry.is_mmio &&
+            !stq.next(stq_idx).paddr_valid) {
+          bypassed = true;
+          check_stlf_num++;
+          continue;
+        }
+        if (ss_predicted) {
+          entry.ss_wait = true;
+        }
+#endif
         entry.load_state = LoadState::CheckStlf;
         break;
       }
@@ -446,12 +496,23 @@ void RealLsu::comb_stlf() {
         const uint32_t forward_offset = entry.p_addr - stq_entry.paddr;
         entry.result = extract_data(stq_entry.data, forward_offset, entry.func3);
         entry.load_state = LoadState::ReadyToWb;
+        entry.fwd_valid = true;
+        entry.fwd_src.idx = stq_idx;
+        entry.fwd_src.flag = stq_entry.stq_flag;
+#ifdef LSU_STORE_SET
+        entry.ss_spec = bypassed;
+#ifdef CONFIG_PERF_COUNTER
+        if (bypassed) {
+          ctx->perf.ld_spec_bypass_count++;
+        }
+#endif
+#endif
 
         const uint32_t finish_idx =
             (nxt.finish_head + nxt.finish_count) % kFinishSize;
-        nxt.finish[finish_idx].valid = true;  // 将完成的LDQ条目加入完成队列
-        nxt.finish[finish_idx].idx = ldq_idx; // 将完成的LDQ条目加入完成队列
-        nxt.finish[finish_idx].is_load = true;
+        finish.write(finish_idx).valid = true;  // 将完成的LDQ条目加入完成队列
+        finish.write(finish_idx).idx = ldq_idx; // 将完成的LDQ条目加入完成队列
+        finish.write(finish_idx).is_load = true;
         nxt.finish_count++;
         break;
       } else if (stlf_result == STLFResult::Retry) {
@@ -468,10 +529,21 @@ void RealLsu::comb_stlf() {
 
     // 没有 older store 了，才允许发射 load。
     entry.load_state = LoadState::ReadyToIssue;
+#ifdef LSU_STORE_SET
+    entry.ss_spec = bypassed;
+#ifdef CONFIG_PERF_COUNTER
+    if (bypassed) {
+      ctx->perf.ld_spec_bypass_count++;
+    }
+    if (entry.ss_wait) {
+      ctx->perf.ld_false_dep_count++; // 等过预测依赖的 store，最终并无重叠
+    }
+#endif
+#endif
     const uint32_t wait_idx =
         (nxt.wait_dcache_ldq_head + nxt.wait_dcache_ldq_count) % LDQ_SIZE;
-    nxt.wait_dcache_ldq[wait_idx].valid = true;
-    nxt.wait_dcache_ldq[wait_idx].ldq_idx = ldq_idx;
+    wait_dcache_ldq.write(wait_idx).valid = true;
+    wait_dcache_ldq.write(wait_idx).ldq_idx = ldq_idx;
     nxt.wait_dcache_ldq_count++;
     todcache_wait_count++;
     if (todcache_wait_count == LSU_LDU_COUNT) {
@@ -489,20 +561,21 @@ void RealLsu::comb_lsu2dcache_ldq() {
   int32_t issue_ldq = cur.wait_dcache_ldq_count > LSU_LDU_COUNT ? LSU_LDU_COUNT : cur.wait_dcache_ldq_count;
   uint32_t issued = 0;
   for (int i = 0; i < issue_ldq; i++) {
-    const auto &entry = cur.wait_dcache_ldq[(cur.wait_dcache_ldq_head + i) % LDQ_SIZE];
-    const LdqEntry &cur_ldq_entry = cur.ldq[entry.ldq_idx];
-    auto &nxt_ldq_entry = nxt.ldq[entry.ldq_idx];
+    const auto &entry = wait_dcache_ldq[(cur.wait_dcache_ldq_head + i) % LDQ_SIZE];
+    const LdqEntry &cur_ldq_entry = ldq[entry.ldq_idx];
+    auto &nxt_ldq_entry = ldq.write(entry.ldq_idx);
     if (entry.valid && cur_ldq_entry.load_state == LoadState::ReadyToIssue) {
       uint32_t wait_idx = (cur.wait_dcache_ldq_head + i) % LDQ_SIZE;
 
       out.lsu2dcache->req_ports.load_ports[i].valid = true;
       out.lsu2dcache->req_ports.load_ports[i].addr = cur_ldq_entry.p_addr;
+      out.lsu2dcache->req_ports.load_ports[i].pc_hash = cur_ldq_entry.pf_pc_hash;
       uint32_t gen = normalize_lsu_req_gen(cur.req_gen + issued);
 
       out.lsu2dcache->req_ports.load_ports[i].req_id =
           make_lsu_load_req_id(wait_idx, gen);
 
-      nxt.wait_dcache_ldq[wait_idx].req_gen = gen;
+      wait_dcache_ldq.write(wait_idx).req_gen = gen;
 
       nxt_ldq_entry.load_state = LoadState::WaitDcacheResp;
       issued++;
@@ -528,7 +601,7 @@ void RealLsu::comb_dcache2lsu_ldq() {
       uint32_t entry_idx = lsu_req_id_wait_idx(req_id);
       uint32_t resp_gen = lsu_req_id_gen(req_id);
 
-      const auto &wait_entry = cur.wait_dcache_ldq[entry_idx];
+      const auto &wait_entry = wait_dcache_ldq[entry_idx];
 
       if (!wait_entry.valid) {
         continue; // stale response after flush/replay queue movement
@@ -550,8 +623,8 @@ void RealLsu::comb_dcache2lsu_ldq() {
       }
 
       uint32_t ldq_idx = wait_entry.ldq_idx;
-      if (cur.wait_dcache_ldq[entry_idx].valid) {
-        LdqEntry &entry = nxt.ldq[ldq_idx];
+      if (wait_dcache_ldq[entry_idx].valid) {
+        LdqEntry &entry = ldq.write(ldq_idx);
         if (entry.load_state == LoadState::WaitDcacheResp) {
           if (in.dcache2lsu->resp_ports.load_resps[i].replay == ReplayType::HIT) {
             entry.result = extract_data(in.dcache2lsu->resp_ports.load_resps[i].data, entry.p_addr, entry.func3);
@@ -560,12 +633,12 @@ void RealLsu::comb_dcache2lsu_ldq() {
 
             const uint32_t finish_idx =
                 (nxt.finish_head + nxt.finish_count) % kFinishSize;
-            nxt.finish[finish_idx].valid = true;  // 将完成的LDQ条目加入完成队列
-            nxt.finish[finish_idx].idx = ldq_idx; // 将完成的LDQ条目加入完成队列
-            nxt.finish[finish_idx].is_load = true;
+            finish.write(finish_idx).valid = true;  // 将完成的LDQ条目加入完成队列
+            finish.write(finish_idx).idx = ldq_idx; // 将完成的LDQ条目加入完成队列
+            finish.write(finish_idx).is_load = true;
             nxt.finish_count++;
           } else {
-            nxt.ldq[ldq_idx].load_state = LoadState::ReadyToIssue;
+            ldq.write(ldq_idx).load_state = LoadState::ReadyToIssue;
             wait_dcache_ldq_entries[i].valid = true;
             wait_dcache_ldq_entries[i].ldq_idx = ldq_idx;
 
@@ -578,7 +651,7 @@ void RealLsu::comb_dcache2lsu_ldq() {
         } else {
           wait_dcache_ldq_entries[i].valid = false;
         }
-        nxt.wait_dcache_ldq[entry_idx].valid = false; // 只有收到响应后才出队，避免丢失仍在等待dcache的load
+        wait_dcache_ldq.write(entry_idx).valid = false; // 只有收到响应后才出队，避免丢失仍在等待dcache的load
       } else {
         wait_dcache_ldq_entries[i].valid = false;
       }
@@ -590,7 +663,7 @@ void RealLsu::comb_dcache2lsu_ldq() {
   uint32_t tmp_count = nxt.wait_dcache_ldq_count;
   uint32_t issue = tmp_count > LSU_LDU_COUNT ? LSU_LDU_COUNT : tmp_count;
   for (int i = 0; i < issue; i++) {
-    if (!nxt.wait_dcache_ldq[(nxt.wait_dcache_ldq_head + i) % LDQ_SIZE].valid) {
+    if (!wait_dcache_ldq.next((nxt.wait_dcache_ldq_head + i) % LDQ_SIZE).valid) {
       tmp_head = (tmp_head + 1) % LDQ_SIZE;
       if (tmp_count > 0) {
         tmp_count--;
@@ -604,8 +677,8 @@ void RealLsu::comb_dcache2lsu_ldq() {
 
   for (int i = 0; i < LSU_LDU_COUNT; i++) {
     if (wait_dcache_ldq_entries[i].valid) {
-      nxt.wait_dcache_ldq[(nxt.wait_dcache_ldq_head + nxt.wait_dcache_ldq_count) % LDQ_SIZE].valid = true;
-      nxt.wait_dcache_ldq[(nxt.wait_dcache_ldq_head + nxt.wait_dcache_ldq_count) % LDQ_SIZE] = wait_dcache_ldq_entries[i];
+      wait_dcache_ldq.write((nxt.wait_dcache_ldq_head + nxt.wait_dcache_ldq_count) % LDQ_SIZE).valid = true;
+      wait_dcache_ldq.set((nxt.wait_dcache_ldq_head + nxt.wait_dcache_ldq_count) % LDQ_SIZE, wait_dcache_ldq_entries[i]);
       nxt.wait_dcache_ldq_count++;
     }
   }
@@ -643,7 +716,7 @@ void RealLsu::comb_dcache2lsu_stq() {
 #endif
         continue;
       }
-      StqEntry &entry = nxt.stq[stq_idx];
+      StqEntry &entry = stq.write(stq_idx);
       if (entry.store_state == StoreState::WaitDcacheResp) {
         if (in.dcache2lsu->resp_ports.store_resps[i].replay == ReplayType::HIT) {
           entry.store_state = StoreState::Done; // store完成，可以提交了
@@ -667,15 +740,15 @@ void RealLsu::comb_lsu2dcache_stq() {
   int32_t issued_stq = 0;
   for (uint32_t i = 0; i < commit_count && issued_stq < LSU_STA_COUNT; i++) {
     const uint32_t stq_idx = (cur.stq_head + i) % STQ_SIZE;
-    auto &entry = nxt.stq[stq_idx];
+    auto &entry = stq.write(stq_idx);
     uint8_t entry_strb = get_store_strb(entry.paddr, entry.func3);
 
     if (entry.store_state == StoreState::Committed) {
       bool has_older_unfinished_store = false;
       for (uint32_t j = 0; j < i; j++) {
         const uint32_t older_stq_idx = (cur.stq_head + j) % STQ_SIZE;
-        uint8_t older_entry_strb = get_store_strb(nxt.stq[older_stq_idx].paddr, nxt.stq[older_stq_idx].func3);
-        if (CheckAddr(entry.paddr, entry_strb, nxt.stq[older_stq_idx].paddr, older_entry_strb) && nxt.stq[older_stq_idx].store_state != StoreState::Done) {
+        uint8_t older_entry_strb = get_store_strb(stq.next(older_stq_idx).paddr, stq.next(older_stq_idx).func3);
+        if (CheckAddr(entry.paddr, entry_strb, stq.next(older_stq_idx).paddr, older_entry_strb) && stq.next(older_stq_idx).store_state != StoreState::Done) {
           entry.store_state = StoreState::Committed; // 还有更老的store没有完成，当前store继续保持在提交状态等待更老的store完成
           has_older_unfinished_store = true;
           break;
@@ -723,9 +796,9 @@ void RealLsu::comb_lsu2exe() {
 
   for (int i = 0; i < issue; i++) {
     const uint32_t done_idx = (cur.mmu_done_stq_head + i) % STQ_SIZE;
-    const auto &entry = cur.mmu_done_stq[done_idx];
+    const auto &entry = mmu_done_stq[done_idx];
     if (entry.valid) {
-      auto &stq_entry = nxt.stq[entry.stq_idx];
+      auto &stq_entry = stq.write(entry.stq_idx);
       if (stq_entry.store_state == StoreState::Done || stq_entry.store_state == StoreState::PageFault) {
         out.lsu2exe->sta_wb_req[i].valid = true;
         MicroOp wb_uop;
@@ -737,6 +810,8 @@ void RealLsu::comb_lsu2exe() {
         wb_uop.result = stq_entry.vaddr;
         wb_uop.page_fault_store = stq_entry.page_fault;
         wb_uop.dest_en = false;
+        // 访存顺序违例：store 提交后冲刷流水线，younger load 重新执行
+        wb_uop.flush_pipe = stq_entry.mem_violation;
 
         out.lsu2exe->sta_wb_req[i].uop =
             LsuExeIO::LsuExeRespUop::from_micro_op(wb_uop);
@@ -747,14 +822,14 @@ void RealLsu::comb_lsu2exe() {
 #endif
       }
     }
-    nxt.mmu_done_stq[done_idx].valid = false; // 无论如何都需要将MMU完成的STQ条目标记为无效
+    mmu_done_stq.write(done_idx).valid = false; // 无论如何都需要将MMU完成的STQ条目标记为无效
   }
 
   uint32_t tmp_head = nxt.mmu_done_stq_head;
   uint32_t tmp_count = nxt.mmu_done_stq_count;
   issue = tmp_count > LSU_STA_COUNT ? LSU_STA_COUNT : tmp_count;
   for (int i = 0; i < issue; i++) {
-    if (!nxt.mmu_done_stq[(nxt.mmu_done_stq_head + i) % STQ_SIZE].valid) {
+    if (!mmu_done_stq.next((nxt.mmu_done_stq_head + i) % STQ_SIZE).valid) {
       tmp_head = (tmp_head + 1) % STQ_SIZE;
       if (tmp_count > 0) {
         tmp_count--;
@@ -769,10 +844,10 @@ void RealLsu::comb_lsu2exe() {
   issue = cur.finish_count > LSU_LDU_COUNT ? LSU_LDU_COUNT : cur.finish_count;
   for (int i = 0; i < issue; i++) {
     const uint32_t finish_idx = (cur.finish_head + i) % kFinishSize;
-    const auto &entry = cur.finish[finish_idx];
+    const auto &entry = finish[finish_idx];
     if (entry.valid) {
       if (entry.is_load) {
-        auto &ldq_entry = nxt.ldq[entry.idx];
+        auto &ldq_entry = ldq.write(entry.idx);
         if (ldq_entry.load_state == LoadState::ReadyToWb || ldq_entry.load_state == LoadState::PageFault) {
           out.lsu2exe->wb_req[i].valid = true;
           MicroOp wb_uop;
@@ -802,9 +877,9 @@ void RealLsu::comb_lsu2exe() {
           }
         }
       } else {
-        auto &stq_entry = nxt.stq[entry.idx];
+        auto &stq_entry = stq.write(entry.idx);
         if (stq_entry.store_state == StoreState::Done || stq_entry.store_state == StoreState::PageFault) {
-          auto &stq_entry = nxt.stq[entry.idx];
+          auto &stq_entry = stq.write(entry.idx);
           MicroOp wb_uop;
           wb_uop.op = UOP_LOAD; // 关键：让 ROB 看到 G0
           wb_uop.rob_idx = stq_entry.rob_idx;
@@ -813,6 +888,7 @@ void RealLsu::comb_lsu2exe() {
           wb_uop.diag_val = stq_entry.vaddr;
           wb_uop.page_fault_store = stq_entry.page_fault;
           wb_uop.dest_en = false;
+          wb_uop.flush_pipe = stq_entry.mem_violation;
 
           if (stq_entry.page_fault) {
             wb_uop.result = stq_entry.vaddr;
@@ -838,14 +914,14 @@ void RealLsu::comb_lsu2exe() {
         }
       }
     }
-    nxt.finish[finish_idx].valid = false; // 无论如何都需要将完成的条目标记为无效
+    finish.write(finish_idx).valid = false; // 无论如何都需要将完成的条目标记为无效
   }
 
   tmp_head = nxt.finish_head;
   tmp_count = nxt.finish_count;
   issue = tmp_count > LSU_LDU_COUNT ? LSU_LDU_COUNT : tmp_count;
   for (int i = 0; i < issue; i++) {
-    if (!nxt.finish[(nxt.finish_head + i) % kFinishSize].valid) {
+    if (!finish.next((nxt.finish_head + i) % kFinishSize).valid) {
       tmp_head = (tmp_head + 1) % kFinishSize;
       if (tmp_count > 0) {
         tmp_count--;
@@ -877,8 +953,8 @@ void RealLsu::comb_stq_commit() {
     }
     int idx = commit_uop.stq_idx;
     if (idx == nxt.stq_commit) {
-      const StqEntry &cur_entry = cur.stq[idx];
-      StqEntry &nxt_entry = nxt.stq[idx];
+      const StqEntry &cur_entry = stq[idx];
+      StqEntry &nxt_entry = stq.write(idx);
 
       if (cur_entry.page_fault) {
         nxt_entry.store_state = StoreState::Done;
@@ -910,16 +986,27 @@ void RealLsu::comb_flush() {
     nxt.stq_commit_count = keep_committed;
     nxt.stq_commit = stq_idx_after(nxt.stq_head, keep_committed);
 
+    // 只写回仍有效的槽位，避免整队列进入写日志。
     for (int i = 0; i < LDQ_SIZE; i++) {
-      nxt.wait_dcache_ldq[i].valid = false;
-      nxt.wait_mmu_ldq[i].valid = false;
+      if (wait_dcache_ldq.next(i).valid) {
+        wait_dcache_ldq.write(i).valid = false;
+      }
+      if (wait_mmu_ldq.next(i).valid) {
+        wait_mmu_ldq.write(i).valid = false;
+      }
     }
     for (int i = 0; i < STQ_SIZE; i++) {
-      nxt.wait_mmu_stq[i].valid = false;
-      nxt.mmu_done_stq[i].valid = false;
+      if (wait_mmu_stq.next(i).valid) {
+        wait_mmu_stq.write(i).valid = false;
+      }
+      if (mmu_done_stq.next(i).valid) {
+        mmu_done_stq.write(i).valid = false;
+      }
     }
     for (int i = 0; i < kFinishSize; i++) {
-      nxt.finish[i].valid = false;
+      if (finish.next(i).valid) {
+        finish.write(i).valid = false;
+      }
     }
 
     nxt.wait_mmu_ldq_count = 0;
@@ -928,52 +1015,57 @@ void RealLsu::comb_flush() {
     nxt.finish_count = 0;
     nxt.wait_dcache_ldq_count = 0;
 
-    nxt.uncached_unit.valid = false;
+    // uncached unit 中的 store 已提交，不随 flush 丢弃，否则该 STQ 项会一直停在
+    // WaitMmioResp（队头非法指令等无需执行的 flush 可能与 MMIO store 进入
+    // uncached unit 落在同一拍）。
+    if (nxt.uncached_unit.is_load) {
+      nxt.uncached_unit.valid = false;
+    }
     // nxt.lrsc_unit.reserve_valid = false;
   }
 
   if (in.dec_bcast->mispred) {
     for (int i = 0; i < nxt.ldq_count; i++) {
-      if ((nxt.ldq[(nxt.ldq_head + i) % LDQ_SIZE].br_mask & in.dec_bcast->br_mask) != 0) {
+      if ((ldq.next((nxt.ldq_head + i) % LDQ_SIZE).br_mask & in.dec_bcast->br_mask) != 0) {
         nxt.ldq_count = i; // 将第一个需要清除的条目之前的条目保留，之后的条目全部清除
         break;
       }
     }
     for (int i = 0; i < nxt.stq_count; i++) {
-      if ((nxt.stq[(nxt.stq_head + i) % STQ_SIZE].br_mask & in.dec_bcast->br_mask) != 0) {
+      if ((stq.next((nxt.stq_head + i) % STQ_SIZE).br_mask & in.dec_bcast->br_mask) != 0) {
         nxt.stq_count = i; // 将第一个需要清除的条目之前的条目保留，之后的条目全部清除
         break;
       }
     }
     for (int i = 0; i < nxt.wait_mmu_ldq_count; i++) {
-      if (!ldq_idx_alive_after_flush(nxt.wait_mmu_ldq[(nxt.wait_mmu_ldq_head + i) % LDQ_SIZE].ldq_idx, nxt.ldq_head, nxt.ldq_count)) { // wait MMU的条目索引如果超过了新的LDQ count，说明这个条目需要被清除
-        nxt.wait_mmu_ldq[(nxt.wait_mmu_ldq_head + i) % LDQ_SIZE].valid = 0;                                                            // 将需要清除的条目无效化
+      if (!ldq_idx_alive_after_flush(wait_mmu_ldq.next((nxt.wait_mmu_ldq_head + i) % LDQ_SIZE).ldq_idx, nxt.ldq_head, nxt.ldq_count)) { // wait MMU的条目索引如果超过了新的LDQ count，说明这个条目需要被清除
+        wait_mmu_ldq.write((nxt.wait_mmu_ldq_head + i) % LDQ_SIZE).valid = 0;                                                            // 将需要清除的条目无效化
       }
     }
     for (int i = 0; i < nxt.wait_mmu_stq_count; i++) {
-      if (!stq_idx_alive_after_flush(nxt.wait_mmu_stq[(nxt.wait_mmu_stq_head + i) % STQ_SIZE].stq_idx, nxt.stq_head, nxt.stq_count)) { // wait MMU的条目索引如果超过了新的STQ count，说明这个条目需要被清除
-        nxt.wait_mmu_stq[(nxt.wait_mmu_stq_head + i) % STQ_SIZE].valid = 0;                                                            // 将需要清除的条目无效化
+      if (!stq_idx_alive_after_flush(wait_mmu_stq.next((nxt.wait_mmu_stq_head + i) % STQ_SIZE).stq_idx, nxt.stq_head, nxt.stq_count)) { // wait MMU的条目索引如果超过了新的STQ count，说明这个条目需要被清除
+        wait_mmu_stq.write((nxt.wait_mmu_stq_head + i) % STQ_SIZE).valid = 0;                                                            // 将需要清除的条目无效化
       }
     }
     for (int i = 0; i < nxt.mmu_done_stq_count; i++) {
-      if (!stq_idx_alive_after_flush(nxt.mmu_done_stq[(nxt.mmu_done_stq_head + i) % STQ_SIZE].stq_idx, nxt.stq_head, nxt.stq_count)) { // MMU完成队列的条目索引如果超过了新的STQ count，说明这个条目需要被清除
-        nxt.mmu_done_stq[(nxt.mmu_done_stq_head + i) % STQ_SIZE].valid = 0;                                                            // 将需要清除的条目无效化
+      if (!stq_idx_alive_after_flush(mmu_done_stq.next((nxt.mmu_done_stq_head + i) % STQ_SIZE).stq_idx, nxt.stq_head, nxt.stq_count)) { // MMU完成队列的条目索引如果超过了新的STQ count，说明这个条目需要被清除
+        mmu_done_stq.write((nxt.mmu_done_stq_head + i) % STQ_SIZE).valid = 0;                                                            // 将需要清除的条目无效化
       }
     }
     for (int i = 0; i < nxt.finish_count; i++) {
       bool alive = false;
-      if (nxt.finish[(nxt.finish_head + i) % kFinishSize].is_load) {
-        alive = ldq_idx_alive_after_flush(nxt.finish[(nxt.finish_head + i) % kFinishSize].idx, nxt.ldq_head, nxt.ldq_count);
+      if (finish.next((nxt.finish_head + i) % kFinishSize).is_load) {
+        alive = ldq_idx_alive_after_flush(finish.next((nxt.finish_head + i) % kFinishSize).idx, nxt.ldq_head, nxt.ldq_count);
       } else {
-        alive = stq_idx_alive_after_flush(nxt.finish[(nxt.finish_head + i) % kFinishSize].idx, nxt.stq_head, nxt.stq_count);
+        alive = stq_idx_alive_after_flush(finish.next((nxt.finish_head + i) % kFinishSize).idx, nxt.stq_head, nxt.stq_count);
       }
       if (!alive) {                                                // 完成队列的条目索引如果超过了新的LDQ/STQ count，说明这个条目需要被清除
-        nxt.finish[(nxt.finish_head + i) % kFinishSize].valid = 0; // 将需要清除的条目无效化
+        finish.write((nxt.finish_head + i) % kFinishSize).valid = 0; // 将需要清除的条目无效化
       }
     }
     for (int i = 0; i < nxt.wait_dcache_ldq_count; i++) {
-      if (!ldq_idx_alive_after_flush(nxt.wait_dcache_ldq[(nxt.wait_dcache_ldq_head + i) % LDQ_SIZE].ldq_idx, nxt.ldq_head, nxt.ldq_count)) { // wait dcache的条目索引如果超过了新的LDQ count，说明这个条目需要被清除
-        nxt.wait_dcache_ldq[(nxt.wait_dcache_ldq_head + i) % LDQ_SIZE].valid = 0;                                                            // 将需要清除的条目无效化
+      if (!ldq_idx_alive_after_flush(wait_dcache_ldq.next((nxt.wait_dcache_ldq_head + i) % LDQ_SIZE).ldq_idx, nxt.ldq_head, nxt.ldq_count)) { // wait dcache的条目索引如果超过了新的LDQ count，说明这个条目需要被清除
+        wait_dcache_ldq.write((nxt.wait_dcache_ldq_head + i) % LDQ_SIZE).valid = 0;                                                            // 将需要清除的条目无效化
       }
     }
     if (nxt.uncached_unit.valid) {
@@ -997,10 +1089,16 @@ void RealLsu::comb_flush() {
 
   if (in.dec_bcast->clear_mask) {
     for (int i = 0; i < cur.ldq_count; i++) {
-      nxt.ldq[(cur.ldq_head + i) % LDQ_SIZE].br_mask &= ~in.dec_bcast->clear_mask; // 将需要清除的分支对应的br mask位清0
+      const uint32_t idx = (cur.ldq_head + i) % LDQ_SIZE;
+      if (ldq.next(idx).br_mask & in.dec_bcast->clear_mask) {
+        ldq.write(idx).br_mask &= ~in.dec_bcast->clear_mask; // 将需要清除的分支对应的br mask位清0
+      }
     }
     for (int i = 0; i < cur.stq_count; i++) {
-      nxt.stq[(cur.stq_head + i) % STQ_SIZE].br_mask &= ~in.dec_bcast->clear_mask; // 将需要清除的分支对应的br mask位清0
+      const uint32_t idx = (cur.stq_head + i) % STQ_SIZE;
+      if (stq.next(idx).br_mask & in.dec_bcast->clear_mask) {
+        stq.write(idx).br_mask &= ~in.dec_bcast->clear_mask; // 将需要清除的分支对应的br mask位清0
+      }
     }
     if (in.dec_bcast->clear_mask && nxt.lrsc_unit.reserve_valid) {
       nxt.lrsc_unit.reserve_br_mask &= ~in.dec_bcast->clear_mask;
@@ -1010,7 +1108,16 @@ void RealLsu::comb_flush() {
 void RealLsu::comb_check() {
   int32_t issue = cur.ldq_count > LSU_LDU_COUNT ? LSU_LDU_COUNT : cur.ldq_count;
   for (int i = 0; i < issue; i++) {
-    if (cur.ldq[(cur.ldq_head + i) % LDQ_SIZE].load_state == LoadState::Done) {
+    const LdqEntry &head_load = ldq[(cur.ldq_head + i) % LDQ_SIZE];
+#ifdef LSU_STORE_SET
+    // 推测发射的 load 需留在 LDQ 中，直到越过的 older store 地址全部解析，
+    // 否则违例检查会漏掉它
+    if (head_load.load_state == LoadState::Done && head_load.ss_spec &&
+        !ss_older_stores_resolved(head_load)) {
+      break;
+    }
+#endif
+    if (head_load.load_state == LoadState::Done) {
       nxt.ldq_count--;
       advance_ring_ptr(nxt.ldq_head, nxt.ldq_head_flag, LDQ_SIZE);
     } else {
@@ -1025,7 +1132,7 @@ void RealLsu::comb_check() {
   issue = committed_count > LSU_STA_COUNT ? LSU_STA_COUNT : committed_count;
   for (int i = 0; i < issue; i++) {
     const uint32_t stq_idx = (cur.stq_head + i) % STQ_SIZE;
-    if (cur.stq[stq_idx].store_state == StoreState::Done) {
+    if (stq[stq_idx].store_state == StoreState::Done) {
       nxt.stq_count--;
       if (nxt.stq_commit_count > 0) {
         nxt.stq_commit_count--;
@@ -1035,10 +1142,33 @@ void RealLsu::comb_check() {
       break;
     }
   }
+
+#ifdef LSU_STORE_SET
+  // 定期清空 SSIT，淘汰过期的 store-set，避免 false dependence 累积
+  if (cur.ssit_clear_timer + 1 >= SSIT_CLEAR_INTERVAL) {
+    for (int i = 0; i < SSIT_SIZE; i++) {
+      if (ssit.next(i).valid) {
+        ssit.write(i).valid = false;
+      }
+    }
+    nxt.ssit_clear_timer = 0;
+  } else {
+    nxt.ssit_clear_timer = cur.ssit_clear_timer + 1;
+  }
+#endif
 }
 
 void RealLsu::seq() {
   cur = nxt;
+  ldq.seq();
+  stq.seq();
+  wait_mmu_stq.seq();
+  wait_mmu_ldq.seq();
+  mmu_done_stq.seq();
+  finish.seq();
+  wait_dcache_ldq.seq();
+  ssit.seq();
+  lfst.seq();
 }
 
 void RealLsu::dump_debug_state(FILE *out) const {
@@ -1091,7 +1221,7 @@ void RealLsu::dump_debug_state(FILE *out) const {
                static_cast<unsigned>(ldq_dump_count));
   for (uint32_t i = 0; i < ldq_dump_count; i++) {
     const uint32_t idx = (cur.ldq_head + i) % LDQ_SIZE;
-    const auto &entry = cur.ldq[idx];
+    const auto &entry = ldq[idx];
     std::fprintf(out,
                  "    [%u] state=%u rob=%u/%u vaddr=%u:0x%08x "
                  "paddr=%u:0x%08x mmio=%u page_fault=%u lrsc=%u\n",
@@ -1113,7 +1243,7 @@ void RealLsu::dump_debug_state(FILE *out) const {
                static_cast<unsigned>(stq_dump_count));
   for (uint32_t i = 0; i < stq_dump_count; i++) {
     const uint32_t idx = (cur.stq_head + i) % STQ_SIZE;
-    const auto &entry = cur.stq[idx];
+    const auto &entry = stq[idx];
     std::fprintf(out,
                  "    [%u] state=%u rob=%u/%u data=%u:0x%08x "
                  "vaddr=%u:0x%08x paddr=%u:0x%08x mmio=%u "
@@ -1139,7 +1269,7 @@ void RealLsu::handle_store_data(const MicroOp &inst) {
   if (inst.stq_idx >= STQ_SIZE) {
     return;
   }
-  StqEntry &entry = nxt.stq[inst.stq_idx];
+  StqEntry &entry = stq.write(inst.stq_idx);
 
   if (entry.rob_flag != inst.rob_flag || entry.rob_idx != inst.rob_idx) {
 #if !BSD_CONFIG
@@ -1152,15 +1282,15 @@ void RealLsu::handle_store_data(const MicroOp &inst) {
   if (entry.paddr_valid && entry.store_state == StoreState::WaitData) {
     entry.store_state = StoreState::Done;
     if (entry.is_lrsc) {
-      nxt.finish[(nxt.finish_head + nxt.finish_count) % kFinishSize].valid = true;
-      nxt.finish[(nxt.finish_head + nxt.finish_count) % kFinishSize].is_load = false;
-      nxt.finish[(nxt.finish_head + nxt.finish_count) % kFinishSize].idx = inst.stq_idx;
+      finish.write((nxt.finish_head + nxt.finish_count) % kFinishSize).valid = true;
+      finish.write((nxt.finish_head + nxt.finish_count) % kFinishSize).is_load = false;
+      finish.write((nxt.finish_head + nxt.finish_count) % kFinishSize).idx = inst.stq_idx;
       nxt.finish_count++;
     } else {
       const uint32_t done_idx =
           (nxt.mmu_done_stq_head + nxt.mmu_done_stq_count) % STQ_SIZE;
-      nxt.mmu_done_stq[done_idx].valid = true;
-      nxt.mmu_done_stq[done_idx].stq_idx = inst.stq_idx;
+      mmu_done_stq.write(done_idx).valid = true;
+      mmu_done_stq.write(done_idx).stq_idx = inst.stq_idx;
       nxt.mmu_done_stq_count++;
     }
   }
@@ -1170,7 +1300,7 @@ void RealLsu::handle_store_addr(const MicroOp &inst) {
   if (inst.stq_idx >= STQ_SIZE) {
     return;
   }
-  StqEntry &entry = nxt.stq[inst.stq_idx];
+  StqEntry &entry = stq.write(inst.stq_idx);
 
   if (entry.rob_flag != inst.rob_flag || entry.rob_idx != inst.rob_idx) {
 #if !BSD_CONFIG
@@ -1191,8 +1321,8 @@ void RealLsu::handle_store_addr(const MicroOp &inst) {
   entry.is_lrsc = inst.is_atomic && ((inst.func7 >> 2) == AmoOp::SC);
 
   uint32_t wait_mmu_idx = (nxt.wait_mmu_stq_head + nxt.wait_mmu_stq_count) % STQ_SIZE;
-  nxt.wait_mmu_stq[wait_mmu_idx].valid = true;
-  nxt.wait_mmu_stq[wait_mmu_idx].stq_idx = inst.stq_idx;
+  wait_mmu_stq.write(wait_mmu_idx).valid = true;
+  wait_mmu_stq.write(wait_mmu_idx).stq_idx = inst.stq_idx;
   nxt.wait_mmu_stq_count++;
 }
 
@@ -1200,7 +1330,7 @@ void RealLsu::handle_load_req(const MicroOp &inst) {
   if (inst.ldq_idx >= LDQ_SIZE) {
     return;
   }
-  LdqEntry &entry = nxt.ldq[inst.ldq_idx];
+  LdqEntry &entry = ldq.write(inst.ldq_idx);
 
   if (entry.rob_flag != inst.rob_flag || entry.rob_idx != inst.rob_idx) {
 #if !BSD_CONFIG
@@ -1220,16 +1350,18 @@ void RealLsu::handle_load_req(const MicroOp &inst) {
 
   entry.stq_snapshot.idx = inst.stq_idx;
   entry.stq_snapshot.flag = inst.stq_flag;
+  entry.ss_spec = false;
+  entry.fwd_valid = false;
 
   entry.is_lrsc = is_amo_lr_uop(inst);
 
   uint32_t wait_mmu_idx = (nxt.wait_mmu_ldq_head + nxt.wait_mmu_ldq_count) % LDQ_SIZE;
-  nxt.wait_mmu_ldq[wait_mmu_idx].ldq_idx = inst.ldq_idx;
-  nxt.wait_mmu_ldq[wait_mmu_idx].valid = true;
+  wait_mmu_ldq.write(wait_mmu_idx).ldq_idx = inst.ldq_idx;
+  wait_mmu_ldq.write(wait_mmu_idx).valid = true;
   nxt.wait_mmu_ldq_count++;
 }
 
-bool RealLsu::alloc_stq_entry(mask_t br_mask, uint32_t rob_idx, uint32_t rob_flag, uint32_t func3, bool slot_flag) {
+bool RealLsu::alloc_stq_entry(mask_t br_mask, uint32_t rob_idx, uint32_t rob_flag, uint32_t func3, bool slot_flag, uint32_t ssit_idx) {
   if (nxt.stq_count >= STQ_SIZE) {
     return false;
   }
@@ -1241,13 +1373,30 @@ bool RealLsu::alloc_stq_entry(mask_t br_mask, uint32_t rob_idx, uint32_t rob_fla
 #endif
     return false;
   }
-  StqEntry &entry = nxt.stq[stq_idx_after(nxt.stq_head, nxt.stq_count)];
+  const uint32_t stq_idx = stq_idx_after(nxt.stq_head, nxt.stq_count);
+  StqEntry &entry = stq.write(stq_idx);
   entry = {};
   entry.rob_idx = rob_idx;
   entry.rob_flag = rob_flag;
   entry.stq_flag = slot_flag;
   entry.br_mask = br_mask;
   entry.func3 = func3;
+  entry.ssit_idx = ssit_idx;
+
+#ifdef LSU_STORE_SET
+  // 属于某个 store-set 时接到 LFST 链尾，并成为该 set 最近的 store
+  const SsitEntry &ss = ssit[ssit_idx];
+  if (ss.valid) {
+    const LfstEntry &last = lfst.next(ss.ssid);
+    entry.ss_pred_valid = last.valid;
+    entry.ss_pred_idx = last.store.idx;
+    entry.ss_pred_flag = last.store.flag;
+    LfstEntry &upd = lfst.write(ss.ssid);
+    upd.valid = true;
+    upd.store.idx = stq_idx;
+    upd.store.flag = slot_flag;
+  }
+#endif
 
   nxt.stq_count++;
   return true;
@@ -1258,7 +1407,7 @@ StqEntry RealLsu::get_stq_entry(int idx, bool flag) {
     return {};
   }
 
-  StqEntry &entry = cur.stq[idx];
+  const StqEntry &entry = stq[idx];
   int32_t count = (idx + STQ_SIZE - cur.stq_head) % STQ_SIZE;
   if (entry.stq_flag != flag || count >= cur.stq_count) {
 #if !BSD_CONFIG
@@ -1271,7 +1420,8 @@ StqEntry RealLsu::get_stq_entry(int idx, bool flag) {
   return {};
 }
 
-bool RealLsu::alloc_ldq_entry(mask_t br_mask, uint32_t rob_idx, uint32_t rob_flag, uint32_t ldq_idx) {
+bool RealLsu::alloc_ldq_entry(mask_t br_mask, uint32_t rob_idx, uint32_t rob_flag, uint32_t ldq_idx, uint32_t ssit_idx,
+                              uint32_t pf_pc_hash) {
   if (nxt.ldq_count >= LDQ_SIZE) {
     return false;
   }
@@ -1282,12 +1432,111 @@ bool RealLsu::alloc_ldq_entry(mask_t br_mask, uint32_t rob_idx, uint32_t rob_fla
 #endif
     return false;
   }
-  LdqEntry &entry = nxt.ldq[(cur.ldq_head + nxt.ldq_count) % LDQ_SIZE];
+  LdqEntry &entry = ldq.write((cur.ldq_head + nxt.ldq_count) % LDQ_SIZE);
   entry = {};
   entry.rob_idx = rob_idx;
   entry.rob_flag = rob_flag;
   entry.br_mask = br_mask;
+  entry.ssit_idx = ssit_idx;
+  entry.pf_pc_hash = pf_pc_hash;
+
+#ifdef LSU_STORE_SET
+  const SsitEntry &ss = ssit[ssit_idx];
+  if (ss.valid && lfst.next(ss.ssid).valid) {
+    entry.ss_dep_valid = true;
+    entry.ss_dep = lfst.next(ss.ssid).store;
+  }
+#endif
 
   nxt.ldq_count++;
   return true;
 }
+
+/*
+ * ss_check_violation
+ * 功能: store 地址解析时，查找越过它推测发射且地址重叠的 younger load。
+ * 输入依赖: 本 store 的 paddr/func3，LDQ 发射窗口内 load 的 ldq.next() 状态。
+ * 输出更新: store.mem_violation（经 STA 写回置 flush_pipe），SSIT 训练。
+ * 约束: 发射过的 load 在 head 推进前始终位于 LOAD_WINDOWS_WIDTH 窗口内；
+ *       由比本 store 更年轻的 store 前递得到结果的 load 不算违例。
+ */
+void RealLsu::ss_check_violation(uint32_t stq_idx, StqEntry &store) {
+  const uint32_t store_pos = (stq_idx + STQ_SIZE - cur.stq_head) % STQ_SIZE;
+  const int32_t window =
+      cur.ldq_count > LOAD_WINDOWS_WIDTH ? LOAD_WINDOWS_WIDTH : cur.ldq_count;
+  for (int i = 0; i < window; i++) {
+    const LdqEntry &load = ldq.next((cur.ldq_head + i) % LDQ_SIZE);
+    if (!load.ss_spec) {
+      continue;
+    }
+    if (load.load_state != LoadState::ReadyToIssue &&
+        load.load_state != LoadState::WaitDcacheResp &&
+        load.load_state != LoadState::ReadyToWb &&
+        load.load_state != LoadState::Done) {
+      continue;
+    }
+    uint32_t older_store_count = 0;
+    if (!stq_distance_from_head_to_boundary(cur.stq_head, cur.stq_head_flag,
+                                            cur.stq_count, load.stq_snapshot,
+                                            older_store_count) ||
+        store_pos >= older_store_count) {
+      continue;
+    }
+    if (load.fwd_valid) {
+      const uint32_t fwd_pos =
+          (load.fwd_src.idx + STQ_SIZE - cur.stq_head) % STQ_SIZE;
+      if (fwd_pos > store_pos) {
+        continue;
+      }
+    }
+    if (check_stlf(load.p_addr, load.func3, store.paddr, store.func3) ==
+        STLFResult::Disjoint) {
+      continue;
+    }
+    store.mem_violation = true;
+    ss_train(load.ssit_idx, store.ssit_idx);
+  }
+#ifdef CONFIG_PERF_COUNTER
+  if (store.mem_violation) {
+    ctx->perf.ld_mem_violation_count++;
+  }
+#endif
+}
+
+// 违例训练：load 与 store 归入同一 store-set（都已有 set 时取较小的 SSID 合并）。
+void RealLsu::ss_train(uint32_t load_ssit_idx, uint32_t store_ssit_idx) {
+  const SsitEntry load_ss = ssit.next(load_ssit_idx);
+  const SsitEntry store_ss = ssit.next(store_ssit_idx);
+  uint32_t ssid = store_ssit_idx & (LFST_SIZE - 1);
+  if (load_ss.valid && store_ss.valid) {
+    ssid = std::min<uint32_t>(load_ss.ssid, store_ss.ssid);
+  } else if (load_ss.valid) {
+    ssid = load_ss.ssid;
+  } else if (store_ss.valid) {
+    ssid = store_ss.ssid;
+  }
+  ssit.write(load_ssit_idx).valid = true;
+  ssit.write(load_ssit_idx).ssid = ssid;
+  ssit.write(store_ssit_idx).valid = true;
+  ssit.write(store_ssit_idx).ssid = ssid;
+}
+
+// load 越过的 older store（前递来源之后的部分）是否都已解析出物理地址。
+bool RealLsu::ss_older_stores_resolved(const LdqEntry &load) const {
+  uint32_t older_store_count = 0;
+  if (!stq_distance_from_head_to_boundary(cur.stq_head, cur.stq_head_flag,
+                                          cur.stq_count, load.stq_snapshot,
+                                          older_store_count)) {
+    return true;
+  }
+  uint32_t first = 0;
+  if (load.fwd_valid) {
+    first = (load.fwd_src.idx + STQ_SIZE - cur.stq_head) % STQ_SIZE + 1;
+  }
+  for (uint32_t j = first; j < older_store_count; j++) {
+    if (!stq[(cur.stq_head + j) % STQ_SIZE].paddr_valid) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -188,7 +188,7 @@ void TlbMmu::record_trace(TraceSource source, Result result, uint32_t v_addr,
   trace_hist_head_ = (trace_hist_head_ + 1) % trace_hist_.size();
   slot = {};
   slot.valid = true;
-  slot.cycle = (sim_time >= 0) ? static_cast<uint64_t>(sim_time) : 0;
+  slot.cycle = (sim_now() >= 0) ? static_cast<uint64_t>(sim_now()) : 0;
   slot.source = source;
   slot.result = result;
   slot.retry = last_retry_reason_;
@@ -491,7 +491,7 @@ TlbMmu::Result TlbMmu::translate(uint32_t &p_addr, uint32_t v_addr,
       std::printf(
           "[ITLB][TRACE] cyc=%lld src=identity v=0x%08x p=0x%08x satp=0x%08x "
           "priv=%d type=%u ret=%s\n",
-          (long long)sim_time, v_addr, p_addr, satp, eff_priv, type,
+          (long long)sim_now(), v_addr, p_addr, satp, eff_priv, type,
           mmu_result_name(Result::OK));
     }
     return Result::OK;
@@ -510,7 +510,7 @@ TlbMmu::Result TlbMmu::translate(uint32_t &p_addr, uint32_t v_addr,
         std::printf(
             "[ITLB][TRACE] cyc=%lld src=tlb_hit_perm_fault v=0x%08x "
             "satp=0x%08x asid=0x%03x priv=%d type=%u perm=0x%02x ret=%s\n",
-            (long long)sim_time, v_addr, satp, asid, eff_priv, type, hit.perm,
+            (long long)sim_now(), v_addr, satp, asid, eff_priv, type, hit.perm,
             mmu_result_name(Result::FAULT));
       }
       return Result::FAULT;
@@ -522,7 +522,7 @@ TlbMmu::Result TlbMmu::translate(uint32_t &p_addr, uint32_t v_addr,
       std::printf(
           "[ITLB][TRACE] cyc=%lld src=tlb_hit v=0x%08x p=0x%08x satp=0x%08x "
           "asid=0x%03x priv=%d type=%u level=%u perm=0x%02x ret=%s\n",
-          (long long)sim_time, v_addr, p_addr, satp, asid, eff_priv, type,
+          (long long)sim_now(), v_addr, p_addr, satp, asid, eff_priv, type,
           static_cast<unsigned>(hit.level), hit.perm,
           mmu_result_name(Result::OK));
     }
@@ -536,7 +536,7 @@ TlbMmu::Result TlbMmu::translate(uint32_t &p_addr, uint32_t v_addr,
           "[ITLB][TRACE] cyc=%lld src=walk_shared v=0x%08x p=0x%08x "
           "satp=0x%08x asid=0x%03x priv=%d type=%u walk_active=%d "
           "walk_req_sent=%d ret=%s\n",
-          (long long)sim_time, v_addr, p_addr, satp, asid, eff_priv, type,
+          (long long)sim_now(), v_addr, p_addr, satp, asid, eff_priv, type,
           static_cast<int>(walk.active), static_cast<int>(walk.req_sent),
           mmu_result_name(ret));
     }
@@ -547,7 +547,7 @@ TlbMmu::Result TlbMmu::translate(uint32_t &p_addr, uint32_t v_addr,
     std::printf(
         "[ITLB][TRACE] cyc=%lld src=walk_local v=0x%08x p=0x%08x "
         "satp=0x%08x asid=0x%03x priv=%d type=%u ret=%s\n",
-        (long long)sim_time, v_addr, p_addr, satp, asid, eff_priv, type,
+        (long long)sim_now(), v_addr, p_addr, satp, asid, eff_priv, type,
         mmu_result_name(ret));
   }
   return ret;
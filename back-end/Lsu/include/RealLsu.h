@@ -1,5 +1,6 @@
 #pragma once
 
+#include "DualRankArray.h"
 #include "IO.h"
 #include "TlbMmu.h"
 #include "config.h"
@@ -85,6 +86,16 @@ struct LdqEntry {
 
   StoreTag stq_snapshot;
 
+  // store-set 预测
+  wire<SSIT_IDX_WIDTH> ssit_idx;
+  wire<L1D_PF_PC_HASH_WIDTH> pf_pc_hash; // 送往 L1D 预取器的 load PC 哈希
+  wire<1> ss_dep_valid; // 分配时 LFST 给出的依赖 store
+  StoreTag ss_dep;
+  wire<1> ss_wait;      // 曾因预测依赖而等待（统计 false dependence）
+  wire<1> ss_spec;      // 越过了地址未知的 older store 推测发射
+  wire<1> fwd_valid;    // 由 older store 前递得到结果
+  StoreTag fwd_src;
+
   #if !BSD_CONFIG
   wire<1> cache_miss; // 仅用于性能统计，非必需
   #endif
@@ -135,43 +146,48 @@ struct MMUDoneEntry{
   wire<1> valid;
   wire<STQ_IDX_WIDTH> stq_idx;
 };
+// Store Set ID Table：按 PC 哈希索引，给出访存指令所属的 store-set。
+struct SsitEntry {
+  wire<1> valid;
+  wire<SSID_WIDTH> ssid;
+};
+// Last Fetched Store Table：每个 store-set 最近分配进 STQ 的 store。
+struct LfstEntry {
+  wire<1> valid;
+  StoreTag store;
+};
 struct FinishEntry{
   wire<1> valid;
   wire<MAX_IDX_WIDTH> idx;
   wire<1> is_load;
 };
 
+// LSU 标量状态：各环形队列的 head/count/flag 与单元寄存器。
+// 队列条目本身放在 RealLsu 的 DualRankArray 中，cur/nxt 只镜像本结构。
 struct LsuState{
-  LdqEntry ldq[LDQ_SIZE];
   wire<LDQ_IDX_WIDTH> ldq_head;
   wire<1> ldq_head_flag;
   wire<LDQ_IDX_WIDTH+1> ldq_count; // 包括分配但未提交的条目
 
-  StqEntry stq[STQ_SIZE];
   wire<STQ_IDX_WIDTH> stq_head;
   wire<STQ_IDX_WIDTH> stq_commit;
   wire<1> stq_head_flag;
   wire<STQ_IDX_WIDTH+1> stq_commit_count; // 已提交但尚未排空的store条目数量
   wire<STQ_IDX_WIDTH+1> stq_count; // 包括分配但未提交的条目
 
-  WaitMmuSTQEntry wait_mmu_stq[STQ_SIZE]; 
   wire<STQ_IDX_WIDTH> wait_mmu_stq_head;
   wire<STQ_IDX_WIDTH+1> wait_mmu_stq_count;
 
-  WaitMmuLDQEntry wait_mmu_ldq[LDQ_SIZE];
   wire<LDQ_IDX_WIDTH> wait_mmu_ldq_head;
   wire<LDQ_IDX_WIDTH+1> wait_mmu_ldq_count;
 
-  MMUDoneEntry mmu_done_stq[STQ_SIZE];
   wire<STQ_IDX_WIDTH> mmu_done_stq_head;
   wire<STQ_IDX_WIDTH+1> mmu_done_stq_count;
 
-  FinishEntry finish[LDQ_SIZE+STQ_SIZE];
   wire<LDQ_STQ_IDX_WIDTH> finish_head;
   wire<LDQ_STQ_IDX_WIDTH+1> finish_count;
 
 
-  WaitDcacheLDQEntry wait_dcache_ldq[LDQ_SIZE];
   wire<LDQ_IDX_WIDTH> wait_dcache_ldq_head;
   wire<LDQ_IDX_WIDTH+1> wait_dcache_ldq_count;
 
@@ -183,6 +199,8 @@ struct LsuState{
   LrScUnit lrsc_unit;
 
   wire<31-LDQ_IDX_WIDTH> req_gen; // 用于区分不同轮次的重放，防止过期重放条目被误用
+
+  wire<32> ssit_clear_timer; // 距上次清空 SSIT 的周期数
 };
 
 enum class STLFResult : wire<2> {
@@ -197,6 +215,18 @@ public:
   LsuState cur;
   LsuState nxt;
 
+  // 环形队列条目：[] 读当前态，next()/write()/set() 访问下一拍副本，
+  // seq() 只提交本拍被写过的槽位。
+  DualRankArray<LdqEntry, LDQ_SIZE> ldq;
+  DualRankArray<StqEntry, STQ_SIZE> stq;
+  DualRankArray<WaitMmuSTQEntry, STQ_SIZE> wait_mmu_stq;
+  DualRankArray<WaitMmuLDQEntry, LDQ_SIZE> wait_mmu_ldq;
+  DualRankArray<MMUDoneEntry, STQ_SIZE> mmu_done_stq;
+  DualRankArray<FinishEntry, kFinishSize> finish;
+  DualRankArray<WaitDcacheLDQEntry, LDQ_SIZE> wait_dcache_ldq;
+  DualRankArray<SsitEntry, SSIT_SIZE> ssit;
+  DualRankArray<LfstEntry, LFST_SIZE> lfst;
+
   LsuIn in{};
   LsuOut out{};
   SimContext *ctx = nullptr;
@@ -227,8 +257,14 @@ public:
   void handle_store_data(const MicroOp &inst);
   void handle_load_req(const MicroOp &inst);
 
-  bool alloc_stq_entry(mask_t br_mask,uint32_t rob_idx, uint32_t rob_flag,uint32_t func3, bool slot_flag);
-  bool alloc_ldq_entry( mask_t br_mask,uint32_t rob_idx, uint32_t rob_flag,uint32_t ldq_idx);
+  bool alloc_stq_entry(mask_t br_mask,uint32_t rob_idx, uint32_t rob_flag,uint32_t func3, bool slot_flag, uint32_t ssit_idx);
+  bool alloc_ldq_entry( mask_t br_mask,uint32_t rob_idx, uint32_t rob_flag,uint32_t ldq_idx, uint32_t ssit_idx,
+                        uint32_t pf_pc_hash);
+
+  // store-set 依赖预测
+  void ss_check_violation(uint32_t stq_idx, StqEntry &store);
+  void ss_train(uint32_t load_ssit_idx, uint32_t store_ssit_idx);
+  bool ss_older_stores_resolved(const LdqEntry &load) const;
 
   void dump_debug_state(FILE *out)const;
   StqEntry get_stq_entry(int idx,bool flag);
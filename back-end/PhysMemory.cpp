@@ -1,60 +1,89 @@
 #include "PhysMemory.h"
+#include "Checkpoint.h"
+#include "SimThread.h"
 #include "config.h"
 
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <unordered_map>
-
-uint32_t *p_memory = nullptr;
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace {
-std::unordered_map<uint32_t, uint32_t> g_io_words;
-
 [[noreturn]] void pmem_fatal(const char *op, uint32_t addr, uint64_t size) {
   std::fprintf(stderr,
                "[PhysMemory] %s failed: addr=0x%08x size=%llu\n", op, addr,
                static_cast<unsigned long long>(size));
   std::abort();
 }
+} // namespace
 
-inline void pmem_require_ready(const char *op) {
-  if (p_memory != nullptr) {
+uint32_t *PhysMemory::map_image(void *addr, int share_flag) const {
+  const int fixed = (addr != nullptr) ? MAP_FIXED : 0;
+  void *p = mmap(addr, RAM_SIZE, PROT_READ | PROT_WRITE,
+                 share_flag | MAP_NORESERVE | fixed, image_fd_, 0);
+  return (p == MAP_FAILED) ? nullptr : static_cast<uint32_t *>(p);
+}
+
+void PhysMemory::require_ready(const char *op) const {
+  if (ram_ != nullptr) {
     return;
   }
   std::fprintf(stderr,
                "[PhysMemory] %s failed: RAM backend not initialized\n", op);
   std::abort();
 }
-} // namespace
 
-bool pmem_init() {
-  if (p_memory != nullptr) {
-    pmem_clear_all();
+bool PhysMemory::init() {
+  if (ram_ != nullptr) {
+    clear_all();
     return true;
   }
-  p_memory =
-      static_cast<uint32_t *>(std::calloc(PHYSICAL_MEMORY_LENGTH, sizeof(uint32_t)));
-  if (p_memory == nullptr) {
+  image_fd_ = memfd_create("pmem-image", 0);
+  if (image_fd_ < 0) {
     return false;
   }
-  g_io_words.clear();
+  if (ftruncate(image_fd_, RAM_SIZE) != 0) {
+    close(image_fd_);
+    image_fd_ = -1;
+    return false;
+  }
+  ram_ = map_image(nullptr, MAP_SHARED);
+  if (ram_ == nullptr) {
+    close(image_fd_);
+    image_fd_ = -1;
+    return false;
+  }
+  image_sealed_ = false;
+  io_words_.clear();
   return true;
 }
 
-void pmem_release() {
-  if (p_memory != nullptr) {
-    std::free(p_memory);
-    p_memory = nullptr;
+void PhysMemory::release() {
+  if (ram_ != nullptr) {
+    munmap(ram_, RAM_SIZE);
+    ram_ = nullptr;
   }
-  g_io_words.clear();
+  if (image_fd_ >= 0) {
+    close(image_fd_);
+    image_fd_ = -1;
+  }
+  image_sealed_ = false;
+  io_words_.clear();
 }
 
-void pmem_clear_all() {
-  if (p_memory != nullptr) {
-    std::memset(p_memory, 0, RAM_SIZE);
+void PhysMemory::clear_all() {
+  if (ram_ != nullptr) {
+    // 截断再扩展即整体打洞，不逐页清零；ram_ 回到装载态（MAP_SHARED）。
+    // 已建立的 COW 视图未私有化的页随之变化，调用方须在重新装载后重置视图。
+    if (ftruncate(image_fd_, 0) != 0 || ftruncate(image_fd_, RAM_SIZE) != 0 ||
+        map_image(ram_, MAP_SHARED) == nullptr) {
+      pmem_fatal("clear_all", PMEM_RAM_BASE, RAM_SIZE);
+    }
+    image_sealed_ = false;
   }
-  g_io_words.clear();
+  io_words_.clear();
 }
 
 bool pmem_is_ram_addr(uint32_t paddr, uint32_t size) {
@@ -66,32 +95,48 @@ bool pmem_is_ram_addr(uint32_t paddr, uint32_t size) {
   return end < static_cast<uint64_t>(PMEM_RAM_BASE) + RAM_SIZE;
 }
 
-uint32_t pmem_read(uint32_t paddr) {
-  pmem_require_ready("read");
+uint32_t PhysMemory::read(uint32_t paddr) const {
+  require_ready("read");
   const uint32_t word_addr = paddr & ~0x3u;
   if (pmem_is_ram_addr(word_addr, 4u)) {
-    return p_memory[(word_addr - PMEM_RAM_BASE) >> 2];
+    return ram_[(word_addr - PMEM_RAM_BASE) >> 2];
   }
-  auto it = g_io_words.find(word_addr);
-  return (it == g_io_words.end()) ? 0u : it->second;
+  auto it = io_words_.find(word_addr);
+  return (it == io_words_.end()) ? 0u : it->second;
 }
 
-void pmem_write(uint32_t paddr, uint32_t data) {
-  pmem_require_ready("write");
+void PhysMemory::write(uint32_t paddr, uint32_t data) {
+  require_ready("write");
   const uint32_t word_addr = paddr & ~0x3u;
   if (pmem_is_ram_addr(word_addr, 4u)) {
-    p_memory[(word_addr - PMEM_RAM_BASE) >> 2] = data;
+    ram_[(word_addr - PMEM_RAM_BASE) >> 2] = data;
     return;
   }
   if (data == 0u) {
-    g_io_words.erase(word_addr);
+    io_words_.erase(word_addr);
   } else {
-    g_io_words[word_addr] = data;
+    io_words_[word_addr] = data;
   }
 }
 
-void pmem_memcpy_to_ram(uint32_t ram_paddr, const void *src, size_t len) {
-  pmem_require_ready("memcpy_to_ram");
+void PhysMemory::collect_io_words(
+    std::unordered_map<uint32_t, uint32_t> &out) const {
+  require_ready("collect_io_words");
+  out.clear();
+  // IO 区不与 RAM 重叠，区内未写过的字读为零，只需遍历已存的 IO 字
+  for (const auto &kv : io_words_) {
+    for (const auto &range : kExpectedIoLayout) {
+      if (kv.first - range.base < range.size) {
+        out.emplace(kv.first, kv.second);
+        break;
+      }
+    }
+  }
+}
+
+void PhysMemory::memcpy_to_ram(uint32_t ram_paddr, const void *src,
+                               size_t len) {
+  require_ready("memcpy_to_ram");
   if (len == 0) {
     return;
   }
@@ -102,11 +147,12 @@ void pmem_memcpy_to_ram(uint32_t ram_paddr, const void *src, size_t len) {
     pmem_fatal("memcpy_to_ram", ram_paddr, len);
   }
   const size_t off = static_cast<size_t>(ram_paddr - PMEM_RAM_BASE);
-  std::memcpy(reinterpret_cast<uint8_t *>(p_memory) + off, src, len);
+  std::memcpy(reinterpret_cast<uint8_t *>(ram_) + off, src, len);
 }
 
-void pmem_memcpy_from_ram(void *dst, uint32_t ram_paddr, size_t len) {
-  pmem_require_ready("memcpy_from_ram");
+void PhysMemory::memcpy_from_ram(void *dst, uint32_t ram_paddr,
+                                 size_t len) const {
+  require_ready("memcpy_from_ram");
   if (len == 0) {
     return;
   }
@@ -117,9 +163,113 @@ void pmem_memcpy_from_ram(void *dst, uint32_t ram_paddr, size_t len) {
     pmem_fatal("memcpy_from_ram", ram_paddr, len);
   }
   const size_t off = static_cast<size_t>(ram_paddr - PMEM_RAM_BASE);
-  std::memcpy(dst, reinterpret_cast<const uint8_t *>(p_memory) + off, len);
+  std::memcpy(dst, reinterpret_cast<const uint8_t *>(ram_) + off, len);
+}
+
+uint32_t *PhysMemory::view_map(uint32_t *view) {
+  require_ready("view_map");
+  if (!image_sealed_) {
+    if (map_image(ram_, MAP_PRIVATE) == nullptr) {
+      pmem_fatal("view_map(seal)", PMEM_RAM_BASE, RAM_SIZE);
+    }
+    image_sealed_ = true;
+  }
+  uint32_t *mapped = map_image(view, MAP_PRIVATE);
+  if (mapped == nullptr) {
+    pmem_fatal("view_map", PMEM_RAM_BASE, RAM_SIZE);
+  }
+  return mapped;
+}
+
+bool PhysMemory::image_has_data(uint64_t offset, uint64_t len) const {
+  require_ready("image_has_data");
+  const off_t data = lseek(image_fd_, static_cast<off_t>(offset), SEEK_DATA);
+  if (data < 0) {
+    return errno != ENXIO; // ENXIO：offset 之后全是空洞
+  }
+  return static_cast<uint64_t>(data) < offset + len;
+}
+
+void PhysMemory::image_commit(const uint32_t *src,
+                              const std::vector<uint64_t> &dirty_page_bits) {
+  require_ready("image_commit");
+  constexpr size_t kPage = 4096;
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(src);
+  for (size_t w = 0; w < dirty_page_bits.size(); ++w) {
+    uint64_t bits = dirty_page_bits[w];
+    while (bits != 0) {
+      const size_t page = w * 64 + __builtin_ctzll(bits);
+      bits &= bits - 1;
+      const size_t off = page * kPage;
+      size_t done = 0;
+      while (done < kPage) {
+        const ssize_t n = pwrite(image_fd_, bytes + off + done, kPage - done,
+                                 static_cast<off_t>(off + done));
+        if (n < 0 && errno == EINTR) {
+          continue;
+        }
+        if (n <= 0) {
+          pmem_fatal("image_commit", PMEM_RAM_BASE + static_cast<uint32_t>(off),
+                     kPage);
+        }
+        done += static_cast<size_t>(n);
+      }
+    }
+  }
+  // DUT 视图整体丢弃私有页，重新看到提交后的镜像。
+  if (map_image(ram_, image_sealed_ ? MAP_PRIVATE : MAP_SHARED) ==
+      nullptr) {
+    pmem_fatal("image_commit(remap)", PMEM_RAM_BASE, RAM_SIZE);
+  }
+}
+
+PhysMemory &pmem_current() {
+  PhysMemory *pmem = sim_thread::pmem;
+  if (pmem == nullptr) {
+    std::fprintf(stderr,
+                 "[PhysMemory] no simulation instance bound to this thread\n");
+    std::abort();
+  }
+  return *pmem;
+}
+
+void pmem_clear_all() { pmem_current().clear_all(); }
+
+uint32_t pmem_read(uint32_t paddr) { return pmem_current().read(paddr); }
+
+void pmem_write(uint32_t paddr, uint32_t data) {
+  pmem_current().write(paddr, data);
+}
+
+void pmem_collect_io_words(std::unordered_map<uint32_t, uint32_t> &out) {
+  pmem_current().collect_io_words(out);
+}
+
+void pmem_memcpy_to_ram(uint32_t ram_paddr, const void *src, size_t len) {
+  pmem_current().memcpy_to_ram(ram_paddr, src, len);
+}
+
+void pmem_memcpy_from_ram(void *dst, uint32_t ram_paddr, size_t len) {
+  pmem_current().memcpy_from_ram(dst, ram_paddr, len);
+}
+
+uint32_t *pmem_ram_ptr() { return pmem_current().ram_ptr(); }
+
+uint32_t *pmem_view_map(uint32_t *view) {
+  return pmem_current().view_map(view);
+}
+
+void pmem_view_unmap(uint32_t *view) {
+  if (view != nullptr) {
+    munmap(view, RAM_SIZE);
+  }
+}
+
+bool pmem_image_has_data(uint64_t offset, uint64_t len) {
+  return pmem_current().image_has_data(offset, len);
 }
 
-uint32_t *pmem_ram_ptr() {
-  return p_memory;
+void pmem_image_commit(const uint32_t *src,
+                       const std::vector<uint64_t> &dirty_page_bits) {
+  pmem_current().image_commit(src, dirty_page_bits);
 }
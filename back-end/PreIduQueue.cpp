@@ -1,11 +1,6 @@
 #include "PreIduQueue.h"
 #include "types.h"
 
-#include <cstring>
-
-static InstructionBufferEntry push_entries[FETCH_WIDTH];
-static int push_count = 0;
-
 static void fill_ftq_pc_resp(FtqPcReadResp &resp, const FTQEntry &entry,
                              wire<1> entry_valid, const FtqPcReadReq &req) {
   resp = {};
@@ -38,7 +33,7 @@ void PreIduQueue::ftq_pop(int pop_cnt) {
     if (ftq_count_1 <= 0) {
       break;
     }
-    ftq_valid_1[ftq_head_1] = false;
+    ftq_valid.set(ftq_head_1, false);
     ftq_head_1 = (ftq_head_1 + 1) % FTQ_SIZE;
     ftq_count_1--;
   }
@@ -49,7 +44,7 @@ void PreIduQueue::ftq_recover(int new_tail) {
   int discarded = (ftq_tail_1 - normalized_tail + FTQ_SIZE) % FTQ_SIZE;
   for (int i = 0; i < discarded; i++) {
     int idx = (normalized_tail + i) % FTQ_SIZE;
-    ftq_valid_1[idx] = false;
+    ftq_valid.set(idx, false);
   }
   ftq_tail_1 = normalized_tail;
   ftq_count_1 -= discarded;
@@ -60,39 +55,32 @@ void PreIduQueue::ftq_flush() {
   ftq_tail_1 = 0;
   ftq_count_1 = 0;
   for (int i = 0; i < FTQ_SIZE; i++) {
-    ftq_valid_1[i] = false;
+    if (ftq_valid.next(i)) {
+      ftq_valid.set(i, false);
+    }
   }
 }
 
 void PreIduQueue::init() {
   ibuf.init();
-  ibuf_1.init();
   ftq_head = ftq_tail = ftq_count = 0;
   ftq_head_1 = ftq_tail_1 = ftq_count_1 = 0;
   push_count = 0;
-  for (int i = 0; i < FTQ_SIZE; i++) {
-    ftq_lookup_entries[i] = FTQEntry();
-    ftq_lookup_entries_1[i] = FTQEntry();
-    ftq_train_meta_fifo[i] = FTQTrainMetaEntry();
-    ftq_train_meta_fifo_1[i] = FTQTrainMetaEntry();
-    ftq_valid[i] = false;
-    ftq_valid_1[i] = false;
-  }
+  ftq_lookup_entries.reset(FTQEntry());
+  ftq_train_meta_fifo.reset(FTQTrainMetaEntry());
+  ftq_valid.reset(false);
 }
 
 void PreIduQueue::comb_begin() {
-  ibuf_1 = ibuf;
+  ibuf.comb_begin();
   ftq_head_1 = ftq_head;
   ftq_tail_1 = ftq_tail;
   ftq_count_1 = ftq_count;
-  std::memcpy(ftq_lookup_entries_1, ftq_lookup_entries, sizeof(ftq_lookup_entries));
-  std::memcpy(ftq_train_meta_fifo_1, ftq_train_meta_fifo, sizeof(ftq_train_meta_fifo));
-  std::memcpy(ftq_valid_1, ftq_valid, sizeof(ftq_valid));
 
   for (auto &e : out.issue->entries) {
     e = {};
   }
-  int n = ibuf.count() < DECODE_WIDTH ? ibuf.count() : DECODE_WIDTH;
+  int n = ibuf.count() < IDU_PEEK_WIDTH ? ibuf.count() : IDU_PEEK_WIDTH;
   for (int i = 0; i < n; i++) {
     out.issue->entries[i] = ibuf.peek(i);
   }
@@ -166,9 +154,9 @@ void PreIduQueue::comb_accept_front() {
     out.pre2front->ready = false;
     return;
   }
-  ftq_lookup_entries_1[ftq_alloc_idx] = ftq_lookup_entry;
-  ftq_train_meta_fifo_1[ftq_alloc_idx] = ftq_train_meta_entry;
-  ftq_valid_1[ftq_alloc_idx] = true;
+  ftq_lookup_entries.set(ftq_alloc_idx, ftq_lookup_entry);
+  ftq_train_meta_fifo.set(ftq_alloc_idx, ftq_train_meta_entry);
+  ftq_valid.set(ftq_alloc_idx, true);
 
   for (int i = 0; i < FETCH_WIDTH; i++) {
     out.pre2front->fire[i] = in.front2pre->valid[i];
@@ -207,7 +195,7 @@ void PreIduQueue::comb_fire() {
   bool ftq_recover_req = false;
   int ftq_recover_tail = 0;
 
-  for (int i = 0; i < DECODE_WIDTH; i++) {
+  for (int i = 0; i < IDU_PEEK_WIDTH; i++) {
     if (in.idu_consume->fire[i]) {
       pop_count++;
     } else {
@@ -234,16 +222,16 @@ void PreIduQueue::comb_fire() {
   }
 
   if (in.rob_bcast->flush) {
-    ibuf_1.clear();
+    ibuf.clear();
   } else if (in.idu_br_latch->mispred) {
-    ibuf_1.clear();
+    ibuf.clear();
   } else {
     if (pop_count > 0) {
-      ibuf_1.pop_front(pop_count);
+      ibuf.pop_front(pop_count);
     }
     if (push_count > 0) {
       for (int i = 0; i < push_count; i++) {
-        ibuf_1.push_back(push_entries[i]);
+        ibuf.push_back(push_entries[i]);
       }
     }
   }
@@ -286,13 +274,13 @@ void PreIduQueue::comb_ftq_lookup_rob() {
 }
 
 void PreIduQueue::seq() {
-  ibuf = ibuf_1;
+  ibuf.seq();
   ftq_head = ftq_head_1;
   ftq_tail = ftq_tail_1;
   ftq_count = ftq_count_1;
-  std::memcpy(ftq_lookup_entries, ftq_lookup_entries_1, sizeof(ftq_lookup_entries));
-  std::memcpy(ftq_train_meta_fifo, ftq_train_meta_fifo_1, sizeof(ftq_train_meta_fifo));
-  std::memcpy(ftq_valid, ftq_valid_1, sizeof(ftq_valid));
+  ftq_lookup_entries.seq();
+  ftq_train_meta_fifo.seq();
+  ftq_valid.seq();
 }
 
 const FTQEntry *PreIduQueue::lookup_ftq_entry(uint32_t idx) const {
@@ -12,7 +12,7 @@ static inline bool is_killed(const ExePrfIO::ExePrfWbUop &uop,
 }
 
 inline uint32_t read_operand_with_bypass(
-    uint32_t preg, bool src_en, const reg<32> *reg_file,
+    uint32_t preg, bool src_en, const DualRankArray<reg<32>, PRF_NUM> &reg_file,
     const ExePrfIO::ExePrfEntry *inst_r, const ExePrfIO *exe2prf) {
   if (!src_en) {
     return 0;
@@ -60,10 +60,7 @@ static inline bool is_load_wb(const ExePrfIO::ExePrfWbUop &uop) {
 } // namespace
 
 void Prf::init() {
-  for (int i = 0; i < PRF_NUM; i++) {
-    reg_file[i] = 0;
-    reg_file_1[i] = 0;
-  }
+  reg_file.reset(0);
   for (int i = 0; i < ISSUE_WIDTH; i++) {
     inst_r[i] = {};
     inst_r_1[i] = {};
@@ -71,13 +68,10 @@ void Prf::init() {
 }
 
 // 功能：复制 PRF 当前状态到本拍工作副本（*_1）。
-// 输入依赖：reg_file[]、inst_r[]。
-// 输出更新：reg_file_1[]、inst_r_1[]。
-// 约束：仅状态镜像，不进行读/写/旁路决策。
+// 输入依赖：inst_r[]。
+// 输出更新：inst_r_1[]。
+// 约束：仅状态镜像，不进行读/写/旁路决策；reg_file 由写日志提交，无需整表拷贝。
 void Prf::comb_begin() {
-  for (int i = 0; i < PRF_NUM; i++) {
-    reg_file_1[i] = reg_file[i];
-  }
   for (int i = 0; i < ISSUE_WIDTH; i++) {
     inst_r_1[i] = inst_r[i];
   }
@@ -177,16 +171,15 @@ void Prf::comb_complete() {
 
 // 功能：将写回级结果写入物理寄存器堆下一拍副本。
 // 输入依赖：inst_r[]（valid/dest_en/dest_preg/result）。
-// 输出更新：reg_file_1[]。
-// 约束：x0 不可写，reg_file_1[0] 始终保持 0。
+// 输出更新：reg_file（rank1）。
+// 约束：x0 不可写，preg0 只在复位时写 0，之后写口一律过滤。
 void Prf::comb_write() {
   // 将写回级结果写入寄存器堆，x0 始终保持为 0。
   for (int i = 0; i < ISSUE_WIDTH; i++) {
     if (inst_r[i].valid && inst_r[i].uop.dest_en && inst_r[i].uop.dest_preg != 0) {
-      reg_file_1[inst_r[i].uop.dest_preg] = inst_r[i].uop.result;
+      reg_file.set(inst_r[i].uop.dest_preg, inst_r[i].uop.result);
     }
   }
-  reg_file_1[0] = 0;
 }
 
 // 功能：推进 PRF 写回流水寄存器，并处理 flush/mispred/clear_mask。
@@ -214,11 +207,7 @@ void Prf::comb_pipeline() {
 }
 
 void Prf::seq() {
-  for (int i = 0; i < PRF_NUM; i++) {
-    reg_file[i] = reg_file_1[i];
-  }
-  reg_file[0] = 0;
-  reg_file_1[0] = 0;
+  reg_file.seq();
 
   for (int i = 0; i < ISSUE_WIDTH; i++) {
     inst_r[i] = inst_r_1[i];
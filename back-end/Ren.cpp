@@ -5,9 +5,67 @@
 
 #include "util.h"
 
-// 多个comb复用的中间信号
-static wire<1> fire[DECODE_WIDTH];
-static wire<PRF_IDX_WIDTH> alloc_reg[DECODE_WIDTH];
+enum MoveElimKind {
+  ELIM_NONE = 0,
+  ELIM_MOVE_SRC1 = 1, // rd <- rs1
+  ELIM_MOVE_SRC2 = 2, // rd <- rs2
+  ELIM_ZERO = 3,      // rd <- 0，映射到常零 preg 0
+};
+
+// 识别可在 Rename 消除的整数搬移与清零惯用法（仅看译码字段，不看操作数值）：
+//   addi/xori/ori rd, rs, 0 与 add/xor/or/sub rd, rs, x0  -> 搬移
+//   add/or/xor rd, x0, rs                                 -> 搬移
+//   andi rd, rs, 0 / and rd, rs, x0 / xor/sub rd, rs, rs  -> 清零
+//   lui rd, 0 与源为 x0 的搬移（含 li rd, 0）               -> 清零
+static int move_elim_kind(const DecRenIO::DecRenInst &inst) {
+#ifdef REN_MOVE_ELIM
+  if (!inst.dest_en || inst.dest_areg == 0 ||
+      decode_inst_type(inst.type) != ADD || inst.src1_is_pc ||
+      inst.page_fault_inst || inst.illegal_inst) {
+    return ELIM_NONE;
+  }
+  int kind = ELIM_NONE;
+  if (!inst.src2_en) {
+    // OP-IMM / lui：rs2 字段属于立即数
+    if (inst.imm != 0) {
+      return ELIM_NONE;
+    }
+    if (inst.func3 == 0b000 || inst.func3 == 0b100 || inst.func3 == 0b110) {
+      kind = ELIM_MOVE_SRC1;
+    } else if (inst.func3 == 0b111) {
+      kind = ELIM_ZERO;
+    }
+  } else if (inst.func7 == 0b0000000) {
+    if (inst.func3 == 0b100 && inst.src1_areg == inst.src2_areg) {
+      kind = ELIM_ZERO;
+    } else if (inst.func3 == 0b000 || inst.func3 == 0b100 ||
+               inst.func3 == 0b110) {
+      if (inst.src2_areg == 0) {
+        kind = ELIM_MOVE_SRC1;
+      } else if (inst.src1_areg == 0) {
+        kind = ELIM_MOVE_SRC2;
+      }
+    } else if (inst.func3 == 0b111 &&
+               (inst.src1_areg == 0 || inst.src2_areg == 0)) {
+      kind = ELIM_ZERO;
+    }
+  } else if (inst.func7 == 0b0100000 && inst.func3 == 0b000) { // sub
+    if (inst.src1_areg == inst.src2_areg) {
+      kind = ELIM_ZERO;
+    } else if (inst.src2_areg == 0) {
+      kind = ELIM_MOVE_SRC1;
+    }
+  }
+  if ((kind == ELIM_MOVE_SRC1 && inst.src1_areg == 0) ||
+      (kind == ELIM_MOVE_SRC2 && inst.src2_areg == 0)) {
+    kind = ELIM_ZERO;
+  }
+  return kind;
+#else
+  (void)inst;
+  return ELIM_NONE;
+#endif
+}
 
 static inline int ring_distance(int from, int to) {
   int d = to - from;
@@ -18,8 +76,10 @@ static inline int ring_distance(int from, int to) {
 }
 
 static inline void ren_freelist_sanity(int spec_head, int commit_head,
-                                       int tail) {
-  constexpr int kManagedPool = PRF_NUM - (ARF_NUM + 1);
+                                       int tail, int arch_cnt) {
+  Assert(arch_cnt > 0 && arch_cnt <= ARF_NUM + 1 &&
+         "Ren: arch preg count out of range");
+  const int kManagedPool = PRF_NUM - arch_cnt;
   Assert(spec_head >= 0 && spec_head < PRF_NUM &&
          "Ren: free_head(spec) out of range");
   Assert(commit_head >= 0 && commit_head < PRF_NUM &&
@@ -31,7 +91,7 @@ static inline void ren_freelist_sanity(int spec_head, int commit_head,
   Assert(pending_spec >= 0 && pending_spec < PRF_NUM &&
          "Ren: pending spec distance out of range");
   Assert(free_cnt + pending_spec == kManagedPool &&
-         "Ren: free slots + pending spec must equal managed pool");
+         "Ren: free slots + pending spec + arch pregs must equal PRF_NUM");
 }
 
 void Ren::init() {
@@ -40,18 +100,21 @@ void Ren::init() {
     if (i < ARF_NUM + 1) {
       spec_RAT[i] = i;
       arch_RAT[i] = i;
+      arch_ref[i] = 1;
     } else {
       free_list[init_free_count] = i;
       init_free_count++;
+      arch_ref[i] = 0;
     }
   }
   free_head = 0;
   free_head_commit = 0;
   free_tail = init_free_count;
+  arch_preg_cnt = ARF_NUM + 1;
   for (int i = 0; i < MAX_BR_NUM; i++) {
     alloc_checkpoint_head[i] = free_head;
   }
-  ren_freelist_sanity(free_head, free_head_commit, free_tail);
+  ren_freelist_sanity(free_head, free_head_commit, free_tail, arch_preg_cnt);
 
   for (int i = 0; i < DECODE_WIDTH; i++) {
     inst_r[i] = {};
@@ -68,13 +131,15 @@ void Ren::init() {
   free_tail_1 = free_tail;
   memcpy(alloc_checkpoint_head_1, alloc_checkpoint_head,
          MAX_BR_NUM * sizeof(reg<PRF_IDX_WIDTH>));
+  memcpy(arch_ref_1, arch_ref, PRF_NUM * sizeof(reg<AREG_IDX_WIDTH>));
+  arch_preg_cnt_1 = arch_preg_cnt;
 }
 
 /*
  * comb_begin
  * 功能: 组合阶段开始时，将所有时序状态复制到 *_1 工作副本。
- * 输入依赖: inst_r/inst_valid, spec_RAT, arch_RAT, RAT_checkpoint, free list 与 checkpoint 指针状态。
- * 输出更新: inst_r_1/inst_valid_1, spec_RAT_1, arch_RAT_1, RAT_checkpoint_1, free list 与 checkpoint 指针状态。
+ * 输入依赖: inst_r/inst_valid, spec_RAT, arch_RAT, RAT_checkpoint, free list 与 checkpoint 指针状态, arch_ref。
+ * 输出更新: inst_r_1/inst_valid_1, spec_RAT_1, arch_RAT_1, RAT_checkpoint_1, free list 与 checkpoint 指针状态, arch_ref_1。
  * 约束: 仅做状态镜像，不进行分配/回收决策，不驱动握手输出。
  */
 void Ren::comb_begin() {
@@ -90,23 +155,31 @@ void Ren::comb_begin() {
   free_tail_1 = free_tail;
   memcpy(alloc_checkpoint_head_1, alloc_checkpoint_head,
          MAX_BR_NUM * sizeof(reg<PRF_IDX_WIDTH>));
+  memcpy(arch_ref_1, arch_ref, PRF_NUM * sizeof(reg<AREG_IDX_WIDTH>));
+  arch_preg_cnt_1 = arch_preg_cnt;
 }
 
 /*
  * comb_alloc
- * 功能: 从 free list 预选目的物理寄存器，并生成 ren2dis.valid 的资源可用性结果。
- * 输入依赖: free_list/head/count, inst_valid, inst_r[].dest_en。
- * 输出更新: alloc_reg, out.ren2dis->valid[]（以及性能计数器相关统计）。
- * 约束: 顺序分配且一旦前序指令因寄存器不足 stall，后续槽位同拍全部阻塞。
+ * 功能: 识别可消除的搬移/清零指令，为其余写寄存器指令从 free list 预选目的物理寄存器，并生成 ren2dis.valid 的资源可用性结果。
+ * 输入依赖: free_list/head/count, inst_valid, inst_r[]（dest_en 与 move elimination 判定字段）。
+ * 输出更新: elim_kind, alloc_reg, out.ren2dis->valid[]（以及性能计数器相关统计）。
+ * 约束: 顺序分配且一旦前序指令因寄存器不足 stall，后续槽位同拍全部阻塞；被消除的指令不占 free list。
  */
 void Ren::comb_alloc() {
-  ren_freelist_sanity(free_head, free_head_commit, free_tail);
+  ren_freelist_sanity(free_head, free_head_commit, free_tail, arch_preg_cnt);
   wire<1> alloc_valid[DECODE_WIDTH] = {false};
+  wire<1> need_alloc[DECODE_WIDTH];
   int local_head = free_head;
   int local_free_count = ring_distance(free_head, free_tail);
+  for (int i = 0; i < DECODE_WIDTH; i++) {
+    elim_kind[i] = inst_valid[i] ? move_elim_kind(inst_r[i]) : ELIM_NONE;
+    need_alloc[i] =
+        inst_valid[i] && inst_r[i].dest_en && elim_kind[i] == ELIM_NONE;
+  }
   for (int i = 0; i < DECODE_WIDTH; i++) {
     alloc_reg[i] = 0;
-    if (inst_valid[i] && inst_r[i].dest_en && local_free_count > 0) {
+    if (need_alloc[i] && local_free_count > 0) {
       alloc_reg[i] = free_list[local_head];
       alloc_valid[i] = true;
       LOOP_INC(local_head, PRF_NUM);
@@ -118,10 +191,10 @@ void Ren::comb_alloc() {
   // 一条指令stall，后面的也stall
   wire<1> stall = false;
   for (int i = 0; i < DECODE_WIDTH; i++) {
-    if (inst_valid[i] && inst_r[i].dest_en && !stall) {
+    if (need_alloc[i] && !stall) {
       out.ren2dis->valid[i] = alloc_valid[i];
       stall = !alloc_valid[i];
-    } else if (inst_valid[i] && !inst_r[i].dest_en) {
+    } else if (inst_valid[i] && !need_alloc[i]) {
       out.ren2dis->valid[i] = !stall;
     } else {
       out.ren2dis->valid[i] = false;
@@ -139,8 +212,10 @@ void Ren::comb_alloc() {
  * comb_rename
  * 功能: 基于 spec_RAT 完成源/目的寄存器重命名，并处理同拍 RAW/WAW 旁路。
  * 输入依赖: inst_r/inst_valid, spec_RAT, alloc_reg, out.ren2dis->uop[j].dest_preg（同拍前序旁路）。
- * 输出更新: out.ren2dis->uop[] 的 src1_preg/src2_preg/old_dest_preg/dest_preg。
+ * 输出更新: out.ren2dis->uop[] 的 src1_preg/src2_preg/old_dest_preg/dest_preg/move_elim。
  * 约束: 旁路仅来自同拍更早槽位；x0 写入不参与旁路；旁路优先于 spec_RAT 常规查表结果。
+ *       被消除的搬移以重命名后的源 preg 作为 dest_preg（清零惯用法取 preg 0），
+ *       因此按槽位顺序确定，后续槽位的旁路可直接看到。
  */
 void Ren::comb_rename() {
 
@@ -165,11 +240,9 @@ void Ren::comb_rename() {
     src2_preg_normal[i] = spec_RAT[inst_r[i].src2_areg];
   }
 
-  // 针对RAT的raw bypass
-  src1_bypass_hit[0] = false;
-  src2_bypass_hit[0] = false;
-  old_dest_bypass_hit[0] = false;
-  for (int i = 1; i < DECODE_WIDTH; i++) {
+  // 针对RAT的raw bypass + 重命名 (Rename)
+  // 按槽位顺序完成：被消除搬移的 dest_preg 取决于其源的旁路结果
+  for (int i = 0; i < DECODE_WIDTH; i++) {
     src1_bypass_hit[i] = false;
     src2_bypass_hit[i] = false;
     old_dest_bypass_hit[i] = false;
@@ -198,10 +271,7 @@ void Ren::comb_rename() {
         old_dest_preg_bypass[i] = out.ren2dis->uop[j].dest_preg;
       }
     }
-  }
 
-  // 重命名 (Rename)
-  for (int i = 0; i < DECODE_WIDTH; i++) {
     if (src1_bypass_hit[i]) {
       out.ren2dis->uop[i].src1_preg = src1_preg_bypass[i];
     } else {
@@ -219,6 +289,18 @@ void Ren::comb_rename() {
     } else {
       out.ren2dis->uop[i].old_dest_preg = old_dest_preg_normal[i];
     }
+
+    // move elimination：目的 areg 直接指向源 preg / 常零 preg 0
+    if (elim_kind[i] != ELIM_NONE) {
+      out.ren2dis->uop[i].move_elim = true;
+      if (elim_kind[i] == ELIM_MOVE_SRC1) {
+        out.ren2dis->uop[i].dest_preg = out.ren2dis->uop[i].src1_preg;
+      } else if (elim_kind[i] == ELIM_MOVE_SRC2) {
+        out.ren2dis->uop[i].dest_preg = out.ren2dis->uop[i].src2_preg;
+      } else {
+        out.ren2dis->uop[i].dest_preg = 0;
+      }
+    }
   }
 }
 
@@ -226,8 +308,9 @@ void Ren::comb_rename() {
  * comb_fire
  * 功能: 在 ren->dis 握手成功时提交重命名状态更新，并处理 commit/flush/mispred 恢复。
  * 输入依赖: out.ren2dis->valid, in.dis2ren->ready, inst_r, in.rob_commit, in.rob_bcast, in.dec_bcast, arch/spec RAT 与 checkpoint 状态。
- * 输出更新: spec_RAT_1, arch_RAT_1, free_list_1 与指针计数, RAT_checkpoint_1, out.ren2dec->ready。
+ * 输出更新: spec_RAT_1, arch_RAT_1, arch_ref_1, free_list_1 与指针计数, RAT_checkpoint_1, out.ren2dec->ready。
  * 约束: flush 优先于 mispred；mispred 从 checkpoint 恢复；flush 从 arch_RAT 恢复；分支 fire 时保存 checkpoint。
+ *       引用计数只随 commit 变化，flush/mispred 恢复无需回滚；old_dest 引用归零才回收。
  */
 void Ren::comb_fire() {
   for (int i = 0; i < DECODE_WIDTH; i++) {
@@ -237,10 +320,12 @@ void Ren::comb_fire() {
   for (int i = 0; i < DECODE_WIDTH; i++) {
     if (fire[i] && out.ren2dis->uop[i].dest_en) {
       int dest_preg = out.ren2dis->uop[i].dest_preg;
-      Assert(free_head_1 != free_tail_1 &&
-             "Ren: allocate when free list is empty");
       spec_RAT_1[inst_r[i].dest_areg] = dest_preg;
-      LOOP_INC(free_head_1, PRF_NUM);
+      if (!out.ren2dis->uop[i].move_elim) {
+        Assert(free_head_1 != free_tail_1 &&
+               "Ren: allocate when free list is empty");
+        LOOP_INC(free_head_1, PRF_NUM);
+      }
     }
 
     // 保存检查点 (Checkpoint)
@@ -270,6 +355,30 @@ void Ren::comb_fire() {
     if (in.rob_commit->commit_entry[i].valid) {
       const auto &commit_uop = in.rob_commit->commit_entry[i].uop;
       ctx->perf.commit_num++;
+      // 宏融合 uop 提交两条架构指令（中断时整条未执行，按一条计）
+      const bool fused_commit =
+          commit_uop.fuse_kind != FUSE_NONE && !in.rob_bcast->interrupt;
+      if (fused_commit) {
+        ctx->perf.commit_num++;
+#ifdef CONFIG_PERF_COUNTER
+        switch (commit_uop.fuse_kind) {
+        case FUSE_LUI_ADDI:
+          ctx->perf.fuse_lui_addi_num++;
+          break;
+        case FUSE_AUIPC_ADDI:
+          ctx->perf.fuse_auipc_addi_num++;
+          break;
+        case FUSE_ZEXT:
+          ctx->perf.fuse_zext_num++;
+          break;
+        case FUSE_LUI_LOAD:
+          ctx->perf.fuse_lui_load_num++;
+          break;
+        default:
+          break;
+        }
+#endif
+      }
       if (is_load(commit_uop)) {
         ctx->perf.commit_load_num++;
       }
@@ -280,7 +389,7 @@ void Ren::comb_fire() {
       if (ctx->is_ckpt) {
         if (!ctx->perf.perf_start &&
             ctx->perf.commit_num >= ctx->ckpt_warmup_commit_target) {
-          std::cout << "[CKPT] O3 warmup done at commit " << std::dec
+          std::cout << "[CKPT] O3 warmup done at commit "
                     << ctx->perf.commit_num << "/" << ctx->ckpt_warmup_commit_target
                     << ". Resetting perf counters and starting measure phase."
                     << std::endl;
@@ -299,13 +408,40 @@ void Ren::comb_fire() {
       InstInfo *inst = &commit_entry.uop;
 
       // 异常指令提交时不回收 old_dest，保持“异常指令看起来未提交”的语义。
+      // 先加 dest 引用再减 old_dest 引用（mv x, x 时两者相同，不能回收）。
       if (inst->dest_en) {
         if (!is_exception(*inst) && !in.rob_bcast->interrupt) {
-          Assert(free_head_commit_1 != free_head_1 &&
-                 "Ren: commit reclaim when no pending spec allocation");
-          free_list_1[free_tail_1] = inst->old_dest_preg;
-          LOOP_INC(free_tail_1, PRF_NUM);
-          LOOP_INC(free_head_commit_1, PRF_NUM);
+          const int dest_preg = inst->dest_preg;
+          const int old_preg = inst->old_dest_preg;
+          if (!commit_uop.move_elim) {
+            Assert(free_head_commit_1 != free_head_1 &&
+                   "Ren: commit reclaim when no pending spec allocation");
+            Assert(arch_ref_1[dest_preg] == 0 &&
+                   "Ren: newly allocated preg already referenced");
+            LOOP_INC(free_head_commit_1, PRF_NUM);
+          } else {
+            Assert(arch_ref_1[dest_preg] != 0 &&
+                   "Ren: eliminated move source not in arch_RAT");
+#ifdef CONFIG_PERF_COUNTER
+            if (dest_preg == 0) {
+              ctx->perf.zero_idiom_elim_num++;
+            } else {
+              ctx->perf.move_elim_num++;
+            }
+#endif
+          }
+          if (arch_ref_1[dest_preg] == 0) {
+            arch_preg_cnt_1++;
+          }
+          arch_ref_1[dest_preg]++;
+          Assert(arch_ref_1[old_preg] != 0 &&
+                 "Ren: old_dest preg not referenced by arch_RAT");
+          arch_ref_1[old_preg]--;
+          if (arch_ref_1[old_preg] == 0) {
+            arch_preg_cnt_1--;
+            free_list_1[free_tail_1] = old_preg;
+            LOOP_INC(free_tail_1, PRF_NUM);
+          }
         }
       }
 
@@ -314,6 +450,21 @@ void Ren::comb_fire() {
       if (inst->dest_en && !is_exception(*inst) && !in.rob_bcast->interrupt) {
         arch_RAT_1[inst->dest_areg] = inst->dest_preg;
       }
+      if (fused_commit) {
+        // 参考模型先单独执行第一条：DUT 此时只有融合后的 rd，故不比对；
+        // 第二条以自身 PC/指令字走正常提交与比对。
+#ifdef CONFIG_DIFFTEST
+        InstEntry head_entry{};
+        head_entry.valid = true;
+        head_entry.uop.type = ADD;
+        head_entry.uop.dbg.pc = inst->dbg.pc;
+        head_entry.uop.dbg.instruction = inst->dbg.instruction;
+        head_entry.uop.dbg.inst_idx = inst->dbg.inst_idx;
+        ctx->run_difftest_inst(&head_entry, false);
+#endif
+        inst->dbg.pc = inst->dbg.pc + 4;
+        inst->dbg.instruction = inst->dbg.fused_instruction;
+      }
       ctx->run_commit_inst(&commit_entry);
 #ifdef CONFIG_DIFFTEST
       ctx->run_difftest_inst(&commit_entry);
@@ -340,7 +491,8 @@ void Ren::comb_fire() {
     free_head_1 = target_head;
     free_tail_1 = free_tail;
   }
-  ren_freelist_sanity(free_head_1, free_head_commit_1, free_tail_1);
+  ren_freelist_sanity(free_head_1, free_head_commit_1, free_tail_1,
+                      arch_preg_cnt_1);
 }
 
 /*
@@ -407,6 +559,8 @@ void Ren ::seq() {
   free_head = free_head_1;
   free_head_commit = free_head_commit_1;
   free_tail = free_tail_1;
+  memcpy(arch_ref, arch_ref_1, PRF_NUM * sizeof(reg<AREG_IDX_WIDTH>));
+  arch_preg_cnt = arch_preg_cnt_1;
 
   memcpy(RAT_checkpoint, RAT_checkpoint_1,
          MAX_BR_NUM * (ARF_NUM + 1) * sizeof(reg<PRF_IDX_WIDTH>));
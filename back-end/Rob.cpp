@@ -53,24 +53,17 @@ void Rob::init() {
   deq_flag = deq_flag_1 = false;
   stall_cycle = 0;
 
-  for (int i = 0; i < ROB_LINE_NUM; i++) {
-    for (int j = 0; j < ROB_BANK_NUM; j++) {
-      entry[j][i].valid = false;
-      entry_1[j][i].valid = false;
-    }
-  }
+  RobStoredEntry empty_entry;
+  empty_entry.valid = false;
+  entry.reset(empty_entry);
 }
 
-// 功能：复制 ROB 当前状态到本拍工作副本（*_1）。
-// 输入依赖：entry[][]、enq_ptr/deq_ptr、enq_flag/deq_flag。
-// 输出更新：entry_1[][]、enq_ptr_1/deq_ptr_1、enq_flag_1/deq_flag_1。
-// 约束：仅状态镜像，不做提交/分配/恢复决策。
+// 功能：复制 ROB 指针到本拍工作副本（*_1）。
+// 输入依赖：enq_ptr/deq_ptr、enq_flag/deq_flag。
+// 输出更新：enq_ptr_1/deq_ptr_1、enq_flag_1/deq_flag_1。
+// 约束：仅状态镜像，不做提交/分配/恢复决策；条目阵列由 DualRankArray
+// 保证 comb 入口两 rank 一致，无需整表拷贝。
 void Rob::comb_begin() {
-  for (int i = 0; i < ROB_BANK_NUM; i++) {
-    for (int j = 0; j < ROB_LINE_NUM; j++) {
-      entry_1[i][j] = entry[i][j];
-    }
-  }
   enq_ptr_1 = enq_ptr;
   deq_ptr_1 = deq_ptr;
   enq_flag_1 = enq_flag;
@@ -87,7 +80,7 @@ void Rob::comb_ready() {
   out.rob2csr->interrupt_resp = false;
 
   for (int i = 0; i < ROB_BANK_NUM; i++) {
-    if (entry[i][deq_ptr].valid && rob_is_flush_inst(entry[i][deq_ptr].uop)) {
+    if (entry[rob_slot(i, deq_ptr)].valid && rob_is_flush_inst(entry[rob_slot(i, deq_ptr)].uop)) {
       out.rob2dis->stall = true;
       break;
     }
@@ -103,14 +96,14 @@ void Rob::comb_ready() {
   bool stall_is_miss = false;
 
   for (int i = 0; i < ROB_BANK_NUM; i++) {
-    if (entry[i][deq_ptr].valid) {
-      bool is_ready = rob_is_complete(entry[i][deq_ptr].uop);
+    if (entry[rob_slot(i, deq_ptr)].valid) {
+      bool is_ready = rob_is_complete(entry[rob_slot(i, deq_ptr)].uop);
 
       if (!is_ready) {
         // This is the oldest incomplete instruction. It is the bottleneck.
         found_stall = true;
-        if (rob_is_load(entry[i][deq_ptr].uop) ||
-            rob_is_store(entry[i][deq_ptr].uop)) {
+        if (rob_is_load(entry[rob_slot(i, deq_ptr)].uop) ||
+            rob_is_store(entry[rob_slot(i, deq_ptr)].uop)) {
           stall_is_mem = true;
           uint32_t rob_idx = i + (deq_ptr * ROB_BANK_NUM);
           stall_is_miss = (rob_idx < ROB_NUM)
@@ -147,10 +140,10 @@ void Rob::comb_ftq_pc_req() {
   }
 
   for (int i = 0; i < ROB_BANK_NUM; i++) {
-    if (entry[i][deq_ptr].valid) {
+    if (entry[rob_slot(i, deq_ptr)].valid) {
       out.ftq_pc_req->req[0].valid = true;
-      out.ftq_pc_req->req[0].ftq_idx = entry[i][deq_ptr].uop.ftq_idx;
-      out.ftq_pc_req->req[0].ftq_offset = entry[i][deq_ptr].uop.ftq_offset;
+      out.ftq_pc_req->req[0].ftq_idx = entry[rob_slot(i, deq_ptr)].uop.ftq_idx;
+      out.ftq_pc_req->req[0].ftq_offset = entry[rob_slot(i, deq_ptr)].uop.ftq_offset;
       break;
     }
   }
@@ -158,7 +151,7 @@ void Rob::comb_ftq_pc_req() {
 
 // 功能：执行 ROB 提交仲裁（组提交/单提交）、flush/异常/中断广播与提交输出生成。
 // 输入依赖：entry[][deq_ptr]、in.dec_bcast、in.csr2rob、in.ftq_pc_resp、in.lsu2rob。
-// 输出更新：out.rob_commit、out.rob_bcast、out.rob2csr、out.rob2dis->enq_idx/rob_flag，及 entry_1/deq_ptr_1/deq_flag_1。
+// 输出更新：out.rob_commit、out.rob_bcast、out.rob2csr、out.rob2dis->enq_idx/rob_flag，及 entry（rank1）/deq_ptr_1/deq_flag_1。
 // 约束：flush/异常/中断必须在精确提交点触发；特殊指令与中断走单提交路径。
 void Rob::comb_commit() {
   out.rob_bcast->flush = out.rob_bcast->exception = out.rob_bcast->mret =
@@ -172,6 +165,8 @@ void Rob::comb_commit() {
 
   out.rob_bcast->page_fault_inst = out.rob_bcast->page_fault_load =
       out.rob_bcast->page_fault_store = out.rob_bcast->illegal_inst = false;
+  out.rob_bcast->fuse_replay = false;
+  out.rob_bcast->inst_bytes = 4;
 
   // 广播队头行的第一个 valid 项，以及该行里第一个未完成项。
   // LSU 使用后者决定 MMIO 访存何时可以发射，避免与 ROB 的整行提交
@@ -182,15 +177,15 @@ void Rob::comb_commit() {
   out.rob_bcast->head_incomplete_rob_idx = 0;
   if (!is_empty()) {
     for (int i = 0; i < ROB_BANK_NUM; i++) {
-      if (entry[i][deq_ptr].valid) {
+      if (entry[rob_slot(i, deq_ptr)].valid) {
         out.rob_bcast->head_valid = true;
         out.rob_bcast->head_rob_idx = make_rob_idx(deq_ptr, i);
         break;
       }
     }
     for (int i = 0; i < ROB_BANK_NUM; i++) {
-      if (entry[i][deq_ptr].valid &&
-          !rob_is_complete(entry[i][deq_ptr].uop)) {
+      if (entry[rob_slot(i, deq_ptr)].valid &&
+          !rob_is_complete(entry[rob_slot(i, deq_ptr)].uop)) {
         out.rob_bcast->head_incomplete_valid = true;
         out.rob_bcast->head_incomplete_rob_idx = make_rob_idx(deq_ptr, i);
         break;
@@ -206,7 +201,7 @@ void Rob::comb_commit() {
   bool group_commit_mask[ROB_BANK_NUM] = {false};
   bool group_has_head = false;
   for (int i = 0; i < ROB_BANK_NUM; i++) {
-    if (!entry[i][deq_ptr].valid) {
+    if (!entry[rob_slot(i, deq_ptr)].valid) {
       continue;
     }
     if (!group_has_head) {
@@ -234,7 +229,7 @@ void Rob::comb_commit() {
     if (!group_commit_mask[i]) {
       continue;
     }
-    commit = commit && rob_is_complete(entry[i][deq_ptr].uop);
+    commit = commit && rob_is_complete(entry[rob_slot(i, deq_ptr)].uop);
   }
 
   // 出队行如果存在特殊指令，则进行单指令提交 (Single Commit)
@@ -258,9 +253,9 @@ void Rob::comb_commit() {
   if (!in.dec_bcast->mispred) {
     const bool interrupt_pending = in.csr2rob->interrupt_req;
     for (int i = 0; i < ROB_BANK_NUM; i++) {
-      if ((entry[i][deq_ptr].valid &&
-           (rob_is_flush_inst(entry[i][deq_ptr].uop) ||
-            rob_is_fence_inst(entry[i][deq_ptr].uop))) ||
+      if ((entry[rob_slot(i, deq_ptr)].valid &&
+           (rob_is_flush_inst(entry[rob_slot(i, deq_ptr)].uop) ||
+            rob_is_fence_inst(entry[rob_slot(i, deq_ptr)].uop))) ||
           interrupt_pending) {
         single_commit = true;
         break;
@@ -270,10 +265,10 @@ void Rob::comb_commit() {
     // 看第一个 valid 指令是否完成。
     bool has_head_valid = false;
     for (int i = 0; i < ROB_BANK_NUM; i++) {
-      if (entry[i][deq_ptr].valid) {
+      if (entry[rob_slot(i, deq_ptr)].valid) {
         has_head_valid = true;
         single_idx = i;
-        const auto &head_uop = entry[i][deq_ptr].uop;
+        const auto &head_uop = entry[rob_slot(i, deq_ptr)].uop;
         if (!interrupt_pending && !rob_is_complete(head_uop)) {
           single_commit = false;
         }
@@ -302,10 +297,10 @@ void Rob::comb_commit() {
     // still commit/retire and unblock younger loads that are waiting on them.
     if (!commit && !single_commit && !interrupt_pending) {
       for (int i = 0; i < ROB_BANK_NUM; i++) {
-        if (!entry[i][deq_ptr].valid) {
+        if (!entry[rob_slot(i, deq_ptr)].valid) {
           continue;
         }
-        const auto &uop = entry[i][deq_ptr].uop;
+        const auto &uop = entry[rob_slot(i, deq_ptr)].uop;
         const bool ready = rob_is_complete(uop);
         if (ready && !rob_is_flush_inst(uop)) {
           single_commit = true;
@@ -321,15 +316,15 @@ void Rob::comb_commit() {
 
   for (int i = 0; i < ROB_BANK_NUM; i++) {
     out.rob_commit->commit_entry[i].uop =
-        entry[i][deq_ptr].uop.to_commit_inst();
+        entry[rob_slot(i, deq_ptr)].uop.to_commit_inst();
   }
 
   // 一组提交
   if (commit && !single_commit) {
     bool line_drained = true;
     for (int i = 0; i < ROB_BANK_NUM; i++) {
-      if (entry[i][deq_ptr].valid && group_commit_mask[i]) {
-        const auto &uop = entry[i][deq_ptr].uop;
+      if (entry[rob_slot(i, deq_ptr)].valid && group_commit_mask[i]) {
+        const auto &uop = entry[rob_slot(i, deq_ptr)].uop;
         // 仅在 Load 已完成且非异常语义时检查地址对齐，避免中断单提交/异常路径下
         // 将 diag_val 的其他语义（如指令字、异常地址）误当作物理地址检查。
         if (rob_is_load(uop) && rob_is_complete(uop) &&
@@ -340,12 +335,12 @@ void Rob::comb_commit() {
         }
       }
       out.rob_commit->commit_entry[i].valid =
-          entry[i][deq_ptr].valid && group_commit_mask[i];
+          entry[rob_slot(i, deq_ptr)].valid && group_commit_mask[i];
       if (out.rob_commit->commit_entry[i].valid) {
-        log_incomplete_store_commit(entry[i][deq_ptr].uop, "group", i);
-        entry_1[i][deq_ptr].valid = false;
+        log_incomplete_store_commit(entry[rob_slot(i, deq_ptr)].uop, "group", i);
+        entry.write(rob_slot(i, deq_ptr)).valid = false;
       }
-      if (entry_1[i][deq_ptr].valid) {
+      if (entry.next(rob_slot(i, deq_ptr)).valid) {
         line_drained = false;
       }
     }
@@ -372,8 +367,8 @@ void Rob::comb_commit() {
         out.rob_commit->commit_entry[i].valid = false;
     }
 
-    if (entry[single_idx][deq_ptr].valid) {
-      const auto &uop = entry[single_idx][deq_ptr].uop;
+    if (entry[rob_slot(single_idx, deq_ptr)].valid) {
+      const auto &uop = entry[rob_slot(single_idx, deq_ptr)].uop;
       log_incomplete_store_commit(uop, "single", single_idx);
       if (rob_is_load(uop) && rob_is_complete(uop) &&
           !rob_is_page_fault(uop)) {
@@ -383,10 +378,10 @@ void Rob::comb_commit() {
       }
     }
 
-    entry_1[single_idx][deq_ptr].valid = false;
+    entry.write(rob_slot(single_idx, deq_ptr)).valid = false;
     bool line_drained_after_single = true;
     for (int i = 0; i < ROB_BANK_NUM; i++) {
-      if (entry_1[i][deq_ptr].valid) {
+      if (entry.next(rob_slot(i, deq_ptr)).valid) {
         line_drained_after_single = false;
         break;
       }
@@ -403,21 +398,33 @@ void Rob::comb_commit() {
                  "rob_idx=%u pc=0x%08x type=%u\n",
                  (unsigned long long)ctx->perf.cycle, (unsigned)deq_ptr,
                  (unsigned)single_idx,
-                 (unsigned)entry[single_idx][deq_ptr].uop.rob_idx,
-                 entry[single_idx][deq_ptr].uop.dbg.pc,
-                 (unsigned)entry[single_idx][deq_ptr].uop.type);
+                 (unsigned)entry[rob_slot(single_idx, deq_ptr)].uop.rob_idx,
+                 entry[rob_slot(single_idx, deq_ptr)].uop.dbg.pc,
+                 (unsigned)entry[rob_slot(single_idx, deq_ptr)].uop.type);
     }
-    if (rob_is_flush_inst(entry[single_idx][deq_ptr].uop) ||
+    if (rob_is_flush_inst(entry[rob_slot(single_idx, deq_ptr)].uop) ||
         out.rob2csr->interrupt_resp) {
-      const auto &uop = entry[single_idx][deq_ptr].uop;
+      const auto &uop = entry[rob_slot(single_idx, deq_ptr)].uop;
       Assert(in.ftq_pc_resp->resp[0].valid);
       uint32_t single_pc = in.ftq_pc_resp->resp[0].pc;
       out.rob_bcast->flush = true;
       out.rob_bcast->exception =
           rob_is_exception(uop) || out.rob2csr->interrupt_resp;
       out.rob_bcast->pc = single_pc;
-
-      if (out.rob2csr->interrupt_resp) {
+      out.rob_bcast->inst_bytes =
+          uop.fuse_kind != FUSE_NONE ? 8 : (uop.is_rvc ? 2 : 4);
+
+      if (!out.rob2csr->interrupt_resp && uop.fuse_kind != FUSE_NONE &&
+          rob_is_exception(uop)) {
+        // 融合 uop 异常：第一条指令的结果未单独保留，无法精确提交。
+        // 整条不提交，从首条 PC 重取，由 Idu 在该 PC 处禁止融合一次。
+        out.rob_commit->commit_entry[single_idx].valid = false;
+        out.rob_bcast->exception = false;
+        out.rob_bcast->fuse_replay = true;
+#ifdef CONFIG_PERF_COUNTER
+        ctx->perf.fuse_replay_num++;
+#endif
+      } else if (out.rob2csr->interrupt_resp) {
         // interrupt拥有最高优先级
       } else if (decode_inst_type(uop.type) == ECALL) {
         out.rob_bcast->ecall = true;
@@ -434,7 +441,12 @@ void Rob::comb_commit() {
         out.rob_bcast->trap_val = uop.diag_val;
       } else if (uop.page_fault_inst) {
         out.rob_bcast->page_fault_inst = true;
+#ifdef CONFIG_RVC
+        // 跨页 32 位指令的高半部缺页时 tval 为 pc + 2，由取指随指令字带来
+        out.rob_bcast->trap_val = uop.diag_val;
+#else
         out.rob_bcast->trap_val = single_pc;
+#endif
       } else if (uop.illegal_inst) {
         out.rob_bcast->illegal_inst = true;
         out.rob_bcast->trap_val = uop.diag_val;
@@ -480,16 +492,16 @@ void Rob::comb_commit() {
     // 打印Rob出队行指令 看是哪条指令卡死
     cout << "Rob deq inst:" << endl;
     for (int i = 0; i < ROB_BANK_NUM; i++) {
-      if (entry[i][deq_ptr].valid) {
+      if (entry[rob_slot(i, deq_ptr)].valid) {
         printf("0x%08x: 0x%08x cplt_mask:0x%x expect_mask:0x%x rob_idx:%d "
                "is_page_fault: %d inst_idx: %lld type: %d\n",
-               entry[i][deq_ptr].uop.dbg.pc, entry[i][deq_ptr].uop.diag_val,
-               entry[i][deq_ptr].uop.cplt_mask,
-               entry[i][deq_ptr].uop.expect_mask,
+               entry[rob_slot(i, deq_ptr)].uop.dbg.pc, entry[rob_slot(i, deq_ptr)].uop.diag_val,
+               entry[rob_slot(i, deq_ptr)].uop.cplt_mask,
+               entry[rob_slot(i, deq_ptr)].uop.expect_mask,
                (i + (deq_ptr * ROB_BANK_NUM)),
-               rob_is_page_fault(entry[i][deq_ptr].uop),
-               (long long)entry[i][deq_ptr].uop.dbg.inst_idx,
-               decode_inst_type(entry[i][deq_ptr].uop.type));
+               rob_is_page_fault(entry[rob_slot(i, deq_ptr)].uop),
+               (long long)entry[rob_slot(i, deq_ptr)].uop.dbg.inst_idx,
+               decode_inst_type(entry[rob_slot(i, deq_ptr)].uop.type));
       } else {
         printf("[Bank %d] INVALID\n", i);
       }
@@ -508,7 +520,7 @@ void Rob::comb_commit() {
 
 // 功能：接收执行完成回传并更新 ROB 条目的完成位与异常/分支附加信息。
 // 输入依赖：in.exu2rob->entry[]（含 rob_idx、result、diag_val、fault/mispred/flush_pipe 等）。
-// 输出更新：entry_1[bank][line].uop.{cplt_mask,diag_val,page_fault_*,mispred,br_taken,flush_pipe,dbg}。
+// 输出更新：entry[bank][line]（rank1）.uop.{cplt_mask,diag_val,page_fault_*,mispred,br_taken,flush_pipe,dbg}。
 // 约束：完成位不可重复置位、不可越界到 expect_mask 之外；多 uop 同指令回传时 flush_pipe 取 OR。
 void Rob::comb_complete() {
   //  执行完毕的标记 (Early Completion Phase 2)
@@ -520,22 +532,24 @@ void Rob::comb_complete() {
       int bank_idx = get_rob_bank(wb.rob_idx);
       int line_idx = get_rob_line(wb.rob_idx);
 
+      RobStoredInst &uop_1 = entry.write(rob_slot(bank_idx, line_idx)).uop;
+
       const wire<ROB_CPLT_MASK_WIDTH> cplt_bit =
           rob_cplt_mask_from_issue_port(i);
-      if ((entry_1[bank_idx][line_idx].uop.cplt_mask & cplt_bit) != 0) {
+      if ((uop_1.cplt_mask & cplt_bit) != 0) {
         std::fprintf(stderr,
                      "[ROB][DUP-CPLT] cycle=%lld port=%d rob_idx=%u line=%d bank=%d "
                      "wb_pc=0x%08x wb_inst=0x%08x wb_op=%u "
                      "entry_cplt=0x%x expect=0x%x\n",
-                     sim_time, i, static_cast<unsigned>(wb.rob_idx), line_idx,
+                     sim_now(), i, static_cast<unsigned>(wb.rob_idx), line_idx,
                      bank_idx, static_cast<unsigned>(wb.dbg.pc),
                      static_cast<unsigned>(wb.dbg.instruction),
                      static_cast<unsigned>(wb.op),
                      static_cast<unsigned>(
-                         entry_1[bank_idx][line_idx].uop.cplt_mask),
+                         uop_1.cplt_mask),
                      static_cast<unsigned>(
-                         entry_1[bank_idx][line_idx].uop.expect_mask));
-        const auto &euop = entry_1[bank_idx][line_idx].uop;
+                         uop_1.expect_mask));
+        const auto &euop = uop_1;
         std::fprintf(stderr,
                      "[ROB][DUP-CPLT][ENTRY] type=%u func7=0x%02x entry_pc=0x%08x "
                      "entry_inst=0x%08x pf(i/l/s)=%u/%u/%u\n",
@@ -548,27 +562,27 @@ void Rob::comb_complete() {
                      static_cast<unsigned>(euop.page_fault_store));
         Assert(0 && "ROB: duplicate completion bit set");
       }
-      entry_1[bank_idx][line_idx].uop.cplt_mask |= cplt_bit;
-      Assert((entry_1[bank_idx][line_idx].uop.cplt_mask &
-              ~entry_1[bank_idx][line_idx].uop.expect_mask) == 0 &&
+      uop_1.cplt_mask |= cplt_bit;
+      Assert((uop_1.cplt_mask &
+              ~uop_1.expect_mask) == 0 &&
              "ROB: completion bit outside expected mask");
-      Assert(rob_cplt_popcount(entry_1[bank_idx][line_idx].uop.cplt_mask) <=
+      Assert(rob_cplt_popcount(uop_1.cplt_mask) <=
                  rob_cplt_popcount(
-                     entry_1[bank_idx][line_idx].uop.expect_mask) &&
+                     uop_1.expect_mask) &&
              "ROB: completion overflow (completed group count > expected)");
 
       for (int k = 0; k < LSU_LDU_COUNT; k++) {
         if (i == IQ_LD_PORT_BASE + k) {
           // 保存物理地址，用于 Commit 时的对齐检查
-          entry_1[bank_idx][line_idx].uop.diag_val = wb.diag_val;
+          uop_1.diag_val = wb.diag_val;
 
           if (wb_has_page_fault) {
-            entry_1[bank_idx][line_idx].uop.diag_val = wb.result;
-            entry_1[bank_idx][line_idx].uop.page_fault_inst |=
+            uop_1.diag_val = wb.result;
+            uop_1.page_fault_inst |=
                 wb.page_fault_inst;
-            entry_1[bank_idx][line_idx].uop.page_fault_load |=
+            uop_1.page_fault_load |=
                 wb.page_fault_load;
-            entry_1[bank_idx][line_idx].uop.page_fault_store |=
+            uop_1.page_fault_store |=
                 wb.page_fault_store;
           }
         }
@@ -577,17 +591,17 @@ void Rob::comb_complete() {
       for (int k = 0; k < LSU_STA_COUNT; k++) {
         if (i == IQ_STA_PORT_BASE + k) {
           // Keep resolved store address in ROB for commit-time policy checks.
-          entry_1[bank_idx][line_idx].uop.diag_val = wb.diag_val;
+          uop_1.diag_val = wb.diag_val;
           if (wb_has_page_fault) {
-            entry_1[bank_idx][line_idx].uop.diag_val = wb.result;
-            entry_1[bank_idx][line_idx].uop.page_fault_load |=
+            uop_1.diag_val = wb.result;
+            uop_1.page_fault_load |=
                 wb.page_fault_load;
-            entry_1[bank_idx][line_idx].uop.page_fault_store |=
+            uop_1.page_fault_store |=
                 wb.page_fault_store;
-            entry_1[bank_idx][line_idx].uop.page_fault_inst |=
+            uop_1.page_fault_inst |=
                 wb.page_fault_inst;
-            if (entry_1[bank_idx][line_idx].uop.page_fault_store) {
-              entry_1[bank_idx][line_idx].uop.page_fault_load = false;
+            if (uop_1.page_fault_store) {
+              uop_1.page_fault_load = false;
             }
           }
         }
@@ -595,13 +609,13 @@ void Rob::comb_complete() {
 
       // 同一条指令可能由多个 uop 回写（例如 STA/STD），flush_pipe
       // 需要保持置位， 不能被后到达的 uop 覆盖为 0。
-      entry_1[bank_idx][line_idx].uop.flush_pipe =
-          entry_1[bank_idx][line_idx].uop.flush_pipe || wb.flush_pipe;
-      entry_1[bank_idx][line_idx].uop.dbg.difftest_skip = wb.dbg.difftest_skip;
+      uop_1.flush_pipe =
+          uop_1.flush_pipe || wb.flush_pipe;
+      uop_1.dbg.difftest_skip = wb.dbg.difftest_skip;
       if (is_branch_uop(wb.op)) {
-        entry_1[bank_idx][line_idx].uop.diag_val = wb.diag_val;
-        entry_1[bank_idx][line_idx].uop.mispred = wb.mispred;
-        entry_1[bank_idx][line_idx].uop.br_taken = wb.br_taken;
+        uop_1.diag_val = wb.diag_val;
+        uop_1.mispred = wb.mispred;
+        uop_1.br_taken = wb.br_taken;
       }
     }
   }
@@ -609,7 +623,7 @@ void Rob::comb_complete() {
 
 // 功能：处理分支误预测恢复，回退 ROB tail 并失效错误路径条目。
 // 输入依赖：in.dec_bcast->{mispred,redirect_rob_idx}、out.rob_bcast->flush、当前 enq_ptr/enq_flag。
-// 输出更新：enq_ptr_1/enq_flag_1、entry_1[][]（重定向点之后条目 invalid）、redirect 指令 ftq_is_last。
+// 输出更新：enq_ptr_1/enq_flag_1、entry[][]（rank1，重定向点之后条目 invalid）、redirect 指令 ftq_is_last。
 // 约束：仅在 mispred 且本拍无全局 flush 时生效；需覆盖跨行回滚，避免僵尸提交。
 void Rob::comb_branch() {
   // 分支预测失败
@@ -627,7 +641,7 @@ void Rob::comb_branch() {
     // FTQ entry.
     int redirect_bank = get_rob_bank(in.dec_bcast->redirect_rob_idx);
     int redirect_line = get_rob_line(in.dec_bcast->redirect_rob_idx);
-    entry_1[redirect_bank][redirect_line].uop.ftq_is_last = true;
+    entry.write(rob_slot(redirect_bank, redirect_line)).uop.ftq_is_last = true;
 
     // 修正：明确使从重定向点到旧 Tail 的所有条目失效
     // 这可以处理多行回溯并防止“僵尸提交”
@@ -637,7 +651,7 @@ void Rob::comb_branch() {
 
     // 1. 清除第一行（重定向行）的剩余条目
     for (int i = start_bank; i < ROB_BANK_NUM; i++) {
-      entry_1[i][ptr].valid = false;
+      entry.write(rob_slot(i, ptr)).valid = false;
     }
 
     // 2. 清除所有后续行，直到旧的 enq_ptr 行
@@ -651,7 +665,7 @@ void Rob::comb_branch() {
     // 在这里清除整行
     while (ptr != current_tail_line) {
       for (int i = 0; i < ROB_BANK_NUM; i++) {
-        entry_1[i][ptr].valid = false;
+        entry.write(rob_slot(i, ptr)).valid = false;
       }
       ptr = (ptr + 1) % ROB_LINE_NUM;
     }
@@ -660,7 +674,7 @@ void Rob::comb_branch() {
 
 // 功能：接收 Dispatch 发射并向 ROB 入队新条目。
 // 输入依赖：out.rob2dis->ready、in.dis2rob->dis_fire[]、in.dis2rob->uop[]、enq_ptr/enq_flag。
-// 输出更新：entry_1[][enq_ptr]、enq_ptr_1/enq_flag_1。
+// 输出更新：entry[][enq_ptr]（rank1）、enq_ptr_1/enq_flag_1。
 // 约束：仅在 ROB ready 时接收入队；有任意槽位入队即推进 tail 一行。
 void Rob::comb_fire() {
   // 入队
@@ -668,10 +682,10 @@ void Rob::comb_fire() {
   if (out.rob2dis->ready) {
     for (int i = 0; i < DECODE_WIDTH; i++) {
       if (in.dis2rob->dis_fire[i]) {
-        entry_1[i][enq_ptr].valid = true;
-        entry_1[i][enq_ptr].uop =
-            RobStoredInst::from_dis_rob_inst(in.dis2rob->uop[i]);
-        entry_1[i][enq_ptr].uop.cplt_mask = 0;
+        RobStoredEntry &slot = entry.write(rob_slot(i, enq_ptr));
+        slot.valid = true;
+        slot.uop = RobStoredInst::from_dis_rob_inst(in.dis2rob->uop[i]);
+        slot.uop.cplt_mask = 0;
         enq = true;
       }
     }
@@ -687,13 +701,15 @@ void Rob::comb_fire() {
 
 // 功能：在全局 flush 时清空 ROB 并复位头尾指针。
 // 输入依赖：out.rob_bcast->flush。
-// 输出更新：entry_1[][].valid、enq_ptr_1/deq_ptr_1、enq_flag_1/deq_flag_1。
+// 输出更新：entry[].valid（rank1）、enq_ptr_1/deq_ptr_1、enq_flag_1/deq_flag_1。
 // 约束：flush 为最终状态覆盖，生效后 ROB 进入空队列初始态。
 void Rob::comb_flush() {
   if (out.rob_bcast->flush) {
     for (int i = 0; i < ROB_BANK_NUM; i++) {
       for (int j = 0; j < ROB_LINE_NUM; j++) {
-        entry_1[i][j].valid = false;
+        if (entry.next(rob_slot(i, j)).valid) {
+          entry.write(rob_slot(i, j)).valid = false;
+        }
       }
     }
 
@@ -705,11 +721,7 @@ void Rob::comb_flush() {
 }
 
 void Rob::seq() {
-  for (int i = 0; i < ROB_BANK_NUM; i++) {
-    for (int j = 0; j < ROB_LINE_NUM; j++) {
-      entry[i][j] = entry_1[i][j];
-    }
-  }
+  entry.seq();
 
   deq_ptr = deq_ptr_1;
   enq_ptr = enq_ptr_1;
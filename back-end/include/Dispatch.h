@@ -62,6 +62,9 @@ private:
       dst.mispred = mispred;
       dst.br_taken = br_taken;
       dst.dest_en = dest_en;
+      dst.move_elim = move_elim;
+      dst.fuse_kind = fuse_kind;
+      dst.is_rvc = is_rvc;
       dst.is_atomic = is_atomic;
       dst.func3 = func3;
       dst.func7 = func7;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+// DualRankArray：带写日志的双 rank 寄存器阵列。
+//
+// - rank0（operator[]）：当前拍寄存器态，comb 阶段只读。
+// - rank1（next/write/set）：本拍组合逻辑累积的下一拍工作副本（原 `*_1`）。
+//
+// 约束：comb 阶段之外两个 rank 恒相等，因此 comb_begin 不再需要整表镜像；
+// comb 阶段对 rank1 的写入必须经 write()/set() 记录槽位，seq() 只把被写过的
+// 槽位从 rank1 提交到 rank0。每拍主机开销与“本拍改动的条目数”成正比，而不是
+// 与阵列深度成正比，周期行为与整表 `*_1 <- *` / `* <- *_1` 拷贝完全一致。
+template <typename T, int N> class DualRankArray {
+public:
+  static constexpr int kSize = N;
+
+  // 读当前态（rank0）。
+  const T &operator[](int idx) const { return cur_[idx]; }
+
+  // 读下一拍工作副本（rank1），不进入写日志。
+  const T &next(int idx) const { return nxt_[idx]; }
+
+  // 取 rank1 可写引用并记录该槽位；字段级修改走这里。
+  T &write(int idx) {
+    mark(idx);
+    return nxt_[idx];
+  }
+
+  void set(int idx, const T &value) {
+    mark(idx);
+    nxt_[idx] = value;
+  }
+
+  // 同时覆盖两个 rank（复位/快照恢复用），不进入写日志。
+  void force(int idx, const T &value) {
+    cur_[idx] = value;
+    nxt_[idx] = value;
+  }
+
+  void reset(const T &value) {
+    for (int i = 0; i < N; i++) {
+      force(i, value);
+      dirty_[i] = 0;
+    }
+    dirty_count_ = 0;
+  }
+
+  // 时序提交：仅回写本拍被写过的槽位，并清空写日志。
+  void seq() {
+    for (int i = 0; i < dirty_count_; i++) {
+      const int idx = dirty_list_[i];
+      cur_[idx] = nxt_[idx];
+      dirty_[idx] = 0;
+    }
+    dirty_count_ = 0;
+  }
+
+  int pending_writes() const { return dirty_count_; }
+
+private:
+  void mark(int idx) {
+    if (!dirty_[idx]) {
+      dirty_[idx] = 1;
+      dirty_list_[dirty_count_++] = idx;
+    }
+  }
+
+  T cur_[N];
+  T nxt_[N];
+  uint8_t dirty_[N] = {};
+  int dirty_list_[N] = {};
+  int dirty_count_ = 0;
+};
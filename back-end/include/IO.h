@@ -40,6 +40,11 @@ struct DecRenIO {
     wire<1> page_fault_inst;
     wire<1> illegal_inst;
 
+    wire<SSIT_IDX_WIDTH> ssit_idx; // 访存指令的 SSIT 索引（由取指 PC 哈希）
+    wire<L1D_PF_PC_HASH_WIDTH> pf_pc_hash; // load 的 PC 哈希，供 L1D stride 预取训练
+    wire<FUSE_KIND_WIDTH> fuse_kind; // Idu 宏融合的指令对，FUSE_NONE 为普通指令
+    wire<1> is_rvc; // 16 位压缩指令（已按 32 位展开），顺序 PC 为 pc + 2
+
     TmaMeta tma;
     DebugMeta dbg;
 
@@ -87,7 +92,7 @@ struct RenDecIO {
 
 // IDU -> PreIduQueue consume handshake (only what PreIduQueue needs).
 struct IduConsumeIO {
-  wire<1> fire[DECODE_WIDTH];
+  wire<1> fire[IDU_PEEK_WIDTH];
   IduConsumeIO() {
     for (auto &v : fire)
       v = {};
@@ -264,7 +269,7 @@ struct FtqRobPcRespIO {
 };
 
 struct PreIssueIO {
-  InstructionBufferEntry entries[DECODE_WIDTH];
+  InstructionBufferEntry entries[IDU_PEEK_WIDTH];
 
   PreIssueIO() {
     for (auto &e : entries) {
@@ -291,6 +296,9 @@ struct RobCommitIO {
     wire<1> br_taken;
 
     wire<1> dest_en;
+    wire<1> move_elim; // Ren 消除的搬移/清零：dest_preg 与其它 areg 共享
+    wire<FUSE_KIND_WIDTH> fuse_kind;
+    wire<1> is_rvc;
     wire<7> func7;
     wire<ROB_IDX_WIDTH> rob_idx;
     wire<1> rob_flag;
@@ -335,6 +343,8 @@ struct RobCommitIO {
       dst.uop.tma = tma;
       dst.uop.dbg = dbg;
       dst.uop.flush_pipe = flush_pipe;
+      dst.uop.fuse_kind = fuse_kind;
+      dst.uop.is_rvc = is_rvc;
       return dst;
     }
   };
@@ -417,6 +427,9 @@ struct DisRobIO {
 
     wire<INST_TYPE_WIDTH> type;
     wire<1> dest_en;
+    wire<1> move_elim;
+    wire<FUSE_KIND_WIDTH> fuse_kind;
+    wire<1> is_rvc;
     wire<1> is_atomic;
     wire<3> func3;
     wire<7> func7;
@@ -502,6 +515,7 @@ struct RenDisIO {
     wire<1> src2_busy;
     wire<1> src1_is_pc;
     wire<1> src2_is_imm;
+    wire<1> move_elim; // Ren 已消除：dest_preg 复用源 preg（或 preg 0），不进 IQ
     wire<3> func3;
     wire<7> func7;
     wire<32> imm;
@@ -515,6 +529,11 @@ struct RenDisIO {
     wire<1> page_fault_inst;
     wire<1> illegal_inst;
 
+    wire<SSIT_IDX_WIDTH> ssit_idx;
+    wire<L1D_PF_PC_HASH_WIDTH> pf_pc_hash;
+    wire<FUSE_KIND_WIDTH> fuse_kind;
+    wire<1> is_rvc;
+
     TmaMeta tma;
     DebugMeta dbg;
 
@@ -545,6 +564,10 @@ struct RenDisIO {
       dst.cplt_mask = src.cplt_mask;
       dst.page_fault_inst = src.page_fault_inst;
       dst.illegal_inst = src.illegal_inst;
+      dst.ssit_idx = src.ssit_idx;
+      dst.pf_pc_hash = src.pf_pc_hash;
+      dst.fuse_kind = src.fuse_kind;
+      dst.is_rvc = src.is_rvc;
       dst.type = src.type;
       dst.tma = src.tma;
       dst.dbg = src.dbg;
@@ -611,6 +634,7 @@ struct DisIssIO {
     wire<FTQ_IDX_WIDTH> ftq_idx;
     wire<FTQ_OFFSET_WIDTH> ftq_offset;
     wire<1> is_atomic;
+    wire<1> is_rvc;
 
     wire<1> dest_en;
     wire<1> src1_en;
@@ -688,6 +712,8 @@ struct RobBroadcastIO {
   wire<1> interrupt;
   wire<32> trap_val;
   wire<32> pc;
+  wire<4> inst_bytes;  // 提交指令的字节数，非异常 flush 从 pc + inst_bytes 重取
+  wire<1> fuse_replay; // 宏融合 uop 异常：不提交，从 pc 拆开重取
 
   wire<ROB_IDX_WIDTH> head_rob_idx;
   wire<1> head_valid;
@@ -709,6 +735,8 @@ struct RobBroadcastIO {
     interrupt = {};
     trap_val = {};
     pc = {};
+    inst_bytes = {};
+    fuse_replay = {};
 
     head_rob_idx = {};
     head_valid = {};
@@ -726,6 +754,7 @@ struct IssPrfIO {
     wire<FTQ_IDX_WIDTH> ftq_idx;
     wire<FTQ_OFFSET_WIDTH> ftq_offset;
     wire<1> is_atomic;
+    wire<1> is_rvc;
     wire<1> dest_en;
     wire<1> src1_en;
     wire<1> src2_en;
@@ -778,6 +807,7 @@ struct PrfExeIO {
     wire<FTQ_IDX_WIDTH> ftq_idx;
     wire<FTQ_OFFSET_WIDTH> ftq_offset;
     wire<1> is_atomic;
+    wire<1> is_rvc;
     wire<1> dest_en;
     wire<1> src1_en;
     wire<1> src2_en;
@@ -809,6 +839,7 @@ struct PrfExeIO {
       dst.ftq_idx = src.ftq_idx;
       dst.ftq_offset = src.ftq_offset;
       dst.is_atomic = src.is_atomic;
+      dst.is_rvc = src.is_rvc;
       dst.dest_en = src.dest_en;
       dst.src1_en = src.src1_en;
       dst.src2_en = src.src2_en;
@@ -1211,12 +1242,21 @@ struct StqEntry {
   wire<ROB_IDX_WIDTH> rob_idx = 0;
   wire<1> rob_flag = 0;
   wire<1> stq_flag = 0;
+
+  // store-set：分配时的 SSIT 索引与同 set 上一条 store（LFST 旧值）
+  wire<SSIT_IDX_WIDTH> ssit_idx = 0;
+  wire<1> ss_pred_valid = false;
+  wire<STQ_IDX_WIDTH> ss_pred_idx = 0;
+  wire<1> ss_pred_flag = false;
+  wire<1> mem_violation = false; // 地址解析时发现 younger load 已越过本 store 读到旧值
 };
 
 struct LoadReq {
   wire<1> valid;
   wire<32> addr;
   wire<32> req_id;
+  wire<L1D_PF_PC_HASH_WIDTH> pc_hash; // load PC 哈希，供 L1D stride 预取训练
+  wire<1> is_prefetch;          // L1D 预取器注入的 tag 探测，不回应 LSU
 };
 
 struct StoreReq {
@@ -1416,12 +1456,15 @@ struct DisLsuIO {
   wire<ROB_IDX_WIDTH> rob_idx[MAX_STQ_DISPATCH_WIDTH];
   wire<1> rob_flag[MAX_STQ_DISPATCH_WIDTH];
   wire<1> stq_flag[MAX_STQ_DISPATCH_WIDTH];
+  wire<SSIT_IDX_WIDTH> ssit_idx[MAX_STQ_DISPATCH_WIDTH];
 
   wire<1> ldq_alloc_req[MAX_LDQ_DISPATCH_WIDTH];
   wire<LDQ_IDX_WIDTH> ldq_idx[MAX_LDQ_DISPATCH_WIDTH];
   wire<BR_MASK_WIDTH> ldq_br_mask[MAX_LDQ_DISPATCH_WIDTH];
   wire<ROB_IDX_WIDTH> ldq_rob_idx[MAX_LDQ_DISPATCH_WIDTH];
   wire<1> ldq_rob_flag[MAX_LDQ_DISPATCH_WIDTH];
+  wire<SSIT_IDX_WIDTH> ldq_ssit_idx[MAX_LDQ_DISPATCH_WIDTH];
+  wire<L1D_PF_PC_HASH_WIDTH> ldq_pf_pc_hash[MAX_LDQ_DISPATCH_WIDTH];
 
   DisLsuIO() {
     for (auto &v : alloc_req)
@@ -1436,6 +1479,8 @@ struct DisLsuIO {
       v = 0;
     for (auto &v : stq_flag)
       v = 0;
+    for (auto &v : ssit_idx)
+      v = 0;
     for (auto &v : ldq_alloc_req)
       v = 0;
     for (auto &v : ldq_idx)
@@ -1446,6 +1491,10 @@ struct DisLsuIO {
       v = 0;
     for (auto &v : ldq_rob_flag)
       v = 0;
+    for (auto &v : ldq_ssit_idx)
+      v = 0;
+    for (auto &v : ldq_pf_pc_hash)
+      v = 0;
   }
 };
 
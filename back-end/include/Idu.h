@@ -1,4 +1,5 @@
 #pragma once
+#include "DecodeMemo.h"
 #include "IO.h"
 #include "PreIduQueue.h"
 #include "config.h"
@@ -27,7 +28,19 @@ public:
   int max_br_per_cycle;
   IduIn in;
   IduOut out;
+  // 经指令字备忘表译码；decode_uncached 为完整的 opcode/funct 译码
   void decode(DecRenIO::DecRenInst &uop, uint32_t inst);
+  void decode_uncached(DecRenIO::DecRenInst &uop, uint32_t inst);
+  // 32 位指令字译码；decode_uncached 先把压缩指令展开再交给它
+  void decode_rv32(DecRenIO::DecRenInst &uop, uint32_t inst);
+  // decode 外加取指缺页、PC/FTQ/SSIT 字段
+  void decode_slot(DecRenIO::DecRenInst &uop,
+                   const InstructionBufferEntry &entry);
+  // 从 in.issue->entries 译码最多 DECODE_WIDTH 个槽位（含宏融合压缩）
+  void decode_group();
+  // 相邻两条可融合时把 a 改写为融合 uop 并返回 true
+  bool try_fuse(DecRenIO::DecRenInst &a, const DecRenIO::DecRenInst &b,
+                uint32_t inst_a, uint32_t inst_b);
 
   void init();
   void comb_begin(); // 默认保持寄存器状态（*_1 <- *）
@@ -42,6 +55,9 @@ public:
   reg<BR_MASK_WIDTH> pending_free_mask; // 延迟一拍释放，避免同拍复用 br_id
   reg<1> tag_vec[MAX_BR_NUM];
   ExuIdIO br_latch;
+  // 融合 uop 异常后按首条 PC 重取，该 PC 处禁止融合一次
+  reg<1> fuse_inhibit_valid;
+  reg<32> fuse_inhibit_pc;
 
   // 下一周期状态
   wire<BR_MASK_WIDTH> now_br_mask_1;
@@ -49,4 +65,18 @@ public:
   wire<BR_MASK_WIDTH> pending_free_mask_1;
   wire<1> tag_vec_1[MAX_BR_NUM];
   ExuIdIO br_latch_1;
+  wire<1> fuse_inhibit_valid_1;
+  wire<32> fuse_inhibit_pc_1;
+
+  // 本拍各 IBuf 项对应的 dec2ren 槽位（-1 表示未译码）；融合对两项同槽
+  int entry_slot[IDU_PEEK_WIDTH];
+#ifdef CONFIG_BPU
+  wire<BR_TAG_WIDTH> alloc_tag[DECODE_WIDTH]; // 分配的新 Tag
+#endif
+
+  // 调试用的译码序号（每次译码都推进）
+  uint64_t global_inst_idx = 0;
+
+  // 译码结果只依赖指令字，按指令字缓存模板（仅加速仿真）
+  DecodeMemo<DecRenIO::DecRenInst, 12> decode_memo;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "DualRankArray.h"
 #include "config.h"
 #include <cstdint>
 
@@ -23,9 +24,14 @@ struct InstructionBufferEntry {
   }
 };
 
+// 环形指令缓冲。查询接口（count/peek 等）读当前态，修改接口
+// （pop_front/push_back/clear）只作用于下一拍副本，由 seq() 提交。
 class InstructionBuffer {
 public:
   void init();
+  void comb_begin(); // 默认保持指针寄存器状态（*_1 <- *）
+  void seq();
+
   int count() const { return count_r; }
   int free_slots() const { return IDU_INST_BUFFER_SIZE - count_r; }
   bool can_accept(int incoming_num) const {
@@ -38,8 +44,12 @@ public:
   void clear();
 
 private:
-  InstructionBufferEntry entries[IDU_INST_BUFFER_SIZE];
-  int head_r = 0;
-  int tail_r = 0;
-  int count_r = 0;
+  DualRankArray<InstructionBufferEntry, IDU_INST_BUFFER_SIZE> entries;
+  reg<clog2(IDU_INST_BUFFER_SIZE)> head_r = 0;
+  reg<clog2(IDU_INST_BUFFER_SIZE)> tail_r = 0;
+  reg<bit_width_for_count(IDU_INST_BUFFER_SIZE + 1)> count_r = 0;
+
+  wire<clog2(IDU_INST_BUFFER_SIZE)> head_1 = 0;
+  wire<clog2(IDU_INST_BUFFER_SIZE)> tail_1 = 0;
+  wire<bit_width_for_count(IDU_INST_BUFFER_SIZE + 1)> count_1 = 0;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "config.h"
+#include "DualRankArray.h"
 #include "IO.h"
 #include "util.h"
 #include <algorithm>
@@ -35,6 +36,7 @@ struct IqStoredUop {
   wire<FTQ_IDX_WIDTH> ftq_idx;
   wire<FTQ_OFFSET_WIDTH> ftq_offset;
   wire<1> is_atomic;
+  wire<1> is_rvc;
   wire<1> dest_en;
   wire<1> src1_en;
   wire<1> src2_en;
@@ -68,6 +70,7 @@ struct IqStoredUop {
     dst.ftq_idx = src.ftq_idx;
     dst.ftq_offset = src.ftq_offset;
     dst.is_atomic = src.is_atomic;
+    dst.is_rvc = src.is_rvc;
     dst.dest_en = src.dest_en;
     dst.src1_en = src.src1_en;
     dst.src2_en = src.src2_en;
@@ -99,6 +102,7 @@ struct IqStoredUop {
     dst.ftq_idx = ftq_idx;
     dst.ftq_offset = ftq_offset;
     dst.is_atomic = is_atomic;
+    dst.is_rvc = is_rvc;
     dst.dest_en = dest_en;
     dst.src1_en = src1_en;
     dst.src2_en = src2_en;
@@ -146,34 +150,58 @@ struct IssueQueueOut {
 // ==========================================
 // 2. IssueQueue (纯逻辑，不含IO)
 // ==========================================
+//
+// 状态组织（按槽位的 64-bit 位图，kIqMaskWords 个字覆盖 MAX_IQ_SIZE 个槽位）：
+// - payload：条目负载，双 rank（[] 当前态供发射读取，next()/write() 为下一拍）。
+// - ready_mask/ready_mask_1：valid 且两个源操作数都不再等待的槽位。
+// - valid_mask、src{1,2}_wait_mask：下一拍占用与等待状态。
+// - wake_matrix_src{1,2}：[preg] -> 等待该 preg 的槽位位图。
+// - port_cap_mask：[port] -> 操作码可由该端口执行的槽位位图。
+// - age_matrix：[slot] -> 比该槽位更老的槽位位图（仅 ROB_OLDEST_FIRST）。
+//
+// 组合阶段只有调度读取当前态（ready_mask/payload/port_cap_mask/age_matrix）。
+// valid/wait/唤醒矩阵从不被调度读取；port_cap_mask/age_matrix 只在入队时改写
+// 新槽位的行/列，而新槽位在本拍调度中不可能是候选（本拍前即空闲，或已在
+// 本拍 comb_issue 后释放），因此这些状态均无需 *_1 副本。唤醒只改写被唤醒
+// preg 对应的矩阵行。调度结果与原先按槽位顺序/按 ROB 年龄排序后的逐端口
+// 选择完全一致。
 class IssueQueue {
 public:
   IssueQueueIn in;
   IssueQueueOut out;
 
 private:
+  static constexpr int kIqMaskWords = (MAX_IQ_SIZE + 63) / 64;
+
   int size;
   int dispatch_width;
   std::vector<PortBinding> ports;
   int wake_words_per_row;
 
-  std::vector<IqStoredEntry> entry;
-  std::vector<IqStoredEntry> entry_1;
+  DualRankArray<IqStoredUop, MAX_IQ_SIZE> payload;
   int count, count_1;
 
+  uint64_t ready_mask[kIqMaskWords] = {};
+  uint64_t ready_mask_1[kIqMaskWords] = {};
+  uint64_t valid_mask[kIqMaskWords] = {};
+  uint64_t src1_wait_mask[kIqMaskWords] = {};
+  uint64_t src2_wait_mask[kIqMaskWords] = {};
+  uint64_t port_cap_mask[ISSUE_WIDTH][kIqMaskWords] = {};
+
   // Wakeup Matrix: [Physical Register] -> Bitmask of IQ slots
   std::vector<uint64_t> wake_matrix_src1;
   std::vector<uint64_t> wake_matrix_src2;
-  std::vector<uint64_t> wake_matrix_src1_1;
-  std::vector<uint64_t> wake_matrix_src2_1;
+  // Age Matrix: [IQ slot] -> Bitmask of older IQ slots
+  std::vector<uint64_t> age_matrix;
 
 
 public:
   IssueQueue(const IssueQueueConfig &cfg)
       : size(cfg.size), dispatch_width(cfg.dispatch_width), // <--- 初始化
         ports(cfg.ports) {
-    entry.resize(size);
-    entry_1.resize(size);
+    Assert(size <= MAX_IQ_SIZE && "IQ size exceeds MAX_IQ_SIZE");
+    Assert(static_cast<int>(ports.size()) <= ISSUE_WIDTH);
+    payload.reset(IqStoredUop());
     count = 0;
     count_1 = 0;
     wake_words_per_row = (size + 63) / 64;
@@ -182,17 +210,18 @@ public:
     // [preg][word_idx], where each word tracks 64 IQ slots.
     wake_matrix_src1.resize(PRF_NUM * wake_words_per_row, 0);
     wake_matrix_src2.resize(PRF_NUM * wake_words_per_row, 0);
-    wake_matrix_src1_1.resize(PRF_NUM * wake_words_per_row, 0);
-    wake_matrix_src2_1.resize(PRF_NUM * wake_words_per_row, 0);
+    if (ISSUE_SCHEDULE_POLICY == IssueSchedulePolicy::ROB_OLDEST_FIRST) {
+      age_matrix.resize(static_cast<size_t>(size) * wake_words_per_row, 0);
+    }
 
     in.enq_reqs.resize(dispatch_width);
   }
 
   void comb_begin() {
-    entry_1 = entry;
     count_1 = count;
-    wake_matrix_src1_1 = wake_matrix_src1;
-    wake_matrix_src2_1 = wake_matrix_src2;
+    for (int w = 0; w < wake_words_per_row; w++) {
+      ready_mask_1[w] = ready_mask[w];
+    }
     out.free_slots = size - count;
     for (auto &grant : out.issue_grants) {
       grant = {};
@@ -236,30 +265,19 @@ public:
       }
       size_t row_base = matrix_row_base(preg);
 
+      // 矩阵行中的位恒满足 valid && srcX_en && srcX_busy && srcX_preg==preg，
+      // 整字清等待位后重算 ready 即可，无需逐槽位检查。
       for (int w = 0; w < wake_words_per_row; w++) {
-        uint64_t mask1 = wake_matrix_src1_1[row_base + w];
-        while (mask1) {
-          int bit = __builtin_ctzll(mask1);
-          int idx = (w << 6) + bit;
-          if (idx < size && entry_1[idx].valid && entry_1[idx].uop.src1_en &&
-              entry_1[idx].uop.src1_busy && entry_1[idx].uop.src1_preg == preg) {
-            entry_1[idx].uop.src1_busy = false;
-          }
-          mask1 &= (mask1 - 1);
-        }
-        wake_matrix_src1_1[row_base + w] = 0;
-
-        uint64_t mask2 = wake_matrix_src2_1[row_base + w];
-        while (mask2) {
-          int bit = __builtin_ctzll(mask2);
-          int idx = (w << 6) + bit;
-          if (idx < size && entry_1[idx].valid && entry_1[idx].uop.src2_en &&
-              entry_1[idx].uop.src2_busy && entry_1[idx].uop.src2_preg == preg) {
-            entry_1[idx].uop.src2_busy = false;
-          }
-          mask2 &= (mask2 - 1);
+        uint64_t mask1 = wake_matrix_src1[row_base + w];
+        uint64_t mask2 = wake_matrix_src2[row_base + w];
+        if ((mask1 | mask2) == 0) {
+          continue;
         }
-        wake_matrix_src2_1[row_base + w] = 0;
+        src1_wait_mask[w] &= ~mask1;
+        src2_wait_mask[w] &= ~mask2;
+        wake_matrix_src1[row_base + w] = 0;
+        wake_matrix_src2[row_base + w] = 0;
+        refresh_ready_word(w);
       }
     }
   }
@@ -268,23 +286,23 @@ public:
     for (auto &grant : out.issue_grants) {
       grant = {};
     }
-    std::vector<std::pair<int, int>> scheduled_pairs = schedule();
-    std::vector<int> committed_indices;
-    committed_indices.reserve(scheduled_pairs.size());
-
-    for (const auto &pair : scheduled_pairs) {
-      int entry_idx = pair.first;
-      int phys_port = pair.second;
-      uint64_t req_bit = (1ULL << static_cast<uint32_t>(entry[entry_idx].uop.op));
+    int sched_slot[ISSUE_WIDTH];
+    int sched_port[ISSUE_WIDTH];
+    int sched_num = schedule(sched_slot, sched_port);
+
+    for (int i = 0; i < sched_num; i++) {
+      int entry_idx = sched_slot[i];
+      int phys_port = sched_port[i];
+      const IqStoredUop &uop = payload[entry_idx];
+      uint64_t req_bit = (1ULL << static_cast<uint32_t>(uop.op));
       if ((in.port_fu_ready_mask[phys_port] & req_bit) &&
           !in.issue_block) {
         out.issue_grants[phys_port].valid = true;
-        out.issue_grants[phys_port].uop = entry[entry_idx].uop;
-        committed_indices.push_back(entry_idx);
+        out.issue_grants[phys_port].uop = uop;
+        commit_issue(entry_idx);
       }
     }
 
-    commit_issue(committed_indices);
     out.free_slots = size - count_1;
   }
 
@@ -305,30 +323,52 @@ private:
   int enqueue(const IqStoredEntry &inst) {
     if (count_1 >= size)
       return 0;
-    for (int i = 0; i < size; i++) {
-      if (!entry_1[i].valid) {
-        entry_1[i] = inst;
-        entry_1[i].valid = true;
-        set_dep_bits_for_slot(entry_1[i], i);
-
-        count_1++;
-        return 1;
+    for (int w = 0; w < wake_words_per_row; w++) {
+      uint64_t free_bits = ~valid_mask[w];
+      if (free_bits == 0) {
+        continue;
+      }
+      int i = (w << 6) + __builtin_ctzll(free_bits);
+      if (i >= size) {
+        return 0;
+      }
+      int word = slot_word(i);
+      uint64_t bit = slot_bit(i);
+      payload.set(i, inst.uop);
+      valid_mask[word] |= bit;
+      set_bit_if(src1_wait_mask[word], bit,
+                 inst.uop.src1_en && inst.uop.src1_busy);
+      set_bit_if(src2_wait_mask[word], bit,
+                 inst.uop.src2_en && inst.uop.src2_busy);
+      refresh_ready_word(word);
+      set_dep_bits_for_slot(inst.uop, i);
+
+      uint64_t op_bit = (1ULL << static_cast<uint32_t>(inst.uop.op));
+      for (size_t p = 0; p < ports.size(); p++) {
+        set_bit_if(port_cap_mask[p][word], bit,
+                   (ports[p].capability_mask & op_bit) != 0);
       }
+      if (ISSUE_SCHEDULE_POLICY == IssueSchedulePolicy::ROB_OLDEST_FIRST) {
+        update_age_for_slot(i);
+      }
+
+      count_1++;
+      return 1;
     }
     return 0;
   }
 
   // Flush
   void flush_br(wire<BR_MASK_WIDTH> br_mask) {
-    for (int i = 0; i < size; i++) {
-      if (!entry_1[i].valid) {
-        continue;
-      }
-      bool match_mask = (entry_1[i].uop.br_mask & br_mask) != 0;
-      if (match_mask) {
-        clear_dep_bits_for_slot(entry_1[i], i);
-        entry_1[i].valid = false;
-        count_1--;
+    for (int w = 0; w < wake_words_per_row; w++) {
+      uint64_t live = valid_mask[w];
+      while (live) {
+        int i = (w << 6) + __builtin_ctzll(live);
+        live &= (live - 1);
+        const IqStoredUop &uop = payload.next(i);
+        if ((uop.br_mask & br_mask) != 0) {
+          release_slot(i);
+        }
       }
     }
   }
@@ -336,111 +376,171 @@ private:
   // Clear resolved branch bits from surviving entries
   void clear_br(wire<BR_MASK_WIDTH> clear_mask) {
     if (clear_mask == 0) return;
-    for (int i = 0; i < size; i++) {
-      if (entry_1[i].valid) {
-        entry_1[i].uop.br_mask &= ~clear_mask;
+    for (int w = 0; w < wake_words_per_row; w++) {
+      uint64_t live = valid_mask[w];
+      while (live) {
+        int i = (w << 6) + __builtin_ctzll(live);
+        live &= (live - 1);
+        if ((payload.next(i).br_mask & clear_mask) != 0) {
+          payload.write(i).br_mask &= ~clear_mask;
+        }
       }
     }
   }
 
   void flush_all() {
-    for (auto &e : entry_1)
-      e.valid = false;
+    for (int w = 0; w < wake_words_per_row; w++) {
+      valid_mask[w] = 0;
+      ready_mask_1[w] = 0;
+      src1_wait_mask[w] = 0;
+      src2_wait_mask[w] = 0;
+    }
     count_1 = 0;
-    
+
     // Clear Wakeup Matrices
-    std::fill(wake_matrix_src1_1.begin(), wake_matrix_src1_1.end(), 0);
-    std::fill(wake_matrix_src2_1.begin(), wake_matrix_src2_1.end(), 0);
+    std::fill(wake_matrix_src1.begin(), wake_matrix_src1.end(), 0);
+    std::fill(wake_matrix_src2.begin(), wake_matrix_src2.end(), 0);
   }
 
   // 提交调度结果 (将选中的指令移出队列)
-  void commit_issue(const std::vector<int> &indices) {
-    for (int idx : indices) {
-      if (entry_1[idx].valid) {
-        clear_dep_bits_for_slot(entry_1[idx], idx);
-        entry_1[idx].valid = false;
-        count_1--;
-      }
+  void commit_issue(int idx) {
+    if (valid_mask[slot_word(idx)] & slot_bit(idx)) {
+      release_slot(idx);
     }
   }
 
+  void release_slot(int idx) {
+    int word = slot_word(idx);
+    uint64_t clear_mask = ~slot_bit(idx);
+    clear_dep_bits_for_slot(payload.next(idx), idx);
+    valid_mask[word] &= clear_mask;
+    ready_mask_1[word] &= clear_mask;
+    src1_wait_mask[word] &= clear_mask;
+    src2_wait_mask[word] &= clear_mask;
+    count_1--;
+  }
+
 public:
   void seq() {
-    entry = entry_1;
+    payload.seq();
     count = count_1;
-    wake_matrix_src1 = wake_matrix_src1_1;
-    wake_matrix_src2 = wake_matrix_src2_1;
+    for (int w = 0; w < wake_words_per_row; w++) {
+      ready_mask[w] = ready_mask_1[w];
+    }
   }
 
 private:
-  std::vector<std::pair<int, int>> schedule() {
-    std::vector<std::pair<int, int>> result;
+  // 逐端口选择：端口按配置顺序依次从 ready 且能力匹配、尚未被选中的槽位中取
+  // 最高优先级者（IQ_SLOT_PRIORITY：最低槽位；ROB_OLDEST_FIRST：最老）。
+  int schedule(int *sched_slot, int *sched_port) const {
     int num_ports = ports.size();
+    int sched_num = 0;
+    uint64_t remain[kIqMaskWords];
+    for (int w = 0; w < wake_words_per_row; w++) {
+      remain[w] = ready_mask[w];
+    }
 
-
-    // 1. Gather all ready instructions
-    std::vector<int> ready_indices;
-    ready_indices.reserve(count);
-    int seen_valid = 0;
-    for (int i = 0; i < size; i++) {
-      if (!entry[i].valid) {
-        continue;
+    for (int p = 0; p < num_ports; p++) {
+      uint64_t cand[kIqMaskWords];
+      bool any = false;
+      for (int w = 0; w < wake_words_per_row; w++) {
+        cand[w] = remain[w] & port_cap_mask[p][w];
+        any = any || cand[w] != 0;
       }
-      seen_valid++;
-      if (is_ready(entry[i])) {
-        ready_indices.push_back(i);
+      if (!any) {
+        continue;
       }
-      if (seen_valid >= count) {
-        break;
+      int idx = (ISSUE_SCHEDULE_POLICY == IssueSchedulePolicy::ROB_OLDEST_FIRST)
+                    ? pick_oldest(cand)
+                    : pick_lowest(cand);
+      sched_slot[sched_num] = idx;
+      sched_port[sched_num] = ports[p].port_idx;
+      sched_num++;
+      remain[slot_word(idx)] &= ~slot_bit(idx);
+    }
+
+    return sched_num;
+  }
+
+  int pick_lowest(const uint64_t *cand) const {
+    for (int w = 0; w < wake_words_per_row; w++) {
+      if (cand[w]) {
+        return (w << 6) + __builtin_ctzll(cand[w]);
       }
     }
+    return -1;
+  }
 
-    // 2. Sort ready instructions by priority
-    if (ISSUE_SCHEDULE_POLICY == IssueSchedulePolicy::ROB_OLDEST_FIRST) {
-      auto older_than = [&](int lhs, int rhs) {
-        const auto &a = entry[lhs].uop;
-        const auto &b = entry[rhs].uop;
-        if (a.rob_flag == b.rob_flag) {
-          if (a.rob_idx != b.rob_idx) {
-            return a.rob_idx < b.rob_idx;
-          }
-        } else {
-          if (a.rob_idx != b.rob_idx) {
-            return a.rob_idx > b.rob_idx;
-          }
+  // 候选集中不存在比它更老的槽位者即为最老条目。
+  int pick_oldest(const uint64_t *cand) const {
+    for (int w = 0; w < wake_words_per_row; w++) {
+      uint64_t bits = cand[w];
+      while (bits) {
+        int idx = (w << 6) + __builtin_ctzll(bits);
+        bits &= (bits - 1);
+        const uint64_t *older = &age_matrix[age_row_base(idx)];
+        bool has_older = false;
+        for (int k = 0; k < wake_words_per_row && !has_older; k++) {
+          has_older = (older[k] & cand[k]) != 0;
+        }
+        if (!has_older) {
+          return idx;
         }
-        return lhs < rhs; // Stable tie-breaker.
-      };
-      std::sort(ready_indices.begin(), ready_indices.end(), older_than);
+      }
     }
-    // If IQ_SLOT_PRIORITY, ready_indices is already sorted by slot index (lowest first).
+    Assert(0 && "IssueQueue: age matrix has no oldest candidate");
+    return -1;
+  }
 
-    // 3. Port-centric scheduling: for each port, find the best instruction
-    std::vector<bool> inst_issued(size, false);
-    
-    for (int p = 0; p < num_ports; p++) {
-      for (int idx : ready_indices) {
-        if (inst_issued[idx]) {
+  // 与原排序比较器一致：先按 (rob_flag, rob_idx) 环形比较，相同 rob_idx 按槽位。
+  bool older_than(int lhs, int rhs) const {
+    const auto &a = payload.next(lhs);
+    const auto &b = payload.next(rhs);
+    if (a.rob_flag == b.rob_flag) {
+      if (a.rob_idx != b.rob_idx) {
+        return a.rob_idx < b.rob_idx;
+      }
+    } else {
+      if (a.rob_idx != b.rob_idx) {
+        return a.rob_idx > b.rob_idx;
+      }
+    }
+    return lhs < rhs; // Stable tie-breaker.
+  }
+
+  // 新入队槽位与所有存活条目两两比较，写入本槽位的行和其他行中的本槽位列。
+  void update_age_for_slot(int idx) {
+    int word = slot_word(idx);
+    uint64_t bit = slot_bit(idx);
+    uint64_t *row = &age_matrix[age_row_base(idx)];
+    for (int w = 0; w < wake_words_per_row; w++) {
+      row[w] = 0;
+      uint64_t live = valid_mask[w];
+      while (live) {
+        int j = (w << 6) + __builtin_ctzll(live);
+        live &= (live - 1);
+        if (j == idx) {
           continue;
         }
-        
-        uint32_t op_type = entry[idx].uop.op;
-        uint64_t op_bit = (1ULL << op_type);
-        
-        if (ports[p].capability_mask & op_bit) {
-          result.push_back({idx, ports[p].port_idx});
-          inst_issued[idx] = true;
-          break; // Move to the next port
+        uint64_t &col = age_matrix[age_row_base(j) + word];
+        if (older_than(j, idx)) {
+          row[w] |= slot_bit(j);
+          col &= ~bit;
+        } else {
+          col |= bit;
         }
       }
     }
-
-    return result;
   }
+
   size_t matrix_row_base(uint32_t preg) const {
     return static_cast<size_t>(preg) * static_cast<size_t>(wake_words_per_row);
   }
 
+  size_t age_row_base(int idx) const {
+    return static_cast<size_t>(idx) * static_cast<size_t>(wake_words_per_row);
+  }
+
   uint64_t slot_bit(int idx) const {
     return 1ULL << (idx & 63);
   }
@@ -449,47 +549,53 @@ private:
     return idx >> 6;
   }
 
-  void set_dep_bits_for_slot(const IqStoredEntry &ent, int idx) {
+  static void set_bit_if(uint64_t &word, uint64_t bit, bool cond) {
+    if (cond) {
+      word |= bit;
+    } else {
+      word &= ~bit;
+    }
+  }
+
+  void refresh_ready_word(int w) {
+    ready_mask_1[w] =
+        valid_mask[w] & ~(src1_wait_mask[w] | src2_wait_mask[w]);
+  }
+
+  void set_dep_bits_for_slot(const IqStoredUop &uop, int idx) {
     int word = slot_word(idx);
     uint64_t bit = slot_bit(idx);
 
-    if (ent.uop.src1_en && ent.uop.src1_busy) {
-      uint32_t preg = ent.uop.src1_preg;
+    if (uop.src1_en && uop.src1_busy) {
+      uint32_t preg = uop.src1_preg;
       if (preg < PRF_NUM) {
-        wake_matrix_src1_1[matrix_row_base(preg) + word] |= bit;
+        wake_matrix_src1[matrix_row_base(preg) + word] |= bit;
       }
     }
-    if (ent.uop.src2_en && ent.uop.src2_busy) {
-      uint32_t preg = ent.uop.src2_preg;
+    if (uop.src2_en && uop.src2_busy) {
+      uint32_t preg = uop.src2_preg;
       if (preg < PRF_NUM) {
-        wake_matrix_src2_1[matrix_row_base(preg) + word] |= bit;
+        wake_matrix_src2[matrix_row_base(preg) + word] |= bit;
       }
     }
   }
 
-  void clear_dep_bits_for_slot(const IqStoredEntry &ent, int idx) {
+  void clear_dep_bits_for_slot(const IqStoredUop &uop, int idx) {
     int word = slot_word(idx);
     uint64_t bit = slot_bit(idx);
     uint64_t clear_mask = ~bit;
 
-    if (ent.uop.src1_en) {
-      uint32_t preg = ent.uop.src1_preg;
+    if (uop.src1_en) {
+      uint32_t preg = uop.src1_preg;
       if (preg < PRF_NUM) {
-        wake_matrix_src1_1[matrix_row_base(preg) + word] &= clear_mask;
+        wake_matrix_src1[matrix_row_base(preg) + word] &= clear_mask;
       }
     }
-    if (ent.uop.src2_en) {
-      uint32_t preg = ent.uop.src2_preg;
+    if (uop.src2_en) {
+      uint32_t preg = uop.src2_preg;
       if (preg < PRF_NUM) {
-        wake_matrix_src2_1[matrix_row_base(preg) + word] &= clear_mask;
+        wake_matrix_src2[matrix_row_base(preg) + word] &= clear_mask;
       }
     }
   }
-
-  bool is_ready(const IqStoredEntry &ent) {
-    const auto &op = ent.uop;
-    bool ops_ok =
-        (!op.src1_en || !op.src1_busy) && (!op.src2_en || !op.src2_busy);
-    return ops_ok ;
-  }
 };
@@ -63,6 +63,17 @@ public:
   uint64_t l1d_axi_write_samples = 0;
   uint64_t l1d_mem_inst_total_cycles = 0;
   uint64_t l1d_mem_inst_samples = 0;
+  uint64_t l1d_pf_train = 0; // demand loads seen by the L1D prefetcher
+  uint64_t l1d_pf_cand_stride = 0; // candidate lines from the stride table
+  uint64_t l1d_pf_cand_stream = 0; // candidate lines from the stream table
+  uint64_t l1d_pf_drop_queue_full = 0;
+  uint64_t l1d_pf_drop_dup = 0; // already queued or in flight as prefetch
+  uint64_t l1d_pf_probe = 0; // tag probes injected into idle load ports
+  uint64_t l1d_pf_drop_present = 0; // line already in cache / WB / MSHR
+  uint64_t l1d_pf_drop_mshr = 0; // not enough free MSHRs beyond the demand reserve
+  uint64_t l1d_pf_issue = 0; // prefetches that allocated an MSHR
+  uint64_t l1d_pf_useful = 0; // first demand access hits the filled line
+  uint64_t l1d_pf_late = 0; // first demand access finds the prefetch in flight
   uint64_t mmio_inst_count = 0;
   uint64_t mmio_load_count = 0;
   uint64_t mmio_store_count = 0;
@@ -73,6 +84,10 @@ public:
   uint64_t stq_same_addr_block_count = 0;
   uint64_t ld_stlf_check_count = 0;
   uint64_t ld_stlf_block_unknown_store_addr_count = 0;
+  // store-set 依赖预测
+  uint64_t ld_spec_bypass_count = 0;   // 越过地址未知 store 推测发射的 load
+  uint64_t ld_mem_violation_count = 0; // 访存顺序违例（每条违例 store 记一次）
+  uint64_t ld_false_dep_count = 0;     // 预测依赖等待后实际无重叠的 load
 
   uint64_t icache_access_num = 0;
   uint64_t icache_miss_num = 0;
@@ -80,6 +95,13 @@ public:
   uint64_t icache_miss_penalty_samples = 0;
   uint64_t icache_axi_read_total_cycles = 0;
   uint64_t icache_axi_read_samples = 0;
+  // FDIP 预取（由取指目标驱动）
+  uint64_t icache_prefetch_issue = 0;
+  uint64_t icache_prefetch_useful = 0;   // 预取行首次被取指命中
+  uint64_t icache_prefetch_late = 0;     // 需求缺失赶上了在途/待发的预取
+  uint64_t icache_prefetch_useless = 0;  // 预取行未被使用即被替换/失效
+  uint64_t icache_prefetch_filtered = 0; // 探测命中或同一行已在途
+  uint64_t icache_prefetch_dropped = 0;  // 队列满或无可用翻译
   uint64_t llc_read_access = 0;
   uint64_t llc_read_hit = 0;
   uint64_t llc_read_miss = 0;
@@ -125,6 +147,9 @@ public:
   uint64_t idu_tag_stall = 0;
   uint64_t stall_br_id_cycles = 0;
   uint64_t stall_preg_cycles = 0;
+  // Rename move elimination（按提交计数）
+  uint64_t move_elim_num = 0;       // 消除的寄存器搬移
+  uint64_t zero_idiom_elim_num = 0; // 映射到 preg 0 的清零惯用法
   uint64_t stall_rob_full_cycles = 0;
   uint64_t stall_iq_full_cycles = 0;
   uint64_t stall_ldq_full_cycles = 0;
@@ -147,6 +172,12 @@ public:
   // IB consume-side counters (producer/consumer gap at PreIDU->IDU boundary).
   uint64_t ib_consume_available_slots = 0;
   uint64_t ib_consume_consumed_slots = 0;
+  // 宏融合（按提交的融合 uop 统计，每个计两条指令）
+  uint64_t fuse_lui_addi_num = 0;
+  uint64_t fuse_auipc_addi_num = 0;
+  uint64_t fuse_zext_num = 0;
+  uint64_t fuse_lui_load_num = 0;
+  uint64_t fuse_replay_num = 0; // 融合 uop 异常后拆开重取
 
   // Level 2 Counters
   uint64_t slots_fetch_latency = 0;
@@ -253,6 +284,17 @@ public:
     l1d_axi_write_samples = 0;
     l1d_mem_inst_total_cycles = 0;
     l1d_mem_inst_samples = 0;
+    l1d_pf_train = 0;
+    l1d_pf_cand_stride = 0;
+    l1d_pf_cand_stream = 0;
+    l1d_pf_drop_queue_full = 0;
+    l1d_pf_drop_dup = 0;
+    l1d_pf_probe = 0;
+    l1d_pf_drop_present = 0;
+    l1d_pf_drop_mshr = 0;
+    l1d_pf_issue = 0;
+    l1d_pf_useful = 0;
+    l1d_pf_late = 0;
     mmio_inst_count = 0;
     mmio_load_count = 0;
     mmio_store_count = 0;
@@ -263,12 +305,21 @@ public:
     stq_same_addr_block_count = 0;
     ld_stlf_check_count = 0;
     ld_stlf_block_unknown_store_addr_count = 0;
+    ld_spec_bypass_count = 0;
+    ld_mem_violation_count = 0;
+    ld_false_dep_count = 0;
     icache_access_num = 0;
     icache_miss_num = 0;
     icache_miss_penalty_total_cycles = 0;
     icache_miss_penalty_samples = 0;
     icache_axi_read_total_cycles = 0;
     icache_axi_read_samples = 0;
+    icache_prefetch_issue = 0;
+    icache_prefetch_useful = 0;
+    icache_prefetch_late = 0;
+    icache_prefetch_useless = 0;
+    icache_prefetch_filtered = 0;
+    icache_prefetch_dropped = 0;
     llc_read_access = 0;
     llc_read_hit = 0;
     llc_read_miss = 0;
@@ -314,6 +365,8 @@ public:
     idu_tag_stall = 0;
     stall_br_id_cycles = 0;
     stall_preg_cycles = 0;
+    move_elim_num = 0;
+    zero_idiom_elim_num = 0;
     stall_rob_full_cycles = 0;
     stall_iq_full_cycles = 0;
     stall_ldq_full_cycles = 0;
@@ -336,6 +389,11 @@ public:
     slots_frontend_bound = 0;
     ib_consume_available_slots = 0;
     ib_consume_consumed_slots = 0;
+    fuse_lui_addi_num = 0;
+    fuse_auipc_addi_num = 0;
+    fuse_zext_num = 0;
+    fuse_lui_load_num = 0;
+    fuse_replay_num = 0;
 
     slots_fetch_latency = 0;
     slots_fetch_bandwidth = 0;
@@ -670,6 +728,45 @@ public:
            avg_axi_write, l1d_axi_write_samples);
     printf("\033[38;5;34mAvg Mem-Inst Latency : %.6f cycles (samples=%ld)\033[0m\n",
            avg_mem_inst_latency, l1d_mem_inst_samples);
+    // 准确率 = 被 demand 用到的预取 / 发出的预取；覆盖率 = 被预取消除的
+    // demand miss / (消除的 + 剩余的 demand miss)；迟到率 = 用到时仍在途的比例
+    const uint64_t l1d_pf_used = l1d_pf_useful + l1d_pf_late;
+    const double l1d_pf_accuracy =
+        (l1d_pf_issue == 0)
+            ? 0.0
+            : static_cast<double>(l1d_pf_used) /
+                  static_cast<double>(l1d_pf_issue);
+    const double l1d_pf_coverage =
+        (l1d_pf_used + l1d_miss_mshr_alloc == 0)
+            ? 0.0
+            : static_cast<double>(l1d_pf_used) /
+                  static_cast<double>(l1d_pf_used + l1d_miss_mshr_alloc);
+    const double l1d_pf_lateness =
+        (l1d_pf_used == 0) ? 0.0
+                           : static_cast<double>(l1d_pf_late) /
+                                 static_cast<double>(l1d_pf_used);
+    printf("\033[38;5;34mL1D PF Train         : %ld\033[0m\n", l1d_pf_train);
+    printf("\033[38;5;34mL1D PF Cand Stride   : %ld\033[0m\n",
+           l1d_pf_cand_stride);
+    printf("\033[38;5;34mL1D PF Cand Stream   : %ld\033[0m\n",
+           l1d_pf_cand_stream);
+    printf("\033[38;5;34mL1D PF Drop QFull    : %ld\033[0m\n",
+           l1d_pf_drop_queue_full);
+    printf("\033[38;5;34mL1D PF Drop Dup      : %ld\033[0m\n", l1d_pf_drop_dup);
+    printf("\033[38;5;34mL1D PF Probe         : %ld\033[0m\n", l1d_pf_probe);
+    printf("\033[38;5;34mL1D PF Drop Present  : %ld\033[0m\n",
+           l1d_pf_drop_present);
+    printf("\033[38;5;34mL1D PF Drop MSHR     : %ld\033[0m\n",
+           l1d_pf_drop_mshr);
+    printf("\033[38;5;34mL1D PF Issue         : %ld\033[0m\n", l1d_pf_issue);
+    printf("\033[38;5;34mL1D PF Useful        : %ld\033[0m\n", l1d_pf_useful);
+    printf("\033[38;5;34mL1D PF Late          : %ld\033[0m\n", l1d_pf_late);
+    printf("\033[38;5;34mL1D PF Accuracy      : %.6f\033[0m\n",
+           l1d_pf_accuracy);
+    printf("\033[38;5;34mL1D PF Coverage      : %.6f\033[0m\n",
+           l1d_pf_coverage);
+    printf("\033[38;5;34mL1D PF Lateness      : %.6f\033[0m\n",
+           l1d_pf_lateness);
     printf("\033[38;5;34mMMIO Inst Count      : %ld\033[0m\n", mmio_inst_count);
     printf("\033[38;5;34mMMIO Load Count      : %ld\033[0m\n", mmio_load_count);
     printf("\033[38;5;34mMMIO Store Count     : %ld\033[0m\n", mmio_store_count);
@@ -692,6 +789,12 @@ public:
            ld_stlf_check_count);
     printf("\033[38;5;34mLD Block Unknown STA : %ld (%.4f%% of checks)\033[0m\n",
            ld_stlf_block_unknown_store_addr_count, ld_stlf_unknown_block_ratio);
+    printf("\033[38;5;34mLD Spec Bypass STA   : %ld\033[0m\n",
+           ld_spec_bypass_count);
+    printf("\033[38;5;34mMem Order Violation  : %ld\033[0m\n",
+           ld_mem_violation_count);
+    printf("\033[38;5;34mStore-Set False Dep  : %ld\033[0m\n",
+           ld_false_dep_count);
     printf("\n");
   }
 
@@ -725,6 +828,17 @@ public:
            avg_miss_penalty, icache_miss_penalty_samples);
     printf("\033[38;5;34mAvg AXI Read    : %.6f cycles (samples=%ld)\033[0m\n",
            avg_axi_read, icache_axi_read_samples);
+    if (icache_prefetch_issue != 0 || icache_prefetch_late != 0) {
+      const double pf_accuracy =
+          static_cast<double>(icache_prefetch_useful) /
+          static_cast<double>(icache_prefetch_issue ? icache_prefetch_issue : 1);
+      printf("\033[38;5;34mL1I prefetch    : issue=%ld useful=%ld late=%ld "
+             "useless=%ld accuracy=%.4f\033[0m\n",
+             icache_prefetch_issue, icache_prefetch_useful, icache_prefetch_late,
+             icache_prefetch_useless, pf_accuracy);
+      printf("\033[38;5;34mL1I prefetch q  : filtered=%ld dropped=%ld\033[0m\n",
+             icache_prefetch_filtered, icache_prefetch_dropped);
+    }
     printf("\n");
   }
 
@@ -852,6 +966,18 @@ public:
            ib_blocked_cycles);
     printf("\033[38;5;34mftq blocked cycles           : %ld\033[0m\n",
            ftq_blocked_cycles);
+    const uint64_t fuse_total = fuse_lui_addi_num + fuse_auipc_addi_num +
+                                fuse_zext_num + fuse_lui_load_num;
+    if (fuse_total != 0) {
+      printf("\033[38;5;34mmacro fusion pairs           : %ld (%.2f%% of commit)\033[0m\n",
+             fuse_total,
+             commit_num ? static_cast<double>(fuse_total) * 200.0 / commit_num
+                        : 0.0);
+      printf("\033[38;5;34mfuse lui+addi/auipc+addi     : %ld / %ld\033[0m\n",
+             fuse_lui_addi_num, fuse_auipc_addi_num);
+      printf("\033[38;5;34mfuse zext/lui+load/replay    : %ld / %ld / %ld\033[0m\n",
+             fuse_zext_num, fuse_lui_load_num, fuse_replay_num);
+    }
     const double icache_wait_bpu_pct =
         cycle ? static_cast<double>(front_icache_wait_bpu_cycle_total) * 100.0 /
                     cycle
@@ -873,6 +999,16 @@ public:
            stall_br_id_cycles);
     printf("\033[38;5;34mpreg stall cycles       : %ld\033[0m\n",
            stall_preg_cycles);
+    const double move_elim_ratio =
+        commit_num ? static_cast<double>(move_elim_num + zero_idiom_elim_num) *
+                         100.0 / commit_num
+                   : 0.0;
+    printf("\033[38;5;34mren move elim commits   : %ld\033[0m\n",
+           move_elim_num);
+    printf("\033[38;5;34mren zero idiom commits  : %ld\033[0m\n",
+           zero_idiom_elim_num);
+    printf("\033[38;5;34m  - eliminated / commit : %.2f%%\033[0m\n",
+           move_elim_ratio);
     printf("\033[38;5;34mrob full stall cycles   : %ld\033[0m\n",
            stall_rob_full_cycles);
     printf("\033[38;5;34miq full stall cycles    : %ld\033[0m\n",
@@ -51,14 +51,14 @@ private:
   void ftq_flush();
 
   InstructionBuffer ibuf;
-  InstructionBuffer ibuf_1;
+  // 本拍待写入 ibuf 的条目（comb 填写，seq 提交）
+  InstructionBufferEntry push_entries[FETCH_WIDTH];
+  int push_count = 0;
 
-  FTQEntry ftq_lookup_entries[FTQ_SIZE];
-  FTQEntry ftq_lookup_entries_1[FTQ_SIZE];
-  FTQTrainMetaEntry ftq_train_meta_fifo[FTQ_SIZE];
-  FTQTrainMetaEntry ftq_train_meta_fifo_1[FTQ_SIZE];
-  wire<1> ftq_valid[FTQ_SIZE] = {};
-  wire<1> ftq_valid_1[FTQ_SIZE] = {};
+  // FTQ 条目阵列为双 rank：[] 读当前态，set()/next() 访问下一拍副本。
+  DualRankArray<FTQEntry, FTQ_SIZE> ftq_lookup_entries;
+  DualRankArray<FTQTrainMetaEntry, FTQ_SIZE> ftq_train_meta_fifo;
+  DualRankArray<wire<1>, FTQ_SIZE> ftq_valid;
   reg<FTQ_IDX_WIDTH> ftq_head = 0;
   reg<FTQ_IDX_WIDTH> ftq_tail = 0;
   reg<bit_width_for_count(FTQ_SIZE + 1)> ftq_count = 0;
@@ -1,5 +1,6 @@
 #pragma once
 #include "config.h"
+#include "DualRankArray.h"
 #include "Exu.h"
 #include "IO.h"
 
@@ -34,9 +35,9 @@ public:
   void init();
   void seq();
 
-  reg<32> reg_file[PRF_NUM];
+  // 物理寄存器堆：reg_file[] 为当前态，reg_file.next() 为本拍写回后的值。
+  DualRankArray<reg<32>, PRF_NUM> reg_file;
   ExePrfIO::ExePrfEntry inst_r[ISSUE_WIDTH];
 
-  wire<32> reg_file_1[PRF_NUM];
   ExePrfIO::ExePrfEntry inst_r_1[ISSUE_WIDTH];
 };
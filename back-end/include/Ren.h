@@ -44,6 +44,10 @@ public:
   reg<PRF_IDX_WIDTH> free_head_commit;
   reg<PRF_IDX_WIDTH> free_tail;
   reg<PRF_IDX_WIDTH> alloc_checkpoint_head[MAX_BR_NUM];
+  // move elimination 后多个 areg 可共享同一 preg：按 arch_RAT 引用计数，
+  // 归零才回收到 free list；arch_preg_cnt 为 arch_RAT 中不同 preg 的个数
+  reg<AREG_IDX_WIDTH> arch_ref[PRF_NUM];
+  reg<AREG_IDX_WIDTH> arch_preg_cnt;
 
   DecRenIO::DecRenInst inst_r_1[DECODE_WIDTH];
   wire<1> inst_valid_1[DECODE_WIDTH];
@@ -55,4 +59,11 @@ public:
   wire<PRF_IDX_WIDTH> free_head_commit_1;
   wire<PRF_IDX_WIDTH> free_tail_1;
   wire<PRF_IDX_WIDTH> alloc_checkpoint_head_1[MAX_BR_NUM];
+  wire<AREG_IDX_WIDTH> arch_ref_1[PRF_NUM];
+  wire<AREG_IDX_WIDTH> arch_preg_cnt_1;
+
+  // 多个comb复用的中间信号
+  wire<1> fire[DECODE_WIDTH];
+  wire<PRF_IDX_WIDTH> alloc_reg[DECODE_WIDTH];
+  wire<2> elim_kind[DECODE_WIDTH];
 };
@@ -1,4 +1,5 @@
 #pragma once
+#include "DualRankArray.h"
 #include "IO.h"
 #include "config.h"
 
@@ -27,6 +28,9 @@ struct RobStoredInst {
   wire<PRF_IDX_WIDTH> dest_preg;
   wire<PRF_IDX_WIDTH> old_dest_preg;
   wire<1> dest_en;
+  wire<1> move_elim;
+  wire<FUSE_KIND_WIDTH> fuse_kind;
+  wire<1> is_rvc;
 
   wire<FTQ_IDX_WIDTH> ftq_idx;
   wire<FTQ_OFFSET_WIDTH> ftq_offset;
@@ -72,6 +76,9 @@ struct RobStoredInst {
     dst.mispred = src.mispred;
     dst.br_taken = src.br_taken;
     dst.dest_en = src.dest_en;
+    dst.move_elim = src.move_elim;
+    dst.fuse_kind = src.fuse_kind;
+    dst.is_rvc = src.is_rvc;
     dst.is_atomic = src.is_atomic;
     dst.func3 = src.func3;
     dst.func7 = src.func7;
@@ -105,6 +112,9 @@ struct RobStoredInst {
     dst.mispred = mispred;
     dst.br_taken = br_taken;
     dst.dest_en = dest_en;
+    dst.move_elim = move_elim;
+    dst.fuse_kind = fuse_kind;
+    dst.is_rvc = is_rvc;
     dst.func7 = func7;
     dst.rob_idx = rob_idx;
     dst.rob_flag = rob_flag;
@@ -133,7 +143,7 @@ public:
   SimContext *ctx;
   void init();
   void seq();
-  void comb_begin(); // 默认保持寄存器状态（*_1 <- *）
+  void comb_begin(); // 默认保持指针寄存器状态（*_1 <- *）
   void comb_ready();
   void comb_ftq_pc_req();
   void comb_commit();
@@ -145,19 +155,21 @@ public:
   RobIn in;
   RobOut out;
 
-  // 状态
-  RobStoredEntry entry[ROB_BANK_NUM][ROB_LINE_NUM];
+  // 状态（entry 为双 rank 阵列：entry[] 为当前态，next()/write() 为下一拍）
+  DualRankArray<RobStoredEntry, ROB_BANK_NUM * ROB_LINE_NUM> entry;
   reg<clog2(ROB_LINE_NUM)> enq_ptr;
   reg<clog2(ROB_LINE_NUM)> deq_ptr;
   reg<1> enq_flag;
   reg<1> deq_flag;
 
-  RobStoredEntry entry_1[ROB_BANK_NUM][ROB_LINE_NUM];
   wire<clog2(ROB_LINE_NUM)> enq_ptr_1;
   wire<clog2(ROB_LINE_NUM)> deq_ptr_1;
   wire<1> enq_flag_1;
   wire<1> deq_flag_1;
 
+  // 条目按 bank-major 扁平化存放。
+  static int rob_slot(int bank, int line) { return bank * ROB_LINE_NUM + line; }
+
 private:
   int stall_cycle = 0;
   bool is_empty() { return (enq_ptr == deq_ptr) && (enq_flag == deq_flag); };
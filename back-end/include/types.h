@@ -46,6 +46,16 @@ enum InstType {
 constexpr int INST_TYPE_COUNT = FP + 1;
 constexpr int INST_TYPE_WIDTH = bit_width_for_count(INST_TYPE_COUNT);
 
+// Idu 宏融合的指令对（融合 uop 占一个 ROB 项，提交时按两条指令计）
+enum FuseKind {
+  FUSE_NONE = 0,
+  FUSE_LUI_ADDI,   // lui rd, hi; addi rd, rd, lo      -> li rd, imm32
+  FUSE_AUIPC_ADDI, // auipc rd, hi; addi rd, rd, lo    -> rd = pc + imm32
+  FUSE_ZEXT,       // slli rd, rs, k; srli rd, rd, k   -> andi rd, rs, mask
+  FUSE_LUI_LOAD,   // lui rd, hi; lw rd, lo(rd)        -> lw rd, imm32(x0)
+};
+constexpr int FUSE_KIND_WIDTH = 3;
+
 // AMO Operations (funct7[6:2])
 namespace AmoOp {
 constexpr uint8_t ADD = 0b00000;
@@ -69,6 +79,7 @@ constexpr uint8_t MAXU = 0b11100;
 struct DebugMeta {
   wire<32> instruction;
   wire<32> pc;
+  wire<32> fused_instruction; // 宏融合 uop 第二条指令的指令字（difftest 用）
   uint8_t mem_align_mask;
   bool difftest_skip;
   int64_t inst_idx;
@@ -123,6 +134,8 @@ struct InstInfo {
   wire<1> illegal_inst;
   wire<1> is_atomic;
   wire<1> flush_pipe;
+  wire<FUSE_KIND_WIDTH> fuse_kind;
+  wire<1> is_rvc;
 
   InstType type;
   TmaMeta tma;
@@ -227,6 +240,7 @@ struct MicroOp {
     this->is_atomic = info.is_atomic;
     this->dbg.instruction = info.dbg.instruction;
     this->dbg.pc = info.dbg.pc;
+    this->dbg.fused_instruction = info.dbg.fused_instruction;
     this->dbg.mem_align_mask = info.dbg.mem_align_mask;
     this->dbg.difftest_skip = info.dbg.difftest_skip;
     this->dbg.inst_idx = info.dbg.inst_idx;
@@ -262,7 +276,10 @@ public:
   bool is_ckpt = false;
   uint64_t ckpt_warmup_commit_target = 0;
   uint64_t ckpt_measure_commit_target = 0;
+  // 本实例的仿真周期；没有 ctx 的叶子代码经 sim_now() 读取（见 SimThread.h）
+  long long sim_time = 0;
   SimCpu *cpu = nullptr;
   void run_commit_inst(InstEntry *inst_entry);
-  void run_difftest_inst(InstEntry *inst_entry);
+  // check=false 时参考模型只执行不比对（宏融合 uop 的第一条指令）
+  void run_difftest_inst(InstEntry *inst_entry, bool check = true);
 };
@@ -1,17 +1,17 @@
 #pragma once
+#include "SimThread.h"
 #include "types.h"
 #include <cstdio>
 
 #define LOOP_INC(idx, length) idx = (idx + 1) % (length)
 #define LOOP_DEC(idx, length) idx = (idx + (length) - 1) % (length)
-extern long long sim_time;
 
 // Unified backend/memory logging helpers.
 // Prefer these macros over scattered direct domain checks.
 #define BE_LOG(fmt, ...)                                                       \
   do {                                                                         \
     if (BACKEND_LOG) {                                                         \
-      std::printf("[BE][t=%lld] " fmt "\n", (long long)sim_time,              \
+      std::printf("[BE][t=%lld] " fmt "\n", (long long)sim_now(),              \
                   ##__VA_ARGS__);                                              \
     }                                                                          \
   } while (0)
@@ -19,7 +19,7 @@ extern long long sim_time;
 #define MEM_LOGF(fmt, ...)                                                     \
   do {                                                                         \
     if (MEM_LOG) {                                                             \
-      std::printf("[MEM][t=%lld] " fmt "\n", (long long)sim_time,             \
+      std::printf("[MEM][t=%lld] " fmt "\n", (long long)sim_now(),             \
                   ##__VA_ARGS__);                                              \
     }                                                                          \
   } while (0)
@@ -27,7 +27,7 @@ extern long long sim_time;
 #define DCACHE_LOGF(fmt, ...)                                                  \
   do {                                                                         \
     if (DCACHE_LOG) {                                                          \
-      std::printf("[DCACHE][t=%lld] " fmt "\n", (long long)sim_time,          \
+      std::printf("[DCACHE][t=%lld] " fmt "\n", (long long)sim_now(),          \
                   ##__VA_ARGS__);                                              \
     }                                                                          \
   } while (0)
@@ -35,7 +35,7 @@ extern long long sim_time;
 #define MMU_LOGF(fmt, ...)                                                     \
   do {                                                                         \
     if (MMU_LOG) {                                                             \
-      std::printf("[MMU][t=%lld] " fmt "\n", (long long)sim_time,             \
+      std::printf("[MMU][t=%lld] " fmt "\n", (long long)sim_now(),             \
                   ##__VA_ARGS__);                                              \
     }                                                                          \
   } while (0)
@@ -53,7 +53,7 @@ extern long long sim_time;
     if (__builtin_expect(!(cond), 0)) {                                        \
       printf("\033[1;31mAssertion failed: %s, file %s, line %d, cycle "        \
              "%lld\033[0m\n",                                                  \
-             #cond, __FILE__, __LINE__, sim_time);                             \
+             #cond, __FILE__, __LINE__, sim_now());                            \
       exit(1);                                                                 \
     }                                                                          \
   } while (0)
@@ -65,6 +65,17 @@ inline uint32_t make_rob_idx(uint32_t line, uint32_t bank) {
   return (line * ROB_BANK_NUM) | bank;
 }
 
+// store-set 预测的 SSIT 索引：取指 PC 折叠哈希。
+inline uint32_t ssit_index_of_pc(uint32_t pc) {
+  return ((pc >> 2) ^ (pc >> (2 + SSIT_IDX_WIDTH))) & (SSIT_SIZE - 1);
+}
+
+// L1D stride 预取的 load PC 哈希：按半字折叠，与 SSIT 大小无关。
+inline uint32_t l1d_pf_pc_hash(uint32_t pc) {
+  return ((pc >> 1) ^ (pc >> (1 + L1D_PF_PC_HASH_WIDTH))) &
+         ((1u << L1D_PF_PC_HASH_WIDTH) - 1);
+}
+
 inline uint8_t rob_cplt_popcount(wire<ROB_CPLT_MASK_WIDTH> mask) {
   return static_cast<uint8_t>(__builtin_popcount(static_cast<unsigned>(mask)));
 }
@@ -0,0 +1,32 @@
+#include "../include/trap.h"
+#include "../include/uart.h"
+#include "../include/xprintf.h"
+#include <stdint.h>
+
+#define UART_MMIO_BASE 0x10000000u
+
+// More iterations than STQ_SIZE in every profile: if a flush drops a
+// committed MMIO store, the STQ fills behind it and the ROB deadlocks.
+#define ITERATIONS 600u
+
+extern void install_trap_vector(void);
+extern void mmio_store_trap_loop(uint32_t addr, uint32_t n);
+
+volatile uint32_t trap_count = 0;
+
+int main(void) {
+  uart_init();
+  xputs("\n[MMIO-FLUSH] MMIO store followed by a trapping instruction\n");
+
+  install_trap_vector();
+  mmio_store_trap_loop(UART_MMIO_BASE + UART_SCR_OFFSET, ITERATIONS);
+
+  if (trap_count != ITERATIONS) {
+    xprintf("[MMIO-FLUSH] FAIL: trap_count=%u expected=%u\n",
+            (unsigned int)trap_count, ITERATIONS);
+    halt(1);
+  }
+
+  xputs("[MMIO-FLUSH] PASS\n");
+  return 0;
+}
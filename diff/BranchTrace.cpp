@@ -0,0 +1,103 @@
+#include "BranchTrace.h"
+
+namespace {
+// 与 front-end/BPU/BPU_configs.h 中的 BR_* 编码一致
+constexpr uint8_t kBrDirect = 0;
+constexpr uint8_t kBrCall = 1;
+constexpr uint8_t kBrRet = 2;
+constexpr uint8_t kBrIdirect = 3;
+constexpr uint8_t kBrJal = 5;
+} // namespace
+
+bool BranchTraceWriter::open(const std::string &path, uint32_t start_pc) {
+  const bool gz = path.size() >= 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+  out_ = gzopen(path.c_str(), gz ? "wb" : "wT");
+  if (out_ == nullptr) {
+    return false;
+  }
+  gzbuffer(out_, 1u << 20);
+  const BrTraceHeader header = {kBrTraceMagic, kBrTraceVersion, start_pc, 0};
+  gzwrite(out_, &header, sizeof(header));
+  buf_.clear();
+  buf_.reserve(kFlushRecords);
+  records_ = 0;
+  return true;
+}
+
+void BranchTraceWriter::close() {
+  if (out_ != nullptr) {
+    flush();
+    gzclose(out_);
+    out_ = nullptr;
+  }
+}
+
+void BranchTraceWriter::flush() {
+  if (!buf_.empty() && out_ != nullptr) {
+    gzwrite(out_, buf_.data(),
+            static_cast<unsigned>(buf_.size() * sizeof(BrTraceRecord)));
+    records_ += buf_.size();
+  }
+  buf_.clear();
+}
+
+void BranchTraceWriter::record_ctl(uint32_t pc, uint32_t next_pc,
+                                   uint32_t inst, uint32_t len) {
+  const uint32_t opcode = inst & 0x7f;
+  const uint32_t rd = (inst >> 7) & 0x1f;
+  const uint32_t rs1 = (inst >> 15) & 0x1f;
+  BrTraceRecord rec = {pc, next_pc, kBrJal, 1, 0};
+  if (opcode == 0x63) {
+    const uint32_t imm = ((inst >> 31) ? 0xfffff000u : 0u) |
+                         ((inst << 4) & 0x800u) | ((inst >> 20) & 0x7e0u) |
+                         ((inst >> 7) & 0x1eu);
+    rec.type = kBrDirect;
+    rec.target = pc + imm;
+    rec.taken = next_pc != pc + len;
+  } else if (opcode == 0x6f) {
+    rec.type = (rd == 1) ? kBrCall : kBrJal;
+  } else {
+    rec.type = (rs1 == 1 && rd == 0 && (inst >> 20) == 0) ? kBrRet : kBrIdirect;
+  }
+  push(rec);
+}
+
+bool BranchTraceReader::open(const std::string &path) {
+  close();
+  in_ = gzopen(path.c_str(), "rb");
+  if (in_ == nullptr) {
+    error_ = "cannot open " + path;
+    return false;
+  }
+  gzbuffer(in_, 1u << 20);
+  if (gzread(in_, &header_, sizeof(header_)) != sizeof(header_) ||
+      header_.magic != kBrTraceMagic || header_.version != kBrTraceVersion) {
+    error_ = path + ": not a branch trace (bad header)";
+    close();
+    return false;
+  }
+  buf_.clear();
+  pos_ = 0;
+  return true;
+}
+
+void BranchTraceReader::close() {
+  if (in_ != nullptr) {
+    gzclose(in_);
+    in_ = nullptr;
+  }
+}
+
+bool BranchTraceReader::refill() {
+  constexpr size_t kChunk = 1u << 14;
+  if (in_ == nullptr) {
+    return false;
+  }
+  buf_.resize(kChunk);
+  const int got = gzread(in_, buf_.data(),
+                         static_cast<unsigned>(kChunk * sizeof(BrTraceRecord)));
+  const size_t n = got > 0 ? static_cast<size_t>(got) / sizeof(BrTraceRecord) : 0;
+  buf_.resize(n);
+  pos_ = 0;
+  return n != 0;
+}
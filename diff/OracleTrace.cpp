@@ -0,0 +1,139 @@
+#include "OracleTrace.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+uint32_t oracle_trace_gpr_hash(const uint32_t *gpr) {
+  uint32_t h = 2166136261u;
+  for (int i = 0; i < 32; i++) {
+    for (int b = 0; b < 4; b++) {
+      h = (h ^ ((gpr[i] >> (8 * b)) & 0xffu)) * 16777619u;
+    }
+  }
+  return h;
+}
+
+bool OracleTraceWriter::open(const std::string &path, uint32_t start_pc,
+                             uint32_t gpr_hash) {
+  out_ = std::fopen(path.c_str(), "wb");
+  if (out_ == nullptr) {
+    return false;
+  }
+  header_ = {};
+  header_.magic = kOracleTraceMagic;
+  header_.version = kOracleTraceVersion;
+  header_.start_pc = start_pc;
+  header_.chunk_records = kOracleTraceChunkRecords;
+  header_.gpr_hash = gpr_hash;
+  std::fwrite(&header_, sizeof(header_), 1, out_); // close() 回填
+  buf_.clear();
+  buf_.reserve(kOracleTraceChunkRecords);
+  index_.clear();
+  return true;
+}
+
+void OracleTraceWriter::flush_chunk() {
+  if (buf_.empty() || out_ == nullptr) {
+    buf_.clear();
+    return;
+  }
+  const uLong src_bytes = buf_.size() * sizeof(OracleTraceRecord);
+  uLongf len = compressBound(src_bytes);
+  comp_.resize(len);
+  compress2(comp_.data(), &len, reinterpret_cast<const Bytef *>(buf_.data()),
+            src_bytes, Z_DEFAULT_COMPRESSION);
+  OracleTraceChunk c;
+  c.offset = static_cast<uint64_t>(std::ftell(out_));
+  c.comp_bytes = static_cast<uint32_t>(len);
+  c.records = static_cast<uint32_t>(buf_.size());
+  std::fwrite(comp_.data(), 1, len, out_);
+  index_.push_back(c);
+  header_.record_count += buf_.size();
+  buf_.clear();
+}
+
+void OracleTraceWriter::close() {
+  if (out_ == nullptr) {
+    return;
+  }
+  flush_chunk();
+  header_.index_offset = static_cast<uint64_t>(std::ftell(out_));
+  header_.chunk_count = static_cast<uint32_t>(index_.size());
+  std::fwrite(index_.data(), sizeof(OracleTraceChunk), index_.size(), out_);
+  std::fseek(out_, 0, SEEK_SET);
+  std::fwrite(&header_, sizeof(header_), 1, out_);
+  std::fclose(out_);
+  out_ = nullptr;
+}
+
+bool OracleTraceReader::open(const std::string &path) {
+  close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error_ = "cannot open " + path;
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(header_)) {
+    ::close(fd);
+    error_ = path + ": truncated oracle trace";
+    return false;
+  }
+  map_bytes_ = static_cast<size_t>(st.st_size);
+  void *p = mmap(nullptr, map_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    error_ = path + ": mmap failed";
+    return false;
+  }
+  base_ = static_cast<const uint8_t *>(p);
+  std::memcpy(&header_, base_, sizeof(header_));
+  const uint64_t index_bytes =
+      static_cast<uint64_t>(header_.chunk_count) * sizeof(OracleTraceChunk);
+  if (header_.magic != kOracleTraceMagic ||
+      header_.version != kOracleTraceVersion || header_.chunk_records == 0 ||
+      header_.index_offset + index_bytes > map_bytes_) {
+    close();
+    error_ = path + ": not an oracle trace (bad header)";
+    return false;
+  }
+  index_ = reinterpret_cast<const OracleTraceChunk *>(base_ + header_.index_offset);
+  for (uint32_t i = 0; i < header_.chunk_count; i++) {
+    if (index_[i].offset + index_[i].comp_bytes > header_.index_offset) {
+      close();
+      error_ = path + ": corrupt chunk index";
+      return false;
+    }
+  }
+  cur_chunk_ = UINT64_MAX;
+  return true;
+}
+
+void OracleTraceReader::close() {
+  if (base_ != nullptr) {
+    munmap(const_cast<uint8_t *>(base_), map_bytes_);
+    base_ = nullptr;
+  }
+  index_ = nullptr;
+  map_bytes_ = 0;
+  cur_chunk_ = UINT64_MAX;
+}
+
+void OracleTraceReader::load_chunk(uint64_t chunk) {
+  const OracleTraceChunk &c = index_[chunk];
+  chunk_buf_.resize(c.records);
+  uLongf len = c.records * sizeof(OracleTraceRecord);
+  if (uncompress(reinterpret_cast<Bytef *>(chunk_buf_.data()), &len,
+                 base_ + c.offset, c.comp_bytes) != Z_OK ||
+      len != c.records * sizeof(OracleTraceRecord)) {
+    std::fprintf(stderr, "[OracleTrace] corrupt chunk %llu\n",
+                 static_cast<unsigned long long>(chunk));
+    std::exit(1);
+  }
+  cur_chunk_ = chunk;
+}
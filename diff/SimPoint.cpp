@@ -0,0 +1,56 @@
+#include "SimPoint.h"
+
+#include <algorithm>
+#include <string>
+
+bool SimPointBbv::open(const std::string &path) {
+  const bool gz = path.size() >= 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+  out_ = gzopen(path.c_str(), gz ? "wb" : "wT");
+  bb_len_ = 0;
+  intervals_ = 0;
+  bb_ids_.clear();
+  counts_.assign(1, 0);
+  touched_.clear();
+  return out_ != nullptr;
+}
+
+void SimPointBbv::close() {
+  if (out_ != nullptr) {
+    end_interval();
+    gzclose(out_);
+    out_ = nullptr;
+  }
+}
+
+void SimPointBbv::end_bb() {
+  if (bb_len_ == 0) {
+    return;
+  }
+  auto it = bb_ids_.find(bb_start_);
+  if (it == bb_ids_.end()) {
+    it = bb_ids_.emplace(bb_start_, static_cast<uint32_t>(counts_.size())).first;
+    counts_.push_back(0);
+  }
+  if (counts_[it->second] == 0) {
+    touched_.push_back(it->second);
+  }
+  counts_[it->second] += bb_len_;
+  bb_len_ = 0;
+}
+
+void SimPointBbv::end_interval() {
+  end_bb(); // 跨边界的基本块：已执行部分记入本区间，剩余部分仍按同一入口计
+  if (touched_.empty() || out_ == nullptr) {
+    return;
+  }
+  std::sort(touched_.begin(), touched_.end());
+  std::string line = "T";
+  for (uint32_t id : touched_) {
+    line += ':' + std::to_string(id) + ':' + std::to_string(counts_[id]) + ' ';
+    counts_[id] = 0;
+  }
+  line.back() = '\n';
+  gzwrite(out_, line.data(), static_cast<unsigned>(line.size()));
+  touched_.clear();
+  intervals_++;
+}
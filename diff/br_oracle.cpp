@@ -1,134 +1,286 @@
+#include "oracle.h"
 #include "config.h"
 #include "Csr.h"
-#include "diff.h"
 #include "PhysMemory.h"
 #include "front_IO.h"
 #include "frontend.h"
-#include "ref.h"
 #include "util.h"
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
-#include <queue>
-
-static RefCpu oracle;
-static std::queue<uint32_t> oracle_timer_queue;
-
-namespace {
-struct IoRange {
-  uint32_t base;
-  uint32_t size;
-};
-
-constexpr IoRange kCkptIoRanges[] = {
-    {BOOT_IO_BASE, BOOT_IO_SIZE},
-    {UART_ADDR_BASE, UART_MMIO_SIZE},
-    {PLIC_ADDR_BASE, PLIC_MMIO_SIZE},
-    {OPENSBI_TIMER_BASE, OPENSBI_TIMER_MMIO_SIZE},
-};
-
-inline void seed_oracle_io_from_backing() {
-  oracle.io_words.clear();
-  for (const auto &range : kCkptIoRanges) {
-    for (uint32_t off = 0; off + 4u <= range.size; off += 4u) {
-      const uint32_t addr = range.base + off;
-      const uint32_t data = pmem_read(addr);
-      if (data != 0u) {
-        oracle.io_words[addr] = data;
-      }
+
+Oracle::Oracle(SimContext *ctx, const CPU_state *dut_cpu)
+    : ctx_(ctx), dut_cpu_(dut_cpu) {
+  ref_.sim_clock = &ctx->sim_time;
+  ref_.timer_sink = &timer_queue;
+}
+
+uint8_t Oracle::exec_flags() const {
+  uint8_t flags = 0;
+  flags |= ref_.is_br ? kOtBr : 0;
+  flags |= ref_.br_taken ? kOtTaken : 0;
+  flags |= ref_.is_exception ? kOtException : 0;
+  flags |= ref_.is_csr ? kOtCsr : 0;
+  flags |= (ref_.is_mmio_load || ref_.is_mmio_store) ? kOtMmio : 0;
+  flags |= ref_.page_fault_inst ? kOtPageFaultInst : 0;
+  flags |= ref_.sim_end ? kOtSimEnd : 0;
+  return flags;
+}
+
+// 送后端的是取指原始位（压缩指令由 Idu 展开）；取指缺页时改为出错地址，
+// 跨页 32 位指令高半部缺页时为 pc + 2，由 Rob 作为 tval 上报。
+void Oracle::live_step(Step &step) {
+  step.pc = ref_.state.pc;
+  ref_.exec();
+  step.next_pc = ref_.state.pc;
+  step.flags = exec_flags();
+  step.inst = (step.flags & kOtPageFaultInst) ? ref_.inst_fault_va
+                                              : ref_.inst_raw;
+}
+
+bool Oracle::trace_step(Step &step) {
+  if (trace_fetch_pos_ >= trace_.size()) {
+    trace_end_ = true;
+    return false;
+  }
+  const OracleTraceRecord &rec = trace_.at(trace_fetch_pos_);
+  // 计时器值只在首次取到该记录时回灌，与 DUT 读计时器的次数一一对应
+  if ((rec.flags & kOtTimer) &&
+      trace_fetch_pos_ >= trace_timer_pos_) {
+    timer_queue.push(rec.timer);
+    trace_timer_pos_ = trace_fetch_pos_ + 1;
+  }
+  trace_fetch_pos_++;
+  step.pc = rec.pc;
+  step.inst = rec.inst;
+  step.next_pc = rec.next_pc;
+  step.flags = rec.flags;
+  if (rec.flags & kOtSimEnd) {
+    trace_end_ = true;
+  }
+  return true;
+}
+
+void Oracle::undo_reset() {
+  undo_log_.clear();
+  undo_head_ = 0;
+  undo_step_pos_.clear();
+}
+
+// 提交 n 条：丢弃对应 step 的回滚记录。
+void Oracle::undo_retire(int n) {
+  for (int i = 0; i < n && !undo_step_pos_.empty(); i++) {
+    undo_step_pos_.pop_front();
+  }
+  const uint64_t keep = undo_step_pos_.empty()
+                            ? undo_head_ + undo_log_.size()
+                            : undo_step_pos_.front();
+  while (undo_head_ < keep) {
+    undo_log_.pop_front();
+    undo_head_++;
+  }
+}
+
+// refetch：撤销全部未提交 step 写过的内存。
+void Oracle::undo_rollback() {
+  ref_.store_undo = nullptr;
+  while (!undo_log_.empty()) {
+    const RefStoreUndo &u = undo_log_.back();
+    ref_.store_word(u.addr, u.old);
+    undo_log_.pop_back();
+  }
+  ref_.store_undo = &undo_log_;
+  undo_reset();
+}
+
+void Oracle::trace_reset() {
+  trace_fetch_pos_ = 0;
+  trace_commit_pos_ = 0;
+  trace_timer_pos_ = 0;
+  trace_end_ = false;
+}
+
+void Oracle::trace_desync(const char *what, uint32_t expect,
+                          uint32_t got) const {
+  std::fprintf(stderr,
+               "[OracleTrace] desync at record %llu (%s): trace=0x%08x "
+               "dut=0x%08x. The trace must be recorded from the same start "
+               "point and options; runs that take asynchronous interrupts "
+               "need the live ref_.\n",
+               static_cast<unsigned long long>(trace_commit_pos_), what,
+               expect, got);
+  std::exit(1);
+}
+
+// refetch 的目标必然是下一条待提交指令：按提交计数重定位并校验 PC。
+void Oracle::trace_refetch(const front_top_in &in) {
+  trace_fetch_pos_ = trace_commit_pos_;
+  trace_end_ = trace_fetch_pos_ >= trace_.size();
+  if (trace_end_) {
+    return;
+  }
+  const uint32_t trace_pc = trace_.at(trace_fetch_pos_).pc;
+  if (trace_pc != in.refetch_address) {
+    trace_desync("refetch pc", trace_pc, in.refetch_address);
+  }
+  if (trace_fetch_pos_ == 0) {
+    const uint32_t hash = oracle_trace_gpr_hash(dut_cpu_->gpr);
+    if (hash != trace_.header().gpr_hash) {
+      trace_desync("start gpr hash", trace_.header().gpr_hash, hash);
     }
   }
 }
 
-inline void sync_oracle_control_state(const front_top_in &in) {
-  oracle.state.pc = in.refetch_address;
+void Oracle::seed_io_from_backing() { pmem_collect_io_words(ref_.io_words); }
+
+void Oracle::sync_control_state(const front_top_in &in) {
+  ref_.state.pc = in.refetch_address;
   if (in.csr_status != nullptr) {
-    oracle.state.csr[csr_mstatus] =
+    ref_.state.csr[csr_mstatus] =
         static_cast<uint32_t>(in.csr_status->mstatus);
-    oracle.state.csr[csr_sstatus] =
+    ref_.state.csr[csr_sstatus] =
         static_cast<uint32_t>(in.csr_status->sstatus);
-    oracle.state.csr[csr_satp] = static_cast<uint32_t>(in.csr_status->satp);
-    oracle.privilege = static_cast<uint8_t>(in.csr_status->privilege);
+    ref_.state.csr[csr_satp] = static_cast<uint32_t>(in.csr_status->satp);
+    ref_.privilege = static_cast<uint8_t>(in.csr_status->privilege);
   }
 }
 
-inline bool oracle_gpr_matches_dut() {
+bool Oracle::gpr_matches_dut() const {
   for (int idx = 0; idx < ARF_NUM; ++idx) {
-    if (oracle.state.gpr[idx] != dut_cpu.gpr[idx]) {
+    if (ref_.state.gpr[idx] != dut_cpu_->gpr[idx]) {
       return false;
     }
   }
   return true;
 }
 
-inline void sync_oracle_arch_state_from_dut(const front_top_in &in) {
-  std::memcpy(oracle.state.gpr, dut_cpu.gpr, sizeof(oracle.state.gpr));
-  std::memcpy(oracle.state.csr, dut_cpu.csr, sizeof(oracle.state.csr));
-  oracle.state.store = dut_cpu.store;
-  oracle.state.store_addr = dut_cpu.store_addr;
-  oracle.state.store_data = dut_cpu.store_data;
-  oracle.state.instruction = dut_cpu.instruction;
-  oracle.state.page_fault_inst = dut_cpu.page_fault_inst;
-  oracle.state.page_fault_load = dut_cpu.page_fault_load;
-  oracle.state.page_fault_store = dut_cpu.page_fault_store;
-  oracle.state.inst_idx = dut_cpu.inst_idx;
-  oracle.state.commit_pc = dut_cpu.commit_pc;
-  sync_oracle_control_state(in);
+void Oracle::sync_arch_state_from_dut(const front_top_in &in) {
+  std::memcpy(ref_.state.gpr, dut_cpu_->gpr, sizeof(ref_.state.gpr));
+  std::memcpy(ref_.state.csr, dut_cpu_->csr, sizeof(ref_.state.csr));
+  ref_.state.store = dut_cpu_->store;
+  ref_.state.store_addr = dut_cpu_->store_addr;
+  ref_.state.store_data = dut_cpu_->store_data;
+  ref_.state.instruction = dut_cpu_->instruction;
+  ref_.state.page_fault_inst = dut_cpu_->page_fault_inst;
+  ref_.state.page_fault_load = dut_cpu_->page_fault_load;
+  ref_.state.page_fault_store = dut_cpu_->page_fault_store;
+  ref_.state.inst_idx = dut_cpu_->inst_idx;
+  ref_.state.commit_pc = dut_cpu_->commit_pc;
+  sync_control_state(in);
 }
-} // namespace
 
-void push_oracle_timer(uint32_t val) {
-  oracle_timer_queue.push(val);
+void Oracle::clear_timer_queue() {
+  while (!timer_queue.empty()) {
+    timer_queue.pop();
+  }
 }
 
-uint64_t get_oracle_timer() {
-  Assert(!oracle_timer_queue.empty() && "Oracle Timer queue underflow!");
-  uint32_t val = oracle_timer_queue.front();
-  oracle_timer_queue.pop();
+uint64_t Oracle::pop_timer() {
+  Assert(!timer_queue.empty() && "Oracle Timer queue underflow!");
+  uint32_t val = timer_queue.front();
+  timer_queue.pop();
   return val;
 }
 
-void init_oracle(int img_size) {
-  while (!oracle_timer_queue.empty()) {
-    oracle_timer_queue.pop();
+void Oracle::set_trace(const std::string &path) {
+  if (!trace_.open(path)) {
+    std::fprintf(stderr, "Error: %s\n", trace_.error().c_str());
+    std::exit(1);
   }
-  oracle.init(0);
-  oracle.dut_pf_check_enable = false;
-  std::memcpy(oracle.memory, pmem_ram_ptr(), img_size);
-  oracle.store_word(0x10000004, pmem_read(0x10000004));
-  oracle.store_word(0x0, pmem_read(0x0));
-  oracle.store_word(0x4, pmem_read(0x4));
-  oracle.store_word(0x8, pmem_read(0x8));
-  oracle.store_word(0xc, pmem_read(0xc));
-  seed_oracle_io_from_backing();
+  trace_on_ = true;
+  trace_reset();
+  std::printf("[OracleTrace] replay %s: %llu records from pc 0x%08x\n",
+              path.c_str(),
+              static_cast<unsigned long long>(trace_.size()),
+              trace_.header().start_pc);
 }
 
-void init_oracle_ckpt(CPU_state ckpt_state, uint8_t privilege) {
-  while (!oracle_timer_queue.empty()) {
-    oracle_timer_queue.pop();
+void Oracle::retire(int n) {
+  if (trace_on_) {
+    trace_commit_pos_ += static_cast<uint64_t>(n);
+  } else {
+    undo_retire(n);
   }
-  oracle.init(0);
-  oracle.dut_pf_check_enable = false;
-  oracle.state = ckpt_state;
-  oracle.privilege = privilege;
+}
 
-  const uint32_t *ckpt_memory = pmem_ram_ptr();
-  Assert(ckpt_memory != nullptr &&
-         "init_oracle_ckpt: pmem RAM backend is not initialized");
-  std::memcpy(oracle.memory, ckpt_memory,
-              static_cast<size_t>(PHYSICAL_MEMORY_LENGTH) * sizeof(uint32_t));
-  seed_oracle_io_from_backing();
+uint64_t Oracle::record_trace(const std::string &path, uint64_t max_inst) {
+  OracleTraceWriter writer;
+  if (!writer.open(path, ref_.state.pc,
+                   oracle_trace_gpr_hash(ref_.state.gpr))) {
+    std::fprintf(stderr, "Error: Could not open oracle trace file %s\n",
+                 path.c_str());
+    std::exit(1);
+  }
+  clear_timer_queue();
+  ref_.store_undo = nullptr; // 离线录制不会 refetch，无需回滚日志
+  // 与 REF 模式一致，计时器按每条指令一拍推进
+  for (uint64_t i = 0; i < max_inst && !ref_.sim_end; i++, ctx_->sim_time++) {
+    OracleTraceRecord rec = {};
+    Step step;
+    live_step(step);
+    rec.pc = step.pc;
+    rec.inst = step.inst;
+    rec.next_pc = step.next_pc;
+    rec.flags = step.flags;
+    if (!timer_queue.empty()) {
+      rec.flags |= kOtTimer;
+      rec.timer = timer_queue.back();
+      while (!timer_queue.empty()) {
+        timer_queue.pop();
+      }
+    }
+    writer.push(rec);
+  }
+  const uint64_t records = writer.record_count();
+  writer.close();
+  return records;
+}
 
-  if ((oracle.state.csr[csr_satp] & 0x80000000u) != 0 &&
-      oracle.privilege != RISCV_MODE_M) {
+void Oracle::init(int img_size) {
+  clear_timer_queue();
+  if (trace_on_) {
+    trace_reset();
+    return;
+  }
+  ref_.init(0);
+  ref_.dut_pf_check_enable = false;
+  (void)img_size; // ref_.memory 是镜像的 COW 视图
+  ref_.store_word(0x10000004, pmem_read(0x10000004));
+  ref_.store_word(0x0, pmem_read(0x0));
+  ref_.store_word(0x4, pmem_read(0x4));
+  ref_.store_word(0x8, pmem_read(0x8));
+  ref_.store_word(0xc, pmem_read(0xc));
+  seed_io_from_backing();
+  undo_reset();
+  ref_.store_undo = &undo_log_;
+}
+
+void Oracle::init_ckpt(CPU_state ckpt_state, uint8_t privilege) {
+  clear_timer_queue();
+  if (trace_on_) {
+    trace_reset();
+    return;
+  }
+  ref_.init(0);
+  ref_.dut_pf_check_enable = false;
+  ref_.state = ckpt_state;
+  ref_.privilege = privilege;
+
+  // ref_.init() 已把 memory 重置为镜像的 COW 视图（含 ref 交接提交的页）。
+  seed_io_from_backing();
+  undo_reset();
+  ref_.store_undo = &undo_log_;
+
+  if ((ref_.state.csr[csr_satp] & 0x80000000u) != 0 &&
+      ref_.privilege != RISCV_MODE_M) {
     uint32_t p_addr = 0;
-    (void)oracle.va2pa(p_addr, oracle.state.pc, 0);
+    (void)ref_.va2pa(p_addr, ref_.state.pc, 0);
   }
 }
 
-void get_oracle(struct front_top_in &in, struct front_top_out &out) {
+void Oracle::fetch(front_top_in &in, front_top_out &out) {
   int i;
-  static bool stall = false;
 #ifdef CONFIG_ORACLE_STEADY_FETCH_WIDTH
   constexpr bool kOracleSteadyFetchWidth = true;
 #else
@@ -140,23 +292,24 @@ void get_oracle(struct front_top_in &in, struct front_top_out &out) {
   out.commit_stall = false;
 
   if (in.refetch) {
-    oracle.sim_end = false;
-    stall = false;
-  }
-
-  if (oracle.sim_end) {
-    stall = true;
+    if (trace_on_) {
+      trace_refetch(in);
+    } else {
+      undo_rollback();
+      ref_.sim_end = false;
+      sync_control_state(in);
+      if (!gpr_matches_dut()) {
+        sync_arch_state_from_dut(in);
+      }
+    }
+    stall_ = false;
   }
 
-  if (in.refetch) {
-    sync_oracle_control_state(in);
-    if (!oracle_gpr_matches_dut()) {
-      sync_oracle_arch_state_from_dut(in);
-    }
-    stall = false;
+  if (trace_on_ ? trace_end_ : ref_.sim_end) {
+    stall_ = true;
   }
 
-  if (stall) {
+  if (stall_) {
     out.FIFO_valid = false;
     for (i = 0; i < FETCH_WIDTH; i++) {
       out.inst_valid[i] = false;
@@ -165,47 +318,55 @@ void get_oracle(struct front_top_in &in, struct front_top_out &out) {
     return;
   }
 
-  out.FIFO_valid = true;
-  out.predict_next_fetch_address = oracle.state.pc;
+  Step step;
+  out.FIFO_valid = false;
   for (i = 0; i < FETCH_WIDTH; i++) {
+    if (trace_on_) {
+      if (!trace_step(step)) {
+        out.inst_valid[i] = false;
+        break;
+      }
+    } else {
+      undo_step_pos_.push_back(undo_head_ +
+                                     undo_log_.size());
+      live_step(step);
+    }
+    out.FIFO_valid = true;
     out.inst_valid[i] = true;
-    out.pc[i] = oracle.state.pc;
+    out.pc[i] = step.pc;
     out.page_fault_inst[i] = false;
+    out.instructions[i] = step.inst;
+    out.predict_next_fetch_address = step.next_pc;
 
-    oracle.exec();
-    out.instructions[i] = oracle.Instruction;
-    out.predict_next_fetch_address = oracle.state.pc;
-
-
-    if (oracle.is_exception || oracle.is_csr || oracle.is_mmio_load ||
-        oracle.is_mmio_store) {
+    if (step.flags & (kOtException | kOtCsr | kOtMmio)) {
       out.predict_dir[i] = false;
-      if (oracle.is_exception || oracle.is_csr) {
-        stall = true;
+      if (step.flags & (kOtException | kOtCsr)) {
+        stall_ = true;
       }
 
-      if (oracle.page_fault_inst) {
+      if (step.flags & kOtPageFaultInst) {
         out.page_fault_inst[i] = true;
       }
       break;
     }
 
-    if (oracle.is_br) {
+    const bool br_taken = (step.flags & kOtTaken) != 0;
+    if (step.flags & kOtBr) {
       if (kOracleSteadyFetchWidth) {
         // Stress mode: keep branch direction metadata, but do not truncate
         // this oracle fetch group on taken branches.
-        out.predict_dir[i] = oracle.br_taken;
-        out.predict_next_fetch_address = oracle.state.pc;
+        out.predict_dir[i] = br_taken;
+        out.predict_next_fetch_address = step.next_pc;
       } else {
-        if (stall) {
-          out.predict_dir[i] = !oracle.br_taken;
+        if (stall_) {
+          out.predict_dir[i] = !br_taken;
           out.predict_next_fetch_address = 0;
         } else {
-          out.predict_dir[i] = oracle.br_taken;
-          out.predict_next_fetch_address = oracle.state.pc;
+          out.predict_dir[i] = br_taken;
+          out.predict_next_fetch_address = step.next_pc;
         }
 
-        if (oracle.br_taken || stall)
+        if (br_taken || stall_)
           break;
       }
     } else {
@@ -214,7 +375,7 @@ void get_oracle(struct front_top_in &in, struct front_top_out &out) {
 
     // Cache line boundary check: truncate if next instruction is in a different line
     if (!kOracleSteadyFetchWidth &&
-        ((oracle.state.pc ^ out.pc[i]) & ~(ICACHE_LINE_SIZE - 1))) {
+        ((step.next_pc ^ out.pc[i]) & ~(ICACHE_LINE_SIZE - 1))) {
       break;
     }
   }
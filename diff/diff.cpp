@@ -1,52 +1,38 @@
 #include "diff.h"
+#include "Checkpoint.h"
 #include "Csr.h"
 #include "DcacheConfig.h"
 #include "DiffMemTrace.h"
 #include "PhysMemory.h"
 #include "RISCV.h"
+#include "SimThread.h"
+#include "SoftfloatGuard.h"
 #include "config.h"
 #include "util.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
-
-CPU_state dut_cpu;
-RefCpu ref_cpu;
+#include <mutex>
+#include <vector>
 
 namespace {
 inline uint32_t sign_extend_12(uint32_t imm12) {
   return static_cast<uint32_t>(static_cast<int32_t>(imm12 << 20) >> 20);
 }
 
-struct IoRange {
-  uint32_t base;
-  uint32_t size;
-};
-
-constexpr IoRange kCkptIoRanges[] = {
-    {BOOT_IO_BASE, BOOT_IO_SIZE},
-    {UART_ADDR_BASE, UART_MMIO_SIZE},
-    {PLIC_ADDR_BASE, PLIC_MMIO_SIZE},
-    {OPENSBI_TIMER_BASE, OPENSBI_TIMER_MMIO_SIZE},
-};
+} // namespace
 
-inline void seed_ref_io_from_backing() {
-  ref_cpu.io_words.clear();
-  for (const auto &range : kCkptIoRanges) {
-    for (uint32_t off = 0; off + 4u <= range.size; off += 4u) {
-      const uint32_t addr = range.base + off;
-      const uint32_t data = pmem_read(addr);
-      if (data != 0u) {
-        ref_cpu.io_words[addr] = data;
-      }
-    }
-  }
+Difftest::Difftest(SimContext *ctx) : ctx_(ctx) {
+  ref_cpu.sim_clock = &ctx->sim_time;
 }
 
-void dump_mem_subsystem_snapshot() {
-}
+Difftest::~Difftest() { async_join(); }
+
+void Difftest::seed_ref_io_from_backing() { pmem_collect_io_words(ref_cpu.io_words); }
 
-void dump_code_line_snapshot(const char *tag, uint32_t pc) {
+void Difftest::dump_code_line_snapshot(const char *tag, uint32_t pc) const {
   const uint32_t line_base =
       pc & ~(static_cast<uint32_t>(ICACHE_LINE_SIZE) - 1u);
   const uint32_t word_off = (pc - line_base) >> 2;
@@ -67,26 +53,19 @@ void dump_code_line_snapshot(const char *tag, uint32_t pc) {
   }
 }
 
-} // namespace
-
-// relocate the init_difftest function to avoid multiple definition error
-void init_difftest(int img_size) {
+void Difftest::init(int img_size) {
+  (void)img_size; // ref_cpu.memory 是镜像的 COW 视图，无需按镜像大小拷贝
   ref_cpu.init(0);
-  std::memcpy(ref_cpu.memory, pmem_ram_ptr(), img_size);
   seed_ref_io_from_backing();
 }
 
-void init_diff_ckpt(CPU_state ckpt_state) {
+void Difftest::init_ckpt(CPU_state ckpt_state, uint8_t privilege) {
   std::cout << "Restore for ref cpu " << std::endl;
   ref_cpu.init(0);
   ref_cpu.state = ckpt_state;
-  ref_cpu.privilege = RISCV_MODE_U;
+  ref_cpu.privilege = privilege;
 
-  const uint32_t *ckpt_memory = pmem_ram_ptr();
-  Assert(ckpt_memory != nullptr &&
-         "init_diff_ckpt: pmem RAM backend is not initialized");
-  std::memcpy(ref_cpu.memory, ckpt_memory,
-              static_cast<size_t>(PHYSICAL_MEMORY_LENGTH) * sizeof(uint32_t));
+  // ref_cpu.init() 已把 memory 映射为快照镜像的 COW 视图。
   seed_ref_io_from_backing();
 
   // Keep checkpoint bootstrap aligned with RefCpu::exec(): only probe a
@@ -99,118 +78,387 @@ void init_diff_ckpt(CPU_state ckpt_state) {
   }
 }
 
-void get_state(CPU_state &dut_state, uint8_t &privilege) {
+void Difftest::get_state(CPU_state &dut_state, uint8_t &privilege) {
   dut_state = ref_cpu.state;
   privilege = ref_cpu.privilege;
-  uint32_t *dut_memory = pmem_ram_ptr();
-  Assert(dut_memory != nullptr &&
-         "get_state: pmem RAM backend is not initialized");
-  std::memcpy(dut_memory, ref_cpu.memory,
-              static_cast<size_t>(PHYSICAL_MEMORY_LENGTH) * sizeof(uint32_t));
+  // 只把 ref 写过的页提交回镜像，DUT 视图随之重置，避免整块 1GB 拷贝。
+  pmem_image_commit(ref_cpu.memory, ref_cpu.ram_dirty_page_bits);
   for (const auto &kv : ref_cpu.io_words) {
     pmem_write(kv.first, kv.second);
   }
 }
 
-static void checkregs() {
-  int i;
+void Difftest::save_checkpoint(const std::string &path,
+                               uint64_t interval_inst_count) {
+  CkptSnapshot snap;
+  std::memcpy(snap.cpu.gpr, ref_cpu.state.gpr, sizeof(snap.cpu.gpr));
+  std::memcpy(snap.cpu.csr, ref_cpu.state.csr, sizeof(snap.cpu.csr));
+  snap.cpu.pc = ref_cpu.state.pc;
+  snap.cpu.store_addr = ref_cpu.state.store_addr;
+  snap.cpu.store_data = ref_cpu.state.store_data;
+  snap.cpu.store_strb = ref_cpu.state.store_strb;
+  snap.cpu.store = ref_cpu.state.store;
+  snap.cpu.reserve_valid = ref_cpu.state.reserve_valid;
+  snap.cpu.reserve_addr = ref_cpu.state.reserve_addr;
+  snap.privilege = ref_cpu.privilege;
+  snap.interval_inst_count = interval_inst_count;
+  ckpt_save(path, snap, ref_cpu.memory, ref_cpu.ram_dirty_page_bits,
+            ref_cpu.io_words);
+}
 
-  if (ref_cpu.state.pc != dut_cpu.pc)
-    goto fault;
+bool Difftest::regs_match(const CPU_state &dut) const {
+  if (ref_cpu.state.pc != dut.pc)
+    return false;
 
   // 如果没有指令缺页异常，且指令不匹配，报错
-  if (!ref_cpu.page_fault_inst && ref_cpu.Instruction != dut_cpu.instruction)
-    goto fault;
+  if (!ref_cpu.page_fault_inst && ref_cpu.Instruction != dut.instruction)
+    return false;
 
-  if (ref_cpu.page_fault_inst != dut_cpu.page_fault_inst)
-    goto fault;
-  if (ref_cpu.page_fault_load != dut_cpu.page_fault_load)
-    goto fault;
-  if (ref_cpu.page_fault_store != dut_cpu.page_fault_store)
-    goto fault;
+  if (ref_cpu.page_fault_inst != dut.page_fault_inst)
+    return false;
+  if (ref_cpu.page_fault_load != dut.page_fault_load)
+    return false;
+  if (ref_cpu.page_fault_store != dut.page_fault_store)
+    return false;
 
   // 通用寄存器
-  for (i = 0; i < 32; i++) {
-    if (ref_cpu.state.gpr[i] != dut_cpu.gpr[i])
-      goto fault;
+  for (int i = 0; i < 32; i++) {
+    if (ref_cpu.state.gpr[i] != dut.gpr[i])
+      return false;
   }
 
   // csr
-  for (i = 0; i < CSR_NUM; i++) {
-    if (ref_cpu.state.csr[i] != dut_cpu.csr[i])
-      goto fault;
+  for (int i = 0; i < CSR_NUM; i++) {
+    if (ref_cpu.state.csr[i] != dut.csr[i])
+      return false;
   }
 
   if (ref_cpu.state.store) {
-    if (dut_cpu.store != ref_cpu.state.store)
-      goto fault;
+    if (dut.store != ref_cpu.state.store)
+      return false;
 
-    if (dut_cpu.store_data != ref_cpu.state.store_data)
-      goto fault;
+    if (dut.store_data != ref_cpu.state.store_data)
+      return false;
 
-    if (dut_cpu.store_addr != ref_cpu.state.store_addr)
-      goto fault;
+    if (dut.store_addr != ref_cpu.state.store_addr)
+      return false;
   }
 
-  return;
+  return true;
+}
 
-fault:
+void Difftest::report_mismatch(const CPU_state &dut, long long cycle) {
   cout << "Difftest: error" << endl;
-  cout << "cycle: " << dec << sim_time << endl;
+  cout << "cycle: " << dec << cycle << endl;
 
   auto print_mismatch = [](const char *name, uint32_t ref, uint32_t dut) {
     printf("%10s:\t%08x\t%08x%s\n", name, ref, dut,
            (ref != dut ? "\t Error" : ""));
   };
 
-  printf("        PC:\t%08x\t%08x\n", ref_cpu.state.pc, dut_cpu.pc);
+  printf("        PC:\t%08x\t%08x\n", ref_cpu.state.pc, dut.pc);
   cout << "\t\tReference\tDut" << endl;
   for (int i = 0; i < 32; i++) {
-    print_mismatch(reg_names[i].c_str(), ref_cpu.state.gpr[i], dut_cpu.gpr[i]);
+    print_mismatch(reg_names[i].c_str(), ref_cpu.state.gpr[i], dut.gpr[i]);
   }
 
   cout << endl;
   for (int i = 0; i < CSR_NUM; i++) {
-    print_mismatch(csr_names[i].c_str(), ref_cpu.state.csr[i], dut_cpu.csr[i]);
+    print_mismatch(csr_names[i].c_str(), ref_cpu.state.csr[i], dut.csr[i]);
   }
 
   cout << endl;
-  print_mismatch("store", ref_cpu.state.store, dut_cpu.store);
-  print_mismatch("data", ref_cpu.state.store_data, dut_cpu.store_data);
-  print_mismatch("addr", ref_cpu.state.store_addr, dut_cpu.store_addr);
+  print_mismatch("store", ref_cpu.state.store, dut.store);
+  print_mismatch("data", ref_cpu.state.store_data, dut.store_data);
+  print_mismatch("addr", ref_cpu.state.store_addr, dut.store_addr);
 
   printf("Ref Inst: %08x\tDUT Inst: %08x\n", ref_cpu.Instruction,
-         dut_cpu.instruction);
+         dut.instruction);
   std::printf("Commit PC: 0x%08x\tDUT next PC: 0x%08x\tREF next PC: 0x%08x\n",
-              dut_cpu.commit_pc, dut_cpu.pc, ref_cpu.state.pc);
+              dut.commit_pc, dut.pc, ref_cpu.state.pc);
   
-  std::printf("[DIFF] p_memory@a5(0x%08x)=0x%08x ref=0x%08x\n", dut_cpu.gpr[15],
-              pmem_read(dut_cpu.gpr[15]),
-              ref_cpu.load_word(dut_cpu.gpr[15]));
-  dump_code_line_snapshot("commit_pc", dut_cpu.commit_pc);
+  std::printf("[DIFF] p_memory@a5(0x%08x)=0x%08x ref=0x%08x\n", dut.gpr[15],
+              pmem_read(dut.gpr[15]),
+              ref_cpu.load_word(dut.gpr[15]));
+  dump_code_line_snapshot("commit_pc", dut.commit_pc);
 #if defined(LOG_ENABLE) && defined(LOG_LSU_MEM_ENABLE)
   diff_mem_trace::dump_recent();
 #endif
-  dump_mem_subsystem_snapshot();
 
   Assert(0 && "Difftest: Register or Memory mismatch detected.");
 }
 
-void difftest_skip() {
-  ref_cpu.dut_expect_pf_inst = dut_cpu.page_fault_inst;
-  ref_cpu.dut_expect_pf_load = dut_cpu.page_fault_load;
-  ref_cpu.dut_expect_pf_store = dut_cpu.page_fault_store;
+void Difftest::ref_step(const CPU_state &dut) {
+  ref_cpu.dut_expect_pf_inst = dut.page_fault_inst;
+  ref_cpu.dut_expect_pf_load = dut.page_fault_load;
+  ref_cpu.dut_expect_pf_store = dut.page_fault_store;
   ref_cpu.exec();
+}
+
+void Difftest::ref_skip(const CPU_state &dut) {
+  ref_step(dut);
   for (int i = 0; i < 32; i++) {
-    ref_cpu.state.gpr[i] = dut_cpu.gpr[i];
+    ref_cpu.state.gpr[i] = dut.gpr[i];
   }
 }
 
-void difftest_step(bool check) {
-  ref_cpu.dut_expect_pf_inst = dut_cpu.page_fault_inst;
-  ref_cpu.dut_expect_pf_load = dut_cpu.page_fault_load;
-  ref_cpu.dut_expect_pf_store = dut_cpu.page_fault_store;
-  ref_cpu.exec();
-  if (check)
-    checkregs();
+void Difftest::skip() { ref_skip(dut_cpu); }
+
+void Difftest::step(bool check) {
+  ref_step(dut_cpu);
+  if (check && !regs_match(dut_cpu))
+    report_mismatch(dut_cpu, ctx_->sim_time);
+}
+
+// ============================================================
+// 异步 difftest
+// ============================================================
+
+static_assert((DIFFTEST_ASYNC_RING_SIZE & (DIFFTEST_ASYNC_RING_SIZE - 1)) == 0,
+              "DIFFTEST_ASYNC_RING_SIZE must be a power of two");
+static_assert((DIFFTEST_ASYNC_SNAP_SIZE & (DIFFTEST_ASYNC_SNAP_SIZE - 1)) == 0,
+              "DIFFTEST_ASYNC_SNAP_SIZE must be a power of two");
+
+// 单生产者（仿真线程）/单消费者（校验线程）无锁环。head/tail 单调递增，
+// 分处不同 cache line；生产者缓存 tail，只在看似满时才重新读取。
+// 快照环与提交记录环同序：带 DIFF_REC_FULL 的记录依次消费下一项快照，
+// 因此快照环的 head 只由生产者自己维护，由提交记录环的 head 一并发布。
+struct DiffCommitRing {
+  alignas(64) std::atomic<uint64_t> head{0};
+  alignas(64) std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> snap_tail{0};
+  alignas(64) uint64_t tail_cache = 0;
+  uint64_t snap_head = 0;
+  uint64_t snap_tail_cache = 0;
+  DiffCommitRecord slots[DIFFTEST_ASYNC_RING_SIZE];
+  CPU_state snaps[DIFFTEST_ASYNC_SNAP_SIZE];
+};
+
+namespace {
+constexpr uint64_t kDiffRingMask = DIFFTEST_ASYNC_RING_SIZE - 1;
+constexpr uint64_t kDiffSnapMask = DIFFTEST_ASYNC_SNAP_SIZE - 1;
+// 消费者每处理这么多条记录发布一次 tail，减少与生产者之间的 cache line 往返。
+constexpr uint64_t kDiffTailPublishMask = 63;
+
+// 校验线程在跑的实例。任意路径 exit() 时先回收这些线程，再析构静态对象。
+std::mutex diff_live_lock;
+std::vector<Difftest *> diff_live;
+bool diff_atexit_registered = false;
+
+// 把非快照记录的增量叠加到校验线程的 DUT 镜像上。
+void diff_record_apply(const DiffCommitRecord &rec, CPU_state &dut) {
+  dut.pc = rec.pc;
+  dut.commit_pc = rec.commit_pc;
+  dut.instruction = rec.instruction;
+  if (rec.rd != 0) {
+    dut.gpr[rec.rd] = rec.rd_val;
+  }
+  dut.store = (rec.flags & DIFF_REC_STORE) != 0;
+  dut.store_addr = rec.store_addr;
+  dut.store_data = rec.store_data;
+  dut.store_strb = rec.store_strb;
+  dut.page_fault_inst = (rec.flags & DIFF_REC_PF_INST) != 0;
+  dut.page_fault_load = (rec.flags & DIFF_REC_PF_LOAD) != 0;
+  dut.page_fault_store = (rec.flags & DIFF_REC_PF_STORE) != 0;
+}
+
+void diff_checker_atexit() {
+  std::vector<Difftest *> live;
+  {
+    std::lock_guard<std::mutex> guard(diff_live_lock);
+    live = diff_live;
+  }
+  for (Difftest *d : live) {
+    d->async_join();
+  }
+}
+} // namespace
+
+void Difftest::checker_main() {
+  SimThreadBinding bind(ctx_);
+  DiffCommitRing &ring = *ring_;
+  uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+  uint64_t snap_tail = ring.snap_tail.load(std::memory_order_relaxed);
+  while (true) {
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    if (tail == head) {
+      if (async_stop_.load(std::memory_order_acquire) &&
+          ring.head.load(std::memory_order_acquire) == tail) {
+        return;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    for (; tail != head; tail++) {
+      const DiffCommitRecord &rec = ring.slots[tail & kDiffRingMask];
+      if (rec.flags & DIFF_REC_FULL) {
+        chk_dut_ = ring.snaps[snap_tail & kDiffSnapMask];
+        snap_tail++;
+      } else {
+        diff_record_apply(rec, chk_dut_);
+      }
+      ref_cpu.commit_cycle = rec.cycle;
+      if (rec.flags & DIFF_REC_SKIP) {
+        ref_skip(chk_dut_);
+      } else {
+        ref_step(chk_dut_);
+        if ((rec.flags & DIFF_REC_CHECK) && !regs_match(chk_dut_)) {
+          fault_cycle_ = rec.cycle;
+          ring.snap_tail.store(snap_tail, std::memory_order_release);
+          ring.tail.store(tail, std::memory_order_release);
+          async_diverged_.store(true, std::memory_order_release);
+          return;
+        }
+      }
+      if ((tail & kDiffTailPublishMask) == kDiffTailPublishMask) {
+        ring.snap_tail.store(snap_tail, std::memory_order_release);
+        ring.tail.store(tail + 1, std::memory_order_release);
+      }
+    }
+    ring.snap_tail.store(snap_tail, std::memory_order_release);
+    ring.tail.store(tail, std::memory_order_release);
+  }
+}
+
+void Difftest::async_join() {
+  if (!checker_.joinable()) {
+    return;
+  }
+  // 校验线程自身触发 exit() 时不能 join 自己。
+  if (checker_.get_id() == std::this_thread::get_id()) {
+    return;
+  }
+  async_stop_.store(true, std::memory_order_release);
+  checker_.join();
+  async_on_ = false;
+  ref_cpu.async_checker = false;
+  softfloat_guard::extra_threads.fetch_sub(1, std::memory_order_acq_rel);
+  std::lock_guard<std::mutex> guard(diff_live_lock);
+  diff_live.erase(std::remove(diff_live.begin(), diff_live.end(), this),
+                  diff_live.end());
+}
+
+void Difftest::report_async_fault() {
+  const uint64_t lag = ring_->head.load(std::memory_order_acquire) -
+                       ring_->tail.load(std::memory_order_acquire);
+  std::printf("[DIFF][ASYNC] mismatch at commit cycle %lld, detected at cycle "
+              "%lld, %llu commits in flight\n",
+              fault_cycle_, ctx_->sim_time,
+              static_cast<unsigned long long>(lag));
+  report_mismatch(chk_dut_, fault_cycle_);
+}
+
+void Difftest::async_start() {
+  Assert(!async_on_ && "Difftest::async_start: checker already running");
+  if (ring_ == nullptr) {
+    ring_ = std::make_unique<DiffCommitRing>();
+  }
+  {
+    std::lock_guard<std::mutex> guard(diff_live_lock);
+    if (!diff_atexit_registered) {
+      std::atexit(diff_checker_atexit);
+      diff_atexit_registered = true;
+    }
+    diff_live.push_back(this);
+  }
+  async_stop_.store(false, std::memory_order_relaxed);
+  async_diverged_.store(false, std::memory_order_relaxed);
+  async_need_full_ = true;
+  ref_cpu.async_checker = true;
+  softfloat_guard::extra_threads.fetch_add(1, std::memory_order_acq_rel);
+  async_on_ = true;
+  checker_ = std::thread(&Difftest::checker_main, this);
+}
+
+bool Difftest::async_wait_room(const std::atomic<uint64_t> &tail,
+                               uint64_t &tail_cache, uint64_t head,
+                               uint64_t size) {
+  while (head - tail_cache >= size) {
+    tail_cache = tail.load(std::memory_order_acquire);
+    if (head - tail_cache < size) {
+      break;
+    }
+    // 校验线程已因分歧退出：不再入环，由主循环的 poll 报告。
+    if (async_diverged_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+void Difftest::async_push(bool skip, bool check, int rd) {
+  DiffCommitRing &ring = *ring_;
+  const uint64_t head = ring.head.load(std::memory_order_relaxed);
+  if (!async_wait_room(ring.tail, ring.tail_cache, head,
+                       DIFFTEST_ASYNC_RING_SIZE)) {
+    return;
+  }
+  uint8_t flags = 0;
+  if (skip) {
+    flags |= DIFF_REC_SKIP;
+  }
+  if (check) {
+    flags |= DIFF_REC_CHECK;
+  }
+  if (dut_cpu.store) {
+    flags |= DIFF_REC_STORE;
+  }
+  if (dut_cpu.page_fault_inst) {
+    flags |= DIFF_REC_PF_INST;
+  }
+  if (dut_cpu.page_fault_load) {
+    flags |= DIFF_REC_PF_LOAD;
+  }
+  if (dut_cpu.page_fault_store) {
+    flags |= DIFF_REC_PF_STORE;
+  }
+  // skip 需要整组 GPR；CSR 指令、异常与中断改写 CSR，都按完整快照入环。
+  const bool trap = dut_cpu.page_fault_inst || dut_cpu.page_fault_load ||
+                    dut_cpu.page_fault_store;
+  if (skip || trap || async_need_full_ ||
+      std::memcmp(async_csr_, dut_cpu.csr, sizeof(async_csr_)) != 0) {
+    if (!async_wait_room(ring.snap_tail, ring.snap_tail_cache, ring.snap_head,
+                         DIFFTEST_ASYNC_SNAP_SIZE)) {
+      return;
+    }
+    ring.snaps[ring.snap_head & kDiffSnapMask] = dut_cpu;
+    ring.snap_head++;
+    std::memcpy(async_csr_, dut_cpu.csr, sizeof(async_csr_));
+    async_need_full_ = false;
+    flags |= DIFF_REC_FULL;
+  }
+  DiffCommitRecord &rec = ring.slots[head & kDiffRingMask];
+  rec.cycle = ctx_->sim_time;
+  rec.pc = dut_cpu.pc;
+  rec.commit_pc = dut_cpu.commit_pc;
+  rec.instruction = dut_cpu.instruction;
+  rec.rd = static_cast<uint8_t>(rd);
+  rec.rd_val = dut_cpu.gpr[rd];
+  rec.store_addr = dut_cpu.store_addr;
+  rec.store_data = dut_cpu.store_data;
+  rec.store_strb = dut_cpu.store_strb;
+  rec.flags = flags;
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+bool Difftest::async_poll() {
+  if (!async_on_ || !async_diverged_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  async_join();
+  report_async_fault();
+  return true;
+}
+
+bool Difftest::async_finish() {
+  if (!async_on_) {
+    return true;
+  }
+  async_join();
+  if (async_diverged_.load(std::memory_order_acquire)) {
+    report_async_fault();
+    return false;
+  }
+  return true;
 }
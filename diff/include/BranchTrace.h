@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+// ============================================================
+// 分支 trace（供 bpu_eval 离线驱动 BPU_TOP）
+//
+// REF 模式下由 RefCpu::run() 逐条调用 BranchTraceWriter::step()，只记录
+// 控制流指令与 PC 不连续点（trap/xret），两条记录之间为顺序执行的非分支
+// 指令，指令数可由 PC 差推出。文件布局（路径以 ".gz" 结尾时整体 gzip）：
+//   BrTraceHeader | BrTraceRecord x N
+// type 复用 BPU 的 BR_* 编码；BR_NONCTL 表示非分支指令处的 PC 跳变
+// （trap/xret），回放时只按目标重定向，不计入预测统计。
+// 条件分支的 target 总是记录跳转目标（不论是否跳转），与 predecode 可见
+// 信息一致。
+// ============================================================
+
+constexpr uint32_t kBrTraceMagic = 0x00545242u; // "BRT\0" little-endian
+constexpr uint32_t kBrTraceVersion = 1u;
+
+struct BrTraceHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t start_pc;
+  uint32_t reserved;
+};
+
+struct BrTraceRecord {
+  uint32_t pc;
+  uint32_t target;
+  uint8_t type;  // BR_DIRECT/BR_CALL/BR_RET/BR_IDIRECT/BR_NONCTL/BR_JAL
+  uint8_t taken; // 实际是否跳转（JAL/JALR/BR_NONCTL 恒为 1）
+  uint16_t reserved;
+};
+
+static_assert(sizeof(BrTraceHeader) == 16 && sizeof(BrTraceRecord) == 12,
+              "branch trace on-disk layout changed");
+
+class BranchTraceWriter {
+public:
+  ~BranchTraceWriter() { close(); }
+  bool open(const std::string &path, uint32_t start_pc);
+  void close();
+
+  // inst 为展开后的指令字，len 为指令字节数（压缩指令为 2）。
+  void step(uint32_t pc, uint32_t next_pc, uint32_t inst, uint32_t len) {
+    const uint32_t opcode = inst & 0x7f;
+    if (opcode == 0x63 || opcode == 0x6f || opcode == 0x67) {
+      record_ctl(pc, next_pc, inst, len);
+    } else if (next_pc != pc + len) {
+      push({pc, next_pc, kTypeNonCtl, 1, 0});
+    }
+  }
+
+  uint64_t record_count() const { return records_; }
+
+private:
+  static constexpr uint8_t kTypeNonCtl = 4; // BR_NONCTL
+  void record_ctl(uint32_t pc, uint32_t next_pc, uint32_t inst, uint32_t len);
+  void push(const BrTraceRecord &rec) {
+    buf_.push_back(rec);
+    if (buf_.size() == kFlushRecords) {
+      flush();
+    }
+  }
+  void flush();
+
+  static constexpr size_t kFlushRecords = 1u << 14;
+  gzFile out_ = nullptr;
+  std::vector<BrTraceRecord> buf_;
+  uint64_t records_ = 0;
+};
+
+class BranchTraceReader {
+public:
+  ~BranchTraceReader() { close(); }
+  // 打开并校验文件头；失败时 error() 给出原因。
+  bool open(const std::string &path);
+  void close();
+
+  // 顺序读取下一条记录，读到结尾返回 false。
+  bool next(BrTraceRecord &rec) {
+    if (pos_ == buf_.size() && !refill()) {
+      return false;
+    }
+    rec = buf_[pos_++];
+    return true;
+  }
+
+  uint32_t start_pc() const { return header_.start_pc; }
+  const std::string &error() const { return error_; }
+
+private:
+  bool refill();
+
+  gzFile in_ = nullptr;
+  BrTraceHeader header_ = {};
+  std::vector<BrTraceRecord> buf_;
+  size_t pos_ = 0;
+  std::string error_;
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ============================================================
+// Oracle 取指 trace（trace 驱动的 oracle 前端，替代在线 oracle RefCpu）
+//
+// 由 --oracle-trace-record 在 O3 起点（复位/快照恢复+prewarm/快进之后）
+// 逐条执行 oracle 录制，回放时 Oracle::fetch() 直接从 trace 组织取指组。
+// 每条记录对应 oracle 的一次 exec()，下标即自 O3 起点的提交序号。
+// 文件布局（非压缩外壳，按块独立 zlib 压缩，回放时 mmap 按需解压）：
+//   OracleTraceHeader | 各块 zlib 数据 | OracleTraceChunk x chunk_count
+// ============================================================
+
+constexpr uint32_t kOracleTraceMagic = 0x0052544fu; // "OTR\0" little-endian
+constexpr uint32_t kOracleTraceVersion = 1u;
+constexpr uint32_t kOracleTraceChunkRecords = 1u << 16;
+
+enum OracleTraceFlag : uint8_t {
+  kOtBr = 1u << 0,        // 条件分支/JAL/JALR
+  kOtTaken = 1u << 1,     // 分支实际跳转
+  kOtException = 1u << 2, // 异常（含取指页故障）
+  kOtCsr = 1u << 3,       // CSR/xret 等需要停顿取指的指令
+  kOtMmio = 1u << 4,      // MMIO load/store
+  kOtPageFaultInst = 1u << 5,
+  kOtTimer = 1u << 6,     // 读计时器，timer 字段为读到的值
+  kOtSimEnd = 1u << 7,    // ebreak/wfi 等结束点
+};
+
+struct OracleTraceHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t start_pc;
+  uint32_t chunk_records; // 每块记录数（最后一块可不足）
+  uint64_t record_count;
+  uint64_t index_offset; // OracleTraceChunk 表在文件中的偏移
+  uint32_t chunk_count;
+  uint32_t gpr_hash; // 起点 GPR 的 FNV-1a，回放时校验起点一致
+};
+
+struct OracleTraceRecord {
+  uint32_t pc;
+  uint32_t inst;
+  uint32_t next_pc;
+  uint32_t timer;
+  uint8_t flags;
+  uint8_t reserved[3];
+};
+
+struct OracleTraceChunk {
+  uint64_t offset;
+  uint32_t comp_bytes;
+  uint32_t records;
+};
+
+static_assert(sizeof(OracleTraceHeader) == 40 && sizeof(OracleTraceRecord) == 20 &&
+                  sizeof(OracleTraceChunk) == 16,
+              "oracle trace on-disk layout changed");
+
+uint32_t oracle_trace_gpr_hash(const uint32_t *gpr);
+
+class OracleTraceWriter {
+public:
+  ~OracleTraceWriter() { close(); }
+  bool open(const std::string &path, uint32_t start_pc, uint32_t gpr_hash);
+  // 写出剩余记录与块索引并回填文件头。
+  void close();
+
+  void push(const OracleTraceRecord &rec) {
+    buf_.push_back(rec);
+    if (buf_.size() == kOracleTraceChunkRecords) {
+      flush_chunk();
+    }
+  }
+  uint64_t record_count() const { return header_.record_count + buf_.size(); }
+
+private:
+  void flush_chunk();
+
+  FILE *out_ = nullptr;
+  OracleTraceHeader header_ = {};
+  std::vector<OracleTraceRecord> buf_;
+  std::vector<OracleTraceChunk> index_;
+  std::vector<uint8_t> comp_;
+};
+
+class OracleTraceReader {
+public:
+  ~OracleTraceReader() { close(); }
+  // mmap 并校验文件头与块索引；失败时 error() 给出原因。
+  bool open(const std::string &path);
+  void close();
+  bool is_open() const { return base_ != nullptr; }
+
+  uint64_t size() const { return header_.record_count; }
+  const OracleTraceHeader &header() const { return header_; }
+  const std::string &error() const { return error_; }
+
+  // 随机访问第 idx 条记录（idx < size()），只在跨块时解压。
+  const OracleTraceRecord &at(uint64_t idx) {
+    const uint64_t chunk = idx / header_.chunk_records;
+    if (chunk != cur_chunk_) {
+      load_chunk(chunk);
+    }
+    return chunk_buf_[idx - chunk * header_.chunk_records];
+  }
+
+private:
+  void load_chunk(uint64_t chunk);
+
+  const uint8_t *base_ = nullptr;
+  size_t map_bytes_ = 0;
+  OracleTraceHeader header_ = {};
+  const OracleTraceChunk *index_ = nullptr;
+  uint64_t cur_chunk_ = UINT64_MAX;
+  std::vector<OracleTraceRecord> chunk_buf_;
+  std::string error_;
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
+
+// ============================================================
+// SimPoint 基本块向量（BBV）采集
+//
+// REF 模式下由 RefCpu::run() 逐条调用 step()：跳转/分支指令或 PC 不连续
+// （trap/xret）结束当前基本块。基本块以入口 PC 编号（首次出现顺序，从 1
+// 开始），每个区间输出一行 SimPoint 格式：
+//   T:<bb_id>:<指令数> :<bb_id>:<指令数> ...
+// 区间边界由调用方按指令数对齐后调用 end_interval()；跨边界的基本块按
+// 已执行指令数拆分到前后两个区间。路径以 ".gz" 结尾时写 gzip。
+// ============================================================
+class SimPointBbv {
+public:
+  bool open(const std::string &path);
+  void close();
+
+  // inst 为展开后的指令字，len 为指令字节数（压缩指令为 2）。
+  void step(uint32_t pc, uint32_t next_pc, uint32_t inst, uint32_t len) {
+    ++bb_len_;
+    const uint32_t opcode = inst & 0x7f;
+    if (next_pc != pc + len || opcode == 0x63 || opcode == 0x6f ||
+        opcode == 0x67) {
+      end_bb();
+      bb_start_ = next_pc;
+    }
+  }
+
+  // 结束当前区间并写出一行（空区间不输出）。
+  void end_interval();
+  void reset_start(uint32_t pc) { bb_start_ = pc; }
+
+  uint64_t interval_count() const { return intervals_; }
+  size_t bb_count() const { return bb_ids_.size(); }
+
+private:
+  void end_bb();
+
+  gzFile out_ = nullptr;
+  uint32_t bb_start_ = 0;
+  uint64_t bb_len_ = 0;
+  uint64_t intervals_ = 0;
+  std::unordered_map<uint32_t, uint32_t> bb_ids_; // 入口 PC -> bb_id
+  std::vector<uint64_t> counts_;                  // 下标 bb_id
+  std::vector<uint32_t> touched_;                 // 本区间出现过的 bb_id
+};
@@ -1,16 +1,103 @@
 #pragma once
 #include "ref.h"
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
 
 enum { DIFFTEST_TO_DUT, DIFFTEST_TO_REF };
 
-extern CPU_state dut_cpu;
 class SimContext;
 
-void init_difftest(int);
-void init_diff_ckpt(CPU_state ckpt_state);
-void get_state(CPU_state &dut_state, uint8_t &privilege);
-void difftest_step(bool);
-void difftest_skip();
-uint64_t difftest_get_oracle_timer();
-void difftest_dump_memory_line(const char *tag, uint32_t addr);
+constexpr uint64_t DIFFTEST_ASYNC_RING_SIZE = 4096; // 2 的幂
+// 完整 CPU_state 快照环（skip / CSR 变化 / 异常时入环），2 的幂
+constexpr uint64_t DIFFTEST_ASYNC_SNAP_SIZE = 256;
+
+enum DiffRecordFlag : uint8_t {
+  DIFF_REC_SKIP = 1u << 0,
+  DIFF_REC_CHECK = 1u << 1, // 置 0：只推进参考模型，不比对（宏融合 uop 的第一条）
+  DIFF_REC_STORE = 1u << 2,
+  DIFF_REC_PF_INST = 1u << 3,
+  DIFF_REC_PF_LOAD = 1u << 4,
+  DIFF_REC_PF_STORE = 1u << 5,
+  DIFF_REC_FULL = 1u << 6, // 按序对应快照环中的下一项，覆盖校验线程的 DUT 镜像
+};
+
+// 异步 difftest 的单条提交记录：只带本条指令的增量，校验线程把它叠加到自己
+// 维护的 DUT 架构状态镜像上再比对。
+struct DiffCommitRecord {
+  long long cycle;
+  uint32_t pc; // 提交后的下一条 PC
+  uint32_t commit_pc;
+  uint32_t instruction;
+  uint32_t rd_val;
+  uint32_t store_addr;
+  uint32_t store_data;
+  uint32_t store_strb;
+  uint8_t rd; // 0：无 GPR 写回
+  uint8_t flags;
+};
+
+struct DiffCommitRing;
+
+// 每个 SimCpu 一份：参考模型 ref_cpu、DUT 提交镜像 dut_cpu 与异步校验线程。
+class Difftest {
+public:
+  explicit Difftest(SimContext *ctx);
+  ~Difftest();
+  Difftest(const Difftest &) = delete;
+  Difftest &operator=(const Difftest &) = delete;
+
+  CPU_state dut_cpu{};
+  RefCpu ref_cpu;
+
+  void init(int img_size);
+  void init_ckpt(CPU_state ckpt_state, uint8_t privilege);
+  void get_state(CPU_state &dut_state, uint8_t &privilege);
+  // 以 v3 格式写出 ref_cpu 当前状态（含特权级），供 CKPT 模式恢复。
+  void save_checkpoint(const std::string &path, uint64_t interval_inst_count);
+  void step(bool check);
+  void skip();
+
+  // 异步 difftest：提交路径只把本条指令的增量（PC、指令字、rd 写回、store、
+  // 异常位）写入 SPSC 提交记录环；skip、CSR 变化与异常时另把完整 dut_cpu
+  // 写入快照环。REF 执行与比对由校验线程完成。环满时提交路径等待，因此校验
+  // 线程最多落后 DIFFTEST_ASYNC_RING_SIZE 条指令；主循环每拍 poll，发现分歧
+  // 后打印与同步模式相同的现场并停止仿真。
+  void async_start();
+  bool async_active() const { return async_on_; }
+  // rd 为本条指令写回的架构寄存器（0 表示不写回），其值取自 dut_cpu.gpr。
+  void async_push(bool skip, bool check, int rd);
+  // 已发现分歧时打印现场并返回 true。
+  bool async_poll();
+  // 排空环并回收校验线程；发现分歧时打印现场并返回 false。
+  bool async_finish();
+  // 回收校验线程，不报告分歧（析构与进程退出路径）。
+  void async_join();
+
+private:
+  bool regs_match(const CPU_state &dut) const;
+  void report_mismatch(const CPU_state &dut, long long cycle);
+  void ref_step(const CPU_state &dut);
+  void ref_skip(const CPU_state &dut);
+  void seed_ref_io_from_backing();
+  void dump_code_line_snapshot(const char *tag, uint32_t pc) const;
+  void checker_main();
+  void report_async_fault();
+  bool async_wait_room(const std::atomic<uint64_t> &tail, uint64_t &tail_cache,
+                       uint64_t head, uint64_t size);
+
+  SimContext *ctx_;
+  std::unique_ptr<DiffCommitRing> ring_;
+  std::thread checker_;
+  bool async_on_ = false;
+  std::atomic<bool> async_stop_{false};
+  std::atomic<bool> async_diverged_{false};
+  // 提交路径上一次入快照环时的 CSR，用于判断本条指令是否改写了 CSR。
+  uint32_t async_csr_[CSR_NUM] = {};
+  bool async_need_full_ = true;
+  // 校验线程维护的 DUT 架构状态镜像；分歧时即为比对现场。
+  CPU_state chk_dut_{};
+  long long fault_cycle_ = 0;
+};
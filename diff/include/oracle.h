@@ -1,8 +1,79 @@
 #pragma once
+#include "OracleTrace.h"
 #include "ref.h"
 #include <cstdint>
-void get_oracle(struct front_top_in &in, struct front_top_out &out);
-void init_oracle(int img_size);
-void init_oracle_ckpt(CPU_state ckpt_state, uint8_t privilege);
-uint64_t get_oracle_timer();
-void push_oracle_timer(uint32_t val);
+#include <deque>
+#include <queue>
+#include <string>
+
+class SimContext;
+struct front_top_in;
+struct front_top_out;
+
+// 每个 SimCpu 一份的 oracle 前端：领先提交点执行的 RefCpu、计时器 FIFO、
+// trace 回放游标与 store 回滚日志。
+class Oracle {
+public:
+  Oracle(SimContext *ctx, const CPU_state *dut_cpu);
+  Oracle(const Oracle &) = delete;
+  Oracle &operator=(const Oracle &) = delete;
+
+  // 计时器 MMIO 读值 FIFO：ref_cpu 与 oracle 执行时压入，DUT 读计时器时弹出。
+  std::queue<uint32_t> timer_queue;
+
+  void fetch(front_top_in &in, front_top_out &out);
+  void init(int img_size);
+  void init_ckpt(CPU_state ckpt_state, uint8_t privilege);
+  uint64_t pop_timer();
+  // trace 驱动模式：在 init*/cpu.init() 之前打开 trace，之后不再初始化
+  // oracle RefCpu；retire() 每拍报告提交条数，用于 refetch 重定位。
+  void set_trace(const std::string &path);
+  void retire(int n);
+  // 从当前 oracle 状态（O3 起点）录制至多 max_inst 条，返回实际条数。
+  uint64_t record_trace(const std::string &path, uint64_t max_inst);
+
+private:
+  // oracle 的一次 exec()：在线模式现场执行，trace 模式读取记录。
+  struct Step {
+    uint32_t pc;
+    uint32_t inst;
+    uint32_t next_pc;
+    uint8_t flags;
+  };
+
+  uint8_t exec_flags() const;
+  void live_step(Step &step);
+  bool trace_step(Step &step);
+  void undo_reset();
+  void undo_retire(int n);
+  void undo_rollback();
+  void trace_reset();
+  [[noreturn]] void trace_desync(const char *what, uint32_t expect,
+                                 uint32_t got) const;
+  void trace_refetch(const front_top_in &in);
+  void seed_io_from_backing();
+  void sync_control_state(const front_top_in &in);
+  bool gpr_matches_dut() const;
+  void sync_arch_state_from_dut(const front_top_in &in);
+  void clear_timer_queue();
+
+  SimContext *ctx_;
+  const CPU_state *dut_cpu_;
+  RefCpu ref_;
+  bool stall_ = false;
+
+  // trace 驱动模式：不初始化/执行 oracle RefCpu，取指组来自预录 trace。
+  OracleTraceReader trace_;
+  bool trace_on_ = false;
+  uint64_t trace_fetch_pos_ = 0;  // 下一条取指对应的记录下标
+  uint64_t trace_commit_pos_ = 0; // 自 O3 起点已提交的指令数
+  uint64_t trace_timer_pos_ = 0;  // 已回灌计时器值的记录上界
+  bool trace_end_ = false;        // 取到 sim_end 记录或 trace 用尽
+
+  // 在线模式：oracle 领先提交点执行，后端可能在普通指令处 refetch
+  // （MMIO / 访存顺序违例的 flush_pipe）。记录每个未提交 step 的 store
+  // 旧值，refetch 时逆序撤销，使 oracle 内存回到提交点。
+  std::deque<RefStoreUndo> undo_log_;
+  uint64_t undo_head_ = 0;             // 日志首项的绝对序号
+  std::deque<uint64_t> undo_step_pos_; // 各未提交 step 的日志起点
+};
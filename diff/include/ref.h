@@ -2,7 +2,10 @@
 #include "config.h"
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <queue>
 #include <unordered_map>
+#include <vector>
 
 #define RISCV_MODE_U 0b00
 #define RISCV_MODE_S 0b01
@@ -84,11 +87,82 @@ typedef struct CPU_state {
   uint32_t reserve_addr;
 } CPU_state;
 
+// RefCpu::run() 的停止条件（位或）。sim_end（EBREAK，或 ref_only 下的 WFI）
+// 与指令数耗尽总是停止。
+enum RefRunFlag : uint32_t {
+  REF_RUN_STOP_WFI = 1u << 0,  // 执行 WFI 后返回（非 ref_only 时 WFI 按 NOP 推进）
+  REF_RUN_STOP_MMIO = 1u << 1, // 执行 MMIO load/store 后返回
+  REF_RUN_STOP_UART = 1u << 2, // 写 UART THR 后返回
+  REF_RUN_TICK_SIM_TIME = 1u << 3, // 每条指令后 *sim_clock++（REF_ONLY 计时语义）
+};
+
+class RefCpu;
+class SimPointBbv;
+class BranchTraceWriter;
+struct RefDecodedInst;
+using RefExecFn = void (RefCpu::*)(const RefDecodedInst &);
+
+// 预译码指令：按物理 PC 直接映射缓存，保存译码后的字段与执行函数。
+// exec == nullptr 表示需走 RISCV() 完整路径（SYSTEM/AMO/浮点）。
+struct RefDecodedInst {
+  uint32_t tag; // 物理 PC；kRefDecodeInvalidTag 表示空
+  uint32_t inst; // 压缩指令为展开后的 32 位指令字
+  uint32_t raw;  // 取指原始位（压缩指令为低 16 位）
+  uint8_t len;   // 指令字节数：2 或 4
+  uint32_t imm;
+  uint8_t rd;
+  uint8_t rs1;
+  uint8_t rs2;
+  uint8_t funct3;
+  uint8_t funct7;
+  RefExecFn exec;
+};
+
+constexpr uint32_t kRefDecodeInvalidTag = 0x1u; // 奇地址，不可能是 PC
+constexpr int REF_DECODE_CACHE_SIZE = 1 << 15; // 2 的幂
+#ifdef CONFIG_RVC
+constexpr int REF_DECODE_IDX_SHIFT = 1; // 指令按半字对齐
+#else
+constexpr int REF_DECODE_IDX_SHIFT = 2;
+#endif
+
+// 软件 TLB 表项：按 4KB 粒度缓存“成功”的 Sv32 翻译（大页按 4KB 切片缓存）。
+// 页故障从不缓存，总是重新遍历页表，因此报告的故障与逐次遍历完全一致。
+struct RefTlbEntry {
+  uint32_t gen; // 等于 RefCpu::tlb_gen 时有效
+  uint32_t vpn;
+  uint16_t asid;
+  uint8_t priv; // 有效特权级（已计入 MPRV/MPP）
+  uint8_t type; // 0 取指 / 1 load / 2 store
+  uint32_t ppage;
+};
+
+constexpr int REF_TLB_SIZE = 1 << 12; // 2 的幂
+
+// store_word 覆盖前的旧字：在线 oracle 据此把超前执行的 store 回滚到提交点。
+struct RefStoreUndo {
+  uint32_t addr;
+  uint32_t old;
+};
+
 class RefCpu {
 public:
+  RefCpu() = default;
+  ~RefCpu();
+  RefCpu(const RefCpu &) = delete;
+  RefCpu &operator=(const RefCpu &) = delete;
+
+  // RAM 为 PhysMemory 镜像的写时复制视图（init() 时映射/重置）；
+  // ram_dirty_page_bits 记录自上次 init() 以来写过的 4KB 页。
   uint32_t *memory = nullptr;
+  std::vector<uint64_t> ram_dirty_page_bits;
   std::unordered_map<uint32_t, uint32_t> io_words;
-  uint32_t Instruction;
+  // 非空时 store_word 先把被覆盖的旧字追加到此日志（仅在线 oracle 使用）。
+  std::deque<RefStoreUndo> *store_undo = nullptr;
+  uint32_t Instruction; // 当前指令（压缩指令为展开后的 32 位指令字）
+  uint32_t inst_raw;    // 取指原始位，送 oracle 前端
+  uint32_t inst_len;    // 当前指令字节数，顺序 next_pc / 链接地址用
+  uint32_t inst_fault_va; // 取指缺页的出错地址（跨页指令可能是 pc + 2）
   CPU_state state;
   uint8_t privilege;
   bool asy;
@@ -112,9 +186,23 @@ public:
   bool sim_end = false;
   bool uart_print = false;
   uint64_t oracle_timer = 0;
+  // 异步 difftest 校验线程上置位：计时器 MMIO 读取提交记录携带的周期戳，
+  // 且不回灌 Oracle 计时 FIFO（该 FIFO 由仿真主线程独占）。
+  bool async_checker = false;
+  long long commit_cycle = 0;
+  // 所属仿真实例的周期计数与 Oracle 计时 FIFO，由 Difftest / Oracle 构造时绑定。
+  long long *sim_clock = nullptr;
+  std::queue<uint32_t> *timer_sink = nullptr;
 
   void init(uint32_t reset_pc);
   void exec();
+  // 连续执行至多 n 条指令，返回实际执行条数（含触发停止的那一条）。
+  // 供 FAST 快进、CKPT prewarm 与 REF_ONLY 使用：不进行 difftest 侧带同步。
+  uint64_t run(uint64_t n, uint32_t flags = 0);
+  // 非空时 run() 逐条把 (pc, next_pc, inst) 交给 BBV 采集器。
+  SimPointBbv *bbv = nullptr;
+  // 非空时 run() 逐条把控制流信息交给分支 trace 记录器（bpu_eval 输入）。
+  BranchTraceWriter *br_trace = nullptr;
   void RISCV();
   void RV32IM();
   void RV32A();
@@ -123,10 +211,47 @@ public:
   void exception(uint32_t trap_val);
   void store_data();
   uint32_t load_word(uint32_t addr) const;
+  uint32_t load_half(uint32_t addr) const;
   void store_word(uint32_t addr, uint32_t data);
   bool va2pa_fix(uint32_t &p_addr, uint32_t v_addr, uint32_t type);
   bool va2pa(uint32_t &p_addr, uint32_t v_addr, uint32_t type);
 
+  // 预译码缓存：store_word 精确失效被覆盖的字，fence.i / init 整体清空。
+  // 直接改写 memory/io_words 的外部路径（快照恢复等）须调用 flush_decode_cache()。
+  std::vector<RefDecodedInst> decode_cache;
+  void flush_decode_cache();
+  const RefDecodedInst &fetch_decoded(uint32_t p_addr);
+  void exec_decoded(const RefDecodedInst &d);
+#ifdef CONFIG_RVC
+  void exec_page_cross();
+#endif
+
+  // 软件 TLB：satp 或 MSTATUS.SUM/MXR/MPRV 与快照不一致时整体失效（覆盖 CSR
+  // 写、trap/xret 与外部状态同步等所有修改路径）；sfence.vma 整体失效；
+  // store 命中被缓存翻译引用过的页表页时整体失效。
+  std::vector<RefTlbEntry> tlb;
+  uint32_t tlb_gen = 1;
+  uint32_t tlb_satp = 0;
+  uint32_t tlb_mstatus = 0;
+  std::vector<uint64_t> tlb_pte_page_bits;
+  std::vector<uint32_t> tlb_pte_pages;
+  void flush_tlb();
+  bool va2pa_walk(uint32_t &p_addr, uint32_t v_addr, uint32_t type,
+                  uint32_t pte_addr[2], int &pte_num);
+
+  // RV32IM 各 opcode 的执行函数（由预译码表分派）
+  void rv32_lui(const RefDecodedInst &d);
+  void rv32_auipc(const RefDecodedInst &d);
+  void rv32_jal(const RefDecodedInst &d);
+  void rv32_jalr(const RefDecodedInst &d);
+  void rv32_branch(const RefDecodedInst &d);
+  void rv32_load(const RefDecodedInst &d);
+  void rv32_store(const RefDecodedInst &d);
+  void rv32_op_imm(const RefDecodedInst &d);
+  void rv32_op(const RefDecodedInst &d);
+  void rv32_fence(const RefDecodedInst &d);
+  void rv32_default(const RefDecodedInst &d);
+
   bool is_br;
   bool br_taken;
 
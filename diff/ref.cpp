@@ -2,7 +2,11 @@
 #include "Csr.h"
 #include "RISCV.h"
 #include "config.h"
-#include "oracle.h"
+#include "PhysMemory.h"
+#include "RVC.h"
+#include "SimPoint.h"
+#include "BranchTrace.h"
+#include "SoftfloatGuard.h"
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -13,6 +17,8 @@ extern "C" {
 constexpr uint32_t kRamBase = 0x80000000u;
 constexpr uint32_t kRamUpperBound = 0xC0000000u;
 constexpr uint32_t kRamSizeBytes = kRamUpperBound - kRamBase;
+static_assert(kRamSizeBytes == RAM_SIZE && kRamBase == PMEM_RAM_BASE,
+              "RefCpu RAM window must match the PhysMemory image");
 
 inline int effective_data_privilege(const CPU_state &state, uint8_t privilege) {
   const uint32_t mstatus = state.csr[csr_mstatus];
@@ -69,6 +75,8 @@ inline bool is_modeled_mmio_addr(uint32_t paddr) {
          is_mmio_range(paddr, PLIC_ADDR_BASE, PLIC_MMIO_SIZE);
 } // namespace
 
+static RefDecodedInst decode_inst(uint32_t inst);
+
 // ---------------- 辅助工具 ----------------
 static inline float32_t to_f32(uint32_t v) {
   float32_t f;
@@ -195,15 +203,20 @@ uint32_t f32_classify(float32_t f) {
   return res;
 }
 
+RefCpu::~RefCpu() { pmem_view_unmap(memory); }
+
 void RefCpu::init(uint32_t reset_pc) {
   state.pc = reset_pc;
-  if (memory != nullptr) {
-    free(memory);
-    memory = nullptr;
-  }
-  const uint32_t ram_words = kRamSizeBytes / sizeof(uint32_t);
-  memory = (uint32_t *)calloc(ram_words, sizeof(uint32_t));
-  Assert(memory != nullptr && "RefCpu::init: memory allocation failed");
+  memory = pmem_view_map(memory);
+  ram_dirty_page_bits.assign(kRamSizeBytes / 4096 / 64, 0);
+  decode_cache.resize(REF_DECODE_CACHE_SIZE);
+  flush_decode_cache();
+  tlb.assign(REF_TLB_SIZE, RefTlbEntry{});
+  tlb_gen = 1;
+  tlb_satp = 0;
+  tlb_mstatus = 0;
+  tlb_pte_page_bits.assign(kRamSizeBytes / 4096 / 64, 0);
+  tlb_pte_pages.clear();
   io_words.clear();
   for (int i = 0; i < 32; i++) {
     state.gpr[i] = 0;
@@ -213,6 +226,12 @@ void RefCpu::init(uint32_t reset_pc) {
     state.csr[i] = 0;
   }
   state.csr[csr_misa] = 0x40141103;
+#ifdef CONFIG_RVC
+  state.csr[csr_misa] |= 1u << 2; // C
+#endif
+  inst_raw = 0;
+  inst_len = 4;
+  inst_fault_va = 0;
   privilege = 0b11;
 
   state.store = false;
@@ -244,30 +263,126 @@ void RefCpu::exec() {
   uint32_t p_addr = state.pc;
 
   if ((state.csr[csr_satp] & 0x80000000) && privilege != 3) {
+#ifdef CONFIG_RVC
+    if ((state.pc & 0xfffu) == 0xffeu) {
+      exec_page_cross();
+      return;
+    }
+#endif
     page_fault_inst = !va2pa_fix(p_addr, state.pc, 0);
 
     if (page_fault_inst) {
+      inst_fault_va = state.pc;
       exception(state.pc);
       return;
-    } else {
-      Instruction = load_word(p_addr);
     }
-  } else {
-    Instruction = load_word(p_addr);
+  }
+
+  exec_decoded(fetch_decoded(p_addr));
+}
+
+void RefCpu::exec_decoded(const RefDecodedInst &d) {
+  Instruction = d.inst;
+  inst_raw = d.raw;
+  inst_len = d.len;
+  if (d.len == 2 && d.inst == 0) {
+    illegal_exception = true;
   }
 
   if (Instruction == INST_EBREAK) {
-    state.pc += 4;
+    state.pc += inst_len;
     sim_end = true;
     return;
   }
 
+  // 快速路径：非 SYSTEM/AMO/浮点指令且无 pending&enabled 中断时，RISCV() 的
+  // 陷入判定必然为假，直接按预译码结果执行。
+  if (d.exec != nullptr &&
+      (state.csr[csr_mip] & state.csr[csr_mie]) == 0) {
+    M_software_interrupt = M_timer_interrupt = M_external_interrupt = false;
+    S_software_interrupt = S_timer_interrupt = S_external_interrupt = false;
+    (this->*d.exec)(d);
+    state.gpr[0] = 0;
+    return;
+  }
+
   RISCV();
 }
 
+#ifdef CONFIG_RVC
+// 取指 PC 位于页内最后一个半字：若为 32 位指令，高半部落在下一页，需单独
+// 翻译；高半部缺页时 mepc 仍指向指令首地址，tval 为高半部地址 pc + 2。
+// 两半物理地址不连续，这类指令不进预译码缓存。
+void RefCpu::exec_page_cross() {
+  uint32_t p_lo = state.pc;
+  if (!va2pa(p_lo, state.pc, 0) || rvc_is_compressed(load_half(p_lo))) {
+    page_fault_inst = !va2pa_fix(p_lo, state.pc, 0);
+    if (page_fault_inst) {
+      inst_fault_va = state.pc;
+      exception(state.pc);
+      return;
+    }
+    exec_decoded(fetch_decoded(p_lo));
+    return;
+  }
+
+  uint32_t p_hi = state.pc + 2;
+  page_fault_inst = !va2pa_fix(p_hi, state.pc + 2, 0);
+  if (page_fault_inst) {
+    inst_fault_va = state.pc + 2;
+    exception(state.pc + 2);
+    return;
+  }
+  const uint32_t inst = load_half(p_lo) | (load_half(p_hi) << 16);
+  RefDecodedInst d = decode_inst(inst);
+  d.tag = kRefDecodeInvalidTag;
+  exec_decoded(d);
+}
+#endif
+
+uint64_t RefCpu::run(uint64_t n, uint32_t flags) {
+  dut_expect_pf_inst = dut_expect_pf_load = dut_expect_pf_store = false;
+  const bool stop_wfi = flags & REF_RUN_STOP_WFI;
+  const bool stop_mmio = flags & REF_RUN_STOP_MMIO;
+  const bool stop_uart = flags & REF_RUN_STOP_UART;
+  const bool tick = flags & REF_RUN_TICK_SIM_TIME;
+
+  uint64_t done = 0;
+  while (done < n) {
+    const uint32_t pc = state.pc;
+    exec();
+    done++;
+    if (__builtin_expect(bbv != nullptr, 0)) {
+      bbv->step(pc, state.pc, Instruction, inst_len);
+    }
+    if (__builtin_expect(br_trace != nullptr, 0)) {
+      br_trace->step(pc, state.pc, Instruction, inst_len);
+    }
+    if (tick) {
+      (*sim_clock)++;
+    }
+    if (__builtin_expect(sim_end, 0)) {
+      break;
+    }
+    if (__builtin_expect(flags == 0 || flags == REF_RUN_TICK_SIM_TIME, 1)) {
+      continue;
+    }
+    if (stop_wfi && Instruction == INST_WFI) {
+      break;
+    }
+    if (stop_mmio && (is_mmio_load || is_mmio_store)) {
+      break;
+    }
+    if (stop_uart && state.store && state.store_addr == UART_ADDR_BASE) {
+      break;
+    }
+  }
+  return done;
+}
+
 void RefCpu::exception(uint32_t trap_val) {
   is_exception = true;
-  uint32_t next_pc = state.pc + 4;
+  uint32_t next_pc = state.pc + inst_len;
 
   // 重新获取当前状态（因为exec可能没传进来最新的）
   bool ecall = (Instruction == INST_ECALL);
@@ -564,7 +679,7 @@ void RefCpu::RISCV() {
   // - 在其它模式下不触发断言，按 NOP 语义推进 PC，避免 reference 路径异常中断。
   if (Instruction == INST_WFI && !asy && !page_fault_inst && !page_fault_load &&
       !page_fault_store) {
-    state.pc += 4;
+    state.pc += inst_len;
     if (ref_only) {
       sim_end = true;
     }
@@ -574,7 +689,7 @@ void RefCpu::RISCV() {
   if (page_fault_inst) {
     exception(state.pc);
   } else if (illegal_exception) {
-    exception(Instruction);
+    exception(inst_raw);
   } else if (asy || Instruction == INST_ECALL) {
     exception(0);
   } else if (opcode == number_10_opcode_ecall) {
@@ -592,6 +707,7 @@ void RefCpu::RISCV() {
              opcode == number_15_opcode_fnmsub ||
              opcode == number_16_opcode_fnmadd ||
              opcode == number_14_opcode_fmsub) {
+    SoftfloatGuard softfloat_guard;
     RV32Zfinx();
   } else {
     RV32IM();
@@ -601,7 +717,7 @@ void RefCpu::RISCV() {
 
 void RefCpu::RV32Zfinx() {
 
-  uint32_t next_pc = state.pc + 4;
+  uint32_t next_pc = state.pc + inst_len;
   // 1. 解码基础字段
   uint32_t opcode = Instruction & 0x7F;
   uint32_t rd = (Instruction >> 7) & 0x1F;
@@ -819,8 +935,7 @@ skip_flags_update:
 }
 
 void RefCpu::RV32CSR() {
-  // pc + 4
-  uint32_t next_pc = state.pc + 4;
+  uint32_t next_pc = state.pc + inst_len;
 
   // 使用宏直接提取，无需 copy_indice
   uint32_t rd = BITS(Instruction, 11, 7);
@@ -830,6 +945,10 @@ void RefCpu::RV32CSR() {
 
   uint32_t reg_rdata1 = state.gpr[rs1];
 
+  if (funct3 == 0 && BITS(Instruction, 31, 25) == 0b0001001) {
+    flush_tlb(); // sfence.vma：其余按 NOP 处理
+  }
+
   bool we = funct3 == 1 || rs1 != 0;
   bool re = funct3 != 1 || rd != 0;
   uint32_t wcmd = funct3 & 0b11;
@@ -936,8 +1055,7 @@ void RefCpu::RV32CSR() {
 }
 
 void RefCpu::RV32A() {
-  // pc + 4
-  uint32_t next_pc = state.pc + 4;
+  uint32_t next_pc = state.pc + inst_len;
   uint32_t funct5 = BITS(Instruction, 31, 27);
   uint32_t reg_d_index = BITS(Instruction, 11, 7);
   uint32_t reg_a_index = BITS(Instruction, 19, 15);
@@ -1065,501 +1183,675 @@ void RefCpu::RV32A() {
   state.pc = next_pc;
 }
 
+// 预译码：提取字段与立即数，并按 opcode 选定执行函数。
+// SYSTEM/AMO/浮点返回 exec == nullptr，由 RISCV() 完整路径处理。
+static RefDecodedInst decode_inst(uint32_t inst) {
+  RefDecodedInst d;
+  d.tag = kRefDecodeInvalidTag;
+  d.inst = inst;
+  d.raw = inst;
+  d.len = 4;
+  d.imm = 0;
+  d.rd = BITS(inst, 11, 7);
+  d.rs1 = BITS(inst, 19, 15);
+  d.rs2 = BITS(inst, 24, 20);
+  d.funct3 = BITS(inst, 14, 12);
+  d.funct7 = BITS(inst, 31, 25);
+  d.exec = &RefCpu::rv32_default;
+
+  switch (BITS(inst, 6, 0)) {
+  case number_0_opcode_lui:
+    d.imm = immU(inst);
+    d.exec = &RefCpu::rv32_lui;
+    break;
+  case number_1_opcode_auipc:
+    d.imm = immU(inst);
+    d.exec = &RefCpu::rv32_auipc;
+    break;
+  case number_2_opcode_jal:
+    d.imm = immJ(inst);
+    d.exec = &RefCpu::rv32_jal;
+    break;
+  case number_3_opcode_jalr:
+    d.imm = immI(inst);
+    d.exec = &RefCpu::rv32_jalr;
+    break;
+  case number_4_opcode_beq:
+    d.imm = immB(inst);
+    d.exec = &RefCpu::rv32_branch;
+    break;
+  case number_5_opcode_lb:
+    d.imm = immI(inst);
+    d.exec = &RefCpu::rv32_load;
+    break;
+  case number_6_opcode_sb:
+    d.imm = immS(inst);
+    d.exec = &RefCpu::rv32_store;
+    break;
+  case number_7_opcode_addi:
+    d.imm = immI(inst);
+    d.exec = &RefCpu::rv32_op_imm;
+    break;
+  case number_8_opcode_add:
+    d.exec = &RefCpu::rv32_op;
+    break;
+  case number_9_opcode_fence:
+    d.exec = &RefCpu::rv32_fence;
+    break;
+  case number_10_opcode_ecall:
+  case number_11_opcode_lrw:
+  case number_12_opcode_float:
+  case number_13_opcode_fmadd:
+  case number_14_opcode_fmsub:
+  case number_15_opcode_fnmsub:
+  case number_16_opcode_fnmadd:
+    d.exec = nullptr;
+    break;
+  default:
+    break;
+  }
+  return d;
+}
+
+void RefCpu::flush_decode_cache() {
+  for (auto &entry : decode_cache) {
+    entry.tag = kRefDecodeInvalidTag;
+  }
+}
+
+// 取指原始位 -> 预译码项。保留 / 非法压缩编码展开为 0，清空 exec 以走
+// RISCV() 完整路径报非法指令异常。
+static RefDecodedInst decode_fetched(uint32_t raw) {
+#ifdef CONFIG_RVC
+  if (rvc_is_compressed(raw)) {
+    RefDecodedInst d = decode_inst(rvc_expand(raw));
+    d.raw = raw & 0xffffu;
+    d.len = 2;
+    if (d.inst == 0) {
+      d.exec = nullptr;
+    }
+    return d;
+  }
+  return decode_inst(raw);
+#else
+  return decode_inst(raw);
+#endif
+}
+
+const RefDecodedInst &RefCpu::fetch_decoded(uint32_t p_addr) {
+  RefDecodedInst &entry =
+      decode_cache[(p_addr >> REF_DECODE_IDX_SHIFT) &
+                   (REF_DECODE_CACHE_SIZE - 1)];
+  if (entry.tag != p_addr) {
+#ifdef CONFIG_RVC
+    // 半字对齐取指；32 位指令可能跨字（物理连续，跨页情形见 exec_page_cross）
+    uint32_t raw = load_half(p_addr);
+    if (!rvc_is_compressed(raw)) {
+      raw |= load_half(p_addr + 2) << 16;
+    }
+    entry = decode_fetched(raw);
+#else
+    entry = decode_fetched(load_word(p_addr));
+#endif
+    entry.tag = p_addr;
+  }
+  return entry;
+}
+
 void RefCpu::RV32IM() {
-  // pc + 4
-  uint32_t next_pc = state.pc + 4;
-  uint32_t opcode = BITS(Instruction, 6, 0);
-  uint32_t funct3 = BITS(Instruction, 14, 12);
-  uint32_t funct7 = BITS(Instruction, 31, 25);
-  uint32_t reg_d_index = BITS(Instruction, 11, 7);
-  uint32_t reg_a_index = BITS(Instruction, 19, 15);
-  uint32_t reg_b_index = BITS(Instruction, 24, 20);
+  const RefDecodedInst d = decode_inst(Instruction);
+  (this->*d.exec)(d);
+}
 
-  uint32_t reg_rdata1 = state.gpr[reg_a_index];
-  uint32_t reg_rdata2 = state.gpr[reg_b_index];
+// lui
+void RefCpu::rv32_lui(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t reg_d_index = d.rd;
 
-  switch (opcode) {
-  case number_0_opcode_lui: { // lui
-    state.gpr[reg_d_index] = immU(Instruction);
+  state.gpr[reg_d_index] = d.imm;
+
+  state.pc = next_pc;
+}
+
+// auipc
+void RefCpu::rv32_auipc(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t reg_d_index = d.rd;
+
+  state.gpr[reg_d_index] = d.imm + state.pc;
+
+  state.pc = next_pc;
+}
+
+// jal
+void RefCpu::rv32_jal(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t reg_d_index = d.rd;
+
+  is_br = true;
+  br_taken = true;
+  next_pc = state.pc + d.imm;
+  state.gpr[reg_d_index] = state.pc + inst_len;
+
+  state.pc = next_pc;
+}
+
+// jalr
+void RefCpu::rv32_jalr(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t reg_d_index = d.rd;
+  uint32_t reg_rdata1 = state.gpr[d.rs1];
+
+  is_br = true;
+  br_taken = true;
+  next_pc = (reg_rdata1 + d.imm) & 0xFFFFFFFE;
+  state.gpr[reg_d_index] = state.pc + inst_len;
+
+  state.pc = next_pc;
+}
+
+// beq, bne, blt, bge, bltu, bgeu
+void RefCpu::rv32_branch(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t funct3 = d.funct3;
+  uint32_t reg_rdata1 = state.gpr[d.rs1];
+  uint32_t reg_rdata2 = state.gpr[d.rs2];
+
+  is_br = true;
+  switch (funct3) {
+  case 0: { // beq
+    if (reg_rdata1 == reg_rdata2) {
+      br_taken = true;
+      next_pc = (state.pc + d.imm);
+    }
     break;
   }
-  case number_1_opcode_auipc: { // auipc
-    state.gpr[reg_d_index] = immU(Instruction) + state.pc;
+  case 1: { // bne
+    if (reg_rdata1 != reg_rdata2) {
+      br_taken = true;
+      next_pc = (state.pc + d.imm);
+    }
     break;
   }
-  case number_2_opcode_jal: { // jal
-    is_br = true;
-    br_taken = true;
-    next_pc = state.pc + immJ(Instruction);
-    state.gpr[reg_d_index] = state.pc + 4;
+  case 4: { // blt
+    if ((int32_t)reg_rdata1 < (int32_t)reg_rdata2) {
+      br_taken = true;
+      next_pc = (state.pc + d.imm);
+    }
     break;
   }
-  case number_3_opcode_jalr: { // jalr
-    is_br = true;
-    br_taken = true;
-    next_pc = (reg_rdata1 + immI(Instruction)) & 0xFFFFFFFE;
-    state.gpr[reg_d_index] = state.pc + 4;
+  case 5: { // bge
+    if ((int32_t)reg_rdata1 >= (int32_t)reg_rdata2) {
+      br_taken = true;
+      next_pc = (state.pc + d.imm);
+    }
     break;
   }
-  case number_4_opcode_beq: { // beq, bne, blt, bge, bltu, bgeu
-    is_br = true;
-    switch (funct3) {
-    case 0: { // beq
-      if (reg_rdata1 == reg_rdata2) {
-        br_taken = true;
-        next_pc = (state.pc + immB(Instruction));
-      }
-      break;
+  case 6: { // bltu
+    if ((uint32_t)reg_rdata1 < (uint32_t)reg_rdata2) {
+      br_taken = true;
+      next_pc = (state.pc + d.imm);
     }
-    case 1: { // bne
-      if (reg_rdata1 != reg_rdata2) {
-        br_taken = true;
-        next_pc = (state.pc + immB(Instruction));
-      }
-      break;
-    }
-    case 4: { // blt
-      if ((int32_t)reg_rdata1 < (int32_t)reg_rdata2) {
-        br_taken = true;
-        next_pc = (state.pc + immB(Instruction));
-      }
-      break;
+    break;
+  }
+  case 7: { // bgeu
+    if ((uint32_t)reg_rdata1 >= (uint32_t)reg_rdata2) {
+      br_taken = true;
+      next_pc = (state.pc + d.imm);
     }
-    case 5: { // bge
-      if ((int32_t)reg_rdata1 >= (int32_t)reg_rdata2) {
-        br_taken = true;
-        next_pc = (state.pc + immB(Instruction));
-      }
-      break;
+    break;
+  }
+  }
+
+  state.pc = next_pc;
+}
+
+// lb, lh, lw, lbu, lhu
+void RefCpu::rv32_load(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t funct3 = d.funct3;
+  uint32_t reg_d_index = d.rd;
+  uint32_t reg_rdata1 = state.gpr[d.rs1];
+
+  uint32_t v_addr = reg_rdata1 + d.imm;
+  uint32_t p_addr = v_addr;
+  if (data_translation_enabled(state, privilege)) {
+    page_fault_load = !va2pa_fix(p_addr, v_addr, 1);
+  }
+
+  if (page_fault_load) {
+    exception(v_addr);
+    return;
+  } else {
+    uint32_t alignment_mask = (funct3 & 0x3) == 0   ? 0
+                              : (funct3 & 0x3) == 1 ? 1
+                                                    : 3;
+    Assert((p_addr & alignment_mask) == 0 && "Load address misaligned!");
+    if (is_modeled_mmio_addr(p_addr) ||
+        is_mmio_range(p_addr, OPENSBI_TIMER_BASE, OPENSBI_TIMER_MMIO_SIZE)) {
+      is_mmio_load = true;
     }
-    case 6: { // bltu
-      if ((uint32_t)reg_rdata1 < (uint32_t)reg_rdata2) {
-        br_taken = true;
-        next_pc = (state.pc + immB(Instruction));
-      }
-      break;
+    // Timer MMIO 特殊处理：使用实例周期 (非Oracle自有计数) 并推入FIFO
+    uint64_t data_l = (uint64_t)load_word(p_addr & ~0x3u);
+    uint64_t data_h = (uint64_t)load_word((p_addr & ~0x3u) + 4u);
+    uint64_t data64 = (data_h << 32) | data_l;
+
+    uint32_t data;
+    const long long now = async_checker ? commit_cycle : *sim_clock;
+    if (p_addr == OPENSBI_TIMER_LOW_ADDR) {
+      data = now;
+      if (!async_checker)
+        timer_sink->push(data);
+    } else if (p_addr == OPENSBI_TIMER_HIGH_ADDR) {
+      data = now >> 32;
+      if (!async_checker)
+        timer_sink->push(data);
+    } else {
+      data = (uint32_t)(data64 >> ((p_addr & 0b11) * 8));
     }
-    case 7: { // bgeu
-      if ((uint32_t)reg_rdata1 >= (uint32_t)reg_rdata2) {
-        br_taken = true;
-        next_pc = (state.pc + immB(Instruction));
-      }
-      break;
+    uint32_t size = funct3 & 0b11;
+    uint32_t sign = 0, mask;
+    if (size == 0) {
+      mask = 0xFF;
+      if (data & 0x80)
+        sign = 0xFFFFFF00;
+    } else if (size == 0b01) {
+      mask = 0xFFFF;
+      if (data & 0x8000)
+        sign = 0xFFFF0000;
+    } else {
+      mask = 0xFFFFFFFF;
     }
+
+    data = data & mask;
+
+    // 有符号数
+    if (!(funct3 & 0b100)) {
+      data = data | sign;
     }
-    break;
+    state.gpr[reg_d_index] = data;
   }
-  case number_5_opcode_lb: { // lb, lh, lw, lbu, lhu
-    uint32_t v_addr = reg_rdata1 + immI(Instruction);
-    uint32_t p_addr = v_addr;
-    if (data_translation_enabled(state, privilege)) {
-      page_fault_load = !va2pa_fix(p_addr, v_addr, 1);
+
+  state.pc = next_pc;
+}
+
+// sb, sh, sw
+void RefCpu::rv32_store(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t funct3 = d.funct3;
+  uint32_t reg_rdata1 = state.gpr[d.rs1];
+  uint32_t reg_rdata2 = state.gpr[d.rs2];
+
+  uint32_t v_addr = reg_rdata1 + d.imm;
+  uint32_t p_addr = v_addr;
+  if (data_translation_enabled(state, privilege)) {
+    page_fault_store = !va2pa_fix(p_addr, v_addr, 2);
+  }
+
+  if (page_fault_store) {
+    exception(v_addr);
+    return;
+  } else {
+    uint32_t alignment_mask = (funct3 & 0x3) == 0   ? 0
+                              : (funct3 & 0x3) == 1 ? 1
+                                                    : 3;
+    Assert((p_addr & alignment_mask) == 0 && "Store address misaligned!");
+    if (is_modeled_mmio_addr(p_addr) ||
+        is_mmio_range(p_addr, OPENSBI_TIMER_BASE, OPENSBI_TIMER_MMIO_SIZE)) {
+      is_mmio_store = true;
     }
 
-    if (page_fault_load) {
-      exception(v_addr);
-      return;
+    state.store = true;
+    state.store_addr = p_addr;
+    state.store_data = reg_rdata2;
+    if (funct3 == 0b00) {
+      state.store_strb = 0b1;
+      state.store_data &= 0xFF;
+    } else if (funct3 == 0b01) {
+      state.store_strb = 0b11;
+      state.store_data &= 0xFFFF;
     } else {
-      uint32_t alignment_mask = (funct3 & 0x3) == 0   ? 0
-                                : (funct3 & 0x3) == 1 ? 1
-                                                      : 3;
-      Assert((p_addr & alignment_mask) == 0 && "Load address misaligned!");
-      if (is_modeled_mmio_addr(p_addr) ||
-          is_mmio_range(p_addr, OPENSBI_TIMER_BASE, OPENSBI_TIMER_MMIO_SIZE)) {
-        is_mmio_load = true;
-      }
-      // Timer MMIO 特殊处理：使用 sim_time (非Oracle自有计数) 并推入FIFO
-      uint64_t data_l = (uint64_t)load_word(p_addr & ~0x3u);
-      uint64_t data_h = (uint64_t)load_word((p_addr & ~0x3u) + 4u);
-      uint64_t data64 = (data_h << 32) | data_l;
-
-      uint32_t data;
-      if (p_addr == OPENSBI_TIMER_LOW_ADDR) {
-        data = sim_time;
-        push_oracle_timer(data);
-      } else if (p_addr == OPENSBI_TIMER_HIGH_ADDR) {
-        data = sim_time >> 32;
-        push_oracle_timer(data);
-      } else {
-        data = (uint32_t)(data64 >> ((p_addr & 0b11) * 8));
-      }
-      uint32_t size = funct3 & 0b11;
-      uint32_t sign = 0, mask;
-      if (size == 0) {
-        mask = 0xFF;
-        if (data & 0x80)
-          sign = 0xFFFFFF00;
-      } else if (size == 0b01) {
-        mask = 0xFFFF;
-        if (data & 0x8000)
-          sign = 0xFFFF0000;
-      } else {
-        mask = 0xFFFFFFFF;
-      }
+      state.store_strb = 0b1111;
+    }
 
-      data = data & mask;
+    store_data();
+  }
 
-      // 有符号数
-      if (!(funct3 & 0b100)) {
-        data = data | sign;
+  state.pc = next_pc;
+}
+
+// addi, slti, sltiu, xori, ori, andi, slli, srli, srai, and Zbb/Zbs Immediates
+void RefCpu::rv32_op_imm(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t funct3 = d.funct3;
+  uint32_t funct7 = d.funct7;
+  uint32_t reg_d_index = d.rd;
+  uint32_t reg_b_index = d.rs2;
+  uint32_t reg_rdata1 = state.gpr[d.rs1];
+  uint32_t imm = d.imm;
+  uint32_t shamt = imm & 0x1F;
+  switch (funct3) {
+  case 0: { // addi
+    state.gpr[reg_d_index] = reg_rdata1 + imm;
+    break;
+  }
+  case 2: { // slti
+    state.gpr[reg_d_index] = (int32_t)reg_rdata1 < (int32_t)imm ? 1 : 0;
+    break;
+  }
+  case 3: { // sltiu
+    state.gpr[reg_d_index] = (uint32_t)reg_rdata1 < (uint32_t)imm ? 1 : 0;
+    break;
+  }
+  case 4: { // xori
+    state.gpr[reg_d_index] = reg_rdata1 ^ imm;
+    break;
+  }
+  case 6: { // ori
+    state.gpr[reg_d_index] = reg_rdata1 | imm;
+    break;
+  }
+  case 7: { // andi
+    state.gpr[reg_d_index] = reg_rdata1 & imm;
+    break;
+  }
+  case 1: {            // slli, bseti, bclri, binvi, clz, ctz, pcnt, sext
+    if (funct7 == 0) { // slli
+      state.gpr[reg_d_index] = reg_rdata1 << shamt;
+    } else if (funct7 == 0x30) { // Zbb Unary (clz, ctz, pcnt, sext)
+      // For OP-IMM-Unary, rs2 field (shamt) is the differentiator
+      // reg_b_index is extracted from bits 24:20 which IS the shamt field
+      // position So checking reg_b_index is correct.
+      uint32_t sub_op = reg_b_index;
+      if (sub_op == 0) { // clz
+        state.gpr[reg_d_index] =
+            (reg_rdata1 == 0) ? 32 : __builtin_clz(reg_rdata1);
+      } else if (sub_op == 1) { // ctz
+        state.gpr[reg_d_index] =
+            (reg_rdata1 == 0) ? 32 : __builtin_ctz(reg_rdata1);
+      } else if (sub_op == 2) { // pcnt
+        state.gpr[reg_d_index] = __builtin_popcount(reg_rdata1);
+      } else if (sub_op == 4) { // sext.b
+        int32_t byte_val = (int32_t)((int8_t)(reg_rdata1 & 0xFF));
+        state.gpr[reg_d_index] = (uint32_t)byte_val;
+      } else if (sub_op == 5) { // sext.h
+        int32_t half_val = (int32_t)((int16_t)(reg_rdata1 & 0xFFFF));
+        state.gpr[reg_d_index] = (uint32_t)half_val;
       }
-      state.gpr[reg_d_index] = data;
+    } else if (funct7 == 0x14) { // bseti (Zbs)
+      state.gpr[reg_d_index] = reg_rdata1 | (1u << shamt);
+    } else if (funct7 == 0x24) { // bclri (Zbs)
+      state.gpr[reg_d_index] = reg_rdata1 & ~(1u << shamt);
+    } else if (funct7 == 0x34) { // binvi (Zbs)
+      state.gpr[reg_d_index] = reg_rdata1 ^ (1u << shamt);
     }
     break;
   }
-  case number_6_opcode_sb: { // sb, sh, sw
-
-    uint32_t v_addr = reg_rdata1 + immS(Instruction);
-    uint32_t p_addr = v_addr;
-    if (data_translation_enabled(state, privilege)) {
-      page_fault_store = !va2pa_fix(p_addr, v_addr, 2);
-    }
-
-    if (page_fault_store) {
-      exception(v_addr);
-      return;
-    } else {
-      uint32_t alignment_mask = (funct3 & 0x3) == 0   ? 0
-                                : (funct3 & 0x3) == 1 ? 1
-                                                      : 3;
-      Assert((p_addr & alignment_mask) == 0 && "Store address misaligned!");
-      if (is_modeled_mmio_addr(p_addr) ||
-          is_mmio_range(p_addr, OPENSBI_TIMER_BASE, OPENSBI_TIMER_MMIO_SIZE)) {
-        is_mmio_store = true;
+  case 5: {            // srli, srai, rori, bexti, rev8, orcb
+    if (funct7 == 0) { // srli
+      state.gpr[reg_d_index] = (uint32_t)reg_rdata1 >> shamt;
+    } else if (funct7 == 0x20) { // srai
+      state.gpr[reg_d_index] = (int32_t)reg_rdata1 >> shamt;
+    } else if (funct7 == 0x30) { // rori (Zbb)
+      state.gpr[reg_d_index] =
+          (reg_rdata1 >> shamt) | (reg_rdata1 << (32 - shamt));
+    } else if (funct7 == 0x24) { // bexti (Zbs)
+      state.gpr[reg_d_index] = (reg_rdata1 >> shamt) & 1;
+    } else if (funct7 == 0x34) { // rev8 (Zbb) - shamt must be 24?
+      // Spec says rev8 encoding is fixed.
+      // But checking sub_op (shamt/rs2) is valid.
+      // rev8: rs2=24 (11000).
+      if (reg_b_index == 24) {
+        uint32_t x = reg_rdata1;
+        state.gpr[reg_d_index] = ((x & 0xFF) << 24) | ((x & 0xFF00) << 8) |
+                                 ((x & 0xFF0000) >> 8) |
+                                 ((x & 0xFF000000) >> 24);
       }
-
-      state.store = true;
-      state.store_addr = p_addr;
-      state.store_data = reg_rdata2;
-      if (funct3 == 0b00) {
-        state.store_strb = 0b1;
-        state.store_data &= 0xFF;
-      } else if (funct3 == 0b01) {
-        state.store_strb = 0b11;
-        state.store_data &= 0xFFFF;
-      } else {
-        state.store_strb = 0b1111;
+    } else if (funct7 == 0x14) { // orcb (Zbb) - shamt must be 7?
+      if (reg_b_index == 7) {
+        uint32_t x = reg_rdata1;
+        uint32_t res = 0;
+        if (x & 0xFF)
+          res |= 0xFF;
+        if (x & 0xFF00)
+          res |= 0xFF00;
+        if (x & 0xFF0000)
+          res |= 0xFF0000;
+        if (x & 0xFF000000)
+          res |= 0xFF000000;
+        state.gpr[reg_d_index] = res;
       }
-
-      store_data();
     }
-
     break;
   }
-  case number_7_opcode_addi: { // addi, slti, sltiu, xori, ori, andi, slli,
-                               // srli, srai, and Zbb/Zbs Immediates
-    uint32_t imm = immI(Instruction);
-    uint32_t shamt = imm & 0x1F;
+  }
+
+  state.pc = next_pc;
+}
+
+// add, sub, sll, slt, sltu, xor, srl, sra, or, and
+void RefCpu::rv32_op(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+  uint32_t funct3 = d.funct3;
+  uint32_t funct7 = d.funct7;
+  uint32_t reg_d_index = d.rd;
+  uint32_t reg_rdata1 = state.gpr[d.rs1];
+  uint32_t reg_rdata2 = state.gpr[d.rs2];
+  if (funct7 == 1) {        // mul div
+    int64_t s1 = (int64_t)(int32_t)reg_rdata1;
+    int64_t s2 = (int64_t)(int32_t)reg_rdata2;
+
+    uint64_t u1 = (uint32_t)reg_rdata1;
+    uint64_t u2 = (uint32_t)reg_rdata2;
+
+    // 获取 32 位操作数
+    int32_t dividend = (int32_t)reg_rdata1;
+    int32_t divisor = (int32_t)reg_rdata2;
+    uint32_t u_dividend = (uint32_t)reg_rdata1;
+    uint32_t u_divisor = (uint32_t)reg_rdata2;
+
     switch (funct3) {
-    case 0: { // addi
-      state.gpr[reg_d_index] = reg_rdata1 + imm;
+    case 0: { // mul
+      state.gpr[reg_d_index] = (int32_t)(u1 * u2);
       break;
     }
-    case 2: { // slti
-      state.gpr[reg_d_index] = (int32_t)reg_rdata1 < (int32_t)imm ? 1 : 0;
+    case 1: { // mulh
+      state.gpr[reg_d_index] = (uint32_t)((s1 * s2) >> 32);
       break;
     }
-    case 3: { // sltiu
-      state.gpr[reg_d_index] = (uint32_t)reg_rdata1 < (uint32_t)imm ? 1 : 0;
+    case 2: { // mulsu
+      state.gpr[reg_d_index] = (uint32_t)((s1 * (int64_t)u2) >> 32);
       break;
     }
-    case 4: { // xori
-      state.gpr[reg_d_index] = reg_rdata1 ^ imm;
+    case 3: { // mulhu
+      state.gpr[reg_d_index] = (uint32_t)((u1 * u2) >> 32);
       break;
     }
-    case 6: { // ori
-      state.gpr[reg_d_index] = reg_rdata1 | imm;
+    case 4: { // div (signed)
+      if (divisor == 0) {
+        state.gpr[reg_d_index] = -1; // RISC-V 规定：除以0结果为 -1
+      } else if (dividend == INT32_MIN && divisor == -1) {
+        state.gpr[reg_d_index] =
+            INT32_MIN; // RISC-V 规定：溢出时结果为被除数本身(INT_MIN)
+      } else {
+        state.gpr[reg_d_index] = dividend / divisor;
+      }
       break;
     }
-    case 7: { // andi
-      state.gpr[reg_d_index] = reg_rdata1 & imm;
+    case 5: { // divu (unsigned)
+      if (u_divisor == 0) {
+        state.gpr[reg_d_index] = 0xFFFFFFFF; // RISC-V 规定：除以0结果为最大值
+      } else {
+        state.gpr[reg_d_index] = u_dividend / u_divisor;
+      }
       break;
     }
-    case 1: {            // slli, bseti, bclri, binvi, clz, ctz, pcnt, sext
-      if (funct7 == 0) { // slli
-        state.gpr[reg_d_index] = reg_rdata1 << shamt;
-      } else if (funct7 == 0x30) { // Zbb Unary (clz, ctz, pcnt, sext)
-        // For OP-IMM-Unary, rs2 field (shamt) is the differentiator
-        // reg_b_index is extracted from bits 24:20 which IS the shamt field
-        // position So checking reg_b_index is correct.
-        uint32_t sub_op = reg_b_index;
-        if (sub_op == 0) { // clz
-          state.gpr[reg_d_index] =
-              (reg_rdata1 == 0) ? 32 : __builtin_clz(reg_rdata1);
-        } else if (sub_op == 1) { // ctz
-          state.gpr[reg_d_index] =
-              (reg_rdata1 == 0) ? 32 : __builtin_ctz(reg_rdata1);
-        } else if (sub_op == 2) { // pcnt
-          state.gpr[reg_d_index] = __builtin_popcount(reg_rdata1);
-        } else if (sub_op == 4) { // sext.b
-          int32_t byte_val = (int32_t)((int8_t)(reg_rdata1 & 0xFF));
-          state.gpr[reg_d_index] = (uint32_t)byte_val;
-        } else if (sub_op == 5) { // sext.h
-          int32_t half_val = (int32_t)((int16_t)(reg_rdata1 & 0xFFFF));
-          state.gpr[reg_d_index] = (uint32_t)half_val;
-        }
-      } else if (funct7 == 0x14) { // bseti (Zbs)
-        state.gpr[reg_d_index] = reg_rdata1 | (1u << shamt);
-      } else if (funct7 == 0x24) { // bclri (Zbs)
-        state.gpr[reg_d_index] = reg_rdata1 & ~(1u << shamt);
-      } else if (funct7 == 0x34) { // binvi (Zbs)
-        state.gpr[reg_d_index] = reg_rdata1 ^ (1u << shamt);
+    case 6: { // rem (signed)
+      if (divisor == 0) {
+        state.gpr[reg_d_index] = dividend; // RISC-V 规定：除以0，余数为被除数
+      } else if (dividend == INT32_MIN && divisor == -1) {
+        state.gpr[reg_d_index] = 0; // RISC-V 规定：溢出时，余数为 0
+      } else {
+        state.gpr[reg_d_index] = dividend % divisor;
       }
       break;
     }
-    case 5: {            // srli, srai, rori, bexti, rev8, orcb
-      if (funct7 == 0) { // srli
-        state.gpr[reg_d_index] = (uint32_t)reg_rdata1 >> shamt;
-      } else if (funct7 == 0x20) { // srai
-        state.gpr[reg_d_index] = (int32_t)reg_rdata1 >> shamt;
-      } else if (funct7 == 0x30) { // rori (Zbb)
+    case 7: { // remu (unsigned)
+      if (u_divisor == 0) {
         state.gpr[reg_d_index] =
-            (reg_rdata1 >> shamt) | (reg_rdata1 << (32 - shamt));
-      } else if (funct7 == 0x24) { // bexti (Zbs)
-        state.gpr[reg_d_index] = (reg_rdata1 >> shamt) & 1;
-      } else if (funct7 == 0x34) { // rev8 (Zbb) - shamt must be 24?
-        // Spec says rev8 encoding is fixed.
-        // But checking sub_op (shamt/rs2) is valid.
-        // rev8: rs2=24 (11000).
-        if (reg_b_index == 24) {
-          uint32_t x = reg_rdata1;
-          state.gpr[reg_d_index] = ((x & 0xFF) << 24) | ((x & 0xFF00) << 8) |
-                                   ((x & 0xFF0000) >> 8) |
-                                   ((x & 0xFF000000) >> 24);
-        }
-      } else if (funct7 == 0x14) { // orcb (Zbb) - shamt must be 7?
-        if (reg_b_index == 7) {
-          uint32_t x = reg_rdata1;
-          uint32_t res = 0;
-          if (x & 0xFF)
-            res |= 0xFF;
-          if (x & 0xFF00)
-            res |= 0xFF00;
-          if (x & 0xFF0000)
-            res |= 0xFF0000;
-          if (x & 0xFF000000)
-            res |= 0xFF000000;
-          state.gpr[reg_d_index] = res;
-        }
+            u_dividend; // RISC-V 规定：除以0，余数为被除数
+      } else {
+        state.gpr[reg_d_index] = u_dividend % u_divisor;
       }
       break;
     }
     }
-    break;
-  }
-  case number_8_opcode_add: { // add, sub, sll, slt, sltu, xor, srl, sra, or,
-                              // and
-    if (funct7 == 1) {        // mul div
-      int64_t s1 = (int64_t)(int32_t)reg_rdata1;
-      int64_t s2 = (int64_t)(int32_t)reg_rdata2;
-
-      uint64_t u1 = (uint32_t)reg_rdata1;
-      uint64_t u2 = (uint32_t)reg_rdata2;
-
-      // 获取 32 位操作数
-      int32_t dividend = (int32_t)reg_rdata1;
-      int32_t divisor = (int32_t)reg_rdata2;
-      uint32_t u_dividend = (uint32_t)reg_rdata1;
-      uint32_t u_divisor = (uint32_t)reg_rdata2;
-
-      switch (funct3) {
-      case 0: { // mul
-        state.gpr[reg_d_index] = (int32_t)(u1 * u2);
-        break;
-      }
-      case 1: { // mulh
-        state.gpr[reg_d_index] = (uint32_t)((s1 * s2) >> 32);
-        break;
-      }
-      case 2: { // mulsu
-        state.gpr[reg_d_index] = (uint32_t)((s1 * (int64_t)u2) >> 32);
-        break;
-      }
-      case 3: { // mulhu
-        state.gpr[reg_d_index] = (uint32_t)((u1 * u2) >> 32);
-        break;
-      }
-      case 4: { // div (signed)
-        if (divisor == 0) {
-          state.gpr[reg_d_index] = -1; // RISC-V 规定：除以0结果为 -1
-        } else if (dividend == INT32_MIN && divisor == -1) {
-          state.gpr[reg_d_index] =
-              INT32_MIN; // RISC-V 规定：溢出时结果为被除数本身(INT_MIN)
-        } else {
-          state.gpr[reg_d_index] = dividend / divisor;
-        }
-        break;
-      }
-      case 5: { // divu (unsigned)
-        if (u_divisor == 0) {
-          state.gpr[reg_d_index] = 0xFFFFFFFF; // RISC-V 规定：除以0结果为最大值
-        } else {
-          state.gpr[reg_d_index] = u_dividend / u_divisor;
-        }
-        break;
-      }
-      case 6: { // rem (signed)
-        if (divisor == 0) {
-          state.gpr[reg_d_index] = dividend; // RISC-V 规定：除以0，余数为被除数
-        } else if (dividend == INT32_MIN && divisor == -1) {
-          state.gpr[reg_d_index] = 0; // RISC-V 规定：溢出时，余数为 0
-        } else {
-          state.gpr[reg_d_index] = dividend % divisor;
-        }
-        break;
-      }
-      case 7: { // remu (unsigned)
-        if (u_divisor == 0) {
-          state.gpr[reg_d_index] =
-              u_dividend; // RISC-V 规定：除以0，余数为被除数
-        } else {
-          state.gpr[reg_d_index] = u_dividend % u_divisor;
-        }
-        break;
-      }
-      }
-    } else {
-      switch (funct3) {
-      case 0: {            // add, sub
-        if (funct7 == 0) { // add
-          state.gpr[reg_d_index] = reg_rdata1 + reg_rdata2;
-        } else if (funct7 == 0x20) { // sub
-          state.gpr[reg_d_index] = reg_rdata1 - reg_rdata2;
-        }
-        break;
-      }
-      case 1: { // sll, rol, bclr, bset, binv, clmul
-        uint32_t shift = reg_rdata2 & 0x1F;
-        if (funct7 == 0) { // sll
-          state.gpr[reg_d_index] = reg_rdata1 << shift;
-        } else if (funct7 == 0x30) { // rol (Zbb)
-          state.gpr[reg_d_index] =
-              (reg_rdata1 << shift) | (reg_rdata1 >> (32 - shift));
-        } else if (funct7 == 0x24) { // bclr (Zbs)
-          state.gpr[reg_d_index] = reg_rdata1 & ~(1u << shift);
-        } else if (funct7 == 0x14) { // bset (Zbs)
-          state.gpr[reg_d_index] = reg_rdata1 | (1u << shift);
-        } else if (funct7 == 0x34) { // binv (Zbs)
-          state.gpr[reg_d_index] = reg_rdata1 ^ (1u << shift);
-        } else if (funct7 == 0x05) { // clmul (Zbc)
-          uint32_t output = 0;
-          for (int i = 0; i < 32; i++) {
-            if ((reg_rdata2 >> i) & 1)
-              output ^= (reg_rdata1 << i);
-          }
-          state.gpr[reg_d_index] = output;
-        }
-        break;
+  } else {
+    switch (funct3) {
+    case 0: {            // add, sub
+      if (funct7 == 0) { // add
+        state.gpr[reg_d_index] = reg_rdata1 + reg_rdata2;
+      } else if (funct7 == 0x20) { // sub
+        state.gpr[reg_d_index] = reg_rdata1 - reg_rdata2;
       }
-      case 2: {            // slt, sh1add, clmulr
-        if (funct7 == 0) { // slt
-          state.gpr[reg_d_index] =
-              (int32_t)reg_rdata1 < (int32_t)reg_rdata2 ? 1 : 0;
-        } else if (funct7 == 0x10) { // sh1add (Zba)
-          state.gpr[reg_d_index] = reg_rdata2 + (reg_rdata1 << 1);
-        } else if (funct7 == 0x05) { // clmulr (Zbc)
-          uint32_t output = 0;
-          for (int i = 0; i < 32; i++) {
-            if ((reg_rdata2 >> i) & 1)
-              output ^= (reg_rdata1 >> (31 - i));
-          }
-          state.gpr[reg_d_index] = output;
+      break;
+    }
+    case 1: { // sll, rol, bclr, bset, binv, clmul
+      uint32_t shift = reg_rdata2 & 0x1F;
+      if (funct7 == 0) { // sll
+        state.gpr[reg_d_index] = reg_rdata1 << shift;
+      } else if (funct7 == 0x30) { // rol (Zbb)
+        state.gpr[reg_d_index] =
+            (reg_rdata1 << shift) | (reg_rdata1 >> (32 - shift));
+      } else if (funct7 == 0x24) { // bclr (Zbs)
+        state.gpr[reg_d_index] = reg_rdata1 & ~(1u << shift);
+      } else if (funct7 == 0x14) { // bset (Zbs)
+        state.gpr[reg_d_index] = reg_rdata1 | (1u << shift);
+      } else if (funct7 == 0x34) { // binv (Zbs)
+        state.gpr[reg_d_index] = reg_rdata1 ^ (1u << shift);
+      } else if (funct7 == 0x05) { // clmul (Zbc)
+        uint32_t output = 0;
+        for (int i = 0; i < 32; i++) {
+          if ((reg_rdata2 >> i) & 1)
+            output ^= (reg_rdata1 << i);
         }
-        break;
+        state.gpr[reg_d_index] = output;
       }
-      case 3: {            // sltu, clmulh
-        if (funct7 == 0) { // sltu
-          state.gpr[reg_d_index] =
-              (uint32_t)reg_rdata1 < (uint32_t)reg_rdata2 ? 1 : 0;
-        } else if (funct7 == 0x05) { // clmulh (Zbc)
-          uint32_t output = 0;
-          for (int i = 1; i < 32; i++) {
-            if ((reg_rdata2 >> i) & 1)
-              output ^= (reg_rdata1 >> (32 - i));
-          }
-          state.gpr[reg_d_index] = output;
+      break;
+    }
+    case 2: {            // slt, sh1add, clmulr
+      if (funct7 == 0) { // slt
+        state.gpr[reg_d_index] =
+            (int32_t)reg_rdata1 < (int32_t)reg_rdata2 ? 1 : 0;
+      } else if (funct7 == 0x10) { // sh1add (Zba)
+        state.gpr[reg_d_index] = reg_rdata2 + (reg_rdata1 << 1);
+      } else if (funct7 == 0x05) { // clmulr (Zbc)
+        uint32_t output = 0;
+        for (int i = 0; i < 32; i++) {
+          if ((reg_rdata2 >> i) & 1)
+            output ^= (reg_rdata1 >> (31 - i));
         }
-        break;
+        state.gpr[reg_d_index] = output;
       }
-      case 4: {            // xor, xnor, min, pack, sh2add
-        if (funct7 == 0) { // xor
-          state.gpr[reg_d_index] = reg_rdata1 ^ reg_rdata2;
-        } else if (funct7 == 0x20) { // xnor (Zbb)
-          state.gpr[reg_d_index] = ~(reg_rdata1 ^ reg_rdata2);
-        } else if (funct7 == 0x10) { // sh2add (Zba)
-          state.gpr[reg_d_index] = reg_rdata2 + (reg_rdata1 << 2);
-        } else if (funct7 == 0x05) { // min (Zbb)
-          state.gpr[reg_d_index] = ((int32_t)reg_rdata1 < (int32_t)reg_rdata2)
-                                       ? reg_rdata1
-                                       : reg_rdata2;
-        } else if (funct7 == 0x04) { // pack (Zbb)
-          state.gpr[reg_d_index] =
-              (reg_rdata1 & 0x0000FFFF) | (reg_rdata2 << 16);
+      break;
+    }
+    case 3: {            // sltu, clmulh
+      if (funct7 == 0) { // sltu
+        state.gpr[reg_d_index] =
+            (uint32_t)reg_rdata1 < (uint32_t)reg_rdata2 ? 1 : 0;
+      } else if (funct7 == 0x05) { // clmulh (Zbc)
+        uint32_t output = 0;
+        for (int i = 1; i < 32; i++) {
+          if ((reg_rdata2 >> i) & 1)
+            output ^= (reg_rdata1 >> (32 - i));
         }
-        break;
+        state.gpr[reg_d_index] = output;
       }
-      case 5: { // srl, sra, ror, bext, minu
-        uint32_t shift = reg_rdata2 & 0x1F;
-        if (funct7 == 0) { // srl
-          state.gpr[reg_d_index] = (uint32_t)reg_rdata1 >> shift;
-        } else if (funct7 == 0x20) { // sra
-          state.gpr[reg_d_index] = (int32_t)reg_rdata1 >> shift;
-        } else if (funct7 == 0x30) { // ror (Zbb)
-          state.gpr[reg_d_index] =
-              (reg_rdata1 >> shift) | (reg_rdata1 << (32 - shift));
-        } else if (funct7 == 0x24) { // bext (Zbs)
-          state.gpr[reg_d_index] = (reg_rdata1 >> shift) & 1;
-        } else if (funct7 == 0x05) { // minu (Zbb)
-          state.gpr[reg_d_index] = ((uint32_t)reg_rdata1 < (uint32_t)reg_rdata2)
-                                       ? reg_rdata1
-                                       : reg_rdata2;
-        }
-        break;
+      break;
+    }
+    case 4: {            // xor, xnor, min, pack, sh2add
+      if (funct7 == 0) { // xor
+        state.gpr[reg_d_index] = reg_rdata1 ^ reg_rdata2;
+      } else if (funct7 == 0x20) { // xnor (Zbb)
+        state.gpr[reg_d_index] = ~(reg_rdata1 ^ reg_rdata2);
+      } else if (funct7 == 0x10) { // sh2add (Zba)
+        state.gpr[reg_d_index] = reg_rdata2 + (reg_rdata1 << 2);
+      } else if (funct7 == 0x05) { // min (Zbb)
+        state.gpr[reg_d_index] = ((int32_t)reg_rdata1 < (int32_t)reg_rdata2)
+                                     ? reg_rdata1
+                                     : reg_rdata2;
+      } else if (funct7 == 0x04) { // pack (Zbb)
+        state.gpr[reg_d_index] =
+            (reg_rdata1 & 0x0000FFFF) | (reg_rdata2 << 16);
       }
-      case 6: {            // or, orn, max, sh3add
-        if (funct7 == 0) { // or
-          state.gpr[reg_d_index] = reg_rdata1 | reg_rdata2;
-        } else if (funct7 == 0x20) { // orn (Zbb)
-          state.gpr[reg_d_index] = reg_rdata1 | (~reg_rdata2);
-        } else if (funct7 == 0x05) { // max (Zbb)
-          state.gpr[reg_d_index] = ((int32_t)reg_rdata1 > (int32_t)reg_rdata2)
-                                       ? reg_rdata1
-                                       : reg_rdata2;
-        } else if (funct7 == 0x10) { // sh3add (Zba)
-          state.gpr[reg_d_index] = reg_rdata2 + (reg_rdata1 << 3);
-        }
-        break;
+      break;
+    }
+    case 5: { // srl, sra, ror, bext, minu
+      uint32_t shift = reg_rdata2 & 0x1F;
+      if (funct7 == 0) { // srl
+        state.gpr[reg_d_index] = (uint32_t)reg_rdata1 >> shift;
+      } else if (funct7 == 0x20) { // sra
+        state.gpr[reg_d_index] = (int32_t)reg_rdata1 >> shift;
+      } else if (funct7 == 0x30) { // ror (Zbb)
+        state.gpr[reg_d_index] =
+            (reg_rdata1 >> shift) | (reg_rdata1 << (32 - shift));
+      } else if (funct7 == 0x24) { // bext (Zbs)
+        state.gpr[reg_d_index] = (reg_rdata1 >> shift) & 1;
+      } else if (funct7 == 0x05) { // minu (Zbb)
+        state.gpr[reg_d_index] = ((uint32_t)reg_rdata1 < (uint32_t)reg_rdata2)
+                                     ? reg_rdata1
+                                     : reg_rdata2;
       }
-      case 7: {            // and, andn, maxu, packh
-        if (funct7 == 0) { // and
-          state.gpr[reg_d_index] = reg_rdata1 & reg_rdata2;
-        } else if (funct7 == 0x20) { // andn (Zbb)
-          state.gpr[reg_d_index] = reg_rdata1 & (~reg_rdata2);
-        } else if (funct7 == 0x05) { // maxu (Zbb)
-          state.gpr[reg_d_index] = ((uint32_t)reg_rdata1 > (uint32_t)reg_rdata2)
-                                       ? reg_rdata1
-                                       : reg_rdata2;
-        } else if (funct7 == 0x04) { // packh (Zbb)
-          state.gpr[reg_d_index] =
-              (reg_rdata1 & 0x000000FF) | ((reg_rdata2 & 0x000000FF) << 8);
-        }
-        break;
+      break;
+    }
+    case 6: {            // or, orn, max, sh3add
+      if (funct7 == 0) { // or
+        state.gpr[reg_d_index] = reg_rdata1 | reg_rdata2;
+      } else if (funct7 == 0x20) { // orn (Zbb)
+        state.gpr[reg_d_index] = reg_rdata1 | (~reg_rdata2);
+      } else if (funct7 == 0x05) { // max (Zbb)
+        state.gpr[reg_d_index] = ((int32_t)reg_rdata1 > (int32_t)reg_rdata2)
+                                     ? reg_rdata1
+                                     : reg_rdata2;
+      } else if (funct7 == 0x10) { // sh3add (Zba)
+        state.gpr[reg_d_index] = reg_rdata2 + (reg_rdata1 << 3);
       }
+      break;
+    }
+    case 7: {            // and, andn, maxu, packh
+      if (funct7 == 0) { // and
+        state.gpr[reg_d_index] = reg_rdata1 & reg_rdata2;
+      } else if (funct7 == 0x20) { // andn (Zbb)
+        state.gpr[reg_d_index] = reg_rdata1 & (~reg_rdata2);
+      } else if (funct7 == 0x05) { // maxu (Zbb)
+        state.gpr[reg_d_index] = ((uint32_t)reg_rdata1 > (uint32_t)reg_rdata2)
+                                     ? reg_rdata1
+                                     : reg_rdata2;
+      } else if (funct7 == 0x04) { // packh (Zbb)
+        state.gpr[reg_d_index] =
+            (reg_rdata1 & 0x000000FF) | ((reg_rdata2 & 0x000000FF) << 8);
       }
+      break;
+    }
     }
-    break;
-  }
-  case number_9_opcode_fence: { // fence, fence.i
-    break;
-  }
-  default: {
-    break;
   }
+
+  state.pc = next_pc;
+}
+
+// fence, fence.i
+void RefCpu::rv32_fence(const RefDecodedInst &d) {
+  uint32_t next_pc = state.pc + inst_len;
+
+  if (d.funct3 == 0b001) { // fence.i：丢弃全部预译码结果
+    flush_decode_cache();
   }
 
   state.pc = next_pc;
 }
 
+void RefCpu::rv32_default(const RefDecodedInst &d) { state.pc += inst_len; }
+
 uint32_t RefCpu::load_word(uint32_t addr) const {
   const uint32_t word_addr = addr & ~0x3u;
   if (is_ram_range(word_addr, 4)) {
@@ -1570,10 +1862,38 @@ uint32_t RefCpu::load_word(uint32_t addr) const {
   return (it == io_words.end()) ? 0 : it->second;
 }
 
+uint32_t RefCpu::load_half(uint32_t addr) const {
+  return (load_word(addr) >> ((addr & 0x2u) * 8)) & 0xffffu;
+}
+
 void RefCpu::store_word(uint32_t addr, uint32_t data) {
   const uint32_t word_addr = addr & ~0x3u;
+  if (store_undo != nullptr) {
+    store_undo->push_back({word_addr, load_word(word_addr)});
+  }
+#ifdef CONFIG_RVC
+  // 被覆盖的字可能属于起始于 word_addr - 2 / word_addr / word_addr + 2 的指令
+  for (uint32_t pc = word_addr - 2; pc != word_addr + 4; pc += 2) {
+    RefDecodedInst &decoded =
+        decode_cache[(pc >> REF_DECODE_IDX_SHIFT) & (REF_DECODE_CACHE_SIZE - 1)];
+    if (decoded.tag == pc) {
+      decoded.tag = kRefDecodeInvalidTag;
+    }
+  }
+#else
+  RefDecodedInst &decoded =
+      decode_cache[(word_addr >> 2) & (REF_DECODE_CACHE_SIZE - 1)];
+  if (decoded.tag == word_addr) {
+    decoded.tag = kRefDecodeInvalidTag;
+  }
+#endif
   if (is_ram_range(word_addr, 4)) {
     memory[(word_addr - kRamBase) >> 2] = data;
+    const uint32_t page = (word_addr - kRamBase) >> 12;
+    ram_dirty_page_bits[page >> 6] |= 1ull << (page & 63);
+    if (tlb_pte_page_bits[page >> 6] & (1ull << (page & 63))) {
+      flush_tlb(); // 改写了被缓存翻译引用的页表页
+    }
     return;
   }
   check_mem_range_or_die("word store", word_addr, 4);
@@ -1641,7 +1961,74 @@ void RefCpu::store_data() {
   state.store_strb = state.store_strb << offset * 8;
 }
 
+void RefCpu::flush_tlb() {
+  if (++tlb_gen == 0) {
+    for (auto &entry : tlb) {
+      entry.gen = 0;
+    }
+    tlb_gen = 1;
+  }
+  for (uint32_t page : tlb_pte_pages) {
+    tlb_pte_page_bits[page >> 6] &= ~(1ull << (page & 63));
+  }
+  tlb_pte_pages.clear();
+}
+
 bool RefCpu::va2pa(uint32_t &p_addr, uint32_t v_addr, uint32_t type) {
+  const uint32_t mstatus = state.csr[csr_mstatus];
+  const uint32_t satp = state.csr[csr_satp];
+  const uint32_t xlate_bits =
+      mstatus & (MSTATUS_SUM | MSTATUS_MXR | MSTATUS_MPRV);
+  if (satp != tlb_satp || xlate_bits != tlb_mstatus) {
+    flush_tlb();
+    tlb_satp = satp;
+    tlb_mstatus = xlate_bits;
+  }
+
+  int eff_priv = privilege;
+  if (type != 0 && (mstatus & MSTATUS_MPRV)) {
+    eff_priv = (mstatus >> MSTATUS_MPP_SHIFT) & 0x3;
+  }
+  const uint32_t vpn = v_addr >> 12;
+  const uint16_t asid = (satp >> 22) & 0x1FF;
+  RefTlbEntry &entry = tlb[((vpn << 2) | type) & (REF_TLB_SIZE - 1)];
+  if (entry.gen == tlb_gen && entry.vpn == vpn && entry.asid == asid &&
+      entry.priv == eff_priv && entry.type == type) {
+    p_addr = entry.ppage | (v_addr & 0xFFF);
+    return true;
+  }
+
+  uint32_t pte_addr[2] = {0, 0};
+  int pte_num = 0;
+  if (!va2pa_walk(p_addr, v_addr, type, pte_addr, pte_num)) {
+    return false;
+  }
+
+  // 只缓存页表项位于 RAM 的翻译：其后续修改必经 store_word 的 RAM 路径。
+  for (int i = 0; i < pte_num; i++) {
+    if (!is_ram_range(pte_addr[i], 4)) {
+      return true;
+    }
+  }
+  for (int i = 0; i < pte_num; i++) {
+    const uint32_t page = (pte_addr[i] - kRamBase) >> 12;
+    uint64_t &bits = tlb_pte_page_bits[page >> 6];
+    if (!(bits & (1ull << (page & 63)))) {
+      bits |= 1ull << (page & 63);
+      tlb_pte_pages.push_back(page);
+    }
+  }
+  entry.gen = tlb_gen;
+  entry.vpn = vpn;
+  entry.asid = asid;
+  entry.priv = eff_priv;
+  entry.type = type;
+  entry.ppage = p_addr & ~0xFFFu;
+  return true;
+}
+
+bool RefCpu::va2pa_walk(uint32_t &p_addr, uint32_t v_addr, uint32_t type,
+                        uint32_t pte_addr[2], int &pte_num) {
   uint32_t mstatus = state.csr[csr_mstatus];
   uint32_t satp = state.csr[csr_satp];
 
@@ -1669,6 +2056,7 @@ bool RefCpu::va2pa(uint32_t &p_addr, uint32_t v_addr, uint32_t type) {
 
   // 直接读取，注意这里需要确保 memory 是按字寻址还是字节寻址
   uint32_t pte1 = load_word(pte1_addr);
+  pte_addr[pte_num++] = pte1_addr;
 
   // 3. 检查 PTE 有效性
   // !V 或者 (!R && W) 都是无效的
@@ -1725,6 +2113,7 @@ bool RefCpu::va2pa(uint32_t &p_addr, uint32_t v_addr, uint32_t type) {
   uint32_t pte2_addr = (ppn1 << 12) | (vpn0 << 2);
 
   uint32_t pte2 = load_word(pte2_addr);
+  pte_addr[pte_num++] = pte2_addr;
 
   // 重复有效性检查
   if (!(pte2 & PTE_V) || (!(pte2 & PTE_R) && (pte2 & PTE_W))) {
@@ -1796,7 +2185,8 @@ bool RefCpu::va2pa_fix(uint32_t &p_addr, uint32_t v_addr, uint32_t type) {
   if (dut_fault && !ref_fault) {
     std::cout << "[Difftest Warning] DUT has " << kind
               << " page fault while REF does not at cycle " << std::dec
-              << sim_time << ", force REF " << kind << " page fault"
+              << (async_checker ? commit_cycle : *sim_clock) << ", force REF "
+              << kind << " page fault"
               << std::endl;
     return false;
   }
@@ -7,8 +7,8 @@
 #include "./dir_predictor/TAGE_top.h"
 #include "./type_predictor/TypePredictor.h"
 #include "./target_predictor/BTB_top.h"
+#include "./target_predictor/ITTAGE_top.h"
 #include "BPU_configs.h"
-#include <SimCpu.h>
 
 #include <cassert>
 #include <cstdlib>
@@ -16,9 +16,6 @@
 #include <iostream>
 #include <vector>
 
-class BPU_TOP;             // 前向声明类
-extern BPU_TOP *g_bpu_top; // 再声明全局指针
-
 struct BankSelCombIn {
   pc_t pc;
 };
@@ -29,7 +26,7 @@ struct BankSelCombOut {
 
 inline void bank_sel_comb(const BankSelCombIn &in, BankSelCombOut &out) {
   out = BankSelCombOut{};
-  out.bank_sel = static_cast<bpu_bank_sel_t>((in.pc >> 2) % BPU_BANK_NUM);
+  out.bank_sel = static_cast<bpu_bank_sel_t>((in.pc >> FETCH_SLOT_SHIFT) % BPU_BANK_NUM);
 }
 
 struct BankPcCombIn {
@@ -43,7 +40,7 @@ struct BankPcCombOut {
 inline void bank_pc_comb(const BankPcCombIn &in, BankPcCombOut &out) {
   out = BankPcCombOut{};
   if ((BPU_BANK_NUM & (BPU_BANK_NUM - 1)) != 0) {
-    uint32_t bank_pc = in.pc >> 2;
+    uint32_t bank_pc = in.pc >> FETCH_SLOT_SHIFT;
     bank_pc = bank_pc / BPU_BANK_NUM;
     bank_pc = bank_pc << 2;
     out.bank_pc = bank_pc;
@@ -56,7 +53,8 @@ inline void bank_pc_comb(const BankPcCombIn &in, BankPcCombOut &out) {
     n >>= 1;
     highest_bit_pos++;
   }
-  out.bank_pc = in.pc >> highest_bit_pos;
+  // 预测器内部按 bank_pc >> 2 取行号，半字槽位时少移一位
+  out.bank_pc = in.pc >> (highest_bit_pos + FETCH_SLOT_SHIFT - 2);
 }
 
 struct NlpIndexCombIn {
@@ -69,7 +67,7 @@ struct NlpIndexCombOut {
 
 inline void nlp_index_comb(const NlpIndexCombIn &in, NlpIndexCombOut &out) {
   out = NlpIndexCombOut{};
-  uint32_t mixed = (in.pc >> 2) ^ (in.pc >> 11) ^ (in.pc >> 19);
+  uint32_t mixed = (in.pc >> FETCH_SLOT_SHIFT) ^ (in.pc >> 11) ^ (in.pc >> 19);
   if ((NLP_TABLE_SIZE & (NLP_TABLE_SIZE - 1)) == 0) {
     out.index = static_cast<nlp_index_t>(mixed & (NLP_TABLE_SIZE - 1));
   } else {
@@ -87,12 +85,12 @@ struct NlpTagCombOut {
 
 inline void nlp_tag_comb(const NlpTagCombIn &in, NlpTagCombOut &out) {
   out = NlpTagCombOut{};
-  out.tag = static_cast<nlp_tag_t>(in.pc >> 2);
+  out.tag = static_cast<nlp_tag_t>(in.pc >> FETCH_SLOT_SHIFT);
 }
 
 inline fetch_addr_t nlp_fallback_next_pc(fetch_addr_t base_pc) {
   const uint32_t cache_mask = ~(ICACHE_LINE_SIZE - 1);
-  const uint32_t pc_plus_width = base_pc + (FETCH_WIDTH * 4);
+  const uint32_t pc_plus_width = base_pc + (FETCH_WIDTH * FETCH_SLOT_BYTES);
   return static_cast<fetch_addr_t>(((base_pc & cache_mask) != (pc_plus_width & cache_mask))
                                        ? (pc_plus_width & cache_mask)
                                        : pc_plus_width);
@@ -123,6 +121,7 @@ public:
     wire1_t in_upd_valid[COMMIT_WIDTH];
     wire1_t in_actual_dir[COMMIT_WIDTH];
     br_type_t in_actual_br_type[COMMIT_WIDTH]; // 3-bit each
+    wire1_t in_upd_is_rvc[COMMIT_WIDTH];       // 16 位压缩指令
     target_addr_t in_actual_targets[COMMIT_WIDTH];
 
     wire1_t in_pred_dir[COMMIT_WIDTH];
@@ -238,10 +237,8 @@ public:
     wire1_t ras_has_entry_snapshot;
     target_addr_t ras_top_snapshot;
     ras_count_t ras_count_snapshot;
-    wire1_t Arch_GHR_snapshot[GHR_LENGTH];
-    wire1_t Spec_GHR_snapshot[GHR_LENGTH];
-    wire32_t Arch_FH_snapshot[FH_N_MAX][TN_MAX];
-    wire32_t Spec_FH_snapshot[FH_N_MAX][TN_MAX];
+    TageHistory Arch_HIST_snapshot;
+    TageHistory Spec_HIST_snapshot;
     tage_path_hist_t Arch_PATH_snapshot;
     tage_path_hist_t Spec_PATH_snapshot;
     target_addr_t Arch_ras_stack_snapshot[RAS_DEPTH];
@@ -271,6 +268,7 @@ public:
     TypePredictor::ReadData type_rd;
     TAGE_TOP::ReadData tage_rd[BPU_BANK_NUM];
     BTB_TOP::ReadData btb_rd[BPU_BANK_NUM];
+    ITTAGE_TOP::ReadData ittage_rd[BPU_BANK_NUM];
     NlpEntrySnapshot nlp_pred_base_entry_snapshot;
     fetch_addr_t nlp_s1_req_pc_snapshot;
     NlpEntrySnapshot nlp_s1_entry_snapshot;
@@ -306,10 +304,8 @@ public:
     nlp_tag_t nlp_entry_tag_next;
     target_addr_t nlp_entry_target_next;
     nlp_conf_t nlp_entry_conf_next;
-    wire1_t Spec_GHR_next[GHR_LENGTH];
-    wire1_t Arch_GHR_next[GHR_LENGTH];
-    wire32_t Spec_FH_next[FH_N_MAX][TN_MAX];
-    wire32_t Arch_FH_next[FH_N_MAX][TN_MAX];
+    TageHistory Spec_HIST_next;
+    TageHistory Arch_HIST_next;
     tage_path_hist_t Spec_PATH_next;
     tage_path_hist_t Arch_PATH_next;
     target_addr_t Arch_ras_stack_next[RAS_DEPTH];
@@ -341,10 +337,12 @@ public:
 
     TAGE_TOP::InputPayload tage_in[BPU_BANK_NUM];
     BTB_TOP::InputPayload btb_in[BPU_BANK_NUM];
+    ITTAGE_TOP::InputPayload ittage_in[BPU_BANK_NUM];
     TypePredictor::InputPayload type_in;
     TypePredictor::CombResult type_req;
     TAGE_TOP::CombResult tage_req[BPU_BANK_NUM];
     BTB_TOP::CombResult btb_req[BPU_BANK_NUM];
+    ITTAGE_TOP::CombResult ittage_req[BPU_BANK_NUM];
 
     wire1_t tage_done_next[BPU_BANK_NUM];
     wire1_t btb_done_next[BPU_BANK_NUM];
@@ -396,8 +394,8 @@ public:
     pc_t in_update_base_pc[COMMIT_WIDTH];
     wire1_t in_upd_valid[COMMIT_WIDTH];
     br_type_t in_actual_br_type[COMMIT_WIDTH];
-    wire1_t ghr_snapshot[GHR_LENGTH];
-    wire32_t fh_snapshot[FH_N_MAX][TN_MAX];
+    wire1_t in_upd_is_rvc[COMMIT_WIDTH];
+    const TageHistory *hist_snapshot;
     tage_path_hist_t path_snapshot;
     pc_t pred_base_pc;
     wire1_t going_to_do_pred;
@@ -417,6 +415,7 @@ public:
     TypePredictor::InputPayload type_in;
     TAGE_TOP::InputPayload tage_in[BPU_BANK_NUM];
     BTB_TOP::InputPayload btb_in[BPU_BANK_NUM];
+    ITTAGE_TOP::InputPayload ittage_in[BPU_BANK_NUM];
   };
 
   struct BpuCombIn {
@@ -433,6 +432,7 @@ public:
   struct BpuSubmoduleBindCombIn {
     wire1_t do_pred_on_this_pc[FETCH_WIDTH];
     bpu_bank_sel_ext_t this_pc_bank_sel[FETCH_WIDTH];
+    pc_t do_pred_for_this_pc[FETCH_WIDTH];
     BTB_TOP::InputPayload btb_in[BPU_BANK_NUM];
     TypePredictor::OutputPayload type_out;
   };
@@ -460,6 +460,7 @@ public:
     TypePredictor::OutputPayload type_out;
     TAGE_TOP::OutputPayload tage_out[BPU_BANK_NUM];
     BTB_TOP::OutputPayload btb_out[BPU_BANK_NUM];
+    ITTAGE_TOP::OutputPayload ittage_out[BPU_BANK_NUM];
   };
 
   struct BpuPredictMainCombOut {
@@ -508,15 +509,14 @@ public:
     wire1_t in_upd_valid[COMMIT_WIDTH];
     wire1_t in_actual_dir[COMMIT_WIDTH];
     br_type_t in_actual_br_type[COMMIT_WIDTH];
+    wire1_t in_upd_is_rvc[COMMIT_WIDTH];
     wire1_t in_pred_dir[COMMIT_WIDTH];
     wire1_t going_to_do_pred;
     wire1_t do_pred_on_this_pc[FETCH_WIDTH];
     bpu_bank_sel_ext_t this_pc_bank_sel[FETCH_WIDTH];
     pc_t do_pred_for_this_pc[FETCH_WIDTH];
-    wire1_t Spec_GHR_snapshot[GHR_LENGTH];
-    wire32_t Spec_FH_snapshot[FH_N_MAX][TN_MAX];
-    wire1_t Arch_GHR_snapshot[GHR_LENGTH];
-    wire32_t Arch_FH_snapshot[FH_N_MAX][TN_MAX];
+    TageHistory Spec_HIST_snapshot;
+    TageHistory Arch_HIST_snapshot;
     tage_path_hist_t Spec_PATH_snapshot;
     tage_path_hist_t Arch_PATH_snapshot;
     target_addr_t Arch_ras_stack_snapshot[RAS_DEPTH];
@@ -529,10 +529,8 @@ public:
 
   struct BpuHistCombOut {
     wire1_t should_update_spec_hist;
-    wire1_t Spec_GHR_next[GHR_LENGTH];
-    wire32_t Spec_FH_next[FH_N_MAX][TN_MAX];
-    wire1_t Arch_GHR_next[GHR_LENGTH];
-    wire32_t Arch_FH_next[FH_N_MAX][TN_MAX];
+    TageHistory Spec_HIST_next;
+    TageHistory Arch_HIST_next;
     tage_path_hist_t Spec_PATH_next;
     tage_path_hist_t Arch_PATH_next;
     target_addr_t Arch_ras_stack_next[RAS_DEPTH];
@@ -628,11 +626,9 @@ private:
   // ========================================================================
 
   // Global History Registers & Folded Histories (Arch + Spec)
-  // GHR/FH从TAGE迁移到BPU统一管理
-  wire1_t Arch_GHR[GHR_LENGTH];
-  wire1_t Spec_GHR[GHR_LENGTH];
-  wire32_t Arch_FH[FH_N_MAX][TN_MAX];
-  wire32_t Spec_FH[FH_N_MAX][TN_MAX];
+  // GHR/FH从TAGE迁移到BPU统一管理，打包存放（见 TageHistory）
+  TageHistory Arch_HIST;
+  TageHistory Spec_HIST;
   tage_path_hist_t Arch_PATH;
   tage_path_hist_t Spec_PATH;
   target_addr_t Arch_ras_stack[RAS_DEPTH];
@@ -640,11 +636,6 @@ private:
   target_addr_t Spec_ras_stack[RAS_DEPTH];
   ras_count_t Spec_ras_count;
 
-  // FH constants (从TAGE复制，用于调用FH_update函数)
-  const uint32_t ghr_length[TN_MAX] = {8, 13, 32, 119};
-  const uint32_t fh_length[FH_N_MAX][TN_MAX] = {
-      {8, 11, 11, 11}, {8, 8, 8, 8}, {7, 7, 7, 7}};
-
   // PC & Memory
   pc_t pc_reg;
   State state;
@@ -686,6 +677,7 @@ private:
   // Sub-modules
   TAGE_TOP *tage_inst[BPU_BANK_NUM];
   BTB_TOP *btb_inst[BPU_BANK_NUM];
+  ITTAGE_TOP *ittage_inst[BPU_BANK_NUM];
   TypePredictor *type_pred_inst;
 
   NLPEntry nlp_table[NLP_TABLE_SIZE];
@@ -734,12 +726,10 @@ public:
   // 构造与析构
   // ========================================================================
   BPU_TOP() {
-    // 注册全局指针，让TAGE可以访问BPU的GHR/FH
-    g_bpu_top = this;
-    
     for (int i = 0; i < BPU_BANK_NUM; i++) {
       tage_inst[i] = new TAGE_TOP();
       btb_inst[i] = new BTB_TOP();
+      ittage_inst[i] = new ITTAGE_TOP();
     }
     type_pred_inst = new TypePredictor();
 
@@ -783,10 +773,8 @@ public:
     rd.saved_mini_flush_req_snapshot = saved_mini_flush_req;
     rd.saved_mini_flush_correct_snapshot = saved_mini_flush_correct;
     rd.saved_mini_flush_target_snapshot = saved_mini_flush_target;
-    std::memcpy(rd.Arch_GHR_snapshot, Arch_GHR, sizeof(rd.Arch_GHR_snapshot));
-    std::memcpy(rd.Spec_GHR_snapshot, Spec_GHR, sizeof(rd.Spec_GHR_snapshot));
-    std::memcpy(rd.Arch_FH_snapshot, Arch_FH, sizeof(rd.Arch_FH_snapshot));
-    std::memcpy(rd.Spec_FH_snapshot, Spec_FH, sizeof(rd.Spec_FH_snapshot));
+    rd.Arch_HIST_snapshot = Arch_HIST;
+    rd.Spec_HIST_snapshot = Spec_HIST;
     rd.Arch_PATH_snapshot = Arch_PATH;
     rd.Spec_PATH_snapshot = Spec_PATH;
     std::memcpy(rd.Arch_ras_stack_snapshot, Arch_ras_stack, sizeof(rd.Arch_ras_stack_snapshot));
@@ -820,14 +808,14 @@ public:
     out.pred_base_pc = in.refetch ? in.refetch_address : in.pc_reg_snapshot;
 
     const uint32_t cache_mask = ~(ICACHE_LINE_SIZE - 1);
-    const uint32_t pc_plus_width = out.pred_base_pc + (FETCH_WIDTH * 4);
+    const uint32_t pc_plus_width = out.pred_base_pc + (FETCH_WIDTH * FETCH_SLOT_BYTES);
     out.boundary_addr =
         ((out.pred_base_pc & cache_mask) != (pc_plus_width & cache_mask))
             ? (pc_plus_width & cache_mask)
             : pc_plus_width;
 
     for (int i = 0; i < FETCH_WIDTH; i++) {
-      out.do_pred_for_this_pc[i] = out.pred_base_pc + (i * 4);
+      out.do_pred_for_this_pc[i] = out.pred_base_pc + (i * FETCH_SLOT_BYTES);
       if (out.do_pred_for_this_pc[i] < out.boundary_addr) {
         BankSelCombOut bank_sel_out{};
         bank_sel_comb(BankSelCombIn{out.do_pred_for_this_pc[i]}, bank_sel_out);
@@ -945,15 +933,9 @@ public:
     FRONTEND_HOST_PROFILE_SCOPE(BpuPostReadReq);
     out = BpuPostReadReqCombOut{};
     for (int b = 0; b < BPU_BANK_NUM; b++) {
-      for (int k = 0; k < FH_N_MAX; k++) {
-        for (int i = 0; i < TN_MAX; i++) {
-          out.tage_in[b].fh_in[k][i] = in.fh_snapshot[k][i];
-        }
-      }
-      for (int i = 0; i < GHR_LENGTH; i++) {
-        out.tage_in[b].ghr_in[i] = in.ghr_snapshot[i];
-      }
+      out.tage_in[b].hist_in = in.hist_snapshot;
       out.tage_in[b].path_in = in.path_snapshot;
+      out.ittage_in[b].hist_in = in.hist_snapshot;
     }
 
 #ifdef ENABLE_2AHEAD
@@ -995,6 +977,10 @@ public:
             out.btb_in[bank_sel].pred_req = true;
             out.btb_in[bank_sel].pred_pc = bank_pc_out.bank_pc;
             out.btb_in[bank_sel].pred_type_in = BR_NONCTL;
+#if ENABLE_ITTAGE
+            out.ittage_in[bank_sel].pred_req = true;
+            out.ittage_in[bank_sel].pred_pc = bank_pc_out.bank_pc;
+#endif
             pred_req_sent[bank_sel] = true;
           }
         }
@@ -1036,6 +1022,19 @@ public:
         out.btb_in[i].upd_actual_addr = in.q_data[i].targets;
         out.btb_in[i].upd_actual_dir = in.q_data[i].actual_dir;
         out.btb_in[i].upd_br_type_in = in.q_data[i].br_type;
+
+#if ENABLE_ITTAGE
+        // 间接跳转沿用回传的 TAGE idx/tag 训练 ITTAGE（与预测时索引一致）
+        if (in.q_data[i].br_type == BR_IDIRECT) {
+          out.ittage_in[i].upd_valid = in.q_data[i].valid_mask;
+          out.ittage_in[i].upd_pc = bank_pc_out.bank_pc;
+          out.ittage_in[i].upd_actual_addr = in.q_data[i].targets;
+          for (int k = 0; k < TN_MAX; k++) {
+            out.ittage_in[i].upd_tage_idx[k] = in.q_data[i].tage_idxs[k];
+            out.ittage_in[i].upd_tage_tag[k] = in.q_data[i].tage_tags[k];
+          }
+        }
+#endif
       }
     }
 
@@ -1043,6 +1042,7 @@ public:
       out.type_in.upd_valid[i] = in.in_upd_valid[i];
       out.type_in.upd_pc[i] = in.in_update_base_pc[i];
       out.type_in.upd_br_type[i] = in.in_actual_br_type[i];
+      out.type_in.upd_is_rvc[i] = in.in_upd_is_rvc[i];
     }
   }
 
@@ -1063,6 +1063,8 @@ public:
       }
       if (out.btb_in_with_type[bank_sel].pred_req) {
         out.btb_in_with_type[bank_sel].pred_type_in = type_out.pred_type[i];
+        out.btb_in_with_type[bank_sel].pred_fallthrough_in =
+            in.do_pred_for_this_pc[i] + (type_out.pred_is_rvc[i] ? 2 : 4);
       }
     }
   }
@@ -1072,6 +1074,7 @@ public:
     const TypePredictor::OutputPayload &type_out = in.type_out;
     const TAGE_TOP::OutputPayload (&tage_out)[BPU_BANK_NUM] = in.tage_out;
     const BTB_TOP::OutputPayload (&btb_out)[BPU_BANK_NUM] = in.btb_out;
+    const ITTAGE_TOP::OutputPayload (&ittage_out)[BPU_BANK_NUM] = in.ittage_out;
     std::memset(&out, 0, sizeof(out));
     out.out.icache_read_valid = in.pc_can_send_to_icache_snapshot && !in.refetch;
     out.out.fetch_address = in.pred_base_pc;
@@ -1110,7 +1113,8 @@ public:
             tage_valid ? tage_out[bank_sel].altpcpn_out : static_cast<pcpn_t>(0);
         out.tage_result_valid_latch_next[i] = tage_valid;
         out.btb_pred_target_latch_next[i] =
-            btb_valid ? btb_out[bank_sel].pred_target : in.do_pred_for_this_pc[i] + 4;
+            btb_valid ? btb_out[bank_sel].pred_target
+                      : in.do_pred_for_this_pc[i] + (type_out.pred_is_rvc[i] ? 2 : 4);
         out.btb_result_valid_latch_next[i] = btb_valid;
         for (int k = 0; k < TN_MAX; ++k) {
           out.tage_pred_calc_tags_latch_next[i][k] =
@@ -1135,6 +1139,8 @@ public:
           uint32_t chosen_target = btb_out[bank_sel].pred_target;
           if (p_type == BR_RET && in.ras_has_entry_snapshot) {
             chosen_target = in.ras_top_snapshot;
+          } else if (p_type == BR_IDIRECT && ittage_out[bank_sel].pred_valid) {
+            chosen_target = ittage_out[bank_sel].pred_target;
           }
           out.next_fetch_addr_calc = chosen_target;
           found_taken_branch = true;
@@ -1155,9 +1161,12 @@ public:
       }
     }
 
-    out.final_2_ahead_address = out.out.fetch_address + (FETCH_WIDTH * 4);
-    const uint32_t refetch_twoahead_target = in.refetch_address + (FETCH_WIDTH * 4);
-    const uint32_t fallback_twoahead_target = out.out.fetch_address + (FETCH_WIDTH * 4);
+    out.final_2_ahead_address =
+        out.out.fetch_address + (FETCH_WIDTH * FETCH_SLOT_BYTES);
+    const uint32_t refetch_twoahead_target =
+        in.refetch_address + (FETCH_WIDTH * FETCH_SLOT_BYTES);
+    const uint32_t fallback_twoahead_target =
+        out.out.fetch_address + (FETCH_WIDTH * FETCH_SLOT_BYTES);
     out.out.two_ahead_valid =
         in.refetch ? false : in.saved_2ahead_pred_valid_snapshot;
     out.out.two_ahead_target =
@@ -1211,7 +1220,8 @@ public:
       const bool s2_usable = stage2_hit && (stage2_conf >= NLP_CONF_THRESHOLD);
       const bool emit_two_ahead = s1_match && s2_usable;
       out.final_2_ahead_address =
-          emit_two_ahead ? stage2_target : (next_fetch_addr_calc + (FETCH_WIDTH * 4));
+          emit_two_ahead ? stage2_target
+                         : (next_fetch_addr_calc + (FETCH_WIDTH * FETCH_SLOT_BYTES));
 
       const bool need_mini_flush =
           (rd.saved_2ahead_prediction_snapshot != next_fetch_addr_calc);
@@ -1262,10 +1272,8 @@ public:
     const TypePredictor::OutputPayload &type_out = in.type_out;
     const wire1_t (&final_pred_dir)[FETCH_WIDTH] = in.final_pred_dir;
     std::memset(&out, 0, sizeof(out));
-    std::memcpy(out.Spec_GHR_next, in.Spec_GHR_snapshot, sizeof(out.Spec_GHR_next));
-    std::memcpy(out.Arch_GHR_next, in.Arch_GHR_snapshot, sizeof(out.Arch_GHR_next));
-    std::memcpy(out.Spec_FH_next, in.Spec_FH_snapshot, sizeof(out.Spec_FH_next));
-    std::memcpy(out.Arch_FH_next, in.Arch_FH_snapshot, sizeof(out.Arch_FH_next));
+    out.Spec_HIST_next = in.Spec_HIST_snapshot;
+    out.Arch_HIST_next = in.Arch_HIST_snapshot;
     out.Spec_PATH_next = in.Spec_PATH_snapshot;
     out.Arch_PATH_next = in.Arch_PATH_snapshot;
     std::memcpy(out.Arch_ras_stack_next, in.Arch_ras_stack_snapshot,
@@ -1277,11 +1285,7 @@ public:
     out.should_update_spec_hist = in.going_to_do_pred && !in.refetch;
 
     if (out.should_update_spec_hist) {
-      bool spec_ghr_tmp[GHR_LENGTH];
-      uint32_t spec_fh_tmp[FH_N_MAX][TN_MAX];
       tage_path_hist_t spec_path_tmp = out.Spec_PATH_next;
-      std::memcpy(spec_ghr_tmp, out.Spec_GHR_next, sizeof(spec_ghr_tmp));
-      std::memcpy(spec_fh_tmp, out.Spec_FH_next, sizeof(spec_fh_tmp));
       for (int i = 0; i < FETCH_WIDTH; ++i) {
         if (!in.do_pred_on_this_pc[i]) {
           continue;
@@ -1293,13 +1297,7 @@ public:
         br_type_t p_type = type_out.pred_type[i];
         const bool pred_taken = final_pred_dir[i];
         if (p_type == BR_DIRECT) {
-          bool next_ghr[GHR_LENGTH];
-          uint32_t next_fh[FH_N_MAX][TN_MAX];
-          tage_ghr_update_apply(spec_ghr_tmp, pred_taken, next_ghr);
-          tage_fh_update_apply(spec_fh_tmp, spec_ghr_tmp, pred_taken, next_fh,
-                               fh_length, ghr_length);
-          std::memcpy(spec_ghr_tmp, next_ghr, sizeof(next_ghr));
-          std::memcpy(spec_fh_tmp, next_fh, sizeof(next_fh));
+          tage_history_shift(out.Spec_HIST_next, pred_taken);
           spec_path_tmp =
               tage_path_update_value(spec_path_tmp, in.do_pred_for_this_pc[i], pred_taken);
         }
@@ -1307,8 +1305,6 @@ public:
           break;
         }
       }
-      std::memcpy(out.Spec_GHR_next, spec_ghr_tmp, sizeof(out.Spec_GHR_next));
-      std::memcpy(out.Spec_FH_next, spec_fh_tmp, sizeof(out.Spec_FH_next));
       out.Spec_PATH_next = spec_path_tmp;
 
 #ifdef ENABLE_BPU_RAS
@@ -1330,7 +1326,9 @@ public:
           continue;
         }
         if (p_type == BR_CALL) {
-          ras_push(spec_ras_stack_tmp, spec_ras_count_tmp, pc + 4);
+          // c.jal / c.jalr 的返回地址为 pc + 2
+          ras_push(spec_ras_stack_tmp, spec_ras_count_tmp,
+                   pc + (type_out.pred_is_rvc[i] ? 2 : 4));
         } else if (p_type == BR_RET) {
           ras_pop(spec_ras_count_tmp);
         }
@@ -1342,12 +1340,7 @@ public:
     }
 
     {
-      wire1_t arch_ghr_tmp[GHR_LENGTH];
-      wire32_t arch_fh_tmp[FH_N_MAX][TN_MAX];
       tage_path_hist_t arch_path_tmp = out.Arch_PATH_next;
-      std::memcpy(arch_ghr_tmp, out.Arch_GHR_next, sizeof(arch_ghr_tmp));
-      std::memcpy(arch_fh_tmp, out.Arch_FH_next, sizeof(arch_fh_tmp));
-      bool arch_need_write = false;
       for (int i = 0; i < COMMIT_WIDTH; ++i) {
         if (!in.in_upd_valid[i]) {
           continue;
@@ -1357,28 +1350,15 @@ public:
           continue;
         }
         bool real_dir = in.in_actual_dir[i];
-        bool next_ghr[GHR_LENGTH];
-        uint32_t next_fh[FH_N_MAX][TN_MAX];
-        tage_ghr_update_apply(arch_ghr_tmp, real_dir, next_ghr);
-        tage_fh_update_apply(arch_fh_tmp, arch_ghr_tmp, real_dir, next_fh, fh_length,
-                             ghr_length);
-        tage_path_hist_t next_path =
+        tage_history_shift(out.Arch_HIST_next, real_dir);
+        arch_path_tmp =
             tage_path_update_value(arch_path_tmp, in.in_update_base_pc[i], real_dir);
         if (in.in_pred_dir[i] != real_dir) {
-          std::memcpy(out.Spec_GHR_next, next_ghr, sizeof(out.Spec_GHR_next));
-          std::memcpy(out.Spec_FH_next, next_fh, sizeof(out.Spec_FH_next));
-          out.Spec_PATH_next = next_path;
+          out.Spec_HIST_next = out.Arch_HIST_next;
+          out.Spec_PATH_next = arch_path_tmp;
         }
-        std::memcpy(arch_ghr_tmp, next_ghr, sizeof(arch_ghr_tmp));
-        std::memcpy(arch_fh_tmp, next_fh, sizeof(arch_fh_tmp));
-        arch_path_tmp = next_path;
-        arch_need_write = true;
-      }
-      if (arch_need_write) {
-        std::memcpy(out.Arch_GHR_next, arch_ghr_tmp, sizeof(out.Arch_GHR_next));
-        std::memcpy(out.Arch_FH_next, arch_fh_tmp, sizeof(out.Arch_FH_next));
-        out.Arch_PATH_next = arch_path_tmp;
       }
+      out.Arch_PATH_next = arch_path_tmp;
     }
 
 #ifdef ENABLE_BPU_RAS
@@ -1392,7 +1372,8 @@ public:
         }
         br_type_t br_type = in.in_actual_br_type[i];
         if (br_type == BR_CALL) {
-          ras_push(arch_ras_stack_tmp, arch_ras_count_tmp, in.in_update_base_pc[i] + 4);
+          ras_push(arch_ras_stack_tmp, arch_ras_count_tmp,
+                   in.in_update_base_pc[i] + (in.in_upd_is_rvc[i] ? 2 : 4));
         } else if (br_type == BR_RET) {
           ras_pop(arch_ras_count_tmp);
         }
@@ -1489,6 +1470,7 @@ public:
     for (int i = 0; i < BPU_BANK_NUM; i++) {
       tage_inst[i]->tage_seq_read(in.tage_in[i], rd.tage_rd[i]);
       btb_inst[i]->btb_seq_read(in.btb_in[i], rd.btb_rd[i]);
+      ittage_inst[i]->ittage_seq_read(in.ittage_in[i], rd.ittage_rd[i]);
     }
     type_pred_inst->type_pred_seq_read(in.type_in, rd.type_rd);
   }
@@ -1529,10 +1511,8 @@ public:
     req.nlp_entry_tag_next = 0;
     req.nlp_entry_target_next = 0;
     req.nlp_entry_conf_next = 0;
-    std::memcpy(req.Spec_GHR_next, rd.Spec_GHR_snapshot, sizeof(req.Spec_GHR_next));
-    std::memcpy(req.Arch_GHR_next, rd.Arch_GHR_snapshot, sizeof(req.Arch_GHR_next));
-    std::memcpy(req.Spec_FH_next, rd.Spec_FH_snapshot, sizeof(req.Spec_FH_next));
-    std::memcpy(req.Arch_FH_next, rd.Arch_FH_snapshot, sizeof(req.Arch_FH_next));
+    req.Spec_HIST_next = rd.Spec_HIST_snapshot;
+    req.Arch_HIST_next = rd.Arch_HIST_snapshot;
     req.Spec_PATH_next = rd.Spec_PATH_snapshot;
     req.Arch_PATH_next = rd.Arch_PATH_snapshot;
     std::memcpy(req.Arch_ras_stack_next, rd.Arch_ras_stack_snapshot,
@@ -1553,7 +1533,10 @@ public:
       req.tage_done_next[i] = false;
       req.btb_done_next[i] = false;
       req.tage_in[i] = post_req.tage_in[i];
+      req.tage_in[i].hist_in = nullptr; // 历史快照只在本拍 rd 内有效
       req.btb_in[i] = post_req.btb_in[i];
+      req.ittage_in[i] = post_req.ittage_in[i];
+      req.ittage_in[i].hist_in = nullptr; // 同 tage_in
     }
     for (int i = 0; i < FETCH_WIDTH; i++) {
       req.do_pred_on_this_pc[i] = rd.do_pred_on_this_pc[i];
@@ -1595,6 +1578,8 @@ public:
                 sizeof(bind_in.do_pred_on_this_pc));
     std::memcpy(bind_in.this_pc_bank_sel, rd.this_pc_bank_sel,
                 sizeof(bind_in.this_pc_bank_sel));
+    std::memcpy(bind_in.do_pred_for_this_pc, rd.do_pred_for_this_pc,
+                sizeof(bind_in.do_pred_for_this_pc));
     std::memcpy(bind_in.btb_in, post_req.btb_in, sizeof(bind_in.btb_in));
     bind_in.type_out = type_out;
     bpu_submodule_bind_comb(bind_in, bind_out);
@@ -1613,6 +1598,14 @@ public:
         req.btb_in[i] = bind_out.btb_in_with_type[i];
       }
     }
+    ITTAGE_TOP::OutputPayload ittage_out[BPU_BANK_NUM];
+    {
+      FRONTEND_HOST_PROFILE_SCOPE(BpuIttageComb);
+      for (int i = 0; i < BPU_BANK_NUM; i++) {
+        ittage_inst[i]->ittage_comb_calc(post_req.ittage_in[i], rd.ittage_rd[i],
+                                         ittage_out[i], req.ittage_req[i]);
+      }
+    }
     BpuPredictMainCombIn predict_main_in{};
     predict_main_in.refetch = inp.refetch;
     predict_main_in.refetch_address = inp.refetch_address;
@@ -1636,6 +1629,7 @@ public:
     for (int i = 0; i < BPU_BANK_NUM; ++i) {
       predict_main_in.tage_out[i] = tage_out[i];
       predict_main_in.btb_out[i] = btb_out[i];
+      predict_main_in.ittage_out[i] = ittage_out[i];
     }
     BpuPredictMainCombOut predict_main_out{};
     bpu_predict_main_comb(predict_main_in, predict_main_out);
@@ -1694,6 +1688,7 @@ public:
     std::memcpy(hist_in.in_actual_dir, inp.in_actual_dir, sizeof(hist_in.in_actual_dir));
     std::memcpy(hist_in.in_actual_br_type, inp.in_actual_br_type,
                 sizeof(hist_in.in_actual_br_type));
+    std::memcpy(hist_in.in_upd_is_rvc, inp.in_upd_is_rvc, sizeof(hist_in.in_upd_is_rvc));
     std::memcpy(hist_in.in_pred_dir, inp.in_pred_dir, sizeof(hist_in.in_pred_dir));
     hist_in.going_to_do_pred = rd.going_to_do_pred;
     std::memcpy(hist_in.do_pred_on_this_pc, rd.do_pred_on_this_pc,
@@ -1702,14 +1697,8 @@ public:
                 sizeof(hist_in.this_pc_bank_sel));
     std::memcpy(hist_in.do_pred_for_this_pc, rd.do_pred_for_this_pc,
                 sizeof(hist_in.do_pred_for_this_pc));
-    std::memcpy(hist_in.Spec_GHR_snapshot, rd.Spec_GHR_snapshot,
-                sizeof(hist_in.Spec_GHR_snapshot));
-    std::memcpy(hist_in.Spec_FH_snapshot, rd.Spec_FH_snapshot,
-                sizeof(hist_in.Spec_FH_snapshot));
-    std::memcpy(hist_in.Arch_GHR_snapshot, rd.Arch_GHR_snapshot,
-                sizeof(hist_in.Arch_GHR_snapshot));
-    std::memcpy(hist_in.Arch_FH_snapshot, rd.Arch_FH_snapshot,
-                sizeof(hist_in.Arch_FH_snapshot));
+    hist_in.Spec_HIST_snapshot = rd.Spec_HIST_snapshot;
+    hist_in.Arch_HIST_snapshot = rd.Arch_HIST_snapshot;
     hist_in.Spec_PATH_snapshot = rd.Spec_PATH_snapshot;
     hist_in.Arch_PATH_snapshot = rd.Arch_PATH_snapshot;
     std::memcpy(hist_in.Arch_ras_stack_snapshot, rd.Arch_ras_stack_snapshot,
@@ -1725,10 +1714,8 @@ public:
     BpuHistCombOut hist_out{};
     bpu_hist_comb(hist_in, hist_out);
     req.should_update_spec_hist = hist_out.should_update_spec_hist;
-    std::memcpy(req.Spec_GHR_next, hist_out.Spec_GHR_next, sizeof(req.Spec_GHR_next));
-    std::memcpy(req.Spec_FH_next, hist_out.Spec_FH_next, sizeof(req.Spec_FH_next));
-    std::memcpy(req.Arch_GHR_next, hist_out.Arch_GHR_next, sizeof(req.Arch_GHR_next));
-    std::memcpy(req.Arch_FH_next, hist_out.Arch_FH_next, sizeof(req.Arch_FH_next));
+    req.Spec_HIST_next = hist_out.Spec_HIST_next;
+    req.Arch_HIST_next = hist_out.Arch_HIST_next;
     req.Spec_PATH_next = hist_out.Spec_PATH_next;
     req.Arch_PATH_next = hist_out.Arch_PATH_next;
     std::memcpy(req.Arch_ras_stack_next, hist_out.Arch_ras_stack_next,
@@ -1789,13 +1776,13 @@ public:
     if (inp.refetch) {
       req.pc_reg_next = inp.refetch_address;
       req.pc_can_send_to_icache_next = true;
-      req.saved_2ahead_prediction_next = inp.refetch_address + (FETCH_WIDTH * 4);
+      req.saved_2ahead_prediction_next =
+          inp.refetch_address + (FETCH_WIDTH * FETCH_SLOT_BYTES);
       req.saved_2ahead_pred_valid_next = false;
       req.saved_mini_flush_req_next = false;
       req.saved_mini_flush_correct_next = false;
       req.saved_mini_flush_target_next = 0;
-      std::memcpy(req.Spec_GHR_next, req.Arch_GHR_next, sizeof(req.Spec_GHR_next));
-      std::memcpy(req.Spec_FH_next, req.Arch_FH_next, sizeof(req.Spec_FH_next));
+      req.Spec_HIST_next = req.Arch_HIST_next;
       req.Spec_PATH_next = req.Arch_PATH_next;
 #ifdef ENABLE_BPU_RAS
       std::memcpy(req.Spec_ras_stack_next, req.Arch_ras_stack_next,
@@ -1817,6 +1804,9 @@ public:
                      bool reset) {
     if (reset) {
       type_pred_inst->reset();
+      for (int i = 0; i < BPU_BANK_NUM; i++) {
+        ittage_inst[i]->reset();
+      }
       reset_internal_all();
       return;
     }
@@ -1825,6 +1815,7 @@ public:
     for (int i = 0; i < BPU_BANK_NUM; i++) {
       tage_inst[i]->tage_seq_write(req.tage_in[i], req.tage_req[i], false);
       btb_inst[i]->btb_seq_write(req.btb_in[i], req.btb_req[i], false);
+      ittage_inst[i]->ittage_seq_write(req.ittage_in[i], req.ittage_req[i], false);
       tage_done[i] = req.tage_done_next[i];
       btb_done[i] = req.btb_done_next[i];
     }
@@ -1865,10 +1856,8 @@ public:
     nlp_s2_hit = req.nlp_s2_hit_next;
     nlp_s2_conf = req.nlp_s2_conf_next;
 
-    std::memcpy(Spec_GHR, req.Spec_GHR_next, sizeof(Spec_GHR));
-    std::memcpy(Arch_GHR, req.Arch_GHR_next, sizeof(Arch_GHR));
-    std::memcpy(Spec_FH, req.Spec_FH_next, sizeof(Spec_FH));
-    std::memcpy(Arch_FH, req.Arch_FH_next, sizeof(Arch_FH));
+    Spec_HIST = req.Spec_HIST_next;
+    Arch_HIST = req.Arch_HIST_next;
     Spec_PATH = req.Spec_PATH_next;
     Arch_PATH = req.Arch_PATH_next;
     std::memcpy(Arch_ras_stack, req.Arch_ras_stack_next, sizeof(Arch_ras_stack));
@@ -1931,10 +1920,28 @@ public:
     for (int i = 0; i < BPU_BANK_NUM; i++) {
       delete tage_inst[i];
       delete btb_inst[i];
+      delete ittage_inst[i];
     }
     delete type_pred_inst;
   }
 
+  // 各 bank ITTAGE 统计汇总（仅用于仿真结束时的报告）
+  ITTAGE_TOP::Stats ittage_stats() const {
+    ITTAGE_TOP::Stats sum;
+    std::memset(&sum, 0, sizeof(sum));
+    for (int i = 0; i < BPU_BANK_NUM; i++) {
+      const ITTAGE_TOP::Stats &s = ittage_inst[i]->get_stats();
+      sum.upd_num += s.upd_num;
+      sum.alloc_fail += s.alloc_fail;
+      for (int t = 0; t < TN_MAX; t++) {
+        sum.provider_hit[t] += s.provider_hit[t];
+        sum.provider_correct[t] += s.provider_correct[t];
+        sum.alloc[t] += s.alloc[t];
+      }
+    }
+    return sum;
+  }
+
   void reset_internal_all() {
     DEBUG_LOG_SMALL_4("reset_internal_all\n");
     pc_reg = RESET_PC;
@@ -1947,10 +1954,8 @@ public:
       do_upd_latch[i] = false;
 
     // 初始化全局GHR/FH（从TAGE迁移过来）
-    std::memset(Arch_GHR, 0, sizeof(Arch_GHR));
-    std::memset(Spec_GHR, 0, sizeof(Spec_GHR));
-    std::memset(Arch_FH, 0, sizeof(Arch_FH));
-    std::memset(Spec_FH, 0, sizeof(Spec_FH));
+    std::memset(&Arch_HIST, 0, sizeof(Arch_HIST));
+    std::memset(&Spec_HIST, 0, sizeof(Spec_HIST));
     Arch_PATH = 0;
     Spec_PATH = 0;
     std::memset(Arch_ras_stack, 0, sizeof(Arch_ras_stack));
@@ -1996,7 +2001,7 @@ public:
     }
     // 初始化2-ahead预测器为下一个cache line的地址
     DEBUG_LOG_SMALL_4("reset_internal_all,pc_reg: %x\n", pc_reg);
-    saved_2ahead_prediction = pc_reg + (FETCH_WIDTH * 4);
+    saved_2ahead_prediction = pc_reg + (FETCH_WIDTH * FETCH_SLOT_BYTES);
     DEBUG_LOG_SMALL_4("reset_internal_all,saved_2ahead_prediction: %x\n", saved_2ahead_prediction);
     saved_2ahead_pred_valid = false;
     saved_mini_flush_req = false;
@@ -2041,17 +2046,13 @@ public:
                 sizeof(post_read_in.in_upd_valid));
     std::memcpy(post_read_in.in_actual_br_type, inp.in_actual_br_type,
                 sizeof(post_read_in.in_actual_br_type));
+    std::memcpy(post_read_in.in_upd_is_rvc, inp.in_upd_is_rvc,
+                sizeof(post_read_in.in_upd_is_rvc));
 #ifdef SPECULATIVE_ON
-    std::memcpy(post_read_in.ghr_snapshot, rd.Spec_GHR_snapshot,
-                sizeof(post_read_in.ghr_snapshot));
-    std::memcpy(post_read_in.fh_snapshot, rd.Spec_FH_snapshot,
-                sizeof(post_read_in.fh_snapshot));
+    post_read_in.hist_snapshot = &rd.Spec_HIST_snapshot;
     post_read_in.path_snapshot = rd.Spec_PATH_snapshot;
 #else
-    std::memcpy(post_read_in.ghr_snapshot, rd.Arch_GHR_snapshot,
-                sizeof(post_read_in.ghr_snapshot));
-    std::memcpy(post_read_in.fh_snapshot, rd.Arch_FH_snapshot,
-                sizeof(post_read_in.fh_snapshot));
+    post_read_in.hist_snapshot = &rd.Arch_HIST_snapshot;
     post_read_in.path_snapshot = rd.Arch_PATH_snapshot;
 #endif
     post_read_in.pred_base_pc = rd.pred_base_pc;
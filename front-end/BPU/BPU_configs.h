@@ -215,12 +215,40 @@ static_assert(TC_ENTRY_NUM <= (1u << 16),
 #error "INDIRECT_TC_INIT_USEFUL must be in [0, 7]"
 #endif
 
+#if ITTAGE_ENTRY_NUM <= 0 || (ITTAGE_ENTRY_NUM & (ITTAGE_ENTRY_NUM - 1)) != 0
+#error "ITTAGE_ENTRY_NUM must be power of two and > 0"
+#endif
+
+static_assert(ITTAGE_ENTRY_NUM <= TN_ENTRY_NUM,
+              "ITTAGE index is taken from the TAGE tagged-table index; "
+              "ITTAGE_ENTRY_NUM must be <= TN_ENTRY_NUM");
+
+#if ITTAGE_TAG_WIDTH <= 0 || ITTAGE_TAG_WIDTH > 16
+#error "ITTAGE_TAG_WIDTH must be in [1, 16] with current wire_for_bits_t coverage"
+#endif
+
+#if ITTAGE_CONF_BITS <= 0 || ITTAGE_CONF_BITS > 8
+#error "ITTAGE_CONF_BITS must be in [1, 8]"
+#endif
+
+#if ITTAGE_CONF_THRESHOLD < 0 || ITTAGE_CONF_THRESHOLD > ((1 << ITTAGE_CONF_BITS) - 1)
+#error "ITTAGE_CONF_THRESHOLD must be in [0, (1<<ITTAGE_CONF_BITS)-1]"
+#endif
+
+#if ITTAGE_USEFUL_BITS <= 0 || ITTAGE_USEFUL_BITS > 8
+#error "ITTAGE_USEFUL_BITS must be in [1, 8]"
+#endif
+
 #define BTB_IDX_MASK    (BTB_ENTRY_NUM - 1)
 #define BTB_TAG_MASK    ((1 << BTB_TAG_LEN) - 1)
 #define BTB_TYPE_IDX_MASK (BTB_TYPE_ENTRY_NUM - 1)
 #define BHT_IDX_MASK    (BHT_ENTRY_NUM - 1)
 #define TC_ENTRY_MASK   (TC_ENTRY_NUM - 1)
 #define TC_TAG_MASK     ((1 << TC_TAG_LEN) - 1)
+#define ITTAGE_IDX_MASK (ITTAGE_ENTRY_NUM - 1)
+#define ITTAGE_TAG_MASK ((1 << ITTAGE_TAG_WIDTH) - 1)
+#define ITTAGE_CONF_MAX ((1 << ITTAGE_CONF_BITS) - 1)
+#define ITTAGE_USEFUL_MAX ((1 << ITTAGE_USEFUL_BITS) - 1)
 
 // Branch Types
 #define BR_DIRECT 0 // only cond now
@@ -161,18 +161,6 @@ static inline wire16_t abs_diff_u16(wire16_t a, wire16_t b) {
   return (a >= b) ? static_cast<wire16_t>(a - b) : static_cast<wire16_t>(b - a);
 }
 
-static inline uint32_t scl_fold_ghr_idx(const wire1_t ghr[GHR_LENGTH],
-                                        int hist_len, int idx_bits) {
-  uint32_t folded = 0;
-  for (int i = 0; i < hist_len && i < GHR_LENGTH; ++i) {
-    const uint32_t bit = static_cast<uint32_t>(ghr[i] ? 1 : 0);
-    folded ^= (bit << (i % idx_bits));
-    folded ^= (bit << ((i * 7) % idx_bits));
-  }
-  const uint32_t mask = (idx_bits >= 32) ? 0xffffffffu : ((1u << idx_bits) - 1u);
-  return folded & mask;
-}
-
 static inline uint32_t scl_fold_path_idx(tage_path_hist_t path_hist, int hist_len,
                                          int idx_bits) {
   uint32_t path = static_cast<uint32_t>(path_hist) & TAGE_SC_PATH_MASK;
@@ -214,82 +202,104 @@ static inline tage_loop_iter_t loop_sat_dec(tage_loop_iter_t v) {
 }
 
 // ============================================================================
-// 2.1 GHR/FH更新组合逻辑函数（提取为公共函数供BPU使用）
+// 2.1 GHR/FH 历史寄存器（打包移位寄存器 + 折叠历史引擎，供BPU统一维护）
 // ============================================================================
+//
+// GHR 按 64bit 字打包：逻辑位 i（0 为最新方向）位于 ghr[i / 64] 的第 i % 64 位，
+// 移入一位即各字左移 1 并串接低位字的最高位。
+// 折叠历史：长度 L 的 GHR 窗口中第 i 位异或到 (i * stride) % width 位置；
+// 移入一位时循环左移 stride、补入新位，并消去移出窗口的第 L-1 位，O(1) 完成。
+// TAGE 各表 FH（stride = 1）与 SC-L 的 GHR 折叠索引共用这一套更新。
+
+constexpr int GHR_WORD_NUM = (GHR_LENGTH + 63) / 64;
+constexpr uint32_t kTageGhrLength[TN_MAX] = {8, 13, 32, 119};
+constexpr uint32_t kTageFhLength[FH_N_MAX][TN_MAX] = {
+    {8, 11, 11, 11}, {8, 8, 8, 8}, {7, 7, 7, 7}};
+#if ENABLE_TAGE_SC_L
+constexpr int kTageSclIdxBits = ceil_log2_u32(TAGE_SC_L_ENTRY_NUM);
+constexpr uint32_t kTageSclHistLen[BPU_SCL_META_NTABLE] = {0, 4, 8, 16, 32, 64, 128, 256};
+// SC-L 索引折叠 = 位 i 异或到 i % bits 与 (i * 7) % bits 两处，各用一个折叠寄存器
+constexpr uint32_t kTageSclFoldStride[2] = {1u % kTageSclIdxBits, 7u % kTageSclIdxBits};
+#endif
 
-struct TageGhrUpdateCombIn {
-  wire1_t current_GHR[GHR_LENGTH];
-  wire1_t real_dir;
-};
-
-struct TageGhrUpdateCombOut {
-  wire1_t next_GHR[GHR_LENGTH];
-};
-
-struct TageFhUpdateCombIn {
-  wire32_t current_FH[FH_N_MAX][TN_MAX];
-  wire1_t current_GHR[GHR_LENGTH];
-  wire1_t new_history;
-  uint32_t fh_len[FH_N_MAX][TN_MAX];
-  uint32_t ghr_len[TN_MAX];
+struct TageHistory {
+  wire64_t ghr[GHR_WORD_NUM];
+  wire32_t fh[FH_N_MAX][TN_MAX];
+#if ENABLE_TAGE_SC_L
+  wire32_t scl_fold[2][BPU_SCL_META_NTABLE];
+#endif
 };
 
-struct TageFhUpdateCombOut {
-  wire32_t next_FH[FH_N_MAX][TN_MAX];
-};
+static inline wire1_t tage_ghr_bit(const TageHistory &hist, uint32_t i) {
+  return ((hist.ghr[i >> 6] >> (i & 63)) & 0x1) != 0;
+}
 
-static inline void tage_ghr_update_comb(const TageGhrUpdateCombIn &in,
-                                        TageGhrUpdateCombOut &out) {
-  out = TageGhrUpdateCombOut{};
-  for (int i = GHR_LENGTH - 1; i > 0; i--) {
-    out.next_GHR[i] = in.current_GHR[i - 1];
+static inline wire32_t tage_fold_shift(wire32_t val, uint32_t width, uint32_t stride,
+                                       uint32_t hist_len, wire1_t new_bit,
+                                       wire1_t out_bit) {
+  const uint32_t mask = (1u << width) - 1u;
+  if (stride != 0) {
+    val = ((val << stride) | (val >> (width - stride))) & mask;
   }
-  out.next_GHR[0] = in.real_dir;
+  val ^= static_cast<uint32_t>(new_bit);
+  val ^= static_cast<uint32_t>(out_bit) << ((hist_len * stride) % width);
+  return val;
 }
 
-static inline void tage_fh_update_comb(const TageFhUpdateCombIn &in,
-                                       TageFhUpdateCombOut &out) {
-  out = TageFhUpdateCombOut{};
+// 原地移入一位方向：先用旧 GHR 更新各折叠寄存器，再移位 GHR
+static inline void tage_history_shift(TageHistory &hist, wire1_t new_history) {
   for (int k = 0; k < FH_N_MAX; k++) {
     for (int i = 0; i < TN_MAX; i++) {
-      uint32_t val = in.current_FH[k][i];
-      uint32_t len = in.fh_len[k][i];
-      bool old_highest = ((val >> (len - 1)) & 0x1) != 0;
-      val = (val << 1) & ((0x1 << len) - 1);
-      val |= static_cast<uint32_t>(in.new_history ^ old_highest);
-      uint32_t ghr_idx = in.ghr_len[i];
-      val ^= static_cast<uint32_t>(in.current_GHR[ghr_idx - 1]) << (ghr_idx % len);
-      out.next_FH[k][i] = val;
+      const uint32_t ghr_len = kTageGhrLength[i];
+      hist.fh[k][i] =
+          tage_fold_shift(hist.fh[k][i], kTageFhLength[k][i], 1, ghr_len,
+                          new_history, tage_ghr_bit(hist, ghr_len - 1));
     }
   }
+#if ENABLE_TAGE_SC_L
+  for (int t = 0; t < BPU_SCL_META_NTABLE; t++) {
+    const uint32_t len = kTageSclHistLen[t] < GHR_LENGTH ? kTageSclHistLen[t] : GHR_LENGTH;
+    if (len == 0) {
+      continue;
+    }
+    const wire1_t out_bit = tage_ghr_bit(hist, len - 1);
+    for (int f = 0; f < 2; f++) {
+      hist.scl_fold[f][t] = tage_fold_shift(hist.scl_fold[f][t], kTageSclIdxBits,
+                                            kTageSclFoldStride[f], len, new_history,
+                                            out_bit);
+    }
+  }
+#endif
+  for (int w = GHR_WORD_NUM - 1; w > 0; w--) {
+    hist.ghr[w] = (hist.ghr[w] << 1) | (hist.ghr[w - 1] >> 63);
+  }
+  hist.ghr[0] = (hist.ghr[0] << 1) | static_cast<wire64_t>(new_history);
+  if (GHR_LENGTH % 64 != 0) {
+    hist.ghr[GHR_WORD_NUM - 1] &= (wire64_t{1} << (GHR_LENGTH % 64)) - 1;
+  }
 }
 
-static inline void tage_ghr_update_apply(const wire1_t current_GHR[GHR_LENGTH],
-                                         wire1_t real_dir,
-                                         wire1_t next_GHR[GHR_LENGTH]) {
-  TageGhrUpdateCombOut out{};
-  TageGhrUpdateCombIn in{};
-  std::memcpy(in.current_GHR, current_GHR, sizeof(in.current_GHR));
-  in.real_dir = real_dir;
-  tage_ghr_update_comb(in, out);
-  std::memcpy(next_GHR, out.next_GHR, sizeof(out.next_GHR));
+// 第 t 张 tagged 表的 index/tag 哈希（pc 为 bank 内 pc）。
+// ITTAGE 与 TAGE 共用这组哈希，因而可直接用随指令回传的 TAGE idx/tag 训练。
+static inline tage_idx_t tage_table_index_hash(pc_t pc,
+                                               const wire32_t (&fh)[FH_N_MAX][TN_MAX],
+                                               int t) {
+  return static_cast<tage_idx_t>((fh[0][t] ^ (pc >> 2)) & (TAGE_IDX_MASK));
 }
 
-static inline void tage_fh_update_apply(
-    const wire32_t current_FH[FH_N_MAX][TN_MAX], const wire1_t current_GHR[GHR_LENGTH],
-    wire1_t new_history, wire32_t next_FH[FH_N_MAX][TN_MAX],
-    const uint32_t fh_len[FH_N_MAX][TN_MAX], const uint32_t ghr_len[TN_MAX]) {
-  TageFhUpdateCombOut out{};
-  TageFhUpdateCombIn in{};
-  std::memcpy(in.current_FH, current_FH, sizeof(in.current_FH));
-  std::memcpy(in.current_GHR, current_GHR, sizeof(in.current_GHR));
-  in.new_history = new_history;
-  std::memcpy(in.fh_len, fh_len, sizeof(in.fh_len));
-  std::memcpy(in.ghr_len, ghr_len, sizeof(in.ghr_len));
-  tage_fh_update_comb(in, out);
-  std::memcpy(next_FH, out.next_FH, sizeof(out.next_FH));
+static inline tage_tag_t tage_table_tag_hash(pc_t pc,
+                                             const wire32_t (&fh)[FH_N_MAX][TN_MAX],
+                                             int t) {
+  return static_cast<tage_tag_t>((fh[1][t] ^ fh[2][t] ^ (pc >> 2)) & (TAGE_TAG_MASK));
 }
 
+#if ENABLE_TAGE_SC_L
+// 等价于对 GHR 前 kTageSclHistLen[t] 位逐位折叠得到的 SC-L 索引分量
+static inline uint32_t tage_scl_folded_ghr(const TageHistory &hist, int t) {
+  return hist.scl_fold[0][t] ^ hist.scl_fold[1][t];
+}
+#endif
+
 // ============================================================================
 // 3. 核心逻辑类 (TAGE_TOP Class)
 // ============================================================================
@@ -312,8 +322,7 @@ public:
   struct InputPayload {
     wire1_t pred_req;
     pc_t pc_pred_in;
-    wire1_t ghr_in[GHR_LENGTH];
-    wire32_t fh_in[FH_N_MAX][TN_MAX];
+    const TageHistory *hist_in; // BPU 历史快照，各 bank 共享只读
     tage_path_hist_t path_in;
     wire1_t update_en;
     pc_t pc_update_in;
@@ -362,8 +371,6 @@ public:
   // 状态输入结构体（包含所有寄存器）
   struct StateInput {
     tage_state_t state;
-    wire32_t FH[FH_N_MAX][TN_MAX];
-    wire1_t GHR[GHR_LENGTH];
     wire1_t LSFR[4];
     tage_reset_ctr_t reset_cnt_reg;
     // int8_t use_alt_ctr_reg;
@@ -705,11 +712,6 @@ private:
   LoopEntry loop_table[TAGE_LOOP_ENTRY_NUM];
 #endif
 
-  // FH constants
-  const uint32_t ghr_length[TN_MAX] = {8, 13, 32, 119};
-  const uint32_t fh_length[FH_N_MAX][TN_MAX] = {
-      {8, 11, 11, 11}, {8, 8, 8, 8}, {7, 7, 7, 7}};
-
   // Pipeline Registers
   tage_state_t state;
   wire1_t do_pred_latch;
@@ -851,20 +853,17 @@ public:
     TagePredIndexCombOut pred_index_out{};
     TagePredIndexCombIn pred_index_in{};
     pred_index_in.pc = in.inp.pc_pred_in;
-    std::memcpy(pred_index_in.fh_in, in.inp.fh_in, sizeof(pred_index_in.fh_in));
+    std::memcpy(pred_index_in.fh_in, in.inp.hist_in->fh, sizeof(pred_index_in.fh_in));
     tage_pred_index_comb(pred_index_in, pred_index_out);
 
     out.pred_read_valid = true;
     out.pred_idx_tag = pred_index_out.index_tag;
     out.pred_sc_idx = tage_sc_idx_from_pc(in.inp.pc_pred_in);
 #if ENABLE_TAGE_SC_L
-    static constexpr int kSclIdxBits = ceil_log2_u32(TAGE_SC_L_ENTRY_NUM);
     static constexpr uint32_t kSclMask = TAGE_SC_L_ENTRY_NUM - 1;
-    static constexpr int kHistLen[BPU_SCL_META_NTABLE] = {0, 4, 8, 16, 32, 64, 128, 256};
     static constexpr int kPathHistLen[BPU_SCL_META_NTABLE] = {0, 4, 8, 12, 16, 20, 24, 28};
     for (int t = 0; t < BPU_SCL_META_NTABLE; ++t) {
-      const uint32_t folded =
-          scl_fold_ghr_idx(in.inp.ghr_in, kHistLen[t], kSclIdxBits);
+      const uint32_t folded = tage_scl_folded_ghr(*in.inp.hist_in, t);
       uint32_t mix = (in.inp.pc_pred_in >> 2);
       mix ^= (mix >> 11);
       mix ^= (mix >> 19);
@@ -872,7 +871,7 @@ public:
       mix ^= (folded << 1);
 #if ENABLE_TAGE_SC_PATH
       const uint32_t path_folded =
-          scl_fold_path_idx(in.inp.path_in, kPathHistLen[t], kSclIdxBits);
+          scl_fold_path_idx(in.inp.path_in, kPathHistLen[t], kTageSclIdxBits);
       mix ^= path_folded;
       mix ^= (path_folded << 2);
       mix ^= (path_folded >> 1);
@@ -981,21 +980,19 @@ public:
       }
 #if ENABLE_TAGE_SC_L
       // Compute SC-L indices and sum; override decision can be tuned later.
-      static constexpr int kSclIdxBits = ceil_log2_u32(TAGE_SC_L_ENTRY_NUM);
       static constexpr uint32_t kSclMask = TAGE_SC_L_ENTRY_NUM - 1;
-      static constexpr int kHistLen[BPU_SCL_META_NTABLE] = {0, 4, 8, 16, 32, 64, 128, 256};
       static constexpr int kPathHistLen[BPU_SCL_META_NTABLE] = {0, 4, 8, 12, 16, 20, 24, 28};
       // int16_t sum = 0;
       wire16_t sum_raw = 0;
       for (int t = 0; t < BPU_SCL_META_NTABLE; ++t) {
-        const uint32_t folded = scl_fold_ghr_idx(rd.state_in.GHR, kHistLen[t], kSclIdxBits);
+        const uint32_t folded = tage_scl_folded_ghr(*inp.hist_in, t);
         uint32_t mix = (inp.pc_pred_in >> 2);
         mix ^= (mix >> 11);
         mix ^= (mix >> 19);
         mix ^= folded;
         mix ^= (folded << 1);
 #if ENABLE_TAGE_SC_PATH
-        const uint32_t path_folded = scl_fold_path_idx(inp.path_in, kPathHistLen[t], kSclIdxBits);
+        const uint32_t path_folded = scl_fold_path_idx(inp.path_in, kPathHistLen[t], kTageSclIdxBits);
         mix ^= path_folded;
         mix ^= (path_folded << 2);
         mix ^= (path_folded >> 1);
@@ -1278,18 +1275,10 @@ public:
 
   void tage_seq_read(const InputPayload &inp, ReadData &rd) const {
     std::memset(&rd, 0, sizeof(ReadData));
+    (void)inp; // 历史由 BPU 维护，经 inp.hist_in 直接供组合逻辑读取
 
     rd.state_in.state = state;
 
-    for (int k = 0; k < FH_N_MAX; ++k) {
-      for (int i = 0; i < TN_MAX; ++i) {
-        rd.state_in.FH[k][i] = inp.fh_in[k][i];
-      }
-    }
-    for (int i = 0; i < GHR_LENGTH; ++i) {
-      rd.state_in.GHR[i] = inp.ghr_in[i];
-    }
-
     for (int i = 0; i < 4; ++i) {
       rd.state_in.LSFR[i] = LSFR[i];
     }
@@ -1615,10 +1604,8 @@ private:
 
     out.index_tag.base_idx = (in.pc >> 2) & (TAGE_BASE_IDX_MASK);
     for (int i = 0; i < TN_MAX; i++) {
-      out.index_tag.index_info.tag[i] =
-          (in.fh_in[1][i] ^ in.fh_in[2][i] ^ (in.pc >> 2)) & (TAGE_TAG_MASK);
-      out.index_tag.index_info.tage_index[i] =
-          (in.fh_in[0][i] ^ (in.pc >> 2)) & (TAGE_IDX_MASK);
+      out.index_tag.index_info.tag[i] = tage_table_tag_hash(in.pc, in.fh_in, i);
+      out.index_tag.index_info.tage_index[i] = tage_table_index_hash(in.pc, in.fh_in, i);
     }
   }
 
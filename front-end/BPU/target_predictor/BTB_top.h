@@ -42,6 +42,7 @@ public:
     pc_t pred_pc;
     wire1_t pred_req;
     br_type_t pred_type_in;
+    pc_t pred_fallthrough_in; // 顺序下一条指令地址（pc + 2/4），未命中时作为预测目标
     wire1_t upd_valid;
     pc_t upd_pc;
     target_addr_t upd_actual_addr;
@@ -424,6 +425,7 @@ public:
   struct BtbPredOutputCombIn {
     pc_t pc;
     br_type_t br_type;
+    pc_t fallthrough;
     HitCheckOut hit_info;
     BtbSetData set_data;
     TcSetData tc_set;
@@ -727,8 +729,8 @@ public:
       btb_hit_check_comb(BtbHitCheckCombIn{rd.pred_btb_set, rd.pred_tag}, pred_hit_out);
       BtbPredOutputCombOut pred_out{};
       btb_pred_output_comb(
-          BtbPredOutputCombIn{inp.pred_pc, inp.pred_type_in, pred_hit_out.hit_info,
-                              rd.pred_btb_set, rd.pred_tc_set},
+          BtbPredOutputCombIn{inp.pred_pc, inp.pred_type_in, inp.pred_fallthrough_in,
+                              pred_hit_out.hit_info, rd.pred_btb_set, rd.pred_tc_set},
           pred_out);
       out.pred_target = pred_out.pred_target;
       out.btb_pred_out_valid = true;
@@ -1168,7 +1170,7 @@ private:
     if (type == BR_IDIRECT) {
       uint32_t expected_tc_tag = tc_get_tag_value(in.pc);
       bool tc_hit = false;
-      uint32_t tc_target = in.pc + 4;
+      uint32_t tc_target = in.fallthrough;
       for (int way = 0; way < TC_WAY_NUM; way++) {
         if (in.tc_set.valid[way] && in.tc_set.tag[way] == expected_tc_tag) {
           tc_hit = true;
@@ -1183,7 +1185,7 @@ private:
         out.pred_target = in.set_data.bta[in.hit_info.hit_way];
 #endif
       } else {
-        out.pred_target = in.pc + 4;
+        out.pred_target = in.fallthrough;
       }
       return;
     } else if (type == BR_DIRECT || type == BR_CALL || type == BR_JAL ||
@@ -1192,10 +1194,10 @@ private:
         out.pred_target = in.set_data.bta[in.hit_info.hit_way];
         return;
       }
-      out.pred_target = in.pc + 4;
+      out.pred_target = in.fallthrough;
       return;
     }
-    out.pred_target = in.pc + 4;
+    out.pred_target = in.fallthrough;
   }
 
   static void btb_victim_select_comb(const BtbVictimSelectCombIn &in,
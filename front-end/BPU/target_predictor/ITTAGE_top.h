@@ -0,0 +1,403 @@
+#ifndef ITTAGE_TOP_H
+#define ITTAGE_TOP_H
+
+#include "../../frontend.h"
+#include "../BPU_configs.h"
+#include "../dir_predictor/TAGE_top.h"
+
+#include <cstdint>
+#include <cstring>
+
+// ============================================================================
+// ITTAGE_TOP：历史索引的多表间接跳转目标预测器（与 BTB_TOP 并列，每 bank 一份）
+//
+// - TN_MAX 张 tagged 表与 TAGE 各表一一对应：index/tag 由 TAGE 的折叠历史
+//   经 tage_table_index_hash / tage_table_tag_hash 得到，再截取 ITTAGE 位宽
+//   （tag 额外拼接 pc 高位）；
+// - 预测：命中的最长表为 provider，次长为 alt；provider 置信度不足时退到
+//   alt，两者都不可信时输出无效，由 BTB/TC 给出目标；
+// - 训练：提交路径上 BR_IDIRECT 的更新沿用随指令回传的 TAGE idx/tag 元数据，
+//   与预测时的索引一致，不需要额外的后端元数据通路；
+// - 每表每项带 useful 计数器：provider 与 alt 目标不同时按对错增减；
+//   provider 未命中或预测错时向更长的表分配，分配失败则递减候选项 useful。
+// ============================================================================
+
+struct IttageEntry {
+  wire1_t valid;
+  ittage_tag_t tag;
+  target_addr_t target;
+  ittage_conf_t conf;
+  ittage_useful_t useful;
+};
+
+class ITTAGE_TOP {
+public:
+  struct InputPayload {
+    wire1_t pred_req;
+    pc_t pred_pc;
+    const TageHistory *hist_in; // BPU 历史快照，各 bank 共享只读
+    wire1_t upd_valid;
+    pc_t upd_pc;
+    target_addr_t upd_actual_addr;
+    tage_idx_t upd_tage_idx[TN_MAX];
+    tage_tag_t upd_tage_tag[TN_MAX];
+  };
+
+  struct OutputPayload {
+    wire1_t pred_valid; // 置 1 时覆盖 BTB/TC 的间接跳转目标
+    target_addr_t pred_target;
+    ittage_table_sel_t provider; // 0 = 未命中，t + 1 = 第 t 张表
+  };
+
+  struct ReadData {
+    IttageEntry pred_entries[TN_MAX];
+    IttageEntry upd_entries[TN_MAX];
+  };
+
+  struct CombResult {
+    wire1_t write_en[TN_MAX];
+    ittage_idx_t write_idx[TN_MAX];
+    IttageEntry write_entry[TN_MAX];
+
+    // 仅用于统计
+    wire1_t stat_upd;
+    ittage_table_sel_t stat_provider;
+    wire1_t stat_provider_correct;
+    ittage_table_sel_t stat_alloc; // 0 = 未分配
+    wire1_t stat_alloc_fail;
+  };
+
+  // 按表统计（provider 命中/正确、分配），各 bank 由 BPU_TOP 汇总
+  struct Stats {
+    uint64_t upd_num;
+    uint64_t provider_hit[TN_MAX];
+    uint64_t provider_correct[TN_MAX];
+    uint64_t alloc[TN_MAX];
+    uint64_t alloc_fail;
+  };
+
+  struct IttageIndexCombIn {
+    pc_t pc;
+    tage_idx_t tage_idx[TN_MAX];
+    tage_tag_t tage_tag[TN_MAX];
+  };
+
+  struct IttageIndexCombOut {
+    ittage_idx_t idx[TN_MAX];
+    ittage_tag_t tag[TN_MAX];
+  };
+
+  struct ReadReqCombOut {
+    wire1_t read_enable;
+    ittage_idx_t idx[TN_MAX];
+    ittage_tag_t tag[TN_MAX];
+  };
+
+  struct PreReadCombOut {
+    ReadReqCombOut pred_req;
+    ReadReqCombOut upd_req;
+  };
+
+  struct IttageCombIn {
+    InputPayload inp;
+    PreReadCombOut pre_read;
+    ReadData rd;
+  };
+
+  struct IttageCombOut {
+    OutputPayload out_regs;
+    CombResult req;
+  };
+
+  struct IttageLookupCombIn {
+    IttageEntry entries[TN_MAX];
+    ittage_tag_t tag[TN_MAX];
+  };
+
+  struct IttageLookupCombOut {
+    wire1_t provider_hit;
+    ittage_table_sel_t provider_table;
+    wire1_t alt_hit;
+    ittage_table_sel_t alt_table;
+  };
+
+  struct IttageUpdateCombIn {
+    IttageEntry entries[TN_MAX];
+    ittage_idx_t idx[TN_MAX];
+    ittage_tag_t tag[TN_MAX];
+    target_addr_t actual_target;
+  };
+
+private:
+  IttageEntry table[TN_MAX][ITTAGE_ENTRY_NUM];
+  Stats stats;
+
+  static ittage_conf_t conf_inc(ittage_conf_t v) {
+    return (v >= static_cast<ittage_conf_t>(ITTAGE_CONF_MAX))
+               ? static_cast<ittage_conf_t>(ITTAGE_CONF_MAX)
+               : static_cast<ittage_conf_t>(v + 1);
+  }
+
+  static ittage_useful_t useful_inc(ittage_useful_t v) {
+    return (v >= static_cast<ittage_useful_t>(ITTAGE_USEFUL_MAX))
+               ? static_cast<ittage_useful_t>(ITTAGE_USEFUL_MAX)
+               : static_cast<ittage_useful_t>(v + 1);
+  }
+
+  static ittage_useful_t useful_dec(ittage_useful_t v) {
+    return (v == 0) ? 0 : static_cast<ittage_useful_t>(v - 1);
+  }
+
+  // TAGE 表索引截取低位；tag 在 TAGE tag 之上拼接 pc 高位以减少别名
+  static void ittage_index_comb(const IttageIndexCombIn &in, IttageIndexCombOut &out) {
+    out = IttageIndexCombOut{};
+    const uint32_t pc_hi = (in.pc >> 2) >> ceil_log2_u32(ITTAGE_ENTRY_NUM);
+    for (int t = 0; t < TN_MAX; ++t) {
+      out.idx[t] = static_cast<ittage_idx_t>(in.tage_idx[t] & ITTAGE_IDX_MASK);
+      const uint32_t raw_tag =
+          static_cast<uint32_t>(in.tage_tag[t]) | (pc_hi << TAGE_TAG_WIDTH);
+      out.tag[t] = static_cast<ittage_tag_t>(raw_tag & ITTAGE_TAG_MASK);
+    }
+  }
+
+  static void pred_read_req_comb(const InputPayload &in, ReadReqCombOut &out) {
+    std::memset(&out, 0, sizeof(out));
+    if (!in.pred_req) {
+      return;
+    }
+    IttageIndexCombIn idx_in{};
+    idx_in.pc = in.pred_pc;
+    for (int t = 0; t < TN_MAX; ++t) {
+      idx_in.tage_idx[t] = tage_table_index_hash(in.pred_pc, in.hist_in->fh, t);
+      idx_in.tage_tag[t] = tage_table_tag_hash(in.pred_pc, in.hist_in->fh, t);
+    }
+    IttageIndexCombOut idx_out{};
+    ittage_index_comb(idx_in, idx_out);
+    out.read_enable = true;
+    for (int t = 0; t < TN_MAX; ++t) {
+      out.idx[t] = idx_out.idx[t];
+      out.tag[t] = idx_out.tag[t];
+    }
+  }
+
+  static void upd_read_req_comb(const InputPayload &in, ReadReqCombOut &out) {
+    std::memset(&out, 0, sizeof(out));
+    if (!in.upd_valid) {
+      return;
+    }
+    IttageIndexCombIn idx_in{};
+    idx_in.pc = in.upd_pc;
+    for (int t = 0; t < TN_MAX; ++t) {
+      idx_in.tage_idx[t] = in.upd_tage_idx[t];
+      idx_in.tage_tag[t] = in.upd_tage_tag[t];
+    }
+    IttageIndexCombOut idx_out{};
+    ittage_index_comb(idx_in, idx_out);
+    out.read_enable = true;
+    for (int t = 0; t < TN_MAX; ++t) {
+      out.idx[t] = idx_out.idx[t];
+      out.tag[t] = idx_out.tag[t];
+    }
+  }
+
+  // provider = 命中的最长表，alt = 次长表
+  static void lookup_comb(const IttageLookupCombIn &in, IttageLookupCombOut &out) {
+    out = IttageLookupCombOut{};
+    for (int t = TN_MAX - 1; t >= 0; --t) {
+      if (!in.entries[t].valid || in.entries[t].tag != in.tag[t]) {
+        continue;
+      }
+      if (!out.provider_hit) {
+        out.provider_hit = true;
+        out.provider_table = static_cast<ittage_table_sel_t>(t);
+      } else {
+        out.alt_hit = true;
+        out.alt_table = static_cast<ittage_table_sel_t>(t);
+        return;
+      }
+    }
+  }
+
+  static void ittage_update_comb(const IttageUpdateCombIn &in, CombResult &req) {
+    IttageLookupCombIn lookup_in{};
+    for (int t = 0; t < TN_MAX; ++t) {
+      lookup_in.entries[t] = in.entries[t];
+      lookup_in.tag[t] = in.tag[t];
+    }
+    IttageLookupCombOut lk{};
+    lookup_comb(lookup_in, lk);
+
+    req.stat_upd = true;
+    bool provider_correct = false;
+    int alloc_from = 0;
+    if (lk.provider_hit) {
+      const int p = lk.provider_table;
+      IttageEntry next = in.entries[p];
+      provider_correct = (next.target == in.actual_target);
+      if (provider_correct) {
+        next.conf = conf_inc(next.conf);
+      } else if (next.conf == 0) {
+        next.target = in.actual_target;
+      } else {
+        next.conf = static_cast<ittage_conf_t>(next.conf - 1);
+      }
+
+      // alt 与 provider 目标不同（或无 alt）时 provider 才体现价值
+      const bool alt_differs =
+          !lk.alt_hit || (in.entries[lk.alt_table].target != in.entries[p].target);
+      if (alt_differs) {
+        next.useful = provider_correct ? useful_inc(next.useful) : useful_dec(next.useful);
+      }
+
+      req.write_en[p] = true;
+      req.write_idx[p] = in.idx[p];
+      req.write_entry[p] = next;
+      req.stat_provider = static_cast<ittage_table_sel_t>(p + 1);
+      req.stat_provider_correct = provider_correct;
+      alloc_from = p + 1;
+    }
+
+    if (provider_correct) {
+      return;
+    }
+
+    for (int t = alloc_from; t < TN_MAX; ++t) {
+      if (in.entries[t].useful != 0) {
+        continue;
+      }
+      IttageEntry fresh{};
+      fresh.valid = true;
+      fresh.tag = in.tag[t];
+      fresh.target = in.actual_target;
+      req.write_en[t] = true;
+      req.write_idx[t] = in.idx[t];
+      req.write_entry[t] = fresh;
+      req.stat_alloc = static_cast<ittage_table_sel_t>(t + 1);
+      return;
+    }
+
+    // 更长的表全部被 useful 项占据：逐项老化，为后续分配腾出空间
+    for (int t = alloc_from; t < TN_MAX; ++t) {
+      IttageEntry aged = in.entries[t];
+      aged.useful = useful_dec(aged.useful);
+      req.write_en[t] = true;
+      req.write_idx[t] = in.idx[t];
+      req.write_entry[t] = aged;
+    }
+    req.stat_alloc_fail = (alloc_from < TN_MAX);
+  }
+
+  void pre_read_comb(const InputPayload &in, PreReadCombOut &out) const {
+    std::memset(&out, 0, sizeof(out));
+    pred_read_req_comb(in, out.pred_req);
+    upd_read_req_comb(in, out.upd_req);
+  }
+
+  void data_seq_read(const PreReadCombOut &in, ReadData &rd) const {
+    std::memset(&rd, 0, sizeof(rd));
+    for (int t = 0; t < TN_MAX; ++t) {
+      if (in.pred_req.read_enable) {
+        rd.pred_entries[t] = table[t][in.pred_req.idx[t]];
+      }
+      if (in.upd_req.read_enable) {
+        rd.upd_entries[t] = table[t][in.upd_req.idx[t]];
+      }
+    }
+  }
+
+  void ittage_comb(const IttageCombIn &input, IttageCombOut &output) const {
+    std::memset(&output, 0, sizeof(output));
+    const PreReadCombOut &pre_read = input.pre_read;
+    const ReadData &rd = input.rd;
+    OutputPayload &out = output.out_regs;
+
+    if (pre_read.pred_req.read_enable) {
+      IttageLookupCombIn lookup_in{};
+      for (int t = 0; t < TN_MAX; ++t) {
+        lookup_in.entries[t] = rd.pred_entries[t];
+        lookup_in.tag[t] = pre_read.pred_req.tag[t];
+      }
+      IttageLookupCombOut lk{};
+      lookup_comb(lookup_in, lk);
+      if (lk.provider_hit) {
+        const IttageEntry &provider = rd.pred_entries[lk.provider_table];
+        out.provider = static_cast<ittage_table_sel_t>(lk.provider_table + 1);
+        if (provider.conf >= ITTAGE_CONF_THRESHOLD) {
+          out.pred_valid = true;
+          out.pred_target = provider.target;
+        } else if (lk.alt_hit &&
+                   rd.pred_entries[lk.alt_table].conf >= ITTAGE_CONF_THRESHOLD) {
+          out.pred_valid = true;
+          out.pred_target = rd.pred_entries[lk.alt_table].target;
+        }
+      }
+    }
+
+    if (pre_read.upd_req.read_enable) {
+      IttageUpdateCombIn upd_in{};
+      for (int t = 0; t < TN_MAX; ++t) {
+        upd_in.entries[t] = rd.upd_entries[t];
+        upd_in.idx[t] = pre_read.upd_req.idx[t];
+        upd_in.tag[t] = pre_read.upd_req.tag[t];
+      }
+      upd_in.actual_target = input.inp.upd_actual_addr;
+      ittage_update_comb(upd_in, output.req);
+    }
+  }
+
+public:
+  ITTAGE_TOP() {
+    reset();
+    std::memset(&stats, 0, sizeof(stats));
+  }
+
+  void reset() { std::memset(table, 0, sizeof(table)); }
+
+  const Stats &get_stats() const { return stats; }
+
+  void ittage_seq_read(const InputPayload &in, ReadData &rd) const {
+    (void)in;
+    std::memset(&rd, 0, sizeof(rd));
+  }
+
+  void ittage_comb_calc(const InputPayload &in, ReadData &rd, OutputPayload &out,
+                        CombResult &req) const {
+    PreReadCombOut pre_read{};
+    pre_read_comb(in, pre_read);
+    data_seq_read(pre_read, rd);
+    IttageCombOut comb_out{};
+    ittage_comb(IttageCombIn{in, pre_read, rd}, comb_out);
+    out = comb_out.out_regs;
+    req = comb_out.req;
+  }
+
+  void ittage_seq_write(const InputPayload &in, const CombResult &req, bool reset_req) {
+    (void)in;
+    if (reset_req) {
+      reset();
+      return;
+    }
+    for (int t = 0; t < TN_MAX; ++t) {
+      if (req.write_en[t]) {
+        table[t][req.write_idx[t]] = req.write_entry[t];
+      }
+    }
+    if (req.stat_upd) {
+      stats.upd_num++;
+      if (req.stat_provider != 0) {
+        stats.provider_hit[req.stat_provider - 1]++;
+        if (req.stat_provider_correct) {
+          stats.provider_correct[req.stat_provider - 1]++;
+        }
+      }
+      if (req.stat_alloc != 0) {
+        stats.alloc[req.stat_alloc - 1]++;
+      }
+      if (req.stat_alloc_fail) {
+        stats.alloc_fail++;
+      }
+    }
+  }
+};
+
+#endif
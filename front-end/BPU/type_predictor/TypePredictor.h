@@ -14,18 +14,21 @@ public:
     wire1_t upd_valid[COMMIT_WIDTH];
     pc_t upd_pc[COMMIT_WIDTH];
     br_type_t upd_br_type[COMMIT_WIDTH];
+    wire1_t upd_is_rvc[COMMIT_WIDTH];
   };
 
   struct Entry {
     wire1_t valid;
     type_pred_tag_t tag;
     br_type_t type;
+    wire1_t is_rvc; // 16 位压缩指令，RAS 压栈地址为 pc + 2
     type_pred_conf_t conf;
     type_pred_age_t age;
   };
 
   struct OutputPayload {
     br_type_t pred_type[FETCH_WIDTH];
+    wire1_t pred_is_rvc[FETCH_WIDTH];
     wire1_t pred_hit[FETCH_WIDTH];
     wire1_t pred_confident[FETCH_WIDTH];
   };
@@ -115,6 +118,7 @@ public:
 
   struct TypePredSelectCombOut {
     br_type_t pred_type;
+    wire1_t pred_is_rvc;
     wire1_t pred_confident;
   };
 
@@ -130,6 +134,7 @@ public:
     Entry entries[TYPE_PRED_WAY_NUM];
     type_pred_tag_t tag;
     br_type_t actual_type;
+    wire1_t actual_is_rvc;
   };
 
   struct TypePredUpdateCombOut {
@@ -158,14 +163,14 @@ private:
   static void type_pred_bank_sel_comb(const TypePredBankSelCombIn &in,
                                       TypePredBankSelCombOut &out) {
     out = TypePredBankSelCombOut{};
-    out.bank_sel = static_cast<bpu_bank_sel_t>((in.pc >> 2) % BPU_BANK_NUM);
+    out.bank_sel = static_cast<bpu_bank_sel_t>((in.pc >> FETCH_SLOT_SHIFT) % BPU_BANK_NUM);
   }
 
   static void type_pred_bank_pc_comb(const TypePredBankPcCombIn &in,
                                      TypePredBankPcCombOut &out) {
     out = TypePredBankPcCombOut{};
     if ((BPU_BANK_NUM & (BPU_BANK_NUM - 1)) != 0) {
-      uint32_t bank_pc = in.pc >> 2;
+      uint32_t bank_pc = in.pc >> FETCH_SLOT_SHIFT;
       bank_pc = bank_pc / BPU_BANK_NUM;
       bank_pc = bank_pc << 2;
       out.bank_pc = bank_pc;
@@ -178,7 +183,7 @@ private:
       n >>= 1;
       highest_bit_pos++;
     }
-    out.bank_pc = in.pc >> highest_bit_pos;
+    out.bank_pc = in.pc >> (highest_bit_pos + FETCH_SLOT_SHIFT - 2);
   }
 
   static void type_pred_req_comb(const TypePredReqCombIn &in, TypePredReqCombOut &out) {
@@ -247,6 +252,7 @@ private:
     }
     const Entry &entry = in.entries[in.hit_info.hit_way];
     out.pred_type = entry.type;
+    out.pred_is_rvc = entry.is_rvc;
     out.pred_confident = (entry.conf >= static_cast<type_pred_conf_t>(TYPE_PRED_CONF_MAX));
   }
 
@@ -313,6 +319,7 @@ private:
       next_entry.conf = static_cast<type_pred_conf_t>(1);
       next_entry.age = static_cast<type_pred_age_t>(1);
     }
+    next_entry.is_rvc = in.actual_is_rvc;
 
     out.write_entry = next_entry;
   }
@@ -372,6 +379,7 @@ private:
       select_comb(sel_in, sel_out);
       out.pred_hit[i] = hit_out.hit;
       out.pred_type[i] = sel_out.pred_type;
+      out.pred_is_rvc[i] = sel_out.pred_is_rvc;
       out.pred_confident[i] = sel_out.pred_confident;
     }
 
@@ -385,6 +393,7 @@ private:
       }
       upd_in.tag = pre_read.upd_req.tag[i];
       upd_in.actual_type = in.upd_br_type[i];
+      upd_in.actual_is_rvc = in.upd_is_rvc[i];
       TypePredUpdateCombOut upd_out{};
       type_pred_update_comb(upd_in, upd_out);
       req.write_en[i] = upd_out.write_enable;
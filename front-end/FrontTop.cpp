@@ -2,23 +2,30 @@
 #include "DeadlockDebug.h"
 #include "config.h"
 #include "front_module.h"
-#include "oracle.h"
+#include "front_top_state.h"
+#include "SimCpu.h"
 #include "util.h"
 #include <cstring>
 
 namespace {
 inline void sync_icache_ptw_ports(const FrontTop &front) {
-  icache_ptw_mem_port = front.icache_ptw_mem_port;
-  icache_ptw_walk_port = front.icache_ptw_walk_port;
-  icache_mem_read_port = front.icache_mem_read_port;
+  icache_set_ports(front.state->icache_state.get(), front.ctx,
+                   front.icache_ptw_mem_port, front.icache_ptw_walk_port,
+                   front.icache_mem_read_port);
 }
 } // namespace
 
+FrontTop::FrontTop() = default;
+FrontTop::~FrontTop() = default;
+
 void FrontTop::init() {
   CsrStatusIO *bound_csr = in.csr_status;
+  // 恢复检查点后的再次 init 沿用同一份状态，与原先文件级 static 的行为一致
+  if (!state) {
+    state = std::make_unique<FrontTopState>();
+  }
+  state->front_ctx = ctx;
   sync_icache_ptw_ports(*this);
-  front_set_context(ctx);
-  icache_set_context(ctx);
   deadlock_debug::register_front_dump_cb(front_dump_debug_state);
   std::memset(&in, 0, sizeof(in));
   std::memset(&out, 0, sizeof(out));
@@ -35,12 +42,12 @@ void FrontTop::init() {
 
 void FrontTop::step_bpu() {
   sync_icache_ptw_ports(*this);
-  front_top(&in, &out);
+  front_top(state.get(), &in, &out);
 }
 
 void FrontTop::step_oracle() {
   sync_icache_ptw_ports(*this);
-  get_oracle(in, out);
+  ctx->cpu->oracle.fetch(in, out);
 }
 
 void FrontTop::dump_debug_state() const { front_dump_debug_state(); }
@@ -238,6 +238,27 @@ static_assert(COMMIT_WIDTH > 0, "COMMIT_WIDTH must be positive");
 #define ENABLE_TC_TARGET_SIGNATURE 1
 #endif
 
+// ITTAGE configs（间接跳转目标预测，与 BTB/TC 并列；各表复用 TAGE 折叠历史
+// 与 tagged 表 index/tag，训练沿用提交回传的 TAGE idx/tag 元数据）
+#ifndef ENABLE_ITTAGE
+#define ENABLE_ITTAGE 1
+#endif
+#ifndef ITTAGE_ENTRY_NUM
+#define ITTAGE_ENTRY_NUM 1024 // 每张表、每个 bank 的表项数，<= TN_ENTRY_NUM
+#endif
+#ifndef ITTAGE_TAG_WIDTH
+#define ITTAGE_TAG_WIDTH 12
+#endif
+#ifndef ITTAGE_CONF_BITS
+#define ITTAGE_CONF_BITS 2
+#endif
+#ifndef ITTAGE_CONF_THRESHOLD
+#define ITTAGE_CONF_THRESHOLD 1
+#endif
+#ifndef ITTAGE_USEFUL_BITS
+#define ITTAGE_USEFUL_BITS 2
+#endif
+
 // 2-Ahead Predictor configs
 #ifndef TWO_AHEAD_TABLE_SIZE
 #define TWO_AHEAD_TABLE_SIZE 4096
@@ -131,141 +131,139 @@ void PTAB_comb(const PtabCombIn &in, PtabCombOut &out) {
   out.out_regs.empty = (next_size == 0);
 }
 
-namespace {
+void PTABModel::seq_read(const PTAB_in &inp, PTAB_read_data &rd) const {
+  (void)inp;
+  std::memset(&rd, 0, sizeof(rd));
+  rd.size = size_;
+  rd.head_valid = (size_ > 0);
+  if (rd.head_valid) {
+    rd.head_entry = entries_[head_];
+  }
+}
 
-class PTABModel {
-public:
-  void seq_read(const PTAB_in &inp, PTAB_read_data &rd) const {
-    (void)inp;
-    std::memset(&rd, 0, sizeof(rd));
-    rd.size = size_;
-    rd.head_valid = (size_ > 0);
-    if (rd.head_valid) {
-      rd.head_entry = entries_[0];
+void PTABModel::build_next_read_data(const PTAB_read_data &cur,
+                                     const PtabCombOut &comb_out,
+                                     PTAB_read_data &next_rd) {
+  next_rd = cur;
+  if (comb_out.clear_ptab) {
+    next_rd = {};
+  }
+  const ptab_size_t size_before_ops = next_rd.size;
+  bool first_push_recorded = false;
+  PTAB_entry first_push_entry{};
+  if (comb_out.push_write_en) {
+    if (next_rd.size >= PTAB_SIZE) {
+      std::printf("[PTAB_TOP] ERROR!!: ptab.size() >= PTAB_SIZE\n");
+      std::exit(1);
+    }
+    if (next_rd.size == 0) {
+      next_rd.head_entry = comb_out.push_write_entry;
+      next_rd.head_valid = true;
     }
+    first_push_entry = comb_out.push_write_entry;
+    first_push_recorded = true;
+    ++next_rd.size;
   }
-
-  void build_next_read_data(const PTAB_read_data &cur, const PtabCombOut &comb_out,
-                            PTAB_read_data &next_rd) const {
-    next_rd = cur;
-    if (comb_out.clear_ptab) {
-      next_rd = {};
+  if (comb_out.push_dummy_en) {
+    if (next_rd.size >= PTAB_SIZE) {
+      std::printf("[PTAB_TOP] dummy entry push ERROR!!: ptab.size() >= PTAB_SIZE\n");
+      std::exit(1);
     }
-    const ptab_size_t size_before_ops = next_rd.size;
-    bool first_push_recorded = false;
-    PTAB_entry first_push_entry{};
-    if (comb_out.push_write_en) {
-      if (next_rd.size >= PTAB_SIZE) {
-        std::printf("[PTAB_TOP] ERROR!!: ptab.size() >= PTAB_SIZE\n");
-        std::exit(1);
-      }
-      if (next_rd.size == 0) {
-        next_rd.head_entry = comb_out.push_write_entry;
-        next_rd.head_valid = true;
-      }
-      first_push_entry = comb_out.push_write_entry;
+    if (next_rd.size == 0) {
+      next_rd.head_entry = comb_out.push_dummy_entry;
+      next_rd.head_valid = true;
+    }
+    if (!first_push_recorded) {
+      first_push_entry = comb_out.push_dummy_entry;
       first_push_recorded = true;
-      ++next_rd.size;
     }
-    if (comb_out.push_dummy_en) {
-      if (next_rd.size >= PTAB_SIZE) {
-        std::printf("[PTAB_TOP] dummy entry push ERROR!!: ptab.size() >= PTAB_SIZE\n");
-        std::exit(1);
-      }
-      if (next_rd.size == 0) {
-        next_rd.head_entry = comb_out.push_dummy_entry;
-        next_rd.head_valid = true;
-      }
-      if (!first_push_recorded) {
-        first_push_entry = comb_out.push_dummy_entry;
-        first_push_recorded = true;
-      }
-      ++next_rd.size;
+    ++next_rd.size;
+  }
+  if (comb_out.pop_en) {
+    if (next_rd.size == 0) {
+      std::printf("[PTAB_TOP] ERROR!!: ptab underflow on read\n");
+      std::exit(1);
     }
-    if (comb_out.pop_en) {
-      if (next_rd.size == 0) {
-        std::printf("[PTAB_TOP] ERROR!!: ptab underflow on read\n");
-        std::exit(1);
-      }
-      --next_rd.size;
-      if (next_rd.size == 0) {
-        next_rd.head_entry = PTAB_entry{};
-        next_rd.head_valid = false;
-      } else if (size_before_ops > 1) {
-        next_rd.head_entry = PTAB_entry{};
-        next_rd.head_valid = false;
-      } else if (first_push_recorded) {
-        next_rd.head_entry = first_push_entry;
-        next_rd.head_valid = true;
-      }
+    --next_rd.size;
+    if (next_rd.size == 0) {
+      next_rd.head_entry = PTAB_entry{};
+      next_rd.head_valid = false;
+    } else if (size_before_ops > 1) {
+      next_rd.head_entry = PTAB_entry{};
+      next_rd.head_valid = false;
+    } else if (first_push_recorded) {
+      next_rd.head_entry = first_push_entry;
+      next_rd.head_valid = true;
     }
   }
+}
 
-  void comb_calc(const PTAB_in &inp, const PTAB_read_data &rd, PTAB_out &out,
-                 PTAB_read_data &next_rd, PtabCombOut &step_req) const {
-    PtabCombIn comb_in{};
-    comb_in.inp = inp;
-    comb_in.rd = rd;
+void PTABModel::comb_calc(const PTAB_in &inp, const PTAB_read_data &rd,
+                          PTAB_out &out, PTAB_read_data &next_rd,
+                          PtabCombOut &step_req) {
+  PtabCombIn comb_in{};
+  comb_in.inp = inp;
+  comb_in.rd = rd;
 
-    PTAB_comb(comb_in, step_req);
-    out = step_req.out_regs;
-    build_next_read_data(rd, step_req, next_rd);
-  }
+  PTAB_comb(comb_in, step_req);
+  out = step_req.out_regs;
+  build_next_read_data(rd, step_req, next_rd);
+}
 
-  void seq_write(const PtabCombOut &req) {
-    if (req.clear_ptab) {
-      size_ = 0;
-      std::memset(entries_, 0, sizeof(entries_));
-    }
-    if (req.push_write_en) {
-      if (size_ >= PTAB_SIZE) {
-        std::printf("[PTAB_TOP] ERROR!!: ptab.size() >= PTAB_SIZE\n");
-        std::exit(1);
-      }
-      entries_[size_++] = req.push_write_entry;
-    }
-    if (req.push_dummy_en) {
-      if (size_ >= PTAB_SIZE) {
-        std::printf("[PTAB_TOP] dummy entry push ERROR!!: ptab.size() >= PTAB_SIZE\n");
-        std::exit(1);
-      }
-      entries_[size_++] = req.push_dummy_entry;
+void PTABModel::seq_write(const PtabCombOut &req) {
+  if (req.clear_ptab) {
+    head_ = 0;
+    size_ = 0;
+  }
+  if (req.push_write_en) {
+    if (size_ >= PTAB_SIZE) {
+      std::printf("[PTAB_TOP] ERROR!!: ptab.size() >= PTAB_SIZE\n");
+      std::exit(1);
     }
-    if (req.pop_en) {
-      if (size_ == 0) {
-        std::printf("[PTAB_TOP] ERROR!!: ptab underflow on read\n");
-        std::exit(1);
-      }
-      for (ptab_size_t i = 1; i < size_; ++i) {
-        entries_[i - 1] = entries_[i];
-      }
-      --size_;
-      entries_[size_] = PTAB_entry{};
+    push(req.push_write_entry);
+  }
+  if (req.push_dummy_en) {
+    if (size_ >= PTAB_SIZE) {
+      std::printf("[PTAB_TOP] dummy entry push ERROR!!: ptab.size() >= PTAB_SIZE\n");
+      std::exit(1);
     }
+    push(req.push_dummy_entry);
   }
-
-  bool peek_mini_flush() {
+  if (req.pop_en) {
     if (size_ == 0) {
-      return false;
+      std::printf("[PTAB_TOP] ERROR!!: ptab underflow on read\n");
+      std::exit(1);
     }
-    DEBUG_LOG_SMALL_4("ptab_peeking for pc=%x,need_mini_flush=%d\n",
-                      entries_[0].predict_base_pc[0], entries_[0].need_mini_flush);
-    return entries_[0].need_mini_flush;
+    head_ = slot_of(1);
+    --size_;
   }
+}
 
-private:
-  PTAB_entry entries_[PTAB_SIZE]{};
-  ptab_size_t size_ = 0;
-};
+bool PTABModel::peek_mini_flush() {
+  if (size_ == 0) {
+    return false;
+  }
+  const PTAB_entry &head = entries_[head_];
+  DEBUG_LOG_SMALL_4("ptab_peeking for pc=%x,need_mini_flush=%d\n",
+                    head.predict_base_pc[0], head.need_mini_flush);
+  return head.need_mini_flush;
+}
 
-PTABModel g_ptab_model;
+ptab_size_t PTABModel::slot_of(ptab_size_t offset) const {
+  return static_cast<ptab_size_t>((head_ + offset) % PTAB_SIZE);
+}
 
-} // namespace
+void PTABModel::push(const PTAB_entry &entry) {
+  entries_[slot_of(size_)] = entry;
+  ++size_;
+}
 
-void PTAB_seq_read(struct PTAB_in *in, struct PTAB_read_data *rd) {
+void PTAB_seq_read(const PTABModel *fifo, struct PTAB_in *in,
+                   struct PTAB_read_data *rd) {
+  assert(fifo);
   assert(in);
   assert(rd);
-  g_ptab_model.seq_read(*in, *rd);
+  fifo->seq_read(*in, *rd);
 }
 
 void PTAB_comb_calc(struct PTAB_in *in, const struct PTAB_read_data *rd,
@@ -276,10 +274,11 @@ void PTAB_comb_calc(struct PTAB_in *in, const struct PTAB_read_data *rd,
   assert(out);
   assert(next_rd);
   assert(step_req);
-  g_ptab_model.comb_calc(*in, *rd, *out, *next_rd, *step_req);
+  PTABModel::comb_calc(*in, *rd, *out, *next_rd, *step_req);
 }
 
-void PTAB_seq_write(const PtabCombOut *req) {
+void PTAB_seq_write(PTABModel *fifo, const PtabCombOut *req) {
+  assert(fifo);
   assert(req);
-  g_ptab_model.seq_write(*req);
+  fifo->seq_write(*req);
 }
@@ -127,111 +127,103 @@ void front2back_FIFO_comb(const Front2BackCombIn &in,
   out.out_regs.empty = (next_size == 0);
 }
 
-namespace {
-
-class Front2BackFifoModel {
-public:
-  void seq_read(const front2back_FIFO_in &inp, front2back_FIFO_read_data &rd) const {
-    (void)inp;
-    std::memset(&rd, 0, sizeof(rd));
-    rd.size = size_;
-    rd.head_valid = (size_ > 0);
-    if (rd.head_valid) {
-      rd.head_entry = entries_[0];
-    }
+void Front2BackFifoModel::seq_read(const front2back_FIFO_in &inp,
+                                   front2back_FIFO_read_data &rd) const {
+  (void)inp;
+  std::memset(&rd, 0, sizeof(rd));
+  rd.size = size_;
+  rd.head_valid = (size_ > 0);
+  if (rd.head_valid) {
+    rd.head_entry = entries_[head_];
   }
+}
 
-  void build_next_read_data(const front2back_FIFO_read_data &cur,
-                            const Front2BackCombOut &comb_out,
-                            front2back_FIFO_read_data &next_rd) const {
-    next_rd = cur;
-    if (comb_out.clear_fifo) {
-      next_rd = {};
+void Front2BackFifoModel::build_next_read_data(const front2back_FIFO_read_data &cur,
+                                               const Front2BackCombOut &comb_out,
+                                               front2back_FIFO_read_data &next_rd) {
+  next_rd = cur;
+  if (comb_out.clear_fifo) {
+    next_rd = {};
+  }
+  const front2back_fifo_size_t size_before_ops = next_rd.size;
+  if (comb_out.push_en) {
+    if (next_rd.size >= FRONT2BACK_FIFO_SIZE) {
+      std::printf("[FRONT2BACK_FIFO_TOP] ERROR!!: front2back_fifo.size() >= FRONT2BACK_FIFO_SIZE\n");
+      std::exit(1);
     }
-    const front2back_fifo_size_t size_before_ops = next_rd.size;
-    if (comb_out.push_en) {
-      if (next_rd.size >= FRONT2BACK_FIFO_SIZE) {
-        std::printf("[FRONT2BACK_FIFO_TOP] ERROR!!: front2back_fifo.size() >= FRONT2BACK_FIFO_SIZE\n");
-        std::exit(1);
-      }
-      if (next_rd.size == 0) {
-        next_rd.head_entry = comb_out.push_entry;
-        next_rd.head_valid = true;
-      }
-      ++next_rd.size;
+    if (next_rd.size == 0) {
+      next_rd.head_entry = comb_out.push_entry;
+      next_rd.head_valid = true;
     }
-    if (comb_out.pop_en) {
-      if (next_rd.size == 0) {
-        std::printf("[FRONT2BACK_FIFO_TOP] ERROR!!: front2back_fifo underflow on read\n");
-        std::exit(1);
-      }
-      --next_rd.size;
-      if (next_rd.size == 0) {
-        next_rd.head_entry = front2back_FIFO_entry{};
-        next_rd.head_valid = false;
-      } else if (size_before_ops > 1) {
-        next_rd.head_entry = front2back_FIFO_entry{};
-        next_rd.head_valid = false;
-      } else if (comb_out.push_en) {
-        next_rd.head_entry = comb_out.push_entry;
-        next_rd.head_valid = true;
-      }
+    ++next_rd.size;
+  }
+  if (comb_out.pop_en) {
+    if (next_rd.size == 0) {
+      std::printf("[FRONT2BACK_FIFO_TOP] ERROR!!: front2back_fifo underflow on read\n");
+      std::exit(1);
+    }
+    --next_rd.size;
+    if (next_rd.size == 0) {
+      next_rd.head_entry = front2back_FIFO_entry{};
+      next_rd.head_valid = false;
+    } else if (size_before_ops > 1) {
+      next_rd.head_entry = front2back_FIFO_entry{};
+      next_rd.head_valid = false;
+    } else if (comb_out.push_en) {
+      next_rd.head_entry = comb_out.push_entry;
+      next_rd.head_valid = true;
     }
   }
+}
 
-  void comb_calc(const front2back_FIFO_in &inp,
-                 const front2back_FIFO_read_data &rd,
-                 front2back_FIFO_out &out,
-                 front2back_FIFO_read_data &next_rd,
-                 Front2BackCombOut &step_req) const {
-    Front2BackCombIn comb_in{};
-    comb_in.inp = inp;
-    comb_in.rd = rd;
-
-    front2back_FIFO_comb(comb_in, step_req);
-    out = step_req.out_regs;
-    build_next_read_data(rd, step_req, next_rd);
-  }
+void Front2BackFifoModel::comb_calc(const front2back_FIFO_in &inp,
+                                    const front2back_FIFO_read_data &rd,
+                                    front2back_FIFO_out &out,
+                                    front2back_FIFO_read_data &next_rd,
+                                    Front2BackCombOut &step_req) {
+  Front2BackCombIn comb_in{};
+  comb_in.inp = inp;
+  comb_in.rd = rd;
+
+  front2back_FIFO_comb(comb_in, step_req);
+  out = step_req.out_regs;
+  build_next_read_data(rd, step_req, next_rd);
+}
 
-  void seq_write(const Front2BackCombOut &req) {
-    if (req.clear_fifo) {
-      size_ = 0;
-      std::memset(entries_, 0, sizeof(entries_));
-    }
-    if (req.push_en) {
-      if (size_ >= FRONT2BACK_FIFO_SIZE) {
-        std::printf("[FRONT2BACK_FIFO_TOP] ERROR!!: front2back_fifo.size() >= FRONT2BACK_FIFO_SIZE\n");
-        std::exit(1);
-      }
-      entries_[size_++] = req.push_entry;
+void Front2BackFifoModel::seq_write(const Front2BackCombOut &req) {
+  if (req.clear_fifo) {
+    head_ = 0;
+    size_ = 0;
+  }
+  if (req.push_en) {
+    if (size_ >= FRONT2BACK_FIFO_SIZE) {
+      std::printf("[FRONT2BACK_FIFO_TOP] ERROR!!: front2back_fifo.size() >= FRONT2BACK_FIFO_SIZE\n");
+      std::exit(1);
     }
-    if (req.pop_en) {
-      if (size_ == 0) {
-        std::printf("[FRONT2BACK_FIFO_TOP] ERROR!!: front2back_fifo underflow on read\n");
-        std::exit(1);
-      }
-      for (front2back_fifo_size_t i = 1; i < size_; ++i) {
-        entries_[i - 1] = entries_[i];
-      }
-      --size_;
-      entries_[size_] = front2back_FIFO_entry{};
+    entries_[slot_of(size_++)] = req.push_entry;
+  }
+  if (req.pop_en) {
+    if (size_ == 0) {
+      std::printf("[FRONT2BACK_FIFO_TOP] ERROR!!: front2back_fifo underflow on read\n");
+      std::exit(1);
     }
+    head_ = slot_of(1);
+    --size_;
   }
+}
 
-private:
-  front2back_FIFO_entry entries_[FRONT2BACK_FIFO_SIZE]{};
-  front2back_fifo_size_t size_ = 0;
-};
-
-Front2BackFifoModel g_front2back_fifo_model;
-
-} // namespace
+front2back_fifo_size_t Front2BackFifoModel::slot_of(front2back_fifo_size_t offset) const {
+  return static_cast<front2back_fifo_size_t>((head_ + offset) %
+                                             FRONT2BACK_FIFO_SIZE);
+}
 
-void front2back_FIFO_seq_read(struct front2back_FIFO_in *in,
+void front2back_FIFO_seq_read(const Front2BackFifoModel *fifo,
+                              struct front2back_FIFO_in *in,
                               struct front2back_FIFO_read_data *rd) {
+  assert(fifo);
   assert(in);
   assert(rd);
-  g_front2back_fifo_model.seq_read(*in, *rd);
+  fifo->seq_read(*in, *rd);
 }
 
 void front2back_FIFO_comb_calc(struct front2back_FIFO_in *in,
@@ -244,10 +236,12 @@ void front2back_FIFO_comb_calc(struct front2back_FIFO_in *in,
   assert(out);
   assert(next_rd);
   assert(step_req);
-  g_front2back_fifo_model.comb_calc(*in, *rd, *out, *next_rd, *step_req);
+  Front2BackFifoModel::comb_calc(*in, *rd, *out, *next_rd, *step_req);
 }
 
-void front2back_FIFO_seq_write(const Front2BackCombOut *req) {
+void front2back_FIFO_seq_write(Front2BackFifoModel *fifo,
+                               const Front2BackCombOut *req) {
+  assert(fifo);
   assert(req);
-  g_front2back_fifo_model.seq_write(*req);
+  fifo->seq_write(*req);
 }
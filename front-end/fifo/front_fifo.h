@@ -5,5 +5,6 @@
 #include "../frontend.h"
 #include "../front_module.h"
 #include "../BPU/BPU_configs.h"
+#include "front_fifo_models.h"
 
 #endif
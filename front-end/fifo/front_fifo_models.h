@@ -0,0 +1,114 @@
+#ifndef FRONT_FIFO_MODELS_H
+#define FRONT_FIFO_MODELS_H
+
+#include "../train_IO.h"
+
+// ============================================================================
+// 前端各 FIFO 的存储模型
+//
+// 每个 FrontTopState 持有一份，X_seq_read/X_seq_write 通过参数访问；
+// comb_calc/build_next_read_data 只依赖 rd 快照，为静态函数。
+// ============================================================================
+
+class FetchAddressFifoModel {
+public:
+  void seq_read(const fetch_address_FIFO_in &inp,
+                fetch_address_FIFO_read_data &rd) const;
+
+  static void build_next_read_data(const fetch_address_FIFO_read_data &cur,
+                                   const FetchAddrCombOut &comb_out,
+                                   fetch_address_FIFO_read_data &next_rd);
+
+  static void comb_calc(const fetch_address_FIFO_in &inp,
+                        const fetch_address_FIFO_read_data &rd,
+                        fetch_address_FIFO_out &out,
+                        fetch_address_FIFO_read_data &next_rd,
+                        FetchAddrCombOut &step_req);
+
+  void seq_write(const FetchAddrCombOut &req);
+
+private:
+  fetch_addr_t entries_[FETCH_ADDR_FIFO_SIZE]{};
+  fetch_addr_fifo_size_t size_ = 0;
+};
+
+class InstructionFifoModel {
+public:
+  void seq_read(const instruction_FIFO_in &inp,
+                instruction_FIFO_read_data &rd) const;
+
+  static void build_next_read_data(const instruction_FIFO_read_data &cur,
+                                   const InstructionCombOut &comb_out,
+                                   instruction_FIFO_read_data &next_rd);
+
+  static void comb_calc(const instruction_FIFO_in &inp,
+                        const instruction_FIFO_read_data &rd,
+                        instruction_FIFO_out &out,
+                        instruction_FIFO_read_data &next_rd,
+                        InstructionCombOut &step_req);
+
+  // 环形缓冲：pop/clear 只移动 head_/size_，不再逐项搬移宽 entry
+  void seq_write(const InstructionCombOut &req);
+
+private:
+  instruction_fifo_size_t slot_of(instruction_fifo_size_t offset) const;
+
+  instruction_FIFO_entry entries_[INSTRUCTION_FIFO_SIZE]{};
+  instruction_fifo_size_t head_ = 0;
+  instruction_fifo_size_t size_ = 0;
+};
+
+class PTABModel {
+public:
+  void seq_read(const PTAB_in &inp, PTAB_read_data &rd) const;
+
+  static void build_next_read_data(const PTAB_read_data &cur,
+                                   const PtabCombOut &comb_out,
+                                   PTAB_read_data &next_rd);
+
+  static void comb_calc(const PTAB_in &inp, const PTAB_read_data &rd,
+                        PTAB_out &out, PTAB_read_data &next_rd,
+                        PtabCombOut &step_req);
+
+  // 环形缓冲：pop/clear 只移动 head_/size_，不再逐项搬移宽 entry
+  void seq_write(const PtabCombOut &req);
+
+  bool peek_mini_flush();
+
+private:
+  ptab_size_t slot_of(ptab_size_t offset) const;
+
+  void push(const PTAB_entry &entry);
+
+  PTAB_entry entries_[PTAB_SIZE]{};
+  ptab_size_t head_ = 0;
+  ptab_size_t size_ = 0;
+};
+
+class Front2BackFifoModel {
+public:
+  void seq_read(const front2back_FIFO_in &inp,
+                front2back_FIFO_read_data &rd) const;
+
+  static void build_next_read_data(const front2back_FIFO_read_data &cur,
+                                   const Front2BackCombOut &comb_out,
+                                   front2back_FIFO_read_data &next_rd);
+
+  static void comb_calc(const front2back_FIFO_in &inp,
+                        const front2back_FIFO_read_data &rd,
+                        front2back_FIFO_out &out,
+                        front2back_FIFO_read_data &next_rd,
+                        Front2BackCombOut &step_req);
+
+  // 环形缓冲：pop/clear 只移动 head_/size_，不再逐项搬移宽 entry
+  void seq_write(const Front2BackCombOut &req);
+
+private:
+  front2back_fifo_size_t slot_of(front2back_fifo_size_t offset) const;
+
+  front2back_FIFO_entry entries_[FRONT2BACK_FIFO_SIZE]{};
+  front2back_fifo_size_t head_ = 0;
+  front2back_fifo_size_t size_ = 0;
+};
+
+#endif
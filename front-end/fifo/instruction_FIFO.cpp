@@ -79,111 +79,103 @@ void instruction_FIFO_comb(const InstructionCombIn &in,
   out.out_regs.full = (next_size == INSTRUCTION_FIFO_SIZE);
 }
 
-namespace {
-
-class InstructionFifoModel {
-public:
-  void seq_read(const instruction_FIFO_in &inp, instruction_FIFO_read_data &rd) const {
-    (void)inp;
-    std::memset(&rd, 0, sizeof(rd));
-    rd.size = size_;
-    rd.head_valid = (size_ > 0);
-    if (rd.head_valid) {
-      rd.head_entry = entries_[0];
-    }
+void InstructionFifoModel::seq_read(const instruction_FIFO_in &inp,
+                                    instruction_FIFO_read_data &rd) const {
+  (void)inp;
+  std::memset(&rd, 0, sizeof(rd));
+  rd.size = size_;
+  rd.head_valid = (size_ > 0);
+  if (rd.head_valid) {
+    rd.head_entry = entries_[head_];
   }
+}
 
-  void build_next_read_data(const instruction_FIFO_read_data &cur,
-                            const InstructionCombOut &comb_out,
-                            instruction_FIFO_read_data &next_rd) const {
-    next_rd = cur;
-    if (comb_out.clear_fifo) {
-      next_rd = {};
+void InstructionFifoModel::build_next_read_data(const instruction_FIFO_read_data &cur,
+                                                const InstructionCombOut &comb_out,
+                                                instruction_FIFO_read_data &next_rd) {
+  next_rd = cur;
+  if (comb_out.clear_fifo) {
+    next_rd = {};
+  }
+  const instruction_fifo_size_t size_before_ops = next_rd.size;
+  if (comb_out.push_en) {
+    if (next_rd.size >= INSTRUCTION_FIFO_SIZE) {
+      std::printf("[INSTRUCTION_FIFO_TOP] ERROR!!: fifo.size() >= INSTRUCTION_FIFO_SIZE\n");
+      std::exit(1);
+    }
+    if (next_rd.size == 0) {
+      next_rd.head_entry = comb_out.push_entry;
+      next_rd.head_valid = true;
     }
-    const instruction_fifo_size_t size_before_ops = next_rd.size;
-    if (comb_out.push_en) {
-      if (next_rd.size >= INSTRUCTION_FIFO_SIZE) {
-        std::printf("[INSTRUCTION_FIFO_TOP] ERROR!!: fifo.size() >= INSTRUCTION_FIFO_SIZE\n");
-        std::exit(1);
-      }
-      if (next_rd.size == 0) {
-        next_rd.head_entry = comb_out.push_entry;
-        next_rd.head_valid = true;
-      }
-      ++next_rd.size;
+    ++next_rd.size;
+  }
+  if (comb_out.pop_en) {
+    if (next_rd.size == 0) {
+      std::printf("[INSTRUCTION_FIFO_TOP] ERROR!!: fifo underflow on read\n");
+      std::exit(1);
     }
-    if (comb_out.pop_en) {
-      if (next_rd.size == 0) {
-        std::printf("[INSTRUCTION_FIFO_TOP] ERROR!!: fifo underflow on read\n");
-        std::exit(1);
-      }
-      --next_rd.size;
-      if (next_rd.size == 0) {
-        next_rd.head_entry = instruction_FIFO_entry{};
-        next_rd.head_valid = false;
-      } else if (size_before_ops > 1) {
-        next_rd.head_entry = instruction_FIFO_entry{};
-        next_rd.head_valid = false;
-      } else if (comb_out.push_en) {
-        next_rd.head_entry = comb_out.push_entry;
-        next_rd.head_valid = true;
-      }
+    --next_rd.size;
+    if (next_rd.size == 0) {
+      next_rd.head_entry = instruction_FIFO_entry{};
+      next_rd.head_valid = false;
+    } else if (size_before_ops > 1) {
+      next_rd.head_entry = instruction_FIFO_entry{};
+      next_rd.head_valid = false;
+    } else if (comb_out.push_en) {
+      next_rd.head_entry = comb_out.push_entry;
+      next_rd.head_valid = true;
     }
   }
+}
 
-  void comb_calc(const instruction_FIFO_in &inp,
-                 const instruction_FIFO_read_data &rd,
-                 instruction_FIFO_out &out,
-                 instruction_FIFO_read_data &next_rd,
-                 InstructionCombOut &step_req) const {
-    InstructionCombIn comb_in{};
-    comb_in.inp = inp;
-    comb_in.rd = rd;
-
-    instruction_FIFO_comb(comb_in, step_req);
-    out = step_req.out_regs;
-    build_next_read_data(rd, step_req, next_rd);
-  }
+void InstructionFifoModel::comb_calc(const instruction_FIFO_in &inp,
+                                     const instruction_FIFO_read_data &rd,
+                                     instruction_FIFO_out &out,
+                                     instruction_FIFO_read_data &next_rd,
+                                     InstructionCombOut &step_req) {
+  InstructionCombIn comb_in{};
+  comb_in.inp = inp;
+  comb_in.rd = rd;
+
+  instruction_FIFO_comb(comb_in, step_req);
+  out = step_req.out_regs;
+  build_next_read_data(rd, step_req, next_rd);
+}
 
-  void seq_write(const InstructionCombOut &req) {
-    if (req.clear_fifo) {
-      size_ = 0;
-      std::memset(entries_, 0, sizeof(entries_));
-    }
-    if (req.push_en) {
-      if (size_ >= INSTRUCTION_FIFO_SIZE) {
-        std::printf("[INSTRUCTION_FIFO_TOP] ERROR!!: fifo.size() >= INSTRUCTION_FIFO_SIZE\n");
-        std::exit(1);
-      }
-      entries_[size_++] = req.push_entry;
+void InstructionFifoModel::seq_write(const InstructionCombOut &req) {
+  if (req.clear_fifo) {
+    head_ = 0;
+    size_ = 0;
+  }
+  if (req.push_en) {
+    if (size_ >= INSTRUCTION_FIFO_SIZE) {
+      std::printf("[INSTRUCTION_FIFO_TOP] ERROR!!: fifo.size() >= INSTRUCTION_FIFO_SIZE\n");
+      std::exit(1);
     }
-    if (req.pop_en) {
-      if (size_ == 0) {
-        std::printf("[INSTRUCTION_FIFO_TOP] ERROR!!: fifo underflow on read\n");
-        std::exit(1);
-      }
-      for (instruction_fifo_size_t i = 1; i < size_; ++i) {
-        entries_[i - 1] = entries_[i];
-      }
-      --size_;
-      entries_[size_] = instruction_FIFO_entry{};
+    entries_[slot_of(size_++)] = req.push_entry;
+  }
+  if (req.pop_en) {
+    if (size_ == 0) {
+      std::printf("[INSTRUCTION_FIFO_TOP] ERROR!!: fifo underflow on read\n");
+      std::exit(1);
     }
+    head_ = slot_of(1);
+    --size_;
   }
+}
 
-private:
-  instruction_FIFO_entry entries_[INSTRUCTION_FIFO_SIZE]{};
-  instruction_fifo_size_t size_ = 0;
-};
-
-InstructionFifoModel g_instruction_fifo;
-
-} // namespace
+instruction_fifo_size_t InstructionFifoModel::slot_of(instruction_fifo_size_t offset) const {
+  return static_cast<instruction_fifo_size_t>((head_ + offset) %
+                                              INSTRUCTION_FIFO_SIZE);
+}
 
-void instruction_FIFO_seq_read(struct instruction_FIFO_in *in,
+void instruction_FIFO_seq_read(const InstructionFifoModel *fifo,
+                               struct instruction_FIFO_in *in,
                                struct instruction_FIFO_read_data *rd) {
+  assert(fifo);
   assert(in);
   assert(rd);
-  g_instruction_fifo.seq_read(*in, *rd);
+  fifo->seq_read(*in, *rd);
 }
 
 void instruction_FIFO_comb_calc(struct instruction_FIFO_in *in,
@@ -196,10 +188,12 @@ void instruction_FIFO_comb_calc(struct instruction_FIFO_in *in,
   assert(out);
   assert(next_rd);
   assert(step_req);
-  g_instruction_fifo.comb_calc(*in, *rd, *out, *next_rd, *step_req);
+  InstructionFifoModel::comb_calc(*in, *rd, *out, *next_rd, *step_req);
 }
 
-void instruction_FIFO_seq_write(const InstructionCombOut *req) {
+void instruction_FIFO_seq_write(InstructionFifoModel *fifo,
+                                const InstructionCombOut *req) {
+  assert(fifo);
   assert(req);
-  g_instruction_fifo.seq_write(*req);
+  fifo->seq_write(*req);
 }
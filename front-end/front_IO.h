@@ -20,6 +20,7 @@ struct front_top_in {
   wire1_t predict_dir[COMMIT_WIDTH];
   wire1_t actual_dir[COMMIT_WIDTH];
   br_type_t actual_br_type[COMMIT_WIDTH];
+  wire1_t actual_is_rvc[COMMIT_WIDTH]; // 16 位压缩指令，RAS 返回地址为 pc + 2
   target_addr_t actual_target[COMMIT_WIDTH];
   wire1_t alt_pred[COMMIT_WIDTH];
   pcpn_t altpcpn[COMMIT_WIDTH];
@@ -75,6 +76,7 @@ struct BPU_in {
   wire1_t predict_dir[COMMIT_WIDTH];
   wire1_t actual_dir[COMMIT_WIDTH];
   br_type_t actual_br_type[COMMIT_WIDTH];
+  wire1_t actual_is_rvc[COMMIT_WIDTH]; // 16 位压缩指令，RAS 返回地址为 pc + 2
   target_addr_t actual_target[COMMIT_WIDTH];
   // for TAGE update
   wire1_t alt_pred[COMMIT_WIDTH];
@@ -139,6 +141,9 @@ struct icache_in {
   fetch_addr_t fetch_address;
   wire1_t icache_read_valid_2;
   fetch_addr_t fetch_address_2;
+  // FDIP: fetch target that just entered the fetch-address FIFO behind others
+  wire1_t prefetch_valid;
+  fetch_addr_t prefetch_address;
   CsrStatusIO *csr_status;
   wire1_t run_comb_only;
 };
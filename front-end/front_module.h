@@ -10,9 +10,7 @@ class SimContext;
 namespace axi_interconnect {
 struct ReadMasterPort_t;
 }
-extern PtwMemPort *icache_ptw_mem_port;
-extern PtwWalkPort *icache_ptw_walk_port;
-extern axi_interconnect::ReadMasterPort_t *icache_mem_read_port;
+struct ICacheState;
 
 
 struct fetch_address_FIFO_read_data {
@@ -102,21 +100,27 @@ struct PtabCombIn;
 struct PtabCombOut;
 struct Front2BackCombIn;
 struct Front2BackCombOut;
+class FetchAddressFifoModel;
+class InstructionFifoModel;
+class PTABModel;
+class Front2BackFifoModel;
 
 void BPU_top(struct BPU_in *in, struct BPU_out *out);
-void icache_top(struct icache_in *in, struct icache_out *out);
-void icache_seq_read(struct icache_in *in, struct icache_out *out);
-void icache_peek_ready(struct icache_in *in, struct icache_out *out);
-void icache_comb_calc(struct icache_in *in, struct icache_out *out);
-void icache_seq_write();
-void icache_dump_debug_state();
-void icache_set_context(SimContext *ctx);
-void front_set_context(SimContext *ctx);
-void icache_set_ptw_mem_port(PtwMemPort *port);
-void icache_set_ptw_walk_port(PtwWalkPort *port);
-void icache_set_mem_read_port(axi_interconnect::ReadMasterPort_t *port);
-
-void instruction_FIFO_seq_read(struct instruction_FIFO_in *in,
+void icache_top(ICacheState *ic, struct icache_in *in, struct icache_out *out);
+void icache_seq_read(ICacheState *ic, struct icache_in *in,
+                     struct icache_out *out);
+void icache_peek_ready(ICacheState *ic, struct icache_in *in,
+                       struct icache_out *out);
+void icache_comb_calc(ICacheState *ic, struct icache_in *in,
+                      struct icache_out *out);
+void icache_seq_write(ICacheState *ic);
+void icache_dump_debug_state(const ICacheState *ic);
+void icache_set_ports(ICacheState *ic, SimContext *ctx,
+                      PtwMemPort *ptw_mem_port, PtwWalkPort *ptw_walk_port,
+                      axi_interconnect::ReadMasterPort_t *mem_read_port);
+
+void instruction_FIFO_seq_read(const InstructionFifoModel *fifo,
+                               struct instruction_FIFO_in *in,
                                struct instruction_FIFO_read_data *rd);
 void instruction_FIFO_comb(const InstructionCombIn &input,
                            InstructionCombOut &output);
@@ -125,19 +129,24 @@ void instruction_FIFO_comb_calc(struct instruction_FIFO_in *in,
                                 struct instruction_FIFO_out *out,
                                 struct instruction_FIFO_read_data *next_rd,
                                 InstructionCombOut *step_req);
-void instruction_FIFO_seq_write(const InstructionCombOut *req);
+void instruction_FIFO_seq_write(InstructionFifoModel *fifo,
+                                const InstructionCombOut *req);
 
-void PTAB_seq_read(struct PTAB_in *in, struct PTAB_read_data *rd);
+void PTAB_seq_read(const PTABModel *fifo, struct PTAB_in *in,
+                   struct PTAB_read_data *rd);
 void PTAB_comb(const PtabCombIn &input, PtabCombOut &output);
 void PTAB_comb_calc(struct PTAB_in *in, const struct PTAB_read_data *rd,
                     struct PTAB_out *out, struct PTAB_read_data *next_rd,
                     PtabCombOut *step_req);
-void PTAB_seq_write(const PtabCombOut *req);
+void PTAB_seq_write(PTABModel *fifo, const PtabCombOut *req);
 
-void front_top(struct front_top_in *in, struct front_top_out *out);
+struct FrontTopState;
+void front_top(FrontTopState *state, struct front_top_in *in,
+               struct front_top_out *out);
 void front_dump_debug_state();
 
-void front2back_FIFO_seq_read(struct front2back_FIFO_in *in,
+void front2back_FIFO_seq_read(const Front2BackFifoModel *fifo,
+                              struct front2back_FIFO_in *in,
                               struct front2back_FIFO_read_data *rd);
 void front2back_FIFO_comb(const Front2BackCombIn &input,
                           Front2BackCombOut &output);
@@ -146,9 +155,11 @@ void front2back_FIFO_comb_calc(struct front2back_FIFO_in *in,
                                struct front2back_FIFO_out *out,
                                struct front2back_FIFO_read_data *next_rd,
                                Front2BackCombOut *step_req);
-void front2back_FIFO_seq_write(const Front2BackCombOut *req);
+void front2back_FIFO_seq_write(Front2BackFifoModel *fifo,
+                               const Front2BackCombOut *req);
 
-void fetch_address_FIFO_seq_read(struct fetch_address_FIFO_in *in,
+void fetch_address_FIFO_seq_read(const FetchAddressFifoModel *fifo,
+                                 struct fetch_address_FIFO_in *in,
                                  struct fetch_address_FIFO_read_data *rd);
 void fetch_address_FIFO_comb(const FetchAddrCombIn &input,
                              FetchAddrCombOut &output);
@@ -157,6 +168,7 @@ void fetch_address_FIFO_comb_calc(struct fetch_address_FIFO_in *in,
                                   struct fetch_address_FIFO_out *out,
                                   struct fetch_address_FIFO_read_data *next_rd,
                                   FetchAddrCombOut *step_req);
-void fetch_address_FIFO_seq_write(const FetchAddrCombOut *req);
+void fetch_address_FIFO_seq_write(FetchAddressFifoModel *fifo,
+                                  const FetchAddrCombOut *req);
 
 #endif // FRONT_MODULE_H
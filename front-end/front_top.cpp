@@ -1,11 +1,14 @@
 #include "BPU/BPU.h"
 #include "front_IO.h"
 #include "front_module.h"
+#include "front_top_state.h"
 #include "host_profile.h"
+#include "icache/include/icache_state.h"
 #include "predecode.h"
 #include "predecode_checker.h"
 #include "train_IO.h"
 #include <RISCV.h>
+#include <RVC.h>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
@@ -20,56 +23,12 @@
 #endif
 
 // ============================================================================
-// 全局状态（寄存器锁存值）
+// 全局状态（寄存器锁存值）：定义见 front_top_state.h，由每个 FrontTop 持有
 // ============================================================================
-static bool predecode_refetch = false;
-static uint32_t predecode_refetch_address = 0;
-static uint32_t front_sim_time = 0;
-
-// FIFO 状态锁存
-static bool fetch_addr_fifo_full_latch = false;
-static bool fetch_addr_fifo_empty_latch = true;
-static bool fifo_full_latch = false;
-static bool fifo_empty_latch = true;
-static bool ptab_full_latch = false;
-static bool ptab_empty_latch = true;
-static bool front2back_fifo_full_latch = false;
-static bool front2back_fifo_empty_latch = true;
-static SimContext *front_ctx = nullptr;
-
-void front_set_context(SimContext *ctx) { front_ctx = ctx; }
-
-static FrontRuntimeStats front_stats;
-static bool falcon_window_active = false;
-static uint64_t falcon_warmup_cycles = 0;
-static bool falcon_recovery_pending = false;
-enum class FalconRecoverySrc : uint8_t {
-  NONE = 0,
-  BACKEND_REFETCH = 1,
-  FRONTEND_FLUSH = 2,
-};
-static FalconRecoverySrc falcon_recovery_src = FalconRecoverySrc::NONE;
 static constexpr uint64_t kFalconColdMissWindowCycles = 100000;
 
-struct FrontDeadlockSnapshot {
-  bool valid = false;
-  bool global_reset = false;
-  bool global_refetch = false;
-  bool icache_ready = false;
-  bool icache_ready_2 = false;
-  bool fetch_addr_read_enable_slot0 = false;
-  bool fetch_addr_read_enable_slot1 = false;
-  bool inst_fifo_read_enable = false;
-  bool ptab_read_enable = false;
-  bool front2back_read_enable = false;
-  icache_out icache = {};
-  instruction_FIFO_out fifo = {};
-  PTAB_out ptab = {};
-  front2back_FIFO_out front2back = {};
-  front_top_out out = {};
-};
-
-static FrontDeadlockSnapshot front_deadlock_snapshot;
+// 本线程最近一次 front_top() 使用的实例，只供无参的死锁 dump 回调读取
+static thread_local FrontTopState *front_bound_state = nullptr;
 
 static double front_stats_pct(uint64_t num, uint64_t den) {
   if (den == 0) {
@@ -85,14 +44,14 @@ static double front_stats_ratio(uint64_t num, uint64_t den) {
   return static_cast<double>(num) / static_cast<double>(den);
 }
 
-static bool falcon_measurement_window_active() {
-  if (front_ctx == nullptr) {
+static bool falcon_measurement_window_active(const FrontTopState &st) {
+  if (st.front_ctx == nullptr) {
     return true;
   }
-  if (!front_ctx->is_ckpt) {
+  if (!st.front_ctx->is_ckpt) {
     return true;
   }
-  return front_ctx->perf.perf_start;
+  return st.front_ctx->perf.perf_start;
 }
 
 static inline bool front_focus_pc(uint32_t pc) {
@@ -131,7 +90,7 @@ static void dump_front_focus_source(const instruction_FIFO_out &fifo_out,
   std::printf(
       "[FRONT][TRACE][SRC] cyc=%lld global_refetch=%d predecode_can_run=%d "
       "front2back_can_write=%d bypass=%d seq_next=0x%08x predict_next=0x%08x\n",
-      (long long)sim_time, static_cast<int>(global_refetch),
+      (long long)sim_now(), static_cast<int>(global_refetch),
       static_cast<int>(predecode_can_run), static_cast<int>(front2back_can_write),
       static_cast<int>(use_front2back_output_bypass), fifo_out.seq_next_pc,
       ptab_out.predict_next_fetch_address);
@@ -151,7 +110,7 @@ static void dump_front_focus_output(const front_top_out &out) {
   }
   std::printf(
       "[FRONT][TRACE][OUT] cyc=%lld valid=%d predict_next=0x%08x\n",
-      (long long)sim_time, static_cast<int>(out.FIFO_valid),
+      (long long)sim_now(), static_cast<int>(out.FIFO_valid),
       out.predict_next_fetch_address);
   for (int i = 0; i < FETCH_WIDTH; ++i) {
     std::printf(
@@ -162,34 +121,39 @@ static void dump_front_focus_output(const front_top_out &out) {
 }
 
 void front_dump_debug_state() {
+  if (front_bound_state == nullptr) {
+    std::printf("[DEADLOCK][FRONT] front_top not stepped yet\n");
+    return;
+  }
+  const FrontTopState &st = *front_bound_state;
   std::printf(
       "[DEADLOCK][FRONT] sim_time=%u fetch_addr_fifo{full=%d empty=%d} "
       "inst_fifo{full=%d empty=%d} ptab{full=%d empty=%d} front2back{full=%d "
       "empty=%d}\n",
-      front_sim_time, static_cast<int>(fetch_addr_fifo_full_latch),
-      static_cast<int>(fetch_addr_fifo_empty_latch),
-      static_cast<int>(fifo_full_latch), static_cast<int>(fifo_empty_latch),
-      static_cast<int>(ptab_full_latch), static_cast<int>(ptab_empty_latch),
-      static_cast<int>(front2back_fifo_full_latch),
-      static_cast<int>(front2back_fifo_empty_latch));
+      st.front_sim_time, static_cast<int>(st.fetch_addr_fifo_full_latch),
+      static_cast<int>(st.fetch_addr_fifo_empty_latch),
+      static_cast<int>(st.fifo_full_latch), static_cast<int>(st.fifo_empty_latch),
+      static_cast<int>(st.ptab_full_latch), static_cast<int>(st.ptab_empty_latch),
+      static_cast<int>(st.front2back_fifo_full_latch),
+      static_cast<int>(st.front2back_fifo_empty_latch));
   std::printf(
       "[DEADLOCK][FRONT][STATS] cycles=%llu active=%llu backend_demand=%llu "
       "backend_bubble=%llu icache_retry=%llu wait_walk=%llu local_walker=%llu\n",
-      static_cast<unsigned long long>(front_stats.cycles),
-      static_cast<unsigned long long>(front_stats.active_cycles),
-      static_cast<unsigned long long>(front_stats.backend_demand_cycles),
-      static_cast<unsigned long long>(front_stats.backend_bubble_cycles),
-      static_cast<unsigned long long>(front_stats.bubble_icache_tlb_retry_cycles),
+      static_cast<unsigned long long>(st.front_stats.cycles),
+      static_cast<unsigned long long>(st.front_stats.active_cycles),
+      static_cast<unsigned long long>(st.front_stats.backend_demand_cycles),
+      static_cast<unsigned long long>(st.front_stats.backend_bubble_cycles),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_tlb_retry_cycles),
       static_cast<unsigned long long>(
-          front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles),
+          st.front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles),
       static_cast<unsigned long long>(
-          front_stats.bubble_icache_tlb_retry_local_walker_cycles));
-  if (!front_deadlock_snapshot.valid) {
+          st.front_stats.bubble_icache_tlb_retry_local_walker_cycles));
+  if (!st.front_deadlock_snapshot.valid) {
     std::printf("[DEADLOCK][FRONT] no deadlock snapshot captured yet\n");
     return;
   }
 
-  const auto &s = front_deadlock_snapshot;
+  const auto &s = st.front_deadlock_snapshot;
   std::printf(
       "[DEADLOCK][FRONT][SNAP] reset=%d refetch=%d ic_ready={%d,%d} "
       "read_en={fa0=%d fa1=%d fifo=%d ptab=%d f2b=%d} fifo_valid=%d "
@@ -222,7 +186,7 @@ void front_dump_debug_state() {
       static_cast<int>(s.icache.perf_itlb_retry_walk_req_blocked),
       static_cast<int>(s.icache.perf_itlb_retry_wait_walk_resp),
       static_cast<int>(s.icache.perf_itlb_retry_local_walker_busy));
-  icache_dump_debug_state();
+  icache_dump_debug_state(st.icache_state.get());
   for (int i = 0; i < FETCH_WIDTH; ++i) {
     std::printf(
         "[DEADLOCK][FRONT][OUT %d] valid=%d pc=0x%08x inst=0x%08x pf=%d "
@@ -234,21 +198,21 @@ void front_dump_debug_state() {
   }
 }
 
-static void falcon_print_summary() {
+static void falcon_print_summary(const FrontTopState &st) {
 #if !FRONTEND_ENABLE_FALCON_STATS
   return;
 #else
-  if (front_stats.cycles == 0) {
+  if (st.front_stats.cycles == 0) {
     return;
   }
 
-  const uint64_t bubble_total = front_stats.backend_bubble_cycles;
-  const uint64_t demand_total = front_stats.backend_demand_cycles;
-  const uint64_t active_total = front_stats.active_cycles;
-  const uint64_t req_fire_total = front_stats.icache_req_fire_cycles;
-  const uint64_t miss_total = front_stats.icache_miss_event_cycles;
-  const uint64_t icache_latency_total = front_stats.bubble_icache_latency_cycles;
-  const uint64_t itlb_retry_total = front_stats.bubble_icache_tlb_retry_cycles;
+  const uint64_t bubble_total = st.front_stats.backend_bubble_cycles;
+  const uint64_t demand_total = st.front_stats.backend_demand_cycles;
+  const uint64_t active_total = st.front_stats.active_cycles;
+  const uint64_t req_fire_total = st.front_stats.icache_req_fire_cycles;
+  const uint64_t miss_total = st.front_stats.icache_miss_event_cycles;
+  const uint64_t icache_latency_total = st.front_stats.bubble_icache_latency_cycles;
+  const uint64_t itlb_retry_total = st.front_stats.bubble_icache_tlb_retry_cycles;
 
   std::printf("\n=== FALCON Front-end Report ===\n");
   std::printf(
@@ -268,63 +232,63 @@ static void falcon_print_summary() {
 
   std::printf(
       "window: is_ckpt=%d perf_start=%d warmup_cycles=%llu measured_cycles=%llu aligned_with_tma=%d\n",
-      (front_ctx != nullptr && front_ctx->is_ckpt) ? 1 : 0,
-      (front_ctx != nullptr && front_ctx->perf.perf_start) ? 1 : 0,
-      static_cast<unsigned long long>(falcon_warmup_cycles),
-      static_cast<unsigned long long>(front_stats.cycles),
-      falcon_measurement_window_active() ? 1 : 0);
+      (st.front_ctx != nullptr && st.front_ctx->is_ckpt) ? 1 : 0,
+      (st.front_ctx != nullptr && st.front_ctx->perf.perf_start) ? 1 : 0,
+      static_cast<unsigned long long>(st.falcon_warmup_cycles),
+      static_cast<unsigned long long>(st.front_stats.cycles),
+      falcon_measurement_window_active(st) ? 1 : 0);
 
   std::printf(
       "cycles: total=%llu active=%llu reset=%llu refetch(ext=%llu delayed=%llu global=%llu)\n",
-      static_cast<unsigned long long>(front_stats.cycles),
-      static_cast<unsigned long long>(front_stats.active_cycles),
-      static_cast<unsigned long long>(front_stats.reset_cycles),
-      static_cast<unsigned long long>(front_stats.ext_refetch_cycles),
-      static_cast<unsigned long long>(front_stats.delayed_refetch_cycles),
-      static_cast<unsigned long long>(front_stats.global_refetch_cycles));
+      static_cast<unsigned long long>(st.front_stats.cycles),
+      static_cast<unsigned long long>(st.front_stats.active_cycles),
+      static_cast<unsigned long long>(st.front_stats.reset_cycles),
+      static_cast<unsigned long long>(st.front_stats.ext_refetch_cycles),
+      static_cast<unsigned long long>(st.front_stats.delayed_refetch_cycles),
+      static_cast<unsigned long long>(st.front_stats.global_refetch_cycles));
 
   std::printf(
       "throughput: demand=%llu deliver=%llu bubble=%llu bubble_pct=%.2f%% groups=%llu insts=%llu inst/cycle=%.6f inst/active=%.6f inst/demand=%.6f\n",
-      static_cast<unsigned long long>(front_stats.backend_demand_cycles),
-      static_cast<unsigned long long>(front_stats.backend_deliver_cycles),
-      static_cast<unsigned long long>(front_stats.backend_bubble_cycles),
-      front_stats_pct(front_stats.backend_bubble_cycles, demand_total),
-      static_cast<unsigned long long>(front_stats.delivered_groups),
-      static_cast<unsigned long long>(front_stats.delivered_insts),
-      front_stats_ratio(front_stats.delivered_insts, front_stats.cycles),
-      front_stats_ratio(front_stats.delivered_insts, active_total),
-      front_stats_ratio(front_stats.delivered_insts, demand_total));
+      static_cast<unsigned long long>(st.front_stats.backend_demand_cycles),
+      static_cast<unsigned long long>(st.front_stats.backend_deliver_cycles),
+      static_cast<unsigned long long>(st.front_stats.backend_bubble_cycles),
+      front_stats_pct(st.front_stats.backend_bubble_cycles, demand_total),
+      static_cast<unsigned long long>(st.front_stats.delivered_groups),
+      static_cast<unsigned long long>(st.front_stats.delivered_insts),
+      front_stats_ratio(st.front_stats.delivered_insts, st.front_stats.cycles),
+      front_stats_ratio(st.front_stats.delivered_insts, active_total),
+      front_stats_ratio(st.front_stats.delivered_insts, demand_total));
 
   std::printf(
       "bubble_root_share(on demand bubbles): reset=%llu(%.2f%%) refetch=%llu(%.2f%%) icache_miss=%llu(%.2f%%) icache_latency=%llu(%.2f%%) bpu_stall=%llu(%.2f%%) fetch_addr_empty=%llu(%.2f%%) ptab_empty=%llu(%.2f%%) dummy_ptab=%llu(%.2f%%) inst_fifo_other=%llu(%.2f%%) other=%llu(%.2f%%)\n",
-      static_cast<unsigned long long>(front_stats.bubble_reset_cycles),
-      front_stats_pct(front_stats.bubble_reset_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_refetch_cycles),
-      front_stats_pct(front_stats.bubble_refetch_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_icache_miss_cycles),
-      front_stats_pct(front_stats.bubble_icache_miss_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_icache_latency_cycles),
-      front_stats_pct(front_stats.bubble_icache_latency_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_bpu_stall_cycles),
-      front_stats_pct(front_stats.bubble_bpu_stall_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_fetch_addr_empty_cycles),
-      front_stats_pct(front_stats.bubble_fetch_addr_empty_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_ptab_empty_cycles),
-      front_stats_pct(front_stats.bubble_ptab_empty_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_dummy_ptab_cycles),
-      front_stats_pct(front_stats.bubble_dummy_ptab_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_inst_fifo_empty_other_cycles),
-      front_stats_pct(front_stats.bubble_inst_fifo_empty_other_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble_other_cycles),
-      front_stats_pct(front_stats.bubble_other_cycles, bubble_total));
+      static_cast<unsigned long long>(st.front_stats.bubble_reset_cycles),
+      front_stats_pct(st.front_stats.bubble_reset_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_refetch_cycles),
+      front_stats_pct(st.front_stats.bubble_refetch_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_miss_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_miss_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_latency_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_latency_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_bpu_stall_cycles),
+      front_stats_pct(st.front_stats.bubble_bpu_stall_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_fetch_addr_empty_cycles),
+      front_stats_pct(st.front_stats.bubble_fetch_addr_empty_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_ptab_empty_cycles),
+      front_stats_pct(st.front_stats.bubble_ptab_empty_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_dummy_ptab_cycles),
+      front_stats_pct(st.front_stats.bubble_dummy_ptab_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_inst_fifo_empty_other_cycles),
+      front_stats_pct(st.front_stats.bubble_inst_fifo_empty_other_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_other_cycles),
+      front_stats_pct(st.front_stats.bubble_other_cycles, bubble_total));
 
   const uint64_t bubble2_sum =
-      front_stats.bubble2_reset_cycles +
-      front_stats.bubble2_recovery_backend_refetch_cycles +
-      front_stats.bubble2_recovery_frontend_flush_cycles +
-      front_stats.bubble2_fetch_stall_cycles +
-      front_stats.bubble2_glue_or_fifo_cycles +
-      front_stats.bubble2_bpu_side_cycles + front_stats.bubble2_other_cycles;
+      st.front_stats.bubble2_reset_cycles +
+      st.front_stats.bubble2_recovery_backend_refetch_cycles +
+      st.front_stats.bubble2_recovery_frontend_flush_cycles +
+      st.front_stats.bubble2_fetch_stall_cycles +
+      st.front_stats.bubble2_glue_or_fifo_cycles +
+      st.front_stats.bubble2_bpu_side_cycles + st.front_stats.bubble2_other_cycles;
   const long long bubble2_delta =
       static_cast<long long>(bubble_total) - static_cast<long long>(bubble2_sum);
 
@@ -336,30 +300,30 @@ static void falcon_print_summary() {
 
   std::printf(
       "bubble_root2_share(on demand bubbles): reset=%llu(%.2f%%) recovery_backend_refetch=%llu(%.2f%%) recovery_frontend_flush=%llu(%.2f%%) fetch_stall=%llu(%.2f%%) glue_or_fifo=%llu(%.2f%%) bpu_side=%llu(%.2f%%) other=%llu(%.2f%%)\n",
-      static_cast<unsigned long long>(front_stats.bubble2_reset_cycles),
-      front_stats_pct(front_stats.bubble2_reset_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble2_recovery_backend_refetch_cycles),
-      front_stats_pct(front_stats.bubble2_recovery_backend_refetch_cycles,
+      static_cast<unsigned long long>(st.front_stats.bubble2_reset_cycles),
+      front_stats_pct(st.front_stats.bubble2_reset_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble2_recovery_backend_refetch_cycles),
+      front_stats_pct(st.front_stats.bubble2_recovery_backend_refetch_cycles,
                       bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble2_recovery_frontend_flush_cycles),
-      front_stats_pct(front_stats.bubble2_recovery_frontend_flush_cycles,
+      static_cast<unsigned long long>(st.front_stats.bubble2_recovery_frontend_flush_cycles),
+      front_stats_pct(st.front_stats.bubble2_recovery_frontend_flush_cycles,
                       bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble2_fetch_stall_cycles),
-      front_stats_pct(front_stats.bubble2_fetch_stall_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble2_glue_or_fifo_cycles),
-      front_stats_pct(front_stats.bubble2_glue_or_fifo_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble2_bpu_side_cycles),
-      front_stats_pct(front_stats.bubble2_bpu_side_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble2_other_cycles),
-      front_stats_pct(front_stats.bubble2_other_cycles, bubble_total));
+      static_cast<unsigned long long>(st.front_stats.bubble2_fetch_stall_cycles),
+      front_stats_pct(st.front_stats.bubble2_fetch_stall_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble2_glue_or_fifo_cycles),
+      front_stats_pct(st.front_stats.bubble2_glue_or_fifo_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble2_bpu_side_cycles),
+      front_stats_pct(st.front_stats.bubble2_bpu_side_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble2_other_cycles),
+      front_stats_pct(st.front_stats.bubble2_other_cycles, bubble_total));
 
   const uint64_t bubble3_sum =
-      front_stats.bubble3_reset_cycles +
-      front_stats.bubble3_recovery_backend_refetch_cycles +
-      front_stats.bubble3_recovery_frontend_flush_cycles +
-      front_stats.bubble3_fetch_stall_cycles +
-      front_stats.bubble3_glue_or_fifo_cycles +
-      front_stats.bubble3_bpu_side_cycles + front_stats.bubble3_other_cycles;
+      st.front_stats.bubble3_reset_cycles +
+      st.front_stats.bubble3_recovery_backend_refetch_cycles +
+      st.front_stats.bubble3_recovery_frontend_flush_cycles +
+      st.front_stats.bubble3_fetch_stall_cycles +
+      st.front_stats.bubble3_glue_or_fifo_cycles +
+      st.front_stats.bubble3_bpu_side_cycles + st.front_stats.bubble3_other_cycles;
   const long long bubble3_delta =
       static_cast<long long>(bubble_total) - static_cast<long long>(bubble3_sum);
 
@@ -371,79 +335,79 @@ static void falcon_print_summary() {
 
   std::printf(
       "bubble_root3_share(on demand bubbles): reset=%llu(%.2f%%) recovery_backend_refetch=%llu(%.2f%%) recovery_frontend_flush=%llu(%.2f%%) fetch_stall=%llu(%.2f%%) glue_or_fifo=%llu(%.2f%%) bpu_side=%llu(%.2f%%) other=%llu(%.2f%%)\n",
-      static_cast<unsigned long long>(front_stats.bubble3_reset_cycles),
-      front_stats_pct(front_stats.bubble3_reset_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble3_reset_cycles),
+      front_stats_pct(st.front_stats.bubble3_reset_cycles, bubble_total),
       static_cast<unsigned long long>(
-          front_stats.bubble3_recovery_backend_refetch_cycles),
-      front_stats_pct(front_stats.bubble3_recovery_backend_refetch_cycles,
+          st.front_stats.bubble3_recovery_backend_refetch_cycles),
+      front_stats_pct(st.front_stats.bubble3_recovery_backend_refetch_cycles,
                       bubble_total),
       static_cast<unsigned long long>(
-          front_stats.bubble3_recovery_frontend_flush_cycles),
-      front_stats_pct(front_stats.bubble3_recovery_frontend_flush_cycles,
+          st.front_stats.bubble3_recovery_frontend_flush_cycles),
+      front_stats_pct(st.front_stats.bubble3_recovery_frontend_flush_cycles,
                       bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble3_fetch_stall_cycles),
-      front_stats_pct(front_stats.bubble3_fetch_stall_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble3_glue_or_fifo_cycles),
-      front_stats_pct(front_stats.bubble3_glue_or_fifo_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble3_bpu_side_cycles),
-      front_stats_pct(front_stats.bubble3_bpu_side_cycles, bubble_total),
-      static_cast<unsigned long long>(front_stats.bubble3_other_cycles),
-      front_stats_pct(front_stats.bubble3_other_cycles, bubble_total));
+      static_cast<unsigned long long>(st.front_stats.bubble3_fetch_stall_cycles),
+      front_stats_pct(st.front_stats.bubble3_fetch_stall_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble3_glue_or_fifo_cycles),
+      front_stats_pct(st.front_stats.bubble3_glue_or_fifo_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble3_bpu_side_cycles),
+      front_stats_pct(st.front_stats.bubble3_bpu_side_cycles, bubble_total),
+      static_cast<unsigned long long>(st.front_stats.bubble3_other_cycles),
+      front_stats_pct(st.front_stats.bubble3_other_cycles, bubble_total));
 
   std::printf(
       "bpu_stage: can_run=%llu stall=%llu stall_pct(active)=%.2f%% stall_fetch_addr_full=%llu stall_ptab_full=%llu issue=%llu issue_pct(active)=%.2f%%\n",
-      static_cast<unsigned long long>(front_stats.bpu_can_run_cycles),
-      static_cast<unsigned long long>(front_stats.bpu_stall_cycles),
-      front_stats_pct(front_stats.bpu_stall_cycles, active_total),
-      static_cast<unsigned long long>(front_stats.bpu_stall_fetch_addr_full_cycles),
-      static_cast<unsigned long long>(front_stats.bpu_stall_ptab_full_cycles),
-      static_cast<unsigned long long>(front_stats.bpu_issue_cycles),
-      front_stats_pct(front_stats.bpu_issue_cycles, active_total));
+      static_cast<unsigned long long>(st.front_stats.bpu_can_run_cycles),
+      static_cast<unsigned long long>(st.front_stats.bpu_stall_cycles),
+      front_stats_pct(st.front_stats.bpu_stall_cycles, active_total),
+      static_cast<unsigned long long>(st.front_stats.bpu_stall_fetch_addr_full_cycles),
+      static_cast<unsigned long long>(st.front_stats.bpu_stall_ptab_full_cycles),
+      static_cast<unsigned long long>(st.front_stats.bpu_issue_cycles),
+      front_stats_pct(st.front_stats.bpu_issue_cycles, active_total));
 
   std::printf(
       "icache_stage: req_seen=%llu req_fire=%llu req_blocked=%llu resp=%llu outstanding=%llu miss_event=%llu miss_rate(req_fire)=%.4f%% miss_busy=%llu miss_busy_pct(active)=%.2f%%\n",
-      static_cast<unsigned long long>(front_stats.icache_req_slot0_cycles),
-      static_cast<unsigned long long>(front_stats.icache_req_fire_cycles),
-      static_cast<unsigned long long>(front_stats.icache_req_blocked_cycles),
-      static_cast<unsigned long long>(front_stats.icache_resp_fire_cycles),
-      static_cast<unsigned long long>(front_stats.icache_outstanding_req_cycles),
-      static_cast<unsigned long long>(front_stats.icache_miss_event_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_req_slot0_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_req_fire_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_req_blocked_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_resp_fire_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_outstanding_req_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_miss_event_cycles),
       front_stats_pct(miss_total, req_fire_total),
-      static_cast<unsigned long long>(front_stats.icache_miss_busy_cycles),
-      front_stats_pct(front_stats.icache_miss_busy_cycles, active_total));
+      static_cast<unsigned long long>(st.front_stats.icache_miss_busy_cycles),
+      front_stats_pct(st.front_stats.icache_miss_busy_cycles, active_total));
 
   std::printf(
       "icache_cold_like: window_cycles=%llu miss_event_in_window=%llu miss_event_pct(req_fire)=%.4f%%\n",
       static_cast<unsigned long long>(kFalconColdMissWindowCycles),
-      static_cast<unsigned long long>(front_stats.icache_miss_event_cold_window_cycles),
-      front_stats_pct(front_stats.icache_miss_event_cold_window_cycles,
+      static_cast<unsigned long long>(st.front_stats.icache_miss_event_cold_window_cycles),
+      front_stats_pct(st.front_stats.icache_miss_event_cold_window_cycles,
                       req_fire_total));
 
   std::printf(
       "icache_latency_detail(on icache_latency bubbles): tlb_retry=%llu(%.2f%%) tlb_fault=%llu(%.2f%%) cache_backpressure=%llu(%.2f%%) other=%llu(%.2f%%)\n",
-      static_cast<unsigned long long>(front_stats.bubble_icache_tlb_retry_cycles),
-      front_stats_pct(front_stats.bubble_icache_tlb_retry_cycles, icache_latency_total),
-      static_cast<unsigned long long>(front_stats.bubble_icache_tlb_fault_cycles),
-      front_stats_pct(front_stats.bubble_icache_tlb_fault_cycles, icache_latency_total),
-      static_cast<unsigned long long>(front_stats.bubble_icache_cache_backpressure_cycles),
-      front_stats_pct(front_stats.bubble_icache_cache_backpressure_cycles, icache_latency_total),
-      static_cast<unsigned long long>(front_stats.bubble_icache_latency_other_cycles),
-      front_stats_pct(front_stats.bubble_icache_latency_other_cycles, icache_latency_total));
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_tlb_retry_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_tlb_retry_cycles, icache_latency_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_tlb_fault_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_tlb_fault_cycles, icache_latency_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_cache_backpressure_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_cache_backpressure_cycles, icache_latency_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_latency_other_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_latency_other_cycles, icache_latency_total));
 
   const char *icache_latency_top1_name = "tlb_retry";
-  uint64_t icache_latency_top1_cycles = front_stats.bubble_icache_tlb_retry_cycles;
-  if (front_stats.bubble_icache_tlb_fault_cycles > icache_latency_top1_cycles) {
+  uint64_t icache_latency_top1_cycles = st.front_stats.bubble_icache_tlb_retry_cycles;
+  if (st.front_stats.bubble_icache_tlb_fault_cycles > icache_latency_top1_cycles) {
     icache_latency_top1_name = "tlb_fault";
-    icache_latency_top1_cycles = front_stats.bubble_icache_tlb_fault_cycles;
+    icache_latency_top1_cycles = st.front_stats.bubble_icache_tlb_fault_cycles;
   }
-  if (front_stats.bubble_icache_cache_backpressure_cycles >
+  if (st.front_stats.bubble_icache_cache_backpressure_cycles >
       icache_latency_top1_cycles) {
     icache_latency_top1_name = "cache_backpressure";
-    icache_latency_top1_cycles = front_stats.bubble_icache_cache_backpressure_cycles;
+    icache_latency_top1_cycles = st.front_stats.bubble_icache_cache_backpressure_cycles;
   }
-  if (front_stats.bubble_icache_latency_other_cycles > icache_latency_top1_cycles) {
+  if (st.front_stats.bubble_icache_latency_other_cycles > icache_latency_top1_cycles) {
     icache_latency_top1_name = "other";
-    icache_latency_top1_cycles = front_stats.bubble_icache_latency_other_cycles;
+    icache_latency_top1_cycles = st.front_stats.bubble_icache_latency_other_cycles;
   }
   std::printf(
       "icache_latency_top1: reason=%s cycles=%llu share_in_icache_latency=%.2f%%\n",
@@ -453,34 +417,34 @@ static void falcon_print_summary() {
 
   std::printf(
       "itlb_retry_detail(on tlb_retry bubbles): other_walk_active=%llu(%.2f%%) walk_req_blocked=%llu(%.2f%%) wait_walk_resp=%llu(%.2f%%) local_walker_busy=%llu(%.2f%%)\n",
-      static_cast<unsigned long long>(front_stats.bubble_icache_tlb_retry_other_walk_cycles),
-      front_stats_pct(front_stats.bubble_icache_tlb_retry_other_walk_cycles, itlb_retry_total),
-      static_cast<unsigned long long>(front_stats.bubble_icache_tlb_retry_walk_req_blocked_cycles),
-      front_stats_pct(front_stats.bubble_icache_tlb_retry_walk_req_blocked_cycles, itlb_retry_total),
-      static_cast<unsigned long long>(front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles),
-      front_stats_pct(front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles, itlb_retry_total),
-      static_cast<unsigned long long>(front_stats.bubble_icache_tlb_retry_local_walker_cycles),
-      front_stats_pct(front_stats.bubble_icache_tlb_retry_local_walker_cycles, itlb_retry_total));
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_tlb_retry_other_walk_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_tlb_retry_other_walk_cycles, itlb_retry_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_tlb_retry_walk_req_blocked_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_tlb_retry_walk_req_blocked_cycles, itlb_retry_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles, itlb_retry_total),
+      static_cast<unsigned long long>(st.front_stats.bubble_icache_tlb_retry_local_walker_cycles),
+      front_stats_pct(st.front_stats.bubble_icache_tlb_retry_local_walker_cycles, itlb_retry_total));
 
   const char *itlb_retry_top1_name = "other_walk_active";
   uint64_t itlb_retry_top1_cycles =
-      front_stats.bubble_icache_tlb_retry_other_walk_cycles;
-  if (front_stats.bubble_icache_tlb_retry_walk_req_blocked_cycles >
+      st.front_stats.bubble_icache_tlb_retry_other_walk_cycles;
+  if (st.front_stats.bubble_icache_tlb_retry_walk_req_blocked_cycles >
       itlb_retry_top1_cycles) {
     itlb_retry_top1_name = "walk_req_blocked";
     itlb_retry_top1_cycles =
-        front_stats.bubble_icache_tlb_retry_walk_req_blocked_cycles;
+        st.front_stats.bubble_icache_tlb_retry_walk_req_blocked_cycles;
   }
-  if (front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles >
+  if (st.front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles >
       itlb_retry_top1_cycles) {
     itlb_retry_top1_name = "wait_walk_resp";
     itlb_retry_top1_cycles =
-        front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles;
+        st.front_stats.bubble_icache_tlb_retry_wait_walk_resp_cycles;
   }
-  if (front_stats.bubble_icache_tlb_retry_local_walker_cycles >
+  if (st.front_stats.bubble_icache_tlb_retry_local_walker_cycles >
       itlb_retry_top1_cycles) {
     itlb_retry_top1_name = "local_walker_busy";
-    itlb_retry_top1_cycles = front_stats.bubble_icache_tlb_retry_local_walker_cycles;
+    itlb_retry_top1_cycles = st.front_stats.bubble_icache_tlb_retry_local_walker_cycles;
   }
   std::printf(
       "itlb_retry_top1: reason=%s cycles=%llu share_in_itlb_retry=%.2f%%\n",
@@ -488,8 +452,8 @@ static void falcon_print_summary() {
       static_cast<unsigned long long>(itlb_retry_top1_cycles),
       front_stats_pct(itlb_retry_top1_cycles, itlb_retry_total));
 
-  if (front_ctx != nullptr) {
-    const auto &perf = front_ctx->perf;
+  if (st.front_ctx != nullptr) {
+    const auto &perf = st.front_ctx->perf;
     std::printf(
         "shared_ptw_itlb_stats: req=%llu grant=%llu resp=%llu blocked=%llu wait=%llu grant_rate=%.2f%% blocked_per_req=%.2f%%\n",
         static_cast<unsigned long long>(perf.ptw_itlb_req),
@@ -503,106 +467,118 @@ static void falcon_print_summary() {
 
   std::printf(
       "predecode_stage: run=%llu block_fifo_empty=%llu block_ptab_empty=%llu block_f2b_full=%llu block_dummy_ptab=%llu checker_run=%llu checker_flush=%llu\n",
-      static_cast<unsigned long long>(front_stats.predecode_run_cycles),
-      static_cast<unsigned long long>(front_stats.predecode_block_fifo_empty_cycles),
-      static_cast<unsigned long long>(front_stats.predecode_block_ptab_empty_cycles),
-      static_cast<unsigned long long>(front_stats.predecode_block_front2back_full_cycles),
-      static_cast<unsigned long long>(front_stats.predecode_block_dummy_ptab_cycles),
-      static_cast<unsigned long long>(front_stats.checker_run_cycles),
-      static_cast<unsigned long long>(front_stats.checker_flush_cycles));
+      static_cast<unsigned long long>(st.front_stats.predecode_run_cycles),
+      static_cast<unsigned long long>(st.front_stats.predecode_block_fifo_empty_cycles),
+      static_cast<unsigned long long>(st.front_stats.predecode_block_ptab_empty_cycles),
+      static_cast<unsigned long long>(st.front_stats.predecode_block_front2back_full_cycles),
+      static_cast<unsigned long long>(st.front_stats.predecode_block_dummy_ptab_cycles),
+      static_cast<unsigned long long>(st.front_stats.checker_run_cycles),
+      static_cast<unsigned long long>(st.front_stats.checker_flush_cycles));
 
   std::printf(
       "queue_flow: fetch_addr_rd0=%llu wr_normal=%llu inst_fifo_wr0=%llu ptab_wr=%llu f2b_write=%llu f2b_valid_out=%llu bypass_f2i=%llu bypass_i2p=%llu bypass_f2o=%llu/%llu\n",
-      static_cast<unsigned long long>(front_stats.fetch_addr_read_slot0_cycles),
-      static_cast<unsigned long long>(front_stats.fetch_addr_write_normal_cycles),
-      static_cast<unsigned long long>(front_stats.inst_fifo_write_slot0_cycles),
-      static_cast<unsigned long long>(front_stats.ptab_write_cycles),
-      static_cast<unsigned long long>(front_stats.front2back_write_cycles),
-      static_cast<unsigned long long>(front_stats.front2back_valid_out_cycles),
-      static_cast<unsigned long long>(front_stats.bypass_fetch_to_icache_opportunity_cycles),
-      static_cast<unsigned long long>(front_stats.bypass_icache_to_predecode_opportunity_cycles),
-      static_cast<unsigned long long>(front_stats.bypass_front2back_to_output_hit_cycles),
-      static_cast<unsigned long long>(front_stats.bypass_front2back_to_output_opportunity_cycles));
+      static_cast<unsigned long long>(st.front_stats.fetch_addr_read_slot0_cycles),
+      static_cast<unsigned long long>(st.front_stats.fetch_addr_write_normal_cycles),
+      static_cast<unsigned long long>(st.front_stats.inst_fifo_write_slot0_cycles),
+      static_cast<unsigned long long>(st.front_stats.ptab_write_cycles),
+      static_cast<unsigned long long>(st.front_stats.front2back_write_cycles),
+      static_cast<unsigned long long>(st.front_stats.front2back_valid_out_cycles),
+      static_cast<unsigned long long>(st.front_stats.bypass_fetch_to_icache_opportunity_cycles),
+      static_cast<unsigned long long>(st.front_stats.bypass_icache_to_predecode_opportunity_cycles),
+      static_cast<unsigned long long>(st.front_stats.bypass_front2back_to_output_hit_cycles),
+      static_cast<unsigned long long>(st.front_stats.bypass_front2back_to_output_opportunity_cycles));
 
   std::printf("=== End FALCON Report ===\n");
 #endif
 }
 
-static void front_stats_print_summary() {
+static void front_stats_print_summary(const FrontTopState &st) {
 #if !FRONTEND_ENABLE_RUNTIME_STATS_SUMMARY
   return;
 #else
-  if (front_stats.cycles == 0) {
+  if (st.front_stats.cycles == 0) {
     return;
   }
   std::printf(
       "\n[FRONT-STATS] cycles=%llu reset=%llu ext_refetch=%llu delayed_refetch=%llu global_refetch=%llu\n",
-      static_cast<unsigned long long>(front_stats.cycles),
-      static_cast<unsigned long long>(front_stats.reset_cycles),
-      static_cast<unsigned long long>(front_stats.ext_refetch_cycles),
-      static_cast<unsigned long long>(front_stats.delayed_refetch_cycles),
-      static_cast<unsigned long long>(front_stats.global_refetch_cycles));
+      static_cast<unsigned long long>(st.front_stats.cycles),
+      static_cast<unsigned long long>(st.front_stats.reset_cycles),
+      static_cast<unsigned long long>(st.front_stats.ext_refetch_cycles),
+      static_cast<unsigned long long>(st.front_stats.delayed_refetch_cycles),
+      static_cast<unsigned long long>(st.front_stats.global_refetch_cycles));
   std::printf(
       "[FRONT-STATS] bpu can_run=%llu stall=%llu stall_fetch_addr_full=%llu stall_ptab_full=%llu issue=%llu\n",
-      static_cast<unsigned long long>(front_stats.bpu_can_run_cycles),
-      static_cast<unsigned long long>(front_stats.bpu_stall_cycles),
-      static_cast<unsigned long long>(front_stats.bpu_stall_fetch_addr_full_cycles),
-      static_cast<unsigned long long>(front_stats.bpu_stall_ptab_full_cycles),
-      static_cast<unsigned long long>(front_stats.bpu_issue_cycles));
+      static_cast<unsigned long long>(st.front_stats.bpu_can_run_cycles),
+      static_cast<unsigned long long>(st.front_stats.bpu_stall_cycles),
+      static_cast<unsigned long long>(st.front_stats.bpu_stall_fetch_addr_full_cycles),
+      static_cast<unsigned long long>(st.front_stats.bpu_stall_ptab_full_cycles),
+      static_cast<unsigned long long>(st.front_stats.bpu_issue_cycles));
   std::printf(
       "[FRONT-STATS] fetch_addr rd0=%llu rd1=%llu wr_normal=%llu wr_2ahead=%llu skip_mini_flush_correct=%llu\n",
-      static_cast<unsigned long long>(front_stats.fetch_addr_read_slot0_cycles),
-      static_cast<unsigned long long>(front_stats.fetch_addr_read_slot1_cycles),
-      static_cast<unsigned long long>(front_stats.fetch_addr_write_normal_cycles),
-      static_cast<unsigned long long>(front_stats.fetch_addr_write_twoahead_cycles),
-      static_cast<unsigned long long>(front_stats.fetch_addr_write_skip_by_mini_flush_correct_cycles));
+      static_cast<unsigned long long>(st.front_stats.fetch_addr_read_slot0_cycles),
+      static_cast<unsigned long long>(st.front_stats.fetch_addr_read_slot1_cycles),
+      static_cast<unsigned long long>(st.front_stats.fetch_addr_write_normal_cycles),
+      static_cast<unsigned long long>(st.front_stats.fetch_addr_write_twoahead_cycles),
+      static_cast<unsigned long long>(st.front_stats.fetch_addr_write_skip_by_mini_flush_correct_cycles));
   std::printf(
       "[FRONT-STATS] icache req0=%llu req1=%llu resp0=%llu resp1=%llu inst_fifo_wr0=%llu inst_fifo_wr1=%llu ptab_wr=%llu\n",
-      static_cast<unsigned long long>(front_stats.icache_req_slot0_cycles),
-      static_cast<unsigned long long>(front_stats.icache_req_slot1_cycles),
-      static_cast<unsigned long long>(front_stats.icache_resp_slot0_cycles),
-      static_cast<unsigned long long>(front_stats.icache_resp_slot1_cycles),
-      static_cast<unsigned long long>(front_stats.inst_fifo_write_slot0_cycles),
-      static_cast<unsigned long long>(front_stats.inst_fifo_write_slot1_cycles),
-      static_cast<unsigned long long>(front_stats.ptab_write_cycles));
+      static_cast<unsigned long long>(st.front_stats.icache_req_slot0_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_req_slot1_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_resp_slot0_cycles),
+      static_cast<unsigned long long>(st.front_stats.icache_resp_slot1_cycles),
+      static_cast<unsigned long long>(st.front_stats.inst_fifo_write_slot0_cycles),
+      static_cast<unsigned long long>(st.front_stats.inst_fifo_write_slot1_cycles),
+      static_cast<unsigned long long>(st.front_stats.ptab_write_cycles));
   std::printf(
       "[FRONT-STATS] predecode run=%llu block_fifo_empty=%llu block_ptab_empty=%llu block_f2b_full=%llu block_ptab_dummy=%llu checker_run=%llu checker_flush=%llu mini_req=%llu mini_correct=%llu\n",
-      static_cast<unsigned long long>(front_stats.predecode_run_cycles),
-      static_cast<unsigned long long>(front_stats.predecode_block_fifo_empty_cycles),
-      static_cast<unsigned long long>(front_stats.predecode_block_ptab_empty_cycles),
-      static_cast<unsigned long long>(front_stats.predecode_block_front2back_full_cycles),
-      static_cast<unsigned long long>(front_stats.predecode_block_dummy_ptab_cycles),
-      static_cast<unsigned long long>(front_stats.checker_run_cycles),
-      static_cast<unsigned long long>(front_stats.checker_flush_cycles),
-      static_cast<unsigned long long>(front_stats.mini_flush_req_cycles),
-      static_cast<unsigned long long>(front_stats.mini_flush_correct_cycles));
+      static_cast<unsigned long long>(st.front_stats.predecode_run_cycles),
+      static_cast<unsigned long long>(st.front_stats.predecode_block_fifo_empty_cycles),
+      static_cast<unsigned long long>(st.front_stats.predecode_block_ptab_empty_cycles),
+      static_cast<unsigned long long>(st.front_stats.predecode_block_front2back_full_cycles),
+      static_cast<unsigned long long>(st.front_stats.predecode_block_dummy_ptab_cycles),
+      static_cast<unsigned long long>(st.front_stats.checker_run_cycles),
+      static_cast<unsigned long long>(st.front_stats.checker_flush_cycles),
+      static_cast<unsigned long long>(st.front_stats.mini_flush_req_cycles),
+      static_cast<unsigned long long>(st.front_stats.mini_flush_correct_cycles));
   std::printf(
       "[FRONT-STATS] front2back write=%llu read_req=%llu valid_out=%llu\n",
-      static_cast<unsigned long long>(front_stats.front2back_write_cycles),
-      static_cast<unsigned long long>(front_stats.front2back_read_req_cycles),
-      static_cast<unsigned long long>(front_stats.front2back_valid_out_cycles));
+      static_cast<unsigned long long>(st.front_stats.front2back_write_cycles),
+      static_cast<unsigned long long>(st.front_stats.front2back_read_req_cycles),
+      static_cast<unsigned long long>(st.front_stats.front2back_valid_out_cycles));
   std::printf(
       "[FRONT-STATS] bypass_opp fetch_to_icache=%llu icache_to_predecode=%llu f2b_to_output=%llu f2b_hit=%llu\n",
-      static_cast<unsigned long long>(front_stats.bypass_fetch_to_icache_opportunity_cycles),
-      static_cast<unsigned long long>(front_stats.bypass_icache_to_predecode_opportunity_cycles),
-      static_cast<unsigned long long>(front_stats.bypass_front2back_to_output_opportunity_cycles),
-      static_cast<unsigned long long>(front_stats.bypass_front2back_to_output_hit_cycles));
+      static_cast<unsigned long long>(st.front_stats.bypass_fetch_to_icache_opportunity_cycles),
+      static_cast<unsigned long long>(st.front_stats.bypass_icache_to_predecode_opportunity_cycles),
+      static_cast<unsigned long long>(st.front_stats.bypass_front2back_to_output_opportunity_cycles),
+      static_cast<unsigned long long>(st.front_stats.bypass_front2back_to_output_hit_cycles));
+#if ENABLE_ITTAGE
+  const ITTAGE_TOP::Stats ittage = st.bpu_instance.ittage_stats();
+  if (ittage.upd_num != 0) {
+    std::printf("[FRONT-STATS] ittage upd=%llu alloc_fail=%llu",
+                static_cast<unsigned long long>(ittage.upd_num),
+                static_cast<unsigned long long>(ittage.alloc_fail));
+    for (int t = 0; t < TN_MAX; t++) {
+      std::printf(" t%d(hit=%llu correct=%llu alloc=%llu)", t,
+                  static_cast<unsigned long long>(ittage.provider_hit[t]),
+                  static_cast<unsigned long long>(ittage.provider_correct[t]),
+                  static_cast<unsigned long long>(ittage.alloc[t]));
+    }
+    std::printf("\n");
+  }
+#endif
 #endif
 }
 
-struct FrontStatsAtExit {
-  ~FrontStatsAtExit() {
-    falcon_print_summary();
-    front_stats_print_summary();
-  }
-};
+FrontTopState::FrontTopState() : icache_state(std::make_unique<ICacheState>()) {}
 
-static FrontStatsAtExit front_stats_at_exit;
-
-static BPU_TOP bpu_instance;
+FrontTopState::~FrontTopState() {
+  falcon_print_summary(*this);
+  front_stats_print_summary(*this);
+  if (front_bound_state == this) {
+    front_bound_state = nullptr;
+  }
+}
 
-// 定义全局指针，供TAGE访问BPU的GHR/FH
-BPU_TOP *g_bpu_top = &bpu_instance;
 // ============================================================================
 // 辅助函数
 // ============================================================================
@@ -699,6 +675,7 @@ static void front_bpu_control_comb(const FrontBpuControlCombIn &input,
         output.bpu_input.in_upd_valid[i] = output.bpu_in.back2front_valid[i];
         output.bpu_input.in_actual_dir[i] = output.bpu_in.actual_dir[i];
         output.bpu_input.in_actual_br_type[i] = output.bpu_in.actual_br_type[i];
+        output.bpu_input.in_upd_is_rvc[i] = output.bpu_in.actual_is_rvc[i];
         output.bpu_input.in_actual_targets[i] = output.bpu_in.actual_target[i];
         output.bpu_input.in_pred_dir[i] = output.bpu_in.predict_dir[i];
         output.bpu_input.in_alt_pred[i] = output.bpu_in.alt_pred[i];
@@ -738,7 +715,8 @@ static void front_ptab_write_comb(const FrontPtabWriteCombIn &input,
     }
     for (int i = 0; i < FETCH_WIDTH; i++) {
         output.ptab_in.predict_dir[i] = bpu_output.out_pred_dir[i];
-        output.ptab_in.predict_base_pc[i] = bpu_output.out_pred_base_pc + (i * 4);
+        output.ptab_in.predict_base_pc[i] =
+            bpu_output.out_pred_base_pc + (i * FETCH_SLOT_BYTES);
         output.ptab_in.alt_pred[i] = bpu_output.out_alt_pred[i];
         output.ptab_in.altpcpn[i] = bpu_output.out_altpcpn[i];
         output.ptab_in.pcpn[i] = bpu_output.out_pcpn[i];
@@ -777,6 +755,136 @@ static void front_checker_input_comb(const FrontCheckerInputCombIn &input,
     output.checker_in.predict_next_fetch_address = ptab_out.predict_next_fetch_address;
 }
 
+#ifdef CONFIG_RVC
+static void front_rvc_carry_from_ptab(const PTAB_out &ptab, int slot,
+                                      FrontRvcCarry &carry) {
+    carry.predict_dir = ptab.predict_dir[slot];
+    carry.alt_pred = ptab.alt_pred[slot];
+    carry.altpcpn = ptab.altpcpn[slot];
+    carry.pcpn = ptab.pcpn[slot];
+    for (int j = 0; j < 4; j++) {
+        carry.tage_idx[j] = ptab.tage_idx[slot][j];
+        carry.tage_tag[j] = ptab.tage_tag[slot][j];
+    }
+    carry.sc_used = ptab.sc_used[slot];
+    carry.sc_pred = ptab.sc_pred[slot];
+    carry.sc_sum = ptab.sc_sum[slot];
+    for (int t = 0; t < BPU_SCL_META_NTABLE; ++t) {
+        carry.sc_idx[t] = ptab.sc_idx[slot][t];
+    }
+    carry.loop_used = ptab.loop_used[slot];
+    carry.loop_hit = ptab.loop_hit[slot];
+    carry.loop_pred = ptab.loop_pred[slot];
+    carry.loop_idx = ptab.loop_idx[slot];
+    carry.loop_tag = ptab.loop_tag[slot];
+}
+
+static void front_rvc_carry_to_ptab(const FrontRvcCarry &carry, PTAB_out &ptab,
+                                    int slot) {
+    ptab.predict_dir[slot] = carry.predict_dir;
+    ptab.predict_base_pc[slot] = carry.pc;
+    ptab.alt_pred[slot] = carry.alt_pred;
+    ptab.altpcpn[slot] = carry.altpcpn;
+    ptab.pcpn[slot] = carry.pcpn;
+    for (int j = 0; j < 4; j++) {
+        ptab.tage_idx[slot][j] = carry.tage_idx[j];
+        ptab.tage_tag[slot][j] = carry.tage_tag[j];
+    }
+    ptab.sc_used[slot] = carry.sc_used;
+    ptab.sc_pred[slot] = carry.sc_pred;
+    ptab.sc_sum[slot] = carry.sc_sum;
+    for (int t = 0; t < BPU_SCL_META_NTABLE; ++t) {
+        ptab.sc_idx[slot][t] = carry.sc_idx[t];
+    }
+    ptab.loop_used[slot] = carry.loop_used;
+    ptab.loop_hit[slot] = carry.loop_hit;
+    ptab.loop_pred[slot] = carry.loop_pred;
+    ptab.loop_idx[slot] = carry.loop_idx;
+    ptab.loop_tag[slot] = carry.loop_tag;
+}
+
+static void front_rvc_clear_slot(instruction_FIFO_out &fifo, int slot) {
+    fifo.inst_valid[slot] = false;
+    fifo.predecode_type[slot] = PREDECODE_NON_BRANCH;
+    fifo.predecode_target_address[slot] = 0;
+}
+
+// ============================================================================
+// RVC 指令边界：取指块按半字分槽，instructions[i] 是从第 i 个半字起的 32 位
+// 候选，预译码也按“每个半字都是起点”做过。这里在 checker 之前按程序顺序从块首
+// 扫描指令长度，只保留指令起点槽位（压缩指令截成 16 位），其余槽位置无效并
+// 视为非分支。valid 槽位不必连续，后端按槽位号记录 ftq_offset。
+//
+// 上一块末尾半字起的 32 位指令放不下（跨取指块或跨 cache 行）时作为 tail 寄存，
+// 若本块恰好从其高半部开始，就在槽位 0 拼出完整指令，pc 与预测元数据都取
+// 上一块那个槽位，与 BPU 当时对该 pc 的预测一致。取指缺页的槽位把出错地址
+// 放进指令字（高半部缺页时为 pc + 2），由后端作为 tval 上报。
+// ============================================================================
+static void front_rvc_align_comb(const FrontRvcAlignCombIn &input,
+                                 FrontRvcAlignCombOut &output) {
+    const FrontRvcCarry &carry = input.carry;
+    std::memset(&output, 0, sizeof(output));
+    output.fifo_out = input.fifo_out;
+    output.ptab_out = input.ptab_out;
+    instruction_FIFO_out &fifo = output.fifo_out;
+
+    int i = 0;
+    bool stop = false;
+    if (carry.valid && fifo.inst_valid[0] && fifo.pc[0] == carry.pc + 2) {
+        const bool upper_fault = fifo.page_fault_inst[0];
+        fifo.instructions[0] =
+            upper_fault ? fifo.pc[0] : ((fifo.instructions[0] << 16) | carry.low_half);
+        fifo.pc[0] = carry.pc;
+        fifo.predecode_type[0] = PREDECODE_NON_BRANCH;
+        fifo.predecode_target_address[0] = 0;
+        if (!upper_fault) {
+            predecode_in predecode_inp{fifo.instructions[0], carry.pc};
+            predecode_read_data predecode_rd{};
+            PredecodeResult result{};
+            predecode_seq_read(&predecode_inp, &predecode_rd);
+            predecode_comb(predecode_rd, result);
+            fifo.predecode_type[0] = result.type;
+            fifo.predecode_target_address[0] = result.target_address;
+        }
+        front_rvc_carry_to_ptab(carry, output.ptab_out, 0);
+        i = 1;
+        stop = upper_fault;
+    }
+
+    for (; i < FETCH_WIDTH && !stop; i++) {
+        if (!fifo.inst_valid[i]) {
+            break;
+        }
+        if (fifo.page_fault_inst[i]) {
+            fifo.instructions[i] = fifo.pc[i];
+            fifo.predecode_type[i] = PREDECODE_NON_BRANCH;
+            fifo.predecode_target_address[i] = 0;
+            stop = true;
+            continue;
+        }
+        const uint32_t candidate = fifo.instructions[i];
+        if (rvc_is_compressed(candidate)) {
+            fifo.instructions[i] = candidate & 0xffffu;
+            continue;
+        }
+        if (i + 1 < FETCH_WIDTH && fifo.inst_valid[i + 1]) {
+            front_rvc_clear_slot(fifo, i + 1);
+            i++;
+            continue;
+        }
+        output.tail.valid = true;
+        output.tail.pc = fifo.pc[i];
+        output.tail.low_half = candidate & 0xffffu;
+        front_rvc_carry_from_ptab(output.ptab_out, i, output.tail);
+        front_rvc_clear_slot(fifo, i);
+        stop = true;
+    }
+    for (; i < FETCH_WIDTH; i++) {
+        front_rvc_clear_slot(fifo, i);
+    }
+}
+#endif
+
 static void front_front2back_write_comb(const FrontFront2backWriteCombIn &input,
                                         FrontFront2backWriteCombOut &output) {
     const instruction_FIFO_out &fifo_out = input.fifo_out;
@@ -999,8 +1107,9 @@ static void accumulate_front2back_req(Front2BackCombOut &acc,
 // ============================================================================
 // 主函数
 // ============================================================================
-void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
-                     struct front_top_out &out, FrontUpdateRequest &req) {
+void front_comb_calc(FrontTopState &st, const struct front_top_in &inp,
+                     const FrontReadData &rd, struct front_top_out &out,
+                     FrontUpdateRequest &req) {
     FRONTEND_HOST_PROFILE_SCOPE(FrontComb);
     struct front_top_in *in = const_cast<struct front_top_in *>(&inp);
     struct front_top_out *out_ptr = &out;
@@ -1014,15 +1123,15 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
     uint32_t front_sim_time = rd.front_sim_time_snapshot + 1;
     FrontRuntimeStats front_stats = rd.front_stats_snapshot;
     DEBUG_LOG_SMALL("--------front_top sim_time: %d----------------\n", front_sim_time);
-    const bool window_active = falcon_measurement_window_active();
-    if (!falcon_window_active && window_active) {
+    const bool window_active = falcon_measurement_window_active(st);
+    if (!st.falcon_window_active && window_active) {
         front_stats = {};
-        falcon_window_active = true;
-        falcon_recovery_pending = false;
-        falcon_recovery_src = FalconRecoverySrc::NONE;
+        st.falcon_window_active = true;
+        st.falcon_recovery_pending = false;
+        st.falcon_recovery_src = FalconRecoverySrc::NONE;
     }
     if (!window_active) {
-        falcon_warmup_cycles++;
+        st.falcon_warmup_cycles++;
     }
     front_stats.cycles++;
     front_state_req.valid = false;
@@ -1101,11 +1210,11 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
         global_refetch = global_ctrl_out.global_refetch;
         refetch_address = global_ctrl_out.refetch_address;
         if (global_reset) {
-            falcon_recovery_pending = false;
-            falcon_recovery_src = FalconRecoverySrc::NONE;
+            st.falcon_recovery_pending = false;
+            st.falcon_recovery_src = FalconRecoverySrc::NONE;
         } else if (global_refetch) {
-            falcon_recovery_pending = true;
-            falcon_recovery_src = in->refetch ? FalconRecoverySrc::BACKEND_REFETCH
+            st.falcon_recovery_pending = true;
+            st.falcon_recovery_src = in->refetch ? FalconRecoverySrc::BACKEND_REFETCH
                                               : FalconRecoverySrc::FRONTEND_FLUSH;
         }
         if (global_reset) {
@@ -1137,7 +1246,7 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
         icache_in.fence_i = in->fence_i;
         icache_in.invalidate_req = false;
         icache_in.csr_status = in->csr_status;
-        icache_peek_ready(&icache_in, &icache_out);
+        icache_peek_ready(st.icache_state.get(), &icache_in, &icache_out);
 #endif
         icache_ready = icache_out.icache_read_ready;
         icache_ready_2 = icache_out.icache_read_ready_2;
@@ -1279,6 +1388,9 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
     bool bpu_stall = false;
     bool bpu_can_run = false;
     bool can_bypass_fetch_to_icache = false;
+    // FDIP 预取候选：写入 FIFO 且前面仍有排队地址的取指目标
+    bool fdip_prefetch_valid = false;
+    fetch_addr_t fdip_prefetch_address = 0;
     BPU_TOP::OutputPayload bpu_output{};
     {
         FRONTEND_HOST_PROFILE_SCOPE(FrontBpuStage);
@@ -1295,6 +1407,7 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             bpu_in_seed.predict_base_pc[i] = in->predict_base_pc[i];
             bpu_in_seed.actual_dir[i] = in->actual_dir[i];
             bpu_in_seed.actual_br_type[i] = in->actual_br_type[i];
+            bpu_in_seed.actual_is_rvc[i] = in->actual_is_rvc[i];
             bpu_in_seed.actual_target[i] = in->actual_target[i];
             bpu_in_seed.predict_dir[i] = in->predict_dir[i];
             bpu_in_seed.alt_pred[i] = in->alt_pred[i];
@@ -1349,12 +1462,13 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             bpu_seq_txn_req.req = BPU_TOP::UpdateRequest{};
             bpu_seq_txn_req.reset = true;
             bpu_output.fetch_address = RESET_PC;
-            bpu_output.two_ahead_target = bpu_output.fetch_address + (FETCH_WIDTH * 4);
+            bpu_output.two_ahead_target =
+                bpu_output.fetch_address + (FETCH_WIDTH * FETCH_SLOT_BYTES);
         } else {
             BPU_TOP::ReadData bpu_rd;
             BPU_TOP::UpdateRequest bpu_req;
-            bpu_instance.bpu_seq_read(bpu_input, bpu_rd);
-            bpu_instance.bpu_comb_calc(bpu_input, bpu_rd, bpu_output, bpu_req);
+            st.bpu_instance.bpu_seq_read(bpu_input, bpu_rd);
+            st.bpu_instance.bpu_comb_calc(bpu_input, bpu_rd, bpu_output, bpu_req);
             bpu_seq_txn_req.valid = true;
             bpu_seq_txn_req.inp = bpu_input;
             bpu_seq_txn_req.req = bpu_req;
@@ -1397,6 +1511,8 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
         if (normal_write_enable && !bpu_output.mini_flush_correct &&
             !can_bypass_fetch_to_icache) {
             front_stats.fetch_addr_write_normal_cycles++;
+            fdip_prefetch_valid = fetch_addr_fifo_rd.size > 0;
+            fdip_prefetch_address = bpu_output.fetch_address;
             fetch_addr_fifo_in.write_enable = true;
             fetch_addr_fifo_in.fetch_address = bpu_output.fetch_address;
             DEBUG_LOG_SMALL_4("normal write enable: %x\n", bpu_output.fetch_address);
@@ -1437,6 +1553,8 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
         icache_in.invalidate_req = false;
         icache_in.csr_status = in->csr_status;
         icache_in.run_comb_only = false;
+        icache_in.prefetch_valid = fdip_prefetch_valid;
+        icache_in.prefetch_address = fdip_prefetch_address;
         
         if (saved_fetch_addr_fifo_out_0.read_valid) {
             icache_in.icache_read_valid = true;
@@ -1473,7 +1591,7 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             front_stats.icache_req_slot1_cycles++;
         }
         
-        icache_comb_calc(&icache_in, &icache_out);
+        icache_comb_calc(st.icache_state.get(), &icache_in, &icache_out);
         if (icache_out.perf_req_fire) {
             front_stats.icache_req_fire_cycles++;
         }
@@ -1550,12 +1668,12 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
                 use_icache_to_predecode_bypass = true;
                 for (int i = 0; i < FETCH_WIDTH; i++) {
                     bypass_fifo_out.instructions[i] = icache_out.fetch_group[i];
-                    bypass_fifo_out.pc[i] = icache_out.fetch_pc + (i * 4);
+                    bypass_fifo_out.pc[i] = icache_out.fetch_pc + (i * FETCH_SLOT_BYTES);
                     bypass_fifo_out.page_fault_inst[i] = icache_out.page_fault_inst[i];
                     bypass_fifo_out.inst_valid[i] = icache_out.inst_valid[i];
 
                     if (icache_out.inst_valid[i]) {
-                        uint32_t current_pc = icache_out.fetch_pc + (i * 4);
+                        uint32_t current_pc = icache_out.fetch_pc + (i * FETCH_SLOT_BYTES);
                         predecode_in predecode_inp{icache_out.fetch_group[i], current_pc};
                         predecode_read_data predecode_rd{};
                         PredecodeResult result{};
@@ -1570,7 +1688,8 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
                 }
 
                 uint32_t mask = ~(ICACHE_LINE_SIZE - 1);
-                bypass_fifo_out.seq_next_pc = icache_out.fetch_pc + (FETCH_WIDTH * 4);
+                bypass_fifo_out.seq_next_pc =
+                    icache_out.fetch_pc + (FETCH_WIDTH * FETCH_SLOT_BYTES);
                 if ((bypass_fifo_out.seq_next_pc & mask) !=
                     (icache_out.fetch_pc & mask)) {
                     bypass_fifo_out.seq_next_pc &= mask;
@@ -1604,12 +1723,12 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             fifo_in.write_enable = true;
             for (int i = 0; i < FETCH_WIDTH; i++) {
                 fifo_in.fetch_group[i] = icache_out.fetch_group[i];
-                fifo_in.pc[i] = icache_out.fetch_pc + (i * 4);
+                fifo_in.pc[i] = icache_out.fetch_pc + (i * FETCH_SLOT_BYTES);
                 fifo_in.page_fault_inst[i] = icache_out.page_fault_inst[i];
                 fifo_in.inst_valid[i] = icache_out.inst_valid[i];
 
                 if (icache_out.inst_valid[i]) {
-                    uint32_t current_pc = icache_out.fetch_pc + (i * 4);
+                    uint32_t current_pc = icache_out.fetch_pc + (i * FETCH_SLOT_BYTES);
                     predecode_in predecode_inp{icache_out.fetch_group[i], current_pc};
                     predecode_read_data predecode_rd{};
                     PredecodeResult result{};
@@ -1626,7 +1745,7 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             }
 
             uint32_t mask = ~(ICACHE_LINE_SIZE - 1);
-            fifo_in.seq_next_pc = icache_out.fetch_pc + (FETCH_WIDTH * 4);
+            fifo_in.seq_next_pc = icache_out.fetch_pc + (FETCH_WIDTH * FETCH_SLOT_BYTES);
             if ((fifo_in.seq_next_pc & mask) != (icache_out.fetch_pc & mask)) {
                 fifo_in.seq_next_pc &= mask;
             }
@@ -1645,12 +1764,12 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             fifo_in.write_enable = true;
             for (int i = 0; i < FETCH_WIDTH; i++) {
                 fifo_in.fetch_group[i] = icache_out.fetch_group_2[i];
-                fifo_in.pc[i] = icache_out.fetch_pc_2 + (i * 4);
+                fifo_in.pc[i] = icache_out.fetch_pc_2 + (i * FETCH_SLOT_BYTES);
                 fifo_in.page_fault_inst[i] = icache_out.page_fault_inst_2[i];
                 fifo_in.inst_valid[i] = icache_out.inst_valid_2[i];
 
                 if (icache_out.inst_valid_2[i]) {
-                    uint32_t current_pc = icache_out.fetch_pc_2 + (i * 4);
+                    uint32_t current_pc = icache_out.fetch_pc_2 + (i * FETCH_SLOT_BYTES);
                     predecode_in predecode_inp{icache_out.fetch_group_2[i], current_pc};
                     predecode_read_data predecode_rd{};
                     PredecodeResult result{};
@@ -1668,7 +1787,7 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             }
 
             uint32_t mask = ~(ICACHE_LINE_SIZE - 1);
-            fifo_in.seq_next_pc = icache_out.fetch_pc_2 + (FETCH_WIDTH * 4);
+            fifo_in.seq_next_pc = icache_out.fetch_pc_2 + (FETCH_WIDTH * FETCH_SLOT_BYTES);
             if ((fifo_in.seq_next_pc & mask) != (icache_out.fetch_pc_2 & mask)) {
                 fifo_in.seq_next_pc &= mask;
             }
@@ -1713,8 +1832,20 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
         struct predecode_checker_out checker_out;
         memset(&checker_out, 0, sizeof(checker_out));
         
+#ifdef CONFIG_RVC
+        FrontRvcAlignCombOut rvc_align_out{};
+#endif
         if (predecode_can_run) {
             front_stats.checker_run_cycles++;
+#ifdef CONFIG_RVC
+            FrontRvcAlignCombIn rvc_align_in{};
+            rvc_align_in.fifo_out = saved_fifo_out;
+            rvc_align_in.ptab_out = saved_ptab_out;
+            rvc_align_in.carry = rd.rvc_carry_snapshot;
+            front_rvc_align_comb(rvc_align_in, rvc_align_out);
+            saved_fifo_out = rvc_align_out.fifo_out;
+            saved_ptab_out = rvc_align_out.ptab_out;
+#endif
             for (int i = 0; i < FETCH_WIDTH; i++) {
                 if (saved_fifo_out.pc[i] != saved_ptab_out.predict_base_pc[i]) {
                     printf("ERROR: fifo pc[%d]: %x != ptab pc[%d]: %x\n",
@@ -1805,7 +1936,8 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             memset(&invalidate_req_in, 0, sizeof(invalidate_req_in));
             invalidate_req_in.invalidate_req = true;
             invalidate_req_in.csr_status = in->csr_status;
-            icache_comb_calc(&invalidate_req_in, &icache_out);
+            icache_comb_calc(st.icache_state.get(), &invalidate_req_in,
+                             &icache_out);
 
             front_state_req.next_predecode_refetch = true;
             front_state_req.next_predecode_refetch_address = predecode_flush_address;
@@ -1815,6 +1947,22 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             front_state_req.next_predecode_refetch = false;
             front_state_req.next_predecode_refetch_address = 0;
         }
+#ifdef CONFIG_RVC
+        // 块内有跳转时 tail 不在执行路径上；predecode flush 不清 tail（不跳转时
+        // flush 目标就是 tail 的高半部），后端重定向与复位才清。
+        front_state_req.next_rvc_carry = rd.rvc_carry_snapshot;
+        if (predecode_can_run) {
+            bool block_taken = false;
+            for (int i = 0; i < FETCH_WIDTH; i++) {
+                block_taken |= checker_out.predict_dir_corrected[i];
+            }
+            front_state_req.next_rvc_carry = rvc_align_out.tail;
+            front_state_req.next_rvc_carry.valid = rvc_align_out.tail.valid && !block_taken;
+        }
+        if (global_reset || in->refetch) {
+            front_state_req.next_rvc_carry = FrontRvcCarry{};
+        }
+#endif
     }
     
     {
@@ -1853,9 +2001,9 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
             if (front2back_read_enable) {
                 front_stats.backend_deliver_cycles++;
                 front_stats.delivered_groups++;
-                if (falcon_recovery_pending) {
-                    falcon_recovery_pending = false;
-                    falcon_recovery_src = FalconRecoverySrc::NONE;
+                if (st.falcon_recovery_pending) {
+                    st.falcon_recovery_pending = false;
+                    st.falcon_recovery_src = FalconRecoverySrc::NONE;
                 }
                 for (int i = 0; i < FETCH_WIDTH; i++) {
                     if (out_ptr->inst_valid[i]) {
@@ -1939,8 +2087,8 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
 
             if (global_reset) {
                 front_stats.bubble3_reset_cycles++;
-            } else if (falcon_recovery_pending) {
-                if (falcon_recovery_src == FalconRecoverySrc::BACKEND_REFETCH) {
+            } else if (st.falcon_recovery_pending) {
+                if (st.falcon_recovery_src == FalconRecoverySrc::BACKEND_REFETCH) {
                     front_stats.bubble3_recovery_backend_refetch_cycles++;
                 } else {
                     front_stats.bubble3_recovery_frontend_flush_cycles++;
@@ -1971,43 +2119,47 @@ void front_comb_calc(const struct front_top_in &inp, const FrontReadData &rd,
         fifo_final_req = fifo_req;
         ptab_final_req = ptab_req;
         front2back_fifo_final_req = front2back_fifo_req;
-        front_deadlock_snapshot.valid = true;
-        front_deadlock_snapshot.global_reset = global_reset;
-        front_deadlock_snapshot.global_refetch = global_refetch;
-        front_deadlock_snapshot.icache_ready = icache_ready;
-        front_deadlock_snapshot.icache_ready_2 = icache_ready_2;
-        front_deadlock_snapshot.fetch_addr_read_enable_slot0 =
+        st.front_deadlock_snapshot.valid = true;
+        st.front_deadlock_snapshot.global_reset = global_reset;
+        st.front_deadlock_snapshot.global_refetch = global_refetch;
+        st.front_deadlock_snapshot.icache_ready = icache_ready;
+        st.front_deadlock_snapshot.icache_ready_2 = icache_ready_2;
+        st.front_deadlock_snapshot.fetch_addr_read_enable_slot0 =
             fetch_addr_fifo_read_enable_slot0;
-        front_deadlock_snapshot.fetch_addr_read_enable_slot1 =
+        st.front_deadlock_snapshot.fetch_addr_read_enable_slot1 =
             fetch_addr_fifo_read_enable_slot1_candidate;
-        front_deadlock_snapshot.inst_fifo_read_enable = inst_fifo_read_enable;
-        front_deadlock_snapshot.ptab_read_enable = ptab_read_enable;
-        front_deadlock_snapshot.front2back_read_enable = front2back_read_enable;
-        front_deadlock_snapshot.icache = icache_out;
-        front_deadlock_snapshot.fifo = fifo_out;
-        front_deadlock_snapshot.ptab = ptab_out;
-        front_deadlock_snapshot.front2back = front2back_fifo_out;
-        front_deadlock_snapshot.out = *out_ptr;
+        st.front_deadlock_snapshot.inst_fifo_read_enable = inst_fifo_read_enable;
+        st.front_deadlock_snapshot.ptab_read_enable = ptab_read_enable;
+        st.front_deadlock_snapshot.front2back_read_enable = front2back_read_enable;
+        st.front_deadlock_snapshot.icache = icache_out;
+        st.front_deadlock_snapshot.fifo = fifo_out;
+        st.front_deadlock_snapshot.ptab = ptab_out;
+        st.front_deadlock_snapshot.front2back = front2back_fifo_out;
+        st.front_deadlock_snapshot.out = *out_ptr;
         req.out_regs = out;
     }
 }
 
 namespace {
 
-void front_seq_read(const struct front_top_in &inp, FrontReadData &rd) {
+void front_seq_read(const FrontTopState &st, const struct front_top_in &inp,
+                    FrontReadData &rd) {
   FRONTEND_HOST_PROFILE_SCOPE(FrontSeqRead);
-  rd.predecode_refetch_snapshot = predecode_refetch;
-  rd.predecode_refetch_address_snapshot = predecode_refetch_address;
-  rd.front_sim_time_snapshot = front_sim_time;
-  rd.front_stats_snapshot = front_stats;
-  rd.fetch_addr_fifo_full_latch_snapshot = fetch_addr_fifo_full_latch;
-  rd.fetch_addr_fifo_empty_latch_snapshot = fetch_addr_fifo_empty_latch;
-  rd.fifo_full_latch_snapshot = fifo_full_latch;
-  rd.fifo_empty_latch_snapshot = fifo_empty_latch;
-  rd.ptab_full_latch_snapshot = ptab_full_latch;
-  rd.ptab_empty_latch_snapshot = ptab_empty_latch;
-  rd.front2back_fifo_full_latch_snapshot = front2back_fifo_full_latch;
-  rd.front2back_fifo_empty_latch_snapshot = front2back_fifo_empty_latch;
+  rd.predecode_refetch_snapshot = st.predecode_refetch;
+  rd.predecode_refetch_address_snapshot = st.predecode_refetch_address;
+  rd.front_sim_time_snapshot = st.front_sim_time;
+  rd.front_stats_snapshot = st.front_stats;
+  rd.fetch_addr_fifo_full_latch_snapshot = st.fetch_addr_fifo_full_latch;
+  rd.fetch_addr_fifo_empty_latch_snapshot = st.fetch_addr_fifo_empty_latch;
+  rd.fifo_full_latch_snapshot = st.fifo_full_latch;
+  rd.fifo_empty_latch_snapshot = st.fifo_empty_latch;
+  rd.ptab_full_latch_snapshot = st.ptab_full_latch;
+  rd.ptab_empty_latch_snapshot = st.ptab_empty_latch;
+  rd.front2back_fifo_full_latch_snapshot = st.front2back_fifo_full_latch;
+  rd.front2back_fifo_empty_latch_snapshot = st.front2back_fifo_empty_latch;
+#ifdef CONFIG_RVC
+  rd.rvc_carry_snapshot = st.rvc_carry;
+#endif
 
   fetch_address_FIFO_in fetch_addr_in;
   instruction_FIFO_in fifo_in;
@@ -2023,56 +2175,64 @@ void front_seq_read(const struct front_top_in &inp, FrontReadData &rd) {
   icache_inp.csr_status = inp.csr_status;
   std::memset(&icache_outp, 0, sizeof(icache_outp));
 
-  fetch_address_FIFO_seq_read(&fetch_addr_in, &rd.fetch_addr_fifo_rd_snapshot);
-  instruction_FIFO_seq_read(&fifo_in, &rd.fifo_rd_snapshot);
-  PTAB_seq_read(&ptab_in, &rd.ptab_rd_snapshot);
-  front2back_FIFO_seq_read(&front2back_in, &rd.front2back_fifo_rd_snapshot);
-  icache_seq_read(&icache_inp, &icache_outp);
+  fetch_address_FIFO_seq_read(&st.fetch_addr_fifo, &fetch_addr_in,
+                              &rd.fetch_addr_fifo_rd_snapshot);
+  instruction_FIFO_seq_read(&st.instruction_fifo, &fifo_in, &rd.fifo_rd_snapshot);
+  PTAB_seq_read(&st.ptab, &ptab_in, &rd.ptab_rd_snapshot);
+  front2back_FIFO_seq_read(&st.front2back_fifo, &front2back_in,
+                           &rd.front2back_fifo_rd_snapshot);
+  icache_seq_read(st.icache_state.get(), &icache_inp, &icache_outp);
   (void)inp;
 }
 
-void front_seq_write(const struct front_top_in &inp, const FrontUpdateRequest &req,
-                     bool reset) {
+void front_seq_write(FrontTopState &st, const struct front_top_in &inp,
+                     const FrontUpdateRequest &req, bool reset) {
   FRONTEND_HOST_PROFILE_SCOPE(FrontSeqWrite);
   (void)inp;
   (void)reset;
   if (req.bpu_seq_txn.valid) {
-    bpu_instance.bpu_seq_write(req.bpu_seq_txn.inp, req.bpu_seq_txn.req,
+    st.bpu_instance.bpu_seq_write(req.bpu_seq_txn.inp, req.bpu_seq_txn.req,
                                req.bpu_seq_txn.reset);
   }
-  fetch_address_FIFO_seq_write(&req.fetch_addr_fifo_req);
-  instruction_FIFO_seq_write(&req.fifo_req);
-  PTAB_seq_write(&req.ptab_req);
-  front2back_FIFO_seq_write(&req.front2back_fifo_req);
+  fetch_address_FIFO_seq_write(&st.fetch_addr_fifo, &req.fetch_addr_fifo_req);
+  instruction_FIFO_seq_write(&st.instruction_fifo, &req.fifo_req);
+  PTAB_seq_write(&st.ptab, &req.ptab_req);
+  front2back_FIFO_seq_write(&st.front2back_fifo, &req.front2back_fifo_req);
   predecode_checker_seq_write();
-  icache_seq_write();
+  icache_seq_write(st.icache_state.get());
 
   if (req.front_state.valid) {
-    front_sim_time = req.front_state.next_front_sim_time;
-    front_stats = req.front_state.next_front_stats;
-    predecode_refetch = req.front_state.next_predecode_refetch;
-    predecode_refetch_address = req.front_state.next_predecode_refetch_address;
-    fetch_addr_fifo_full_latch = req.front_state.next_fetch_addr_fifo_full;
-    fetch_addr_fifo_empty_latch = req.front_state.next_fetch_addr_fifo_empty;
-    fifo_full_latch = req.front_state.next_fifo_full;
-    fifo_empty_latch = req.front_state.next_fifo_empty;
-    ptab_full_latch = req.front_state.next_ptab_full;
-    ptab_empty_latch = req.front_state.next_ptab_empty;
-    front2back_fifo_full_latch = req.front_state.next_front2back_fifo_full;
-    front2back_fifo_empty_latch = req.front_state.next_front2back_fifo_empty;
+    st.front_sim_time = req.front_state.next_front_sim_time;
+    st.front_stats = req.front_state.next_front_stats;
+    st.predecode_refetch = req.front_state.next_predecode_refetch;
+    st.predecode_refetch_address = req.front_state.next_predecode_refetch_address;
+#ifdef CONFIG_RVC
+    st.rvc_carry = req.front_state.next_rvc_carry;
+#endif
+    st.fetch_addr_fifo_full_latch = req.front_state.next_fetch_addr_fifo_full;
+    st.fetch_addr_fifo_empty_latch = req.front_state.next_fetch_addr_fifo_empty;
+    st.fifo_full_latch = req.front_state.next_fifo_full;
+    st.fifo_empty_latch = req.front_state.next_fifo_empty;
+    st.ptab_full_latch = req.front_state.next_ptab_full;
+    st.ptab_empty_latch = req.front_state.next_ptab_empty;
+    st.front2back_fifo_full_latch = req.front_state.next_front2back_fifo_full;
+    st.front2back_fifo_empty_latch = req.front_state.next_front2back_fifo_empty;
   }
 }
 
 } // namespace
 
-void front_top(struct front_top_in *in, struct front_top_out *out) {
+void front_top(FrontTopState *state, struct front_top_in *in,
+               struct front_top_out *out) {
+  assert(state);
   assert(in);
   assert(out);
   FRONTEND_HOST_PROFILE_SCOPE(FrontTop);
 
   FrontReadData rd;
   FrontUpdateRequest req;
-  front_seq_read(*in, rd);
-  front_comb_calc(*in, rd, *out, req);
-  front_seq_write(*in, req, in->reset);
+  front_bound_state = state;
+  front_seq_read(*state, *in, rd);
+  front_comb_calc(*state, *in, rd, *out, req);
+  front_seq_write(*state, *in, req, in->reset);
 }
@@ -0,0 +1,85 @@
+#ifndef FRONT_TOP_STATE_H
+#define FRONT_TOP_STATE_H
+
+#include "BPU/BPU.h"
+#include "fifo/front_fifo_models.h"
+#include "front_IO.h"
+#include "train_IO.h"
+#include <cstdint>
+#include <memory>
+
+class SimContext;
+struct ICacheState;
+
+enum class FalconRecoverySrc : uint8_t {
+  NONE = 0,
+  BACKEND_REFETCH = 1,
+  FRONTEND_FLUSH = 2,
+};
+
+struct FrontDeadlockSnapshot {
+  bool valid = false;
+  bool global_reset = false;
+  bool global_refetch = false;
+  bool icache_ready = false;
+  bool icache_ready_2 = false;
+  bool fetch_addr_read_enable_slot0 = false;
+  bool fetch_addr_read_enable_slot1 = false;
+  bool inst_fifo_read_enable = false;
+  bool ptab_read_enable = false;
+  bool front2back_read_enable = false;
+  icache_out icache = {};
+  instruction_FIFO_out fifo = {};
+  PTAB_out ptab = {};
+  front2back_FIFO_out front2back = {};
+  front_top_out out = {};
+};
+
+// ============================================================================
+// front_top 的跨拍状态（寄存器锁存值 + BPU/icache 实例 + FIFO 存储 + 统计）
+//
+// 每个 FrontTop（即每个 SimCpu）持有一份，front_top() 只通过参数访问，
+// 不再使用文件级 static，多个仿真实例可以分别在各自线程里推进。
+// 析构时打印 FALCON / 前端统计报告。
+// ============================================================================
+struct FrontTopState {
+  bool predecode_refetch = false;
+  uint32_t predecode_refetch_address = 0;
+  uint32_t front_sim_time = 0;
+#ifdef CONFIG_RVC
+  FrontRvcCarry rvc_carry{};
+#endif
+
+  // FIFO 状态锁存
+  bool fetch_addr_fifo_full_latch = false;
+  bool fetch_addr_fifo_empty_latch = true;
+  bool fifo_full_latch = false;
+  bool fifo_empty_latch = true;
+  bool ptab_full_latch = false;
+  bool ptab_empty_latch = true;
+  bool front2back_fifo_full_latch = false;
+  bool front2back_fifo_empty_latch = true;
+  SimContext *front_ctx = nullptr;
+
+  FrontRuntimeStats front_stats;
+  bool falcon_window_active = false;
+  uint64_t falcon_warmup_cycles = 0;
+  bool falcon_recovery_pending = false;
+  FalconRecoverySrc falcon_recovery_src = FalconRecoverySrc::NONE;
+
+  FrontDeadlockSnapshot front_deadlock_snapshot;
+
+  BPU_TOP bpu_instance;
+  FetchAddressFifoModel fetch_addr_fifo;
+  InstructionFifoModel instruction_fifo;
+  PTABModel ptab;
+  Front2BackFifoModel front2back_fifo;
+  std::unique_ptr<ICacheState> icache_state;
+
+  FrontTopState();
+  FrontTopState(const FrontTopState &) = delete;
+  FrontTopState &operator=(const FrontTopState &) = delete;
+  ~FrontTopState();
+};
+
+#endif
@@ -14,6 +14,16 @@
 #define PMEM_OFFSET RESET_PC
 #endif
 
+// 取指槽位粒度：开启 RVC 时每个槽位对应一个半字（可能的指令起点），取指块
+// 覆盖 FETCH_WIDTH 个半字；否则每个槽位为一条 4 字节指令。
+#ifdef CONFIG_RVC
+constexpr uint32_t FETCH_SLOT_BYTES = 2;
+constexpr int FETCH_SLOT_SHIFT = 1;
+#else
+constexpr uint32_t FETCH_SLOT_BYTES = 4;
+constexpr int FETCH_SLOT_SHIFT = 2;
+#endif
+
 /* ICache model selection:
  * - default: True ICache
  * - define USE_IDEAL_ICACHE for ideal model (performance upper-bound)
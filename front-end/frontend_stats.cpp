@@ -68,8 +68,7 @@ const std::vector<TrainableIoStat> kTrainableIoStats = {
     {"BTB", "useful_next_state_comb", 4, 3},
     {"BTB", "btb_victim_select_comb", 176, 2},
 
-    {"TAGE", "tage_ghr_update_comb", 257, 256},
-    {"TAGE", "tage_fh_update_comb", 1153, 384},
+    {"TAGE", "tage_history_shift", GHR_LENGTH + 242, GHR_LENGTH + 241},
     {"TAGE", "lsfr_update_comb", 4, 12},
     {"TAGE", "tage_pred_index_comb", 416, 192},
     {"TAGE", "tage_pred_select_comb", 296, 226},
@@ -39,6 +39,7 @@ constexpr std::array<const char *, kSlotCount> kSlotNames = {
     "bpu.type_comb",
     "bpu.tage_comb_total",
     "bpu.btb_comb_total",
+    "bpu.ittage_comb_total",
     "icache.comb",
     "sim.cycle_total",
     "sim.csr_status",
@@ -28,6 +28,7 @@ enum class Slot : uint32_t {
   BpuTypeComb,
   BpuTageComb,
   BpuBtbComb,
+  BpuIttageComb,
   IcacheComb,
   SimCycle,
   SimCsrStatus,
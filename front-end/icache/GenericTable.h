@@ -53,6 +53,30 @@ struct DynamicTableWriteReq {
   std::vector<uint8_t> chunk_enable{};
 };
 
+// 零拷贝接口（仅仿真侧，不改变 RTL 端口语义）：
+// - DynamicTableRowView 直接指向表内某一行，在下一次 seq()/reset() 前有效；
+// - DynamicTableWriteView 从调用方缓冲写入 [chunk_offset, chunk_offset +
+//   chunk_count) 这一段 chunk，段外 chunk 等价于 wr_chunk_enable=0。
+// 逐拍热路径用它们代替 DynamicTablePayload，避免每拍的堆分配与整行拷贝。
+struct DynamicTableRowView {
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+};
+
+struct DynamicTableReadView {
+  bool valid = false;
+  DynamicTableRowView row{};
+};
+
+struct DynamicTableWriteView {
+  bool enable = false;
+  uint32_t address = 0;
+  uint32_t chunk_offset = 0;
+  uint32_t chunk_count = 0;
+  const uint8_t *payload = nullptr;      // chunk_count 个 chunk
+  const uint8_t *chunk_enable = nullptr; // chunk_count 项，非 0 为写使能
+};
+
 namespace generic_table_detail {
 
 inline uint32_t clamp_latency(uint32_t value) { return value < 1u ? 1u : value; }
@@ -91,6 +115,13 @@ public:
     std::memcpy(payload.data(), row_ptr(address), payload_bytes());
   }
 
+  DynamicTableRowView row_view(uint32_t address) const {
+    if (!valid_address(address)) {
+      return {};
+    }
+    return {row_ptr(address), payload_bytes()};
+  }
+
   void write_chunks(uint32_t address, const DynamicTableWriteReq &write_req) {
     if (!write_req.enable || !valid_address(address)) {
       return;
@@ -116,6 +147,28 @@ public:
     }
   }
 
+  void write_chunk_range(const DynamicTableWriteView &write_view) {
+    if (!write_view.enable || !valid_address(write_view.address)) {
+      return;
+    }
+    const uint32_t cbytes = chunk_bytes();
+    if (cbytes == 0 || write_view.chunk_offset >= config_.chunks) {
+      return;
+    }
+    const uint32_t count =
+        std::min(write_view.chunk_count, config_.chunks - write_view.chunk_offset);
+    uint8_t *dst = row_ptr(write_view.address) +
+                   static_cast<size_t>(write_view.chunk_offset) * cbytes;
+    for (uint32_t chunk = 0; chunk < count; ++chunk) {
+      if (!write_view.chunk_enable[chunk]) {
+        continue;
+      }
+      std::memcpy(dst + static_cast<size_t>(chunk) * cbytes,
+                  write_view.payload + static_cast<size_t>(chunk) * cbytes,
+                  cbytes);
+    }
+  }
+
 private:
   uint8_t *row_ptr(uint32_t address) {
     return storage_.data() + static_cast<size_t>(address) * row_bytes();
@@ -153,10 +206,19 @@ public:
     storage_.copy_row_to_payload(req.address, resp.payload);
   }
 
+  void comb_view(const DynamicTableReadReq &req, DynamicTableReadView &resp) const {
+    resp.valid = req.enable && storage_.valid_address(req.address);
+    resp.row = resp.valid ? storage_.row_view(req.address) : DynamicTableRowView{};
+  }
+
   void seq(const DynamicTableReadReq &, const DynamicTableWriteReq &write_req) {
     storage_.write_chunks(write_req.address, write_req);
   }
 
+  void seq(const DynamicTableReadReq &, const DynamicTableWriteView &write_view) {
+    storage_.write_chunk_range(write_view);
+  }
+
   bool debug_read_row(uint32_t address, DynamicTablePayload &payload) const {
     payload.reset(storage_.payload_bytes());
     if (!storage_.valid_address(address)) {
@@ -166,6 +228,10 @@ public:
     return true;
   }
 
+  DynamicTableRowView peek_row_view(uint32_t address) const {
+    return storage_.row_view(address);
+  }
+
   size_t payload_bytes() const { return storage_.payload_bytes(); }
   uint32_t row_bytes() const { return storage_.row_bytes(); }
   uint32_t chunk_bytes() const { return storage_.chunk_bytes(); }
@@ -208,22 +274,22 @@ public:
     storage_.copy_row_to_payload(pending_addr_, resp.payload);
   }
 
+  void comb_view(const DynamicTableReadReq &, DynamicTableReadView &resp) const {
+    resp.valid = pending_valid_ && delay_left_ == 0 &&
+                 storage_.valid_address(pending_addr_);
+    resp.row = resp.valid ? storage_.row_view(pending_addr_) : DynamicTableRowView{};
+  }
+
   void seq(const DynamicTableReadReq &read_req,
            const DynamicTableWriteReq &write_req) {
     storage_.write_chunks(write_req.address, write_req);
+    step_read(read_req);
+  }
 
-    if (read_req.enable && !pending_valid_ &&
-        storage_.valid_address(read_req.address)) {
-      pending_valid_ = true;
-      pending_addr_ = read_req.address;
-      delay_left_ = choose_latency() - 1u;
-    } else if (!read_req.enable && pending_valid_ && delay_left_ == 0) {
-      pending_valid_ = false;
-      pending_addr_ = 0;
-      delay_left_ = 0;
-    } else if (pending_valid_ && delay_left_ > 0) {
-      delay_left_--;
-    }
+  void seq(const DynamicTableReadReq &read_req,
+           const DynamicTableWriteView &write_view) {
+    storage_.write_chunk_range(write_view);
+    step_read(read_req);
   }
 
   bool debug_read_row(uint32_t address, DynamicTablePayload &payload) const {
@@ -235,12 +301,31 @@ public:
     return true;
   }
 
+  DynamicTableRowView peek_row_view(uint32_t address) const {
+    return storage_.row_view(address);
+  }
+
   size_t payload_bytes() const { return storage_.payload_bytes(); }
   uint32_t row_bytes() const { return storage_.row_bytes(); }
   uint32_t chunk_bytes() const { return storage_.chunk_bytes(); }
   const DynamicTableConfig &config() const { return storage_.config(); }
 
 private:
+  void step_read(const DynamicTableReadReq &read_req) {
+    if (read_req.enable && !pending_valid_ &&
+        storage_.valid_address(read_req.address)) {
+      pending_valid_ = true;
+      pending_addr_ = read_req.address;
+      delay_left_ = choose_latency() - 1u;
+    } else if (!read_req.enable && pending_valid_ && delay_left_ == 0) {
+      pending_valid_ = false;
+      pending_addr_ = 0;
+      delay_left_ = 0;
+    } else if (pending_valid_ && delay_left_ > 0) {
+      delay_left_--;
+    }
+  }
+
   uint32_t choose_latency() {
     uint32_t latency = generic_table_detail::clamp_latency(timing_.fixed_latency);
     if (timing_.random_delay) {
@@ -280,6 +365,12 @@ template <int Chunks, int ChunkBits> struct GenericTableReadResp {
   GenericTablePayload<Chunks, ChunkBits> payload{};
 };
 
+// 零拷贝读视图：payload 指向表内行存储，在下一次 seq()/reset() 前有效
+template <int Chunks, int ChunkBits> struct GenericTableReadView {
+  wire<1> valid = false;
+  const GenericTablePayload<Chunks, ChunkBits> *payload = nullptr;
+};
+
 template <int AddrBits, int Chunks, int ChunkBits> struct GenericTableWriteReq {
   wire<1> enable = false;
   wire<AddrBits> address = 0;
@@ -295,6 +386,7 @@ public:
   static constexpr int kAddrBits = (Rows <= 1) ? 1 : __builtin_ctz(Rows);
   using ReadReq = GenericTableReadReq<kAddrBits>;
   using ReadResp = GenericTableReadResp<Chunks, ChunkBits>;
+  using ReadView = GenericTableReadView<Chunks, ChunkBits>;
   using WriteReq = GenericTableWriteReq<kAddrBits, Chunks, ChunkBits>;
   using Payload = GenericTablePayload<Chunks, ChunkBits>;
 
@@ -309,12 +401,17 @@ public:
   }
 
   void comb(const ReadReq &req, ReadResp &resp) const {
-    resp = {};
-    if (!req.enable) {
-      return;
+    resp.valid = req.enable;
+    if (req.enable) {
+      resp.payload = storage_[req.address];
+    } else {
+      resp.payload = {};
     }
-    resp.valid = true;
-    resp.payload = storage_[req.address];
+  }
+
+  void comb_view(const ReadReq &req, ReadView &resp) const {
+    resp.valid = req.enable;
+    resp.payload = req.enable ? &storage_[req.address] : nullptr;
   }
 
   void seq(const ReadReq &, const WriteReq &write_req) {
@@ -341,6 +438,7 @@ public:
   static constexpr int kAddrBits = (Rows <= 1) ? 1 : __builtin_ctz(Rows);
   using ReadReq = GenericTableReadReq<kAddrBits>;
   using ReadResp = GenericTableReadResp<Chunks, ChunkBits>;
+  using ReadView = GenericTableReadView<Chunks, ChunkBits>;
   using WriteReq = GenericTableWriteReq<kAddrBits, Chunks, ChunkBits>;
   using Payload = GenericTablePayload<Chunks, ChunkBits>;
 
@@ -362,13 +460,19 @@ public:
   }
 
   void comb(const ReadReq &, ReadResp &resp) const {
-    resp = {};
-    if (pending_valid_ && delay_left_ == 0) {
-      resp.valid = true;
+    resp.valid = pending_valid_ && delay_left_ == 0;
+    if (resp.valid) {
       resp.payload = storage_[pending_addr_];
+    } else {
+      resp.payload = {};
     }
   }
 
+  void comb_view(const ReadReq &, ReadView &resp) const {
+    resp.valid = pending_valid_ && delay_left_ == 0;
+    resp.payload = resp.valid ? &storage_[pending_addr_] : nullptr;
+  }
+
   void seq(const ReadReq &read_req, const WriteReq &write_req) {
     if (write_req.enable) {
       for (int chunk = 0; chunk < Chunks; ++chunk) {
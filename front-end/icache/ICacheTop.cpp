@@ -15,6 +15,7 @@
 #include "PhysMemory.h"
 #include "config.h"
 #include "include/icache_module.h"
+#include "include/icache_state.h"
 
 #if __has_include("AXI_Interconnect_IO.h")
 #include "AXI_Interconnect_IO.h"
@@ -52,12 +53,6 @@ struct ReadMasterPort_t {
 #include <iostream>
 #include <memory>
 
-extern icache_module_n::ICache icache;
-void icache_fill_lookup_meta_input(icache_module_n::ICache_lookup_in_t &dst);
-void icache_fill_lookup_data_input(icache_module_n::ICache_lookup_in_t &dst,
-                                   bool req_valid, uint32_t req_index,
-                                   uint32_t req_way);
-
 namespace {
 
 #ifndef CONFIG_ICACHE_FOCUS_VADDR_BEGIN
@@ -77,7 +72,7 @@ inline bool icache_focus_vaddr(uint32_t v_addr) {
 inline void dump_icache_focus_line(const char *tag, uint32_t fetch_pc,
                                    const uint32_t *line_words) {
   std::printf("[ICACHE][TRACE][%s] cyc=%lld fetch_pc=0x%08x line=[", tag,
-              (long long)sim_time, fetch_pc);
+              (long long)sim_now(), fetch_pc);
   for (int i = 0; i < ICACHE_LINE_SIZE / 4; ++i) {
     std::printf("%s%08x", (i == 0) ? "" : " ", line_words[i]);
   }
@@ -127,6 +122,38 @@ void clear_perf_outputs(struct icache_out *out) {
   out->perf_itlb_retry_local_walker_busy = false;
 }
 
+#ifdef CONFIG_RVC
+uint32_t line_halfword(const uint32_t *line_words, int idx) {
+  return (line_words[idx / 2] >> ((idx & 1) * 16)) & 0xffffu;
+}
+
+// RVC: slot i is the 32-bit candidate starting at halfword i of the fetch
+// block (upper half is 0 past the end of the line). Instruction boundaries
+// are resolved by the front-end after the fetch FIFO.
+void fill_fetch_group(uint32_t fetch_pc, const uint32_t *line_words,
+                      bool page_fault, uint32_t *fetch_group,
+                      bool *page_fault_inst, bool *inst_valid) {
+  constexpr int kLineHalfwords = ICACHE_LINE_SIZE / 2;
+  uint32_t mask = ICACHE_LINE_SIZE - 1u;
+  int base_idx = static_cast<int>((fetch_pc & mask) / 2u);
+  for (int i = 0; i < FETCH_WIDTH; ++i) {
+    const int idx = base_idx + i;
+    if (idx >= kLineHalfwords) {
+      fetch_group[i] = INST_NOP;
+      page_fault_inst[i] = false;
+      inst_valid[i] = false;
+      continue;
+    }
+    uint32_t candidate = line_halfword(line_words, idx);
+    if (idx + 1 < kLineHalfwords) {
+      candidate |= line_halfword(line_words, idx + 1) << 16;
+    }
+    fetch_group[i] = page_fault ? INST_NOP : candidate;
+    page_fault_inst[i] = page_fault;
+    inst_valid[i] = true;
+  }
+}
+#else
 void fill_fetch_group(uint32_t fetch_pc, const uint32_t *line_words,
                       bool page_fault, uint32_t *fetch_group,
                       bool *page_fault_inst, bool *inst_valid) {
@@ -144,6 +171,7 @@ void fill_fetch_group(uint32_t fetch_pc, const uint32_t *line_words,
     inst_valid[i] = true;
   }
 }
+#endif
 
 class IcacheBlockingPtwPort : public PtwMemPort {
 public:
@@ -226,7 +254,7 @@ public:
           "[ICACHE][ADAPTER][VIEW] cyc=%lld req_v=%u req_addr=0x%08x "
           "req_id=%u req_ready=%u req_acc=%u acc_id=%u resp_v=%u resp_id=%u "
           "resp_ready=%u resp_w0=0x%08x resp_w7=0x%08x\n",
-          (long long)sim_time, static_cast<unsigned>(port_->req.valid),
+          (long long)sim_now(), static_cast<unsigned>(port_->req.valid),
           static_cast<unsigned>(port_->req.addr),
           static_cast<unsigned>(port_->req.id & 0xF),
           static_cast<unsigned>(port_->req.ready),
@@ -260,7 +288,7 @@ public:
           "req_id=%u resp_ready=%u port_req_ready=%u port_req_acc=%u acc_id=%u "
           "port_resp_v=%u port_resp_id=%u port_resp_w0=0x%08x "
           "port_resp_w7=0x%08x\n",
-          (long long)sim_time, static_cast<unsigned>(req_valid),
+          (long long)sim_now(), static_cast<unsigned>(req_valid),
           static_cast<unsigned>(req_addr),
           static_cast<unsigned>(req_id & 0xF),
           static_cast<unsigned>(resp_ready),
@@ -280,26 +308,17 @@ private:
   axi_interconnect::ReadMasterPort_t *port_ = nullptr;
 };
 
-template <typename ReadPort> ReadPort &read_port_runtime() {
-  static ReadPort read_port;
-  return read_port;
-}
-
 template <typename HW, typename ReadPort> struct TrueIcacheRuntime {
-  TlbMmu *mmu_model = nullptr;
+  std::unique_ptr<TlbMmu> mmu_model;
+  IcacheBlockingPtwPort blocking_ptw_port;
   PtwMemPort *ptw_mem_port = nullptr;
   PtwWalkPort *ptw_walk_port = nullptr;
   axi_interconnect::ReadMasterPort_t *mem_read_port = nullptr;
 };
 
-template <typename HW, typename ReadPort>
-TrueIcacheRuntime<HW, ReadPort> &true_icache_runtime() {
-  static TrueIcacheRuntime<HW, ReadPort> runtime;
-  return runtime;
-}
-
 struct SimpleIcacheRuntime {
-  TlbMmu *mmu_model = nullptr;
+  std::unique_ptr<TlbMmu> mmu_model;
+  IcacheBlockingPtwPort blocking_ptw_port;
   PtwMemPort *ptw_mem_port = nullptr;
   PtwWalkPort *ptw_walk_port = nullptr;
   axi_interconnect::ReadMasterPort_t *mem_read_port = nullptr;
@@ -311,20 +330,15 @@ struct SimpleIcacheRuntime {
   bool resp_fire_comb = false;
 };
 
-SimpleIcacheRuntime &simple_icache_runtime() {
-  static SimpleIcacheRuntime runtime;
-  return runtime;
-}
-
 template <typename Runtime>
 void ensure_mmu_model(Runtime &runtime, SimContext *ctx) {
-  static IcacheBlockingPtwPort ptw_port;
   if (runtime.mmu_model != nullptr || ctx == nullptr) {
     return;
   }
-  runtime.mmu_model =
-      new TlbMmu(ctx, runtime.ptw_mem_port ? runtime.ptw_mem_port : &ptw_port,
-                 ITLB_ENTRIES);
+  runtime.mmu_model = std::make_unique<TlbMmu>(
+      ctx,
+      runtime.ptw_mem_port ? runtime.ptw_mem_port : &runtime.blocking_ptw_port,
+      ITLB_ENTRIES);
   if (runtime.ptw_walk_port != nullptr) {
     runtime.mmu_model->set_ptw_walk_port(runtime.ptw_walk_port);
   }
@@ -395,14 +409,16 @@ void apply_mmu_resp_view(HW &icache_hw, const ICacheMmuRespView &resp) {
 }
 
 template <typename HW>
-void refresh_lookup_meta_input(HW &icache_hw) {
-  icache_fill_lookup_meta_input(icache_hw.io.lookup_in);
+void refresh_lookup_meta_input(HW &icache_hw,
+                               const ICacheLookupTableResp &lookup_resp) {
+  icache_fill_lookup_meta_input(lookup_resp, icache_hw.io.lookup_in);
 }
 
 template <typename HW>
-void refresh_lookup_data_input(HW &icache_hw) {
+void refresh_lookup_data_input(HW &icache_hw,
+                               const ICacheLookupTableResp &lookup_resp) {
   icache_fill_lookup_data_input(
-      icache_hw.io.lookup_in, icache_hw.io.out.lookup_data_req_valid,
+      lookup_resp, icache_hw.io.lookup_in, icache_hw.io.out.lookup_data_req_valid,
       static_cast<uint32_t>(icache_hw.io.out.lookup_data_req_index),
       static_cast<uint32_t>(icache_hw.io.out.lookup_data_req_way));
 }
@@ -410,18 +426,19 @@ void refresh_lookup_data_input(HW &icache_hw) {
 template <typename HW, typename ReadPort>
 class TrueICacheTopT : public ICacheTop {
 public:
-  explicit TrueICacheTopT(HW &hw) : icache_hw(hw) {}
+  TrueICacheTopT(HW &hw, const ICacheLookupTableResp &lookup_resp)
+      : icache_hw(hw), lookup_resp_(lookup_resp) {}
 
   void set_ptw_mem_port(PtwMemPort *port) override {
-    bind_ptw_mem_port(true_icache_runtime<HW, ReadPort>(), port);
+    bind_ptw_mem_port(runtime_, port);
   }
 
   void set_ptw_walk_port(PtwWalkPort *port) override {
-    bind_ptw_walk_port(true_icache_runtime<HW, ReadPort>(), port);
+    bind_ptw_walk_port(runtime_, port);
   }
 
   void set_mem_read_port(axi_interconnect::ReadMasterPort_t *port) override {
-    bind_mem_read_port(true_icache_runtime<HW, ReadPort>(), port);
+    bind_mem_read_port(runtime_, port);
   }
 
   void peek_ready() override {
@@ -433,8 +450,8 @@ public:
   }
 
   void dump_debug_state() const override {
-    const auto &runtime = true_icache_runtime<HW, ReadPort>();
-    auto &read_port = read_port_runtime<ReadPort>();
+    const auto &runtime = runtime_;
+    auto &read_port = read_port_;
     read_port.bind(runtime.mem_read_port);
     const MemReadView mem = read_port.comb_view();
     bool hold_for_recovery =
@@ -510,8 +527,8 @@ public:
     clear_secondary_outputs(out);
     clear_perf_outputs(out);
 
-    auto &runtime = true_icache_runtime<HW, ReadPort>();
-    auto &read_port = read_port_runtime<ReadPort>();
+    auto &runtime = runtime_;
+    auto &read_port = read_port_;
     read_port.bind(runtime.mem_read_port);
 
     if (in->reset) {
@@ -554,8 +571,16 @@ public:
     for (int i = 0; i < ICACHE_LINE_SIZE / 4; ++i) {
       icache_hw.io.in.mem_resp_data[i] = mem.resp_data[i];
     }
-
-    refresh_lookup_meta_input(icache_hw);
+    // Instruction fetch ignores MPRV: M-mode or satp.MODE=Bare fetches are
+    // untranslated, so prefetch candidates need no TLB lookup.
+    const bool fetch_bare =
+        in->csr_status->privilege == 3 || ((in->csr_status->satp >> 31) & 1u) == 0;
+    icache_hw.io.in.pf_req_valid = in->prefetch_valid;
+    icache_hw.io.in.pf_req_vaddr = in->prefetch_address;
+    icache_hw.io.in.pf_translate_bare = fetch_bare;
+    icache_hw.io.in.pf_ctx_flush = translation_context_flush;
+
+    refresh_lookup_meta_input(icache_hw, lookup_resp_);
     icache_hw.comb_lookup_meta();
 
     ICacheMmuReqView mmu_req;
@@ -569,9 +594,9 @@ public:
     itlb_translate_ret = mmu_resp.translate_result;
     apply_mmu_resp_view(icache_hw, mmu_resp);
 
-    refresh_lookup_meta_input(icache_hw);
+    refresh_lookup_meta_input(icache_hw, lookup_resp_);
     icache_hw.comb_lookup_meta();
-    refresh_lookup_data_input(icache_hw);
+    refresh_lookup_data_input(icache_hw, lookup_resp_);
     icache_hw.comb_lookup_data();
 
     read_port.comb_accept(
@@ -610,7 +635,7 @@ public:
       std::printf(
           "[ICACHE][TRACE][MEM_REQ] cyc=%lld issue=%d fire=%d req_pc_r=0x%08x "
           "lookup_pc_r=0x%08x mem_req_addr=0x%08x req_id=%u state=%u\n",
-          (long long)sim_time, static_cast<int>(mem_req_issue),
+          (long long)sim_now(), static_cast<int>(mem_req_issue),
           static_cast<int>(mem_req_fire), icache_hw.io.regs.req_pc_r,
           icache_hw.io.regs.lookup_pc_r, icache_hw.io.out.mem_req_addr,
           static_cast<unsigned>(icache_hw.io.out.mem_req_id & 0xF),
@@ -631,7 +656,7 @@ public:
         std::printf(
             "[ICACHE][TRACE][MMU] cyc=%lld req_vaddr=0x%08x ppn_valid=%d "
             "ppn=0x%05x page_fault=%d ret=%d satp=0x%08x refetch=%d\n",
-            (long long)sim_time, icache_hw.io.out.mmu_req_vtag << 12,
+            (long long)sim_now(), icache_hw.io.out.mmu_req_vtag << 12,
             static_cast<int>(icache_hw.io.in.ppn_valid),
             static_cast<unsigned>(icache_hw.io.in.ppn),
             static_cast<int>(icache_hw.io.in.page_fault),
@@ -671,7 +696,7 @@ public:
   }
 
   void seq() override {
-    auto &runtime = true_icache_runtime<HW, ReadPort>();
+    auto &runtime = runtime_;
     if (in->reset) {
       if (runtime.mmu_model != nullptr) {
         runtime.mmu_model->seq();
@@ -685,7 +710,7 @@ public:
         icache_hw.io.in.mem_resp_valid && icache_hw.io.out.mem_resp_ready;
 
     icache_hw.seq();
-    read_port_runtime<ReadPort>().seq(
+    read_port_.seq(
         mem_req_issue, icache_hw.io.out.mem_req_addr,
         static_cast<uint8_t>(icache_hw.io.out.mem_req_id & 0xF), mem_resp_fire,
         static_cast<uint8_t>(icache_hw.io.in.mem_resp_id & 0xF), in->refetch);
@@ -712,12 +737,16 @@ private:
   }
 
   HW &icache_hw;
+  const ICacheLookupTableResp &lookup_resp_;
+  TrueIcacheRuntime<HW, ReadPort> runtime_;
+  // dump_debug_state() 也需要经读口适配器观察端口
+  mutable ReadPort read_port_;
 };
 
 class SimpleICacheTop : public ICacheTop {
 public:
   void dump_debug_state() const override {
-    const auto &runtime = simple_icache_runtime();
+    const auto &runtime = runtime_;
     std::printf(
         "[DEADLOCK][FRONT][ICACHE_HW] type=simple pending_req_valid=%d "
         "pending_fetch_addr=0x%08x pend_on_retry=%d resp_fire=%d satp_seen=%d "
@@ -736,7 +765,7 @@ public:
     clear_perf_outputs(out);
     out->icache_read_ready_2 = false;
     out->icache_read_complete_2 = false;
-    const auto &runtime = simple_icache_runtime();
+    const auto &runtime = runtime_;
     out->icache_read_ready =
         in->reset || in->refetch || in->invalidate_req || in->fence_i ||
         !runtime.pending_req_valid;
@@ -744,7 +773,7 @@ public:
   }
 
   void comb() override {
-    auto &runtime = simple_icache_runtime();
+    auto &runtime = runtime_;
     clear_perf_outputs(out);
     out->icache_read_ready_2 = false;
     out->icache_read_complete_2 = false;
@@ -830,7 +859,7 @@ public:
     out->fetch_pc = fetch_addr;
     out->icache_read_complete = true;
     for (int i = 0; i < FETCH_WIDTH; i++) {
-      uint32_t v_addr = fetch_addr + (i * 4);
+      uint32_t v_addr = fetch_addr + (i * FETCH_SLOT_BYTES);
       uint32_t p_addr = 0;
 
       if (v_addr / ICACHE_LINE_SIZE != (fetch_addr) / ICACHE_LINE_SIZE) {
@@ -901,7 +930,12 @@ public:
 
       out->page_fault_inst[i] = false;
       out->perf_itlb_hit = true;
+#ifdef CONFIG_RVC
+      out->fetch_group[i] =
+          (pmem_read(p_addr & ~0x3u) >> ((p_addr & 0x2u) * 8)) & 0xffffu;
+#else
       out->fetch_group[i] = pmem_read(p_addr);
+#endif
 
       if (DEBUG_PRINT) {
         uint32_t satp =
@@ -914,6 +948,14 @@ public:
                v_addr, p_addr, out->fetch_group[i], satp, privilege);
       }
     }
+#ifdef CONFIG_RVC
+    // Same slot layout as fill_fetch_group: candidate = halfword i | i+1.
+    for (int i = 0; i + 1 < FETCH_WIDTH; i++) {
+      if (out->inst_valid[i + 1] && !out->page_fault_inst[i + 1]) {
+        out->fetch_group[i] |= out->fetch_group[i + 1] << 16;
+      }
+    }
+#endif
 
     if (out->icache_read_complete) {
       runtime.resp_fire_comb = true;
@@ -927,11 +969,11 @@ public:
   }
 
   void set_ptw_mem_port(PtwMemPort *port) override {
-    bind_ptw_mem_port(simple_icache_runtime(), port);
+    bind_ptw_mem_port(runtime_, port);
   }
 
   void set_ptw_walk_port(PtwWalkPort *port) override {
-    bind_ptw_walk_port(simple_icache_runtime(), port);
+    bind_ptw_walk_port(runtime_, port);
   }
 
   void set_mem_read_port(axi_interconnect::ReadMasterPort_t *port) override {
@@ -939,7 +981,7 @@ public:
   }
 
   void seq() override {
-    auto &runtime = simple_icache_runtime();
+    auto &runtime = runtime_;
     if (in->reset) {
       runtime.pending_req_valid = false;
       runtime.pending_fetch_addr = 0;
@@ -975,27 +1017,23 @@ public:
       runtime.mmu_model->seq();
     }
   }
+
+private:
+  SimpleIcacheRuntime runtime_;
 };
 
 } // namespace
 
-ICacheTop *get_icache_instance() {
-  static std::unique_ptr<ICacheTop> instance = nullptr;
-  if (!instance) {
+std::unique_ptr<ICacheTop>
+make_icache_top(icache_module_n::ICache &hw,
+                const ICacheLookupTableResp &lookup_resp) {
 #ifdef USE_IDEAL_ICACHE
-    instance = std::make_unique<SimpleICacheTop>();
+  (void)hw;
+  (void)lookup_resp;
+  return std::make_unique<SimpleICacheTop>();
 #else
-    instance = std::make_unique<
-        TrueICacheTopT<icache_module_n::ICache, ExternalReadPortAdapter>>(icache);
+  return std::make_unique<
+      TrueICacheTopT<icache_module_n::ICache, ExternalReadPortAdapter>>(
+      hw, lookup_resp);
 #endif
-  }
-  return instance.get();
-}
-
-void icache_dump_debug_state() {
-  if (auto *instance = get_icache_instance(); instance != nullptr) {
-    instance->dump_debug_state();
-  } else {
-    std::printf("[DEADLOCK][FRONT][ICACHE_HW] no icache instance\n");
-  }
 }
@@ -3,6 +3,7 @@
 #include "include/ICacheTop.h"
 #include "host_profile.h"
 #include "include/icache_module.h"
+#include "include/icache_state.h"
 #include "GenericTable.h"
 #include <cassert>
 
@@ -15,37 +16,14 @@
 #endif
 
 // icache.cpp is the front-end wrapper/orchestrator:
-// - own the external tables used by icache_module
+// - own the external tables used by icache_module (per ICacheState)
 // - bind the selected ICacheTop glue object into front_top
 // - drive per-cycle seq/perf handoff after the combinational glue is evaluated
 
-// Define global ICache instance
-icache_module_n::ICache icache;
-PtwMemPort *icache_ptw_mem_port = nullptr;
-PtwWalkPort *icache_ptw_walk_port = nullptr;
-axi_interconnect::ReadMasterPort_t *icache_mem_read_port = nullptr;
-static SimContext *icache_ctx = nullptr;
-
 namespace {
-using LookupTimingPolicy =
-#if ICACHE_LOOKUP_LATENCY == 0
-    RegfileTablePolicy;
-#else
-    SramTablePolicy;
-#endif
-
-constexpr int kSetAddrBits = icache_module_n::ICACHE_V1_INDEX_BITS;
-constexpr int kRows = icache_module_n::ICACHE_V1_SET_NUM;
-constexpr int kDataChunks = ICACHE_V1_WAYS;
-constexpr int kDataChunkBits = ICACHE_LINE_SIZE * 8;
-constexpr int kTagChunks = ICACHE_V1_WAYS;
-constexpr int kTagChunkBits = icache_module_n::ICACHE_V1_TAG_BITS;
-constexpr int kValidChunks = ICACHE_V1_WAYS;
-constexpr int kValidChunkBits = 1;
-
-using DataTable = GenericTable<kRows, kDataChunks, kDataChunkBits, LookupTimingPolicy>;
-using TagTable = GenericTable<kRows, kTagChunks, kTagChunkBits, LookupTimingPolicy>;
-using ValidTable = GenericTable<kRows, kValidChunks, kValidChunkBits, LookupTimingPolicy>;
+using DataTable = ICacheState::DataTable;
+using TagTable = ICacheState::TagTable;
+using ValidTable = ICacheState::ValidTable;
 
 GenericTableTimingConfig make_lookup_timing_config() {
   GenericTableTimingConfig cfg;
@@ -96,28 +74,25 @@ void dump_focus_row(const char *tag, const DataTableT &data_table,
   }
 }
 
-void bind_icache_runtime(ICacheTop *instance) {
-  static PtwMemPort *bound_mem_port = nullptr;
-  static PtwWalkPort *bound_walk_port = nullptr;
-  static axi_interconnect::ReadMasterPort_t *bound_read_port = nullptr;
-  static SimContext *bound_ctx = nullptr;
-
-  if (bound_mem_port != icache_ptw_mem_port) {
-    instance->set_ptw_mem_port(icache_ptw_mem_port);
-    bound_mem_port = icache_ptw_mem_port;
+ICacheTop *bind_icache_runtime(ICacheState &ic) {
+  ICacheTop *instance = ic.top.get();
+  if (ic.bound_mem_port != ic.ptw_mem_port) {
+    instance->set_ptw_mem_port(ic.ptw_mem_port);
+    ic.bound_mem_port = ic.ptw_mem_port;
   }
-  if (bound_walk_port != icache_ptw_walk_port) {
-    instance->set_ptw_walk_port(icache_ptw_walk_port);
-    bound_walk_port = icache_ptw_walk_port;
+  if (ic.bound_walk_port != ic.ptw_walk_port) {
+    instance->set_ptw_walk_port(ic.ptw_walk_port);
+    ic.bound_walk_port = ic.ptw_walk_port;
   }
-  if (bound_read_port != icache_mem_read_port) {
-    instance->set_mem_read_port(icache_mem_read_port);
-    bound_read_port = icache_mem_read_port;
+  if (ic.bound_read_port != ic.mem_read_port) {
+    instance->set_mem_read_port(ic.mem_read_port);
+    ic.bound_read_port = ic.mem_read_port;
   }
-  if (bound_ctx != icache_ctx) {
-    instance->setContext(icache_ctx);
-    bound_ctx = icache_ctx;
+  if (ic.bound_ctx != ic.ctx) {
+    instance->setContext(ic.ctx);
+    ic.bound_ctx = ic.ctx;
   }
+  return instance;
 }
 
 void dump_focus_read_row(const DataTable &data_table, const TagTable &tag_table,
@@ -134,37 +109,59 @@ void dump_focus_read_row(const DataTable &data_table, const TagTable &tag_table,
   dump_focus_row("READ", data_table, tag_table, valid_table, lookup_index);
 }
 
-struct ICacheLookupTableResp {
-  bool meta_resp_valid = false;
-  bool data_snapshot_valid = false;
-  uint32_t lookup_index = 0;
-  uint32_t set_way_line_snapshot[ICACHE_V1_WAYS][icache_module_n::ICACHE_V1_WORD_NUM] = {{0}};
-  uint32_t set_tag_snapshot[ICACHE_V1_WAYS] = {0};
-  bool set_valid_snapshot[ICACHE_V1_WAYS] = {false};
-};
-
-ICacheLookupTableResp g_lookup_table_resp;
-
-void cache_lookup_table_resp(const DataTable::ReadResp &data_resp,
-                             const TagTable::ReadResp &tag_resp,
-                             const ValidTable::ReadResp &valid_resp,
+// 读视图直接指向表存储，此处是每拍唯一的一次行拷贝
+void cache_lookup_table_resp(ICacheLookupTableResp &resp,
+                             const DataTable::ReadView &data_resp,
+                             const TagTable::ReadView &tag_resp,
+                             const ValidTable::ReadView &valid_resp,
                              uint32_t lookup_index) {
-  g_lookup_table_resp = {};
-  g_lookup_table_resp.meta_resp_valid = tag_resp.valid && valid_resp.valid;
-  g_lookup_table_resp.data_snapshot_valid = data_resp.valid;
-  g_lookup_table_resp.lookup_index = lookup_index;
+  resp = {};
+  resp.meta_resp_valid = tag_resp.valid && valid_resp.valid;
+  resp.data_snapshot_valid = data_resp.valid;
+  resp.lookup_index = lookup_index;
   for (uint32_t way = 0; way < ICACHE_V1_WAYS; ++way) {
-    g_lookup_table_resp.set_tag_snapshot[way] = tag_resp.payload.chunks[way][0];
-    g_lookup_table_resp.set_valid_snapshot[way] = valid_resp.payload.chunks[way][0];
-    for (uint32_t word = 0; word < icache_module_n::ICACHE_V1_WORD_NUM; ++word) {
-      g_lookup_table_resp.set_way_line_snapshot[way][word] =
-          data_resp.payload.chunks[way][word];
+    if (tag_resp.payload != nullptr) {
+      resp.set_tag_snapshot[way] = tag_resp.payload->chunks[way][0];
+    }
+    if (valid_resp.payload != nullptr) {
+      resp.set_valid_snapshot[way] =
+          valid_resp.payload->chunks[way][0];
+    }
+    if (data_resp.payload != nullptr) {
+      for (uint32_t word = 0; word < icache_module_n::ICACHE_V1_WORD_NUM; ++word) {
+        resp.set_way_line_snapshot[way][word] =
+            data_resp.payload->chunks[way][word];
+      }
     }
   }
 }
 
-void update_icache_perf_counters(const struct icache_in *in,
+// 预取探测只读 tag/valid，不占用查找读口
+void cache_prefetch_probe_resp(ICacheLookupTableResp &resp,
+                               const icache_module_n::ICache &icache,
+                               const TagTable &tag_table,
+                               const ValidTable &valid_table) {
+  if (icache_module_n::ICACHE_PF_MSHR_NUM == 0 || icache.io.regs.pf_q_count_r == 0) {
+    return;
+  }
+  const uint32_t vaddr = icache.io.regs.pf_q_vaddr_r[icache.io.regs.pf_q_head_r];
+  const uint32_t index = (vaddr >> icache_module_n::ICACHE_V1_OFFSET_BITS) &
+                         (icache_module_n::ICACHE_V1_SET_NUM - 1u);
+  const auto &tag_payload = tag_table.peek_row(index);
+  const auto &valid_payload = valid_table.peek_row(index);
+  resp.pf_probe_valid = true;
+  resp.pf_probe_index = index;
+  for (uint32_t way = 0; way < ICACHE_V1_WAYS; ++way) {
+    resp.pf_probe_set_tag[way] = tag_payload.chunks[way][0];
+    resp.pf_probe_set_valid[way] = valid_payload.chunks[way][0];
+  }
+}
+
+void update_icache_perf_counters(const ICacheState &ic,
+                                 const struct icache_in *in,
                                  const struct icache_out *out) {
+  SimContext *icache_ctx = ic.ctx;
+  const icache_module_n::ICache &icache = ic.hw;
   if (icache_ctx == nullptr || in == nullptr || out == nullptr) {
     return;
   }
@@ -187,23 +184,37 @@ void update_icache_perf_counters(const struct icache_in *in,
     icache_ctx->perf.icache_axi_read_samples++;
   }
 #endif
+  icache_ctx->perf.icache_prefetch_issue += icache.perf.pf_issue_valid;
+  icache_ctx->perf.icache_prefetch_useful += icache.perf.pf_useful_valid;
+  icache_ctx->perf.icache_prefetch_late += icache.perf.pf_late_valid;
+  icache_ctx->perf.icache_prefetch_filtered += icache.perf.pf_filtered_valid;
+  icache_ctx->perf.icache_prefetch_dropped += icache.perf.pf_dropped_valid;
+  icache_ctx->perf.icache_prefetch_useless += icache.perf.pf_useless_num;
 }
 } // namespace
 
-void icache_fill_lookup_meta_input(icache_module_n::ICache_lookup_in_t &dst) {
+void icache_fill_lookup_meta_input(const ICacheLookupTableResp &resp,
+                                   icache_module_n::ICache_lookup_in_t &dst) {
   dst = {};
-  dst.meta_resp_valid = g_lookup_table_resp.meta_resp_valid;
-  if (!g_lookup_table_resp.meta_resp_valid) {
+  dst.pf_probe_valid = resp.pf_probe_valid;
+  dst.pf_probe_index = resp.pf_probe_index;
+  for (uint32_t way = 0; way < ICACHE_V1_WAYS; ++way) {
+    dst.pf_probe_set_tag[way] = resp.pf_probe_set_tag[way];
+    dst.pf_probe_set_valid[way] = resp.pf_probe_set_valid[way];
+  }
+  dst.meta_resp_valid = resp.meta_resp_valid;
+  if (!resp.meta_resp_valid) {
     return;
   }
 
   for (uint32_t way = 0; way < ICACHE_V1_WAYS; ++way) {
-    dst.lookup_set_tag[way] = g_lookup_table_resp.set_tag_snapshot[way];
-    dst.lookup_set_valid[way] = g_lookup_table_resp.set_valid_snapshot[way];
+    dst.lookup_set_tag[way] = resp.set_tag_snapshot[way];
+    dst.lookup_set_valid[way] = resp.set_valid_snapshot[way];
   }
 }
 
-void icache_fill_lookup_data_input(icache_module_n::ICache_lookup_in_t &dst,
+void icache_fill_lookup_data_input(const ICacheLookupTableResp &resp,
+                                   icache_module_n::ICache_lookup_in_t &dst,
                                    bool req_valid, uint32_t req_index,
                                    uint32_t req_way) {
   dst.data_resp_valid = false;
@@ -211,8 +222,8 @@ void icache_fill_lookup_data_input(icache_module_n::ICache_lookup_in_t &dst,
   for (uint32_t word = 0; word < icache_module_n::ICACHE_V1_WORD_NUM; ++word) {
     dst.data_resp_line[word] = 0;
   }
-  if (!req_valid || !g_lookup_table_resp.data_snapshot_valid ||
-      g_lookup_table_resp.lookup_index != req_index ||
+  if (!req_valid || !resp.data_snapshot_valid ||
+      resp.lookup_index != req_index ||
       req_way >= ICACHE_V1_WAYS) {
     return;
   }
@@ -221,41 +232,53 @@ void icache_fill_lookup_data_input(icache_module_n::ICache_lookup_in_t &dst,
   dst.data_resp_way = static_cast<uint8_t>(req_way);
   for (uint32_t word = 0; word < icache_module_n::ICACHE_V1_WORD_NUM; ++word) {
     dst.data_resp_line[word] =
-        g_lookup_table_resp.set_way_line_snapshot[req_way][word];
+        resp.set_way_line_snapshot[req_way][word];
   }
 }
 
-void icache_seq_read(struct icache_in *in, struct icache_out *out) {
+ICacheState::ICacheState()
+    : data_table(make_lookup_timing_config()),
+      tag_table(make_lookup_timing_config()),
+      valid_table(make_lookup_timing_config()),
+      top(make_icache_top(hw, lookup_resp)) {}
+
+void icache_seq_read(ICacheState *ic, struct icache_in *in,
+                     struct icache_out *out) {
+  assert(ic != nullptr);
   assert(in != nullptr);
   assert(out != nullptr);
   (void)in;
   (void)out;
 }
 
-void icache_peek_ready(struct icache_in *in, struct icache_out *out) {
+void icache_peek_ready(ICacheState *ic, struct icache_in *in,
+                       struct icache_out *out) {
+  assert(ic != nullptr);
   assert(in != nullptr);
   assert(out != nullptr);
   if (!in->reset) {
     assert(in->csr_status != nullptr &&
            "icache_peek_ready requires csr_status when not in reset");
   }
-  ICacheTop *instance = get_icache_instance();
-  bind_icache_runtime(instance);
+  ICacheTop *instance = bind_icache_runtime(*ic);
   instance->setIO(in, out);
   instance->peek_ready();
 }
 
-void icache_comb_calc(struct icache_in *in, struct icache_out *out) {
+void icache_comb_calc(ICacheState *ic, struct icache_in *in,
+                      struct icache_out *out) {
   FRONTEND_HOST_PROFILE_SCOPE(IcacheComb);
+  assert(ic != nullptr);
   assert(in != nullptr);
   assert(out != nullptr);
   if (!in->reset) {
     assert(in->csr_status != nullptr &&
            "icache_comb_calc requires csr_status when not in reset");
   }
-  static DataTable data_table(make_lookup_timing_config());
-  static TagTable tag_table(make_lookup_timing_config());
-  static ValidTable valid_table(make_lookup_timing_config());
+  icache_module_n::ICache &icache = ic->hw;
+  DataTable &data_table = ic->data_table;
+  TagTable &tag_table = ic->tag_table;
+  ValidTable &valid_table = ic->valid_table;
   if (in->reset) {
     data_table.reset();
     tag_table.reset();
@@ -263,8 +286,7 @@ void icache_comb_calc(struct icache_in *in, struct icache_out *out) {
     dump_focus_row("RESET", data_table, tag_table, valid_table,
                    icache_focus_index());
   }
-  ICacheTop *instance = get_icache_instance();
-  bind_icache_runtime(instance);
+  ICacheTop *instance = bind_icache_runtime(*ic);
   instance->setIO(in, out);
 
   uint32_t lookup_pc = in->fetch_address;
@@ -291,18 +313,20 @@ void icache_comb_calc(struct icache_in *in, struct icache_out *out) {
   tag_read.address = lookup_index;
   valid_read.address = lookup_index;
 
-  DataTable::ReadResp data_resp{};
-  TagTable::ReadResp tag_resp{};
-  ValidTable::ReadResp valid_resp{};
-  data_table.comb(data_read, data_resp);
-  tag_table.comb(tag_read, tag_resp);
-  valid_table.comb(valid_read, valid_resp);
+  DataTable::ReadView data_resp{};
+  TagTable::ReadView tag_resp{};
+  ValidTable::ReadView valid_resp{};
+  data_table.comb_view(data_read, data_resp);
+  tag_table.comb_view(tag_read, tag_resp);
+  valid_table.comb_view(valid_read, valid_resp);
   dump_focus_read_row(data_table, tag_table, valid_table, lookup_pc,
                       lookup_index,
                       data_resp.valid && tag_resp.valid && valid_resp.valid);
-  cache_lookup_table_resp(data_resp, tag_resp, valid_resp, lookup_index);
+  cache_lookup_table_resp(ic->lookup_resp, data_resp, tag_resp, valid_resp,
+                          lookup_index);
+  cache_prefetch_probe_resp(ic->lookup_resp, icache, tag_table, valid_table);
   instance->comb();
-  update_icache_perf_counters(in, out);
+  update_icache_perf_counters(*ic, in, out);
   instance->seq();
   data_read.enable = icache.io.regs.lookup_pending_r;
   tag_read.enable = data_read.enable;
@@ -347,29 +371,28 @@ void icache_comb_calc(struct icache_in *in, struct icache_out *out) {
   }
 }
 
-void icache_seq_write() {}
-
-void icache_top(struct icache_in *in, struct icache_out *out) {
-  icache_seq_read(in, out);
-  icache_comb_calc(in, out);
-  icache_seq_write();
-}
-
-void icache_set_context(SimContext *ctx) {
-  icache_ctx = ctx;
-}
+void icache_seq_write(ICacheState *ic) { (void)ic; }
 
-void icache_set_ptw_mem_port(PtwMemPort *port) {
-  ICacheTop *instance = get_icache_instance();
-  instance->set_ptw_mem_port(port);
+void icache_top(ICacheState *ic, struct icache_in *in, struct icache_out *out) {
+  icache_seq_read(ic, in, out);
+  icache_comb_calc(ic, in, out);
+  icache_seq_write(ic);
 }
 
-void icache_set_ptw_walk_port(PtwWalkPort *port) {
-  ICacheTop *instance = get_icache_instance();
-  instance->set_ptw_walk_port(port);
+void icache_set_ports(ICacheState *ic, SimContext *ctx,
+                      PtwMemPort *ptw_mem_port, PtwWalkPort *ptw_walk_port,
+                      axi_interconnect::ReadMasterPort_t *mem_read_port) {
+  assert(ic != nullptr);
+  ic->ctx = ctx;
+  ic->ptw_mem_port = ptw_mem_port;
+  ic->ptw_walk_port = ptw_walk_port;
+  ic->mem_read_port = mem_read_port;
 }
 
-void icache_set_mem_read_port(axi_interconnect::ReadMasterPort_t *port) {
-  ICacheTop *instance = get_icache_instance();
-  instance->set_mem_read_port(port);
+void icache_dump_debug_state(const ICacheState *ic) {
+  if (ic != nullptr && ic->top != nullptr) {
+    ic->top->dump_debug_state();
+  } else {
+    std::printf("[DEADLOCK][FRONT][ICACHE_HW] no icache instance\n");
+  }
 }
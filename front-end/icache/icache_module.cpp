@@ -124,7 +124,7 @@ inline bool icache_req_slot_idle(const ICache_regs_t &regs) {
 }
 
 inline int alloc_free_txid(const ICache_regs_t &regs) {
-  for (int id = 0; id < 16; ++id) {
+  for (int id = 0; id < static_cast<int>(ICACHE_DEMAND_TXID_NUM); ++id) {
     if (!regs.txid_inflight_r[id]) {
       return id;
     }
@@ -201,6 +201,30 @@ void ICache::reset() {
   lookup_pc_next = 0;
   sram_load_fire = false;
 
+  for (uint32_t i = 0; i < ICACHE_PF_QUEUE_DEPTH; ++i) {
+    io.regs.pf_q_vaddr_r[i] = 0;
+  }
+  io.regs.pf_q_head_r = 0;
+  io.regs.pf_q_count_r = 0;
+  io.regs.pf_last_valid_r = false;
+  io.regs.pf_last_line_r = 0;
+  for (uint32_t i = 0; i < ICACHE_PF_MSHR_SLOTS; ++i) {
+    io.regs.pf_mshr_valid_r[i] = false;
+    io.regs.pf_mshr_sent_r[i] = false;
+    io.regs.pf_mshr_ppn_r[i] = 0;
+    io.regs.pf_mshr_index_r[i] = 0;
+  }
+  io.regs.pf_req_busy_r = false;
+  io.regs.pf_req_slot_r = 0;
+  io.regs.pf_gap_r = 0;
+  io.regs.pf_tlb_valid_r = false;
+  io.regs.pf_tlb_vpn_r = 0;
+  io.regs.pf_tlb_ppn_r = 0;
+  for (uint32_t set = 0; set < set_num; ++set) {
+    for (uint32_t way = 0; way < way_cnt; ++way) {
+      pf_line_[set][way] = false;
+    }
+  }
 }
 
 void ICache::comb() {
@@ -224,6 +248,15 @@ void ICache::comb_core(bool allow_lookup_data_phase) {
   io.table_write = {};
   fast_bypass_fire = false;
   fast_bypass_from_pending = false;
+  pf_line_hit_w = false;
+  pf_line_write_w = false;
+  pf_line_clear_all_w = false;
+  perf.pf_issue_valid = false;
+  perf.pf_useful_valid = false;
+  perf.pf_late_valid = false;
+  perf.pf_filtered_valid = false;
+  perf.pf_dropped_valid = false;
+  perf.pf_useless_num = 0;
   io.out.ifu_req_ready = io.regs.ifu_req_ready_r;
   io.out.ifu_resp_pc = io.regs.req_pc_r;
   io.out.mem_req_id = io.regs.miss_txid_valid_r ? io.regs.miss_txid_r : 0;
@@ -246,6 +279,7 @@ void ICache::comb_core(bool allow_lookup_data_phase) {
   //    context and current memory/MMU inputs
   // 2) request side updates next request/lookup state
   eval_state_machine();
+  comb_prefetch();
   uint32_t index = (io.in.pc >> offset_bits) & (set_num - 1u);
   lookup(index);
   io.out.ifu_req_ready = req_ready_w;
@@ -302,6 +336,250 @@ void ICache::capture_lookup_data_result() {
 void ICache::seq() {
   io.regs = io.reg_write;
   perf_state = perf_state_next;
+  if (pf_line_clear_all_w) {
+    for (uint32_t set = 0; set < set_num; ++set) {
+      for (uint32_t way = 0; way < way_cnt; ++way) {
+        pf_line_[set][way] = false;
+      }
+    }
+  }
+  if (pf_line_hit_w) {
+    pf_line_[pf_line_hit_index_w][pf_line_hit_way_w] = false;
+  }
+  if (pf_line_write_w) {
+    pf_line_[io.table_write.index][io.table_write.way] = pf_line_write_set_w;
+  }
+}
+
+bool ICache::prefetch_line_busy(uint32_t ppn, uint32_t index) const {
+  for (uint32_t i = 0; i < ICACHE_PF_MSHR_NUM; ++i) {
+    const bool valid = io.regs.pf_mshr_valid_r[i] || io.reg_write.pf_mshr_valid_r[i];
+    if (valid && io.reg_write.pf_mshr_ppn_r[i] == ppn &&
+        io.reg_write.pf_mshr_index_r[i] == index) {
+      return true;
+    }
+  }
+  // The demand refill in flight (or latched this cycle) owns its line.
+  if (io.regs.miss_txid_valid_r && io.regs.ppn_r == ppn &&
+      io.regs.req_index_r == index) {
+    return true;
+  }
+  return io.reg_write.miss_txid_valid_r && io.reg_write.ppn_r == ppn &&
+         io.regs.req_index_r == index;
+}
+
+// Prefetch MSHR whose refill is on the response port this cycle, or -1.
+int ICache::prefetch_resp_slot() const {
+  const uint8_t resp_id = static_cast<uint8_t>(io.in.mem_resp_id & 0xF);
+  if (!io.in.mem_resp_valid || resp_id < ICACHE_DEMAND_TXID_NUM ||
+      resp_id >= ICACHE_DEMAND_TXID_NUM + ICACHE_PF_MSHR_NUM ||
+      !io.regs.txid_inflight_r[resp_id] || io.regs.txid_canceled_r[resp_id]) {
+    return -1;
+  }
+  const uint32_t slot = resp_id - ICACHE_DEMAND_TXID_NUM;
+  if (!io.regs.pf_mshr_valid_r[slot] || !io.regs.pf_mshr_sent_r[slot]) {
+    return -1;
+  }
+  return static_cast<int>(slot);
+}
+
+void ICache::note_table_write(bool from_prefetch) {
+  const uint32_t index = io.table_write.index;
+  const uint32_t way = io.table_write.way;
+  if (pf_line_[index][way]) {
+    perf.pf_useless_num = perf.pf_useless_num + 1;
+  }
+  pf_line_write_w = true;
+  pf_line_write_set_w = from_prefetch;
+}
+
+void ICache::comb_prefetch() {
+  if (ICACHE_PF_MSHR_NUM == 0) {
+    return;
+  }
+  const bool flush = io.in.flush;
+  const bool kill = io.in.refetch;
+
+  // Translation for candidates: identity when bare, otherwise reuse the last
+  // demand translation for same-page lines.
+  if (io.in.pf_ctx_flush) {
+    io.reg_write.pf_tlb_valid_r = false;
+  } else if (io.in.ppn_valid && !io.in.page_fault) {
+    io.reg_write.pf_tlb_valid_r = true;
+    io.reg_write.pf_tlb_vpn_r = io.out.mmu_req_vtag;
+    io.reg_write.pf_tlb_ppn_r = io.in.ppn;
+  }
+
+  // 1) Prefetch response: fill a round-robin victim. A demand fill never
+  //    lands in the same cycle since the port returns one response per cycle.
+  //    A demand miss on this line holds for the cycle instead of adopting.
+  const int resp_slot = prefetch_resp_slot();
+  if (resp_slot >= 0) {
+    const uint32_t slot = static_cast<uint32_t>(resp_slot);
+    io.out.mem_resp_ready = true;
+    io.reg_write.txid_inflight_r[ICACHE_DEMAND_TXID_NUM + slot] = false;
+    io.reg_write.pf_mshr_valid_r[slot] = false;
+    io.reg_write.pf_mshr_sent_r[slot] = false;
+    if (!flush && !io.table_write.we) {
+      const uint32_t victim = (io.regs.replace_idx + 1) % way_cnt;
+      io.reg_write.replace_idx = victim;
+      io.table_write.we = true;
+      io.table_write.index = io.regs.pf_mshr_index_r[slot];
+      io.table_write.way = victim;
+      for (uint32_t word = 0; word < word_num; ++word) {
+        io.table_write.data[word] = io.in.mem_resp_data[word];
+      }
+      io.table_write.tag = io.regs.pf_mshr_ppn_r[slot];
+      io.table_write.valid = true;
+      note_table_write(/*from_prefetch=*/true);
+    }
+  }
+
+  // 2) fence.i: pending prefetches are dropped, in-flight ones are drained
+  //    through the canceled-txid path like a killed demand miss. A request
+  //    still being offered keeps its slot until accepted, then drains too.
+  if (flush) {
+    for (uint32_t i = 0; i < ICACHE_PF_MSHR_NUM; ++i) {
+      const bool offered = io.regs.pf_req_busy_r && io.regs.pf_req_slot_r == i;
+      if ((io.reg_write.pf_mshr_valid_r[i] && io.reg_write.pf_mshr_sent_r[i]) ||
+          offered) {
+        io.reg_write.txid_canceled_r[ICACHE_DEMAND_TXID_NUM + i] = true;
+      }
+      io.reg_write.pf_mshr_valid_r[i] = false;
+      io.reg_write.pf_mshr_sent_r[i] = false;
+    }
+    for (uint32_t set = 0; set < set_num; ++set) {
+      for (uint32_t way = 0; way < way_cnt; ++way) {
+        if (pf_line_[set][way]) {
+          perf.pf_useless_num = perf.pf_useless_num + 1;
+        }
+      }
+    }
+    pf_line_clear_all_w = true;
+  }
+
+  // 3) Candidate queue head: probe tags and move a missing line into a free
+  //    prefetch MSHR. Redirects drop queued candidates (stale path) but keep
+  //    prefetches already in flight.
+  uint32_t head = io.regs.pf_q_head_r;
+  uint32_t count = io.regs.pf_q_count_r;
+  bool last_valid = io.regs.pf_last_valid_r;
+  if (kill || flush) {
+    count = 0;
+    last_valid = false;
+  } else if (count > 0) {
+    const uint32_t vaddr = io.regs.pf_q_vaddr_r[head];
+    const uint32_t index = (vaddr >> offset_bits) & (set_num - 1u);
+    const uint32_t vpn = vaddr >> 12;
+    bool translated = true;
+    uint32_t ppn = vpn;
+    if (!io.in.pf_translate_bare) {
+      translated = io.regs.pf_tlb_valid_r && io.regs.pf_tlb_vpn_r == vpn;
+      ppn = io.regs.pf_tlb_ppn_r;
+    }
+    bool pop = false;
+    if (!translated) {
+      perf.pf_dropped_valid = true;
+      pop = true;
+    } else if (io.lookup_in.pf_probe_valid &&
+               io.lookup_in.pf_probe_index == index) {
+      bool hit = false;
+      for (uint32_t way = 0; way < way_cnt; ++way) {
+        hit = hit || (io.lookup_in.pf_probe_set_valid[way] &&
+                      io.lookup_in.pf_probe_set_tag[way] == ppn);
+      }
+      if (hit || prefetch_line_busy(ppn, index)) {
+        perf.pf_filtered_valid = true;
+        pop = true;
+      } else {
+        for (uint32_t i = 0; i < ICACHE_PF_MSHR_NUM; ++i) {
+          if (io.regs.pf_mshr_valid_r[i] || io.reg_write.pf_mshr_valid_r[i] ||
+              (io.regs.pf_req_busy_r && io.regs.pf_req_slot_r == i) ||
+              io.regs.txid_inflight_r[ICACHE_DEMAND_TXID_NUM + i] ||
+              io.regs.txid_canceled_r[ICACHE_DEMAND_TXID_NUM + i]) {
+            continue;
+          }
+          io.reg_write.pf_mshr_valid_r[i] = true;
+          io.reg_write.pf_mshr_sent_r[i] = false;
+          io.reg_write.pf_mshr_ppn_r[i] = ppn;
+          io.reg_write.pf_mshr_index_r[i] = index;
+          pop = true;
+          break;
+        }
+      }
+    }
+    if (pop) {
+      head = (head + 1) % ICACHE_PF_QUEUE_DEPTH;
+      --count;
+    }
+  }
+
+  // 4) Enqueue this cycle's candidate (consecutive same-line candidates merge).
+  uint32_t last_line = io.regs.pf_last_line_r;
+  if (io.in.pf_req_valid && !kill && !flush) {
+    const uint32_t line = io.in.pf_req_vaddr & ~(ICACHE_LINE_SIZE - 1u);
+    if (!last_valid || line != last_line) {
+      if (count < ICACHE_PF_QUEUE_DEPTH) {
+        io.reg_write.pf_q_vaddr_r[(head + count) % ICACHE_PF_QUEUE_DEPTH] = line;
+        ++count;
+      } else {
+        perf.pf_dropped_valid = true;
+      }
+      last_valid = true;
+      last_line = line;
+    }
+  }
+  io.reg_write.pf_q_head_r = head;
+  io.reg_write.pf_q_count_r = count;
+  io.reg_write.pf_last_valid_r = last_valid;
+  io.reg_write.pf_last_line_r = last_line;
+
+  // 5) Issue: the demand miss owns the request channel whenever it is
+  //    waiting to send. Like the demand miss, a prefetch request is held
+  //    until its accepted pulse and only then counts as in flight; req.ready
+  //    alone does not mean the interconnect took it.
+  const bool demand_wants_port =
+      io.out.mem_req_valid ||
+      (static_cast<ICacheState>(io.regs.state) == SWAP_IN &&
+       static_cast<AXIState>(io.regs.mem_axi_state) == AXI_IDLE);
+  io.reg_write.pf_gap_r = io.regs.pf_gap_r > 0 ? io.regs.pf_gap_r - 1 : 0;
+  if (io.regs.pf_req_busy_r) {
+    const uint32_t slot = io.regs.pf_req_slot_r;
+    const uint8_t txid = static_cast<uint8_t>(ICACHE_DEMAND_TXID_NUM + slot);
+    if (io.in.mem_req_accepted && (io.in.mem_req_accepted_id & 0xF) == txid) {
+      io.reg_write.pf_req_busy_r = false;
+      io.reg_write.txid_inflight_r[txid] = true;
+      if (io.reg_write.pf_mshr_valid_r[slot]) {
+        io.reg_write.pf_mshr_sent_r[slot] = true;
+      }
+      io.reg_write.pf_gap_r = ICACHE_PREFETCH_ISSUE_GAP;
+      perf.pf_issue_valid = true;
+    } else if (!demand_wants_port) {
+      io.out.mem_req_valid = true;
+      io.out.mem_req_addr = (io.regs.pf_mshr_ppn_r[slot] << 12) |
+                            (io.regs.pf_mshr_index_r[slot] << offset_bits);
+      io.out.mem_req_id = txid;
+    }
+    return;
+  }
+  if (flush || demand_wants_port || !io.in.mem_req_ready ||
+      io.regs.pf_gap_r > 0) {
+    return;
+  }
+  for (uint32_t i = 0; i < ICACHE_PF_MSHR_NUM; ++i) {
+    if (!io.reg_write.pf_mshr_valid_r[i] || io.reg_write.pf_mshr_sent_r[i] ||
+        !io.regs.pf_mshr_valid_r[i]) {
+      continue;
+    }
+    const uint8_t txid = static_cast<uint8_t>(ICACHE_DEMAND_TXID_NUM + i);
+    io.out.mem_req_valid = true;
+    io.out.mem_req_addr = (io.regs.pf_mshr_ppn_r[i] << 12) |
+                          (io.regs.pf_mshr_index_r[i] << offset_bits);
+    io.out.mem_req_id = txid;
+    io.reg_write.pf_req_busy_r = true;
+    io.reg_write.pf_req_slot_r = static_cast<uint8_t>(i);
+    break;
+  }
 }
 
 void ICache::lookup(uint32_t index) {
@@ -364,12 +642,12 @@ void ICache::lookup(uint32_t index) {
 
   if (sram_load_fire) {
     req_valid_next = true;
-    if (SIM_DEBUG_PRINT_ACTIVE && icache_trace_pc(load_pc, sim_time)) {
+    if (SIM_DEBUG_PRINT_ACTIVE && icache_trace_pc(load_pc, sim_now())) {
       std::printf(
           "[ICACHE][MODULE][REQ_LOAD] cyc=%lld load_pc=0x%08x load_idx=%u "
           "slot_idle=%u can_accept=%u lookup_pending_r=%u in_ppn_v=%u "
           "in_ppn=0x%05x mmu_req_v=%u mmu_vtag=0x%05x\n",
-          (long long)sim_time, static_cast<unsigned>(load_pc),
+          (long long)sim_now(), static_cast<unsigned>(load_pc),
           static_cast<unsigned>(load_index),
           static_cast<unsigned>(slot_idle), static_cast<unsigned>(can_accept),
           static_cast<unsigned>(io.regs.lookup_pending_r),
@@ -483,8 +761,8 @@ void ICache::eval_state_machine() {
         io.out.ifu_resp_valid = true;
         io.out.ifu_page_fault = true;
         if (SIM_DEBUG_PRINT_ACTIVE &&
-            icache_trace_pc(io.out.ifu_resp_pc, sim_time)) {
-          dump_icache_module_ctx("FAST_PF_BYPASS", sim_time, io, mem_gnt);
+            icache_trace_pc(io.out.ifu_resp_pc, sim_now())) {
+          dump_icache_module_ctx("FAST_PF_BYPASS", sim_now(), io, mem_gnt);
         }
         req_ready_w = true;
         fast_bypass_fire = true;
@@ -501,9 +779,13 @@ void ICache::eval_state_machine() {
         }
         io.out.ifu_resp_valid = true;
         io.out.ifu_page_fault = false;
+        perf.pf_useful_valid = pf_line_[index][lookup_hit_way_w];
+        pf_line_hit_w = true;
+        pf_line_hit_index_w = index;
+        pf_line_hit_way_w = lookup_hit_way_w;
         if (SIM_DEBUG_PRINT_ACTIVE &&
-            icache_trace_pc(io.out.ifu_resp_pc, sim_time)) {
-          dump_icache_module_line("FAST_HIT_BYPASS", sim_time, io, mem_gnt,
+            icache_trace_pc(io.out.ifu_resp_pc, sim_now())) {
+          dump_icache_module_line("FAST_HIT_BYPASS", sim_now(), io, mem_gnt,
                                   io.out.rd_data);
         }
         req_ready_w = true;
@@ -529,8 +811,8 @@ void ICache::eval_state_machine() {
         io.out.ifu_resp_valid = true;
         io.out.ifu_page_fault = true;
         if (SIM_DEBUG_PRINT_ACTIVE &&
-            icache_trace_pc(io.out.ifu_resp_pc, sim_time)) {
-          dump_icache_module_ctx("REG_PF", sim_time, io, mem_gnt);
+            icache_trace_pc(io.out.ifu_resp_pc, sim_now())) {
+          dump_icache_module_ctx("REG_PF", sim_now(), io, mem_gnt);
         }
         req_ready_w = true;
         state_next = IDLE;
@@ -538,9 +820,9 @@ void ICache::eval_state_machine() {
       }
 
       if (SIM_DEBUG_PRINT_ACTIVE &&
-          icache_trace_pc(io.regs.req_pc_r, sim_time) &&
+          icache_trace_pc(io.regs.req_pc_r, sim_now()) &&
           !io.lookup_in.meta_resp_valid) {
-        dump_icache_module_ctx("REG_LOOKUP_STALE", sim_time, io, mem_gnt);
+        dump_icache_module_ctx("REG_LOOKUP_STALE", sim_now(), io, mem_gnt);
       }
 
       capture_lookup_meta_result(io.in.ppn & 0xFFFFF, /*compare_valid=*/true);
@@ -551,9 +833,14 @@ void ICache::eval_state_machine() {
         for (uint32_t word = 0; word < word_num; ++word) {
           io.out.rd_data[word] = lookup_hit_data_w[word];
         }
+        perf.pf_useful_valid =
+            pf_line_[io.regs.req_index_r][lookup_hit_way_w];
+        pf_line_hit_w = true;
+        pf_line_hit_index_w = io.regs.req_index_r;
+        pf_line_hit_way_w = lookup_hit_way_w;
         if (SIM_DEBUG_PRINT_ACTIVE &&
-            icache_trace_pc(io.out.ifu_resp_pc, sim_time)) {
-          dump_icache_module_line("REG_HIT", sim_time, io, mem_gnt,
+            icache_trace_pc(io.out.ifu_resp_pc, sim_now())) {
+          dump_icache_module_line("REG_HIT", sim_now(), io, mem_gnt,
                                   io.out.rd_data);
         }
         state_next = IDLE;
@@ -564,12 +851,12 @@ void ICache::eval_state_machine() {
         state_next = IDLE;
       } else {
         if (SIM_DEBUG_PRINT_ACTIVE &&
-            icache_trace_pc(io.out.ifu_resp_pc, sim_time)) {
-          dump_icache_module_ctx("REG_MISS", sim_time, io, mem_gnt);
+            icache_trace_pc(io.out.ifu_resp_pc, sim_now())) {
+          dump_icache_module_ctx("REG_MISS", sim_now(), io, mem_gnt);
           std::printf(
               "[ICACHE][MODULE][REG_MISS_SET] cyc=%lld req_pc=0x%08x req_idx=%u "
               "cmp_ppn=0x%05x hit_v=%u has_inv=%u first_inv=%u",
-              sim_time, static_cast<unsigned>(io.regs.req_pc_r),
+              sim_now(), static_cast<unsigned>(io.regs.req_pc_r),
               static_cast<unsigned>(io.regs.req_index_r),
               static_cast<unsigned>(io.in.ppn & 0xFFFFF),
               static_cast<unsigned>(lookup_hit_valid_w),
@@ -577,9 +864,51 @@ void ICache::eval_state_machine() {
               static_cast<unsigned>(lookup_first_invalid_way_w));
           std::printf("\n");
         }
+        // A prefetch of this line already owns a txid: a sent one is adopted
+        // as the demand refill (late prefetch), an unsent one is dropped.
+        // One whose response lands this cycle, or whose request still waits
+        // for its accepted pulse, holds the miss until it settles.
+        int pf_slot = -1;
+        for (uint32_t i = 0; i < ICACHE_PF_MSHR_NUM; ++i) {
+          if (io.regs.pf_mshr_valid_r[i] &&
+              io.regs.pf_mshr_ppn_r[i] == (io.in.ppn & 0xFFFFF) &&
+              io.regs.pf_mshr_index_r[i] == io.regs.req_index_r) {
+            pf_slot = static_cast<int>(i);
+            break;
+          }
+        }
+        const bool pf_hold =
+            pf_slot >= 0 &&
+            (pf_slot == prefetch_resp_slot() ||
+             (io.regs.pf_req_busy_r && io.regs.pf_req_slot_r == pf_slot));
+        if (pf_hold) {
+          state_next = IDLE;
+          req_ready_w = false;
+          io.out.ppn_ready = io.regs.req_valid_r;
+          break;
+        }
+        if (pf_slot >= 0) {
+          perf.pf_late_valid = true;
+          io.reg_write.pf_mshr_valid_r[pf_slot] = false;
+          io.reg_write.pf_mshr_sent_r[pf_slot] = false;
+        }
         int txid = io.regs.miss_txid_valid_r ? static_cast<int>(io.regs.miss_txid_r)
                                              : alloc_free_txid(io.regs);
-        if (txid < 0) {
+        if (pf_slot >= 0 && io.regs.pf_mshr_sent_r[pf_slot]) {
+          io.reg_write.ppn_r = io.in.ppn;
+          io.reg_write.miss_txid_valid_r = true;
+          io.reg_write.miss_txid_r =
+              static_cast<uint8_t>(ICACHE_DEMAND_TXID_NUM + pf_slot);
+          io.reg_write.miss_ready_seen_r = false;
+          perf.miss_issue_valid = true;
+          perf_state_next.miss_penalty_active = true;
+          perf_state_next.miss_penalty_start_cycle =
+              static_cast<uint64_t>(sim_now());
+          perf_state_next.axi_read_active = false;
+          perf_state_next.axi_read_start_cycle = 0;
+          mem_axi_state_next = AXI_BUSY;
+          state_next = SWAP_IN;
+        } else if (txid < 0) {
           state_next = IDLE;
           req_ready_w = false;
         } else {
@@ -592,7 +921,7 @@ void ICache::eval_state_machine() {
           io.reg_write.miss_ready_seen_r = false;
           perf_state_next.miss_penalty_active = true;
           perf_state_next.miss_penalty_start_cycle =
-              static_cast<uint64_t>(sim_time);
+              static_cast<uint64_t>(sim_now());
           perf_state_next.axi_read_active = false;
           perf_state_next.axi_read_start_cycle = 0;
           state_next = SWAP_IN;
@@ -682,8 +1011,8 @@ void ICache::eval_state_machine() {
           (io.regs.ppn_r << 12) | (io.regs.req_index_r << offset_bits);
       io.out.mem_req_id = io.regs.miss_txid_r;
       if (SIM_DEBUG_PRINT_ACTIVE &&
-          icache_trace_pc(io.regs.req_pc_r, sim_time)) {
-        dump_icache_module_ctx("SWAP_REQ", sim_time, io, mem_gnt);
+          icache_trace_pc(io.regs.req_pc_r, sim_now())) {
+        dump_icache_module_ctx("SWAP_REQ", sim_now(), io, mem_gnt);
       }
       state_next = SWAP_IN;
       if (io.in.mem_req_accepted &&
@@ -693,7 +1022,7 @@ void ICache::eval_state_machine() {
         io.reg_write.txid_inflight_r[io.regs.miss_txid_r & 0xF] = true;
         perf_state_next.axi_read_active = true;
         perf_state_next.axi_read_start_cycle =
-            static_cast<uint64_t>(sim_time);
+            static_cast<uint64_t>(sim_now());
       } else {
         io.out.mem_req_valid = true;
         mem_axi_state_next = AXI_IDLE;
@@ -706,17 +1035,17 @@ void ICache::eval_state_machine() {
       state_next = SWAP_IN;
       if (mem_gnt) {
         if (perf_state.miss_penalty_active &&
-            static_cast<uint64_t>(sim_time) >= perf_state.miss_penalty_start_cycle) {
+            static_cast<uint64_t>(sim_now()) >= perf_state.miss_penalty_start_cycle) {
           perf.miss_penalty_valid = true;
           perf.miss_penalty_cycles =
-              static_cast<uint64_t>(sim_time) -
+              static_cast<uint64_t>(sim_now()) -
               perf_state.miss_penalty_start_cycle;
         }
         if (perf_state.axi_read_active &&
-            static_cast<uint64_t>(sim_time) >= perf_state.axi_read_start_cycle) {
+            static_cast<uint64_t>(sim_now()) >= perf_state.axi_read_start_cycle) {
           perf.axi_read_valid = true;
           perf.axi_read_cycles =
-              static_cast<uint64_t>(sim_time) -
+              static_cast<uint64_t>(sim_now()) -
               perf_state.axi_read_start_cycle;
         }
         for (uint32_t offset = 0; offset < ICACHE_LINE_SIZE / 4; ++offset) {
@@ -749,6 +1078,7 @@ void ICache::eval_state_machine() {
           }
           io.table_write.tag = io.regs.ppn_r;
           io.table_write.valid = true;
+          note_table_write(/*from_prefetch=*/false);
         }
 
         if (!io.in.refetch && !io.in.flush) {
@@ -757,8 +1087,8 @@ void ICache::eval_state_machine() {
             io.out.rd_data[word] = mem_resp_data_w[word];
           }
           if (SIM_DEBUG_PRINT_ACTIVE &&
-              icache_trace_pc(io.out.ifu_resp_pc, sim_time)) {
-            dump_icache_module_line("SWAP_MEM_GNT", sim_time, io, mem_gnt,
+              icache_trace_pc(io.out.ifu_resp_pc, sim_now())) {
+            dump_icache_module_line("SWAP_MEM_GNT", sim_now(), io, mem_gnt,
                                     io.out.rd_data);
           }
           req_ready_w = true;
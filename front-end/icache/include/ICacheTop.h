@@ -12,13 +12,18 @@
 
 #include "../../front_IO.h"
 #include <cstdint>
+#include <memory>
 
 class SimContext;
 class PtwMemPort;
 class PtwWalkPort;
+struct ICacheLookupTableResp;
 namespace axi_interconnect {
 struct ReadMasterPort_t;
 }
+namespace icache_module_n {
+class ICache;
+}
 
 class ICacheTop {
 protected:
@@ -47,6 +52,10 @@ public:
   virtual ~ICacheTop() {}
 };
 
-ICacheTop *get_icache_instance();
+// Build the glue object for one front end; `hw` and `lookup_resp` are owned by
+// the caller's ICacheState and must outlive the returned object.
+std::unique_ptr<ICacheTop>
+make_icache_top(icache_module_n::ICache &hw,
+                const ICacheLookupTableResp &lookup_resp);
 
 #endif
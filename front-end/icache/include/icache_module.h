@@ -5,6 +5,9 @@
  * - 32 bytes per cache line
  * - Random replacement policy
  * - single registered request context with same-cycle hit bypass
+ * - FDIP prefetch: fetch-target queue candidates are tag-probed and prefetched
+ *   over the same AXI read port (demand has priority, prefetch uses reserved
+ *   txids); a demand miss on an in-flight prefetch adopts its txid
  *
  * Address split:
  * PC[31:12], PC[11:5], PC[4:0]
@@ -72,6 +75,26 @@
 #ifndef ICACHE_V1_WAYS
 #define ICACHE_V1_WAYS 8
 #endif
+
+// -----------------------------------------------------------------------------
+// ICache V1 FDIP prefetch knobs
+// -----------------------------------------------------------------------------
+// Candidates are fetch targets queued behind the fetch_address_FIFO head.
+#ifndef ICACHE_PREFETCH_ENABLE
+#define ICACHE_PREFETCH_ENABLE 1
+#endif
+// Candidate queue depth (lines waiting for tag probe).
+#ifndef ICACHE_PREFETCH_QUEUE_DEPTH
+#define ICACHE_PREFETCH_QUEUE_DEPTH 8
+#endif
+// Prefetch MSHRs = max in-flight prefetches; each owns a reserved txid.
+#ifndef ICACHE_PREFETCH_MSHR_NUM
+#define ICACHE_PREFETCH_MSHR_NUM 4
+#endif
+// Throttle: minimum cycles between two prefetch issues (0 = back-to-back).
+#ifndef ICACHE_PREFETCH_ISSUE_GAP
+#define ICACHE_PREFETCH_ISSUE_GAP 0
+#endif
 namespace icache_module_n {
 // -----------------------------------------------------------------------------
 // ICache V1 derived parameters (for generalized-IO structs)
@@ -83,6 +106,17 @@ static constexpr uint32_t ICACHE_V1_WORD_BITS = 32;
 static constexpr uint32_t ICACHE_V1_WORD_BYTES = ICACHE_V1_WORD_BITS / 8u;
 static constexpr uint32_t ICACHE_V1_WORD_NUM = ICACHE_LINE_SIZE / ICACHE_V1_WORD_BYTES;
 static constexpr uint32_t ICACHE_V1_TAG_BITS = 20;
+static constexpr uint32_t ICACHE_PF_QUEUE_DEPTH = ICACHE_PREFETCH_QUEUE_DEPTH;
+static constexpr uint32_t ICACHE_PF_MSHR_NUM =
+    ICACHE_PREFETCH_ENABLE ? ICACHE_PREFETCH_MSHR_NUM : 0;
+// txid [0, ICACHE_DEMAND_TXID_NUM) for demand misses, the rest for prefetch.
+static constexpr uint32_t ICACHE_DEMAND_TXID_NUM = 16 - ICACHE_PF_MSHR_NUM;
+static constexpr uint32_t ICACHE_PF_MSHR_SLOTS =
+    ICACHE_PF_MSHR_NUM > 0 ? ICACHE_PF_MSHR_NUM : 1;
+static_assert(ICACHE_PF_QUEUE_DEPTH >= 1 && ICACHE_PF_QUEUE_DEPTH <= 64,
+              "ICACHE_PREFETCH_QUEUE_DEPTH out of range");
+static_assert(ICACHE_PF_MSHR_NUM <= 8,
+              "ICACHE_PREFETCH_MSHR_NUM must leave txids for demand misses");
 
 // i-Cache State
 enum ICacheState {
@@ -109,6 +143,11 @@ struct ICache_lookup_in_t {
   wire<1> data_resp_valid = false;
   wire<8> data_resp_way = 0;
   wire<ICACHE_V1_WORD_BITS> data_resp_line[ICACHE_V1_WORD_NUM] = {0};
+  // Prefetch tag probe of the candidate-queue head set (dedicated tag port).
+  wire<1> pf_probe_valid = false;
+  wire<7> pf_probe_index = 0;
+  wire<20> pf_probe_set_tag[ICACHE_V1_WAYS] = {0};
+  wire<1> pf_probe_set_valid[ICACHE_V1_WAYS] = {false};
 };
 
 // -----------------------------------------------------------------------------
@@ -142,6 +181,27 @@ struct ICache_regs_t {
   reg<1> lookup_pending_r = false;
   reg<7> lookup_index_r = 0;
   reg<32> lookup_pc_r = 0;
+
+  // FDIP candidate queue (line-aligned virtual addresses, circular).
+  reg<32> pf_q_vaddr_r[ICACHE_PF_QUEUE_DEPTH] = {0};
+  reg<8> pf_q_head_r = 0;
+  reg<8> pf_q_count_r = 0;
+  reg<1> pf_last_valid_r = false;
+  reg<32> pf_last_line_r = 0;
+  // Prefetch MSHRs; entry i owns txid ICACHE_DEMAND_TXID_NUM + i.
+  reg<1> pf_mshr_valid_r[ICACHE_PF_MSHR_SLOTS] = {false};
+  reg<1> pf_mshr_sent_r[ICACHE_PF_MSHR_SLOTS] = {false};
+  reg<20> pf_mshr_ppn_r[ICACHE_PF_MSHR_SLOTS] = {0};
+  reg<7> pf_mshr_index_r[ICACHE_PF_MSHR_SLOTS] = {0};
+  // Prefetch request offered on the read channel, held until its accepted
+  // pulse (same handshake as the demand miss).
+  reg<1> pf_req_busy_r = false;
+  reg<8> pf_req_slot_r = 0;
+  reg<8> pf_gap_r = 0;
+  // Last demand translation, reused for same-page candidates.
+  reg<1> pf_tlb_valid_r = false;
+  reg<20> pf_tlb_vpn_r = 0;
+  reg<20> pf_tlb_ppn_r = 0;
 };
 
 // Generalized-IO note:
@@ -169,6 +229,12 @@ struct ICache_in_t {
   wire<1> refetch = false;        // Refetch signal from Top
   wire<1> flush = false;          // fence.i flush signal from Top
 
+  // FDIP candidate: a fetch target queued behind the fetch_address_FIFO head
+  wire<1> pf_req_valid = false;
+  wire<32> pf_req_vaddr = 0;
+  wire<1> pf_translate_bare = false; // satp.MODE=Bare or M-mode: va == pa
+  wire<1> pf_ctx_flush = false;      // sfence.vma: drop the cached translation
+
   // Input from MMU (Memory Management Unit)
   wire<20> ppn = 0;    // Physical Page Number
   wire<1> ppn_valid = false;  // PPN valid signal
@@ -216,6 +282,13 @@ struct ICache_perf_t {
   wire<64> miss_penalty_cycles = 0;
   wire<1> axi_read_valid = false;
   wire<64> axi_read_cycles = 0;
+  // FDIP prefetch events
+  wire<1> pf_issue_valid = false;
+  wire<1> pf_useful_valid = false;   // first demand hit on a prefetched line
+  wire<1> pf_late_valid = false;     // demand miss caught its prefetch
+  wire<1> pf_filtered_valid = false; // probe hit or already in flight
+  wire<1> pf_dropped_valid = false;  // queue full or no translation
+  wire<16> pf_useless_num = 0;       // prefetched lines evicted unused
 };
 
 // cache io
@@ -326,6 +399,23 @@ private:
   void lookup(uint32_t index);
   void capture_lookup_meta_result(uint32_t compare_tag, bool compare_valid);
   void capture_lookup_data_result();
+
+  // FDIP prefetch engine, evaluated after the demand state machine so it can
+  // see this cycle's demand request/response decisions.
+  void comb_prefetch();
+  bool prefetch_line_busy(uint32_t ppn, uint32_t index) const;
+  int prefetch_resp_slot() const;
+  void note_table_write(bool from_prefetch);
+
+  // Which lines were brought in by prefetch and not yet used. Perf-only
+  // bookkeeping, applied in seq() like perf_state.
+  bool pf_line_[set_num][way_cnt] = {};
+  bool pf_line_hit_w = false;
+  uint32_t pf_line_hit_index_w = 0;
+  uint32_t pf_line_hit_way_w = 0;
+  bool pf_line_write_w = false;
+  bool pf_line_write_set_w = false;
+  bool pf_line_clear_all_w = false;
 };
 
 }; // namespace icache_module_n
@@ -0,0 +1,86 @@
+#ifndef ICACHE_STATE_H
+#define ICACHE_STATE_H
+
+// Per-front-end icache wrapper state (one per FrontTopState):
+// - the icache_module hardware instance and the external lookup tables
+// - the per-cycle table response snapshot folded into icache_module IO
+// - the ICacheTop glue object and the runtime objects bound into it
+//
+// icache.cpp drives it through the icache_* functions in front_module.h.
+
+#include "../GenericTable.h"
+#include "ICacheTop.h"
+#include "icache_module.h"
+#include <memory>
+
+namespace axi_interconnect {
+struct ReadMasterPort_t;
+}
+
+struct ICacheLookupTableResp {
+  bool meta_resp_valid = false;
+  bool data_snapshot_valid = false;
+  uint32_t lookup_index = 0;
+  uint32_t set_way_line_snapshot[ICACHE_V1_WAYS][icache_module_n::ICACHE_V1_WORD_NUM] = {{0}};
+  uint32_t set_tag_snapshot[ICACHE_V1_WAYS] = {0};
+  bool set_valid_snapshot[ICACHE_V1_WAYS] = {false};
+  // Prefetch tag-probe port: tags/valids of the candidate queue head's set.
+  bool pf_probe_valid = false;
+  uint32_t pf_probe_index = 0;
+  uint32_t pf_probe_set_tag[ICACHE_V1_WAYS] = {0};
+  bool pf_probe_set_valid[ICACHE_V1_WAYS] = {false};
+};
+
+void icache_fill_lookup_meta_input(const ICacheLookupTableResp &resp,
+                                   icache_module_n::ICache_lookup_in_t &dst);
+void icache_fill_lookup_data_input(const ICacheLookupTableResp &resp,
+                                   icache_module_n::ICache_lookup_in_t &dst,
+                                   bool req_valid, uint32_t req_index,
+                                   uint32_t req_way);
+
+struct ICacheState {
+  using LookupTimingPolicy =
+#if ICACHE_LOOKUP_LATENCY == 0
+      RegfileTablePolicy;
+#else
+      SramTablePolicy;
+#endif
+
+  static constexpr int kRows = icache_module_n::ICACHE_V1_SET_NUM;
+  static constexpr int kDataChunks = ICACHE_V1_WAYS;
+  static constexpr int kDataChunkBits = ICACHE_LINE_SIZE * 8;
+  static constexpr int kTagChunks = ICACHE_V1_WAYS;
+  static constexpr int kTagChunkBits = icache_module_n::ICACHE_V1_TAG_BITS;
+  static constexpr int kValidChunks = ICACHE_V1_WAYS;
+  static constexpr int kValidChunkBits = 1;
+
+  using DataTable =
+      GenericTable<kRows, kDataChunks, kDataChunkBits, LookupTimingPolicy>;
+  using TagTable =
+      GenericTable<kRows, kTagChunks, kTagChunkBits, LookupTimingPolicy>;
+  using ValidTable =
+      GenericTable<kRows, kValidChunks, kValidChunkBits, LookupTimingPolicy>;
+
+  ICacheState();
+  ICacheState(const ICacheState &) = delete;
+  ICacheState &operator=(const ICacheState &) = delete;
+
+  icache_module_n::ICache hw;
+  DataTable data_table;
+  TagTable tag_table;
+  ValidTable valid_table;
+  ICacheLookupTableResp lookup_resp;
+  std::unique_ptr<ICacheTop> top;
+
+  // Bindings requested by FrontTop; pushed into `top` lazily on change.
+  SimContext *ctx = nullptr;
+  PtwMemPort *ptw_mem_port = nullptr;
+  PtwWalkPort *ptw_walk_port = nullptr;
+  axi_interconnect::ReadMasterPort_t *mem_read_port = nullptr;
+  SimContext *bound_ctx = nullptr;
+  PtwMemPort *bound_mem_port = nullptr;
+  PtwWalkPort *bound_walk_port = nullptr;
+  axi_interconnect::ReadMasterPort_t *bound_read_port = nullptr;
+};
+
+#endif
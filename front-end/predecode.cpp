@@ -1,5 +1,7 @@
 #include "predecode.h"
 
+#include "DecodeMemo.h"
+#include "RVC.h"
 #include <cstring>
 
 static inline uint32_t sign_extend_u32(uint32_t value, int bits) {
@@ -13,48 +15,83 @@ void predecode_seq_read(const struct predecode_in *in,
   rd->pc = in->pc;
 }
 
-void predecode_comb(const predecode_read_data &input, PredecodeResult &output) {
-  std::memset(&output, 0, sizeof(PredecodeResult));
-  output.type = PREDECODE_NON_BRANCH;
-  output.target_address = 0;
+namespace {
+// 预译码结果按指令字缓存：类型与 PC 相对偏移只由指令字决定，目标地址 = pc + offset
+struct PredecodeMemoEntry {
+  predecode_type_t type;
+  uint32_t offset;
+};
 
-  const uint32_t inst = input.inst;
-  const uint32_t pc = input.pc;
-  if (inst == 0 || inst == INST_NOP) {
-    return;
+PredecodeMemoEntry predecode_uncached(uint32_t inst) {
+  PredecodeMemoEntry out = {PREDECODE_NON_BRANCH, 0};
+#ifdef CONFIG_RVC
+  // C.J/C.JAL/C.BEQZ/C.BNEZ/C.JR/C.JALR 展开后与对应 32 位指令同类
+  if (rvc_is_compressed(inst)) {
+    inst = rvc_expand(inst);
   }
-
+#endif
   const uint32_t opcode = inst & 0x7f;
   switch (opcode) {
   case number_2_opcode_jal: {
-    output.type = PREDECODE_JAL;
+    out.type = PREDECODE_JAL;
     const uint32_t imm20 = (inst >> 31) & 0x1;
     const uint32_t imm10_1 = (inst >> 21) & 0x3ff;
     const uint32_t imm11 = (inst >> 20) & 0x1;
     const uint32_t imm19_12 = (inst >> 12) & 0xff;
     const uint32_t imm_raw =
         (imm20 << 20) | (imm19_12 << 12) | (imm11 << 11) | (imm10_1 << 1);
-    output.target_address = pc + sign_extend_u32(imm_raw, 21);
+    out.offset = sign_extend_u32(imm_raw, 21);
     break;
   }
   case number_4_opcode_beq: {
-    output.type = PREDECODE_DIRECT_JUMP_NO_JAL;
+    out.type = PREDECODE_DIRECT_JUMP_NO_JAL;
     const uint32_t imm12 = (inst >> 31) & 0x1;
     const uint32_t imm10_5 = (inst >> 25) & 0x3f;
     const uint32_t imm4_1 = (inst >> 8) & 0xf;
     const uint32_t imm11 = (inst >> 7) & 0x1;
     const uint32_t imm_raw =
         (imm12 << 12) | (imm11 << 11) | (imm10_5 << 5) | (imm4_1 << 1);
-    output.target_address = pc + sign_extend_u32(imm_raw, 13);
+    out.offset = sign_extend_u32(imm_raw, 13);
     break;
   }
   case number_3_opcode_jalr:
-    output.type = PREDECODE_JALR;
-    output.target_address = 0;
+    out.type = PREDECODE_JALR;
     break;
   default:
     break;
   }
+  return out;
+}
+} // namespace
+
+void predecode_comb(const predecode_read_data &input, PredecodeResult &output) {
+  // 内容只依赖指令字，可跨仿真实例共享；按线程独立以免加锁
+  static thread_local DecodeMemo<PredecodeMemoEntry, 10> memo;
+
+  std::memset(&output, 0, sizeof(PredecodeResult));
+  output.type = PREDECODE_NON_BRANCH;
+  output.target_address = 0;
+
+  uint32_t inst = input.inst;
+#ifdef CONFIG_RVC
+  // 槽位候选为从该半字起的 32 位；压缩指令只看低 16 位，高半部属于下一条
+  if (rvc_is_compressed(inst)) {
+    inst &= 0xffffu;
+  }
+#endif
+  if (inst == 0 || inst == INST_NOP) {
+    return;
+  }
+
+  const PredecodeMemoEntry *entry = memo.find(inst);
+  if (entry == nullptr) {
+    memo.insert(inst, predecode_uncached(inst));
+    entry = memo.find(inst);
+  }
+  output.type = entry->type;
+  if (entry->type != PREDECODE_NON_BRANCH && entry->type != PREDECODE_JALR) {
+    output.target_address = input.pc + entry->offset;
+  }
 }
 
 void predecode_seq_write() {}
@@ -208,6 +208,31 @@ struct PendingBpuSeqTxn {
   BPU_TOP::UpdateRequest req;
 };
 
+#ifdef CONFIG_RVC
+// 跨取指块的 32 位指令：低半部落在上一块最后一个半字槽位，连同该槽位的预测
+// 元数据一起寄存，顺序下一块到达时在其槽位 0 拼成完整指令。
+struct FrontRvcCarry {
+  wire1_t valid;
+  pc_t pc;
+  inst_word_t low_half;
+  wire1_t predict_dir;
+  wire1_t alt_pred;
+  pcpn_t altpcpn;
+  pcpn_t pcpn;
+  tage_idx_t tage_idx[4]; // TN_MAX = 4
+  tage_tag_t tage_tag[4]; // TN_MAX = 4
+  wire1_t sc_used;
+  wire1_t sc_pred;
+  tage_scl_meta_sum_t sc_sum;
+  tage_scl_meta_idx_t sc_idx[BPU_SCL_META_NTABLE];
+  wire1_t loop_used;
+  wire1_t loop_hit;
+  wire1_t loop_pred;
+  tage_loop_meta_idx_t loop_idx;
+  tage_loop_meta_tag_t loop_tag;
+};
+#endif
+
 struct PendingFrontState {
   wire1_t valid = false;
   wire32_t next_front_sim_time = 0;
@@ -222,6 +247,9 @@ struct PendingFrontState {
   wire1_t next_ptab_empty = true;
   wire1_t next_front2back_fifo_full = false;
   wire1_t next_front2back_fifo_empty = true;
+#ifdef CONFIG_RVC
+  FrontRvcCarry next_rvc_carry{};
+#endif
 };
 
 struct FrontReadData {
@@ -241,6 +269,9 @@ struct FrontReadData {
   wire1_t ptab_empty_latch_snapshot = true;
   wire1_t front2back_fifo_full_latch_snapshot = false;
   wire1_t front2back_fifo_empty_latch_snapshot = true;
+#ifdef CONFIG_RVC
+  FrontRvcCarry rvc_carry_snapshot{};
+#endif
 };
 
 struct FrontUpdateRequest {
@@ -369,6 +400,20 @@ struct FrontCheckerInputCombOut {
   predecode_checker_in checker_in;
 };
 
+#ifdef CONFIG_RVC
+struct FrontRvcAlignCombIn {
+  instruction_FIFO_out fifo_out;
+  PTAB_out ptab_out;
+  FrontRvcCarry carry;
+};
+
+struct FrontRvcAlignCombOut {
+  instruction_FIFO_out fifo_out;
+  PTAB_out ptab_out;
+  FrontRvcCarry tail;
+};
+#endif
+
 struct FrontFront2backWriteCombIn {
   instruction_FIFO_out fifo_out;
   PTAB_out ptab_out;
@@ -52,6 +52,8 @@ using wire30_t = uint32_t;
 static constexpr int wire30_t_BITS = 30;
 using wire32_t = uint32_t;
 static constexpr int wire32_t_BITS = 32;
+using wire64_t = uint64_t;
+static constexpr int wire64_t_BITS = 64;
 
 template <int Bits>
 struct wire_for_bits;
@@ -228,6 +230,16 @@ using type_pred_conf_t = wire_for_bits_t<TYPE_PRED_CONF_BITS>;
 static constexpr int type_pred_conf_t_BITS = TYPE_PRED_CONF_BITS;
 using type_pred_age_t = wire_for_bits_t<TYPE_PRED_AGE_BITS>;
 static constexpr int type_pred_age_t_BITS = TYPE_PRED_AGE_BITS;
+using ittage_idx_t = wire_for_bits_t<ceil_log2_u32(ITTAGE_ENTRY_NUM)>;
+static constexpr int ittage_idx_t_BITS = ceil_log2_u32(ITTAGE_ENTRY_NUM);
+using ittage_tag_t = wire_for_bits_t<ITTAGE_TAG_WIDTH>;
+static constexpr int ittage_tag_t_BITS = ITTAGE_TAG_WIDTH;
+using ittage_conf_t = wire_for_bits_t<ITTAGE_CONF_BITS>;
+static constexpr int ittage_conf_t_BITS = ITTAGE_CONF_BITS;
+using ittage_useful_t = wire_for_bits_t<ITTAGE_USEFUL_BITS>;
+static constexpr int ittage_useful_t_BITS = ITTAGE_USEFUL_BITS;
+using ittage_table_sel_t = wire_for_bits_t<ceil_log2_u32(TN_MAX + 1)>;
+static constexpr int ittage_table_sel_t_BITS = ceil_log2_u32(TN_MAX + 1);
 using fetch_addr_t = wire32_t;
 static constexpr int fetch_addr_t_BITS = 32;
 using pc_t = wire32_t;
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "config.h"
+
+// ============================================================
+// Checkpoint 文件格式
+//
+// v2（SimpleSim 生成，整体 gzip）：
+//   CkptHeader | CkptCpuState | uint64 interval | RAM(ram_size 字节) |
+//   { CkptIoRange | 原始字节 } x io_range_count
+//
+// v3（非压缩外壳，按块独立压缩，全零块省略）：
+//   CkptHeader(version=3) | CkptV3Meta | CkptCpuState |
+//   CkptIoRange x io_range_count | CkptIoWord x io_word_count |
+//   CkptChunkEntry x chunk_count | 各块 zlib 数据
+//   RAM 被切成 chunk_bytes 大小的块，只存非全零块；恢复时多线程
+//   pread + uncompress 直接写入 pmem 后端，未出现的块保持为零。
+//   IO 区只存非零字（与 pmem IO 字存储一致）。
+// 两种格式按文件头区分：gzip 魔数为 v2，否则按 v3 头解析。
+// ============================================================
+
+constexpr uint32_t kCkptMagic = 0x006d6552u; // "Rem\0" little-endian
+constexpr uint32_t kCkptVersionV2 = 2u;
+constexpr uint32_t kCkptVersionV3 = 3u;
+constexpr uint64_t kCkptSimpointRamBytes = RAM_SIZE;
+constexpr uint32_t kCkptV3ChunkBytes = 1u << 20; // 写出 v3 时的默认块大小
+
+typedef struct CkptHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t ram_size;
+  uint32_t io_range_count;
+} CkptHeader;
+
+// 与 SimpleSim/save_checkpoint 写入格式保持一致，确保反序列化对齐。
+// 注意：reserve_* 当前在本模拟器中暂未使用，但必须读取以避免流错位。
+typedef struct CkptCpuState {
+  uint32_t gpr[32];
+  uint32_t csr[21];
+  uint32_t pc;
+
+  uint32_t store_addr;
+  uint32_t store_data;
+  uint32_t store_strb;
+  bool store;
+  bool reserve_valid;
+  uint32_t reserve_addr;
+} CkptCpuState;
+
+typedef struct CkptIoRange {
+  uint32_t base;
+  uint32_t size;
+} CkptIoRange;
+
+typedef struct CkptV3Meta {
+  uint32_t chunk_bytes;   // RAM 分块大小，需整除 ram_size
+  uint32_t chunk_count;   // 实际存储的（非全零）块数
+  uint32_t io_word_count; // 非零 IO 字个数
+  uint32_t privilege;     // 打点时的特权级
+  uint64_t interval_inst_count;
+} CkptV3Meta;
+
+typedef struct CkptIoWord {
+  uint32_t addr;
+  uint32_t data;
+} CkptIoWord;
+
+typedef struct CkptChunkEntry {
+  uint32_t index;      // 块号，RAM 偏移 = index * chunk_bytes
+  uint32_t comp_bytes; // zlib 压缩后字节数
+  uint64_t offset;     // 压缩数据在文件中的偏移
+} CkptChunkEntry;
+
+static_assert(sizeof(CkptHeader) == 16 && sizeof(CkptCpuState) == 236 &&
+                  sizeof(CkptV3Meta) == 24 && sizeof(CkptChunkEntry) == 16,
+              "checkpoint on-disk layout changed");
+
+constexpr std::array<CkptIoRange, 4> kExpectedIoLayout = {
+    CkptIoRange{BOOT_IO_BASE, BOOT_IO_SIZE},
+    CkptIoRange{UART_ADDR_BASE, UART_MMIO_SIZE},
+    CkptIoRange{PLIC_ADDR_BASE, PLIC_MMIO_SIZE},
+    CkptIoRange{OPENSBI_TIMER_BASE, OPENSBI_TIMER_MMIO_SIZE},
+};
+
+struct CkptSnapshot {
+  uint32_t version = 0;
+  CkptCpuState cpu = {};
+  uint8_t privilege = 0;
+  uint64_t interval_inst_count = 0;
+};
+
+// 读取 v2/v3 checkpoint：RAM 与 IO 字直接写入 pmem 后端（先整体清空），
+// CPU 状态写入 snap。filename 不存在且不含 ".gz" 时尝试追加 ".gz"。
+// 返回实际打开的文件名；格式错误直接报错退出。
+std::string ckpt_restore(const std::string &filename, CkptSnapshot &snap);
+
+// 以 v3 格式写出 checkpoint（先写临时文件再改名）。ram 为 RAM 视图，
+// dirty_page_bits 标记该视图相对 pmem 镜像写过的 4KB 页：镜像中为空洞且
+// 未被写过的块直接按全零省略，不触碰其页面。
+void ckpt_save(const std::string &path, const CkptSnapshot &snap,
+               const uint32_t *ram,
+               const std::vector<uint64_t> &dirty_page_bits,
+               const std::unordered_map<uint32_t, uint32_t> &io_words);
@@ -2,10 +2,10 @@
 
 #include "config.h"
 
-#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <vector>
 
 enum class DeadlockReplayTraceKind : uint8_t {
   MshrBroadcast = 0,
@@ -34,11 +34,10 @@ struct DeadlockReplayTraceEvent {
 
 namespace deadlock_replay_trace {
 
-inline std::array<DeadlockReplayTraceEvent,
-                  CONFIG_DEADLOCK_REPLAY_TRACE_BUFFER_SIZE>
-    g_events{};
-inline size_t g_next = 0;
-inline bool g_wrapped = false;
+// 每个仿真线程一份，首次 record 时才分配环形缓冲
+inline thread_local std::vector<DeadlockReplayTraceEvent> g_events;
+inline thread_local size_t g_next = 0;
+inline thread_local bool g_wrapped = false;
 
 inline const char *kind_name(DeadlockReplayTraceKind kind) {
   switch (kind) {
@@ -81,8 +80,11 @@ inline void record(DeadlockReplayTraceKind kind, uint16_t slot, uint8_t replay,
                    uint8_t state, uint8_t flag0, uint8_t flag1, uint32_t pc,
                    uint32_t addr, uint32_t line, uint32_t aux0,
                    uint32_t aux1) {
+  if (g_events.empty()) {
+    g_events.resize(CONFIG_DEADLOCK_REPLAY_TRACE_BUFFER_SIZE);
+  }
   auto &slot_ref = g_events[g_next];
-  slot_ref.cycle = sim_time;
+  slot_ref.cycle = sim_now();
   slot_ref.kind = kind;
   slot_ref.slot = slot;
   slot_ref.replay = replay;
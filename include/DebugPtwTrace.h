@@ -45,20 +45,23 @@ struct DebugPtwWalkRespEvent {
 
 namespace debug_ptw_trace {
 
-inline std::array<DebugSatpWriteEvent, CONFIG_DEBUG_SATP_TRACE_BUFFER_SIZE>
+// 记录与转储都在仿真线程上进行，每个线程（即每个实例）一份
+inline thread_local std::array<DebugSatpWriteEvent,
+                               CONFIG_DEBUG_SATP_TRACE_BUFFER_SIZE>
     g_satp_events{};
-inline size_t g_satp_next = 0;
-inline bool g_satp_wrapped = false;
+inline thread_local size_t g_satp_next = 0;
+inline thread_local bool g_satp_wrapped = false;
 
-inline std::array<DebugPtwWalkRespEvent, CONFIG_DEBUG_PTW_WALK_TRACE_BUFFER_SIZE>
+inline thread_local std::array<DebugPtwWalkRespEvent,
+                               CONFIG_DEBUG_PTW_WALK_TRACE_BUFFER_SIZE>
     g_ptw_walk_events{};
-inline size_t g_ptw_walk_next = 0;
-inline bool g_ptw_walk_wrapped = false;
+inline thread_local size_t g_ptw_walk_next = 0;
+inline thread_local bool g_ptw_walk_wrapped = false;
 
 inline void record_satp_write(uint32_t old_satp, uint32_t new_satp,
                               uint8_t privilege) {
   auto &slot = g_satp_events[g_satp_next];
-  slot.cycle = sim_time;
+  slot.cycle = sim_now();
   slot.old_satp = old_satp;
   slot.new_satp = new_satp;
   slot.privilege = privilege;
@@ -71,7 +74,7 @@ inline void record_satp_write(uint32_t old_satp, uint32_t new_satp,
 inline void record_ptw_walk_resp_detail(const uint32_t *memory, uint32_t req_addr,
                                         uint32_t pte) {
   auto &slot = g_ptw_walk_events[g_ptw_walk_next];
-  slot.cycle = sim_time;
+  slot.cycle = sim_now();
   slot.req_addr = req_addr;
   slot.line_addr = req_addr & ~(DCACHE_LINE_SIZE - 1u);
   slot.pte = pte;
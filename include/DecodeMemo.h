@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+
+// ============================================================
+// 以 32 位指令字为键的译码备忘表（仿真器加速，不对应任何硬件结构）
+//
+// 只适用于结果完全由指令字决定的译码：命中直接返回缓存的模板，
+// 缺失由调用方完整译码后 insert。直接映射，冲突时新值覆盖旧值。
+// PC、序号、异常位等动态字段由调用方在取出模板后补写。
+// ============================================================
+
+template <typename T, int kIndexBits> class DecodeMemo {
+public:
+  static_assert(kIndexBits > 0 && kIndexBits <= 20,
+                "DecodeMemo index bits out of range");
+
+  const T *find(uint32_t inst) const {
+    const Entry &e = entries_[index_of(inst)];
+    return (e.valid && e.inst == inst) ? &e.value : nullptr;
+  }
+
+  void insert(uint32_t inst, const T &value) {
+    Entry &e = entries_[index_of(inst)];
+    e.valid = true;
+    e.inst = inst;
+    e.value = value;
+  }
+
+  void clear() {
+    for (auto &e : entries_) {
+      e.valid = false;
+    }
+  }
+
+private:
+  // 乘法散列取高位：指令字低位（opcode）取值很少，直接截低位冲突严重
+  static uint32_t index_of(uint32_t inst) {
+    return (inst * 0x9E3779B1u) >> (32 - kIndexBits);
+  }
+
+  struct Entry {
+    bool valid = false;
+    uint32_t inst = 0;
+    T value{};
+  };
+  Entry entries_[1u << kIndexBits];
+};
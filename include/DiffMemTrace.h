@@ -1,10 +1,10 @@
 #pragma once
 
 #include "config.h"
-#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <vector>
 
 enum class DiffMemTraceOp : uint8_t {
   Load = 0,
@@ -51,10 +51,10 @@ struct DiffMemTraceEvent {
 
 namespace diff_mem_trace {
 
-inline std::array<DiffMemTraceEvent, CONFIG_DIFF_DEBUG_MEMTRACE_BUFFER_SIZE>
-    g_events{};
-inline size_t g_next = 0;
-inline bool g_wrapped = false;
+// 每个仿真线程一份，首次 record 时才分配环形缓冲
+inline thread_local std::vector<DiffMemTraceEvent> g_events;
+inline thread_local size_t g_next = 0;
+inline thread_local bool g_wrapped = false;
 
 inline const char *op_name(DiffMemTraceOp op) {
   return op == DiffMemTraceOp::Load ? "LD" : "ST";
@@ -103,8 +103,11 @@ inline void record(DiffMemTraceOp op, DiffMemTracePhase phase,
                    size_t req_id, uint32_t rob_idx, uint32_t rob_flag,
                    uint32_t addr, uint32_t data, uint32_t aux0,
                    uint32_t aux1) {
+  if (g_events.empty()) {
+    g_events.resize(CONFIG_DIFF_DEBUG_MEMTRACE_BUFFER_SIZE);
+  }
   auto &slot = g_events[g_next];
-  slot.cycle = sim_time;
+  slot.cycle = sim_now();
   slot.op = op;
   slot.phase = phase;
   slot.detail = detail;
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "front_IO.h"
+#include <memory>
 
 class PtwMemPort;
 class PtwWalkPort;
 class SimContext;
+struct FrontTopState;
 namespace axi_interconnect {
 struct ReadMasterPort_t;
 }
@@ -29,7 +31,11 @@ public:
   ICacheMemPortReq *icache_mem_req_port = nullptr;
   ICacheMemPortResp *icache_mem_resp_port = nullptr;
   axi_interconnect::ReadMasterPort_t *icache_mem_read_port = nullptr;
+  // front_top 的跨拍状态（锁存、BPU、统计），首次 init() 时创建
+  std::unique_ptr<FrontTopState> state;
 
+  FrontTop();
+  ~FrontTop();
   void init();
   void step_bpu();
   void step_oracle();
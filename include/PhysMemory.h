@@ -2,6 +2,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 // ============================================================
 // 物理内存统一接口
@@ -10,25 +12,88 @@
 // - RAM: [PMEM_RAM_BASE, PMEM_RAM_BASE + RAM_SIZE) 连续存储
 // - IO : 其余 32-bit 物理地址，离散字存储（按 word 对齐）
 //
-// p_memory 指向 RAM 窗口基址（对应物理地址 0x8000_0000）。
-// 代码应优先使用 pmem_read / pmem_write，而非直接 p_memory[] 下标。
+// 每个 SimCpu 持有一个 PhysMemory；pmem_* 自由函数作用于当前线程绑定的
+// 实例（见 SimThread.h）。ram_ptr() 指向 RAM 窗口基址（对应物理地址
+// 0x8000_0000），代码应优先使用 pmem_read / pmem_write 而非直接下标。
 // ============================================================
 
 constexpr uint32_t PMEM_RAM_BASE = 0x80000000u;
 
-extern uint32_t *p_memory;
+bool pmem_is_ram_addr(uint32_t paddr, uint32_t size = 4u);
 
-bool pmem_init();
-void pmem_release();
-void pmem_clear_all();
+class PhysMemory {
+public:
+  PhysMemory() = default;
+  ~PhysMemory() { release(); }
+  PhysMemory(const PhysMemory &) = delete;
+  PhysMemory &operator=(const PhysMemory &) = delete;
 
-bool pmem_is_ram_addr(uint32_t paddr, uint32_t size = 4u);
+  bool init();
+  void release();
+  void clear_all();
+
+  uint32_t read(uint32_t paddr) const;
+  void write(uint32_t paddr, uint32_t data);
+  void memcpy_to_ram(uint32_t ram_paddr, const void *src, size_t len);
+  void memcpy_from_ram(void *dst, uint32_t ram_paddr, size_t len) const;
+  uint32_t *ram_ptr() const { return ram_; }
+
+  void collect_io_words(std::unordered_map<uint32_t, uint32_t> &out) const;
+
+  uint32_t *view_map(uint32_t *view = nullptr);
+  bool image_has_data(uint64_t offset, uint64_t len) const;
+  void image_commit(const uint32_t *src,
+                    const std::vector<uint64_t> &dirty_page_bits);
+
+private:
+  void require_ready(const char *op) const;
+  uint32_t *map_image(void *addr, int share_flag) const;
+
+  uint32_t *ram_ = nullptr; // DUT 视图
+  std::unordered_map<uint32_t, uint32_t> io_words_;
+  // RAM 镜像由一个 memfd 承载：
+  // - 装载阶段 ram_ 以 MAP_SHARED 映射，写入直接落到镜像；
+  // - 首个 COW 视图建立时“封存”镜像，ram_ 原地改为 MAP_PRIVATE，
+  //   此后 DUT / ref_cpu / oracle 各自只为写过的页付出私有副本。
+  int image_fd_ = -1;
+  bool image_sealed_ = false;
+};
+
+// 当前线程绑定实例的物理内存；未绑定时报错退出。
+PhysMemory &pmem_current();
+
+void pmem_clear_all();
 uint32_t pmem_read(uint32_t paddr);
 void pmem_write(uint32_t paddr, uint32_t data);
 
+// 把 checkpoint IO 布局（kExpectedIoLayout）内的非零 IO 字拷入 out（先清空），
+// 供 ref_cpu / oracle 在恢复或复位后同步后端的 IO 状态。
+void pmem_collect_io_words(std::unordered_map<uint32_t, uint32_t> &out);
+
 // 批量 RAM 拷贝接口，paddr 必须落在 RAM 窗口内。
 void pmem_memcpy_to_ram(uint32_t ram_paddr, const void *src, size_t len);
 void pmem_memcpy_from_ram(void *dst, uint32_t ram_paddr, size_t len);
 
 // 返回 RAM 基址指针（对应物理地址 PMEM_RAM_BASE）。
 uint32_t *pmem_ram_ptr();
+
+// ------------------------------------------------------------
+// 写时复制 RAM 视图
+//
+// RAM 由 memfd 镜像承载。同一实例的 ref_cpu / oracle 不再各自持有 1GB
+// 拷贝，而是 MAP_PRIVATE 映射同一镜像，只有写过的页才产生私有副本。
+// - pmem_view_map(nullptr)：新建一个内容等于当前镜像的视图；
+// - pmem_view_map(view)：原地重置已有视图（丢弃私有页，地址不变）。
+// 首次建立视图时镜像被封存，此后 DUT 的写入同样只落在自己的私有页上。
+// ------------------------------------------------------------
+uint32_t *pmem_view_map(uint32_t *view = nullptr);
+void pmem_view_unmap(uint32_t *view);
+
+// 镜像 [offset, offset+len) 字节内是否可能有非零数据（空洞一定为零）。
+// 配合视图的脏页位图，可在不触碰未分配页的前提下跳过全零区域。
+bool pmem_image_has_data(uint64_t offset, uint64_t len);
+
+// 把 src 视图中 dirty_page_bits 标记的 4KB 页写回镜像，并把 DUT 视图
+// (ram_ptr()) 重置为提交后的镜像。用于 ref 快进后将内存交接给 DUT。
+void pmem_image_commit(const uint32_t *src,
+                       const std::vector<uint64_t> &dirty_page_bits);
@@ -0,0 +1,196 @@
+#pragma once
+#include <cstdint>
+
+// ============================================================
+// RV32C 压缩指令展开（ref 模型、后端译码与预译码共用）
+//
+// 取指得到的原始位低 2 位不为 11 即为 16 位压缩指令；rvc_expand() 把它
+// 展开成语义等价的 32 位 RV32I 指令字，保留 / 非法编码返回 0（opcode 0
+// 在各译码器中都按非法指令处理）。本核浮点为 Zfinx，C.FLW/C.FSW 等浮点
+// 访存编码按保留处理；RV32 下 shamt[5]=1 的移位为非法。
+// ============================================================
+
+inline bool rvc_is_compressed(uint32_t raw) { return (raw & 0x3u) != 0x3u; }
+
+namespace rvc_detail {
+
+inline uint32_t bit(uint32_t x, int i) { return (x >> i) & 1u; }
+inline uint32_t bits(uint32_t x, int hi, int lo) {
+  return (x >> lo) & ((1u << (hi - lo + 1)) - 1u);
+}
+inline uint32_t sext(uint32_t x, int width) {
+  const uint32_t m = 1u << (width - 1);
+  return (x ^ m) - m;
+}
+// rd'/rs1'/rs2' 三位寄存器号映射到 x8-x15
+inline uint32_t creg(uint32_t x) { return x + 8u; }
+
+inline uint32_t enc_i(uint32_t imm, uint32_t rs1, uint32_t f3, uint32_t rd,
+                      uint32_t op) {
+  return ((imm & 0xfffu) << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+inline uint32_t enc_s(uint32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3,
+                      uint32_t op) {
+  return (bits(imm, 11, 5) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) |
+         (bits(imm, 4, 0) << 7) | op;
+}
+inline uint32_t enc_b(uint32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3) {
+  return (bit(imm, 12) << 31) | (bits(imm, 10, 5) << 25) | (rs2 << 20) |
+         (rs1 << 15) | (f3 << 12) | (bits(imm, 4, 1) << 8) |
+         (bit(imm, 11) << 7) | 0x63u;
+}
+inline uint32_t enc_j(uint32_t imm, uint32_t rd) {
+  return (bit(imm, 20) << 31) | (bits(imm, 10, 1) << 21) |
+         (bit(imm, 11) << 20) | (bits(imm, 19, 12) << 12) | (rd << 7) | 0x6fu;
+}
+inline uint32_t enc_r(uint32_t f7, uint32_t rs2, uint32_t rs1, uint32_t f3,
+                      uint32_t rd) {
+  return (f7 << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) |
+         0x33u;
+}
+
+// C.J / C.JAL 的 offset[11|4|9:8|10|6|7|3:1|5]
+inline uint32_t imm_cj(uint32_t c) {
+  const uint32_t imm = (bit(c, 12) << 11) | (bit(c, 11) << 4) |
+                       (bits(c, 10, 9) << 8) | (bit(c, 8) << 10) |
+                       (bit(c, 7) << 6) | (bit(c, 6) << 7) |
+                       (bits(c, 5, 3) << 1) | (bit(c, 2) << 5);
+  return sext(imm, 12);
+}
+// C.BEQZ / C.BNEZ 的 offset[8|4:3] / [7:6|2:1|5]
+inline uint32_t imm_cb(uint32_t c) {
+  const uint32_t imm = (bit(c, 12) << 8) | (bits(c, 11, 10) << 3) |
+                       (bits(c, 6, 5) << 6) | (bits(c, 4, 3) << 1) |
+                       (bit(c, 2) << 5);
+  return sext(imm, 9);
+}
+// CI 格式 6 位有符号立即数 imm[5] / imm[4:0]
+inline uint32_t imm_ci(uint32_t c) {
+  return sext((bit(c, 12) << 5) | bits(c, 6, 2), 6);
+}
+
+} // namespace rvc_detail
+
+inline uint32_t rvc_expand(uint32_t raw) {
+  using namespace rvc_detail;
+  const uint32_t c = raw & 0xffffu;
+  const uint32_t f3 = bits(c, 15, 13);
+  const uint32_t rd = bits(c, 11, 7);
+  const uint32_t rs2 = bits(c, 6, 2);
+  const uint32_t rd_p = creg(bits(c, 4, 2));
+  const uint32_t rs1_p = creg(bits(c, 9, 7));
+
+  switch (c & 0x3u) {
+  case 0b00:
+    switch (f3) {
+    case 0b000: { // C.ADDI4SPN -> addi rd', x2, nzuimm
+      const uint32_t imm = (bits(c, 12, 11) << 4) | (bits(c, 10, 7) << 6) |
+                           (bit(c, 6) << 2) | (bit(c, 5) << 3);
+      return imm == 0 ? 0 : enc_i(imm, 2, 0b000, rd_p, 0x13u);
+    }
+    case 0b010: { // C.LW -> lw rd', uimm(rs1')
+      const uint32_t imm =
+          (bits(c, 12, 10) << 3) | (bit(c, 6) << 2) | (bit(c, 5) << 6);
+      return enc_i(imm, rs1_p, 0b010, rd_p, 0x03u);
+    }
+    case 0b110: { // C.SW -> sw rs2', uimm(rs1')
+      const uint32_t imm =
+          (bits(c, 12, 10) << 3) | (bit(c, 6) << 2) | (bit(c, 5) << 6);
+      return enc_s(imm, rd_p, rs1_p, 0b010, 0x23u);
+    }
+    default:
+      return 0;
+    }
+
+  case 0b01:
+    switch (f3) {
+    case 0b000: // C.ADDI / C.NOP -> addi rd, rd, imm
+      return enc_i(imm_ci(c), rd, 0b000, rd, 0x13u);
+    case 0b001: // C.JAL -> jal x1, offset
+      return enc_j(imm_cj(c), 1);
+    case 0b010: // C.LI -> addi rd, x0, imm
+      return enc_i(imm_ci(c), 0, 0b000, rd, 0x13u);
+    case 0b011: {
+      if (rd == 2) { // C.ADDI16SP -> addi x2, x2, nzimm
+        const uint32_t imm =
+            sext((bit(c, 12) << 9) | (bit(c, 6) << 4) | (bit(c, 5) << 6) |
+                     (bits(c, 4, 3) << 7) | (bit(c, 2) << 5),
+                 10);
+        return imm == 0 ? 0 : enc_i(imm, 2, 0b000, 2, 0x13u);
+      }
+      // C.LUI -> lui rd, nzimm
+      const uint32_t imm = imm_ci(c);
+      return imm == 0 ? 0 : ((imm << 12) | (rd << 7) | 0x37u);
+    }
+    case 0b100: {
+      const uint32_t shamt = bits(c, 6, 2);
+      switch (bits(c, 11, 10)) {
+      case 0b00: // C.SRLI
+        return bit(c, 12) ? 0 : enc_i(shamt, rs1_p, 0b101, rs1_p, 0x13u);
+      case 0b01: // C.SRAI
+        return bit(c, 12)
+                   ? 0
+                   : enc_i(0x400u | shamt, rs1_p, 0b101, rs1_p, 0x13u);
+      case 0b10: // C.ANDI
+        return enc_i(imm_ci(c), rs1_p, 0b111, rs1_p, 0x13u);
+      default: {
+        if (bit(c, 12)) {
+          return 0; // C.SUBW / C.ADDW 仅 RV64
+        }
+        const uint32_t rs2_p = rd_p;
+        switch (bits(c, 6, 5)) {
+        case 0b00: // C.SUB
+          return enc_r(0x20u, rs2_p, rs1_p, 0b000, rs1_p);
+        case 0b01: // C.XOR
+          return enc_r(0, rs2_p, rs1_p, 0b100, rs1_p);
+        case 0b10: // C.OR
+          return enc_r(0, rs2_p, rs1_p, 0b110, rs1_p);
+        default: // C.AND
+          return enc_r(0, rs2_p, rs1_p, 0b111, rs1_p);
+        }
+      }
+      }
+    }
+    case 0b101: // C.J -> jal x0, offset
+      return enc_j(imm_cj(c), 0);
+    case 0b110: // C.BEQZ -> beq rs1', x0, offset
+      return enc_b(imm_cb(c), 0, rs1_p, 0b000);
+    default: // C.BNEZ -> bne rs1', x0, offset
+      return enc_b(imm_cb(c), 0, rs1_p, 0b001);
+    }
+
+  case 0b10:
+    switch (f3) {
+    case 0b000: // C.SLLI -> slli rd, rd, shamt
+      return bit(c, 12) ? 0 : enc_i(rs2, rd, 0b001, rd, 0x13u);
+    case 0b010: { // C.LWSP -> lw rd, uimm(x2)
+      const uint32_t imm =
+          (bit(c, 12) << 5) | (bits(c, 6, 4) << 2) | (bits(c, 3, 2) << 6);
+      return rd == 0 ? 0 : enc_i(imm, 2, 0b010, rd, 0x03u);
+    }
+    case 0b100:
+      if (!bit(c, 12)) {
+        if (rs2 == 0) { // C.JR -> jalr x0, 0(rs1)
+          return rd == 0 ? 0 : enc_i(0, rd, 0b000, 0, 0x67u);
+        }
+        return enc_r(0, rs2, 0, 0b000, rd); // C.MV -> add rd, x0, rs2
+      }
+      if (rs2 == 0) {
+        if (rd == 0) {
+          return 0x00100073u; // C.EBREAK
+        }
+        return enc_i(0, rd, 0b000, 1, 0x67u); // C.JALR -> jalr x1, 0(rs1)
+      }
+      return enc_r(0, rs2, rd, 0b000, rd); // C.ADD -> add rd, rd, rs2
+    case 0b110: { // C.SWSP -> sw rs2, uimm(x2)
+      const uint32_t imm = (bits(c, 12, 9) << 2) | (bits(c, 8, 7) << 6);
+      return enc_s(imm, rs2, 2, 0b010, 0x23u);
+    }
+    default:
+      return 0;
+    }
+
+  default:
+    return raw; // 非压缩指令原样返回
+  }
+}
@@ -5,7 +5,11 @@
 #include "FrontTop.h"
 #include "MMIO_Bus_AXI4.h"
 #include "MemSubsystem.h"
+#include "PhysMemory.h"
 #include "SimDDR.h"
+#include "SimThread.h"
+#include "diff.h"
+#include "oracle.h"
 using AxiInterconnectImpl = axi_interconnect::AXI_Interconnect;
 using AxiRouterImpl = axi_interconnect::AXI_Router_AXI4;
 using AxiDdrImpl = sim_ddr::SimDDR;
@@ -19,8 +23,18 @@ class SimCpu {
 public:
   ICacheMemPortReq icache_req{}; // 供 FrontTop 直接驱动的 ICache 请求端口（可选，取决于 CONFIG_ICACHE_USE_AXI_MEM_PORT）
   ICacheMemPortResp icache_resp{}; // 供 FrontTop 直接驱动的 ICache 响应端口（可选，取决于 CONFIG_ICACHE_USE
-  SimCpu() : back(&this->ctx), mem_subsystem(&this->ctx) {};
+  SimCpu()
+      : difftest(&this->ctx), oracle(&this->ctx, &difftest.dut_cpu),
+        back(&this->ctx), mem_subsystem(&this->ctx) {
+    ctx.cpu = this;
+    difftest.ref_cpu.timer_sink = &oracle.timer_queue;
+  };
   SimContext ctx;
+  // 本实例独占的物理内存、参考模型与 oracle 前端；同一进程可在不同线程上
+  // 各跑一个 SimCpu（线程绑定见 SimThread.h）。
+  PhysMemory pmem;
+  Difftest difftest;
+  Oracle oracle;
   BackTop back;
   FrontTop front;
   MemSubsystem mem_subsystem;
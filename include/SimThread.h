@@ -0,0 +1,36 @@
+#pragma once
+
+class SimContext;
+class PhysMemory;
+
+// ============================================================
+// 线程绑定的仿真实例
+//
+// 一个进程内可在不同线程上各跑一个 SimCpu，各实例的周期计数、物理内存、
+// difftest 与 oracle 状态都归 SimCpu 所有。持有 SimContext 的模块经 ctx
+// 访问本实例；调试宏、Assert、pmem_* 自由函数等没有 ctx 的叶子代码经此处
+// 读取当前线程绑定的实例。未绑定时 sim_now() 恒为 0，pmem_* 报错退出。
+// ============================================================
+namespace sim_thread {
+inline const long long unbound_clock = 0;
+inline thread_local SimContext *ctx = nullptr;
+inline thread_local const long long *clock = &unbound_clock;
+inline thread_local PhysMemory *pmem = nullptr;
+} // namespace sim_thread
+
+// 当前线程所绑定实例的仿真周期。
+inline long long sim_now() { return *sim_thread::clock; }
+
+// RAII：把 ctx 所属实例绑定到当前线程，析构时恢复原绑定。
+class SimThreadBinding {
+public:
+  explicit SimThreadBinding(SimContext *ctx);
+  ~SimThreadBinding();
+  SimThreadBinding(const SimThreadBinding &) = delete;
+  SimThreadBinding &operator=(const SimThreadBinding &) = delete;
+
+private:
+  SimContext *prev_ctx_;
+  const long long *prev_clock_;
+  PhysMemory *prev_pmem_;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+// libs/softfloat.a 未启用 THREAD_LOCAL，舍入模式/异常标志是进程级全局变量。
+// 异步 difftest 校验线程、同进程内的多个仿真实例都会在各自线程上并发
+// “设置舍入模式 + 运算”，需要串行化。extra_threads 记录除首个线程外
+// 仍在使用 softfloat 的线程数，须在这些线程启动前加上、回收后减去；
+// 为 0（单线程运行）时不加锁。
+namespace softfloat_guard {
+inline std::atomic<int> extra_threads{0};
+inline std::mutex lock;
+} // namespace softfloat_guard
+
+class SoftfloatGuard {
+public:
+  SoftfloatGuard()
+      : held_(softfloat_guard::extra_threads.load(std::memory_order_acquire) >
+              0) {
+    if (held_)
+      softfloat_guard::lock.lock();
+  }
+  ~SoftfloatGuard() {
+    if (held_)
+      softfloat_guard::lock.unlock();
+  }
+  SoftfloatGuard(const SoftfloatGuard &) = delete;
+  SoftfloatGuard &operator=(const SoftfloatGuard &) = delete;
+
+private:
+  bool held_;
+};
@@ -35,6 +35,10 @@ constexpr uint64_t div_round_u64(uint64_t numerator, uint64_t denominator) {
 //#define CONFIG_BPU
 #define CONFIG_TLB_MMU
 #define CONFIG_ORACLE_STEADY_FETCH_WIDTH
+// RV32C 压缩指令：ref 模型、oracle 前端与后端译码/提交按 2/4 字节变长指令
+// 处理。BPU 前端按半字划分取指槽位（FETCH_SLOT_BYTES），跨取指块 / 跨 cache
+// 行的 32 位指令在 front_top 预译码检查前拼接。
+#define CONFIG_RVC
 
 // ============================================================
 // Global Limits
@@ -323,6 +327,12 @@ constexpr int ROB_BANK_NUM = DECODE_WIDTH;
 constexpr int ROB_NUM = 2048;
 constexpr int ROB_LINE_NUM = ROB_NUM / ROB_BANK_NUM;
 
+// Rename 级 move elimination：addi rd, rs, 0 / add rd, rs, x0 等寄存器搬移
+// 直接把 rd 映射到 rs 的物理寄存器，xor/sub rd, rs, rs 等清零惯用法映射到
+// 常零 preg 0。被消除的指令不占 free list、不进 IQ，物理寄存器按 arch_RAT
+// 引用计数回收。注释掉 REN_MOVE_ELIM 关闭。
+#define REN_MOVE_ELIM
+
 // ============================================================
 // FTQ/INST BUFFER
 // ============================================================
@@ -331,6 +341,18 @@ constexpr int IDU_INST_BUFFER_SIZE = 1024;
 constexpr int FTQ_SIZE = 256;
 static_assert(is_power_of_two_u64(FTQ_SIZE), "FTQ_SIZE must be a power of two");
 
+// 宏融合（Idu）：同一取指块内相邻的 lui+addi、auipc+addi、slli+srli（零扩展）、
+// lui+load（绝对地址访存）合并为一个 uop，只占一个 ROB 项与一个目的 preg，
+// 提交时按两条指令推进 difftest。融合 uop 发生异常时不提交，按首条 PC 重取
+// 并在该 PC 处禁止一次融合。Idu 每拍最多查看 IDU_PEEK_WIDTH 条指令以填满
+// DECODE_WIDTH 个槽位。注释掉 CONFIG_MACRO_FUSION 关闭。
+#define CONFIG_MACRO_FUSION
+#ifdef CONFIG_MACRO_FUSION
+constexpr int IDU_PEEK_WIDTH = DECODE_WIDTH * 2;
+#else
+constexpr int IDU_PEEK_WIDTH = DECODE_WIDTH;
+#endif
+
 // ============================================================
 // Uop Capability Masks
 // ============================================================
@@ -525,6 +547,39 @@ constexpr int IQ_READY_NUM_WIDTH = bit_width_for_count(MAX_IQ_SIZE + 1);
 #define LSU_STLF
 constexpr int LOAD_WINDOWS_WIDTH = LSU_LDU_COUNT*3; 
 constexpr int STORE_WINDOWS_WIDTH = LSU_STA_COUNT*3;
+
+// Store-set 访存依赖预测（SSIT 按 PC 给出 store-set ID，LFST 记录每个 set
+// 最近分配的 store）。预测无依赖的 load 可越过地址未知的 older store 推测发射，
+// store 地址解析时检查违例并经 ROB flush_pipe 冲刷。注释掉 LSU_STORE_SET
+// 恢复等待全部 older store 地址就绪的保守顺序（需 LSU_STLF）。
+#define LSU_STORE_SET
+constexpr int SSIT_SIZE = 1024;
+constexpr int LFST_SIZE = 128;
+constexpr int SSIT_CLEAR_INTERVAL = 1000000; // 周期，定期清空 SSIT
+constexpr int SSIT_IDX_WIDTH = clog2(SSIT_SIZE);
+constexpr int SSID_WIDTH = clog2(LFST_SIZE);
+static_assert(is_power_of_two_u64(SSIT_SIZE),
+              "SSIT_SIZE must be a power of two");
+static_assert(is_power_of_two_u64(LFST_SIZE) && LFST_SIZE <= SSIT_SIZE,
+              "LFST_SIZE must be a power of two no larger than SSIT_SIZE");
+
+// L1D 硬件预取（MemSubSystem/DcachePrefetcher）：训练于 LSU 送入 RealDcache 的
+// load 请求流（PC 索引 stride + 顺序 stream），预取行经空闲 load 端口查 tag，
+// 未命中时占用空闲 MSHR，且优先级低于 demand miss。注释掉 CONFIG_L1D_PREFETCH
+// 关闭整个预取器。
+#define CONFIG_L1D_PREFETCH
+constexpr int L1D_PF_STRIDE_ENTRIES = 64; // 按 load PC 哈希组织
+constexpr int L1D_PF_PC_HASH_WIDTH = 16;   // Idu 折叠取指 PC 得到，低位索引、高位作 tag
+constexpr int L1D_PF_STREAM_ENTRIES = 8;
+constexpr int L1D_PF_DEGREE = 2;          // 每次触发最多产生的预取行数
+constexpr int L1D_PF_QUEUE_SIZE = 8;      // 待查 tag 的候选行
+constexpr int L1D_PF_TRACK_SIZE = 32;     // 已发出的预取行（去重 + 准确率统计）
+constexpr int L1D_PF_MSHR_RESERVE = 2;    // 预取分配后至少留给 demand 的空闲 MSHR
+static_assert(is_power_of_two_u64(L1D_PF_STRIDE_ENTRIES) &&
+                  L1D_PF_STRIDE_ENTRIES < (1 << L1D_PF_PC_HASH_WIDTH),
+              "L1D_PF_STRIDE_ENTRIES must be a power of two below 2^L1D_PF_PC_HASH_WIDTH");
+static_assert(L1D_PF_MSHR_RESERVE < DCACHE_MSHR_ENTRIES,
+              "L1D_PF_MSHR_RESERVE must leave MSHR entries for prefetch");
 // ============================================================
 // Global Sanity Checks
 // ============================================================
@@ -2,7 +2,7 @@
 #include <cstdint>
 #include <cstdio>
 
-extern long long sim_time; // Global simulation time
+#include "SimThread.h" // sim_now(): 当前线程所绑定实例的仿真周期
 
 #ifndef SIM_DEBUG_PRINT
 #define SIM_DEBUG_PRINT 0
@@ -18,8 +18,8 @@ extern long long sim_time; // Global simulation time
 
 #define SIM_DEBUG_PRINT_ACTIVE                                                \
   (SIM_DEBUG_PRINT &&                                                         \
-   sim_time >= static_cast<long long>(SIM_DEBUG_PRINT_CYCLE_BEGIN) &&        \
-   sim_time <= static_cast<long long>(SIM_DEBUG_PRINT_CYCLE_END))
+   sim_now() >= static_cast<long long>(SIM_DEBUG_PRINT_CYCLE_BEGIN) &&        \
+   sim_now() <= static_cast<long long>(SIM_DEBUG_PRINT_CYCLE_END))
 
 // ============================================================
 // [Debug Logging]
@@ -41,28 +41,28 @@ constexpr uint64_t MMU_LOG_START = LOG_START;
 // #define LOG_MMU_ENABLE
 
 #ifdef LOG_ENABLE
-#define BACKEND_LOG (sim_time >= BACKEND_LOG_START)
+#define BACKEND_LOG (sim_now() >= BACKEND_LOG_START)
 
 #ifdef LOG_MEMORY_ENABLE
-#define MEM_LOG (sim_time >= MEMORY_LOG_START)
+#define MEM_LOG (sim_now() >= MEMORY_LOG_START)
 #else
 #define MEM_LOG (0)
 #endif
 
 #ifdef LOG_LSU_MEM_ENABLE
-#define LSU_MEM_LOG (sim_time >= LSU_MEM_LOG_START)
+#define LSU_MEM_LOG (sim_now() >= LSU_MEM_LOG_START)
 #else
 #define LSU_MEM_LOG (0)
 #endif
 
 #ifdef LOG_DCACHE_ENABLE
-#define DCACHE_LOG (sim_time >= DCACHE_LOG_START)
+#define DCACHE_LOG (sim_now() >= DCACHE_LOG_START)
 #else
 #define DCACHE_LOG (0)
 #endif
 
 #ifdef LOG_MMU_ENABLE
-#define MMU_LOG (sim_time >= MMU_LOG_START)
+#define MMU_LOG (sim_now() >= MMU_LOG_START)
 #else
 #define MMU_LOG (0)
 #endif
@@ -1,12 +1,23 @@
 #include "SimCpu.h"
 #include "PhysMemory.h"
 #include "RISCV.h"
+#include "SimPoint.h"
+#include "SoftfloatGuard.h"
+#include "BranchTrace.h"
 #include "config.h"
 #include "diff.h"
+#include "oracle.h"
+#include <algorithm>
+#include <atomic>
 #include <csignal>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <getopt.h>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include <unistd.h>
 #include "RISCV.h"
 
@@ -15,7 +26,6 @@
 #endif
 
 using namespace std;
-extern RefCpu ref_cpu;
 
 // 1. 定义配置结构
 struct SimConfig {
@@ -26,8 +36,10 @@ struct SimConfig {
     REF_ONLY // 仅运行 Reference Model
   } mode = RUN;
 
-  // 目标文件路径
+  // 目标文件路径（多目标时每个实例一份配置副本）
   std::string target_file;
+  // 多目标时并行运行的 SimCpu 实例数（每个实例一个线程）
+  unsigned jobs = 1;
   // 存储 Fast-forward 的指令数/周期数
   uint64_t fast_forward_count = 0;
   // CKPT 模式下，O3 目标 warmup 步数（0~checkpoint interval）
@@ -35,11 +47,43 @@ struct SimConfig {
   bool ckpt_warmup_target_set = false;
   uint64_t max_commit_inst = static_cast<uint64_t>(MAX_COMMIT_INST);
   bool max_commit_inst_set = false;
+  // O3 主循环中 difftest 是否交给独立校验线程
+  bool async_difftest = false;
+
+  // REF 模式 SimPoint 流程：BBV 输出、区间长度与 checkpoint 打点
+  std::string bbv_file;
+  uint64_t simpoint_interval = 100000000;
+  std::vector<uint64_t> ckpt_at;
+  std::string simpoints_file;
+  std::string ckpt_dir = ".";
+  // REF 模式分支 trace 输出（bpu_eval 输入）
+  std::string br_trace_file;
+  // 非 BPU 构建：oracle 取指 trace 的录制输出与回放输入
+  std::string oracle_trace_record_file;
+  std::string oracle_trace_file;
+};
+
+// 长选项专用编号（无短选项）
+enum LongOnlyOption {
+  OPT_BBV = 256,
+  OPT_INTERVAL,
+  OPT_CKPT_AT,
+  OPT_SIMPOINTS,
+  OPT_CKPT_DIR,
+  OPT_BR_TRACE,
+  OPT_ORACLE_TRACE_RECORD,
+  OPT_ORACLE_TRACE,
+};
+
+struct RefCkptTarget {
+  uint64_t inst;    // 在第 inst 条指令执行完后打点
+  std::string name; // 输出文件名（位于 ckpt_dir 下）
 };
 
 // 2. 帮助信息更新
 void print_help(char *argv[]) {
-  std::cout << "Usage: " << argv[0] << " [options] <target_file>" << std::endl;
+  std::cout << "Usage: " << argv[0] << " [options] <target_file> [target_file...]"
+            << std::endl;
   std::cout << "\nOptions:" << std::endl;
   std::cout
       << "  -m, --mode <run|ckpt|fast|ref>  Set execution mode (default: run)"
@@ -56,6 +100,41 @@ void print_help(char *argv[]) {
          "(default: checkpoint_interval in CKPT mode, compile-time "
          "MAX_COMMIT_INST otherwise)"
       << std::endl;
+  std::cout << "  -a, --async-difftest  Run difftest on a separate checker "
+               "thread fed by a commit-record ring"
+            << std::endl;
+  std::cout << "  -j, --jobs <num>      With several target files, simulate "
+               "<num> of them at a time, each in its own SimCpu on its own "
+               "thread (default: 1)"
+            << std::endl;
+  std::cout << "\nREF mode SimPoint options:" << std::endl;
+  std::cout << "  --bbv <file>          Write SimPoint basic-block vectors "
+               "(gzip if <file> ends with .gz)"
+            << std::endl;
+  std::cout << "  --interval <num>      SimPoint interval length in "
+               "instructions (default: 100000000)"
+            << std::endl;
+  std::cout << "  --ckpt-at <n[,n...]>  Write a v3 checkpoint after <n> "
+               "instructions (ckpt_<n>.ckpt)"
+            << std::endl;
+  std::cout << "  --simpoints <file>    Write one checkpoint per SimPoint in "
+               "<file> (\"<interval_idx> <id>\" lines), one interval before "
+               "it (ckpt_sp<id>.ckpt)"
+            << std::endl;
+  std::cout << "  --ckpt-dir <dir>      Output directory for checkpoints "
+               "(default: .)"
+            << std::endl;
+  std::cout << "  --br-trace <file>     Write a branch trace for build/bpu_eval "
+               "(gzip if <file> ends with .gz)"
+            << std::endl;
+  std::cout << "\nOracle front-end options (RUN/CKPT/FAST, non-BPU build):"
+            << std::endl;
+  std::cout << "  --oracle-trace-record <file>  Record the oracle fetch stream "
+               "from the O3 start point and exit"
+            << std::endl;
+  std::cout << "  --oracle-trace <file>  Replay fetch groups from a recorded "
+               "trace instead of running the live oracle"
+            << std::endl;
   std::cout << "  -h, --help                  Show this message" << std::endl;
   std::cout << "\nExamples:" << std::endl;
   std::cout << "  Run Binary: " << argv[0] << " spec_mem/mcf.bin" << std::endl;
@@ -65,10 +144,43 @@ void print_help(char *argv[]) {
             << " --mode fast -f 1000000 spec_mem/mcf.bin" << std::endl;
   std::cout << "  Ref Only:   " << argv[0] << " --mode ref spec_mem/mcf.bin"
             << std::endl;
+  std::cout << "  SimPoint:   " << argv[0]
+            << " --mode ref --bbv mcf.bb.gz spec_mem/mcf.bin" << std::endl;
+  std::cout << "  Br Trace:   " << argv[0]
+            << " --mode ref --br-trace mcf.brt.gz spec_mem/mcf.bin" << std::endl;
+  std::cout << "              " << argv[0]
+            << " --mode ref --simpoints mcf.simpts --ckpt-dir checkpoint/mcf "
+               "spec_mem/mcf.bin"
+            << std::endl;
 }
 
-long long sim_time = 0;
-SimCpu cpu;
+// 解析 SimPoint 输出（每行 "<interval_idx> <simpoint_id>"）。
+// checkpoint 取在所选区间的前一个区间起点，使 CKPT 模式的 prewarm/warmup
+// 恰好覆盖前一个区间，测量窗口对齐所选区间；区间 0 只能从程序起点打点。
+bool load_simpoints(const std::string &path, uint64_t interval,
+                    std::vector<RefCkptTarget> &targets) {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream ss(line);
+    uint64_t idx = 0, id = 0;
+    if (!(ss >> idx >> id)) {
+      continue;
+    }
+    if (idx == 0) {
+      std::cerr << "Warning: simpoint " << id
+                << " selects interval 0, checkpoint taken at instruction 0 "
+                   "(no warmup room)."
+                << std::endl;
+    }
+    targets.push_back({idx == 0 ? 0 : (idx - 1) * interval,
+                       "ckpt_sp" + std::to_string(id) + ".ckpt"});
+  }
+  return true;
+}
 
 namespace {
 volatile std::sig_atomic_t g_sigint_requested = 0;
@@ -101,13 +213,14 @@ void install_signal_handlers() {
   sigaction(SIGINT, &sa, nullptr);
 }
 
-bool handle_pending_sigint() {
+bool handle_pending_sigint(SimCpu &cpu) {
   if (g_sigint_requested == 0) {
     return false;
   }
 
 #if defined(LOG_ENABLE) && defined(LOG_LSU_MEM_ENABLE)
-  std::cout << "[sim] SIGINT observed at cycle " << std::dec << sim_time
+  std::cout << "[sim] SIGINT observed at cycle " << std::dec
+            << cpu.ctx.sim_time
             << ", printing debug dump." << std::endl;
   // deadlock_debug::dump_all();
 #endif
@@ -116,16 +229,27 @@ bool handle_pending_sigint() {
 }
 } // namespace
 
-void exit_handler() {
-  if (cpu.ctx.exit_reason == ExitReason::NONE) {
+void print_exit_stats(SimContext &ctx) {
+  if (ctx.exit_reason == ExitReason::NONE) {
     return;
   }
   std::cout << "\033[38;5;34m-----------------------------\033[0m" << std::endl;
   std::cout << "Simulation Exited. Printing Perf Stats..." << std::endl;
-  cpu.ctx.perf.perf_print();
+  ctx.perf.perf_print();
   std::cout << "\033[38;5;34m-----------------------------\033[0m" << std::endl;
 }
 
+// 仿真中途 exit()（Assert、超时等）时打印调用线程所绑定实例的统计。
+void exit_handler() {
+  if (sim_thread::ctx != nullptr) {
+    print_exit_stats(*sim_thread::ctx);
+  }
+}
+
+int run_simulation(SimConfig &config, SimCpu &cpu);
+int run_simulations(const SimConfig &config,
+                    const std::vector<std::string> &targets);
+
 int main(int argc, char *argv[]) {
   atexit(exit_handler);
   install_signal_handlers();
@@ -138,6 +262,16 @@ int main(int argc, char *argv[]) {
       {"fast-forward", required_argument, 0, 'f'}, // 快进参数
       {"warmup", required_argument, 0, 'w'},
       {"max-commit", required_argument, 0, 'c'},
+      {"async-difftest", no_argument, 0, 'a'},
+      {"jobs", required_argument, 0, 'j'},
+      {"bbv", required_argument, 0, OPT_BBV},
+      {"interval", required_argument, 0, OPT_INTERVAL},
+      {"ckpt-at", required_argument, 0, OPT_CKPT_AT},
+      {"simpoints", required_argument, 0, OPT_SIMPOINTS},
+      {"ckpt-dir", required_argument, 0, OPT_CKPT_DIR},
+      {"br-trace", required_argument, 0, OPT_BR_TRACE},
+      {"oracle-trace-record", required_argument, 0, OPT_ORACLE_TRACE_RECORD},
+      {"oracle-trace", required_argument, 0, OPT_ORACLE_TRACE},
       {"help", no_argument, 0, 'h'},
       {0, 0, 0, 0}};
 
@@ -145,7 +279,7 @@ int main(int argc, char *argv[]) {
   int option_index = 0;
 
   // --- A. 解析命令行参数 ---
-  while ((opt = getopt_long(argc, argv, "m:f:w:c:h", long_options,
+  while ((opt = getopt_long(argc, argv, "m:f:w:c:aj:h", long_options,
                             &option_index)) != -1) {
     switch (opt) {
     case 'm': {
@@ -213,6 +347,72 @@ int main(int argc, char *argv[]) {
       }
       break;
     }
+    case 'a':
+      config.async_difftest = true;
+      break;
+    case 'j': {
+      long jobs = 0;
+      try {
+        jobs = std::stol(optarg);
+      } catch (const std::exception &e) {
+        jobs = 0;
+      }
+      if (jobs <= 0) {
+        std::cerr << "Error: --jobs must be a positive integer, got: "
+                  << optarg << std::endl;
+        return 1;
+      }
+      config.jobs = static_cast<unsigned>(jobs);
+      break;
+    }
+    case OPT_BBV:
+      config.bbv_file = optarg;
+      break;
+    case OPT_BR_TRACE:
+      config.br_trace_file = optarg;
+      break;
+    case OPT_ORACLE_TRACE_RECORD:
+      config.oracle_trace_record_file = optarg;
+      break;
+    case OPT_ORACLE_TRACE:
+      config.oracle_trace_file = optarg;
+      break;
+    case OPT_INTERVAL: {
+      try {
+        config.simpoint_interval = std::stoull(optarg);
+      } catch (const std::exception &e) {
+        config.simpoint_interval = 0;
+      }
+      if (config.simpoint_interval == 0 || optarg[0] == '-') {
+        std::cerr << "Error: --interval must be a positive integer, got: "
+                  << optarg << std::endl;
+        return 1;
+      }
+      break;
+    }
+    case OPT_CKPT_AT: {
+      std::stringstream ss(optarg);
+      std::string item;
+      while (std::getline(ss, item, ',')) {
+        try {
+          if (item.empty() || item[0] == '-') {
+            throw std::invalid_argument(item);
+          }
+          config.ckpt_at.push_back(std::stoull(item));
+        } catch (const std::exception &e) {
+          std::cerr << "Error: Invalid number for --ckpt-at: " << item
+                    << std::endl;
+          return 1;
+        }
+      }
+      break;
+    }
+    case OPT_SIMPOINTS:
+      config.simpoints_file = optarg;
+      break;
+    case OPT_CKPT_DIR:
+      config.ckpt_dir = optarg;
+      break;
     case 'h':
       print_help(argv);
       return 0;
@@ -223,18 +423,27 @@ int main(int argc, char *argv[]) {
   }
 
   // --- B. 解析位置参数 (Target File) ---
-  if (optind < argc) {
-    config.target_file = argv[optind];
-    if (optind + 1 < argc) {
-      std::cerr
-          << "Warning: Multiple files provided. Only using the first one: "
-          << config.target_file << std::endl;
-    }
-  } else {
+  if (optind >= argc) {
     std::cerr << "Error: Missing target file argument." << std::endl;
     print_help(argv);
     return 1;
   }
+  const std::vector<std::string> targets(argv + optind, argv + argc);
+  config.target_file = targets[0];
+  if (targets.size() > 1 &&
+      (!config.bbv_file.empty() || !config.br_trace_file.empty() ||
+       !config.ckpt_at.empty() || !config.simpoints_file.empty() ||
+       !config.oracle_trace_record_file.empty())) {
+    std::cerr << "Error: --bbv/--br-trace/--ckpt-at/--simpoints/"
+                 "--oracle-trace-record write per-run output files and take "
+                 "a single target file."
+              << std::endl;
+    return 1;
+  }
+  if (targets.size() == 1 && config.jobs > 1) {
+    std::cerr << "Warning: --jobs (-j) is ignored with a single target file."
+              << std::endl;
+  }
 
   // 快速模式逻辑校验
   if (config.mode == SimConfig::FAST) {
@@ -251,16 +460,120 @@ int main(int argc, char *argv[]) {
                 << std::endl;
     }
   }
+  if (config.mode != SimConfig::REF_ONLY &&
+      (!config.bbv_file.empty() || !config.ckpt_at.empty() ||
+       !config.simpoints_file.empty() || !config.br_trace_file.empty())) {
+    std::cerr << "Warning: --bbv/--ckpt-at/--simpoints/--br-trace are ignored "
+                 "unless in "
+                 "REF mode."
+              << std::endl;
+  }
+  const bool oracle_trace_opt = !config.oracle_trace_record_file.empty() ||
+                                !config.oracle_trace_file.empty();
+#ifdef CONFIG_BPU
+  if (oracle_trace_opt) {
+    std::cerr << "Warning: --oracle-trace/--oracle-trace-record are ignored "
+                 "with CONFIG_BPU."
+              << std::endl;
+    config.oracle_trace_record_file.clear();
+    config.oracle_trace_file.clear();
+  }
+#else
+  if (config.mode == SimConfig::REF_ONLY && oracle_trace_opt) {
+    std::cerr << "Warning: --oracle-trace/--oracle-trace-record are ignored "
+                 "in REF mode."
+              << std::endl;
+    config.oracle_trace_record_file.clear();
+    config.oracle_trace_file.clear();
+  }
+  if (!config.oracle_trace_record_file.empty() &&
+      !config.oracle_trace_file.empty()) {
+    std::cerr << "Error: --oracle-trace and --oracle-trace-record are "
+                 "mutually exclusive."
+              << std::endl;
+    return 1;
+  }
+#endif
   if (config.mode != SimConfig::CKPT && config.ckpt_warmup_target_set) {
     std::cerr << "Warning: --warmup (-w) is ignored unless in CKPT "
                  "mode."
               << std::endl;
   }
 
-  if (!pmem_init()) {
+  if (targets.size() > 1) {
+    return run_simulations(config, targets);
+  }
+
+  // SimCpu 内含参考模型等大对象，放在堆上；实例在本线程上绑定后运行。
+  auto cpu = std::make_unique<SimCpu>();
+  SimThreadBinding bind(&cpu->ctx);
+  const int rc = run_simulation(config, *cpu);
+  print_exit_stats(cpu->ctx);
+  return rc;
+}
+
+// 多目标：每个目标一个 SimCpu，至多 config.jobs 个线程各自绑定实例并行运行。
+// 运行期输出（UART、进度）按行交错，各线程共享 cout 的格式状态，运行路径
+// 上不再切换 dec/hex；统计在全部结束后按目标顺序打印。
+// 仿真中途 exit()（Assert、超时）仍结束整个进程。
+int run_simulations(const SimConfig &config,
+                    const std::vector<std::string> &targets) {
+  std::vector<std::unique_ptr<SimCpu>> cpus(targets.size());
+  std::vector<int> rcs(targets.size(), 0);
+  std::atomic<size_t> next_target{0};
+  auto worker = [&]() {
+    for (size_t i = next_target++; i < targets.size(); i = next_target++) {
+      SimConfig run_config = config;
+      run_config.target_file = targets[i];
+      cpus[i] = std::make_unique<SimCpu>();
+      SimThreadBinding bind(&cpus[i]->ctx);
+      rcs[i] = run_simulation(run_config, *cpus[i]);
+    }
+  };
+
+  const unsigned jobs =
+      std::min<unsigned>(config.jobs, static_cast<unsigned>(targets.size()));
+  // 主线程也作为 worker 参与
+  softfloat_guard::extra_threads.fetch_add(static_cast<int>(jobs) - 1,
+                                           std::memory_order_acq_rel);
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < jobs; t++) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto &th : pool) {
+    th.join();
+  }
+  softfloat_guard::extra_threads.fetch_sub(static_cast<int>(jobs) - 1,
+                                           std::memory_order_acq_rel);
+
+  int rc = 0;
+  for (size_t i = 0; i < targets.size(); i++) {
+    SimThreadBinding bind(&cpus[i]->ctx);
+    std::cout << "[File] " << targets[i] << " -> exit code " << rcs[i]
+              << std::endl;
+    print_exit_stats(cpus[i]->ctx);
+    if (rc == 0) {
+      rc = rcs[i];
+    }
+  }
+  return rc;
+}
+
+int run_simulation(SimConfig &config, SimCpu &cpu) {
+  RefCpu &ref_cpu = cpu.difftest.ref_cpu;
+  long long &sim_time = cpu.ctx.sim_time;
+
+  if (!cpu.pmem.init()) {
     std::cerr << "Error: Failed to allocate memory!" << std::endl;
     exit(1);
   }
+#ifndef CONFIG_BPU
+  // 必须先于 cpu.init()/load_image：trace 模式下不再初始化 oracle RefCpu
+  if (!config.oracle_trace_file.empty()) {
+    cpu.oracle.set_trace(config.oracle_trace_file);
+  }
+#endif
   cpu.init();
 
   // --- D. 模拟器启动逻辑 ---
@@ -315,14 +628,11 @@ int main(int argc, char *argv[]) {
                 << " steps..." << std::endl;
       ref_cpu.uart_print = false;
       ref_cpu.ref_only = true;
-      for (; ref_prewarm_done < ref_prewarm_target; ref_prewarm_done++) {
-        difftest_step(false);
-        if (ref_cpu.sim_end) {
-          cpu.ctx.exit_reason =
-              (ref_cpu.Instruction == INST_WFI) ? ExitReason::WFI
-                                                : ExitReason::EBREAK;
-          break;
-        }
+      ref_prewarm_done = ref_cpu.run(ref_prewarm_target);
+      if (ref_cpu.sim_end) {
+        cpu.ctx.exit_reason =
+            (ref_cpu.Instruction == INST_WFI) ? ExitReason::WFI
+                                              : ExitReason::EBREAK;
       }
       ref_cpu.ref_only = false;
       std::cout << "[Run] Ref prewarm done: " << ref_prewarm_done
@@ -370,14 +680,11 @@ int main(int argc, char *argv[]) {
     ref_cpu.uart_print = true;
     ref_cpu.ref_only = true;
 
-    for (uint64_t i = 0; i < config.fast_forward_count; i++) {
-      difftest_step(false);
-      if (ref_cpu.sim_end) {
-        cpu.ctx.exit_reason =
-            (ref_cpu.Instruction == INST_WFI) ? ExitReason::WFI
-                                              : ExitReason::EBREAK;
-        break;
-      }
+    ref_cpu.run(config.fast_forward_count);
+    if (ref_cpu.sim_end) {
+      cpu.ctx.exit_reason =
+          (ref_cpu.Instruction == INST_WFI) ? ExitReason::WFI
+                                            : ExitReason::EBREAK;
     }
     ref_cpu.ref_only = false;
 
@@ -401,20 +708,99 @@ int main(int argc, char *argv[]) {
 
     std::cout << "[Debug] Running Reference Model Standalone..." << std::endl;
 
+    // SimPoint：checkpoint 打点目标（按指令数升序）与 BBV 采集
+    std::vector<RefCkptTarget> ckpt_targets;
+    for (uint64_t n : config.ckpt_at) {
+      ckpt_targets.push_back({n, "ckpt_" + std::to_string(n) + ".ckpt"});
+    }
+    if (!config.simpoints_file.empty() &&
+        !load_simpoints(config.simpoints_file, config.simpoint_interval,
+                        ckpt_targets)) {
+      std::cerr << "Error: Could not open simpoints file "
+                << config.simpoints_file << std::endl;
+      cpu.pmem.release();
+      return 1;
+    }
+    std::stable_sort(ckpt_targets.begin(), ckpt_targets.end(),
+                     [](const RefCkptTarget &a, const RefCkptTarget &b) {
+                       return a.inst < b.inst;
+                     });
+    size_t ckpt_next = 0;
+
+    SimPointBbv bbv;
+    const bool bbv_on = !config.bbv_file.empty();
+    if (bbv_on) {
+      if (!bbv.open(config.bbv_file)) {
+        std::cerr << "Error: Could not open BBV file " << config.bbv_file
+                  << std::endl;
+        cpu.pmem.release();
+        return 1;
+      }
+      bbv.reset_start(ref_cpu.state.pc);
+      ref_cpu.bbv = &bbv;
+      std::cout << "[SimPoint] BBV -> " << config.bbv_file
+                << ", interval = " << config.simpoint_interval << std::endl;
+    }
+
+    BranchTraceWriter br_trace;
+    const bool br_trace_on = !config.br_trace_file.empty();
+    if (br_trace_on) {
+      if (!br_trace.open(config.br_trace_file, ref_cpu.state.pc)) {
+        std::cerr << "Error: Could not open branch trace file "
+                  << config.br_trace_file << std::endl;
+        cpu.pmem.release();
+        return 1;
+      }
+      ref_cpu.br_trace = &br_trace;
+      std::cout << "[BrTrace] -> " << config.br_trace_file << std::endl;
+    }
+
     uint64_t ref_commit_cnt = 0;
 
+    // 分批执行：批边界对齐进度打印周期与提交上限，SIGINT 按批响应。
+    constexpr uint64_t kRefRunChunk = 1ull << 20;
+    constexpr uint64_t kRefProgressPeriod = 10000000;
     sim_time = 0;
     while (sim_time < (long long)MAX_SIM_TIME) { // Or a large limit
-      difftest_step(false);
-      ref_commit_cnt++;
-      sim_time++;
-      if (handle_pending_sigint()) {
-        pmem_release();
+      for (; ckpt_next < ckpt_targets.size() &&
+             ckpt_targets[ckpt_next].inst <= ref_commit_cnt;
+           ++ckpt_next) {
+        cpu.difftest.save_checkpoint(config.ckpt_dir + "/" +
+                                         ckpt_targets[ckpt_next].name,
+                                     config.simpoint_interval);
+      }
+      if (!ckpt_targets.empty() && ckpt_next == ckpt_targets.size() &&
+          !bbv_on && !br_trace_on) {
+        std::cout << "[sim][REF] All " << ckpt_targets.size()
+                  << " checkpoints written." << std::endl;
+        break;
+      }
+      uint64_t chunk = kRefRunChunk;
+      chunk = std::min<uint64_t>(chunk, kRefProgressPeriod -
+                                            sim_time % kRefProgressPeriod);
+      chunk = std::min<uint64_t>(chunk,
+                                 config.max_commit_inst - ref_commit_cnt);
+      chunk = std::min<uint64_t>(chunk, MAX_SIM_TIME - sim_time);
+      if (ckpt_next < ckpt_targets.size()) {
+        chunk = std::min<uint64_t>(chunk, ckpt_targets[ckpt_next].inst -
+                                              ref_commit_cnt);
+      }
+      if (bbv_on) {
+        chunk = std::min<uint64_t>(
+            chunk, config.simpoint_interval -
+                       ref_commit_cnt % config.simpoint_interval);
+      }
+      ref_commit_cnt += ref_cpu.run(chunk, REF_RUN_TICK_SIM_TIME);
+      if (bbv_on && ref_commit_cnt % config.simpoint_interval == 0) {
+        bbv.end_interval();
+      }
+      if (handle_pending_sigint(cpu)) {
+        cpu.pmem.release();
         return 130;
       }
       if (ref_commit_cnt >= config.max_commit_inst) {
         cpu.ctx.exit_reason = ExitReason::SIMPOINT;
-        std::cout << "[sim][REF] Reached MAX_COMMIT_INST=" << std::dec
+        std::cout << "[sim][REF] Reached MAX_COMMIT_INST="
                   << config.max_commit_inst << std::endl;
         break;
       }
@@ -424,20 +810,71 @@ int main(int argc, char *argv[]) {
                                               : ExitReason::EBREAK;
         break;
       }
-      if (sim_time % 10000000 == 0) {
-        cout << dec << sim_time << endl;
+      if (sim_time % kRefProgressPeriod == 0) {
+        cout << sim_time << endl;
       }
     }
+    if (bbv_on) {
+      ref_cpu.bbv = nullptr;
+      bbv.close();
+      std::cout << "[SimPoint] " << bbv.interval_count() << " intervals, "
+                << bbv.bb_count() << " basic blocks written to "
+                << config.bbv_file << std::endl;
+    }
+    if (br_trace_on) {
+      ref_cpu.br_trace = nullptr;
+      br_trace.close();
+      std::cout << "[BrTrace] " << br_trace.record_count()
+                << " records written to " << config.br_trace_file << std::endl;
+    }
+    if (ckpt_next < ckpt_targets.size()) {
+      std::cerr << "Warning: " << ckpt_targets.size() - ckpt_next
+                << " checkpoint(s) beyond the end of execution were not "
+                   "written."
+                << std::endl;
+    }
     std::cout << "[Debug] Ref Model Run Completed." << std::endl;
-    pmem_release();
+    cpu.pmem.release();
     return 0;
   }
 
+#ifndef CONFIG_BPU
+  if (!config.oracle_trace_record_file.empty()) {
+    // O3 提交总数（CKPT 含 warmup）外加一个 ROB 的错误路径余量
+    uint64_t record_target = config.max_commit_inst + 4 * ROB_NUM;
+    if (config.mode == SimConfig::CKPT) {
+      record_target += config.ckpt_warmup_target;
+    }
+    uint64_t records = 0;
+    if (cpu.ctx.exit_reason == ExitReason::NONE) {
+      records = cpu.oracle.record_trace(config.oracle_trace_record_file,
+                                        record_target);
+    }
+    std::cout << "[OracleTrace] " << records << " records written to "
+              << config.oracle_trace_record_file << std::endl;
+    cpu.pmem.release();
+    return 0;
+  }
+#endif
+
+#ifdef CONFIG_DIFFTEST
+  if (config.async_difftest && cpu.ctx.exit_reason == ExitReason::NONE) {
+    std::cout << "[Difftest] Async checker thread enabled, ring = "
+              << DIFFTEST_ASYNC_RING_SIZE << " commits." << std::endl;
+    cpu.difftest.async_start();
+  }
+#else
+  if (config.async_difftest) {
+    std::cerr << "Warning: --async-difftest is ignored without CONFIG_DIFFTEST."
+              << std::endl;
+  }
+#endif
+
   // 主循环
   if (cpu.ctx.exit_reason == ExitReason::NONE) {
     for (sim_time = 0; sim_time < (long long)MAX_SIM_TIME; sim_time++) {
       if (sim_time % 10000000 == 0) {
-        cout << dec << sim_time << endl;
+        cout << sim_time << endl;
       }
       BE_LOG("************************************************************** "
              "cycle: %lld "
@@ -446,14 +883,19 @@ int main(int argc, char *argv[]) {
 
       cpu.cycle();
 
-    if (handle_pending_sigint()) {
-        pmem_release();
+      if (cpu.difftest.async_poll()) {
+        cpu.pmem.release();
+        return 1;
+      }
+
+    if (handle_pending_sigint(cpu)) {
+        cpu.pmem.release();
         return 130;
       }
 
     if (cpu.ctx.perf.commit_num >= config.max_commit_inst) {
         cpu.ctx.exit_reason = ExitReason::SIMPOINT;
-        std::cout << "[sim] Reached MAX_COMMIT_INST=" << std::dec
+        std::cout << "[sim] Reached MAX_COMMIT_INST="
                   << config.max_commit_inst << std::endl;
       }
 
@@ -463,7 +905,11 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  pmem_release();
+  if (!cpu.difftest.async_finish()) {
+    cpu.pmem.release();
+    return 1;
+  }
+  cpu.pmem.release();
 
   if (sim_time != MAX_SIM_TIME) {
     cout << "\033[38;5;34m-----------------------------\033[0m" << endl;
@@ -8,6 +8,8 @@
 #include "front-end/host_profile.h"
 #include "front_IO.h"
 #include "front_module.h"
+#include "oracle.h"
+#include "SimThread.h"
 #include "util.h"
 #include <cstdint>
 #include <cstdio>
@@ -368,12 +370,14 @@ void SimCpu::difftest_prepare(InstEntry *inst_entry, bool *skip) {
   Assert(skip != nullptr && "SimCpu::difftest_prepare: skip is null");
   BackTop *back = &this->back;
   InstInfo *inst = &inst_entry->uop;
+  CPU_state &dut_cpu = difftest.dut_cpu;
 
   for (int i = 0; i < ARF_NUM; i++) {
     // With same-cycle EXU->ROB completion, commit-side architectural mapping
     // (arch_RAT_1) can point to a preg whose value is produced in this cycle's
-    // comb writeback path. Use reg_file_1 to observe the up-to-date comb state.
-    dut_cpu.gpr[i] = back->prf->reg_file_1[back->rename->arch_RAT_1[i]];
+    // comb writeback path. Use reg_file.next() to observe the up-to-date comb
+    // state.
+    dut_cpu.gpr[i] = back->prf->reg_file.next(back->rename->arch_RAT_1[i]);
   }
 
   if (inst->tma.mem_commit_is_store && !inst->page_fault_store) {
@@ -415,7 +419,7 @@ void SimCpu::difftest_prepare(InstEntry *inst_entry, bool *skip) {
   dut_cpu.pc = (is_branch(inst->type) || inst->type == JAL ||
                 back->rob->out.rob_bcast->flush)
                    ? inst_entry->uop.diag_val
-                   : inst->dbg.pc + 4;
+                   : inst->dbg.pc + (inst->is_rvc ? 2 : 4);
   dut_cpu.instruction = inst->dbg.instruction;
   dut_cpu.page_fault_inst = inst->page_fault_inst;
   dut_cpu.page_fault_load = inst->page_fault_load;
@@ -434,7 +438,7 @@ void SimContext::run_commit_inst(InstEntry *inst_entry) {
   cpu->commit_sync(&inst_entry->uop);
 }
 
-void SimContext::run_difftest_inst(InstEntry *inst_entry) {
+void SimContext::run_difftest_inst(InstEntry *inst_entry, bool check) {
   Assert(cpu != nullptr && "SimContext::run_difftest_inst: cpu is null");
   Assert(inst_entry != nullptr &&
          "SimContext::run_difftest_inst: inst_entry is null");
@@ -442,15 +446,37 @@ void SimContext::run_difftest_inst(InstEntry *inst_entry) {
          "SimContext::run_difftest_inst: inst_entry is not valid");
   bool skip = false;
   cpu->difftest_prepare(inst_entry, &skip);
+  Difftest &difftest = cpu->difftest;
+  if (difftest.async_active()) {
+    const InstInfo &uop = inst_entry->uop;
+    const bool gpr_write = uop.dest_en && uop.dest_areg < ARF_NUM;
+    difftest.async_push(skip, check, gpr_write ? static_cast<int>(uop.dest_areg) : 0);
+    return;
+  }
   if (skip) {
-    difftest_skip();
+    difftest.skip();
   } else {
     // Keep commit-time difftest checking enabled in real-BPU runs. Skip is
-    // reserved for explicitly unsupported sideband cases only.
-    difftest_step(true);
+    // reserved for explicitly unsupported sideband cases only. check=false
+    // only for the first half of a macro-fused uop.
+    difftest.step(check);
   }
 }
 
+SimThreadBinding::SimThreadBinding(SimContext *ctx)
+    : prev_ctx_(sim_thread::ctx), prev_clock_(sim_thread::clock),
+      prev_pmem_(sim_thread::pmem) {
+  sim_thread::ctx = ctx;
+  sim_thread::clock = &ctx->sim_time;
+  sim_thread::pmem = (ctx->cpu != nullptr) ? &ctx->cpu->pmem : nullptr;
+}
+
+SimThreadBinding::~SimThreadBinding() {
+  sim_thread::ctx = prev_ctx_;
+  sim_thread::clock = prev_clock_;
+  sim_thread::pmem = prev_pmem_;
+}
+
 // 复位逻辑
 void SimCpu::init() {
   const auto llc_cfg = make_default_llc_config();
@@ -463,7 +489,7 @@ void SimCpu::init() {
 
   // 第三阶段：集中完成跨模块连线
   mem_subsystem.csr = back.csr;
-  mem_subsystem.memory = p_memory;
+  mem_subsystem.memory = pmem.ram_ptr();
   mem_subsystem.peripheral_req = back.lsu_peripheral_req_io;
   mem_subsystem.peripheral_resp = back.lsu_peripheral_resp_io;
   mem_subsystem.set_ptw_coherent_source(back.lsu);
@@ -893,7 +919,7 @@ void SimCpu::back2front_comb() {
       front.in.actual_target[i] =
           (is_branch(inst->type) || inst->type == JAL || inst->type == JALR)
               ? back.out.commit_entry[i].uop.diag_val
-              : inst->dbg.pc + 4;
+              : inst->dbg.pc + (inst->is_rvc ? 2 : 4);
       int br_type = BR_NONCTL;
       if (is_branch(inst->type)) {
         br_type = BR_DIRECT;
@@ -911,6 +937,7 @@ void SimCpu::back2front_comb() {
       }
 
       front.in.actual_br_type[i] = br_type;
+      front.in.actual_is_rvc[i] = inst->is_rvc;
       front.in.alt_pred[i] = alt_pred;
       front.in.altpcpn[i] = altpcpn;
       front.in.pcpn[i] = pcpn;
@@ -942,4 +969,19 @@ void SimCpu::back2front_comb() {
   if (back.out.mispred || back.out.flush) {
     front.in.refetch_address = back.out.redirect_pc;
   }
+
+#ifndef CONFIG_BPU
+  // trace 驱动 oracle 按提交条数定位 refetch 对应的记录。
+  int retired = 0;
+  // 宏融合 uop 提交两条指令（中断时整条未执行）。
+  for (int i = 0; i < COMMIT_WIDTH; i++) {
+    if (!back.out.commit_entry[i].valid) {
+      continue;
+    }
+    const bool fused = back.out.commit_entry[i].uop.fuse_kind != FUSE_NONE &&
+                       !back.rob->out.rob_bcast->interrupt;
+    retired += fused ? 2 : 1;
+  }
+  oracle.retire(retired);
+#endif
 }
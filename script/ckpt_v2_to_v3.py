@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""把 SimpleSim 生成的 v2 checkpoint（整体 gzip）转换为 v3 分块格式。
+
+v3 布局见 include/Checkpoint.h：RAM 按 --chunk-kb 切块独立 zlib 压缩，
+全零块省略；IO 区只保留非零字。v2 不记录特权级，转换结果固定为 U 态。
+
+用法:
+  python3 script/ckpt_v2_to_v3.py in.gz out.ckpt [--chunk-kb 1024] [-j N]
+  python3 script/ckpt_v2_to_v3.py --batch <v2_dir> <v3_dir> [-j N]
+"""
+import argparse
+import gzip
+import os
+import struct
+import sys
+import zlib
+from concurrent.futures import ThreadPoolExecutor
+
+CKPT_MAGIC = 0x006D6552
+HEADER = struct.Struct("<4I")  # magic, version, ram_size, io_range_count
+CPU_STATE = struct.Struct("<32I21II3I??2xI")  # CkptCpuState（236B）
+V3_META = struct.Struct("<4IQ")  # chunk_bytes, chunk_count, io_word_count, privilege, interval
+IO_RANGE = struct.Struct("<2I")
+IO_WORD = struct.Struct("<2I")
+CHUNK_ENTRY = struct.Struct("<IIQ")  # index, comp_bytes, offset
+PRIV_U = 0
+
+
+def read_exact(f, n):
+    data = f.read(n)
+    if len(data) != n:
+        raise ValueError("unexpected EOF in v2 checkpoint")
+    return data
+
+
+def convert(src, dst, chunk_bytes, jobs, level):
+    with gzip.open(src, "rb") as f:
+        magic, version, ram_size, io_count = HEADER.unpack(read_exact(f, HEADER.size))
+        if magic != CKPT_MAGIC or version != 2:
+            raise ValueError(f"{src}: not a v2 checkpoint (magic=0x{magic:08x}, version={version})")
+        if ram_size % chunk_bytes != 0:
+            raise ValueError(f"chunk size {chunk_bytes} does not divide RAM size {ram_size}")
+        cpu_state = read_exact(f, CPU_STATE.size)
+        (interval,) = struct.unpack("<Q", read_exact(f, 8))
+
+        zero = bytes(chunk_bytes)
+        stored = []  # (index, future)
+        with ThreadPoolExecutor(max_workers=jobs) as pool:  # zlib 压缩时释放 GIL
+            for idx in range(ram_size // chunk_bytes):
+                chunk = read_exact(f, chunk_bytes)
+                if chunk != zero:
+                    stored.append((idx, pool.submit(zlib.compress, chunk, level)))
+            payloads = [(idx, fut.result()) for idx, fut in stored]
+
+        ranges, io_words = [], []
+        for _ in range(io_count):
+            base, size = IO_RANGE.unpack(read_exact(f, IO_RANGE.size))
+            raw = read_exact(f, size)
+            ranges.append((base, size))
+            for off in range(0, size - size % 4, 4):
+                (word,) = struct.unpack_from("<I", raw, off)
+                if word:
+                    io_words.append((base + off, word))
+
+    offset = (HEADER.size + V3_META.size + CPU_STATE.size + IO_RANGE.size * len(ranges)
+              + IO_WORD.size * len(io_words) + CHUNK_ENTRY.size * len(payloads))
+    tmp = dst + ".tmp"
+    with open(tmp, "wb") as out:
+        out.write(HEADER.pack(CKPT_MAGIC, 3, ram_size, io_count))
+        out.write(V3_META.pack(chunk_bytes, len(payloads), len(io_words), PRIV_U, interval))
+        out.write(cpu_state)
+        for r in ranges:
+            out.write(IO_RANGE.pack(*r))
+        for w in io_words:
+            out.write(IO_WORD.pack(*w))
+        for idx, comp in payloads:
+            out.write(CHUNK_ENTRY.pack(idx, len(comp), offset))
+            offset += len(comp)
+        for _, comp in payloads:
+            out.write(comp)
+    os.replace(tmp, dst)
+    total = ram_size // chunk_bytes
+    print(f"{src} -> {dst}: {len(payloads)}/{total} chunks stored, "
+          f"{len(io_words)} io words, {os.path.getsize(dst) / (1 << 20):.1f} MB")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("src")
+    ap.add_argument("dst")
+    ap.add_argument("--batch", action="store_true", help="src/dst 为目录，转换其中所有 .gz")
+    ap.add_argument("--chunk-kb", type=int, default=1024)
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1)
+    ap.add_argument("--level", type=int, default=6, help="zlib 压缩等级")
+    args = ap.parse_args()
+
+    chunk_bytes = args.chunk_kb * 1024
+    if args.batch:
+        os.makedirs(args.dst, exist_ok=True)
+        for name in sorted(os.listdir(args.src)):
+            if name.endswith(".gz"):
+                convert(os.path.join(args.src, name),
+                        os.path.join(args.dst, name[:-3] + ".ckpt"),
+                        chunk_bytes, args.jobs, args.level)
+    else:
+        convert(args.src, args.dst, chunk_bytes, args.jobs, args.level)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except ValueError as e:
+        sys.exit(f"error: {e}")
@@ -0,0 +1,625 @@
+// ============================================================
+// bpu_eval：分支 trace 驱动的 BPU_TOP 独立评估器
+//
+// 输入为 REF 模式 --br-trace 生成的 trace，按周期驱动 BPU_TOP（含
+// TAGE_TOP/BTB_TOP/TypePredictor 子模块），不经过 icache/后端：
+//   - 取指：BPU 每周期给出一个取指块，按 predecode_checker 的规则修正
+//     （非分支不跳、JAL/JALR 必跳、直接跳转目标取自 trace），再与 trace
+//     真实路径逐条比对；
+//   - 修正后的下一取指地址与 BPU 原始预测不同时，predecode_lat 周期后
+//     重定向（对应前端 predecode flush）；
+//   - 真实路径上的每条指令进入 ROB，commit_lat 周期后按 COMMIT_WIDTH
+//     提交并回送 BPU 更新接口（与 SimCpu::back2front_comb 一致）；
+//   - 误预测/trap 在该指令提交时重定向，其间停止取指（不模拟错误路径）。
+// --functional 为功能回放：每条分支记录只驱动 BPU_TOP 两拍（重定向到分支
+// PC + 预测），上一条分支的更新随重定向拍送入，不模拟取指块、ROB 与提交
+// 延迟；分支之间的顺序指令不经过 BPU，只按 PC 差计入指令数。
+// 统计口径与 PerfCount::perf_print_branch() 一致。多个 trace 分线程并行回放。
+// ============================================================
+#include <BPU/BPU.h>
+
+#include "BranchTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct EvalParams {
+  uint64_t max_inst = UINT64_MAX;
+  uint32_t commit_lat = 16;
+  uint32_t predecode_lat = 3;
+  uint32_t rob_size = ROB_NUM;
+  bool functional = false;
+};
+
+struct EvalStats {
+  uint64_t inst = 0;
+  uint64_t cycles = 0;
+  uint64_t records = 0;
+
+  uint64_t cond_br_num = 0;
+  uint64_t jalr_br_num = 0;
+  uint64_t ret_br_num = 0;
+  uint64_t cond_mispred_num = 0;
+  uint64_t jalr_mispred_num = 0;
+  uint64_t ret_mispred_num = 0;
+  uint64_t cond_dir_mispred = 0;
+  uint64_t cond_addr_mispred = 0;
+  uint64_t jalr_dir_mispred = 0;
+  uint64_t jalr_addr_mispred = 0;
+  uint64_t ret_dir_mispred = 0;
+  uint64_t ret_addr_mispred = 0;
+
+  uint64_t predecode_flush = 0;
+  uint64_t trap_redirect = 0;
+  uint64_t desync = 0;
+  double host_sec = 0;
+  std::string error;
+};
+
+// 单条指令在预测时刻的训练元数据（来自所在取指块的对应 slot）
+struct SlotMeta {
+  bool alt_pred;
+  pcpn_t pcpn;
+  pcpn_t altpcpn;
+  tage_tag_t tags[TN_MAX];
+  tage_idx_t idxs[TN_MAX];
+  bool sc_used;
+  bool sc_pred;
+  tage_scl_meta_sum_t sc_sum;
+  tage_scl_meta_idx_t sc_idx[BPU_SCL_META_NTABLE];
+  bool loop_used;
+  bool loop_hit;
+  bool loop_pred;
+  tage_loop_meta_idx_t loop_idx;
+  tage_loop_meta_tag_t loop_tag;
+};
+
+struct RobEntry {
+  uint32_t pc;
+  uint32_t next_pc;     // 训练用目标（trap 点按顺序执行）
+  uint32_t redirect_pc; // 真实的下一条 PC
+  uint8_t type;
+  bool actual_dir;
+  bool pred_dir;
+  bool mispred;
+  bool redirect; // 提交时重定向（误预测或 trap）
+  uint64_t ready_cycle;
+  SlotMeta meta;
+};
+
+// 定长环形缓冲（ROB）
+template <typename T> class Ring {
+public:
+  explicit Ring(size_t cap) : buf_(cap) {}
+  bool empty() const { return count_ == 0; }
+  size_t size() const { return count_; }
+  size_t capacity() const { return buf_.size(); }
+  T &front() { return buf_[head_]; }
+  T &push() {
+    T &slot = buf_[(head_ + count_) % buf_.size()];
+    count_++;
+    return slot;
+  }
+  void pop() {
+    head_ = (head_ + 1) % buf_.size();
+    count_--;
+  }
+
+private:
+  std::vector<T> buf_;
+  size_t head_ = 0;
+  size_t count_ = 0;
+};
+
+// 按 trace 推进的真实执行路径
+class TruthPath {
+public:
+  explicit TruthPath(BranchTraceReader &reader) : reader_(reader) {
+    pc_ = reader_.start_pc();
+    valid_ = reader_.next(rec_);
+  }
+  bool valid() const { return valid_; }
+  uint32_t pc() const { return pc_; }
+  // 当前指令是否为 trace 记录点（分支或 PC 跳变）
+  bool at_record() const { return rec_.pc == pc_; }
+  const BrTraceRecord &record() const { return rec_; }
+  uint32_t next_pc() const {
+    return (at_record() && rec_.taken) ? rec_.target : pc_ + 4;
+  }
+  uint64_t records() const { return consumed_; }
+  void advance() {
+    const uint32_t next = next_pc();
+    if (at_record()) {
+      consumed_++;
+      valid_ = reader_.next(rec_);
+    }
+    pc_ = next;
+  }
+
+private:
+  BranchTraceReader &reader_;
+  BrTraceRecord rec_ = {};
+  uint32_t pc_ = 0;
+  bool valid_ = false;
+  uint64_t consumed_ = 0;
+};
+
+bool is_direct_target(uint8_t type) {
+  return type == BR_DIRECT || type == BR_JAL || type == BR_CALL;
+}
+
+// 与 SimCpu::back2front_comb 的更新字段一致
+void fill_update(BPU_TOP::InputPayload &inp, int n, const RobEntry &e) {
+  const SlotMeta &m = e.meta;
+  inp.in_update_base_pc[n] = e.pc;
+  inp.in_upd_valid[n] = true;
+  inp.in_actual_dir[n] = e.actual_dir;
+  inp.in_actual_br_type[n] = e.type;
+  inp.in_actual_targets[n] = e.next_pc;
+  inp.in_pred_dir[n] = e.pred_dir;
+  inp.in_alt_pred[n] = m.alt_pred;
+  inp.in_pcpn[n] = m.pcpn;
+  inp.in_altpcpn[n] = m.altpcpn;
+  for (int k = 0; k < TN_MAX; k++) {
+    inp.in_tage_tags[n][k] = m.tags[k];
+    inp.in_tage_idxs[n][k] = m.idxs[k];
+  }
+  inp.in_sc_used[n] = m.sc_used;
+  inp.in_sc_pred[n] = m.sc_pred;
+  inp.in_sc_sum[n] = m.sc_sum;
+  for (int t = 0; t < BPU_SCL_META_NTABLE; t++) {
+    inp.in_sc_idx[n][t] = m.sc_idx[t];
+  }
+  inp.in_loop_used[n] = m.loop_used;
+  inp.in_loop_hit[n] = m.loop_hit;
+  inp.in_loop_pred[n] = m.loop_pred;
+  inp.in_loop_idx[n] = m.loop_idx;
+  inp.in_loop_tag[n] = m.loop_tag;
+}
+
+void save_meta(const BPU_TOP::OutputPayload &out, int i, SlotMeta &m) {
+  m.alt_pred = out.out_alt_pred[i];
+  m.pcpn = out.out_pcpn[i];
+  m.altpcpn = out.out_altpcpn[i];
+  for (int k = 0; k < TN_MAX; k++) {
+    m.tags[k] = out.out_tage_tags[i][k];
+    m.idxs[k] = out.out_tage_idxs[i][k];
+  }
+  m.sc_used = out.out_sc_used[i];
+  m.sc_pred = out.out_sc_pred[i];
+  m.sc_sum = out.out_sc_sum[i];
+  for (int t = 0; t < BPU_SCL_META_NTABLE; t++) {
+    m.sc_idx[t] = out.out_sc_idx[i][t];
+  }
+  m.loop_used = out.out_loop_used[i];
+  m.loop_hit = out.out_loop_hit[i];
+  m.loop_pred = out.out_loop_pred[i];
+  m.loop_idx = out.out_loop_idx[i];
+  m.loop_tag = out.out_loop_tag[i];
+}
+
+// 按 predecode_checker 规则修正 slot 的预测：非分支不跳、JAL/JALR 必跳、
+// 直接跳转目标取自 trace。返回是否跳转，pred_next 为修正后的下一条 PC。
+bool corrected_pred(const BPU_TOP::OutputPayload &out, int slot, uint32_t pc,
+                    uint8_t type, const BrTraceRecord &rec, uint32_t &pred_next) {
+  bool pred_taken = false;
+  if (type == BR_DIRECT) {
+    pred_taken = out.out_pred_dir[slot];
+  } else if (type != BR_NONCTL) {
+    pred_taken = true;
+  }
+  pred_next = pc + 4;
+  if (pred_taken) {
+    pred_next = is_direct_target(type) ? rec.target : out.predict_next_fetch_address;
+  }
+  return pred_taken;
+}
+
+void count_commit(const RobEntry &e, EvalStats &s) {
+  s.inst++;
+  uint64_t *num = nullptr, *mispred = nullptr, *dir = nullptr, *addr = nullptr;
+  if (e.type == BR_DIRECT) {
+    num = &s.cond_br_num, mispred = &s.cond_mispred_num;
+    dir = &s.cond_dir_mispred, addr = &s.cond_addr_mispred;
+  } else if (e.type == BR_RET) {
+    num = &s.ret_br_num, mispred = &s.ret_mispred_num;
+    dir = &s.ret_dir_mispred, addr = &s.ret_addr_mispred;
+  } else if (e.type == BR_IDIRECT) {
+    num = &s.jalr_br_num, mispred = &s.jalr_mispred_num;
+    dir = &s.jalr_dir_mispred, addr = &s.jalr_addr_mispred;
+  } else {
+    return;
+  }
+  (*num)++;
+  if (e.mispred) {
+    (*mispred)++;
+    (e.pred_dir != e.actual_dir ? *dir : *addr)++;
+  }
+}
+
+void run_trace(const std::string &path, const EvalParams &params,
+               EvalStats &s) {
+  BranchTraceReader reader;
+  if (!reader.open(path)) {
+    s.error = reader.error();
+    return;
+  }
+  const auto t0 = std::chrono::steady_clock::now();
+  TruthPath truth(reader);
+  // BPU_TOP 及其三阶段数据容器体积较大，放堆上
+  auto bpu = std::make_unique<BPU_TOP>();
+  auto rd = std::make_unique<BPU_TOP::ReadData>();
+  auto req = std::make_unique<BPU_TOP::UpdateRequest>();
+  auto inp = std::make_unique<BPU_TOP::InputPayload>();
+  auto out = std::make_unique<BPU_TOP::OutputPayload>();
+  std::memset(out.get(), 0, sizeof(*out));
+  Ring<RobEntry> rob(params.rob_size);
+
+  bool refetch_pending = true; // 首拍重定向到 trace 起点
+  uint32_t refetch_addr = truth.pc();
+  uint64_t refetch_cycle = 0;
+  bool wait_commit = false; // 等待误预测/trap 提交
+  bool queue_full = false;
+  const uint32_t line_mask = ~static_cast<uint32_t>(ICACHE_LINE_SIZE - 1);
+
+  uint64_t cycle = 0;
+  for (;; cycle++) {
+    const bool fetch_done = !truth.valid() || s.inst + rob.size() >= params.max_inst;
+    if (fetch_done && rob.empty()) {
+      break;
+    }
+    std::memset(inp.get(), 0, sizeof(*inp));
+
+    // 1. 提交：回送 BPU 更新；误预测/trap 提交时重定向
+    for (int n = 0; !queue_full && n < COMMIT_WIDTH && !rob.empty() &&
+                    rob.front().ready_cycle <= cycle;
+         n++) {
+      const RobEntry &e = rob.front();
+      fill_update(*inp, n, e);
+      count_commit(e, s);
+      const bool redirect = e.redirect;
+      const uint32_t next_pc = e.redirect_pc;
+      rob.pop();
+      if (redirect) {
+        refetch_pending = true;
+        refetch_addr = next_pc;
+        refetch_cycle = cycle;
+        wait_commit = false;
+        break;
+      }
+    }
+    if (refetch_pending && cycle >= refetch_cycle) {
+      inp->refetch = true;
+      inp->refetch_address = refetch_addr;
+      refetch_pending = false;
+    }
+    const bool fetch_ok = !refetch_pending && !wait_commit && !fetch_done &&
+                          rob.size() + FETCH_WIDTH <= rob.capacity();
+    inp->icache_read_ready = fetch_ok;
+
+    // 2. BPU 一个周期
+    bpu->bpu_seq_read(*inp, *rd);
+    bpu->bpu_comb_calc(*inp, *rd, *out, *req);
+    bpu->bpu_seq_write(*inp, *req, false);
+    queue_full = out->update_queue_full;
+
+    if (!fetch_ok || !out->icache_read_valid) {
+      continue;
+    }
+
+    // 3. 取指块：按 predecode_checker 规则修正后与真实路径逐条比对
+    // 半字槽位下，4 字节指令可从上一块的最后一个半字开始，此时真实路径
+    // 比取指块起点多 2 字节
+    const uint32_t fa = out->fetch_address;
+    const uint32_t skew = truth.pc() - fa;
+    if (skew != 0 && !(FETCH_SLOT_BYTES == 2 && skew == 2)) {
+      // BPU 取指流与真实路径失步（正常不应出现），强制重定向
+      s.desync++;
+      refetch_pending = true;
+      refetch_addr = truth.pc();
+      refetch_cycle = cycle + 1;
+      continue;
+    }
+    const uint32_t pc_plus_width = fa + FETCH_WIDTH * FETCH_SLOT_BYTES;
+    const uint32_t boundary = ((fa & line_mask) != (pc_plus_width & line_mask))
+                                  ? (pc_plus_width & line_mask)
+                                  : pc_plus_width;
+    uint32_t corrected_next = boundary;
+    while (truth.valid() && truth.pc() < boundary) {
+      const uint32_t spc = truth.pc();
+      const int i = static_cast<int>((spc - fa) >> FETCH_SLOT_SHIFT);
+      const bool at_rec = truth.at_record();
+      const BrTraceRecord &rec = truth.record();
+      const uint8_t type = at_rec ? rec.type : BR_NONCTL;
+      uint32_t pred_next;
+      const bool pred_taken = corrected_pred(*out, i, spc, type, rec, pred_next);
+      const uint32_t actual_next = truth.next_pc();
+      const bool trap = at_rec && type == BR_NONCTL;
+      RobEntry &e = rob.push();
+      e.pc = spc;
+      e.next_pc = trap ? spc + 4 : actual_next;
+      e.redirect_pc = actual_next;
+      e.type = type;
+      e.actual_dir = (type == BR_DIRECT) ? (rec.taken != 0) : (type != BR_NONCTL);
+      e.pred_dir = pred_taken;
+      e.mispred = type != BR_NONCTL && pred_next != actual_next;
+      e.redirect = e.mispred || trap;
+      e.ready_cycle = cycle + params.commit_lat;
+      save_meta(*out, i, e.meta);
+      truth.advance();
+      if (e.redirect) {
+        s.trap_redirect += trap;
+        wait_commit = true;
+        break;
+      }
+      if (pred_taken) {
+        corrected_next = pred_next;
+        break;
+      }
+    }
+    if (!wait_commit && corrected_next != out->predict_next_fetch_address) {
+      s.predecode_flush++;
+      refetch_pending = true;
+      refetch_addr = corrected_next;
+      refetch_cycle = cycle + params.predecode_lat;
+    }
+  }
+  s.cycles = cycle;
+  s.records = truth.records();
+  s.host_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+                   .count();
+}
+
+void run_trace_functional(const std::string &path, const EvalParams &params,
+                          EvalStats &s) {
+  BranchTraceReader reader;
+  if (!reader.open(path)) {
+    s.error = reader.error();
+    return;
+  }
+  const auto t0 = std::chrono::steady_clock::now();
+  auto bpu = std::make_unique<BPU_TOP>();
+  auto rd = std::make_unique<BPU_TOP::ReadData>();
+  auto req = std::make_unique<BPU_TOP::UpdateRequest>();
+  auto inp = std::make_unique<BPU_TOP::InputPayload>();
+  auto out = std::make_unique<BPU_TOP::OutputPayload>();
+  std::memset(out.get(), 0, sizeof(*out));
+  auto step = [&]() {
+    bpu->bpu_seq_read(*inp, *rd);
+    bpu->bpu_comb_calc(*inp, *rd, *out, *req);
+    bpu->bpu_seq_write(*inp, *req, false);
+    s.cycles++;
+  };
+
+  RobEntry upd = {}; // 上一条分支，随下一次重定向回送更新
+  bool upd_valid = false;
+  uint32_t pc = reader.start_pc();
+  BrTraceRecord rec;
+  while (s.inst < params.max_inst && reader.next(rec)) {
+    // 两条记录之间为顺序执行的非分支指令
+    const uint64_t gap = (rec.pc - pc) / 4;
+    if (s.inst + gap >= params.max_inst) {
+      s.inst = params.max_inst;
+      break;
+    }
+    s.inst += gap;
+    s.records++;
+    if (rec.type == BR_NONCTL) {
+      s.inst++;
+      s.trap_redirect++;
+      pc = rec.target;
+      continue;
+    }
+
+    // 1. 重定向到分支 PC；同拍回送上一条分支的更新，Spec 历史/RAS 随之
+    //    恢复为更新后的 Arch 状态
+    std::memset(inp.get(), 0, sizeof(*inp));
+    if (upd_valid) {
+      fill_update(*inp, 0, upd);
+    }
+    inp->refetch = true;
+    inp->refetch_address = rec.pc;
+    step();
+
+    // 2. 以分支为 slot 0 预测一个取指块
+    std::memset(inp.get(), 0, sizeof(*inp));
+    inp->icache_read_ready = true;
+    step();
+    if (!out->icache_read_valid || out->fetch_address != rec.pc) {
+      s.desync++;
+    }
+
+    const uint32_t actual_next = rec.taken ? rec.target : rec.pc + 4;
+    uint32_t pred_next;
+    upd.pc = rec.pc;
+    upd.next_pc = actual_next;
+    upd.redirect_pc = actual_next;
+    upd.type = rec.type;
+    upd.actual_dir = rec.taken != 0;
+    upd.pred_dir = corrected_pred(*out, 0, rec.pc, rec.type, rec, pred_next);
+    upd.mispred = pred_next != actual_next;
+    upd.redirect = upd.mispred;
+    save_meta(*out, 0, upd.meta);
+    upd_valid = true;
+    count_commit(upd, s);
+    pc = actual_next;
+  }
+  s.host_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+                   .count();
+}
+
+} // namespace
+
+namespace {
+
+void print_stats(const std::string &path, const EvalParams &params,
+                 const EvalStats &s) {
+  printf("\033[38;5;34m*********BPU EVAL: %s************\033[0m\n", path.c_str());
+  if (!s.error.empty()) {
+    printf("error: %s\n\n", s.error.c_str());
+    return;
+  }
+  const uint64_t br = s.cond_br_num + s.jalr_br_num + s.ret_br_num;
+  const uint64_t mis = s.cond_mispred_num + s.jalr_mispred_num + s.ret_mispred_num;
+  printf("inst       : %lu\n", s.inst);
+  if (params.functional) {
+    printf("bpu steps  : %lu\n", s.cycles);
+  } else {
+    printf("cycles     : %lu (ipc %.4f)\n", s.cycles,
+           s.cycles ? s.inst / (double)s.cycles : 0.0);
+  }
+  printf("bpu   accuracy : %f\n", 1 - mis / (double)br);
+  printf("bpu   MPKI     : %f\n\n", s.inst ? mis * 1000.0 / s.inst : 0.0);
+  const struct {
+    const char *name;
+    uint64_t num, mispred, addr, dir;
+  } rows[] = {
+      {"jalr", s.jalr_br_num, s.jalr_mispred_num, s.jalr_addr_mispred,
+       s.jalr_dir_mispred},
+      {"br  ", s.cond_br_num, s.cond_mispred_num, s.cond_addr_mispred,
+       s.cond_dir_mispred},
+      {"ret ", s.ret_br_num, s.ret_mispred_num, s.ret_addr_mispred,
+       s.ret_dir_mispred},
+  };
+  for (const auto &r : rows) {
+    printf("%s  accuracy : %f  MPKI : %f\n", r.name,
+           1 - r.mispred / (double)r.num,
+           s.inst ? r.mispred * 1000.0 / s.inst : 0.0);
+    printf("num        : %lu\n", r.num);
+    printf("mispred    : %lu\n", r.mispred);
+    printf("addr error : %lu\n", r.addr);
+    printf("dir  error : %lu\n\n", r.dir);
+  }
+  if (!params.functional) {
+    printf("predecode flush : %lu\n", s.predecode_flush);
+  }
+  printf("trap redirect   : %lu\n", s.trap_redirect);
+  if (s.desync != 0) {
+    printf("desync          : %lu\n", s.desync);
+  }
+  printf("host            : %.3f s, %.3f M inst/s, %.3f M record/s\n\n",
+         s.host_sec, s.inst / s.host_sec / 1e6, s.records / s.host_sec / 1e6);
+}
+
+void print_help(char *argv[]) {
+  printf("Usage: %s [options] <trace> [trace...]\n", argv[0]);
+  printf("\nReplay branch traces written by `simulator -m ref --br-trace` "
+         "through BPU_TOP.\n");
+  printf("\nOptions:\n");
+  printf("  -j, --jobs <num>           Replay traces on <num> threads "
+         "(default: 1)\n");
+  printf("  -c, --max-inst <num>       Stop each trace after <num> "
+         "instructions\n");
+  printf("  --commit-lat <num>         Fetch-to-commit latency in cycles "
+         "(default: 16)\n");
+  printf("  --predecode-lat <num>      Predecode flush latency in cycles "
+         "(default: 3)\n");
+  printf("  --rob <num>                In-flight instruction window "
+         "(default: ROB_NUM)\n");
+  printf("  --functional               Predict and update once per branch "
+         "record, without\n"
+         "                             fetch blocks or commit latency\n");
+  printf("  -h, --help                 Show this message\n");
+}
+
+enum {
+  OPT_COMMIT_LAT = 256,
+  OPT_PREDECODE_LAT,
+  OPT_ROB,
+  OPT_FUNCTIONAL,
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  EvalParams params;
+  unsigned jobs = 1;
+
+  static struct option long_options[] = {
+      {"jobs", required_argument, 0, 'j'},
+      {"max-inst", required_argument, 0, 'c'},
+      {"commit-lat", required_argument, 0, OPT_COMMIT_LAT},
+      {"predecode-lat", required_argument, 0, OPT_PREDECODE_LAT},
+      {"rob", required_argument, 0, OPT_ROB},
+      {"functional", no_argument, 0, OPT_FUNCTIONAL},
+      {"help", no_argument, 0, 'h'},
+      {0, 0, 0, 0}};
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "j:c:h", long_options, nullptr)) != -1) {
+    switch (opt) {
+    case 'j':
+      jobs = static_cast<unsigned>(std::max(1l, std::strtol(optarg, nullptr, 0)));
+      break;
+    case 'c':
+      params.max_inst = std::strtoull(optarg, nullptr, 0);
+      break;
+    case OPT_COMMIT_LAT:
+      params.commit_lat = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 0));
+      break;
+    case OPT_PREDECODE_LAT:
+      params.predecode_lat =
+          static_cast<uint32_t>(std::strtoul(optarg, nullptr, 0));
+      break;
+    case OPT_ROB:
+      params.rob_size = static_cast<uint32_t>(
+          std::max(static_cast<unsigned long>(FETCH_WIDTH),
+                   std::strtoul(optarg, nullptr, 0)));
+      break;
+    case OPT_FUNCTIONAL:
+      params.functional = true;
+      break;
+    case 'h':
+      print_help(argv);
+      return 0;
+    default:
+      print_help(argv);
+      return 1;
+    }
+  }
+  if (optind >= argc) {
+    fprintf(stderr, "Error: Missing trace file argument.\n");
+    print_help(argv);
+    return 1;
+  }
+
+  const std::vector<std::string> traces(argv + optind, argv + argc);
+  std::vector<EvalStats> stats(traces.size());
+  std::atomic<size_t> next_trace{0};
+  auto worker = [&]() {
+    for (size_t i = next_trace++; i < traces.size(); i = next_trace++) {
+      if (params.functional) {
+        run_trace_functional(traces[i], params, stats[i]);
+      } else {
+        run_trace(traces[i], params, stats[i]);
+      }
+    }
+  };
+  jobs = std::min<unsigned>(jobs, static_cast<unsigned>(traces.size()));
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < jobs; t++) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto &th : pool) {
+    th.join();
+  }
+
+  bool ok = true;
+  for (size_t i = 0; i < traces.size(); i++) {
+    print_stats(traces[i], params, stats[i]);
+    ok = ok && stats[i].error.empty();
+  }
+  return ok ? 0 : 1;
+}